@@ -31,6 +31,37 @@
  *
  *  V01.002 13-Jul-2019 Jonathan D. Belanger
  *  Chasing down a condition where the CPU mutex gets locked and not unlocked.
+ *
+ *  V01.003 15-Oct-2026 Jonathan D. Belanger
+ *  Get the execution mode for this CPU from the configuration.
+ *
+ *  V01.004 15-Oct-2026 Jonathan D. Belanger
+ *  Initialize the per-pipeline queues instead of the IQ and FQ counted queues.
+ *
+ *  V01.005 15-Oct-2026 Jonathan D. Belanger
+ *  Initialize the physical register wakeup matrix.
+ *
+ *  V01.006 16-Oct-2026 Jonathan D. Belanger
+ *  Start the thread that periodically writes the performance counters, when
+ *  a counter file has been configured.
+ *
+ *  V01.007 16-Oct-2026 Jonathan D. Belanger
+ *  Added a function for the System to save its memory map into the CPU.
+ *
+ *  V01.008 16-Oct-2026 Jonathan D. Belanger
+ *  The System now gives the CPU its own request ring and request entries.
+ *
+ *  V01.009 16-Oct-2026 Jonathan D. Belanger
+ *  Not being able to write the performance counters no longer deallocates the
+ *  CPU, which would have been done out from under its running threads.
+ *
+ *  V01.010 16-Oct-2026 Jonathan D. Belanger
+ *  The execution mode is no longer changed while running, so there is no
+ *  requested mode to initialize.
+ *
+ *  V01.011 16-Oct-2026 Jonathan D. Belanger
+ *  Initialize the requested execution mode, and the number of instructions
+ *  retired before the mode is changed, from the configuration.
  */
 #include "CPU/AXP_21264_CPUDefs.h"
 #include "CPU/Cbox/AXP_21264_Cbox.h"
@@ -181,39 +212,50 @@ void *AXP_21264_AllocateCPU(u64 cpuID)
         }
 
         /*
-         * Let's initialize the counted queues (these have both a mutex and a
-         * condition variable.  We also have to initialize the preallocated
-         * queue entries.
+         * Let's initialize the per-pipeline queues (these each have a ring and
+         * an event count).  We also have to initialize the preallocated queue
+         * entries.
          */
-        if (qRet == true)
+        for (ii = 0; ((ii < AXP_21264_PIPES) && (qRet == true)); ii++)
         {
-            AXP_InitCountedQueue(&cpu->iq, AXP_IQ_LEN);
+            AXP_SPSCRing_Init(&cpu->pipeQ[ii].ring);
+            qRet = AXP_EventCount_Init(&cpu->pipeQ[ii].wake);
+            cpu->pipeQ[ii].issued = cpu->pipeQ[ii].sleeps = 0;
         }
         if (qRet == true)
         {
+            cpu->xqTicket = 0;
+            cpu->iqCount = cpu->fqCount = 0;
+            cpu->xqWaiting = 0;
+            for (ii = 0; ii < AXP_INT_PHYS_REG; ii++)
+            {
+                cpu->prWake[ii] = 0;
+            }
+            for (ii = 0; ii < AXP_FP_PHYS_REG; ii++)
+            {
+                cpu->pfWake[ii] = 0;
+            }
             cpu->iqEFlStart = cpu->iqEFlEnd = 0;
             for (ii = 0; ii < AXP_IQ_LEN; ii++)
             {
-                AXP_INIT_CQENTRY(cpu->iqEntries[ii].header, cpu->iq);
                 cpu->iqEntries[ii].ins = NULL;
                 cpu->iqEntries[ii].index = ii;
-                cpu->iqEntries[ii].processing = false;
+                cpu->iqEntries[ii].ticket = 0;
+                cpu->iqEntries[ii].wakeBit = ii;
+                cpu->iqEntries[ii].waitCnt = 0;
                 cpu->iqEFreelist[ii] = ii;
             }
         }
         if (qRet == true)
-        {
-            AXP_InitCountedQueue(&cpu->fq, AXP_IQ_LEN);
-        }
-        if (qRet == true)
         {
             cpu->fqEFlStart = cpu->fqEFlEnd = 0;
             for (ii = 0; ii < AXP_FQ_LEN; ii++)
             {
-                AXP_INIT_CQENTRY(cpu->fqEntries[ii].header, cpu->fq);
                 cpu->fqEntries[ii].ins = NULL;
                 cpu->fqEntries[ii].index = ii;
-                cpu->fqEntries[ii].processing = false;
+                cpu->fqEntries[ii].ticket = 0;
+                cpu->fqEntries[ii].wakeBit = AXP_IQ_LEN + ii;
+                cpu->fqEntries[ii].waitCnt = 0;
                 cpu->fqEFreelist[ii] = ii;
             }
         }
@@ -234,6 +276,14 @@ void *AXP_21264_AllocateCPU(u64 cpuID)
          */
         cpu->whami = cpuID;
 
+        /*
+         * Get the execution mode (Detailed or Functional) for this CPU.
+         */
+        cpu->execMode = AXP_ConfigGet_CPUMode(cpuID);
+        cpu->execModeReq = cpu->execMode;
+        cpu->execModeChange = false;
+        cpu->execModeSwitch = AXP_ConfigGet_ModeSwitch();
+
         /*
          * At this point, we lock the CPU mutex, to hold back any of the CPU
          * initialization that will occur when the iBox, mBox, dBox, eBoxes,
@@ -311,6 +361,17 @@ void *AXP_21264_AllocateCPU(u64 cpuID)
                                             AXP_21264_CboxMain,
                                             cpu);
             }
+
+            /*
+             * The other threads are already running on the CPU structure, so
+             * not being able to write the counters cannot be treated as a
+             * failure to create the CPU.  A warning has already been
+             * displayed.
+             */
+            if (pthreadRet == 0)
+            {
+                (void) AXP_21264_Counters_Start(cpu, cpuID);
+            }
         }
 
         /*
@@ -373,21 +434,14 @@ void AXP_21264_Save_WHAMI(void *cpuPtr, u64 *cpuID)
  *  cpuPtr:
  *      A void pointer to the CPU structure.  This will be recast so that the
  *      System does not have to have knowledge of the specifics of the CPU.
- *  sysMutex:
- *      A pointer to the System Interface mutex to be stored into the CPU.
- *  sysCond:
- *      A pointer to the System Interface condition variable to be stored into
- *      the CPU.
+ *  rqRing:
+ *      A pointer to this CPU's request ring, onto which the CPU puts its
+ *      requests for processing by the System.
+ *  rqEvent:
+ *      A pointer to the event count the CPU signals after putting a request
+ *      onto its ring.
  *  rq:
- *      A pointer to the System Interface request queue, where requests from
- *      the CPU will be queued up for processing by the System.
- *  rqStart:
- *      A pointer to the System Interface request queue starting entry.  This
- *      is the location where the System will remove entries for processing.
- *  rqEnd:
- *      A pointer to the System Interface request queue last entry.  This is
- *      incremented to the next location where the CPU will add entries to be
- *      processed by the System.
+ *      A pointer to this CPU's AXP_21264_CCHIP_RQ_LEN request entries.
  *
  * Output Parameters:
  *   cpuMutex:
@@ -422,9 +476,9 @@ void AXP_21264_Save_SystemInterfaces(void *cpuPtr,
                                      u8 **pqTop,
                                      u8 **pqBottom,
                                      u8 **irq_H,
-                                     pthread_mutex_t *sysMutex,
-                                     pthread_cond_t *sysCond,
-                                     AXP_QUEUE_HDR *rq)
+                                     AXP_SPSC_RING *rqRing,
+                                     AXP_EVENT_COUNT *rqEvent,
+                                     void *rq)
 {
     AXP_21264_CPU *cpu = (AXP_21264_CPU *) cpuPtr;
 
@@ -432,9 +486,9 @@ void AXP_21264_Save_SystemInterfaces(void *cpuPtr,
      * First, set the data needed for the CPU to be able to communicate with
      * the System into the CPU structure.
      */
-    cpu->system.cond = sysCond;
-    cpu->system.mutex = sysMutex;
-    cpu->system.rq = rq;
+    cpu->system.rqRing = rqRing;
+    cpu->system.rqEvent = rqEvent;
+    cpu->system.rq = (AXP_21264_RQ_ENTRY *) rq;
 
     /*
      * Finally, set the data needed for the System to be able to communicate
@@ -453,6 +507,45 @@ void AXP_21264_Save_SystemInterfaces(void *cpuPtr,
     return;
 }
 
+/*
+ * AXP_21264_Save_MemoryMap
+ *  This function is called by the System after allocating the memory arrays.
+ *  It stores the map of the host memory for the arrays, which the Cbox uses
+ *  to read and write memory blocks without sending a request to the System.
+ *
+ * Input Parameters:
+ *  cpuPtr:
+ *      A void pointer to the CPU structure.  This will be recast so that the
+ *      System does not have to have knowledge of the specifics of the CPU.
+ *  memMap:
+ *      A pointer to the map of host memory, with AXP_21264_MEM_MAP_LEN
+ *      entries.
+ *  directMem:
+ *      A value indicating whether the Cbox may access memory directly.  This
+ *      is only the case when there is no other CPU that would need to be
+ *      probed.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_21264_Save_MemoryMap(void *cpuPtr, u8 **memMap, bool directMem)
+{
+    AXP_21264_CPU *cpu = (AXP_21264_CPU *) cpuPtr;
+
+    pthread_mutex_lock(&cpu->cBoxInterfaceMutex);
+    cpu->system.memMap = memMap;
+    cpu->system.directMem = directMem;
+    pthread_mutex_unlock(&cpu->cBoxInterfaceMutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
 /*
  * AXP_21264_Unlock_CPU
  *  This function is called to unlock the CPU mutex.  It is locked prior to the
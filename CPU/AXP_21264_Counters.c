@@ -0,0 +1,449 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the functions needed to take a snapshot of the
+ *  performance counters for a Digital Alpha AXP 21264 CPU, and the thread that
+ *  periodically writes these snapshots to a CSV file.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Added the load forward and replay counters.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Added the direct memory read and write counters.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Added the return and jump counters, and the rates at which branches,
+ *  returns, and jumps are mispredicted.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  A counter file that cannot be written is reported, but no longer stops the
+ *  CPU from being created.  Added a function to join the counter thread when
+ *  the CPU shuts down.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped a line longer than 80 columns.
+ */
+#include "CPU/AXP_21264_CPUDefs.h"
+
+/*
+ * The column headings for each of the counters, in the order they are defined
+ * in the AXP_COUNTER enumeration.
+ */
+static const char *_axp_counter_names_[AXP_CNT_MAX] =
+{
+    "IboxCycles",
+    "IboxStalls",
+    "Decoded",
+    "Retired",
+    "Branches",
+    "Mispredicts",
+    "Returns",
+    "ReturnMispredicts",
+    "Jumps",
+    "JumpMispredicts",
+    "Aborts",
+    "Aborted",
+    "IcacheFetches",
+    "IcacheMisses",
+    "DcacheReads",
+    "DcacheReadMisses",
+    "DcacheWrites",
+    "DcacheWriteMisses",
+    "DcacheFills",
+    "ITBLookups",
+    "ITBMisses",
+    "DTBLookups",
+    "DTBMisses",
+    "MAFRequests",
+    "MAFMerges",
+    "MAFInUse",
+    "LoadForwards",
+    "LoadReplays",
+    "DirectReads",
+    "DirectWrites"
+};
+
+/*
+ * The information the counter thread needs, over and above the CPU.
+ */
+typedef struct
+{
+    AXP_21264_CPU *cpu;
+    u64 cpuID;
+    FILE *fp;
+} AXP_COUNTERS_THREAD;
+
+/*
+ * AXP_21264_Counters_Snapshot
+ *  This function is called to take a snapshot of the performance counters for
+ *  a CPU.  The counters themselves are read without stopping the CPU, so they
+ *  may be a little out of step with each other.  The MAF, VDB, and IOWB
+ *  entries in use are counted with the Cbox interface mutex locked.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *
+ * Output Parameters:
+ *  snapshot:
+ *      A pointer to the location to receive the current counter values.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_21264_Counters_Snapshot(AXP_21264_CPU *cpu,
+                                 AXP_COUNTERS_SNAPSHOT *snapshot)
+{
+    int ii;
+
+    clock_gettime(CLOCK_MONOTONIC, &snapshot->when);
+    for (ii = 0; ii < AXP_CNT_MAX; ii++)
+    {
+        snapshot->value[ii] = __atomic_load_n(&cpu->counters.value[ii],
+                                              __ATOMIC_RELAXED);
+    }
+
+    /*
+     * Now count the Cbox entries currently in use.
+     */
+    snapshot->mafInUse = snapshot->vdbInUse = snapshot->iowbInUse = 0;
+    pthread_mutex_lock(&cpu->cBoxInterfaceMutex);
+    for (ii = 0; ii < AXP_21264_MAF_LEN; ii++)
+    {
+        if (cpu->maf[ii].valid == true)
+        {
+            snapshot->mafInUse++;
+        }
+    }
+    for (ii = 0; ii < AXP_21264_VDB_LEN; ii++)
+    {
+        if (cpu->vdb[ii].valid == true)
+        {
+            snapshot->vdbInUse++;
+        }
+    }
+    for (ii = 0; ii < AXP_21264_IOWB_LEN; ii++)
+    {
+        if (cpu->iowb[ii].valid == true)
+        {
+            snapshot->iowbInUse++;
+        }
+    }
+    pthread_mutex_unlock(&cpu->cBoxInterfaceMutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Counters_Rate
+ *  This function is called to determine the rate of one counter to another,
+ *  since the previous snapshot.
+ *
+ * Input Parameters:
+ *  prev:
+ *      A pointer to the previous snapshot.
+ *  cur:
+ *      A pointer to the current snapshot.
+ *  counter:
+ *      A value indicating the counter of the events counted.
+ *  of:
+ *      A value indicating the counter of the events they are a rate of.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The rate, or zero if there were none of the latter.
+ */
+static double AXP_21264_Counters_Rate(AXP_COUNTERS_SNAPSHOT *prev,
+                                      AXP_COUNTERS_SNAPSHOT *cur,
+                                      AXP_COUNTER counter,
+                                      AXP_COUNTER of)
+{
+    u64 count = cur->value[counter] - prev->value[counter];
+    u64 total = cur->value[of] - prev->value[of];
+    double retVal = 0.0;
+
+    if (total != 0)
+    {
+        retVal = (double) count / (double) total;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Counters_Write
+ *  This function is called to write a row to the CSV file for a snapshot of
+ *  the counters.  The counters are written as totals since the CPU was
+ *  created.  The IPC is the instructions retired per Ibox cycle, and the
+ *  misprediction rates are of the branches, returns, and jumps retired, since
+ *  the previous snapshot.
+ *
+ * Input Parameters:
+ *  fp:
+ *      A pointer to the open CSV file.
+ *  cpuID:
+ *      A value indicating the CPU for which the counters were taken.
+ *  start:
+ *      A pointer to the time at which the counter thread was started.
+ *  prev:
+ *      A pointer to the previous snapshot.
+ *  cur:
+ *      A pointer to the current snapshot.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void AXP_21264_Counters_Write(FILE *fp,
+                                     u64 cpuID,
+                                     struct timespec *start,
+                                     AXP_COUNTERS_SNAPSHOT *prev,
+                                     AXP_COUNTERS_SNAPSHOT *cur)
+{
+    double elapsed;
+    int ii;
+
+    elapsed = (double) (cur->when.tv_sec - start->tv_sec) +
+              ((double) (cur->when.tv_nsec - start->tv_nsec) / 1.0e9);
+
+    fprintf(fp, "%.3f,%llu", elapsed, cpuID);
+    for (ii = 0; ii < AXP_CNT_MAX; ii++)
+    {
+        fprintf(fp, ",%llu", cur->value[ii]);
+    }
+    fprintf(fp,
+            ",%.3f,%.4f,%.4f,%.4f,%u,%u,%u\n",
+            AXP_21264_Counters_Rate(prev,
+                                    cur,
+                                    AXP_CNT_RETIRED,
+                                    AXP_CNT_IBOX_CYCLES),
+            AXP_21264_Counters_Rate(prev,
+                                    cur,
+                                    AXP_CNT_MISPREDICTS,
+                                    AXP_CNT_BRANCHES),
+            AXP_21264_Counters_Rate(prev,
+                                    cur,
+                                    AXP_CNT_RET_MISPREDICTS,
+                                    AXP_CNT_RETURNS),
+            AXP_21264_Counters_Rate(prev,
+                                    cur,
+                                    AXP_CNT_JMP_MISPREDICTS,
+                                    AXP_CNT_JUMPS),
+            cur->mafInUse,
+            cur->vdbInUse,
+            cur->iowbInUse);
+    fflush(fp);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Counters_Main
+ *  This is the main function for the thread that periodically writes the
+ *  performance counters to a CSV file.  It runs until the CPU is shutting
+ *  down, at which point it writes the final values and closes the file.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      A pointer to the counter thread information.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL.
+ */
+static void *AXP_21264_Counters_Main(void *voidPtr)
+{
+    AXP_COUNTERS_THREAD *thread = (AXP_COUNTERS_THREAD *) voidPtr;
+    AXP_21264_CPU *cpu = thread->cpu;
+    AXP_COUNTERS_SNAPSHOT prev, cur;
+    struct timespec start;
+    struct timespec interval;
+    int ii;
+
+    interval.tv_sec = cpu->counterInterval / 1000;
+    interval.tv_nsec = (cpu->counterInterval % 1000) * 1000000;
+
+    /*
+     * Write the column headings, then take the first snapshot for the first
+     * IPC to be calculated from.
+     */
+    fprintf(thread->fp, "Time,CPU");
+    for (ii = 0; ii < AXP_CNT_MAX; ii++)
+    {
+        fprintf(thread->fp, ",%s", _axp_counter_names_[ii]);
+    }
+    fprintf(thread->fp,
+            ",IPC,BranchMissRate,ReturnMissRate,JumpMissRate,"
+            "MAFUsed,VDBUsed,IOWBUsed\n");
+    AXP_21264_Counters_Snapshot(cpu, &prev);
+    start = prev.when;
+
+    /*
+     * Wait for the interval, take a snapshot and write it.  Once the CPU is
+     * shutting down, we write one last time and are done.
+     */
+    do
+    {
+        nanosleep(&interval, NULL);
+        AXP_21264_Counters_Snapshot(cpu, &cur);
+        AXP_21264_Counters_Write(thread->fp,
+                                 thread->cpuID,
+                                 &start,
+                                 &prev,
+                                 &cur);
+        prev = cur;
+    } while (cpu->cpuState != ShuttingDown);
+
+    fclose(thread->fp);
+    free(thread);
+
+    /*
+     * Return back to the caller.
+     */
+    return (NULL);
+}
+
+/*
+ * AXP_21264_Counters_Start
+ *  This function is called when a CPU is being created, to start the thread
+ *  that periodically writes its performance counters, if a counter file has
+ *  been configured.  Each CPU writes its own file, which has the CPU number
+ *  added to the end of the configured file name for all but CPU 0.  If the
+ *  file cannot be opened, or the thread cannot be created, a warning is
+ *  displayed and the CPU runs without writing its counters.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *  cpuID:
+ *      A value indicating the CPU for which the counters are to be written.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  true:   The thread was started, or a counter file was not configured.
+ *  false:  The file could not be opened or the thread could not be created.
+ */
+bool AXP_21264_Counters_Start(AXP_21264_CPU *cpu, u64 cpuID)
+{
+    AXP_COUNTERS_THREAD *thread;
+    char fileName[256];
+    u32 interval;
+    bool retVal = true;
+
+    cpu->counterStarted = false;
+    if (AXP_ConfigGet_CounterFile(fileName, &interval) == true)
+    {
+        retVal = false;
+        if (cpuID != 0)
+        {
+            size_t len = strlen(fileName);
+
+            snprintf(&fileName[len], sizeof(fileName) - len, ".%llu", cpuID);
+        }
+        thread = malloc(sizeof(AXP_COUNTERS_THREAD));
+        if (thread != NULL)
+        {
+            thread->cpu = cpu;
+            thread->cpuID = cpuID;
+            thread->fp = fopen(fileName, "w");
+            if (thread->fp != NULL)
+            {
+                cpu->counterInterval = interval;
+                retVal = pthread_create(&cpu->counterThreadID,
+                                        NULL,
+                                        AXP_21264_Counters_Main,
+                                        thread) == 0;
+                if (retVal == false)
+                {
+                    fclose(thread->fp);
+                }
+            }
+            if (retVal == false)
+            {
+                free(thread);
+            }
+        }
+        if (retVal == false)
+        {
+            printf("\n%%DECAXP-W-NOCOUNTERS, Unable to write the performance "
+                   "counters to %s, continuing without them.\n",
+                   fileName);
+        }
+        cpu->counterStarted = retVal;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Counters_Stop
+ *  This function is called when a CPU has shut down, to wait for the thread
+ *  that writes its performance counters to write them for the last time and
+ *  close the file.  The thread notices the CPU shutting down by itself.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_21264_Counters_Stop(AXP_21264_CPU *cpu)
+{
+    if (cpu->counterStarted == true)
+    {
+        pthread_join(cpu->counterThreadID, NULL);
+        cpu->counterStarted = false;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
@@ -56,9 +56,56 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.007 15-Oct-2026 Jonathan D. Belanger
+ *  Searching all 128 TLB entries for every translation is way too slow.  The
+ *  ITB and DTB now each have a hashed index, keyed off of the VPN and ASN,
+ *  that is kept in synch when TLB entries are added and invalidated.  Also,
+ *  TLB entries with the ASM bit set now match any ASN, as they should.
+ *
+ *  V01.008 15-Oct-2026 Jonathan D. Belanger
+ *  Added a micro-TLB in front of the TLB look-up in AXP_va2pa.  It remembers
+ *  the physical page for the last successful translations, for each access
+ *  type and processor mode, so that we do not have to look-up the TLB entry
+ *  and check the memory access for every load, store, and fetch.
+ *
+ *  V01.009 15-Oct-2026 Jonathan D. Belanger
+ *  The Icache now keeps a predecoded version of each instruction in the
+ *  block.  An instruction is predecoded the first time it is fetched after the
+ *  block was filled, and the predecoded version is returned with the
+ *  instruction on every fetch after that.  Filling or flushing a block
+ *  invalidates the predecoded instructions for that block.
+ *
+ *  V01.010 15-Oct-2026 Jonathan D. Belanger
+ *  Flushing the Icache, or changing an ITB entry, discards the translated
+ *  blocks used by the functional execution mode.
+ *
+ *  V01.011 15-Oct-2026 Jonathan D. Belanger
+ *  AXP_IcacheFetch and AXP_IcacheValid no longer lock the Icache mutex.  Each
+ *  Icache block has a sequence number, which writers make odd while they
+ *  change the block, and readers check before and after reading it.  Only
+ *  writers lock the mutex, now.  To keep the fetch from writing into the
+ *  block, the instructions are predecoded when the block is filled.
+ *
+ *  V01.012 16-Oct-2026 Jonathan D. Belanger
+ *  Count the Icache, Dcache, ITB and DTB accesses and misses in the
+ *  performance counters.
+ *
+ *  V01.013 16-Oct-2026 Jonathan D. Belanger
+ *  Split the super page translation out of AXP_va2pa, into
+ *  AXP_va2paSuperPage, so that the translated block cache can find the
+ *  physical page of code run from a super page.
+ *
+ *  V01.014 16-Oct-2026 Jonathan D. Belanger
+ *  AXP_IcacheFetch no longer reads past the end of the Icache block.  The
+ *  instructions after it are marked as not valid, and the number of valid
+ *  instructions is returned with the line.
  */
 #include "CPU/Caches/AXP_21264_Cache.h"
+#include "CPU/Ibox/AXP_21264_Ibox_InstructionDecoding.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Translate.h"
 #include "CommonUtilities/AXP_Trace.h"
+#include <sched.h>
 
 /*
  * Union to hold 2 32-bit values as a 64-bit value for the purposes of saving
@@ -83,6 +130,13 @@ static char *accStr[] =
     "Read & Write"
 };
 
+/*
+ * Local Prototypes
+ */
+static void AXP_TLBHashInsert(AXP_21264_TLB_HASH *, AXP_21264_TLB *, u32);
+static void AXP_TLBHashRemove(AXP_21264_TLB_HASH *, AXP_21264_TLB *, u32);
+static void AXP_MicroTLBFlush(AXP_21264_CPU *, bool);
+
 /****************************************************************************/
 /*                                                                          */
 /*  The following code handles both the ITB and DTB lists for the Digital   */
@@ -92,10 +146,173 @@ static char *accStr[] =
 /*                                                                          */
 /****************************************************************************/
 
+/*
+ * AXP_TLBHashInsert
+ *  This function is called to insert a valid TLB entry onto the hash chain
+ *  associated with its virtual address and ASN (or just its virtual address,
+ *  if the ASM bit is set).
+ *
+ * Input Parameters:
+ *  hash:
+ *      A pointer to the hashed index for the TLB array.
+ *  tlbArray:
+ *      A pointer to the TLB array containing the entry.
+ *  idx:
+ *      A value indicating the index of the TLB entry to be inserted.
+ *
+ * Output Parameters:
+ *  hash:
+ *      The hash chain and granularity hint counts are updated.
+ *
+ * Return Value:
+ *  None.
+ */
+static void AXP_TLBHashInsert(AXP_21264_TLB_HASH *hash,
+                              AXP_21264_TLB *tlbArray,
+                              u32 idx)
+{
+    AXP_21264_TLB *tlb = &tlbArray[idx];
+    u8 *head;
+
+    if (tlb->_asm == true)
+    {
+        head = &hash->asmBucket[AXP_TB_HASH(tlb->virtAddr, 0)];
+        hash->asmGhCount[tlb->gh]++;
+    }
+    else
+    {
+        head = &hash->bucket[AXP_TB_HASH(tlb->virtAddr, tlb->asn)];
+        hash->ghCount[tlb->gh]++;
+    }
+    hash->next[idx] = *head;
+    *head = idx + 1;
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_TLBHashRemove
+ *  This function is called to remove a valid TLB entry from the hash chain it
+ *  was inserted onto.  This needs to be called before any of the fields used
+ *  to compute the hash are changed.
+ *
+ * Input Parameters:
+ *  hash:
+ *      A pointer to the hashed index for the TLB array.
+ *  tlbArray:
+ *      A pointer to the TLB array containing the entry.
+ *  idx:
+ *      A value indicating the index of the TLB entry to be removed.
+ *
+ * Output Parameters:
+ *  hash:
+ *      The hash chain and granularity hint counts are updated.
+ *
+ * Return Value:
+ *  None.
+ */
+static void AXP_TLBHashRemove(AXP_21264_TLB_HASH *hash,
+                              AXP_21264_TLB *tlbArray,
+                              u32 idx)
+{
+    AXP_21264_TLB *tlb = &tlbArray[idx];
+    u8 *link;
+    u8 *ghCount;
+
+    if (tlb->_asm == true)
+    {
+        link = &hash->asmBucket[AXP_TB_HASH(tlb->virtAddr, 0)];
+        ghCount = &hash->asmGhCount[tlb->gh];
+    }
+    else
+    {
+        link = &hash->bucket[AXP_TB_HASH(tlb->virtAddr, tlb->asn)];
+        ghCount = &hash->ghCount[tlb->gh];
+    }
+
+    /*
+     * Walk the chain until we find the link that points to this entry, then
+     * point it to the entry after this one.
+     */
+    while ((*link != 0) && (*link != (idx + 1)))
+    {
+        link = &hash->next[*link - 1];
+    }
+    if (*link != 0)
+    {
+        *link = hash->next[idx];
+        hash->next[idx] = 0;
+        (*ghCount)--;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_MicroTLBFlush
+ *  This function is called to invalidate all the entries in the micro-TLB for
+ *  either the ITB or DTB.  This is done by incrementing the generation, so
+ *  that all the current entries no longer match.  If the generation wraps
+ *  around, then the entries are cleared out so that a really old entry cannot
+ *  come back to life.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure where the micro-TLBs are located.
+ *  dtb:
+ *      A boolean indicating whether we are flushing the DTB micro-TLB.  If
+ *      not, then we are flushing the ITB micro-TLB.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void AXP_MicroTLBFlush(AXP_21264_CPU *cpu, bool dtb)
+{
+    u32 *gen = (dtb ? &cpu->dtbMicroGen : &cpu->itbMicroGen);
+
+    if (++(*gen) == 0)
+    {
+        if (dtb)
+        {
+            memset(cpu->dtbMicro, 0, sizeof(cpu->dtbMicro));
+        }
+        else
+        {
+            memset(cpu->itbMicro, 0, sizeof(cpu->itbMicro));
+        }
+    }
+
+    /*
+     * If an ITB entry changed, then the instructions in the translated blocks
+     * may no longer be the ones at their virtual addresses.
+     */
+    if (dtb == false)
+    {
+        AXP_21264_Xlate_Flush(cpu);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
 /*
  * AXP_findTLBEntry
  *  This function is called to locate a TLB entry in either the Data or
- *  Instruction TLB, based off of the virtual address.
+ *  Instruction TLB, based off of the virtual address.  Rather than searching
+ *  the entire TLB array, only the hash chains for the granularity hints
+ *  currently in use are searched.  Entries with the ASM bit set match any
+ *  ASN.
  *
  * Input Parameters:
  *  cpu:
@@ -118,8 +335,12 @@ AXP_21264_TLB *AXP_findTLBEntry(AXP_21264_CPU *cpu, u64 virtAddr, bool dtb)
 {
     AXP_21264_TLB *retVal = NULL;
     AXP_21264_TLB *tlbArray = (dtb ? cpu->dtb : cpu->itb);
+    AXP_21264_TLB_HASH *hash = (dtb ? &cpu->dtbHash : &cpu->itbHash);
+    AXP_21264_TLB *tlb;
     u8 asn = (dtb ? cpu->dtbAsn0.asn : cpu->pCtx.asn);
-    int ii;
+    u64 vpn;
+    u32 gh;
+    u8 idx;
 
     if (AXP_CACHE_CALL)
     {
@@ -131,22 +352,62 @@ AXP_21264_TLB *AXP_findTLBEntry(AXP_21264_CPU *cpu, u64 virtAddr, bool dtb)
     }
 
     /*
-     * Search through all valid TLB entries until we find the one we are being
-     * asked to return.
+     * For each granularity hint that has at least one valid entry, search the
+     * hash chain for the VPN (and ASN) until we find the one we are being
+     * asked to return.  Only valid entries are on a hash chain.
      */
-    for (ii = 0; ii < AXP_TB_LEN; ii++)
+    for (gh = 0; ((gh < AXP_TB_GH_CNT) && (retVal == NULL)); gh++)
     {
-        if (tlbArray[ii].valid == true)
+        vpn = virtAddr & GH_MATCH(gh);
+        if (hash->ghCount[gh] != 0)
         {
-            if ((tlbArray[ii].virtAddr == (virtAddr & tlbArray[ii].matchMask)) &&
-                (tlbArray[ii].asn == asn))
+            idx = hash->bucket[AXP_TB_HASH(vpn, asn)];
+            while (idx != 0)
             {
-                retVal = &tlbArray[ii];
-                break;
+                tlb = &tlbArray[idx - 1];
+                if ((tlb->virtAddr == vpn) &&
+                    (tlb->gh == gh) &&
+                    (tlb->asn == asn))
+                {
+                    retVal = tlb;
+                    break;
+                }
+                idx = hash->next[idx - 1];
+            }
+        }
+        if ((retVal == NULL) && (hash->asmGhCount[gh] != 0))
+        {
+            idx = hash->asmBucket[AXP_TB_HASH(vpn, 0)];
+            while (idx != 0)
+            {
+                tlb = &tlbArray[idx - 1];
+                if ((tlb->virtAddr == vpn) && (tlb->gh == gh))
+                {
+                    retVal = tlb;
+                    break;
+                }
+                idx = hash->next[idx - 1];
             }
         }
     }
 
+    if (dtb == true)
+    {
+        AXP_COUNT(cpu, AXP_CNT_DTB_LOOKUPS);
+        if (retVal == NULL)
+        {
+            AXP_COUNT(cpu, AXP_CNT_DTB_MISSES);
+        }
+    }
+    else
+    {
+        AXP_COUNT(cpu, AXP_CNT_ITB_LOOKUPS);
+        if (retVal == NULL)
+        {
+            AXP_COUNT(cpu, AXP_CNT_ITB_MISSES);
+        }
+    }
+
     if (AXP_CACHE_CALL)
     {
         AXP_TRACE_BEGIN();
@@ -308,7 +569,10 @@ AXP_21264_TLB *AXP_getNextFreeTLB(AXP_21264_TLB *tlbArray, u32 *nextTLB)
  */
 void AXP_addTLBEntry(AXP_21264_CPU *cpu, u64 virtAddr, u64 physAddr, bool dtb)
 {
+    AXP_21264_TLB *tlbArray = (dtb ? cpu->dtb : cpu->itb);
+    AXP_21264_TLB_HASH *hash = (dtb ? &cpu->dtbHash : &cpu->itbHash);
     AXP_21264_TLB *tlbEntry;
+    u32 idx;
 
     if (AXP_CACHE_CALL)
     {
@@ -340,9 +604,22 @@ void AXP_addTLBEntry(AXP_21264_CPU *cpu, u64 virtAddr, u64 physAddr, bool dtb)
         }
     }
 
+    /*
+     * If the entry is currently valid (either it is the one we found or it is
+     * being reused), it needs to come off of its hash chain before any of the
+     * fields used to hash it get changed.
+     */
+    idx = tlbEntry - tlbArray;
+    if (tlbEntry->valid == true)
+    {
+        AXP_TLBHashRemove(hash, tlbArray, idx);
+        AXP_MicroTLBFlush(cpu, dtb);
+    }
+
     /*
      * Update the common fields for the TLB entry (for data and instruction).
      */
+    tlbEntry->gh = (dtb ? cpu->dtbPte0.gh : cpu->itbPte.gh);
     tlbEntry->matchMask = GH_MATCH(dtb ? cpu->dtbPte0.gh : cpu->itbPte.gh);
     tlbEntry->keepMask = GH_KEEP(dtb ? cpu->dtbPte0.gh : cpu->itbPte.gh);
     tlbEntry->virtAddr = virtAddr & tlbEntry->matchMask;
@@ -396,6 +673,7 @@ void AXP_addTLBEntry(AXP_21264_CPU *cpu, u64 virtAddr, u64 physAddr, bool dtb)
         tlbEntry->asn = cpu->pCtx.asn;
     }
     tlbEntry->valid = true; /* Mark the TLB entry as valid. */
+    AXP_TLBHashInsert(hash, tlbArray, idx);
 
     /*
      * Return back to the caller.
@@ -424,6 +702,7 @@ void AXP_addTLBEntry(AXP_21264_CPU *cpu, u64 virtAddr, u64 physAddr, bool dtb)
 void AXP_tbia(AXP_21264_CPU *cpu, bool dtb)
 {
     AXP_21264_TLB *tlbArray = (dtb ? cpu->dtb : cpu->itb);
+    AXP_21264_TLB_HASH *hash = (dtb ? &cpu->dtbHash : &cpu->itbHash);
     int ii;
 
     if (AXP_CACHE_CALL)
@@ -443,6 +722,12 @@ void AXP_tbia(AXP_21264_CPU *cpu, bool dtb)
         tlbArray[ii].valid = false;
     }
 
+    /*
+     * Since there are no valid entries left, the hashed index is now empty.
+     */
+    memset(hash, 0, sizeof(AXP_21264_TLB_HASH));
+    AXP_MicroTLBFlush(cpu, dtb);
+
     /*
      * Reset the next TLB entry to select to the start of the list.
      */
@@ -482,6 +767,7 @@ void AXP_tbia(AXP_21264_CPU *cpu, bool dtb)
 void AXP_tbiap(AXP_21264_CPU *cpu, bool dtb)
 {
     AXP_21264_TLB *tlbArray = (dtb ? cpu->dtb : cpu->itb);
+    AXP_21264_TLB_HASH *hash = (dtb ? &cpu->dtbHash : &cpu->itbHash);
     int ii;
 
     if (AXP_CACHE_CALL)
@@ -505,6 +791,15 @@ void AXP_tbiap(AXP_21264_CPU *cpu, bool dtb)
         }
     }
 
+    /*
+     * The process-specific entries are the only ones on the non-ASM hash
+     * chains, so all of these chains are now empty.  The ASM hash chains are
+     * left alone.
+     */
+    memset(hash->bucket, 0, sizeof(hash->bucket));
+    memset(hash->ghCount, 0, sizeof(hash->ghCount));
+    AXP_MicroTLBFlush(cpu, dtb);
+
     /*
      * Return back to the caller.
      */
@@ -550,7 +845,16 @@ void AXP_tbis(AXP_21264_CPU *cpu, u64 va, bool dtb)
      */
     if (tlb != NULL)
     {
+        if (dtb)
+        {
+            AXP_TLBHashRemove(&cpu->dtbHash, cpu->dtb, tlb - cpu->dtb);
+        }
+        else
+        {
+            AXP_TLBHashRemove(&cpu->itbHash, cpu->itb, tlb - cpu->itb);
+        }
         tlb->valid = false;
+        AXP_MicroTLBFlush(cpu, dtb);
     }
 
     /*
@@ -799,6 +1103,65 @@ AXP_EXCEPTIONS AXP_21264_checkMemoryAccess(AXP_21264_CPU *cpu,
     return (retVal);
 }
 
+/*
+ * AXP_va2paSuperPage
+ *  This function is called to convert a virtual address in one of the enabled
+ *  super pages to a physical address.  Super pages are only used in Kernel
+ *  mode, and do not go through the TLB.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the AXP 21264 CPU structure containing the current
+ *      execution mode and the super page enables.
+ *  va:
+ *      The virtual address value to be converted to a physical address.
+ *  dtb:
+ *      A boolean value indicating if the super page enables for data (M_CTL)
+ *      or instructions (I_CTL) are to be used.
+ *
+ * Output Parameters:
+ *  pa:
+ *      A pointer to a location to receive the physical address, when the
+ *      virtual address is in a super page.
+ *
+ * Return Value:
+ *  true:   The virtual address is in an enabled super page.
+ *  false:  The virtual address needs to be translated through the TLB.
+ */
+bool AXP_va2paSuperPage(AXP_21264_CPU *cpu, u64 va, bool dtb, u64 *pa)
+{
+    AXP_VA_SPE vaSpe =
+        {.va = va};
+    u8 spe = (dtb ? cpu->mCtl.spe : cpu->iCtl.spe);
+    bool retVal = false;
+
+    if ((spe != 0) && (cpu->ierCm.cm == AXP_CM_KERNEL))
+    {
+        if ((spe & AXP_SPE2_BIT) && (vaSpe.spe2.spe2 == AXP_SPE2_VA_VAL))
+        {
+            *pa = va & AXP_SPE2_VA_MASK;
+            retVal = true;
+        }
+        else if ((spe & AXP_SPE1_BIT) && (vaSpe.spe1.spe1 == AXP_SPE1_VA_VAL))
+        {
+            *pa = ((va & AXP_SPE1_VA_MASK) | ((va & AXP_SPE1_VA_40) ?
+                AXP_SPE1_PA_43_41 :
+                0));
+            retVal = true;
+        }
+        else if ((spe & AXP_SPE0_BIT) && (vaSpe.spe0.spe0 == AXP_SPE0_VA_VAL))
+        {
+            *pa = va & AXP_SPE0_VA_MASK;
+            retVal = true;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * AXP_va2pa
  *  This function is called to convert a virtual address to a physical address.
@@ -869,10 +1232,10 @@ u64 AXP_va2pa(AXP_21264_CPU *cpu,
               AXP_EXCEPTIONS *memChk)
 {
     AXP_21264_TLB *tlb;
-    AXP_VA_SPE vaSpe =
-        {.va = va};
+    AXP_21264_MICRO_TLB *micro;
+    u32 microGen = (dtb ? cpu->dtbMicroGen : cpu->itbMicroGen);
+    u8 asn = (dtb ? cpu->dtbAsn0.asn : cpu->pCtx.asn);
     u64 pa = 0x0ll;
-    u8 spe = (dtb ? cpu->mCtl.spe : cpu->iCtl.spe);
 
     /*
      * Initialize the output parameters.
@@ -900,37 +1263,29 @@ u64 AXP_va2pa(AXP_21264_CPU *cpu,
      * If we are using a super page and are in Kernel mode, then we need to go
      * down that translation path.
      */
-    else if ((spe != 0) && (cpu->ierCm.cm == AXP_CM_KERNEL))
+    else if (AXP_va2paSuperPage(cpu, va, dtb, &pa) == true)
     {
-        if ((spe & AXP_SPE2_BIT) && (vaSpe.spe2.spe2 == AXP_SPE2_VA_VAL))
-        {
-            pa = va & AXP_SPE2_VA_MASK;
-            if (_asm != NULL)
-            {
-                *_asm = false;
-            }
-            return (pa);
-        }
-        else if ((spe & AXP_SPE1_BIT) && (vaSpe.spe1.spe1 == AXP_SPE1_VA_VAL))
-        {
-            pa = ((va & AXP_SPE1_VA_MASK) | ((va & AXP_SPE1_VA_40) ?
-                AXP_SPE1_PA_43_41 :
-                0));
-            if (_asm != NULL)
-            {
-                *_asm = false;
-            }
-            return (pa);
-        }
-        else if ((spe & AXP_SPE0_BIT) && (vaSpe.spe0.spe0 == AXP_SPE0_VA_VAL))
+        return (pa);
+    }
+
+    /*
+     * Before going to the TLB, see if we have already translated this page,
+     * for this type of access in the current mode.  If so, the access has
+     * already been checked and we have the physical page.
+     */
+    micro = (dtb ?
+             &cpu->dtbMicro[acc][cpu->ierCm.cm][AXP_MICRO_TLB_IDX(va)] :
+             &cpu->itbMicro[acc][cpu->ierCm.cm][AXP_MICRO_TLB_IDX(va)]);
+    if ((micro->tag == AXP_MICRO_TLB_TAG(va)) &&
+        (micro->gen == microGen) &&
+        ((micro->_asm == true) || (micro->asn == asn)))
+    {
+        cpu->tbMissOutstanding = false;
+        if (_asm != NULL)
         {
-            pa = va & AXP_SPE0_VA_MASK;
-            if (_asm != NULL)
-            {
-                *_asm = false;
-            }
-            return (pa);
+            *_asm = micro->_asm;
         }
+        return (micro->physAddr | (va & (AXP_21264_PAGE_SIZE - 1)));
     }
 
     /*
@@ -998,6 +1353,15 @@ u64 AXP_va2pa(AXP_21264_CPU *cpu,
             {
                 *_asm = tlb->_asm;
             }
+
+            /*
+             * Remember this translation for the next time around.
+             */
+            micro->tag = AXP_MICRO_TLB_TAG(va);
+            micro->physAddr = pa & ~(AXP_21264_PAGE_SIZE - 1);
+            micro->gen = microGen;
+            micro->asn = tlb->asn;
+            micro->_asm = tlb->_asm;
         }
     }
 
@@ -1353,6 +1717,9 @@ bool AXP_DcacheWrite(AXP_21264_CPU *cpu,
      * throughout this function.  The Dcache one is used sporadically in this
      * function.
      */
+    AXP_COUNT(cpu,
+              (len == AXP_DCACHE_DATA_LEN) ?
+                  AXP_CNT_DCACHE_FILLS : AXP_CNT_DCACHE_WRITES);
     pthread_mutex_lock(&cpu->dtagMutex);
     pthread_mutex_lock(&cpu->dCacheMutex);
     switch (len)
@@ -1944,6 +2311,11 @@ bool AXP_DcacheRead(AXP_21264_CPU *cpu,
         }
     }
     pthread_mutex_unlock(&cpu->dtagMutex);
+    AXP_COUNT(cpu, AXP_CNT_DCACHE_READS);
+    if (retVal == false)
+    {
+        AXP_COUNT(cpu, AXP_CNT_DCACHE_READ_MISSES);
+    }
 
     /*
      * If we found what we were looking for, so save the value requested
@@ -1998,6 +2370,132 @@ bool AXP_DcacheRead(AXP_21264_CPU *cpu,
 /*                                                                          */
 /****************************************************************************/
 
+/*
+ * AXP_IcacheLock
+ *  This function is called by the functions that change the Icache to lock
+ *  the Icache mutex.  If some other writer already has it locked, the wait is
+ *  counted, so that we can tell how much contention there is.
+ *
+ * Input Parameters:
+ *   cpu:
+ *       A pointer to the Digital Alpha AXP 21264 CPU structure containing the
+ *       Instruction Cache (iCache) array.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void AXP_IcacheLock(AXP_21264_CPU *cpu)
+{
+    if (pthread_mutex_trylock(&cpu->iCacheMutex) != 0)
+    {
+        pthread_mutex_lock(&cpu->iCacheMutex);
+        cpu->iCacheWriteWaits++;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_IcacheWriteBegin
+ *  This function is called, with the Icache mutex locked, before changing an
+ *  Icache block.  It makes the sequence number odd, so that readers know not
+ *  to trust what they are reading.
+ *
+ * Input Parameters:
+ *  blk:
+ *      A pointer to the Icache block about to be changed.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static inline void AXP_IcacheWriteBegin(AXP_ICACHE_BLK *blk)
+{
+    __atomic_store_n(&blk->seq, blk->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return;
+}
+
+/*
+ * AXP_IcacheWriteEnd
+ *  This function is called, with the Icache mutex locked, after changing an
+ *  Icache block.  It makes the sequence number even again.
+ *
+ * Input Parameters:
+ *  blk:
+ *      A pointer to the Icache block just changed.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static inline void AXP_IcacheWriteEnd(AXP_ICACHE_BLK *blk)
+{
+    __atomic_store_n(&blk->seq, blk->seq + 1, __ATOMIC_RELEASE);
+    return;
+}
+
+/*
+ * AXP_IcacheReadBegin
+ *  This function is called before reading an Icache block without the Icache
+ *  mutex locked.  It waits for any write in progress to complete.
+ *
+ * Input Parameters:
+ *  blk:
+ *      A pointer to the Icache block about to be read.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The sequence number to be passed to AXP_IcacheReadRetry.
+ */
+static inline u32 AXP_IcacheReadBegin(AXP_ICACHE_BLK *blk)
+{
+    u32 seq;
+
+    while (((seq = __atomic_load_n(&blk->seq, __ATOMIC_ACQUIRE)) & 1) != 0)
+    {
+        sched_yield();
+    }
+    return (seq);
+}
+
+/*
+ * AXP_IcacheReadRetry
+ *  This function is called after reading an Icache block without the Icache
+ *  mutex locked.  It determines if the block was changed while it was being
+ *  read, in which case it needs to be read again.
+ *
+ * Input Parameters:
+ *  blk:
+ *      A pointer to the Icache block just read.
+ *  seq:
+ *      The value returned by AXP_IcacheReadBegin.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The block changed and needs to be read again.
+ *  false:  What was read is consistent.
+ */
+static inline bool AXP_IcacheReadRetry(AXP_ICACHE_BLK *blk, u32 seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (__atomic_load_n(&blk->seq, __ATOMIC_RELAXED) != seq);
+}
+
 /*
  * AXP_IcacheAdd
  *  This function is called to add a set of instructions (16 32-bit
@@ -2036,10 +2534,12 @@ void AXP_IcacheAdd(AXP_21264_CPU *cpu,
                    AXP_21264_TLB *itb)
 {
     AXP_VPC vpc = {.pc = pc};
+    AXP_ICACHE_BLK *blk;
     u32 index = vpc.vpcFields.index;
     u64 tag = vpc.vpcFields.tag;
     u32 ii;
     u32 sets, whichSet;
+    bool set_0_1;
 
     if (AXP_CACHE_CALL)
     {
@@ -2055,7 +2555,7 @@ void AXP_IcacheAdd(AXP_21264_CPU *cpu,
      * First things first, we need to lock the Icache from being updated by
      * anyone but us.
      */
-    pthread_mutex_lock(&cpu->iCacheMutex);
+    AXP_IcacheLock(cpu);
 
     /*
      * 5.3.10 Determine how many sets are enabled.
@@ -2090,46 +2590,71 @@ void AXP_IcacheAdd(AXP_21264_CPU *cpu,
         if (cpu->iCache[index][0].vb == 0)
         {
             whichSet = 0;
-            cpu->iCache[index][0].set_0_1 = 1;
+            set_0_1 = 1;
         }
         else if (cpu->iCache[index][1].vb == 0)
         {
             whichSet = 1;
-            cpu->iCache[index][0].set_0_1 = 0;
+            set_0_1 = 0;
         }
         else if (cpu->iCache[index][0].set_0_1 == 0)
         {
             whichSet = 0;
-            cpu->iCache[index][0].set_0_1 = 1;
+            set_0_1 = 1;
         }
         else
         {
             whichSet = 1;
-            cpu->iCache[index][0].set_0_1 = 0;
+            set_0_1 = 0;
         }
     }
     else
     {
         whichSet = 0; /* just one set is in use. */
-        cpu->iCache[index][0].set_0_1 = 0;
+        set_0_1 = 0;
+    }
+
+    /*
+     * The set_0_1 bit shares a word with the valid bit and tag of set zero,
+     * so if we are filling set one, set zero is also being changed.
+     */
+    if (whichSet != 0)
+    {
+        AXP_IcacheWriteBegin(&cpu->iCache[index][0]);
+        cpu->iCache[index][0].set_0_1 = set_0_1;
+        AXP_IcacheWriteEnd(&cpu->iCache[index][0]);
     }
 
     /*
      * Initialize the cache entry with the supplied information.
      */
-    cpu->iCache[index][whichSet].kre = itb->kre;
-    cpu->iCache[index][whichSet].ere = itb->ere;
-    cpu->iCache[index][whichSet].sre = itb->sre;
-    cpu->iCache[index][whichSet].ure = itb->ure;
-    cpu->iCache[index][whichSet]._asm = itb->_asm;
-    cpu->iCache[index][whichSet].asn = itb->asn;
-    cpu->iCache[index][whichSet].pal = pc.pal;
-    cpu->iCache[index][whichSet].vb = 1;
-    cpu->iCache[index][whichSet].tag = tag;
+    blk = &cpu->iCache[index][whichSet];
+    AXP_IcacheWriteBegin(blk);
+    if (whichSet == 0)
+    {
+        blk->set_0_1 = set_0_1;
+    }
+    blk->kre = itb->kre;
+    blk->ere = itb->ere;
+    blk->sre = itb->sre;
+    blk->ure = itb->ure;
+    blk->_asm = itb->_asm;
+    blk->asn = itb->asn;
+    blk->pal = pc.pal;
+    blk->vb = 1;
+    blk->tag = tag;
+
+    /*
+     * The instructions in this block have changed, so predecode them now.
+     * Doing it here, rather than the first time each one is fetched, means
+     * that fetching never has to write into the block.
+     */
     for (ii = 0; ii < AXP_ICACHE_LINE_INS; ii++)
     {
-        cpu->iCache[index][whichSet].instructions[ii].instr = nextInst[ii];
+        blk->instructions[ii].instr = nextInst[ii];
+        AXP_Predecode(blk->instructions[ii], &blk->predecoded[ii]);
     }
+    AXP_IcacheWriteEnd(blk);
 
     /*
      * Return back to the caller.
@@ -2183,7 +2708,13 @@ void AXP_IcacheFlush(AXP_21264_CPU *cpu, bool purgeAsm)
      * First things first, we need to lock the Icache from being updated by
      * anyone but us.
      */
-    pthread_mutex_lock(&cpu->iCacheMutex);
+    AXP_IcacheLock(cpu);
+
+    /*
+     * The translated blocks were made from the instructions in the Icache, so
+     * they need to go too.
+     */
+    AXP_21264_Xlate_Flush(cpu);
 
     for (ii = 0; ii < AXP_CACHE_ENTRIES; ii++)
     {
@@ -2198,6 +2729,7 @@ void AXP_IcacheFlush(AXP_21264_CPU *cpu, bool purgeAsm)
             if (((purgeAsm == true) && (cpu->iCache[ii][0]._asm == 0)) ||
                 (purgeAsm == false))
             {
+                AXP_IcacheWriteBegin(&cpu->iCache[ii][0]);
                 cpu->iCache[ii][0].kre = 0;
                 cpu->iCache[ii][0].ere = 0;
                 cpu->iCache[ii][0].sre = 0;
@@ -2213,6 +2745,10 @@ void AXP_IcacheFlush(AXP_21264_CPU *cpu, bool purgeAsm)
                            0,
                            sizeof(AXP_INS_FMT));
                 }
+                memset(cpu->iCache[ii][0].predecoded,
+                       0,
+                       sizeof(cpu->iCache[ii][0].predecoded));
+                AXP_IcacheWriteEnd(&cpu->iCache[ii][0]);
             }
         }
 
@@ -2224,6 +2760,7 @@ void AXP_IcacheFlush(AXP_21264_CPU *cpu, bool purgeAsm)
             if (((purgeAsm == true) && (cpu->iCache[ii][1]._asm == 0)) ||
                 (purgeAsm == false))
             {
+                AXP_IcacheWriteBegin(&cpu->iCache[ii][1]);
                 cpu->iCache[ii][1].kre = 0;
                 cpu->iCache[ii][1].ere = 0;
                 cpu->iCache[ii][1].sre = 0;
@@ -2239,6 +2776,10 @@ void AXP_IcacheFlush(AXP_21264_CPU *cpu, bool purgeAsm)
                            0,
                            sizeof(AXP_INS_FMT));
                 }
+                memset(cpu->iCache[ii][1].predecoded,
+                       0,
+                       sizeof(cpu->iCache[ii][1].predecoded));
+                AXP_IcacheWriteEnd(&cpu->iCache[ii][1]);
             }
         }
     }
@@ -2290,8 +2831,12 @@ bool AXP_IcacheFetch(AXP_21264_CPU *cpu, AXP_PC pc, AXP_INS_LINE *next)
     u32 index = vpc.vpcFields.index;
     u64 tag = vpc.vpcFields.tag;
     u32 offset = vpc.vpcFields.offset % AXP_ICACHE_LINE_INS;
+    u32 count = AXP_NUM_FETCH_INS;
+    AXP_ICACHE_BLK *blk;
     u32 ii;
     u32 sets, whichSet = 0;
+    u32 seq;
+    bool retry;
 
     if (AXP_CACHE_CALL)
     {
@@ -2302,10 +2847,12 @@ bool AXP_IcacheFetch(AXP_21264_CPU *cpu, AXP_PC pc, AXP_INS_LINE *next)
     }
 
     /*
-     * First things first, we need to lock the Icache from being updated by
-     * anyone but us.
+     * Only the instructions up to the end of the block can be fetched.
      */
-    pthread_mutex_lock(&cpu->iCacheMutex);
+    if ((offset + count) > AXP_ICACHE_LINE_INS)
+    {
+        count = AXP_ICACHE_LINE_INS - offset;
+    }
 
     /*
      * 5.3.10 Determine how many sets are enabled.
@@ -2328,31 +2875,75 @@ bool AXP_IcacheFetch(AXP_21264_CPU *cpu, AXP_PC pc, AXP_INS_LINE *next)
      */
     sets = (cpu->iCtl.ic_en == 1) ? 1 : 2;
 
-    if ((cpu->iCache[index][next->setPrediction].vb == 1) &&
-        (cpu->iCache[index][next->setPrediction].tag == tag))
+    /*
+     * The Icache is not locked, so if the block we used changes while we are
+     * copying instructions out of it, we have to start again.  A block that
+     * changes while we are deciding that it is not the one we want does not
+     * matter, the Ibox will just request the fill again.
+     */
+    do
     {
-        whichSet = next->setPrediction;
-        retVal = true;
-    }
-    else if ((cpu->iCache[index][(next->setPrediction + 1) & 1].vb == 1) &&
-             (cpu->iCache[index][(next->setPrediction + 1) & 1].tag == tag))
+        retVal = false;
+        retry = false;
+        for (ii = 0; ((ii < AXP_2_WAY_CACHE) && (retVal == false)); ii++)
+        {
+            whichSet = (next->setPrediction + ii) & 1;
+            blk = &cpu->iCache[index][whichSet];
+            seq = AXP_IcacheReadBegin(blk);
+            if ((blk->vb == 1) && (blk->tag == tag))
+            {
+                retVal = true;
+            }
+        }
+
+        /*
+         * If we found what were were asked to find, then get the next set of
+         * instructions and their predecoded versions.  The instructions past
+         * the end of the block are not in it, so we stop there.
+         */
+        if (retVal == true)
+        {
+            for (ii = 0; ii < count; ii++)
+            {
+                next->instructions[ii] = blk->instructions[offset + ii];
+                next->predecoded[ii] = blk->predecoded[offset + ii];
+            }
+            retry = AXP_IcacheReadRetry(blk, seq);
+            if (retry == true)
+            {
+                cpu->iCacheReadRetries++;
+            }
+        }
+    } while (retry == true);
+    AXP_COUNT(cpu, AXP_CNT_ICACHE_FETCHES);
+    if (retVal == false)
     {
-        whichSet = (next->setPrediction + 1) & 1;
-        retVal = true;
+        AXP_COUNT(cpu, AXP_CNT_ICACHE_MISSES);
     }
 
     /*
-     * If we found what were were asked to find, then get the next set of
-     * instructions and return them to the caller
+     * Finish setting up the instructions and return them to the caller.  The
+     * slots after the end of the block are marked as not valid, and the
+     * caller fetches those instructions from the next block.
      */
     if (retVal == true)
     {
         tmpPC = pc;
+        next->instrCount = count;
         for (ii = 0; ii < AXP_NUM_FETCH_INS; ii++)
         {
-            next->instructions[ii] =
-                cpu->iCache[index][whichSet].instructions[offset + ii];
-            next->instrType[ii] = AXP_InstructionFormat(next->instructions[ii]);
+            if (ii < count)
+            {
+                next->instrType[ii] = next->predecoded[ii].format;
+            }
+            else
+            {
+                next->instructions[ii].instr = 0;
+                memset(&next->predecoded[ii],
+                       0,
+                       sizeof(AXP_ICACHE_PREDECODE));
+                next->instrType[ii] = Res;
+            }
             next->instrPC[ii] = tmpPC;
             tmpPC.pc++;
         }
@@ -2404,8 +2995,6 @@ bool AXP_IcacheFetch(AXP_21264_CPU *cpu, AXP_PC pc, AXP_INS_LINE *next)
     /*
      * Return back to the caller.
      */
-    pthread_mutex_unlock(&cpu->iCacheMutex);
-
     if (AXP_CACHE_CALL)
     {
         AXP_TRACE_BEGIN();
@@ -2446,8 +3035,11 @@ bool AXP_IcacheValid(AXP_21264_CPU *cpu, AXP_PC pc)
         {.pc = pc};
     u32 index = vpc.vpcFields.index;
     u64 tag = vpc.vpcFields.tag;
+    AXP_ICACHE_BLK *blk;
     u32 ii;
     u32 sets;
+    u32 seq;
+    bool retry;
 
     if (AXP_CACHE_CALL)
     {
@@ -2457,12 +3049,6 @@ bool AXP_IcacheValid(AXP_21264_CPU *cpu, AXP_PC pc)
         AXP_TRACE_END();
     }
 
-    /*
-     * First things first, we need to lock the Icache from being updated by
-     * anyone but us.
-     */
-    pthread_mutex_lock(&cpu->iCacheMutex);
-
     /*
      * 5.3.10 Determine how many sets are enabled.
      *
@@ -2484,19 +3070,28 @@ bool AXP_IcacheValid(AXP_21264_CPU *cpu, AXP_PC pc)
      */
     sets = (cpu->iCtl.ic_en == 1) ? 1 : 2;
 
+    /*
+     * The Icache is not locked, so if a block changes while we are looking at
+     * it, look at it again.
+     */
     for (ii = 0; ((ii < sets) & (retVal == false)); ii++)
     {
-        if ((cpu->iCache[index][ii].vb == 1) &&
-            (cpu->iCache[index][ii].tag == tag))
+        blk = &cpu->iCache[index][ii];
+        do
         {
-            retVal = true;
-        }
+            seq = AXP_IcacheReadBegin(blk);
+            retVal = (blk->vb == 1) && (blk->tag == tag);
+            retry = AXP_IcacheReadRetry(blk, seq);
+            if (retry == true)
+            {
+                cpu->iCacheReadRetries++;
+            }
+        } while (retry == true);
     }
 
     /*
      * Return back to the caller.
      */
-    pthread_mutex_unlock(&cpu->iCacheMutex);
 
     if (AXP_CACHE_CALL)
     {
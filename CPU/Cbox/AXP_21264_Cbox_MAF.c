@@ -28,6 +28,20 @@
  *  GCC 7.4.0, and possibly earlier, turns on strict-aliasing rules by default.
  *  There are a number of issues in this module where the address of one
  *  variable is cast to extract a value in a different format.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Count the MAF requests, the ones merged, and the entries in use, in the
+ *  performance counters.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Memory block reads, when no other CPU needs to be probed, are now filled
+ *  directly from host memory, without sending a request to the System.  A
+ *  block fill now copies the whole block, and completes each of the merged
+ *  loads and stores.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  The request sent to the System now carries the MAF entry, so that the
+ *  response completes the right one.
  */
 #include "CPU/Cbox/AXP_21264_Cbox.h"
 #include "CommonUtilities/AXP_Configure.h"
@@ -107,7 +121,8 @@ int AXP_21264_MAF_Empty(AXP_21264_CPU *cpu)
 /*
  * AXP_21264_Process_MAF
  *  This function is called to check the first unprocessed entry on the queue
- *  containing the MAF records.
+ *  containing the MAF records.  A read of a memory block that can be found in
+ *  host memory is completed here, otherwise the request is sent to the System.
  *
  * Input Parameters:
  *  cpu:
@@ -126,99 +141,133 @@ void AXP_21264_Process_MAF(AXP_21264_CPU *cpu, int entry)
 {
     AXP_21264_CBOX_MAF *maf = &cpu->maf[entry];
     AXP_21264_SYSBUS_System sys;
+    u8 *block = NULL;
 
     /*
-     * Process the next MAF entry that needs it.
-     *
-     * TODO: Need to look at Speculative Transactions.
+     * A read of a memory block (ReadBlk, ReadBlkI, and ReadBlkMod) can be
+     * filled straight from host memory, when no other CPU needs to be probed.
+     * The response is the one the System would have sent.
      */
-    switch (maf->type)
+    if ((maf->ioReq == false) &&
+        ((maf->type == LDx) ||
+         (maf->type == Istream) ||
+         (maf->type == STx) ||
+         (maf->type == STx_C)))
     {
-        case LDx:
-            if (maf->ioReq == true)
-            {
-                switch (maf->dataLen)
+        block = AXP_21264_DirectMem(cpu, maf->pa, -1);
+    }
+    if (block != NULL)
+    {
+        AXP_COUNT(cpu, AXP_CNT_DIRECT_READS);
+        maf->complete = true;
+        AXP_21264_Complete_MAF(cpu,
+                               entry,
+                               (((maf->type == STx) || (maf->type == STx_C)) ?
+                                ReadDataDirty : ReadData),
+                               block);
+    }
+    else
+    {
+
+        /*
+         * Process the next MAF entry that needs it.
+         *
+         * TODO: Need to look at Speculative Transactions.
+         */
+        memset(&sys, 0, sizeof(sys));
+        switch (maf->type)
+        {
+            case LDx:
+                if (maf->ioReq == true)
                 {
-                    case BYTE_LEN:
-                        sys.cmd = ReadBytes;
-                        break;
+                    switch (maf->dataLen)
+                    {
+                        case BYTE_LEN:
+                            sys.cmd = ReadBytes;
+                            break;
 
-                    case WORD_LEN:
-                        sys.cmd = ReadBytes;
-                        break;
+                        case WORD_LEN:
+                            sys.cmd = ReadBytes;
+                            break;
 
-                    case LONG_LEN:
-                        sys.cmd = ReadLWs;
-                        break;
+                        case LONG_LEN:
+                            sys.cmd = ReadLWs;
+                            break;
 
-                    case QUAD_LEN:
-                        sys.cmd = ReadQWs;
-                        break;
+                        case QUAD_LEN:
+                            sys.cmd = ReadQWs;
+                            break;
+                    }
                 }
-            }
-            else
-            {
-                sys.cmd = ReadBlk;
-            }
-            break;
+                else
+                {
+                    sys.cmd = ReadBlk;
+                }
+                break;
 
-        case STx:
-        case STx_C:
-            sys.cmd = ReadBlkMod;
-            break;
+            case STx:
+            case STx_C:
+                sys.cmd = ReadBlkMod;
+                break;
 
-        case STxChangeToDirty:
-            if (maf->shared == true)
-            {
-                sys.cmd = SharedToDirty;
-            }
-            else
-            {
-                sys.cmd = CleanToDirty;
-            }
-            break;
+            case STxChangeToDirty:
+                if (maf->shared == true)
+                {
+                    sys.cmd = SharedToDirty;
+                }
+                else
+                {
+                    sys.cmd = CleanToDirty;
+                }
+                break;
 
-        case STxCChangeToDirty:
-            sys.cmd = STCChangeToDirty;
-            break;
+            case STxCChangeToDirty:
+                sys.cmd = STCChangeToDirty;
+                break;
 
-        case WH64:
-            sys.cmd = InvalToDirty;
-            break;
+            case WH64:
+                sys.cmd = InvalToDirty;
+                break;
 
-        case ECB:
-            sys.cmd = Evict;
-            break;
+            case ECB:
+                sys.cmd = Evict;
+                break;
 
-        case Istream:
-            sys.cmd = ReadBlkI;
-            break;
+            case Istream:
+                sys.cmd = ReadBlkI;
+                break;
 
-        case MemoryBarrier:
-            sys.cmd = Sysbus_MB;
-            break;
+            case MemoryBarrier:
+                sys.cmd = Sysbus_MB;
+                break;
 
-        default:
-            break;
-    }
+            default:
+                break;
+        }
 
-    /*
-     * Go check the Oldest pending PQ and set the flags for it here and now.
-     */
-    AXP_21264_OldestPQFlags(cpu, &sys.m1, &sys.m2, &sys.ch);
+        /*
+         * Go check the Oldest pending PQ and set the flags for it here and now.
+         */
+        AXP_21264_OldestPQFlags(cpu, &sys.m1, &sys.m2, &sys.ch);
 
-    /*
-     * OK, send what we have to the System.
-     */
-    sys.mask = maf->mask;
-    sys.pa = maf->pa;
-    sys.rv = true;
-    AXP_21264_SendToSystem(cpu, &sys);
+        /*
+         * OK, send what we have to the System.
+         */
+        sys.mask = maf->mask;
+        sys.pa = maf->pa;
+        sys.rv = true;
+        sys.id = entry;
+        AXP_21264_SendToSystem(cpu, &sys);
+
+        /*
+         * Indicate that the entry is now processed.
+         */
+        maf->complete = true;
+    }
 
     /*
-     * Indicate that the entry is now processed and return back to the caller.
+     * Return back to the caller.
      */
-    maf->complete = true;
     return;
 }
 
@@ -298,11 +347,13 @@ void AXP_21264_Complete_MAF(AXP_21264_CPU *cpu,
                 /*
                  * ReadBlk (data length = 64)
                  * ReadBlkI (data length = 64)
+                 *
+                 * The whole block is returned, and is given to each of the
+                 * loads merged into this entry.  An Istream fill has no loads
+                 * waiting on it, but is still done the once.
                  */
-                dataLen = AXP_DCACHE_DATA_LEN;
-                while (curPtr != -1)
+                do
                 {
-                    bufIndex = AXP_MaskGet(&curPtr, maf->mask, dataLen);
                     switch (sysDc)
                     {
 
@@ -364,14 +415,14 @@ void AXP_21264_Complete_MAF(AXP_21264_CPU *cpu,
                     {
                         AXP_21264_Ibox_UpdateIcache(cpu,
                                                     maf->pa,
-                                                    &sysData[bufIndex],
+                                                    sysData,
                                                     cacheStatus);
                     }
                     else if (error == false)
                     {
                         AXP_21264_Mbox_UpdateDcache(cpu,
                                                     maf->lqSqEntry[ii],
-                                                    &sysData[bufIndex],
+                                                    sysData,
                                                     cacheStatus);
                     }
                     if (maf->type == LDx)
@@ -383,7 +434,8 @@ void AXP_21264_Complete_MAF(AXP_21264_CPU *cpu,
                                                  error);
                     }
                     ii++;
-                }
+                } while ((ii < AXP_21264_MBOX_MAX) &&
+                         (maf->lqSqEntry[ii] != 0));
             }
 
             /*
@@ -447,10 +499,8 @@ void AXP_21264_Complete_MAF(AXP_21264_CPU *cpu,
         case STx:
         case STx_C:
             /* cmd = ReadBlkMod (data length = 64) */
-            dataLen = AXP_DCACHE_DATA_LEN;
-            while (curPtr != -1)
+            do
             {
-                bufIndex = AXP_MaskGet(&curPtr, maf->mask, dataLen);
                 switch (sysDc)
                 {
 
@@ -515,7 +565,7 @@ void AXP_21264_Complete_MAF(AXP_21264_CPU *cpu,
                 {
                     AXP_21264_Mbox_UpdateDcache(cpu,
                                                 maf->lqSqEntry[ii],
-                                                &sysData[bufIndex],
+                                                sysData,
                                                 cacheStatus);
                 }
                 AXP_21264_Mbox_CboxCompl(cpu,
@@ -524,7 +574,7 @@ void AXP_21264_Complete_MAF(AXP_21264_CPU *cpu,
                                          0,
                                          error);
                 ii++;
-            }
+            } while ((ii < AXP_21264_MBOX_MAX) && (maf->lqSqEntry[ii] != 0));
             break;
 
         /*
@@ -1206,6 +1256,7 @@ void AXP_21264_Add_MAF(AXP_21264_CPU *cpu,
     int ii;
     bool ioRq = AXP_21264_IS_IO_ADDR(pa);
     bool notMerged;
+    u64 inUse = 0;
 
     /*
      * Before we do anything, lock the interface mutex to prevent multiple
@@ -1280,6 +1331,24 @@ void AXP_21264_Add_MAF(AXP_21264_CPU *cpu,
         maf->shared = shared;
         maf->valid = true;
     }
+    else
+    {
+        AXP_COUNT(cpu, AXP_CNT_MAF_MERGES);
+    }
+
+    /*
+     * Keep track of how many requests there have been, and how many MAF
+     * entries were in use after each one.
+     */
+    AXP_COUNT(cpu, AXP_CNT_MAF_REQUESTS);
+    for (ii = 0; ii < AXP_21264_MAF_LEN; ii++)
+    {
+        if (cpu->maf[ii].valid == true)
+        {
+            inUse++;
+        }
+    }
+    AXP_COUNT_ADD(cpu, AXP_CNT_MAF_IN_USE, inUse);
 
     /*
      * Let the Cbox know there is something for it to process, then unlock the
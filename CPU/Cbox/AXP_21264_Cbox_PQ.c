@@ -28,6 +28,12 @@
  *  GCC 7.4.0, and possibly earlier, turns on strict-aliasing rules by default.
  *  There are a number of issues in this module where the address of one
  *  variable is cast to extract a value in a different format.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  The Bcache mutex was being locked a second time, rather than unlocked,
+ *  after processing a PQ entry, which hung the next one.  The Cbox IPR mutex
+ *  is no longer held while completing the MAF entry, as writing the Dcache
+ *  locks it.
  */
 #include "CPU/Cbox/AXP_21264_Cbox.h"
 #include "CommonUtilities/AXP_Configure.h"
@@ -698,9 +704,15 @@ void AXP_21264_Process_PQ(AXP_21264_CPU *cpu, int entry)
             pthread_mutex_unlock(&cpu->dtagMutex);
         }
 
+        pthread_mutex_unlock(&cpu->bCacheMutex);
+
         /*
-         * Process the SysDc section of the request.
+         * Process the SysDc section of the request.  Completing a MAF entry
+         * writes the Dcache, which locks the Cbox IPR mutex, so it is unlocked
+         * until the SysDc has been processed.  Only the Cbox processes the
+         * PQ, so the entry is not going to be processed by anyone else.
          */
+        pthread_mutex_unlock(&cpu->cBoxIPRMutex);
         switch (pq->sysDc)
         {
             case SysDC_Nop:
@@ -980,7 +992,7 @@ void AXP_21264_Process_PQ(AXP_21264_CPU *cpu, int entry)
                                        (u8 *) pq->sysData);
                 break;
         }
-        pthread_mutex_lock(&cpu->bCacheMutex);
+        pthread_mutex_lock(&cpu->cBoxIPRMutex);
 
         /*
          * Indicate that the entry is now processed, and unlock the Cbox IPR
@@ -31,6 +31,10 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Victims to be written to memory, when no other CPU needs to be probed, are
+ *  now written directly to host memory, without sending them to the System.
  */
 #include "CPU/Cbox/AXP_21264_Cbox.h"
 #include "CommonUtilities/AXP_Configure.h"
@@ -110,7 +114,8 @@ AXP_21264_VDB_Empty(AXP_21264_CPU *cpu)
 /*
  * AXP_21264_Process_VDB
  *  This function is called to check the first unprocessed entry on the queue
- *  containing the VDB records.
+ *  containing the VDB records.  A victim to be written to a memory block that
+ *  can be found in host memory is written, and the entry freed, here.
  *
  * Input Parameters:
  *  cpu:
@@ -130,6 +135,7 @@ AXP_21264_Process_VDB(AXP_21264_CPU *cpu, int entry)
 {
     AXP_21264_CBOX_VIC_BUF *vdb = &cpu->vdb[entry];
     AXP_21264_SYSBUS_System sys;
+    u8 *block;
 
     /*
      * Process the next VDB entry that needs it.
@@ -146,12 +152,26 @@ AXP_21264_Process_VDB(AXP_21264_CPU *cpu, int entry)
             break;
 
             /*
-             * We need to write a Bcache block out to memory.
-             *           or
+             * We need to write a Bcache block out to memory.  If there is no
+             * other CPU to be probed, this is done here, just as the System
+             * would have done it, and the buffer is released.
+             */
+        case toMemory:
+            block = AXP_21264_DirectMem(cpu, vdb->pa, entry);
+            if (block != NULL)
+            {
+                AXP_COUNT(cpu, AXP_CNT_DIRECT_WRITES);
+                memcpy(block, vdb->sysData, AXP_21264_SIZE_QUAD);
+                AXP_21264_Free_VDB(cpu, entry);
+                break;
+            }
+
+            /*
+             * Fall through to send the victim to the System.
+             *
              * Dcache or Bcache blocks to send to the system in response to a
              * probe command.
              */
-        case toMemory:
         case probeResponse:
 
             /*
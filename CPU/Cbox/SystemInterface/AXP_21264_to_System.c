@@ -28,48 +28,70 @@
  *  The clang-9 compiler is reporting some errors that GCC was not.  These will
  *  be fixed so that this software can compile cleanly with either GCC or
  *  clang.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Added a function to find a memory block in host memory, so that the Cbox
+ *  can read and write it without sending a request to the System.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Requests are now put into one of this CPU's request entries and onto this
+ *  CPU's request ring, rather than over the System's one request queue.
  */
 #include "CommonUtilities/AXP_Utility.h"
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/AXP_21264_CPU.h"
+#include <sched.h>
 
 /*
  * AXP_21264_SendToSystem
  *  This function is called with a pointer to the SysBus message and a pointer
- *  to the CPU structure, and sends the message to the CPU, locking the correct
- *  mutex and signaling the correct condition variable.
+ *  to the CPU structure, and sends the message to the System.  The message is
+ *  copied into one of this CPU's request entries, which is put onto this
+ *  CPU's request ring, and the System is signaled.  Nothing is locked, as
+ *  this CPU is the only one to put entries onto its ring.
+ *
+ *  The System frees the entry before sending its response, which it does with
+ *  the Cbox interface mutex locked.  So, when all the entries are in use, we
+ *  can wait here for one to be freed, even with the mutex locked.
  *
  * Input Parameters:
  *  cpu:
  *      A pointer to the CPU structure for the emulation.
  *  msg:
- *      A pointer to the message to send to the specified CPU.
+ *      A pointer to the message to send to the System.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
  */
 void AXP_21264_SendToSystem(AXP_21264_CPU *cpu, AXP_21264_SYSBUS_System *msg)
 {
-    AXP_21264_RQ_ENTRY *rq;
+    AXP_21264_RQ_ENTRY *rq = NULL;
+    int ii;
 
     /*
-     * Lock the mutex so that no one else tries to manipulate the queue or the
-     * index into it.
+     * Find a request entry that the System is not using.
      */
-    pthread_mutex_lock(cpu->system.mutex);
-
-    /*
-     * Queue up the next PQ entry for the CPU to process.
-    if (cpu->system.rq[*cpu->system.rqEnd].valid == true)
-        *cpu->system.rqEnd = (*cpu->system.rqEnd + 1) % AXP_21264_CCHIP_RQ_LEN;
-     *
-     * TODO:    The below is bogus.  We need to rationalize the interfaces
-     *          between components.  This is just to keep the compiler happy.
-     */
-    rq = (AXP_21264_RQ_ENTRY *) cpu->system.rq; /*[*cpu->system.rqEnd]; */
+    while (rq == NULL)
+    {
+        for (ii = 0; ((ii < AXP_21264_CCHIP_RQ_LEN) && (rq == NULL)); ii++)
+        {
+            if (__atomic_load_n(&cpu->system.rq[ii].inUse,
+                                __ATOMIC_ACQUIRE) == false)
+            {
+                rq = &cpu->system.rq[ii];
+            }
+        }
+        if (rq == NULL)
+        {
+            sched_yield();
+        }
+    }
 
     /*
-     * Copy the data from the System structure and into the CPU structure.
-     *
-     * TODO:    We need to do something about data movement, mask, deal with a
-     *          probeResponse, and wrapping data.
+     * Copy the data from the message into the request entry.
      *
      * TODO:    There is way too much copying of data from one buffer to the
      *          next.  We should look at defining a pool of buffers that can
@@ -77,50 +99,92 @@ void AXP_21264_SendToSystem(AXP_21264_CPU *cpu, AXP_21264_SYSBUS_System *msg)
      *          only be copied out of the source and copied into the
      *          destination.
      */
+    memcpy(rq->sysData, msg->sysData, sizeof(rq->sysData));
+    rq->mask = msg->mask;
     rq->pa = msg->pa;
+    rq->cmd = msg->cmd;
+    rq->status = HitClean;  /* Just initializing */
+    rq->entry = msg->id;
+    rq->sysDataLen = AXP_21264_DATA_SIZE;
+    rq->cpuID = cpu->whami;
+    rq->waitVector = 0;
     rq->miss1 = msg->m1;
     rq->miss2 = msg->m2;
-    /* rq->status = msg->cmd;   TODO: Probably not correct */
-    rq->cacheHit = msg->ch;
     rq->rqValid = msg->rv;
-    rq->valid = true;
-    rq->waitVector = msg->id; /* TODO: Probably not correct */
-    rq->mask = msg->mask;
-    switch (msg->cmd)
-    {
-        case ReadDataError:
-            memset(rq->sysData, 0xff, (AXP_21264_DATA_SIZE * sizeof(rq->sysData)));
-            /* rq->dm = true; */
-            break;
-
-        case ReadData:
-        case ReadDataDirty:
-        case ReadDataShared:
-        case ReadDataSharedDirty:
-            memcpy(rq->sysData, msg->sysData, AXP_21264_DATA_SIZE);
-            /* rq->dm = true;
-            rq->wrap = msg->wrap; */
-            break;
-
-        default:
-            /*        rq->dm = false; */
-            break;
-    }
+    rq->cacheHit = msg->ch;
+    rq->inUse = true;
 
     /*
-     * OK, we are done here.  Signal the CPU that it has something to process.
+     * There are more slots on the ring than there are request entries, so
+     * there is always room for this one.  Let the System know it has
+     * something to process.
      */
-    pthread_cond_signal(cpu->system.cond);
+    (void) AXP_SPSCRing_Put(cpu->system.rqRing, rq, rq->cpuID);
+    AXP_EventCount_Signal(cpu->system.rqEvent);
 
     /*
-     * Unlock the CPU's interface Mutex, so that the CPU can process the data
-     * we just queued up to it.
+     * Return back to the caller.
      */
-    pthread_mutex_unlock(cpu->system.mutex);
+    return;
+}
+
+/*
+ * AXP_21264_DirectMem
+ *  This function is called by the Cbox, with the interface mutex locked, to
+ *  determine whether a memory block can be read or written directly, rather
+ *  than by sending a request to the System, and if so, where the block is in
+ *  host memory.  This is only the case when:
+ *
+ *      - The System has saved its memory map, and there is no other CPU that
+ *        would need to be probed for the block.
+ *      - There is memory at the physical address.  Anything else, including
+ *        NXM, is left to the System.
+ *      - There is no other victim for the block waiting to be written, which
+ *        the access would otherwise get ahead of.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *  pa:
+ *      A value indicating the physical address within the block.
+ *  vdbEntry:
+ *      A value indicating the VDB entry for a victim being written, which is
+ *      not to be considered a waiting victim, or -1.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL:       The request needs to be sent to the System.
+ *  Otherwise:  A pointer to the 64-byte block in host memory.
+ */
+u8 *AXP_21264_DirectMem(AXP_21264_CPU *cpu, u64 pa, int vdbEntry)
+{
+    u64 block = pa & ~((u64) AXP_21264_SIZE_QUAD - 1);
+    u64 mapIdx = block >> AXP_21264_MEM_MAP_SHIFT;
+    u8 *retVal = NULL;
+    int ii;
+
+    if ((cpu->system.directMem == true) &&
+        (cpu->system.memMap != NULL) &&
+        (mapIdx < AXP_21264_MEM_MAP_LEN) &&
+        (cpu->system.memMap[mapIdx] != NULL))
+    {
+        retVal = cpu->system.memMap[mapIdx] + (block & AXP_21264_MEM_MAP_MASK);
+        for (ii = 0; ((ii < AXP_21264_VDB_LEN) && (retVal != NULL)); ii++)
+        {
+            if ((ii != vdbEntry) &&
+                (cpu->vdb[ii].valid == true) &&
+                ((cpu->vdb[ii].pa & ~((u64) AXP_21264_SIZE_QUAD - 1)) == block))
+            {
+                retVal = NULL;
+            }
+        }
+    }
 
     /*
      * Return back to the caller.
      */
-    return;
+    return (retVal);
 }
-
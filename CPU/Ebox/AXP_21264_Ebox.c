@@ -40,9 +40,31 @@
  *	V01.004		27-Feb-2018	Jonathan D. Belanger
  *	The EboxMain and FboxMain functions were nearly identical, so they were
  *	combined into one that is now in COMUTL.
+ *
+ *	V01.005		15-Oct-2026	Jonathan D. Belanger
+ *	When the CPU is in functional mode, or changing modes, the Ibox is
+ *	waiting for the instruction to complete, so signal it as well.
+ *
+ *	V01.006		15-Oct-2026	Jonathan D. Belanger
+ *	The Ebox pipelines no longer wait on the Ebox condition variable, and no
+ *	longer need the IQ/FQ, condition variable, and mutex passed to them.
+ *
+ *	V01.007		15-Oct-2026	Jonathan D. Belanger
+ *	Completing an instruction no longer wakes the Ebox pipelines.  Nothing
+ *	new can be executed until the instruction is retired and its destination
+ *	register written, and that hands over the waiting instructions.
+ *
+ *	V01.008		16-Oct-2026	Jonathan D. Belanger
+ *	Choose the byte and multimedia kernels for the host when initializing.
+ *
+ *	V01.009		16-Oct-2026	Jonathan D. Belanger
+ *	The Ibox is signaled whenever it is waiting for the instruction to
+ *	complete, not just in functional mode.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ebox/AXP_21264_Ebox.h"
+#include "CPU/Ebox/AXP_21264_Ebox_SIMD.h"
+#include "CPU/Ibox/AXP_21264_Ibox.h"
 #include "CPU/Ibox/AXP_21264_Ibox_InstructionInfo.h"
 #include "CommonUtilities/AXP_Trace.h"
 #include "CommonUtilities/AXP_Execute_Box.h"
@@ -121,10 +143,14 @@ void AXP_21264_Ebox_Compl(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
      * done what is was supposed to and now we need to tell the Ebox that there
      * is something to retire.
      */
-    pthread_mutex_lock(&cpu->eBoxMutex);
     cpu->eBoxWaitingRetirement = true;
-    pthread_cond_signal(&cpu->eBoxCondition);
-    pthread_mutex_unlock(&cpu->eBoxMutex);
+
+    /*
+     * The Ibox may be waiting for this instruction to complete, so that it
+     * can retire it.  In functional mode, the Ibox executed the instruction
+     * and is always waiting for it to complete.
+     */
+    AXP_21264_Ibox_Completed(cpu);
 
     /*
      * Return back to the caller.
@@ -167,6 +193,11 @@ bool AXP_21264_Ebox_Init(AXP_21264_CPU *cpu)
      */
     cpu->VAXintrFlag = false;
 
+    /*
+     * Choose the byte and multimedia instruction kernels for this host.
+     */
+    AXP_SIMD_Init();
+
     /*
      * Initialize the Ebox IPRs.
      * NOTE: These will get real values from the PALcode.
@@ -235,9 +266,6 @@ void *AXP_21264_EboxU0Main(void *voidPtr)
     AXP_Execution_Box(
   cpu,
   EboxU0,
-  &cpu->iq,
-  &cpu->eBoxCondition,
-  &cpu->eBoxMutex,
   &AXP_ReturnIQEntry);
 
     /*
@@ -283,9 +311,6 @@ void *AXP_21264_EboxU1Main(void *voidPtr)
     AXP_Execution_Box(
   cpu,
   EboxU1,
-  &cpu->iq,
-  &cpu->eBoxCondition,
-  &cpu->eBoxMutex,
   &AXP_ReturnIQEntry);
 
     /*
@@ -331,9 +356,6 @@ void *AXP_21264_EboxL0Main(void *voidPtr)
     AXP_Execution_Box(
   cpu,
   EboxL0,
-  &cpu->iq,
-  &cpu->eBoxCondition,
-  &cpu->eBoxMutex,
   &AXP_ReturnIQEntry);
 
     /*
@@ -378,9 +400,6 @@ void *AXP_21264_EboxL1Main(void *voidPtr)
     AXP_Execution_Box(
   cpu,
   EboxL1,
-  &cpu->iq,
-  &cpu->eBoxCondition,
-  &cpu->eBoxMutex,
   &AXP_ReturnIQEntry);
 
     /*
@@ -27,6 +27,10 @@
  *	V01.001		25-Jun-2017	Jonathan D. Belanger
  *	The registers are nolonger just a 64-bit unsigned value.  They now have a
  *	structure to them, to aid in coding.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	CMPBGE, ZAP, and ZAPNOT now work on all the bytes at once, using the
+ *	kernels chosen for the host.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ebox/AXP_21264_Ebox_Byte.h"
@@ -53,17 +57,12 @@
  */
 AXP_EXCEPTIONS AXP_CMPBGE(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rav = (u8 *) &instr->src1v.r.uq;
-    u8 *Rbv = (u8 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Implement the instruction.
      */
-    instr->destv.r.uq = (Rav[0] >= Rbv[0] ? 0x01 : 0x00)
-  | (Rav[1] >= Rbv[1] ? 0x02 : 0x00) | (Rav[2] >= Rbv[2] ? 0x04 : 0x00)
-  | (Rav[3] >= Rbv[3] ? 0x08 : 0x00) | (Rav[4] >= Rbv[4] ? 0x10 : 0x00)
-  | (Rav[5] >= Rbv[5] ? 0x20 : 0x00) | (Rav[6] >= Rbv[6] ? 0x40 : 0x00)
-  | (Rav[7] >= Rbv[7] ? 0x80 : 0x00);
+    instr->destv.r.uq = AXP_SIMD_Active.cmpbge(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -1086,20 +1085,12 @@ AXP_EXCEPTIONS AXP_SEXTW(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_ZAP(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rbv = (u8 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Implement the instruction.
      */
-    instr->destv.r.uq = instr->src1v.r.uq
-  & (((Rbv[0] & 0x01) ? 0 : 0x00000000000000ffll)
-      | ((Rbv[0] & 0x02) ? 0 : 0x000000000000ff00ll)
-      | ((Rbv[0] & 0x04) ? 0 : 0x0000000000ff0000ll)
-      | ((Rbv[0] & 0x08) ? 0 : 0x00000000ff000000ll)
-      | ((Rbv[0] & 0x10) ? 0 : 0x000000ff00000000ll)
-      | ((Rbv[0] & 0x20) ? 0 : 0x0000ff0000000000ll)
-      | ((Rbv[0] & 0x40) ? 0 : 0x00ff000000000000ll)
-      | ((Rbv[0] & 0x80) ? 0 : 0xff00000000000000ll));
+    instr->destv.r.uq = instr->src1v.r.uq & ~AXP_SIMD_Active.zapMask(Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -1129,20 +1120,12 @@ AXP_EXCEPTIONS AXP_ZAP(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_ZAPNOT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rbv = (u8 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Implement the instruction.
      */
-    instr->destv.r.uq = instr->src1v.r.uq
-  & (((Rbv[0] & 0x01) ? 0x00000000000000ffll : 0)
-      | ((Rbv[0] & 0x02) ? 0x000000000000ff00ll : 0)
-      | ((Rbv[0] & 0x04) ? 0x0000000000ff0000ll : 0)
-      | ((Rbv[0] & 0x08) ? 0x00000000ff000000ll : 0)
-      | ((Rbv[0] & 0x10) ? 0x000000ff00000000ll : 0)
-      | ((Rbv[0] & 0x20) ? 0x0000ff0000000000ll : 0)
-      | ((Rbv[0] & 0x40) ? 0x00ff000000000000ll : 0)
-      | ((Rbv[0] & 0x80) ? 0xff00000000000000ll : 0));
+    instr->destv.r.uq = instr->src1v.r.uq & AXP_SIMD_Active.zapMask(Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
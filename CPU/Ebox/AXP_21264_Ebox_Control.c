@@ -46,6 +46,10 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  The prediction stack is now pushed and popped by the Ibox, when the
+ *  instructions are fetched, rather than when they are executed.
  */
 #include "CPU/Ebox/AXP_21264_Ebox_Control.h"
 #include "CPU/Ibox/AXP_21264_Ibox_PCHandling.h"
@@ -573,7 +577,6 @@ AXP_BSR(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
      */
     pc = instr->pc;
     pc.pc++;
-    AXP_PUSH(pc);
 
     /*
      * We store the PC calculated above into the destination register value.
@@ -614,6 +617,9 @@ AXP_BSR(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  *      0x0001      Indicates procedure return
  *                  All other encodings are reserved.
  *
+ *  The prediction stack is maintained by the Ibox, when it fetches this
+ *  instruction.  Whatever the hint, the new PC is the one in Rb.
+ *
  * Input Parameters:
  *  cpu:
  *      A pointer to the structure containing the information needed to emulate
@@ -648,39 +654,6 @@ AXP_JMP(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
      */
     instr->destv.r.uq = AXP_GET_PC(pc);
 
-    /*
-     * Use the hint bits to determine what we are being asked to do.
-     */
-    switch (AXP_JMP_TYPE(instr->displacement))
-    {
-        case AXP_HW_JMP:
-            instr->branchPC = AXP_21264_DisplaceVPC(cpu,
-                                                    pc,
-                                                    instr->displacement);
-            break;
-
-        case AXP_HW_JSR:
-            AXP_PUSH(pc);
-            instr->branchPC = AXP_21264_DisplaceVPC(cpu,
-                                                    pc,
-                                                    instr->displacement);
-            break;
-
-        case AXP_HW_RET:
-            AXP_POP(pc);
-            instr->branchPC = AXP_21264_MakeVPC(cpu,
-                                                AXP_GET_PC(pc),
-                                                AXP_NORMAL_MODE);
-            break;
-
-        case AXP_HW_COROUTINE:
-            AXP_SWAP(pc);
-            instr->branchPC = AXP_21264_MakeVPC(cpu,
-                                                AXP_GET_PC(pc),
-                                                AXP_NORMAL_MODE);
-            break;
-    }
-
     /*
      * Now we use the PC indicated in src1 as the new PC.
      */
@@ -36,6 +36,11 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  The return PC of CALL_PAL is the one after the instruction itself, rather
+ *  than the most recent one on the VPC stack, and is pushed onto the
+ *  prediction stack by the Ibox, when it fetches the instruction.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ebox/AXP_21264_Ebox_Misc.h"
@@ -142,8 +147,8 @@ AXP_CALL_PAL(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
      * The destination register was set to the R23 (R39) shadow register or
      * R27 (does not have a shadow register).
      */
-    *retPC = AXP_21264_GetNextVPC(cpu);
-    AXP_PUSH(*retPC);
+    *retPC = instr->pc;
+    retPC->pc++;
 
     /*
      * CALL_PAL is just like a branch, but it is not predicted.
@@ -23,6 +23,11 @@
  *
  *	V01.000		19-Jul-2017	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	The instructions now work on all the bytes or words at once, using the
+ *	kernels chosen for the host.  The pack and unpack instructions were
+ *	moving the wrong bytes, and reading past the end of the register.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ebox/AXP_21264_Ebox_Multimedia.h"
@@ -49,16 +54,12 @@
  */
 AXP_EXCEPTIONS AXP_MINUB8(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rav = (u8 *) &instr->src1v.r.uq;
-    u8 *Rbv = (u8 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    u8 *Rcv = (u8 *) &instr->destv.r.uq;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(u64) / sizeof(u8)); ii++)
-  Rcv[ii] = Rav[ii] < Rbv[ii] ? Rav[ii] : Rbv[ii];
+    instr->destv.r.uq = AXP_SIMD_Active.minub8(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -88,16 +89,12 @@ AXP_EXCEPTIONS AXP_MINUB8(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_MINSB8(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    i8 *Rav = (i8 *) &instr->src1v.r.uq;
-    i8 *Rbv = (i8 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    i8 *Rcv = (i8 *) &instr->destv.r.uq;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(i64) / sizeof(i8)); ii++)
-  Rcv[ii] = Rav[ii] < Rbv[ii] ? Rav[ii] : Rbv[ii];
+    instr->destv.r.uq = AXP_SIMD_Active.minsb8(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -127,17 +124,12 @@ AXP_EXCEPTIONS AXP_MINSB8(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_MINUW4(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u16 *Rav = (u16 *) &instr->src1v.r.uq;
-    u16 *Rbv =
-  (u16 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    u16 *Rcv = (u16 *) &instr->destv.r.uq;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(u64) / sizeof(u16)); ii++)
-  Rcv[ii] = Rav[ii] < Rbv[ii] ? Rav[ii] : Rbv[ii];
+    instr->destv.r.uq = AXP_SIMD_Active.minuw4(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -167,17 +159,12 @@ AXP_EXCEPTIONS AXP_MINUW4(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_MINSW4(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    i16 *Rav = (i16 *) &instr->src1v.r.uq;
-    i16 *Rbv =
-  (i16 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    i16 *Rcv = (i16 *) &instr->destv.r.uq;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(i64) / sizeof(i16)); ii++)
-  Rcv[ii] = Rav[ii] < Rbv[ii] ? Rav[ii] : Rbv[ii];
+    instr->destv.r.uq = AXP_SIMD_Active.minsw4(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -207,16 +194,12 @@ AXP_EXCEPTIONS AXP_MINSW4(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_MAXUB8(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rav = (u8 *) &instr->src1v.r.uq;
-    u8 *Rbv = (u8 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    u8 *Rcv = (u8 *) &instr->destv.r.uq;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(u64) / sizeof(u8)); ii++)
-  Rcv[ii] = Rav[ii] > Rbv[ii] ? Rav[ii] : Rbv[ii];
+    instr->destv.r.uq = AXP_SIMD_Active.maxub8(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -246,16 +229,12 @@ AXP_EXCEPTIONS AXP_MAXUB8(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_MAXSB8(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    i8 *Rav = (i8 *) &instr->src1v.r.uq;
-    i8 *Rbv = (i8 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    i8 *Rcv = (i8 *) &instr->destv.r.uq;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(i64) / sizeof(i8)); ii++)
-  Rcv[ii] = Rav[ii] > Rbv[ii] ? Rav[ii] : Rbv[ii];
+    instr->destv.r.uq = AXP_SIMD_Active.maxsb8(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -285,17 +264,12 @@ AXP_EXCEPTIONS AXP_MAXSB8(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_MAXUW4(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u16 *Rav = (u16 *) &instr->src1v.r.uq;
-    u16 *Rbv =
-  (u16 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    u16 *Rcv = (u16 *) &instr->destv.r.uq;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(u64) / sizeof(u16)); ii++)
-  Rcv[ii] = Rav[ii] > Rbv[ii] ? Rav[ii] : Rbv[ii];
+    instr->destv.r.uq = AXP_SIMD_Active.maxuw4(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -325,17 +299,12 @@ AXP_EXCEPTIONS AXP_MAXUW4(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_MAXSW4(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    i16 *Rav = (i16 *) &instr->src1v.r.uq;
-    i16 *Rbv =
-  (i16 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    i16 *Rcv = (i16 *) &instr->destv.r.uq;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(i64) / sizeof(i16)); ii++)
-  Rcv[ii] = Rav[ii] > Rbv[ii] ? Rav[ii] : Rbv[ii];
+    instr->destv.r.uq = AXP_SIMD_Active.maxsw4(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -365,17 +334,12 @@ AXP_EXCEPTIONS AXP_MAXSW4(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_PERR(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rav = (u8 *) &instr->src1v.r.uq;
-    u8 *Rbv = (u8 *) (instr->useLiteral ? &instr->literal : &instr->src2v.r.uq);
-    u64 temp = 0;
-    int ii;
+    u64 Rbv = (instr->useLiteral ? instr->literal : instr->src2v.r.uq);
 
     /*
      * Execute the instruction.
      */
-    for (ii = 0; ii < (sizeof(u64) / sizeof(u8)); ii++)
-  temp += abs(Rav[ii] - Rbv[ii]);
-    instr->destv.r.uq = temp;
+    instr->destv.r.uq = AXP_SIMD_Active.perr(instr->src1v.r.uq, Rbv);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -405,15 +369,11 @@ AXP_EXCEPTIONS AXP_PERR(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_PKLB(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rbv = (u8 *) &instr->src2v.r.uq;
-    u8 *Rcv = (u8 *) &instr->destv.r.uq;
 
     /*
      * Execute the instruction.
      */
-    instr->destv.r.uq = 0;
-    Rcv[0] = Rbv[0];
-    Rcv[1] = Rbv[8];
+    instr->destv.r.uq = AXP_SIMD_Active.pklb(instr->src2v.r.uq);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -443,17 +403,11 @@ AXP_EXCEPTIONS AXP_PKLB(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_PKWB(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rbv = (u8 *) &instr->src2v.r.uq;
-    u8 *Rcv = (u8 *) &instr->destv.r.uq;
 
     /*
      * Execute the instruction.
      */
-    instr->destv.r.uq = 0;
-    Rcv[0] = Rbv[0];
-    Rcv[1] = Rbv[2];
-    Rcv[2] = Rbv[4];
-    Rcv[3] = Rbv[8];
+    instr->destv.r.uq = AXP_SIMD_Active.pkwb(instr->src2v.r.uq);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -483,15 +437,11 @@ AXP_EXCEPTIONS AXP_PKWB(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_UNPKBL(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rbv = (u8 *) &instr->src2v.r.uq;
-    u8 *Rcv = (u8 *) &instr->destv.r.uq;
 
     /*
      * Execute the instruction.
      */
-    instr->destv.r.uq = 0;
-    Rcv[0] = Rbv[0];
-    Rcv[8] = Rbv[1];
+    instr->destv.r.uq = AXP_SIMD_Active.unpkbl(instr->src2v.r.uq);
 
     /*
      * Return back to the caller with any exception that may have occurred.
@@ -521,17 +471,11 @@ AXP_EXCEPTIONS AXP_UNPKBL(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
  */
 AXP_EXCEPTIONS AXP_UNPKBW(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
-    u8 *Rbv = (u8 *) &instr->src2v.r.uq;
-    u8 *Rcv = (u8 *) &instr->destv.r.uq;
 
     /*
      * Execute the instruction.
      */
-    instr->destv.r.uq = 0;
-    Rcv[0] = Rbv[0];
-    Rcv[2] = Rbv[1];
-    Rcv[3] = Rbv[2];
-    Rcv[6] = Rbv[3];
+    instr->destv.r.uq = AXP_SIMD_Active.unpkbw(instr->src2v.r.uq);
 
     /*
      * Return back to the caller with any exception that may have occurred.
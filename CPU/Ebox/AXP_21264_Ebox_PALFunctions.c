@@ -31,6 +31,11 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  HW_RET takes its new PC from Rb, which is the instruction's first source
+ *  register, whatever its HINT bits.  The prediction stack is now maintained
+ *  by the Ibox, when it fetches the instruction.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ebox/AXP_21264_Ebox_PALfunctions.h"
@@ -162,45 +167,15 @@ AXP_EXCEPTIONS AXP_HWST(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 AXP_EXCEPTIONS AXP_HWRET(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
     AXP_EXCEPTIONS retVal = NoException;
-    AXP_PC pc;
 
     /*
-     * Implement the HW_RET instruction.
+     * Implement the HW_RET instruction.  The Ibox has already used the HINT
+     * bits to maintain the prediction stack, and to predict the new PC, when
+     * it fetched this instruction.  The new PC is always the one in Rb.
      */
-    switch (instr->type_hint_index)
-    {
-        case AXP_HW_JMP:
-            pc = instr->pc;
-            pc.pc++;
-            instr->branchPC = AXP_21264_DisplaceVPC(cpu,
-                                                    pc,
-                                                    instr->displacement);
-            break;
-
-        case AXP_HW_JSR:
-            pc = instr->pc;
-            pc.pc++;
-            AXP_PUSH(pc);
-            instr->branchPC = AXP_21264_DisplaceVPC(cpu,
-                                                    pc,
-                                                    instr->displacement);
-            break;
-
-        case AXP_HW_RET:
-            AXP_POP(pc);
-            instr->branchPC = AXP_21264_MakeVPC(cpu,
-                                                instr->src2v.r.uq,
-                                                (instr->src2v.r.uq &
-                                                    AXP_PAL_MODE));
-            break;
-
-        case AXP_HW_COROUTINE:
-            pc = instr->pc;
-            pc.pc++;
-            AXP_SWAP(pc);
-            instr->branchPC = AXP_21264_MakeVPC(cpu, AXP_GET_PC(pc), pc.pal);
-            break;
-        }
+    instr->branchPC = AXP_21264_MakeVPC(cpu,
+                                        instr->src1v.r.uq,
+                                        (instr->src1v.r.uq & AXP_PAL_MODE));
 
     /*
      * Return back to the caller with any exception that may have occurred.
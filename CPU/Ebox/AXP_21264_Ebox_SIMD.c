@@ -0,0 +1,543 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *	This source file contains the kernels that perform the byte compare,
+ *	zap, and multimedia (MVI) operations on all the bytes or words of a
+ *	register at once, rather than one at a time.
+ *
+ *	The SWAR kernels treat the 64-bit register as 8 bytes or 4 words, and
+ *	keep the carries and borrows from crossing from one to the next.  The
+ *	SSE2 and SSSE3 kernels move the register into the low half of an XMM
+ *	register and use the host's byte and word instructions, most of which
+ *	are exactly the Alpha's.  The operands are only ever 64 bits, so wider
+ *	vectors would not do any more work per instruction.
+ *
+ *	The kernels used are chosen once, from what the host supports, the first
+ *	time AXP_SIMD_Init is called.  Moving a value into and out of an XMM
+ *	register costs more than CMPBGE or the byte packs and unpacks do in
+ *	SWAR, so those stay SWAR whatever the host supports.
+ *
+ * Revision History:
+ *
+ *	V01.000		16-Oct-2026	Jonathan D. Belanger
+ *	Initially written.
+ */
+#include "CommonUtilities/AXP_Configure.h"
+#include "CPU/Ebox/AXP_21264_Ebox_SIMD.h"
+#if defined(__x86_64__) || defined(__i386__)
+#define AXP_SIMD_X86	1
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#endif
+
+#define AXP_SIMD_BYTE_LSB	0x0101010101010101ull
+#define AXP_SIMD_BYTE_MSB	0x8080808080808080ull
+#define AXP_SIMD_WORD_MSB	0x8000800080008000ull
+#define AXP_SIMD_GATHER		0x0102040810204080ull
+
+/*
+ * _AXP_SIMD_GE
+ *	This function is called to determine, for each unsigned lane of two
+ *	values, if the lane in the first is greater than or equal to the one in
+ *	the second.
+ *
+ * Input Parameters:
+ *	a:
+ *		A value of the first operand.
+ *	b:
+ *		A value of the second operand.
+ *	msb:
+ *		A value with the most significant bit of each lane set, which
+ *		determines the lane size.
+ *
+ * Output Parameters:
+ *	None.
+ *
+ * Return Value:
+ *	A value with the most significant bit of each lane set where the lane of
+ *	a is greater than or equal to the lane of b, and every other bit clear.
+ */
+static inline u64 _AXP_SIMD_GE(u64 a, u64 b, u64 msb)
+{
+
+    /*
+     * With the top bit of each lane of a set, and of b clear, subtracting the
+     * rest of the bits cannot borrow from the next lane.  The top bit of the
+     * difference is then set if the rest of a is at least the rest of b.  The
+     * top bits of a and b themselves decide it when they differ.
+     */
+    u64 low = (a | msb) - (b & ~msb);
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (((a & ~b) | (~(a ^ b) & low)) & msb);
+}
+
+/*
+ * _AXP_SIMD_Expand
+ *	This function is called to turn a value with the most significant bit of
+ *	some lanes set into a mask of those whole lanes.
+ *
+ * Input Parameters:
+ *	msbs:
+ *		A value with only the most significant bits of lanes set.
+ *	lane:
+ *		A value indicating the number of bits in a lane.
+ *
+ * Output Parameters:
+ *	None.
+ *
+ * Return Value:
+ *	The mask.
+ */
+static inline u64 _AXP_SIMD_Expand(u64 msbs, u32 lane)
+{
+
+    /*
+     * Return the results back to the caller.
+     */
+    return ((msbs >> (lane - 1)) * ((1ull << lane) - 1));
+}
+
+/*
+ * The SWAR kernels.
+ */
+static u64 _AXP_SWAR_CmpBge(u64 a, u64 b)
+{
+    u64 ge = _AXP_SIMD_GE(a, b, AXP_SIMD_BYTE_MSB) >> 7;
+
+    /*
+     * Gather the bit at the bottom of each byte into the top byte, then move
+     * it to the bottom.
+     */
+    return ((ge * AXP_SIMD_GATHER) >> 56);
+}
+
+static u64 _AXP_SWAR_ZapMask(u64 b)
+{
+    u64 bits = ((b & 0xff) * AXP_SIMD_BYTE_LSB) & 0x8040201008040201ull;
+
+    /*
+     * Each byte now has the one bit of b that selects it, or is zero.  Adding
+     * 0x7f to the rest of the byte sets its top bit if any were set.
+     */
+    bits = (((bits & ~AXP_SIMD_BYTE_MSB) + ~AXP_SIMD_BYTE_MSB) | bits) &
+           AXP_SIMD_BYTE_MSB;
+    return (_AXP_SIMD_Expand(bits, 8));
+}
+
+static u64 _AXP_SWAR_MinUB8(u64 a, u64 b)
+{
+    u64 ge = _AXP_SIMD_Expand(_AXP_SIMD_GE(a, b, AXP_SIMD_BYTE_MSB), 8);
+
+    return ((b & ge) | (a & ~ge));
+}
+
+static u64 _AXP_SWAR_MaxUB8(u64 a, u64 b)
+{
+    u64 ge = _AXP_SIMD_Expand(_AXP_SIMD_GE(a, b, AXP_SIMD_BYTE_MSB), 8);
+
+    return ((a & ge) | (b & ~ge));
+}
+
+static u64 _AXP_SWAR_MinSB8(u64 a, u64 b)
+{
+
+    /*
+     * Flipping the sign bits orders signed values as unsigned ones.
+     */
+    return (_AXP_SWAR_MinUB8(a ^ AXP_SIMD_BYTE_MSB, b ^ AXP_SIMD_BYTE_MSB) ^
+            AXP_SIMD_BYTE_MSB);
+}
+
+static u64 _AXP_SWAR_MaxSB8(u64 a, u64 b)
+{
+    return (_AXP_SWAR_MaxUB8(a ^ AXP_SIMD_BYTE_MSB, b ^ AXP_SIMD_BYTE_MSB) ^
+            AXP_SIMD_BYTE_MSB);
+}
+
+static u64 _AXP_SWAR_MinUW4(u64 a, u64 b)
+{
+    u64 ge = _AXP_SIMD_Expand(_AXP_SIMD_GE(a, b, AXP_SIMD_WORD_MSB), 16);
+
+    return ((b & ge) | (a & ~ge));
+}
+
+static u64 _AXP_SWAR_MaxUW4(u64 a, u64 b)
+{
+    u64 ge = _AXP_SIMD_Expand(_AXP_SIMD_GE(a, b, AXP_SIMD_WORD_MSB), 16);
+
+    return ((a & ge) | (b & ~ge));
+}
+
+static u64 _AXP_SWAR_MinSW4(u64 a, u64 b)
+{
+    return (_AXP_SWAR_MinUW4(a ^ AXP_SIMD_WORD_MSB, b ^ AXP_SIMD_WORD_MSB) ^
+            AXP_SIMD_WORD_MSB);
+}
+
+static u64 _AXP_SWAR_MaxSW4(u64 a, u64 b)
+{
+    return (_AXP_SWAR_MaxUW4(a ^ AXP_SIMD_WORD_MSB, b ^ AXP_SIMD_WORD_MSB) ^
+            AXP_SIMD_WORD_MSB);
+}
+
+static u64 _AXP_SWAR_Perr(u64 a, u64 b)
+{
+    u64 diff = _AXP_SWAR_MaxUB8(a, b) - _AXP_SWAR_MinUB8(a, b);
+
+    /*
+     * No byte of the maximum is less than the same byte of the minimum, so
+     * the subtraction does not borrow.  Add the bytes into words, then the
+     * words into the top word.
+     */
+    diff = (diff & 0x00ff00ff00ff00ffull) +
+           ((diff >> 8) & 0x00ff00ff00ff00ffull);
+    return ((diff * 0x0001000100010001ull) >> 48);
+}
+
+static u64 _AXP_SWAR_PkLB(u64 b)
+{
+    return ((b & 0xff) | ((b >> 24) & 0xff00));
+}
+
+static u64 _AXP_SWAR_PkWB(u64 b)
+{
+    b &= 0x00ff00ff00ff00ffull;
+    b = (b | (b >> 8)) & 0x0000ffff0000ffffull;
+    return ((b | (b >> 16)) & 0xffffffffull);
+}
+
+static u64 _AXP_SWAR_UnpkBL(u64 b)
+{
+    return ((b & 0xff) | ((b & 0xff00) << 24));
+}
+
+static u64 _AXP_SWAR_UnpkBW(u64 b)
+{
+    b &= 0xffffffffull;
+    b = (b | (b << 16)) & 0x0000ffff0000ffffull;
+    return ((b | (b << 8)) & 0x00ff00ff00ff00ffull);
+}
+
+#ifdef AXP_SIMD_X86
+
+/*
+ * The SSE2 kernels.  Every x86-64 host has SSE2.
+ */
+#define AXP_SSE_IN(value)	_mm_cvtsi64_si128((long long) (value))
+#define AXP_SSE_OUT(value)	((u64) _mm_cvtsi128_si64(value))
+
+static u64 _AXP_SSE2_CmpBge(u64 a, u64 b)
+{
+    __m128i va = AXP_SSE_IN(a);
+
+    return (_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_max_epu8(va, AXP_SSE_IN(b)), va)) & 0xff);
+}
+
+static u64 _AXP_SSE2_MinUB8(u64 a, u64 b)
+{
+    return (AXP_SSE_OUT(_mm_min_epu8(AXP_SSE_IN(a), AXP_SSE_IN(b))));
+}
+
+static u64 _AXP_SSE2_MaxUB8(u64 a, u64 b)
+{
+    return (AXP_SSE_OUT(_mm_max_epu8(AXP_SSE_IN(a), AXP_SSE_IN(b))));
+}
+
+/*
+ * SSE2 only has unsigned byte and signed word minimums and maximums, so the
+ * others flip the sign bits.
+ */
+static u64 _AXP_SSE2_MinSB8(u64 a, u64 b)
+{
+    return (_AXP_SSE2_MinUB8(a ^ AXP_SIMD_BYTE_MSB, b ^ AXP_SIMD_BYTE_MSB) ^
+            AXP_SIMD_BYTE_MSB);
+}
+
+static u64 _AXP_SSE2_MaxSB8(u64 a, u64 b)
+{
+    return (_AXP_SSE2_MaxUB8(a ^ AXP_SIMD_BYTE_MSB, b ^ AXP_SIMD_BYTE_MSB) ^
+            AXP_SIMD_BYTE_MSB);
+}
+
+static u64 _AXP_SSE2_MinSW4(u64 a, u64 b)
+{
+    return (AXP_SSE_OUT(_mm_min_epi16(AXP_SSE_IN(a), AXP_SSE_IN(b))));
+}
+
+static u64 _AXP_SSE2_MaxSW4(u64 a, u64 b)
+{
+    return (AXP_SSE_OUT(_mm_max_epi16(AXP_SSE_IN(a), AXP_SSE_IN(b))));
+}
+
+static u64 _AXP_SSE2_MinUW4(u64 a, u64 b)
+{
+    return (_AXP_SSE2_MinSW4(a ^ AXP_SIMD_WORD_MSB, b ^ AXP_SIMD_WORD_MSB) ^
+            AXP_SIMD_WORD_MSB);
+}
+
+static u64 _AXP_SSE2_MaxUW4(u64 a, u64 b)
+{
+    return (_AXP_SSE2_MaxSW4(a ^ AXP_SIMD_WORD_MSB, b ^ AXP_SIMD_WORD_MSB) ^
+            AXP_SIMD_WORD_MSB);
+}
+
+static u64 _AXP_SSE2_Perr(u64 a, u64 b)
+{
+    return (AXP_SSE_OUT(_mm_sad_epu8(AXP_SSE_IN(a), AXP_SSE_IN(b))));
+}
+
+static u64 _AXP_SSE2_PkLB(u64 b)
+{
+    __m128i vb = _mm_and_si128(AXP_SSE_IN(b), _mm_set1_epi32(0xff));
+
+    vb = _mm_packs_epi32(vb, vb);
+    return (AXP_SSE_OUT(_mm_packus_epi16(vb, vb)) & 0xffff);
+}
+
+static u64 _AXP_SSE2_PkWB(u64 b)
+{
+    __m128i vb = _mm_and_si128(AXP_SSE_IN(b), _mm_set1_epi16(0xff));
+
+    return (AXP_SSE_OUT(_mm_packus_epi16(vb, vb)) & 0xffffffffull);
+}
+
+static u64 _AXP_SSE2_UnpkBL(u64 b)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i vb = _mm_unpacklo_epi8(AXP_SSE_IN(b & 0xffff), zero);
+
+    return (AXP_SSE_OUT(_mm_unpacklo_epi16(vb, zero)));
+}
+
+static u64 _AXP_SSE2_UnpkBW(u64 b)
+{
+    return (AXP_SSE_OUT(_mm_unpacklo_epi8(AXP_SSE_IN(b), _mm_setzero_si128())));
+}
+
+/*
+ * The SSSE3 kernels.  These only differ from the SSE2 ones for the pack and
+ * unpack instructions, which are each a single byte shuffle.  A shuffle
+ * index with its top bit set gives a zero byte.
+ */
+__attribute__((target("ssse3")))
+static u64 _AXP_SSSE3_PkLB(u64 b)
+{
+    const __m128i shuffle = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, 4, 0);
+
+    return (AXP_SSE_OUT(_mm_shuffle_epi8(AXP_SSE_IN(b), shuffle)));
+}
+
+__attribute__((target("ssse3")))
+static u64 _AXP_SSSE3_PkWB(u64 b)
+{
+    const __m128i shuffle = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, 6, 4, 2, 0);
+
+    return (AXP_SSE_OUT(_mm_shuffle_epi8(AXP_SSE_IN(b), shuffle)));
+}
+
+__attribute__((target("ssse3")))
+static u64 _AXP_SSSE3_UnpkBL(u64 b)
+{
+    const __m128i shuffle = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, 1, -1, -1, -1, 0);
+
+    return (AXP_SSE_OUT(_mm_shuffle_epi8(AXP_SSE_IN(b), shuffle)));
+}
+
+__attribute__((target("ssse3")))
+static u64 _AXP_SSSE3_UnpkBW(u64 b)
+{
+    const __m128i shuffle = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, 3, -1, 2, -1, 1, -1, 0);
+
+    return (AXP_SSE_OUT(_mm_shuffle_epi8(AXP_SSE_IN(b), shuffle)));
+}
+#endif /* AXP_SIMD_X86 */
+
+/*
+ * The kernels for each instruction set.  There is no faster way to expand the
+ * zap mask than SWAR, so every set uses it.
+ */
+static const AXP_SIMD_KERNELS _AXP_SIMD_Sets[AXP_SIMD_ISA_COUNT] =
+{
+    {
+        "SWAR",
+        _AXP_SWAR_CmpBge, _AXP_SWAR_ZapMask,
+        _AXP_SWAR_MinUB8, _AXP_SWAR_MinSB8, _AXP_SWAR_MinUW4, _AXP_SWAR_MinSW4,
+        _AXP_SWAR_MaxUB8, _AXP_SWAR_MaxSB8, _AXP_SWAR_MaxUW4, _AXP_SWAR_MaxSW4,
+        _AXP_SWAR_Perr,
+        _AXP_SWAR_PkLB, _AXP_SWAR_PkWB, _AXP_SWAR_UnpkBL, _AXP_SWAR_UnpkBW
+    },
+#ifdef AXP_SIMD_X86
+    {
+        "SSE2",
+        _AXP_SSE2_CmpBge, _AXP_SWAR_ZapMask,
+        _AXP_SSE2_MinUB8, _AXP_SSE2_MinSB8, _AXP_SSE2_MinUW4, _AXP_SSE2_MinSW4,
+        _AXP_SSE2_MaxUB8, _AXP_SSE2_MaxSB8, _AXP_SSE2_MaxUW4, _AXP_SSE2_MaxSW4,
+        _AXP_SSE2_Perr,
+        _AXP_SSE2_PkLB, _AXP_SSE2_PkWB, _AXP_SSE2_UnpkBL, _AXP_SSE2_UnpkBW
+    },
+    {
+        "SSSE3",
+        _AXP_SSE2_CmpBge, _AXP_SWAR_ZapMask,
+        _AXP_SSE2_MinUB8, _AXP_SSE2_MinSB8, _AXP_SSE2_MinUW4, _AXP_SSE2_MinSW4,
+        _AXP_SSE2_MaxUB8, _AXP_SSE2_MaxSB8, _AXP_SSE2_MaxUW4, _AXP_SSE2_MaxSW4,
+        _AXP_SSE2_Perr,
+        _AXP_SSSE3_PkLB, _AXP_SSSE3_PkWB, _AXP_SSSE3_UnpkBL, _AXP_SSSE3_UnpkBW
+    }
+#endif /* AXP_SIMD_X86 */
+};
+
+AXP_SIMD_KERNELS AXP_SIMD_Active =
+{
+    "SWAR",
+    _AXP_SWAR_CmpBge, _AXP_SWAR_ZapMask,
+    _AXP_SWAR_MinUB8, _AXP_SWAR_MinSB8, _AXP_SWAR_MinUW4, _AXP_SWAR_MinSW4,
+    _AXP_SWAR_MaxUB8, _AXP_SWAR_MaxSB8, _AXP_SWAR_MaxUW4, _AXP_SWAR_MaxSW4,
+    _AXP_SWAR_Perr,
+    _AXP_SWAR_PkLB, _AXP_SWAR_PkWB, _AXP_SWAR_UnpkBL, _AXP_SWAR_UnpkBW
+};
+
+static pthread_once_t _AXP_SIMD_Once = PTHREAD_ONCE_INIT;
+
+/*
+ * AXP_SIMD_Kernels
+ *	This function is called to get the kernels for an instruction set, if
+ *	the host supports it.
+ *
+ * Input Parameters:
+ *	isa:
+ *		A value indicating the instruction set.
+ *
+ * Output Parameters:
+ *	None.
+ *
+ * Return Value:
+ *	NULL:		The host does not support the instruction set.
+ *	Otherwise:	A pointer to the kernels.
+ */
+const AXP_SIMD_KERNELS *AXP_SIMD_Kernels(AXP_SIMD_ISA isa)
+{
+    const AXP_SIMD_KERNELS *retVal = NULL;
+
+    switch (isa)
+    {
+        case AXP_SIMD_SWAR:
+            retVal = &_AXP_SIMD_Sets[AXP_SIMD_SWAR];
+            break;
+
+#ifdef AXP_SIMD_X86
+        case AXP_SIMD_SSE2:
+            if (__builtin_cpu_supports("sse2"))
+            {
+                retVal = &_AXP_SIMD_Sets[AXP_SIMD_SSE2];
+            }
+            break;
+
+        case AXP_SIMD_SSSE3:
+            if (__builtin_cpu_supports("ssse3"))
+            {
+                retVal = &_AXP_SIMD_Sets[AXP_SIMD_SSSE3];
+            }
+            break;
+#endif /* AXP_SIMD_X86 */
+
+        default:
+            break;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SIMD_Select
+ *	This function is called, once, to make the kernels for the best
+ *	instruction set the host supports the active ones, except for those that
+ *	are faster in SWAR.
+ *
+ * Input Parameters:
+ *	None.
+ *
+ * Output Parameters:
+ *	None.
+ *
+ * Return Value:
+ *	None.
+ */
+static void _AXP_SIMD_Select(void)
+{
+    const AXP_SIMD_KERNELS *kernels;
+    int isa;
+
+#ifdef AXP_SIMD_X86
+    __builtin_cpu_init();
+#endif
+    for (isa = AXP_SIMD_ISA_COUNT - 1; isa >= AXP_SIMD_SWAR; isa--)
+    {
+        kernels = AXP_SIMD_Kernels(isa);
+        if (kernels != NULL)
+        {
+            AXP_SIMD_Active = *kernels;
+            AXP_SIMD_Active.cmpbge = _AXP_SWAR_CmpBge;
+            AXP_SIMD_Active.pklb = _AXP_SWAR_PkLB;
+            AXP_SIMD_Active.pkwb = _AXP_SWAR_PkWB;
+            AXP_SIMD_Active.unpkbl = _AXP_SWAR_UnpkBL;
+            AXP_SIMD_Active.unpkbw = _AXP_SWAR_UnpkBW;
+            break;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_SIMD_Init
+ *	This function is called to choose the kernels used.  It can be called
+ *	any number of times, from any number of threads, but only chooses them
+ *	the first time.
+ *
+ * Input Parameters:
+ *	None.
+ *
+ * Output Parameters:
+ *	None.
+ *
+ * Return Value:
+ *	None.
+ */
+void AXP_SIMD_Init(void)
+{
+    pthread_once(&_AXP_SIMD_Once, _AXP_SIMD_Select);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
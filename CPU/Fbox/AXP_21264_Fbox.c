@@ -39,6 +39,23 @@
  *	V01.004		27-Feb-2018	Jonathan D. Belanger
  *	The EboxMain and FboxMain functions were nearly identical, so they were
  *	combined into one that is now in COMUTL.
+ *
+ *	V01.005		15-Oct-2026	Jonathan D. Belanger
+ *	When the CPU is in functional mode, or changing modes, the Ibox is
+ *	waiting for the instruction to complete, so signal it as well.
+ *
+ *	V01.006		15-Oct-2026	Jonathan D. Belanger
+ *	The Fbox pipelines no longer wait on the Fbox condition variable, and no
+ *	longer need the IQ/FQ, condition variable, and mutex passed to them.
+ *
+ *	V01.007		15-Oct-2026	Jonathan D. Belanger
+ *	Completing an instruction no longer wakes the Fbox pipelines.  Nothing
+ *	new can be executed until the instruction is retired and its destination
+ *	register written, and that hands over the waiting instructions.
+ *
+ *	V01.008		16-Oct-2026	Jonathan D. Belanger
+ *	The Ibox is signaled whenever it is waiting for the instruction to
+ *	complete, not just in functional mode.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Fbox/AXP_21264_Fbox.h"
@@ -171,10 +188,14 @@ void AXP_21264_Fbox_Compl(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
      * done what is was supposed to and now we need to tell the Fbox that there
      * is something to retire.
      */
-    pthread_mutex_lock(&cpu->fBoxMutex);
     cpu->fBoxWaitingRetirement = true;
-    pthread_cond_signal(&cpu->fBoxCondition);
-    pthread_mutex_unlock(&cpu->fBoxMutex);
+
+    /*
+     * The Ibox may be waiting for this instruction to complete, so that it
+     * can retire it.  In functional mode, the Ibox executed the instruction
+     * and is always waiting for it to complete.
+     */
+    AXP_21264_Ibox_Completed(cpu);
 
     /*
      * Return back to the caller.
@@ -289,9 +310,6 @@ void *AXP_21264_FboxMulMain(void *voidPtr)
     AXP_Execution_Box(
   cpu,
   FboxMul,
-  &cpu->fq,
-  &cpu->fBoxCondition,
-  &cpu->fBoxMutex,
   &AXP_ReturnFQEntry);
 
     /*
@@ -344,9 +362,6 @@ void *AXP_21264_FboxOthMain(void *voidPtr)
     AXP_Execution_Box(
   cpu,
   FboxOther,
-  &cpu->fq,
-  &cpu->fBoxCondition,
-  &cpu->fBoxMutex,
   &AXP_ReturnFQEntry);
 
     /*
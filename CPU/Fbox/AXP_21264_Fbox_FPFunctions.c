@@ -24,13 +24,90 @@
  *
  *	V01.000		29-June-2017	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026		Jonathan D. Belanger
+ *	Added the function to put the host's floating-point environment in the
+ *	state an IEEE instruction needs, which leaves the rounding mode in place
+ *	from one instruction to the next, and only clears the exception flags
+ *	when some are set.
+ *
+ *	V01.002		16-Oct-2026		Jonathan D. Belanger
+ *	Added the functions to perform an instruction with the integer-only
+ *	floating-point operations, and to determine when an IEEE instruction
+ *	needs them.
+ *
+ *	V01.003		16-Oct-2026		Jonathan D. Belanger
+ *	Added the function to determine when an IEEE instruction the host
+ *	performed needs to be performed again with integer arithmetic, because
+ *	the result was too small to be normalized.
+ *
+ *	V01.004		16-Oct-2026		Jonathan D. Belanger
+ *	Removed AXP_FP_SetRoundingMode and AXP_FP_SetExceptionMode.  The IEEE
+ *	instructions use AXP_FP_EnterIEEE, and nothing else called them.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Fbox/AXP_21264_Fbox_FPFunctions.h"
 
-extern int feenableexcept (int __excepts);
 extern int fedisableexcept (int __excepts);
-extern int fegetexcept (void);
+
+/*
+ * This is the rounding mode this thread last put the host in, or -1 before it
+ * has put the host in one, and whether the host's exceptions have been
+ * disabled for this thread.
+ */
+static __thread int _AXP_FP_HostRoundingMode = -1;
+static __thread bool _AXP_FP_HostTrapsDisabled = false;
+
+/*
+ * _AXP_FP_RoundingMode
+ * 	This function is called to determine the host rounding mode for an
+ * 	instruction, from the rounding in its function field or, when that is
+ * 	dynamic, from the FPCR.
+ *
+ * Input Parameters:
+ *	cpu:
+ *		A pointer to the structure containing the information needed to emulate
+ *		a single CPU.
+ * 	func:
+ * 		A pointer to a structure containing the information needed determine
+ * 		the rounding mode.
+ *
+ * Output Parameters:
+ * 	None.
+ *
+ * Return Value:
+ * 	The host rounding mode.
+ */
+static int _AXP_FP_RoundingMode(AXP_21264_CPU *cpu, AXP_FP_FUNC *func)
+{
+    u32 rnd = (func->rnd == AXP_FP_DYNAMIC) ? cpu->fpcr.dyn : func->rnd;
+    int retVal;
+
+    switch (rnd)
+    {
+        case AXP_FP_CHOPPED:
+            retVal = FE_TOWARDZERO;
+            break;
+
+        case AXP_FP_MINUS_INF:
+            retVal = FE_DOWNWARD;
+            break;
+
+        case AXP_FP_PLUS_INF:
+            retVal = FE_UPWARD;
+            break;
+
+        case AXP_FP_NORMAL:
+        default:
+            retVal = FE_TONEAREST;
+            break;
+    }
+
+    /*
+     * Return the rounding mode back to the caller.
+     */
+    return (retVal);
+}
 
 /*
  * AXP_FP_CvtFPRToFloat
@@ -379,151 +456,70 @@ int AXP_FP_CvtX2G(
 }
 
 /*
- * AXP_FP_SetRoundingMode
- * 	This function is called to set the rounding mode.  It determines this based
- * 	one the function field from the instruction of the FPCR in the cpu
- * 	structure.  If this is called with the cpu equal to NULL, then use the
- * 	roundingMode parameter to reset the rounding mode.
+ * AXP_FP_EnterIEEE
+ * 	This function is called before an IEEE instruction performs its
+ * 	arithmetic, to put the host in the rounding mode for the instruction,
+ * 	with none of the exception flags set.  Nothing needs to be put back
+ * 	afterwards.  The rounding mode is left as it is for the next
+ * 	instruction, and is only changed when the instruction's rounding, or the
+ * 	FPCR's, calls for a different one.  Likewise, the exception flags the
+ * 	last instruction raised are left set until the next one, and only
+ * 	cleared when some are.  Setting the rounding mode or clearing the flags
+ * 	takes far longer than the arithmetic, while testing the flags does not.
+ *
+ * 	The host's floating-point exceptions never trap here.  They are all
+ * 	disabled the first time a thread gets here, and the exceptions the FPCR
+ * 	disables are determined from the flags, after the arithmetic.
  *
  * Input Parameters:
  *	cpu:
- *		A pointer to the structure containing the information needed to emulate
- *		a single CPU.
- * 	function:
- * 		A pointer to a structure containing the information needed determine
- * 		the rounding mode.
- * 	resetRoundingMode:
- * 		A value of the previous rounding mode, which was returned on a previous
- * 		call to this function.
+ *		A pointer to the structure containing the information needed to
+ *		emulate a single CPU.
+ * 	func:
+ * 		A pointer to a structure containing the information needed to
+ * 		determine the rounding mode.
  *
  * Output Parameters:
  * 	None.
  *
  * Return Value:
- * 	A value representing the previous value for the rounding mode.
+ * 	None.
  */
-int AXP_FP_SetRoundingMode(
-    AXP_21264_CPU *cpu,
-    AXP_FP_FUNC *func,
-    int resetRoundingMode)
+void AXP_FP_EnterIEEE(AXP_21264_CPU *cpu, AXP_FP_FUNC *func)
 {
-    int savedRoundingMode = fegetround();
-    int newRoundingMode;
-
-    /*
-     * perform the math,
-     * and then convert the result back into 64-bit register format
-     */
-    if (cpu != NULL)
-    {
-  switch (func->rnd)
-  {
-      case AXP_FP_CHOPPED:
-    newRoundingMode = FE_TOWARDZERO;
-    break;
-
-      case AXP_FP_MINUS_INF:
-    newRoundingMode = FE_DOWNWARD;
-    break;
-
-      case AXP_FP_NORMAL:
-    newRoundingMode = FE_TONEAREST;
-    break;
+    int newRoundingMode = _AXP_FP_RoundingMode(cpu, func);
 
-      case AXP_FP_DYNAMIC:
-    switch (cpu->fpcr.dyn)
+    if (_AXP_FP_HostTrapsDisabled == false)
     {
-        case AXP_FP_CHOPPED:
-      newRoundingMode = FE_TOWARDZERO;
-      break;
-
-        case AXP_FP_MINUS_INF:
-      newRoundingMode = FE_DOWNWARD;
-      break;
-
-        case AXP_FP_NORMAL:
-      newRoundingMode = FE_TONEAREST;
-      break;
-
-        case AXP_FP_PLUS_INF:
-      newRoundingMode = FE_UPWARD;
-      break;
+        fedisableexcept(FE_ALL_EXCEPT);
+        _AXP_FP_HostTrapsDisabled = true;
     }
-    break;
-  }
+    if (newRoundingMode != _AXP_FP_HostRoundingMode)
+    {
+        if (fesetround(newRoundingMode) == 0)
+        {
+            _AXP_FP_HostRoundingMode = newRoundingMode;
+        }
+        else
+        {
+            fprintf(stderr,
+                    "Internal error: "
+                    "unexpected return value when setting "
+                    "rounding mode to %d at %s, line %d.\n",
+                    newRoundingMode,
+                    __FILE__,
+                    __LINE__);
+        }
     }
-    else
-  newRoundingMode = resetRoundingMode;
-
-    /*
-     * Set the rounding mode.
-     */
-    if (fesetround(newRoundingMode) != 0)
+    if (fetestexcept(FE_ALL_EXCEPT) != 0)
     {
-  fprintf(
-      stderr,
-      "Internal error: "
-    "unexpected return value when setting "
-    "rounding mode to %d at %s, line %d.\n",
-      newRoundingMode,
-      __FILE__,
-      __LINE__);
+        feclearexcept(FE_ALL_EXCEPT);
     }
 
     /*
-     * Returned the previous rounding mode back to the caller.  They'll call
-     * back to reset the rounding mode with this value and a NULL cpu
-     * parameter.
+     * Return back to the caller.
      */
-    return (savedRoundingMode);
-}
-
-/*
- * AXP_FP_SetExceptionMode
- * 	This function is called to disable/enable the exception mode.  It
- * 	determines this based on the FPCR in the cpu structure.  If this is called
- * 	with the cpu equal to NULL, then use the exceptionMode parameter to enable
- * 	the exception mode.
- *
- * Input Parameters:
- *	cpu:
- *		A pointer to the structure containing the information needed to emulate
- *		a single CPU.
- * 	resetExceptionMode:
- * 		A value of the previous exception mode, which was returned on a
- * 		previous call to this function.
- *
- * Output Parameters:
- * 	None.
- *
- * Return Value:
- * 	A value representing the previous value for the exception mode.
- */
-int AXP_FP_SetExceptionMode(AXP_21264_CPU *cpu, int resetExceptionMode)
-{
-    int retVal = fegetexcept();
-    int exceptionBits = 0;
-
-    if (cpu != NULL)
-    {
-  if (cpu->fpcr.dzed == 1)
-      exceptionBits |= FE_DIVBYZERO;
-  if (cpu->fpcr.ined == 1)
-      exceptionBits |= FE_INEXACT;
-  if (cpu->fpcr.invd == 1)
-      exceptionBits |= FE_INVALID;
-  if (cpu->fpcr.ovfd == 1)
-      exceptionBits |= FE_OVERFLOW;
-  if (cpu->fpcr.unfd == 1)
-      exceptionBits |= FE_UNDERFLOW;
-  if (exceptionBits != 0)
-      fedisableexcept(exceptionBits);
-  else
-      retVal = 0;
-    }
-    else if (resetExceptionMode != 0)
-  feenableexcept(resetExceptionMode);
-    return (retVal);
+    return;
 }
 
 /*
@@ -687,6 +683,192 @@ void AXP_FP_SetExcSum(AXP_INSTRUCTION *instr, int raised, bool integerOverflow)
     return;
 }
 
+/*
+ * AXP_FP_SoftOperate
+ * 	This function is called to perform a floating-point operate instruction
+ * 	with integer arithmetic only, and set the FPCR and excSum from the
+ * 	exceptions it raised.  The VAX instructions are always performed this
+ * 	way, and the IEEE ones when the host cannot be relied upon to get them
+ * 	right.
+ *
+ * Input Parameters:
+ *	cpu:
+ *		A pointer to the structure containing the information needed to
+ *		emulate a single CPU.
+ * 	instr:
+ * 		A pointer to a structure containing the information needed to
+ * 		execute this instruction.
+ *
+ * Output Parameters:
+ * 	instr:
+ * 		The destination register value, and the FPCR and excSum, are
+ * 		updated as needed.
+ *
+ * Return Value:
+ * 	NoException:		Normal successful completion.
+ * 	IllegalOperand:		An invalid operation trap has occurred.
+ * 	ArithmeticTraps:	Another arithmetic trap has occurred.
+ */
+AXP_EXCEPTIONS AXP_FP_SoftOperate(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
+{
+    AXP_EXCEPTIONS retVal = NoException;
+    AXP_SF_OPERATION op;
+    u32 raised, traps;
+    int hostRaised = 0;
+
+    if (AXP_SF_Decode(instr->opcode, instr->function, &cpu->fpcr, &op) == true)
+    {
+        instr->destv.fp.uq = AXP_SF_Execute(&op,
+                                            instr->src1v.fp.uq,
+                                            instr->src2v.fp.uq,
+                                            &raised);
+
+        /*
+         * The FPCR and excSum are set from the host's exception bits, so
+         * convert to those.  Integer overflow is an overflow on an integer
+         * result.
+         */
+        hostRaised |= (raised & AXP_SF_INV) ? FE_INVALID : 0;
+        hostRaised |= (raised & AXP_SF_DZE) ? FE_DIVBYZERO : 0;
+        hostRaised |= (raised & (AXP_SF_OVF | AXP_SF_IOV)) ? FE_OVERFLOW : 0;
+        hostRaised |= (raised & AXP_SF_UNF) ? FE_UNDERFLOW : 0;
+        hostRaised |= (raised & AXP_SF_INE) ? FE_INEXACT : 0;
+        if (op.vax == true)
+        {
+            AXP_FP_SetExcSum(instr, hostRaised, (raised & AXP_SF_IOV) != 0);
+        }
+        else
+        {
+            AXP_FP_SetFPCR(cpu, instr, hostRaised, (raised & AXP_SF_IOV) != 0);
+        }
+        traps = AXP_SF_Traps(&op, raised);
+        if ((traps & AXP_SF_INV) != 0)
+        {
+            retVal = IllegalOperand;
+        }
+        else if (traps != 0)
+        {
+            retVal = ArithmeticTraps;
+        }
+    }
+    else
+    {
+        retVal = IllegalOperand;
+    }
+
+    /*
+     * Return back to the caller with any exception that may have occurred.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_FP_SoftFloatNeeded
+ * 	This function is called to determine if an IEEE instruction needs to be
+ * 	performed with integer arithmetic only.  The host gets finite, normal
+ * 	operands right, but not what the Alpha does with denormals, infinities,
+ * 	and NaNs, or when the FPCR maps denormals to zero.  A result that is too
+ * 	small to be normalized is not known until after the host has performed
+ * 	the instruction (see AXP_FP_SoftFloatRedo).  An instruction that is not
+ * 	a valid one is left for the caller to reject.
+ *
+ * Input Parameters:
+ *	cpu:
+ *		A pointer to the structure containing the information needed to
+ *		emulate a single CPU.
+ * 	instr:
+ * 		A pointer to a structure containing the information needed to
+ * 		execute this instruction.
+ *
+ * Output Parameters:
+ * 	None.
+ *
+ * Return Value:
+ * 	true:	The instruction needs to be performed with integer arithmetic.
+ * 	false:	The host can perform the instruction.
+ */
+bool AXP_FP_SoftFloatNeeded(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
+{
+    AXP_FP_FUNC *func = (AXP_FP_FUNC *) &instr->function;
+    AXP_SF_OPERATION op;
+    bool retVal = (cpu->fpcr.dnz == 1) || (cpu->fpcr.undz == 1);
+    bool unary = (instr->opcode == ITFP) || (func->fnc >= AXP_FP_CVTF);
+    u64 regs[2] = {instr->src1v.fp.uq, instr->src2v.fp.uq};
+    u32 exponent, ii;
+
+    /*
+     * An integer source is never special.
+     */
+    if (func->src == AXP_FP_Q)
+    {
+        unary = true;
+        regs[0] = 0;
+    }
+    for (ii = 0; (ii < (unary ? 1 : 2)) && (retVal == false); ii++)
+    {
+        exponent = (regs[ii] >> AXP_T_FRAC_SIZE) & AXP_T_EXP_MASK;
+        retVal = (exponent == AXP_T_EXP_MAX) ||
+                 ((exponent == 0) && ((regs[ii] & AXP_R_FRAC) != 0));
+    }
+    if (retVal == true)
+    {
+        retVal = AXP_SF_Decode(instr->opcode, instr->function, &cpu->fpcr, &op);
+    }
+
+    /*
+     * Return the results of the test back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_FP_SoftFloatRedo
+ * 	This function is called after the host has performed an IEEE
+ * 	instruction, to determine if it needs to be performed again with integer
+ * 	arithmetic only.  When the result is too small to be normalized, the
+ * 	host delivers a denormal, and raises underflow if it is not exact.  The
+ * 	Alpha writes a true zero instead, unless the instruction has the /U
+ * 	qualifier, in which case it traps.  The operands are finite, as
+ * 	AXP_FP_SoftFloatNeeded has already been called, so the underflow flag is
+ * 	from this instruction.
+ *
+ * Input Parameters:
+ *	cpu:
+ *		A pointer to the structure containing the information needed to
+ *		emulate a single CPU.
+ * 	instr:
+ * 		A pointer to a structure containing the information needed to
+ * 		execute this instruction, with the result from the host.
+ *
+ * Output Parameters:
+ * 	None.
+ *
+ * Return Value:
+ * 	true:	The instruction needs to be performed with integer arithmetic.
+ * 	false:	The result from the host is the one the Alpha delivers.
+ */
+bool AXP_FP_SoftFloatRedo(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
+{
+    AXP_SF_OPERATION op;
+    u64 result = instr->destv.fp.uq;
+    bool retVal = fetestexcept(FE_UNDERFLOW) != 0;
+
+    if (retVal == false)
+    {
+        retVal = (((result >> AXP_T_FRAC_SIZE) & AXP_T_EXP_MASK) == 0) &&
+                 ((result & AXP_R_FRAC) != 0);
+    }
+    if (retVal == true)
+    {
+        retVal = AXP_SF_Decode(instr->opcode, instr->function, &cpu->fpcr, &op);
+    }
+
+    /*
+     * Return the results of the test back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * AXP_FP_CheckForVAXInvalid
  * 	This function is called to check one or two parameters are invalid VAX
@@ -37,6 +37,11 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  The IEEE instructions no longer set and restore the host rounding and
+ *  exception modes around every operation.  AXP_FP_EnterIEEE only changes
+ *  what is not already as the instruction needs it.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Fbox/AXP_21264_Fbox_OperateIEEE.h"
@@ -70,8 +75,6 @@ AXP_EXCEPTIONS AXP_ADDS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     AXP_EXCEPTIONS retVal = NoException;
     AXP_FP_FUNC *fpFunc = (AXP_FP_FUNC *) &instr->function;
     float src1v, src2v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -100,19 +103,10 @@ AXP_EXCEPTIONS AXP_ADDS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src2v = AXP_FP_CvtFPRToFloat(instr->src2v.fp);
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -123,17 +117,6 @@ AXP_EXCEPTIONS AXP_ADDS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     /*
@@ -205,8 +188,6 @@ AXP_EXCEPTIONS AXP_ADDT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u64 tmp1;
         double tmp2;
     } src1v, src2v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -235,19 +216,10 @@ AXP_EXCEPTIONS AXP_ADDT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src2v.tmp1 = instr->src2v.fp.uq;
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -258,17 +230,6 @@ AXP_EXCEPTIONS AXP_ADDT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     raised &= (FE_INEXACT | FE_OVERFLOW | FE_UNDERFLOW | FE_INVALID);
@@ -593,8 +554,6 @@ AXP_EXCEPTIONS AXP_CVTTQ(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u64 tmp1;
         double tmp2;
     } src1v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -622,19 +581,10 @@ AXP_EXCEPTIONS AXP_CVTTQ(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src1v.tmp1 = instr->src1v.fp.uq;
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -645,17 +595,6 @@ AXP_EXCEPTIONS AXP_CVTTQ(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     raised &= (FE_INEXACT | FE_OVERFLOW | FE_INVALID);
@@ -719,8 +658,6 @@ AXP_EXCEPTIONS AXP_CVTQS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     AXP_FP_FUNC *fpFunc = (AXP_FP_FUNC *) &instr->function;
     u64 src1v;
     float destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -730,19 +667,10 @@ AXP_EXCEPTIONS AXP_CVTQS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     src1v = instr->src1v.fp.uq;
 
     /*
-     * Set the rounding mode, based on the function code and/or the FPCR.
-     */
-    oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-    /*
-     * Clear the current set of exceptions.
+     * Put the host in the rounding mode for the function code and/or the
+     * FPCR, with no exceptions raised.
      */
-    feclearexcept(FE_ALL_EXCEPT);
-
-    /*
-     * Disable any exception modes indicating in the FPCR.
-     */
-    oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+    AXP_FP_EnterIEEE(cpu, fpFunc);
 
     /*
      * Execute the instruction.
@@ -753,17 +681,6 @@ AXP_EXCEPTIONS AXP_CVTQS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
      * Test to see what exceptions were raised.
      */
     raised = fetestexcept(FE_ALL_EXCEPT);
-
-    /*
-     * Enable any exception modes that were set prior to getting into this
-     * function.
-     */
-    oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-    /*
-     * Reset the rounding mode
-     */
-    oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     raised &= FE_INEXACT;
 
     /*
@@ -817,8 +734,6 @@ AXP_EXCEPTIONS AXP_CVTQT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     AXP_FP_FUNC *fpFunc = (AXP_FP_FUNC *) &instr->function;
     u64 src1v;
     u64 destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -828,19 +743,10 @@ AXP_EXCEPTIONS AXP_CVTQT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     src1v = instr->src1v.fp.uq;
 
     /*
-     * Set the rounding mode, based on the function code and/or the FPCR.
-     */
-    oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-    /*
-     * Clear the current set of exceptions.
+     * Put the host in the rounding mode for the function code and/or the
+     * FPCR, with no exceptions raised.
      */
-    feclearexcept(FE_ALL_EXCEPT);
-
-    /*
-     * Disable any exception modes indicating in the FPCR.
-     */
-    oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+    AXP_FP_EnterIEEE(cpu, fpFunc);
 
     /*
      * Execute the instruction.
@@ -851,17 +757,6 @@ AXP_EXCEPTIONS AXP_CVTQT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
      * Test to see what exceptions were raised.
      */
     raised = fetestexcept(FE_ALL_EXCEPT);
-
-    /*
-     * Enable any exception modes that were set prior to getting into this
-     * function.
-     */
-    oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-    /*
-     * Reset the rounding mode
-     */
-    oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     raised &= FE_INEXACT;
 
     /*
@@ -919,8 +814,6 @@ AXP_EXCEPTIONS AXP_CVTST(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u64 tmp1;
         double tmp2;
     } destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -948,19 +841,10 @@ AXP_EXCEPTIONS AXP_CVTST(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src1v = AXP_FP_CvtFPRToFloat(instr->src1v.fp);
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -971,17 +855,6 @@ AXP_EXCEPTIONS AXP_CVTST(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     raised &= FE_INVALID;
@@ -1048,8 +921,6 @@ AXP_EXCEPTIONS AXP_CVTTS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u64 tmp1;
         float tmp2;
     } destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -1077,19 +948,10 @@ AXP_EXCEPTIONS AXP_CVTTS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src1v.tmp1 = instr->src1v.fp.uq;
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -1100,17 +962,6 @@ AXP_EXCEPTIONS AXP_CVTTS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     raised &= (FE_INVALID | FE_OVERFLOW | FE_UNDERFLOW | FE_INEXACT);
@@ -1177,8 +1028,6 @@ AXP_EXCEPTIONS AXP_DIVS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     AXP_EXCEPTIONS retVal = NoException;
     AXP_FP_FUNC *fpFunc = (AXP_FP_FUNC *) &instr->function;
     float src1v, src2v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -1207,19 +1056,10 @@ AXP_EXCEPTIONS AXP_DIVS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src2v = AXP_FP_CvtFPRToFloat(instr->src2v.fp);
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -1230,17 +1070,6 @@ AXP_EXCEPTIONS AXP_DIVS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     /*
@@ -1317,8 +1146,6 @@ AXP_EXCEPTIONS AXP_DIVT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u64 tmp1;
         double tmp2;
     } src1v, src2v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -1347,19 +1174,10 @@ AXP_EXCEPTIONS AXP_DIVT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src2v.tmp1 = instr->src2v.fp.uq;
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -1370,17 +1188,6 @@ AXP_EXCEPTIONS AXP_DIVT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     raised &= (FE_INEXACT |
@@ -1594,8 +1401,6 @@ AXP_EXCEPTIONS AXP_MULS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     AXP_EXCEPTIONS retVal = NoException;
     AXP_FP_FUNC *fpFunc = (AXP_FP_FUNC *) &instr->function;
     float src1v, src2v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -1624,19 +1429,10 @@ AXP_EXCEPTIONS AXP_MULS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src2v = AXP_FP_CvtFPRToFloat(instr->src2v.fp);
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -1647,17 +1443,6 @@ AXP_EXCEPTIONS AXP_MULS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     /*
@@ -1729,8 +1514,6 @@ AXP_EXCEPTIONS AXP_MULT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u64 tmp1;
         double tmp2;
     } src1v, src2v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -1759,19 +1542,10 @@ AXP_EXCEPTIONS AXP_MULT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src2v.tmp1 = instr->src2v.fp.uq;
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -1782,17 +1556,6 @@ AXP_EXCEPTIONS AXP_MULT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     raised &= (FE_INEXACT | FE_OVERFLOW | FE_UNDERFLOW | FE_INVALID);
@@ -1856,8 +1619,6 @@ AXP_EXCEPTIONS AXP_SQRTS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     AXP_EXCEPTIONS retVal = NoException;
     AXP_FP_FUNC *fpFunc = (AXP_FP_FUNC *) &instr->function;
     float src1v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -1885,19 +1646,10 @@ AXP_EXCEPTIONS AXP_SQRTS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src1v = AXP_FP_CvtFPRToFloat(instr->src1v.fp);
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -1908,17 +1660,6 @@ AXP_EXCEPTIONS AXP_SQRTS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     /*
@@ -1989,8 +1730,6 @@ AXP_EXCEPTIONS AXP_SQRTT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u64 tmp1;
         double tmp2;
     } src1v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -2018,19 +1757,10 @@ AXP_EXCEPTIONS AXP_SQRTT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src1v.tmp1 = instr->src1v.fp.uq;
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -2041,17 +1771,6 @@ AXP_EXCEPTIONS AXP_SQRTT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     raised &= (FE_INEXACT | FE_INVALID);
@@ -2117,8 +1836,6 @@ AXP_EXCEPTIONS AXP_SUBS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
     AXP_EXCEPTIONS retVal = NoException;
     AXP_FP_FUNC *fpFunc = (AXP_FP_FUNC *) &instr->function;
     float src1v, src2v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -2147,19 +1864,10 @@ AXP_EXCEPTIONS AXP_SUBS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src2v = AXP_FP_CvtFPRToFloat(instr->src2v.fp);
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -2170,17 +1878,6 @@ AXP_EXCEPTIONS AXP_SUBS(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     /*
@@ -2253,8 +1950,6 @@ AXP_EXCEPTIONS AXP_SUBT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u64 tmp1;
         double tmp2;
     } src1v, src2v, destv;
-    int oldRndMode = 0;
-    int oldExcMode = 0;
     int raised = 0;
 
     /*
@@ -2283,19 +1978,10 @@ AXP_EXCEPTIONS AXP_SUBT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         src2v.tmp1 = instr->src2v.fp.uq;
 
         /*
-         * Set the rounding mode, based on the function code and/or the FPCR.
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(cpu, fpFunc, oldRndMode);
-
-        /*
-         * Clear the current set of exceptions.
-         */
-        feclearexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Disable any exception modes indicating in the FPCR.
+         * Put the host in the rounding mode for the function code and/or the
+         * FPCR, with no exceptions raised.
          */
-        oldExcMode = AXP_FP_SetExceptionMode(cpu, oldExcMode);
+        AXP_FP_EnterIEEE(cpu, fpFunc);
 
         /*
          * Execute the instruction.
@@ -2306,17 +1992,6 @@ AXP_EXCEPTIONS AXP_SUBT(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
          * Test to see what exceptions were raised.
          */
         raised = fetestexcept(FE_ALL_EXCEPT);
-
-        /*
-         * Enable any exception modes that were set prior to getting into this
-         * function.
-         */
-        oldExcMode = AXP_FP_SetExceptionMode(NULL, oldExcMode);
-
-        /*
-         * Reset the rounding mode
-         */
-        oldRndMode = AXP_FP_SetRoundingMode(NULL, NULL, oldRndMode);
     }
 
     raised &= (FE_INEXACT | FE_OVERFLOW | FE_UNDERFLOW | FE_INVALID);
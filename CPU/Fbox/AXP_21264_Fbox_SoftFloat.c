@@ -0,0 +1,1655 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the code to perform the VAX F, G, and D and IEEE
+ *  S and T floating-point operations of the Alpha AXP processor, using only
+ *  integer arithmetic.  Nothing about the host's floating-point environment
+ *  is used or changed, so the results and exceptions are the same no matter
+ *  what host this is run on, or what the host was last asked to do.
+ *
+ *  Each operand is unpacked from its register format into a sign, a 64-bit
+ *  significand with its most significant bit set, and an unbiased exponent,
+ *  such that the value is significand * 2^(exponent - 63).  The operation is
+ *  performed on the unpacked values, keeping every bit it produces, or at
+ *  least whether any were non-zero (the sticky bit).  The result is then
+ *  rounded, once, to the precision of the destination format, checked
+ *  against the range of that format, and packed into the register format.
+ *
+ *  The VAX formats round to nearest with ties away from zero, or chopped, and
+ *  have no infinities, NaNs, or denormals.  A VAX operand with a zero exponent
+ *  and a sign of zero is a zero, whatever its fraction (a dirty zero).  With a
+ *  sign of one it is a reserved operand, which is an invalid operation.
+ *
+ *  The IEEE formats round to nearest even, chopped, toward minus infinity, or
+ *  toward plus infinity.  Denormal operands are used as they are, unless the
+ *  FPCR has DNZ set.  A tiny result is a denormal when the instruction has the
+ *  /U qualifier, and is otherwise a true zero, as the Alpha architecture
+ *  specifies.  Tininess is detected before rounding.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#include "CommonUtilities/AXP_Configure.h"
+#include "CPU/Fbox/AXP_21264_Fbox_SoftFloat.h"
+
+/*
+ * The classes of unpacked values.
+ */
+typedef enum
+{
+    AXP_SF_Zero,
+    AXP_SF_Finite,
+    AXP_SF_Infinity,
+    AXP_SF_QNaN,
+    AXP_SF_SNaN,
+    AXP_SF_Reserved
+} AXP_SF_CLASS;
+
+/*
+ * An unpacked value.  For a finite value, the significand has its most
+ * significant bit set, and the value is sig * 2^(exp - 63).  The register is
+ * kept for propagating NaNs.
+ */
+typedef struct
+{
+    AXP_SF_CLASS cls;
+    bool sign;
+    i32 exp;
+    u64 sig;
+    u64 reg;
+} AXP_SF_VALUE;
+
+/*
+ * The characteristics of each floating-point format.  The precision includes
+ * the hidden bit, the minimum and maximum exponents are unbiased, for values
+ * of the form 1.f * 2^exp, and fracShift is where the fraction starts in the
+ * register.
+ */
+typedef struct
+{
+    u32 precision;
+    i32 minExp;
+    i32 maxExp;
+    u32 fracShift;
+    bool ieee;
+} AXP_SF_FORMAT_INFO;
+
+static const AXP_SF_FORMAT_INFO _AXP_SF_Formats[] =
+{
+    {24, -128, 126, 29, false},         /* VAX F */
+    {53, -1024, 1022, 0, false},        /* VAX G */
+    {56, -128, 126, 0, false},          /* VAX D */
+    {24, -126, 127, 29, true},          /* IEEE S */
+    {53, -1022, 1023, 0, true}          /* IEEE T */
+};
+
+#define AXP_SF_QUIET_BIT        0x0008000000000000ull
+#define AXP_SF_DEFAULT_NAN      0xfff8000000000000ull
+#define AXP_SF_S_LOW_BITS       0x000000001fffffffull
+#define AXP_SF_TRUE             0x4000000000000000ull
+
+/*
+ * _AXP_SF_ShiftRightJam
+ *  This function is called to shift a value right, setting the least
+ *  significant bit of the result if any of the bits shifted out were set.
+ *
+ * Input Parameters:
+ *  value:
+ *      A value to be shifted.
+ *  count:
+ *      A value indicating the number of bits to shift.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The shifted value.
+ */
+static u64 _AXP_SF_ShiftRightJam(u64 value, u32 count)
+{
+    u64 retVal;
+
+    if (count == 0)
+    {
+        retVal = value;
+    }
+    else if (count < 64)
+    {
+        retVal = (value >> count) | ((value << (64 - count)) != 0);
+    }
+    else
+    {
+        retVal = (value != 0);
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_Normalize128
+ *  This function is called to reduce a non-zero 128-bit intermediate result
+ *  to a 64-bit significand with its most significant bit set, keeping whether
+ *  any of the bits dropped were set in its least significant bit.
+ *
+ * Input Parameters:
+ *  value:
+ *      A non-zero value to be normalized.
+ *
+ * Output Parameters:
+ *  top:
+ *      A pointer to receive the bit number of the most significant bit set in
+ *      the value.
+ *
+ * Return Values:
+ *  The normalized significand.
+ */
+static u64 _AXP_SF_Normalize128(u128 value, i32 *top)
+{
+    u64 high = (u64) (value >> 64);
+    u64 retVal;
+    i32 bit;
+
+    if (high != 0)
+    {
+        bit = 127 - __builtin_clzll(high);
+    }
+    else
+    {
+        bit = 63 - __builtin_clzll((u64) value);
+    }
+    if (bit > 63)
+    {
+        retVal = (u64) (value >> (bit - 63)) |
+                 ((value & (((u128) 1 << (bit - 63)) - 1)) != 0);
+    }
+    else
+    {
+        retVal = (u64) value << (63 - bit);
+    }
+    *top = bit;
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_Unpack
+ *  This function is called to unpack a register into its class, sign,
+ *  exponent, and significand.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  fmt:
+ *      A value indicating the format of the register.
+ *  reg:
+ *      A value of the register.
+ *
+ * Output Parameters:
+ *  val:
+ *      A pointer to receive the unpacked value.
+ *
+ * Return Values:
+ *  None.
+ */
+static void _AXP_SF_Unpack(AXP_SF_OPERATION *op,
+                           AXP_SF_FORMAT fmt,
+                           u64 reg,
+                           AXP_SF_VALUE *val)
+{
+    const AXP_SF_FORMAT_INFO *info = &_AXP_SF_Formats[fmt];
+    u64 fraction;
+    u32 exponent;
+    u32 fracBits = info->precision - 1;
+
+    val->sign = (reg >> 63) != 0;
+    val->reg = reg;
+    if (fmt == AXP_SF_D)
+    {
+        exponent = (reg >> AXP_D_FRAC_SIZE) & AXP_D_EXP_MASK;
+        fraction = reg & (AXP_D_HIDDEN_BIT - 1);
+    }
+    else
+    {
+        exponent = (reg >> AXP_T_FRAC_SIZE) & AXP_T_EXP_MASK;
+        fraction = (reg & AXP_R_FRAC) >> info->fracShift;
+    }
+    if (info->ieee == false)
+    {
+
+        /*
+         * A VAX exponent of zero is a zero when the sign is clear, whatever
+         * the fraction, and a reserved operand when the sign is set.
+         */
+        if (exponent == 0)
+        {
+            val->cls = (val->sign == true) ? AXP_SF_Reserved : AXP_SF_Zero;
+        }
+        else
+        {
+
+            /*
+             * F is held in the register with the G exponent.
+             */
+            val->cls = AXP_SF_Finite;
+            val->sig = (fraction | (1ull << fracBits)) << (63 - fracBits);
+            val->exp = exponent - ((fmt == AXP_SF_D) ? 129 : 1025);
+        }
+    }
+    else if (exponent == AXP_T_EXP_MAX)
+    {
+        if (fraction == 0)
+        {
+            val->cls = AXP_SF_Infinity;
+        }
+        else
+        {
+            val->cls = ((reg & AXP_SF_QUIET_BIT) != 0) ?
+                    AXP_SF_QNaN : AXP_SF_SNaN;
+        }
+    }
+    else if (exponent == 0)
+    {
+        if ((fraction == 0) || (op->dnz == true))
+        {
+            val->cls = AXP_SF_Zero;
+        }
+        else
+        {
+            u32 shift = __builtin_clzll(fraction);
+
+            val->cls = AXP_SF_Finite;
+            val->sig = fraction << shift;
+            val->exp = info->minExp - fracBits + 63 - shift;
+        }
+    }
+    else
+    {
+
+        /*
+         * The register always holds an IEEE exponent with the T bias, even
+         * for S.
+         */
+        val->cls = AXP_SF_Finite;
+        val->sig = (fraction | (1ull << fracBits)) << (63 - fracBits);
+        val->exp = exponent - AXP_T_BIAS;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * _AXP_SF_PackZero
+ *  This function is called to return a zero in a format.  VAX has only the
+ *  one, true, zero.
+ *
+ * Input Parameters:
+ *  fmt:
+ *      A value indicating the format of the result.
+ *  sign:
+ *      A boolean indicating the sign of an IEEE zero.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The register value of the zero.
+ */
+static u64 _AXP_SF_PackZero(AXP_SF_FORMAT fmt, bool sign)
+{
+    u64 retVal = AXP_FPR_ZERO;
+
+    if ((_AXP_SF_Formats[fmt].ieee == true) && (sign == true))
+    {
+        retVal = AXP_R_SIGN;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_QuietNaN
+ *  This function is called to return the result of an IEEE operation with a
+ *  NaN operand, which is the first NaN operand, made quiet.  If either NaN is
+ *  signaling, this is an invalid operation.
+ *
+ * Input Parameters:
+ *  fmt:
+ *      A value indicating the format of the result.
+ *  a:
+ *      A pointer to the first operand.
+ *  b:
+ *      A pointer to the second operand, or NULL.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  The register value of the NaN.
+ */
+static u64 _AXP_SF_QuietNaN(AXP_SF_FORMAT fmt,
+                            AXP_SF_VALUE *a,
+                            AXP_SF_VALUE *b,
+                            u32 *raised)
+{
+    u64 retVal;
+
+    if ((a->cls == AXP_SF_SNaN) || ((b != NULL) && (b->cls == AXP_SF_SNaN)))
+    {
+        *raised |= AXP_SF_INV;
+    }
+    if ((a->cls == AXP_SF_QNaN) || (a->cls == AXP_SF_SNaN))
+    {
+        retVal = a->reg | AXP_SF_QUIET_BIT;
+    }
+    else
+    {
+        retVal = b->reg | AXP_SF_QUIET_BIT;
+    }
+    if (fmt == AXP_SF_S)
+    {
+        retVal &= ~AXP_SF_S_LOW_BITS;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_RoundPack
+ *  This function is called to round a result to the precision of its format,
+ *  check it against the range of the format, and pack it into a register.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  fmt:
+ *      A value indicating the format of the result.
+ *  sign:
+ *      A boolean indicating that the result is negative.
+ *  exp:
+ *      A value of the unbiased exponent of the result.
+ *  sig:
+ *      A value of the significand of the result, with its most significant
+ *      bit set and any bits lost before now in its least significant bit.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  The register value of the result.
+ */
+static u64 _AXP_SF_RoundPack(AXP_SF_OPERATION *op,
+                             AXP_SF_FORMAT fmt,
+                             bool sign,
+                             i32 exp,
+                             u64 sig,
+                             u32 *raised)
+{
+    const AXP_SF_FORMAT_INFO *info = &_AXP_SF_Formats[fmt];
+    u32 shift = 64 - info->precision;
+    u64 half = 1ull << (shift - 1);
+    u64 roundBits, mant, retVal;
+    bool tiny = false;
+    bool increment;
+
+    /*
+     * An IEEE result too small to be normalized is denormalized before it is
+     * rounded, so that it is rounded to the bits a denormal has.
+     */
+    if ((info->ieee == true) && (exp < info->minExp))
+    {
+        tiny = true;
+        sig = _AXP_SF_ShiftRightJam(sig, info->minExp - exp);
+        exp = info->minExp;
+    }
+    roundBits = sig & ((1ull << shift) - 1);
+    mant = sig >> shift;
+    switch (op->rnd)
+    {
+        case AXP_FP_CHOPPED:
+            increment = false;
+            break;
+
+        case AXP_FP_MINUS_INF:
+            increment = (sign == true) && (roundBits != 0);
+            break;
+
+        case AXP_FP_PLUS_INF:
+            increment = (sign == false) && (roundBits != 0);
+            break;
+
+        case AXP_FP_NORMAL:
+        default:
+            if (info->ieee == true)
+            {
+                increment = (roundBits > half) ||
+                            ((roundBits == half) && ((mant & 1) != 0));
+            }
+            else
+            {
+                increment = roundBits >= half;
+            }
+            break;
+    }
+    if (increment == true)
+    {
+        mant++;
+        if ((mant >> info->precision) != 0)
+        {
+            mant >>= 1;
+            exp++;
+        }
+    }
+
+    if (info->ieee == false)
+    {
+
+        /*
+         * VAX has no inexact exception.  An overflow always traps, and its
+         * result is unpredictable, so zero is returned.  An underflow is a
+         * true zero, which only traps with /U.
+         */
+        if (exp > info->maxExp)
+        {
+            *raised |= AXP_SF_OVF;
+            retVal = AXP_FPR_ZERO;
+        }
+        else if (exp < info->minExp)
+        {
+            *raised |= AXP_SF_UNF;
+            retVal = AXP_FPR_ZERO;
+        }
+        else
+        {
+            mant &= (1ull << (info->precision - 1)) - 1;
+            if (fmt == AXP_SF_D)
+            {
+                retVal = ((u64) sign << 63) |
+                         ((u64) (exp + 129) << AXP_D_FRAC_SIZE) |
+                         mant;
+            }
+            else
+            {
+                retVal = ((u64) sign << 63) |
+                         ((u64) (exp + 1025) << AXP_G_FRAC_SIZE) |
+                         (mant << info->fracShift);
+            }
+        }
+    }
+    else if (exp > info->maxExp)
+    {
+
+        /*
+         * An overflow is infinity, or the largest finite value when rounding
+         * away from infinity.
+         */
+        *raised |= AXP_SF_OVF | AXP_SF_INE;
+        if ((op->rnd == AXP_FP_CHOPPED) ||
+            ((op->rnd == AXP_FP_MINUS_INF) && (sign == false)) ||
+            ((op->rnd == AXP_FP_PLUS_INF) && (sign == true)))
+        {
+            retVal = ((u64) sign << 63) |
+                     ((u64) (info->maxExp + AXP_T_BIAS) << AXP_T_FRAC_SIZE) |
+                     ((((1ull << (info->precision - 1)) - 1)) <<
+                      info->fracShift);
+        }
+        else
+        {
+            retVal = ((u64) sign << 63) | AXP_R_PINF;
+        }
+    }
+    else
+    {
+        if (tiny == true)
+        {
+
+            /*
+             * Without /U, or when the FPCR asks for it, an underflow is a true
+             * zero.  Otherwise, it is the denormal.  It is only an underflow
+             * exception if it is also inexact, unless underflow traps.
+             */
+            if (((op->trp & AXP_FP_TRP_U) == 0) || (op->undz == true))
+            {
+                *raised |= AXP_SF_UNF | AXP_SF_INE;
+                mant = 0;
+                sign = false;
+                roundBits = 0;
+            }
+            else if (roundBits != 0)
+            {
+                *raised |= AXP_SF_UNF;
+            }
+            else if ((op->disabled & AXP_SF_UNF) == 0)
+            {
+                *raised |= AXP_SF_UNF;
+            }
+        }
+        if (roundBits != 0)
+        {
+            *raised |= AXP_SF_INE;
+        }
+        if ((mant >> (info->precision - 1)) != 0)
+        {
+            retVal = ((u64) sign << 63) |
+                     ((u64) (exp + AXP_T_BIAS) << AXP_T_FRAC_SIZE) |
+                     ((mant & ((1ull << (info->precision - 1)) - 1)) <<
+                      info->fracShift);
+        }
+        else
+        {
+            retVal = ((u64) sign << 63) | (mant << info->fracShift);
+        }
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_AddSub
+ *  This function is called to add or subtract two values.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  a:
+ *      A pointer to the first operand.
+ *  b:
+ *      A pointer to the second operand.
+ *  subtract:
+ *      A boolean indicating that the second operand is subtracted.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  The register value of the result.
+ */
+static u64 _AXP_SF_AddSub(AXP_SF_OPERATION *op,
+                          AXP_SF_VALUE *a,
+                          AXP_SF_VALUE *b,
+                          bool subtract,
+                          u32 *raised)
+{
+    AXP_SF_VALUE *big, *small;
+    bool bSign = b->sign ^ subtract;
+    u128 bigSig, smallSig, sum;
+    u64 retVal;
+    i32 top;
+
+    if ((a->cls >= AXP_SF_QNaN) || (b->cls >= AXP_SF_QNaN))
+    {
+        retVal = _AXP_SF_QuietNaN(op->dest, a, b, raised);
+    }
+    else if (a->cls == AXP_SF_Infinity)
+    {
+        if ((b->cls == AXP_SF_Infinity) && (a->sign != bSign))
+        {
+            *raised |= AXP_SF_INV;
+            retVal = AXP_SF_DEFAULT_NAN;
+        }
+        else
+        {
+            retVal = ((u64) a->sign << 63) | AXP_R_PINF;
+        }
+    }
+    else if (b->cls == AXP_SF_Infinity)
+    {
+        retVal = ((u64) bSign << 63) | AXP_R_PINF;
+    }
+    else if ((a->cls == AXP_SF_Zero) && (b->cls == AXP_SF_Zero))
+    {
+
+        /*
+         * The sum of unlike-signed zeros is only negative when rounding
+         * toward minus infinity.
+         */
+        retVal = _AXP_SF_PackZero(op->dest,
+                                  (a->sign == bSign) ?
+                                      a->sign :
+                                      (op->rnd == AXP_FP_MINUS_INF));
+    }
+    else if (b->cls == AXP_SF_Zero)
+    {
+        retVal = _AXP_SF_RoundPack(op,
+                                   op->dest,
+                                   a->sign,
+                                   a->exp,
+                                   a->sig,
+                                   raised);
+    }
+    else if (a->cls == AXP_SF_Zero)
+    {
+        retVal = _AXP_SF_RoundPack(op, op->dest, bSign, b->exp, b->sig, raised);
+    }
+    else
+    {
+        bool bigSign, smallSign;
+
+        /*
+         * Line the smaller magnitude up with the larger one.  With the
+         * significands at bit 126, there is room for the carry out of an
+         * add, and for the bits of the smaller one shifted out of 64 bits.
+         */
+        if ((a->exp > b->exp) || ((a->exp == b->exp) && (a->sig >= b->sig)))
+        {
+            big = a;
+            bigSign = a->sign;
+            small = b;
+            smallSign = bSign;
+        }
+        else
+        {
+            big = b;
+            bigSign = bSign;
+            small = a;
+            smallSign = a->sign;
+        }
+        bigSig = (u128) big->sig << 63;
+        smallSig = (u128) small->sig << 63;
+        if ((big->exp - small->exp) >= 127)
+        {
+            smallSig = 1;
+        }
+        else if (big->exp != small->exp)
+        {
+            u32 shift = big->exp - small->exp;
+
+            smallSig = (smallSig >> shift) |
+                       ((smallSig & (((u128) 1 << shift) - 1)) != 0);
+        }
+        if (bigSign == smallSign)
+        {
+            sum = bigSig + smallSig;
+        }
+        else
+        {
+            sum = bigSig - smallSig;
+        }
+        if (sum == 0)
+        {
+            retVal = _AXP_SF_PackZero(op->dest, op->rnd == AXP_FP_MINUS_INF);
+        }
+        else
+        {
+            u64 sig = _AXP_SF_Normalize128(sum, &top);
+
+            retVal = _AXP_SF_RoundPack(op,
+                                       op->dest,
+                                       bigSign,
+                                       big->exp - 126 + top,
+                                       sig,
+                                       raised);
+        }
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_Mul
+ *  This function is called to multiply two values.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  a:
+ *      A pointer to the first operand.
+ *  b:
+ *      A pointer to the second operand.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  The register value of the result.
+ */
+static u64 _AXP_SF_Mul(AXP_SF_OPERATION *op,
+                       AXP_SF_VALUE *a,
+                       AXP_SF_VALUE *b,
+                       u32 *raised)
+{
+    bool sign = a->sign ^ b->sign;
+    u64 retVal;
+    i32 top;
+
+    if ((a->cls >= AXP_SF_QNaN) || (b->cls >= AXP_SF_QNaN))
+    {
+        retVal = _AXP_SF_QuietNaN(op->dest, a, b, raised);
+    }
+    else if ((a->cls == AXP_SF_Infinity) || (b->cls == AXP_SF_Infinity))
+    {
+        if ((a->cls == AXP_SF_Zero) || (b->cls == AXP_SF_Zero))
+        {
+            *raised |= AXP_SF_INV;
+            retVal = AXP_SF_DEFAULT_NAN;
+        }
+        else
+        {
+            retVal = ((u64) sign << 63) | AXP_R_PINF;
+        }
+    }
+    else if ((a->cls == AXP_SF_Zero) || (b->cls == AXP_SF_Zero))
+    {
+        retVal = _AXP_SF_PackZero(op->dest, sign);
+    }
+    else
+    {
+        u64 sig = _AXP_SF_Normalize128((u128) a->sig * b->sig, &top);
+
+        retVal = _AXP_SF_RoundPack(op,
+                                   op->dest,
+                                   sign,
+                                   a->exp + b->exp - 126 + top,
+                                   sig,
+                                   raised);
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_Div
+ *  This function is called to divide one value by another.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  a:
+ *      A pointer to the dividend.
+ *  b:
+ *      A pointer to the divisor.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  The register value of the result.
+ */
+static u64 _AXP_SF_Div(AXP_SF_OPERATION *op,
+                       AXP_SF_VALUE *a,
+                       AXP_SF_VALUE *b,
+                       u32 *raised)
+{
+    bool sign = a->sign ^ b->sign;
+    u64 retVal;
+
+    if ((a->cls >= AXP_SF_QNaN) || (b->cls >= AXP_SF_QNaN))
+    {
+        retVal = _AXP_SF_QuietNaN(op->dest, a, b, raised);
+    }
+    else if (a->cls == AXP_SF_Infinity)
+    {
+        if (b->cls == AXP_SF_Infinity)
+        {
+            *raised |= AXP_SF_INV;
+            retVal = AXP_SF_DEFAULT_NAN;
+        }
+        else
+        {
+            retVal = ((u64) sign << 63) | AXP_R_PINF;
+        }
+    }
+    else if (b->cls == AXP_SF_Infinity)
+    {
+        retVal = _AXP_SF_PackZero(op->dest, sign);
+    }
+    else if (b->cls == AXP_SF_Zero)
+    {
+        if (a->cls == AXP_SF_Zero)
+        {
+            *raised |= AXP_SF_INV;
+            retVal = op->vax ? AXP_FPR_ZERO : AXP_SF_DEFAULT_NAN;
+        }
+        else
+        {
+            *raised |= AXP_SF_DZE;
+            retVal = op->vax ? AXP_FPR_ZERO : (((u64) sign << 63) | AXP_R_PINF);
+        }
+    }
+    else if (a->cls == AXP_SF_Zero)
+    {
+        retVal = _AXP_SF_PackZero(op->dest, sign);
+    }
+    else
+    {
+        u128 dividend = (u128) a->sig << 64;
+        u128 quotient = dividend / b->sig;
+        bool remainder = (dividend - (quotient * b->sig)) != 0;
+        u64 sig;
+        i32 exp;
+
+        /*
+         * The quotient is from 2^63 up to, but not including, 2^65.
+         */
+        if ((quotient >> 64) != 0)
+        {
+            sig = (u64) (quotient >> 1) | (u64) (quotient & 1) | remainder;
+            exp = a->exp - b->exp;
+        }
+        else
+        {
+            sig = (u64) quotient | remainder;
+            exp = a->exp - b->exp - 1;
+        }
+        retVal = _AXP_SF_RoundPack(op, op->dest, sign, exp, sig, raised);
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_Sqrt
+ *  This function is called to determine the square root of a value.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  a:
+ *      A pointer to the operand.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  The register value of the result.
+ */
+static u64 _AXP_SF_Sqrt(AXP_SF_OPERATION *op, AXP_SF_VALUE *a, u32 *raised)
+{
+    u64 retVal;
+
+    if (a->cls >= AXP_SF_QNaN)
+    {
+        retVal = _AXP_SF_QuietNaN(op->dest, a, NULL, raised);
+    }
+    else if (a->cls == AXP_SF_Zero)
+    {
+        retVal = _AXP_SF_PackZero(op->dest, a->sign);
+    }
+    else if (a->sign == true)
+    {
+        *raised |= AXP_SF_INV;
+        retVal = op->vax ? AXP_FPR_ZERO : AXP_SF_DEFAULT_NAN;
+    }
+    else if (a->cls == AXP_SF_Infinity)
+    {
+        retVal = AXP_R_PINF;
+    }
+    else
+    {
+        u128 radicand, one, root = 0;
+        i32 exp;
+
+        /*
+         * Make the power of two even, so that it can be halved, then take the
+         * root a bit at a time.  The radicand is at least 2^126, so the root
+         * is 64 bits with its most significant bit set.
+         */
+        if (((a->exp - 127) & 1) == 0)
+        {
+            radicand = (u128) a->sig << 64;
+            exp = ((a->exp - 127) / 2) + 63;
+        }
+        else
+        {
+            radicand = (u128) a->sig << 63;
+            exp = ((a->exp - 126) / 2) + 63;
+        }
+        one = (u128) 1 << 126;
+        while (one != 0)
+        {
+            if (radicand >= (root + one))
+            {
+                radicand -= root + one;
+                root = (root >> 1) + one;
+            }
+            else
+            {
+                root >>= 1;
+            }
+            one >>= 2;
+        }
+        retVal = _AXP_SF_RoundPack(op,
+                                   op->dest,
+                                   false,
+                                   exp,
+                                   (u64) root | (radicand != 0),
+                                   raised);
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_CvtToQ
+ *  This function is called to convert a value to a quadword integer, rounding
+ *  it as the instruction says.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  a:
+ *      A pointer to the operand.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  The integer, which is the low 64 bits of the true result on an integer
+ *  overflow.
+ */
+static u64 _AXP_SF_CvtToQ(AXP_SF_OPERATION *op, AXP_SF_VALUE *a, u32 *raised)
+{
+    u64 mag = 0, fraction = 0;
+    u64 retVal = 0;
+    bool increment;
+
+    if (a->cls >= AXP_SF_Infinity)
+    {
+        *raised |= AXP_SF_INV;
+    }
+    else if (a->cls == AXP_SF_Finite)
+    {
+        bool overflow;
+
+        /*
+         * Split the value into its integer part and the fraction left over,
+         * with the fraction's most significant bit worth one half.
+         */
+        if (a->exp >= 127)
+        {
+            overflow = true;
+        }
+        else if (a->exp >= 63)
+        {
+            mag = a->sig << (a->exp - 63);
+            overflow = true;
+        }
+        else
+        {
+            u32 shift = 63 - a->exp;
+
+            overflow = false;
+            if (shift >= 128)
+            {
+                fraction = 1;
+            }
+            else if (shift > 64)
+            {
+                fraction = _AXP_SF_ShiftRightJam(a->sig, shift - 64);
+            }
+            else if (shift == 64)
+            {
+                fraction = a->sig;
+            }
+            else
+            {
+                mag = a->sig >> shift;
+                fraction = a->sig << (64 - shift);
+            }
+        }
+        switch (op->rnd)
+        {
+            case AXP_FP_CHOPPED:
+                increment = false;
+                break;
+
+            case AXP_FP_MINUS_INF:
+                increment = (a->sign == true) && (fraction != 0);
+                break;
+
+            case AXP_FP_PLUS_INF:
+                increment = (a->sign == false) && (fraction != 0);
+                break;
+
+            case AXP_FP_NORMAL:
+            default:
+                if (op->vax == true)
+                {
+                    increment = fraction >= AXP_R_SIGN;
+                }
+                else
+                {
+                    increment = (fraction > AXP_R_SIGN) ||
+                                ((fraction == AXP_R_SIGN) && ((mag & 1) != 0));
+                }
+                break;
+        }
+        if (increment == true)
+        {
+            mag++;
+            overflow |= (mag == 0);
+        }
+        if (fraction != 0)
+        {
+            *raised |= AXP_SF_INE;
+        }
+        if ((overflow == true) ||
+            (mag > (a->sign ? AXP_Q_NEGMAX : AXP_Q_POSMAX)))
+        {
+            *raised |= AXP_SF_IOV | AXP_SF_INE;
+        }
+        retVal = a->sign ? (~mag + 1) : mag;
+    }
+
+    /*
+     * VAX has no inexact exception.
+     */
+    if (op->vax == true)
+    {
+        *raised &= ~AXP_SF_INE;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_Cvt
+ *  This function is called to convert a value from one format to another.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  reg:
+ *      A value of the source register.
+ *  a:
+ *      A pointer to the unpacked operand, when it is not a quadword.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  The register value of the result.
+ */
+static u64 _AXP_SF_Cvt(AXP_SF_OPERATION *op,
+                       u64 reg,
+                       AXP_SF_VALUE *a,
+                       u32 *raised)
+{
+    u64 retVal;
+
+    if (op->dest == AXP_SF_Q)
+    {
+        retVal = _AXP_SF_CvtToQ(op, a, raised);
+    }
+    else if (op->src == AXP_SF_Q)
+    {
+        if (reg == 0)
+        {
+            retVal = AXP_FPR_ZERO;
+        }
+        else
+        {
+            bool sign = (reg >> 63) != 0;
+            u64 mag = sign ? (~reg + 1) : reg;
+            u32 shift = __builtin_clzll(mag);
+
+            retVal = _AXP_SF_RoundPack(op,
+                                       op->dest,
+                                       sign,
+                                       63 - shift,
+                                       mag << shift,
+                                       raised);
+        }
+    }
+    else if (a->cls >= AXP_SF_QNaN)
+    {
+        retVal = _AXP_SF_QuietNaN(op->dest, a, NULL, raised);
+    }
+    else if (a->cls == AXP_SF_Infinity)
+    {
+        retVal = ((u64) a->sign << 63) | AXP_R_PINF;
+    }
+    else if (a->cls == AXP_SF_Zero)
+    {
+        retVal = _AXP_SF_PackZero(op->dest, a->sign);
+    }
+    else
+    {
+        retVal = _AXP_SF_RoundPack(op,
+                                   op->dest,
+                                   a->sign,
+                                   a->exp,
+                                   a->sig,
+                                   raised);
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_SF_Compare
+ *  This function is called to compare two values.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  a:
+ *      A pointer to the first operand.
+ *  b:
+ *      A pointer to the second operand.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to the exceptions raised, updated as needed.
+ *
+ * Return Values:
+ *  AXP_SF_TRUE:    The comparison is true.
+ *  AXP_FPR_ZERO:   The comparison is false.
+ */
+static u64 _AXP_SF_Compare(AXP_SF_OPERATION *op,
+                           AXP_SF_VALUE *a,
+                           AXP_SF_VALUE *b,
+                           u32 *raised)
+{
+    bool unordered = (a->cls >= AXP_SF_QNaN) || (b->cls >= AXP_SF_QNaN);
+    bool result = false;
+    int order = 0;
+
+    if (unordered == true)
+    {
+
+        /*
+         * A signaling NaN is always an invalid operation.  A quiet one is too,
+         * for less than and less than or equal.
+         */
+        if ((a->cls == AXP_SF_SNaN) || (b->cls == AXP_SF_SNaN) ||
+            (op->oper == AXP_SF_CmpLT) || (op->oper == AXP_SF_CmpLE))
+        {
+            *raised |= AXP_SF_INV;
+        }
+        result = op->oper == AXP_SF_CmpUN;
+    }
+    else
+    {
+
+        /*
+         * Order the magnitudes (zero, then finite, then infinity), then apply
+         * the signs.  Zeros are equal whatever their signs.
+         */
+        if ((a->cls != AXP_SF_Zero) || (b->cls != AXP_SF_Zero))
+        {
+            if (a->cls != b->cls)
+            {
+                order = (a->cls > b->cls) ? 1 : -1;
+            }
+            else if (a->cls == AXP_SF_Finite)
+            {
+                if (a->exp != b->exp)
+                {
+                    order = (a->exp > b->exp) ? 1 : -1;
+                }
+                else if (a->sig != b->sig)
+                {
+                    order = (a->sig > b->sig) ? 1 : -1;
+                }
+            }
+            if (a->sign != b->sign)
+            {
+                order = (a->sign == true) ? -1 : 1;
+                if ((a->cls == AXP_SF_Zero) && (b->cls == AXP_SF_Zero))
+                {
+                    order = 0;
+                }
+            }
+            else if (a->sign == true)
+            {
+                order = -order;
+            }
+        }
+        switch (op->oper)
+        {
+            case AXP_SF_CmpEQ:
+                result = order == 0;
+                break;
+
+            case AXP_SF_CmpLT:
+                result = order < 0;
+                break;
+
+            case AXP_SF_CmpLE:
+                result = order <= 0;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (result ? AXP_SF_TRUE : AXP_FPR_ZERO);
+}
+
+/*
+ * AXP_SF_Decode
+ *  This function is called to decode the opcode and function fields of a
+ *  floating-point operate instruction, along with the FPCR, into the
+ *  operation to be performed.
+ *
+ * Input Parameters:
+ *  opcode:
+ *      A value of the instruction's opcode, ITFP, FLTV, or FLTI.
+ *  function:
+ *      A value of the instruction's function field.
+ *  fpcr:
+ *      A pointer to the FPCR, for the dynamic rounding mode, and the
+ *      exceptions disabled with /S.
+ *
+ * Output Parameters:
+ *  op:
+ *      A pointer to receive the decoded operation.
+ *
+ * Return Values:
+ *  true:   The instruction is one performed here.
+ *  false:  The instruction is not.
+ */
+bool AXP_SF_Decode(u32 opcode,
+                   u32 function,
+                   AXP_FBOX_FPCR *fpcr,
+                   AXP_SF_OPERATION *op)
+{
+    static const AXP_SF_FORMAT vaxSrc[] =
+    {
+        AXP_SF_F, AXP_SF_D, AXP_SF_G, AXP_SF_Q
+    };
+    static const AXP_SF_FORMAT ieeeSrc[] =
+    {
+        AXP_SF_S, AXP_SF_Q, AXP_SF_T, AXP_SF_Q
+    };
+    u32 fnc = function & 0xf;
+    u32 src = (function >> 4) & 0x3;
+    bool retVal = true;
+
+    op->rnd = (function >> 6) & 0x3;
+    op->trp = (function >> 8) & 0x7;
+    op->vax = opcode == FLTV;
+    switch (opcode)
+    {
+        case ITFP:
+            op->oper = AXP_SF_Sqrt;
+            op->vax = fnc == AXP_FP_SQRTFG;
+            if (op->vax == true)
+            {
+                op->src = (src == AXP_FP_G) ? AXP_SF_G : AXP_SF_F;
+            }
+            else
+            {
+                op->src = (src == AXP_FP_T) ? AXP_SF_T : AXP_SF_S;
+            }
+            op->dest = op->src;
+            retVal = ((fnc == AXP_FP_SQRTFG) || (fnc == AXP_FP_SQRTST)) &&
+                     ((src == AXP_FP_S) || (src == AXP_FP_T));
+            break;
+
+        case FLTV:
+        case FLTI:
+            op->src = (opcode == FLTV) ? vaxSrc[src] : ieeeSrc[src];
+            op->dest = op->src;
+            switch (fnc)
+            {
+                case AXP_FP_ADD:
+                case AXP_FP_SUB:
+                case AXP_FP_MUL:
+                case AXP_FP_DIV:
+                    op->oper = AXP_SF_Add + fnc;
+                    retVal = (op->src == AXP_SF_F) || (op->src == AXP_SF_G) ||
+                             (op->src == AXP_SF_S) || (op->src == AXP_SF_T);
+                    break;
+
+                case AXP_FP_CMPUN:
+                case AXP_FP_CMPEQ:
+                case AXP_FP_CMPLT:
+                case AXP_FP_CMPLE:
+                    op->oper = AXP_SF_CmpUN + (fnc - AXP_FP_CMPUN);
+                    retVal = (op->src == AXP_SF_G) || (op->src == AXP_SF_T);
+                    retVal &= (op->oper != AXP_SF_CmpUN) || (op->vax == false);
+                    break;
+
+                case AXP_FP_CVTF:
+                    op->oper = AXP_SF_Cvt;
+                    if (op->vax == true)
+                    {
+                        op->dest = AXP_SF_F;
+                        retVal = (op->src == AXP_SF_G) || (op->src == AXP_SF_Q);
+                    }
+                    else if ((op->src == AXP_SF_T) &&
+                             ((op->trp & 0x3) == AXP_FP_TRP_I))
+                    {
+
+                        /*
+                         * CVTST is encoded as CVTTS with only /I, which is
+                         * not otherwise a valid qualifier.
+                         */
+                        op->src = AXP_SF_S;
+                        op->dest = AXP_SF_T;
+                        op->trp &= ~AXP_FP_TRP_I;
+                    }
+                    else
+                    {
+                        op->dest = AXP_SF_S;
+                        retVal = (op->src == AXP_SF_T) || (op->src == AXP_SF_Q);
+                    }
+                    break;
+
+                case AXP_FP_CVTD:
+                    op->oper = AXP_SF_Cvt;
+                    op->dest = AXP_SF_D;
+                    retVal = (op->vax == true) && (op->src == AXP_SF_G);
+                    break;
+
+                case AXP_FP_CVTG:
+                    op->oper = AXP_SF_Cvt;
+                    if (op->vax == true)
+                    {
+                        op->dest = AXP_SF_G;
+                        retVal = (op->src == AXP_SF_D) || (op->src == AXP_SF_Q);
+                    }
+                    else
+                    {
+                        op->dest = AXP_SF_T;
+                        retVal = op->src == AXP_SF_Q;
+                    }
+                    break;
+
+                case AXP_FP_CVTQ:
+                    op->oper = AXP_SF_Cvt;
+                    op->dest = AXP_SF_Q;
+                    retVal = (op->src == AXP_SF_G) || (op->src == AXP_SF_T);
+                    break;
+
+                default:
+                    retVal = false;
+                    break;
+            }
+            break;
+
+        default:
+            retVal = false;
+            break;
+    }
+
+    /*
+     * VAX rounding is either chopped or normal.  IEEE dynamic rounding comes
+     * from the FPCR.
+     */
+    if (op->vax == true)
+    {
+        op->rnd = (op->rnd == AXP_FP_CHOPPED) ? AXP_FP_CHOPPED : AXP_FP_NORMAL;
+        op->dnz = false;
+        op->undz = false;
+        op->disabled = 0;
+    }
+    else
+    {
+        if (op->rnd == AXP_FP_DYNAMIC)
+        {
+            op->rnd = fpcr->dyn;
+        }
+        op->dnz = fpcr->dnz == 1;
+        op->disabled = 0;
+        if ((op->trp & AXP_FP_TRP_S) != 0)
+        {
+            op->disabled |= fpcr->invd ? AXP_SF_INV : 0;
+            op->disabled |= fpcr->dzed ? AXP_SF_DZE : 0;
+            op->disabled |= fpcr->ovfd ? AXP_SF_OVF : 0;
+            op->disabled |= fpcr->unfd ? AXP_SF_UNF : 0;
+            op->disabled |= fpcr->ined ? AXP_SF_INE : 0;
+        }
+        op->undz = (fpcr->undz == 1) && ((op->disabled & AXP_SF_UNF) != 0);
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_SF_Execute
+ *  This function is called to perform a decoded operation.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  src1:
+ *      A value of the first source register.  For the conversions and square
+ *      root, this is the only operand.
+ *  src2:
+ *      A value of the second source register.
+ *
+ * Output Parameters:
+ *  raised:
+ *      A pointer to receive the exceptions raised.
+ *
+ * Return Values:
+ *  The value for the destination register.
+ */
+u64 AXP_SF_Execute(AXP_SF_OPERATION *op, u64 src1, u64 src2, u32 *raised)
+{
+    AXP_SF_VALUE a, b;
+    u64 retVal = AXP_FPR_ZERO;
+
+    *raised = 0;
+    if (op->src != AXP_SF_Q)
+    {
+        _AXP_SF_Unpack(op, op->src, src1, &a);
+    }
+    else
+    {
+        a.cls = AXP_SF_Zero;
+    }
+    if (op->oper < AXP_SF_Sqrt || op->oper > AXP_SF_Cvt)
+    {
+        _AXP_SF_Unpack(op, op->src, src2, &b);
+    }
+    else
+    {
+        b.cls = AXP_SF_Zero;
+    }
+
+    /*
+     * A VAX reserved operand is an invalid operation, without a result.
+     */
+    if ((a.cls == AXP_SF_Reserved) || (b.cls == AXP_SF_Reserved))
+    {
+        *raised = AXP_SF_INV;
+    }
+    else
+    {
+        switch (op->oper)
+        {
+            case AXP_SF_Add:
+            case AXP_SF_Sub:
+                retVal = _AXP_SF_AddSub(op,
+                                        &a,
+                                        &b,
+                                        op->oper == AXP_SF_Sub,
+                                        raised);
+                break;
+
+            case AXP_SF_Mul:
+                retVal = _AXP_SF_Mul(op, &a, &b, raised);
+                break;
+
+            case AXP_SF_Div:
+                retVal = _AXP_SF_Div(op, &a, &b, raised);
+                break;
+
+            case AXP_SF_Sqrt:
+                retVal = _AXP_SF_Sqrt(op, &a, raised);
+                break;
+
+            case AXP_SF_Cvt:
+                retVal = _AXP_SF_Cvt(op, src1, &a, raised);
+                break;
+
+            case AXP_SF_CmpUN:
+            case AXP_SF_CmpEQ:
+            case AXP_SF_CmpLT:
+            case AXP_SF_CmpLE:
+                retVal = _AXP_SF_Compare(op, &a, &b, raised);
+                break;
+        }
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_SF_Traps
+ *  This function is called to determine which of the exceptions an operation
+ *  raised cause a trap.  Invalid operation, division by zero, and overflow
+ *  always do.  Underflow does with /U, integer overflow with /V, and inexact
+ *  with /I.  With /S, those the FPCR disables do not.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  raised:
+ *      A value of the exceptions raised.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The exceptions that trap.
+ */
+u32 AXP_SF_Traps(AXP_SF_OPERATION *op, u32 raised)
+{
+    u32 enabled = AXP_SF_INV | AXP_SF_DZE | AXP_SF_OVF;
+
+    if ((op->trp & AXP_FP_TRP_U) != 0)
+    {
+        enabled |= (op->dest == AXP_SF_Q) ? AXP_SF_IOV : AXP_SF_UNF;
+    }
+    if (((op->trp & AXP_FP_TRP_I) != 0) && (op->vax == false))
+    {
+        enabled |= AXP_SF_INE;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (raised & enabled & ~op->disabled);
+}
+
+/*
+ * AXP_SF_Batch
+ *  This function is called to perform one decoded operation on a number of
+ *  operand pairs.  The operation is decoded once, for all of them, and the
+ *  operands and results are kept in separate arrays, so that the loop over
+ *  them does nothing but the operation itself.
+ *
+ * Input Parameters:
+ *  op:
+ *      A pointer to the decoded operation.
+ *  src1:
+ *      A pointer to an array of the first source register values.
+ *  src2:
+ *      A pointer to an array of the second source register values.  This may
+ *      be NULL for the conversions and square root.
+ *  count:
+ *      A value indicating the number of entries in each array.
+ *
+ * Output Parameters:
+ *  dest:
+ *      A pointer to an array to receive the results.
+ *  raised:
+ *      A pointer to an array to receive the exceptions each one raised.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_SF_Batch(AXP_SF_OPERATION *op,
+                  const u64 *src1,
+                  const u64 *src2,
+                  u64 *dest,
+                  u32 *raised,
+                  u32 count)
+{
+    u32 ii;
+
+    if (src2 == NULL)
+    {
+        for (ii = 0; ii < count; ii++)
+        {
+            dest[ii] = AXP_SF_Execute(op, src1[ii], 0, &raised[ii]);
+        }
+    }
+    else
+    {
+        for (ii = 0; ii < count; ii++)
+        {
+            dest[ii] = AXP_SF_Execute(op, src1[ii], src2[ii], &raised[ii]);
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
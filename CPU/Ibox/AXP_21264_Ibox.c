@@ -123,15 +123,100 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.016 15-Oct-2026 Jonathan D. Belanger
+ *  The NOOP detection, Mbox slot selection, and IQ/FQ selection are now taken
+ *  from the predecoded instruction returned by the Icache, rather than being
+ *  determined again each time the instruction is fetched.
+ *
+ *  V01.017 15-Oct-2026 Jonathan D. Belanger
+ *  When the CPU is in functional mode, the fetched instructions are executed
+ *  in order by AXP_21264_Ibox_Functional, instead of being queued up to the
+ *  IQ and FQ.  Also added the code to change the execution mode, once all the
+ *  in-flight instructions have been retired.
+ *
+ *  V01.018 15-Oct-2026 Jonathan D. Belanger
+ *  Instructions are now handed to the Ebox and Fbox pipelines through
+ *  AXP_Execution_Enqueue, which puts them onto a lock-free ring for each
+ *  pipeline able to execute them and wakes just those pipelines.  The IQ and
+ *  FQ entry free-lists can now be returned to by more than one pipeline at the
+ *  same time, so the return is done under the Ebox/Fbox mutex.
+ *
+ *  V01.019 15-Oct-2026 Jonathan D. Belanger
+ *  Retiring an instruction no longer wakes all the Ebox or Fbox pipelines.
+ *  AXP_UpdateRegisters hands over just the instructions waiting on the
+ *  register written.
+ *
+ *  V01.020 15-Oct-2026 Jonathan D. Belanger
+ *  The ROB entries for a fetch block are now allocated with the ROB mutex
+ *  locked just once, and instructions are retired once per fetch block,
+ *  rather than after each instruction is decoded.  The Ibox waits for room in
+ *  the ROB, rather than overwriting entries still in-flight.  Retirement
+ *  statistics are kept for the number of instructions retired per call and
+ *  the reason retirement stopped.
+ *
+ *  V01.021 16-Oct-2026 Jonathan D. Belanger
+ *  Count the Ibox cycles, stalls, instructions decoded and retired, branches
+ *  and branch mispredictions in the performance counters.
+ *
+ *  V01.022 16-Oct-2026 Jonathan D. Belanger
+ *  Supply the instruction when getting an LQ or SQ slot.
+ *
+ *  V01.023 16-Oct-2026 Jonathan D. Belanger
+ *  Loads give back their LQ entry when retired.  A load that read stale data,
+ *  because an older store to the same bytes did not yet have its address, is
+ *  replayed (the 21264 load-store order trap).
+ *
+ *  V01.024 16-Oct-2026 Jonathan D. Belanger
+ *  Returns are predicted from the return stack, and computed jumps from the
+ *  jump target cache, when they are fetched.  The return stack is recovered
+ *  when fetched instructions are aborted.  The PC of the instruction that
+ *  caused an exception is pushed onto the return stack, rather than the
+ *  PALcode entry point.
+ *
+ *  V01.025 16-Oct-2026 Jonathan D. Belanger
+ *  A load or store is not decoded until there is room for it in the LQ or
+ *  SQ.  Until then, the Ibox retires what it can and waits for instructions
+ *  to complete.
+ *
+ *  V01.026 16-Oct-2026 Jonathan D. Belanger
+ *  Added AXP_21264_Ibox_Completed, which every completed instruction calls,
+ *  to signal the Ibox, under the Ibox mutex, when it is waiting for an
+ *  instruction to complete.  The Ibox sets the flag saying it is waiting
+ *  before it looks at the ROB, and waits for room in the ROB in a loop, in
+ *  AXP_21264_Ibox_WaitForROB, so that a wakeup cannot be missed.
+ *
+ *  V01.027 16-Oct-2026 Jonathan D. Belanger
+ *  Removed the code to change the execution mode while running.  The mode is
+ *  set for each CPU from the configuration when it is initialized.
+ *
+ *  V01.028 16-Oct-2026 Jonathan D. Belanger
+ *  The count of retirement stalls for an instruction that stalls the Ibox is
+ *  now updated under the ROB mutex, as the other retirement statistics are.
+ *
+ *  V01.029 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped lines longer than 80 columns.
+ *
+ *  V01.030 16-Oct-2026 Jonathan D. Belanger
+ *  Only decode the instructions the Icache fetch says are valid.  A fetch near
+ *  the end of an Icache block was decoding the slots after the block.
+ *
+ *  V01.031 16-Oct-2026 Jonathan D. Belanger
+ *  Restored changing the execution mode while running.  When a change has
+ *  been requested, the Ibox stops fetching, and the change is made once the
+ *  ROB, IQ, FQ, LQ, and SQ have all drained.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CommonUtilities/AXP_Dumps.h"
 #include "CPU/Ibox/AXP_21264_Ibox.h"
+#include "CommonUtilities/AXP_Execute_Box.h"
 #include "CPU/Ibox/AXP_21264_Ibox_Initialize.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Functional.h"
 #include "CPU/Ibox/AXP_21264_Ibox_InstructionDecoding.h"
 #include "CPU/Ibox/AXP_21264_Ibox_PCHandling.h"
 #include "CPU/Mbox/AXP_21264_Mbox.h"
 #include "CommonUtilities/AXP_Trace.h"
+#include <sched.h>
 
 /*
  * A local structure used to calculate the PC for a CALL_PAL function.
@@ -213,6 +298,11 @@ static char *_ins_state_[] =
 static AXP_QUEUE_ENTRY *AXP_GetNextIQEntry(AXP_21264_CPU *);
 static AXP_QUEUE_ENTRY *AXP_GetNextFQEntry(AXP_21264_CPU *);
 
+/*
+ * Functions that manage the ReOrder Buffer (ROB) entries.
+ */
+static u32 AXP_21264_Ibox_AllocROB(AXP_21264_CPU *, u32, u32 *);
+
 /*
  * AXP_GetNextIQEntry
  *  This function is called to get the next available entry for the IQ queue.
@@ -239,6 +329,7 @@ static AXP_QUEUE_ENTRY *AXP_GetNextIQEntry(AXP_21264_CPU *cpu)
 
     retVal = &cpu->iqEntries[cpu->iqEFreelist[cpu->iqEFlStart]];
     cpu->iqEFlStart = (cpu->iqEFlStart + 1) % AXP_IQ_LEN;
+    __atomic_add_fetch(&cpu->iqCount, 1, __ATOMIC_RELAXED);
 
     /*
      * Return back to the caller.
@@ -268,8 +359,10 @@ void AXP_ReturnIQEntry(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
 {
 
     /*
-     * Enter the index of the IQ entry onto the end of the free-list.
+     * Enter the index of the IQ entry onto the end of the free-list.  More
+     * than one pipeline can be returning an entry at the same time.
      */
+    pthread_mutex_lock(&cpu->eBoxMutex);
     cpu->iqEFreelist[cpu->iqEFlEnd] = entry->index;
 
     /*
@@ -277,6 +370,14 @@ void AXP_ReturnIQEntry(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
      * after end of the free-list.
      */
     cpu->iqEFlEnd = (cpu->iqEFlEnd + 1) % AXP_IQ_LEN;
+    pthread_mutex_unlock(&cpu->eBoxMutex);
+
+    /*
+     * The Ibox only takes an entry off the free-list when the count says
+     * there is one, so the count is decremented after the free-list has been
+     * updated.
+     */
+    __atomic_sub_fetch(&cpu->iqCount, 1, __ATOMIC_RELEASE);
 
     /*
      * Return back to the caller.
@@ -310,6 +411,7 @@ static AXP_QUEUE_ENTRY *AXP_GetNextFQEntry(AXP_21264_CPU *cpu)
 
     retVal = &cpu->fqEntries[cpu->fqEFreelist[cpu->fqEFlStart]];
     cpu->fqEFlStart = (cpu->fqEFlStart + 1) % AXP_FQ_LEN;
+    __atomic_add_fetch(&cpu->fqCount, 1, __ATOMIC_RELAXED);
 
     /*
      * Return back to the caller.
@@ -339,8 +441,10 @@ void AXP_ReturnFQEntry(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
 {
 
     /*
-     * Enter the index of the IQ entry onto the end of the free-list.
+     * Enter the index of the FQ entry onto the end of the free-list.  More
+     * than one pipeline can be returning an entry at the same time.
      */
+    pthread_mutex_lock(&cpu->fBoxMutex);
     cpu->fqEFreelist[cpu->fqEFlEnd] = entry->index;
 
     /*
@@ -348,6 +452,14 @@ void AXP_ReturnFQEntry(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
      * after end of the free-list.
      */
     cpu->fqEFlEnd = (cpu->fqEFlEnd + 1) % AXP_FQ_LEN;
+    pthread_mutex_unlock(&cpu->fBoxMutex);
+
+    /*
+     * The Ibox only takes an entry off the free-list when the count says
+     * there is one, so the count is decremented after the free-list has been
+     * updated.
+     */
+    __atomic_sub_fetch(&cpu->fqCount, 1, __ATOMIC_RELEASE);
 
     /*
      * Return back to the caller.
@@ -1385,12 +1497,13 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
 {
     AXP_INSTRUCTION *rob;
     u32 ii, end;
-    u32 signalWho = AXP_SIGNAL_NONE;
     bool split;
     bool done = false;
     bool updateDest = false;
     bool stallRetired = false;
     bool retVal = false;
+    u32 retired = 0;
+    AXP_RETIRE_STALL stop = AXP_RETIRE_EMPTY;
 
     if (AXP_IBOX_CALL)
     {
@@ -1457,6 +1570,32 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
          */
         if (rob->state == WaitingRetirement)
         {
+            bool replay = false;
+
+            /*
+             * A load gives back its LQ entry, and finds out whether it read
+             * stale data and needs to be replayed.
+             */
+            switch (rob->opcode)
+            {
+                case LDBU:
+                case LDQ_U:
+                case LDW_U:
+                case HW_LD:
+                case LDF:
+                case LDG:
+                case LDS:
+                case LDT:
+                case LDL:
+                case LDQ:
+                case LDL_L:
+                case LDQ_L:
+                    replay = AXP_21264_Mbox_RetireRead(cpu, rob->slot);
+                    break;
+
+                default:
+                    break;
+            }
 
             /*
              * If an exception occurred, we need to process it.  Otherwise, the
@@ -1480,6 +1619,7 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
                  * this one.
                  */
                 retVal = true;
+                stop = AXP_RETIRE_FAULT;
                 AXP_21264_Ibox_Event(cpu,
                                      fault,
                                      rob->pc,
@@ -1492,13 +1632,60 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
                 /*
                  * Call the function to abort all instructions immediately
                  * after the current one.  This may change the value of
-                 * cpu->robEnd.
+                 * cpu->robEnd.  The faulting instruction will be fetched
+                 * again, so the return stack is put back to how it was before
+                 * it was fetched.
                  */
                 if ((AXP_AbortInstructions(cpu, rob) == true) &&
                     (stallRetired == false))
                 {
                     stallRetired = true;
                 }
+                AXP_Branch_Recover(cpu, rob, false);
+            }
+
+            /*
+             * The load read stale data.  Like the 21264 load-store order trap,
+             * the load and all the instructions after it are fetched and
+             * executed again.  The load is retired without changing its
+             * destination register, by giving it the value the register had
+             * before the load (all older instructions have now retired).
+             */
+            else if (replay == true)
+            {
+                AXP_COUNT(cpu, AXP_CNT_LOAD_REPLAYS);
+                if (AXP_IBOX_OPT2)
+                {
+                    AXP_TRACE_BEGIN();
+                    AXP_TraceWrite("Load REPLAY instruction at "
+                                    "pc: 0x%016llx, opcode: 0x%02x",
+                                    rob->pc,
+                                    rob->opcode);
+                    AXP_TRACE_END();
+                }
+                if (retVal == false)
+                {
+                    stop = AXP_RETIRE_REPLAY;
+                }
+                retVal = true;
+                if ((rob->decodedReg.bits.dest & AXP_DEST_FLOAT) ==
+                    AXP_DEST_FLOAT)
+                {
+                    rob->destv.fp.uq = cpu->pf[rob->prevDestMap].value;
+                    AXP_UpdateRegisters(cpu, rob);
+                }
+                else if (rob->decodedReg.bits.dest != 0)
+                {
+                    rob->destv.r.uq = cpu->pr[rob->prevDestMap].value;
+                    AXP_UpdateRegisters(cpu, rob);
+                }
+                if ((AXP_AbortInstructions(cpu, rob) == true) &&
+                    (stallRetired == false))
+                {
+                    stallRetired = true;
+                }
+                AXP_Branch_Recover(cpu, rob, false);
+                AXP_21264_AddVPC(cpu, rob->pc);
             }
             else
             {
@@ -1517,7 +1704,7 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
                  * If this is a branch, we need to do the following:
                  *
                  *  1)  Update the branch prediction with whether we are taking
-                 *      branch or not.
+                 *      branch or not, and where to.
                  *  2)  If the branch is taken, update the destination
                  *      register.
                  *  3)  If the branch prediction did not match the actual
@@ -1528,17 +1715,17 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
                 if (rob->type == Branch)
                 {
                     bool taken = AXP_GET_PC(rob->branchPC) != 0;
+                    bool mispredict;
+
+                    AXP_COUNT(cpu, AXP_CNT_BRANCHES);
 
                     /*
                      * Step 1:
                      *
-                     * Update the branch prediction logic.
+                     * Update the branch prediction logic, which tells us if
+                     * the Ibox fetched the wrong instructions after this one.
                      */
-                    AXP_Branch_Direction(cpu,
-                                         rob->pc,
-                                         taken,
-                                         rob->localPredict,
-                                         rob->globalPredict);
+                    mispredict = AXP_Branch_Resolve(cpu, rob);
 
                     /*
                      * Step 2:
@@ -1572,7 +1759,7 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
                      *          Therefore, there is nothing else that needs to
                      *          be done.
                      */
-                    if (taken != rob->branchPredict)
+                    if (mispredict == true)
                     {
                         if (AXP_IBOX_OPT2)
                         {
@@ -1593,18 +1780,24 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
                          * instructions at the current PC so that it can go
                          * start executing the correct set of instructions.
                          */
+                        if (retVal == false)
+                        {
+                            stop = AXP_RETIRE_MISPREDICT;
+                        }
                         retVal = true;
 
                         /*
                          * Call the function to abort all instructions
                          * immediately after the current one.  This may change
-                         * the value of cpu->robEnd.
+                         * the value of cpu->robEnd.  The return stack is put
+                         * back to how this branch left it.
                          */
                         if ((AXP_AbortInstructions(cpu, rob) == true) &&
                             (stallRetired == false))
                         {
                             stallRetired = true;
                         }
+                        AXP_Branch_Recover(cpu, rob, true);
 
                         /*
                          * Step 4:
@@ -1641,7 +1834,7 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
                  */
                 if (updateDest == true)
                 {
-                    signalWho = AXP_UpdateRegisters(cpu, rob);
+                    AXP_UpdateRegisters(cpu, rob);
                 }
                 updateDest = false;
 
@@ -1704,6 +1897,7 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
              * the next instruction location.
              */
             rob->state = Retired;
+            retired++;
 
             cpu->robStart = (cpu->robStart + 1) % AXP_INFLIGHT_MAX;
             if (AXP_IBOX_INST)
@@ -1721,6 +1915,17 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
         else
         {
             done = true;
+            if (retVal == false)
+            {
+                if (rob->state == Queued)
+                {
+                    stop = AXP_RETIRE_QUEUED;
+                }
+                else if (rob->state == Executing)
+                {
+                    stop = AXP_RETIRE_EXECUTING;
+                }
+            }
         }
 
         /*
@@ -1749,6 +1954,17 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
         }
     }
 
+    /*
+     * Keep track of how many instructions we retired and why we stopped.
+     */
+    cpu->retireStats.calls++;
+    cpu->retireStats.retired += retired;
+    cpu->retireStats.perCall[(retired < AXP_RETIRE_HIST_LEN) ?
+                             retired :
+                             (AXP_RETIRE_HIST_LEN - 1)]++;
+    cpu->retireStats.stalls[stop]++;
+    AXP_COUNT_ADD(cpu, AXP_CNT_RETIRED, retired);
+
     /*
      * Finally, unlock the ROB mutex so that it can be updated by another
      * thread.
@@ -1765,32 +1981,252 @@ bool AXP_21264_Ibox_Retire(AXP_21264_CPU *cpu)
     }
 
     /*
-     * There may have been an instruction that was waiting for one of the
-     * destination registers to be written to before it could execute.  If one
-     * of them was for the Fbox, signal it to wake up and check to see if there
-     * is one or more Queued Floating Point instructions that can now be
-     * executed.
+     * Return back to the caller.
+     */
+    return (retVal);;
+}
+
+/*
+ * AXP_21264_Ibox_AllocROB
+ *  This function is called to allocate the ROB entries for a block of fetched
+ *  instructions, with the ROB mutex locked just the once.  The entries are
+ *  consecutive, starting at the end of the ROB.  The end of the ROB is moved
+ *  past each entry as the instruction is decoded into it.
+ *
+ *  NOTE:   Only the Ibox changes the start and end of the ROB, so the entries
+ *          allocated remain available until the Ibox uses them, or aborts
+ *          the instructions in front of them.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *  count:
+ *      A value indicating the number of entries wanted.
+ *
+ * Output Parameters:
+ *  first:
+ *      A pointer to a location to receive the index of the first ROB entry
+ *      allocated.
+ *
+ * Return Values:
+ *  The number of entries allocated, which may be less than requested, or even
+ *  zero, if the ROB does not have enough room.
+ */
+static u32 AXP_21264_Ibox_AllocROB(AXP_21264_CPU *cpu, u32 count, u32 *first)
+{
+    u32 inFlight;
+    u32 retVal;
+
+    pthread_mutex_lock(&cpu->robMutex);
+
+    /*
+     * One entry is always left unused, so that a full ROB can be told apart
+     * from an empty one.
+     */
+    inFlight = (cpu->robEnd + AXP_INFLIGHT_MAX - cpu->robStart) %
+               AXP_INFLIGHT_MAX;
+    retVal = AXP_INFLIGHT_MAX - 1 - inFlight;
+    if (retVal > count)
+    {
+        retVal = count;
+    }
+    *first = cpu->robEnd;
+    pthread_mutex_unlock(&cpu->robMutex);
+
+    /*
+     * Return what we allocated back to the caller.
      */
-    if (signalWho == AXP_SIGNAL_FBOX)
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Ibox_Completed
+ *  This function is called after an instruction has completed, and is waiting
+ *  to be retired.  If the Ibox is waiting for an instruction to complete, so
+ *  that it can retire it, then it is signaled.
+ *
+ *  NOTE:   The Ibox sets the stallWaitingRetirement flag before looking at the
+ *          ROB, and we look at it after the instruction state has been set.
+ *          Either the Ibox sees the instruction has completed, or we see the
+ *          Ibox is waiting and signal it.  The Ibox mutex is only locked when
+ *          the Ibox is, or is about to be, waiting, as the Ibox keeps it
+ *          locked while it is running.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_21264_Ibox_Completed(AXP_21264_CPU *cpu)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&cpu->stallWaitingRetirement, __ATOMIC_RELAXED) ==
+         true) ||
+        (cpu->execMode == FunctionalMode))
     {
-        pthread_cond_broadcast(&cpu->fBoxCondition);
+        pthread_mutex_lock(&cpu->iBoxMutex);
+        pthread_cond_signal(&cpu->iBoxCondition);
+        pthread_mutex_unlock(&cpu->iBoxMutex);
     }
 
     /*
-     * There may have been an instruction that was waiting for one of the
-     * destination registers to be written to before it could execute.  If one
-     * of them was for the Ebox, signal it to wake up and check to see if there
-     * is one or more Queued Integer instructions that can now be executed.
+     * Return back to the caller.
      */
-    if (signalWho == AXP_SIGNAL_EBOX)
+    return;
+}
+
+/*
+ * AXP_21264_Ibox_WaitForROB
+ *  This function is called by the Ibox when there is no room in the ROB for
+ *  another instruction.  Instructions are retired and, until there is room,
+ *  the Ibox waits for instructions to complete.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  true:   There is room in the ROB.
+ *  false:  The CPU is no longer running.
+ *
+ * NOTE:    The Ibox mutex is locked when we are called.
+ */
+bool AXP_21264_Ibox_WaitForROB(AXP_21264_CPU *cpu)
+{
+    u32 robIdx;
+    bool robFull = true;
+
+    pthread_mutex_lock(&cpu->robMutex);
+    cpu->retireStats.stalls[AXP_RETIRE_ROB_FULL]++;
+    pthread_mutex_unlock(&cpu->robMutex);
+
+    /*
+     * The flag is set each time around, as retiring an instruction that
+     * stalled the Ibox clears it.
+     */
+    while ((robFull == true) && (cpu->cpuState == Run))
     {
-        pthread_cond_broadcast(&cpu->eBoxCondition);
+        __atomic_store_n(&cpu->stallWaitingRetirement, true, __ATOMIC_SEQ_CST);
+        AXP_21264_Ibox_Retire(cpu);
+        robFull = AXP_21264_Ibox_AllocROB(cpu, 1, &robIdx) == 0;
+        if (robFull == true)
+        {
+            AXP_COUNT(cpu, AXP_CNT_IBOX_STALLS);
+            pthread_cond_wait(&cpu->iBoxCondition, &cpu->iBoxMutex);
+        }
     }
+    cpu->stallWaitingRetirement = false;
 
     /*
      * Return back to the caller.
      */
-    return (retVal);;
+    return (robFull == false);
+}
+
+/*
+ * AXP_21264_Ibox_ExecModeChange
+ *  This function is called by the Ibox when a change in the execution mode
+ *  has been requested.  Instructions are retired and, until the ROB is empty,
+ *  the Ibox waits for instructions to complete.  Once the ROB is empty,
+ *  nothing else is put into the IQ, FQ, LQ, or SQ, but the pipeline and Mbox
+ *  threads may not have given back their last entries yet, and do not signal
+ *  the Ibox when an aborted instruction's entry is given back, so they are
+ *  given a chance to run.  When everything has drained, the mode is changed.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  true:   The execution mode has been changed.
+ *  false:  Something is still in-flight, call again.
+ *
+ * NOTE:    The Ibox mutex is locked when we are called.
+ */
+bool AXP_21264_Ibox_ExecModeChange(AXP_21264_CPU *cpu)
+{
+    bool retVal = false;
+
+    __atomic_store_n(&cpu->stallWaitingRetirement, true, __ATOMIC_SEQ_CST);
+    AXP_21264_Ibox_Retire(cpu);
+    if (cpu->robStart != cpu->robEnd)
+    {
+        AXP_COUNT(cpu, AXP_CNT_IBOX_STALLS);
+        pthread_cond_wait(&cpu->iBoxCondition, &cpu->iBoxMutex);
+    }
+    else if ((__atomic_load_n(&cpu->iqCount, __ATOMIC_ACQUIRE) != 0) ||
+             (__atomic_load_n(&cpu->fqCount, __ATOMIC_ACQUIRE) != 0) ||
+             (AXP_21264_Mbox_QueuesEmpty(cpu) == false))
+    {
+        AXP_COUNT(cpu, AXP_CNT_IBOX_STALLS);
+        pthread_mutex_unlock(&cpu->iBoxMutex);
+        sched_yield();
+        pthread_mutex_lock(&cpu->iBoxMutex);
+    }
+    else
+    {
+        cpu->stallWaitingRetirement = false;
+        cpu->execMode = cpu->execModeReq;
+        cpu->execModeChange = false;
+        retVal = true;
+        if (AXP_IBOX_OPT1)
+        {
+            AXP_TRACE_BEGIN();
+            AXP_TraceWrite("Ibox is now in %s mode",
+                           (cpu->execMode == FunctionalMode) ?
+                               "Functional" : "Detailed");
+            AXP_TRACE_END();
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Ibox_RetireStats
+ *  This function is called to get a copy of the retirement statistics, which
+ *  are consistent with each other.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure for the emulated Alpha AXP 21264
+ *      processor.
+ *
+ * Output Parameters:
+ *  stats:
+ *      A pointer to a location to receive the retirement statistics.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_21264_Ibox_RetireStats(AXP_21264_CPU *cpu, AXP_RETIRE_STATS *stats)
+{
+    pthread_mutex_lock(&cpu->robMutex);
+    *stats = cpu->retireStats;
+    pthread_mutex_unlock(&cpu->robMutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
 }
 
 /*
@@ -1819,10 +2255,13 @@ void *AXP_21264_IboxMain(void *voidPtr)
     AXP_EXCEPTIONS exception;
     AXP_PIPELINE pipeline;
     u32 ii, fault;
+    u32 robIdx, robCnt;
     u16 whichQueue;
-    bool choice, wasRunning = false;
+    bool wasRunning = false;
+    bool fetched;
     bool _asm;
     bool noop;
+    bool lsqFull, lsqLoad = false;
     bool aborting, branchPredicted = false;
 
     /*
@@ -1896,6 +2335,33 @@ void *AXP_21264_IboxMain(void *voidPtr)
      */
     while (cpu->cpuState == Run)
     {
+        AXP_COUNT(cpu, AXP_CNT_IBOX_CYCLES);
+
+        /*
+         * If a change in the execution mode has been requested, then all the
+         * in-flight instructions need to be retired, and the IQ, FQ, LQ, and
+         * SQ emptied, before the change can take place.  If an exception is
+         * pending, then we process it first, as the in-flight instructions
+         * may be waiting on the PALcode.
+         */
+        if ((AXP_21264_Ibox_ExecModeCheck(cpu) == true) &&
+            (cpu->excPend == false) &&
+            (AXP_21264_Ibox_ExecModeChange(cpu) == false))
+        {
+            continue;
+        }
+
+        /*
+         * If there is no room in the ROB for another instruction, retire what
+         * we can.  If there is still no room, wait for an instruction to
+         * complete.  Functional mode does not use the ROB this way.
+         */
+        if ((cpu->execMode != FunctionalMode) &&
+            (AXP_21264_Ibox_AllocROB(cpu, 1, &robIdx) == 0))
+        {
+            AXP_21264_Ibox_WaitForROB(cpu);
+            continue;
+        }
 
         /*
          * Exceptions take precedence over normal CPU processing.  IF an
@@ -1904,7 +2370,7 @@ void *AXP_21264_IboxMain(void *voidPtr)
          */
         if (cpu->excPend == true)
         {
-            AXP_PUSH(cpu->excPC);
+            AXP_PUSH(cpu->excAddr.exc_pc);
             nextPC = cpu->excPC;
             cpu->excPend = false;
         }
@@ -1925,36 +2391,71 @@ void *AXP_21264_IboxMain(void *voidPtr)
          * get the Cbox to fill the iCache.  If the former, store the faulting
          * PC and generate an exception.
          */
-        if (AXP_IcacheFetch(cpu, nextPC, &nextCacheLine) == true)
+        fetched = AXP_IcacheFetch(cpu, nextPC, &nextCacheLine);
+
+        /*
+         * In functional mode, the instructions are executed, one at a time,
+         * to completion.
+         */
+        if ((fetched == true) && (cpu->execMode == FunctionalMode))
         {
+            AXP_21264_Ibox_Functional(cpu, &nextCacheLine);
+        }
+        else if (fetched == true)
+        {
+
+            /*
+             * Allocate the ROB entries for the instructions just fetched.  If
+             * there is not enough room for all of them, we decode what we
+             * can, and fetch the rest again once there is room.  A fetch near
+             * the end of the Icache block returns fewer instructions.
+             */
+            robCnt = AXP_21264_Ibox_AllocROB(cpu,
+                                             nextCacheLine.instrCount,
+                                             &robIdx);
             aborting = false;
+            lsqFull = false;
             for (ii = 0;
-                 ((ii < AXP_NUM_FETCH_INS) && (aborting == false));
+                 ((ii < robCnt) && (aborting == false) && (lsqFull == false));
                  ii++)
             {
 
                 /*
-                 * Lock the ROB mutex so that it is not updated by anyone but
-                 * this function.
+                 * A load or store needs an entry in the LQ or SQ.  If the
+                 * queue is full, retire what we can.  If it is still full,
+                 * this and the rest of the fetched instructions are fetched
+                 * again, once there is room.
                  */
-                pthread_mutex_lock(&cpu->robMutex);
-                decodedInstr = &cpu->rob[cpu->robEnd];
+                if ((nextCacheLine.predecoded[ii].noop == false) &&
+                    (nextCacheLine.predecoded[ii].slot !=
+                     AXP_PREDECODE_NO_SLOT))
+                {
+                    lsqLoad = nextCacheLine.predecoded[ii].slot ==
+                              AXP_PREDECODE_LQ_SLOT;
+                    if (AXP_21264_Mbox_SlotAvailable(cpu, lsqLoad) == false)
+                    {
+                        aborting = AXP_21264_Ibox_Retire(cpu);
+                        lsqFull = AXP_21264_Mbox_SlotAvailable(cpu, lsqLoad) ==
+                                  false;
+                        if ((aborting == true) || (lsqFull == true))
+                        {
+                            continue;
+                        }
+                    }
+                }
+                decodedInstr = &cpu->rob[robIdx];
                 if (AXP_IBOX_BUFF)
                 {
                     AXP_TRACE_BEGIN();
                     AXP_TraceWrite("ROB[%u] getting instruction at pc: "
                                    "0x%016llx",
-                                   cpu->robEnd,
+                                   robIdx,
                                    AXP_GET_PC(nextPC));
                     AXP_TRACE_END();
                 }
-
-                cpu->robEnd = (cpu->robEnd + 1) % AXP_INFLIGHT_MAX;
-
-                /*
-                 * We are done with the ROB mutex.
-                 */
-                pthread_mutex_unlock(&cpu->robMutex);
+                robIdx = (robIdx + 1) % AXP_INFLIGHT_MAX;
+                cpu->robEnd = robIdx;
+                AXP_COUNT(cpu, AXP_CNT_DECODED);
 
                 /*
                  * Go and decode the instruction, as well as rename the
@@ -1965,71 +2466,69 @@ void *AXP_21264_IboxMain(void *voidPtr)
                                   ii,
                                   decodedInstr,
                                   &pipeline);
-                if (decodedInstr->type == Branch)
-                {
-                    decodedInstr->branchPredict = AXP_Branch_Prediction(cpu,
-                                                                        nextPC,
-                                                                        &decodedInstr->localPredict,
-                                                                        &decodedInstr->globalPredict,
-                                                                        &choice);
 
-                    /*
-                     * TODO:    We need to be able to handle returns, and
-                     *          utilization of the, yet to be implemented,
-                     *          prediction stack.
-                     */
-                    if (decodedInstr->branchPredict == true)
+                /*
+                 * Predict whether this instruction branches, and where to.
+                 * Subroutine calls and returns push and pop the return stack
+                 * now, so that a return fetched before its call retires still
+                 * goes to the right place.
+                 */
+                if (AXP_Branch_Target(cpu, decodedInstr) == true)
+                {
+                    branchPC = decodedInstr->predictedPC;
+                    if (AXP_IcacheValid(cpu, branchPC) == false)
                     {
-                        branchPC = AXP_21264_DisplaceVPC(
-                        cpu,
-                        nextPC,
-                        (decodedInstr->displacement + 1));
-                        if (AXP_IcacheValid(cpu, branchPC) == false)
-                        {
-                            u64 pa;
-                            bool _asm;
-                            u32 fault;
-
-                            /*
-                             * We are branching to a location that is not
-                             * currently in the Icache.  We have to do the
-                             * following:
-                             *  1) Convert the virtual address to a physical
-                             *     address.
-                             *  2) Request the Cbox fetch the next set of
-                             *     instructions.
-                             */
-                            pa = AXP_va2pa(cpu,
-                                           AXP_GET_PC(branchPC),
-                                           nextPC,
-                                           false,
-                                           Execute,
-                                           &_asm,
-                                           &fault,
-                                           &exception);
-
-                            /*
-                             * TODO:    We need to check that we don't have a
-                             *          hit in the Bcache, before requesting
-                             *          it.  Also, not if we fill in the Icache
-                             *          from the Bcache, then we need to check
-                             *          the value of cpu->hwIntClr.fbtp to
-                             *          generate a 'Bad Icache fill parity'.
-                             */
-                            AXP_21264_Add_MAF(cpu, Istream, pa, 0,
-                            AXP_ICACHE_BUF_LEN, false);
-                        }
+                        u64 pa;
+                        bool _asm;
+                        u32 fault;
 
                         /*
-                         * The branch prediction code predicted that we will be
-                         * taking the branch.  This code assumes it is correct,
-                         * so we stop processing any more instructions at the
-                         * current PC.  We'll set the branch PC as the next set
-                         * of instructions to start executing at the bottom of
-                         * this for loop.
+                         * We are branching to a location that is not
+                         * currently in the Icache.  We have to do the
+                         * following:
+                         *  1) Convert the virtual address to a physical
+                         *     address.
+                         *  2) Request the Cbox fetch the next set of
+                         *     instructions.
+                         *
+                         * If the address does not translate, then there is
+                         * nothing to fetch.  A mispredicted return, for
+                         * example, can go anywhere.  The fetch will get the
+                         * exception, if we really do go there.
                          */
-                        branchPredicted = true;
+                        pa = AXP_va2pa(cpu,
+                                       AXP_GET_PC(branchPC),
+                                       nextPC,
+                                       false,
+                                       Execute,
+                                       &_asm,
+                                       &fault,
+                                       &exception);
+
+                        /*
+                         * TODO:    We need to check that we don't have a
+                         *          hit in the Bcache, before requesting
+                         *          it.  Also, not if we fill in the Icache
+                         *          from the Bcache, then we need to check
+                         *          the value of cpu->hwIntClr.fbtp to
+                         *          generate a 'Bad Icache fill parity'.
+                         */
+                        if (exception == NoException)
+                        {
+                            AXP_21264_Add_MAF(cpu, Istream, pa, 0,
+                                              AXP_ICACHE_BUF_LEN, false);
+                        }
                     }
+
+                    /*
+                     * The branch prediction code predicted that we will be
+                     * taking the branch.  This code assumes it is correct,
+                     * so we stop processing any more instructions at the
+                     * current PC.  We'll set the branch PC as the next set
+                     * of instructions to start executing at the bottom of
+                     * this for loop.
+                     */
+                    branchPredicted = true;
                 }
 
                 /*
@@ -2039,37 +2538,16 @@ void *AXP_21264_IboxMain(void *voidPtr)
                  * Ibox will resume processing instructions to be executed by
                  * the Ebox or Fbox.
                  */
-                cpu->stallWaitingRetirement = decodedInstr->stall;
+                __atomic_store_n(&cpu->stallWaitingRetirement,
+                                 decodedInstr->stall,
+                                 __ATOMIC_SEQ_CST);
 
                 /*
                  * If this is one of the potential NOOP instructions, then the
                  * instruction is already completed and does not need to be
                  * queued up.
                  */
-                noop = (pipeline == PipelineNone ? true : false);
-                if (decodedInstr->aDest == AXP_UNMAPPED_REG)
-                {
-                    switch (decodedInstr->opcode)
-                    {
-                        case INTA:
-                        case INTL:
-                        case INTM:
-                        case INTS:
-                        case LDQ_U:
-                        case ITFP:
-                            noop = true;
-                            break;
-
-                        case FLTI:
-                        case FLTL:
-                        case FLTV:
-                            if (decodedInstr->function != AXP_FUNC_MT_FPCR)
-                            {
-                                noop = true;
-                            }
-                            break;
-                    }
-                }
+                noop = nextCacheLine.predecoded[ii].noop;
                 if (AXP_IBOX_OPT2)
                 {
                     AXP_TRACE_BEGIN();
@@ -2092,70 +2570,22 @@ void *AXP_21264_IboxMain(void *voidPtr)
                      * Before we do much more, if we have a load/store, we need
                      * to request an entry in either the LQ or SQ in the Mbox.
                      */
-                    switch (decodedInstr->opcode)
+                    switch (nextCacheLine.predecoded[ii].slot)
                     {
-                        case LDBU:
-                        case LDQ_U:
-                        case LDW_U:
-                        case HW_LD:
-                        case LDF:
-                        case LDG:
-                        case LDS:
-                        case LDT:
-                        case LDL:
-                        case LDQ:
-                        case LDL_L:
-                        case LDQ_L:
-                            decodedInstr->slot = AXP_21264_Mbox_GetLQSlot(cpu);
+                        case AXP_PREDECODE_LQ_SLOT:
+                            decodedInstr->slot =
+                                AXP_21264_Mbox_GetLQSlot(cpu, decodedInstr);
                             break;
 
-                        case STW:
-                        case STB:
-                        case STQ_U:
-                        case HW_ST:
-                        case STF:
-                        case STG:
-                        case STS:
-                        case STT:
-                        case STL:
-                        case STQ:
-                        case STL_C:
-                        case STQ_C:
-                            decodedInstr->slot = AXP_21264_Mbox_GetSQSlot(cpu);
+                        case AXP_PREDECODE_SQ_SLOT:
+                            decodedInstr->slot =
+                                AXP_21264_Mbox_GetSQSlot(cpu, decodedInstr);
                             break;
 
                         default:
                             break;
                     }
-                    whichQueue = AXP_InstructionQueue(decodedInstr->opcode);
-                    if (whichQueue == AXP_COND)
-                    {
-                        if (decodedInstr->opcode == ITFP)
-                        {
-                            if ((decodedInstr->function == AXP_FUNC_ITOFS) ||
-                                (decodedInstr->function == AXP_FUNC_ITOFF) ||
-                                (decodedInstr->function == AXP_FUNC_ITOFT))
-                            {
-                                whichQueue = AXP_IQ;
-                            }
-                            else
-                            {
-                                whichQueue = AXP_FQ;
-                            }
-                        }
-                        else /* FPTI */
-                        {
-                            if ((decodedInstr->function == AXP_FUNC_FTOIT) ||
-                                (decodedInstr->function == AXP_FUNC_FTOIS))
-                            {
-                                whichQueue = AXP_FQ;
-                            }
-                            else
-                            {
-                                whichQueue = AXP_IQ;
-                            }
-                        }
-                    }
+                    whichQueue = nextCacheLine.predecoded[ii].whichQueue;
                     decodedInstr->state = Queued;
                     if (whichQueue == AXP_IQ)
                     {
@@ -2164,73 +2594,19 @@ void *AXP_21264_IboxMain(void *voidPtr)
                          * Scoreboard processing.
                          */
                         xqEntry = AXP_GetNextIQEntry(cpu);
-                        xqEntry->ins = decodedInstr;
-                        xqEntry->pipeline = pipeline;
-
-                        /*
-                         * Increment the counters for the pipelines in which
-                         * this instruction can be executed.  This is used to
-                         * keep the pipeline specific Ebox from unnecessarily
-                         * processing the IQ when there is nothing for it to
-                         * process.
-                         */
-                        if ((pipeline == EboxU0) ||
-                            (pipeline == EboxU0U1) ||
-                            (pipeline == EboxL0L1U0U1))
-                        {
-                            cpu->eBoxClusterCounter[AXP_21264_EBOX_U0]++;
-                        }
-                        if ((pipeline == EboxU1) ||
-                            (pipeline == EboxU0U1) ||
-                            (pipeline == EboxL0L1U0U1))
-                        {
-                            cpu->eBoxClusterCounter[AXP_21264_EBOX_U1]++;
-                        }
-                        if ((pipeline == EboxL0) ||
-                            (pipeline == EboxL0L1) ||
-                            (pipeline == EboxL0L1U0U1))
-                        {
-                            cpu->eBoxClusterCounter[AXP_21264_EBOX_L0]++;
-                        }
-                        if ((pipeline == EboxL1) ||
-                            (pipeline == EboxL0L1) ||
-                            (pipeline == EboxL0L1U0U1))
-                        {
-                            cpu->eBoxClusterCounter[AXP_21264_EBOX_L1]++;
-                        }
-                        AXP_InsertCountedQueue((AXP_CQUE_ENTRY *) &cpu->iq,
-                                               (AXP_CQUE_ENTRY *) xqEntry);
-                        pthread_mutex_lock(&cpu->eBoxMutex);
-                        pthread_cond_broadcast(&cpu->eBoxCondition);
-                        pthread_mutex_unlock(&cpu->eBoxMutex);
                     }
                     else /* FQ */
                     {
                         xqEntry = AXP_GetNextFQEntry(cpu);
-                        xqEntry->pipeline = pipeline;
-                        xqEntry->ins = decodedInstr;
-
-                        /*
-                         * Increment the counters for the pipelines in which
-                         * this instruction can be executed.  This is used to
-                         * keep the pipeline specific Fbox from unnecessarily
-                         * processing the FQ when there is nothing for it to
-                         * process.
-                         */
-                        if (pipeline == FboxMul)
-                        {
-                            cpu->fBoxClusterCounter[AXP_21264_FBOX_MULTIPLY]++;
-                        }
-                        else
-                        {
-                            cpu->fBoxClusterCounter[AXP_21264_FBOX_OTHER]++;
-                        }
-                        AXP_InsertCountedQueue((AXP_CQUE_ENTRY *) &cpu->fq,
-                                               (AXP_CQUE_ENTRY *) xqEntry);
-                        pthread_mutex_lock(&cpu->fBoxMutex);
-                        pthread_cond_broadcast(&cpu->fBoxCondition);
-                        pthread_mutex_unlock(&cpu->fBoxMutex);
                     }
+                    xqEntry->ins = decodedInstr;
+                    xqEntry->pipeline = pipeline;
+
+                    /*
+                     * Hand the entry to the pipelines in which this
+                     * instruction can be executed, and only wake those up.
+                     */
+                    AXP_Execution_Enqueue(cpu, xqEntry);
                 }
                 else
                 {
@@ -2238,19 +2614,23 @@ void *AXP_21264_IboxMain(void *voidPtr)
                 }
 
                 /*
-                 * Go see if any of there are any instructions that can be
-                 * retired.  If we are stalled, then loop truing to retire
-                 * instructions until either the instruction that caused the
-                 * stall is retired or aborted.
+                 * If we are stalled, then loop trying to retire instructions
+                 * until either the instruction that caused the stall is
+                 * retired or aborted.  Otherwise, retirement is left until
+                 * the whole fetch block has been decoded.
                  */
-                do
+                while (cpu->stallWaitingRetirement == true)
                 {
+                    pthread_mutex_lock(&cpu->robMutex);
+                    cpu->retireStats.stalls[AXP_RETIRE_STALL_INS]++;
+                    pthread_mutex_unlock(&cpu->robMutex);
                     aborting = AXP_21264_Ibox_Retire(cpu);
                     if (cpu->stallWaitingRetirement == true)
                     {
+                        AXP_COUNT(cpu, AXP_CNT_IBOX_STALLS);
                         pthread_cond_wait(&cpu->iBoxCondition, &cpu->iBoxMutex);
                     }
-                } while (cpu->stallWaitingRetirement == true);
+                }
 
                 /*
                  * If we aborted instructions, the aborting code has already
@@ -2280,6 +2660,33 @@ void *AXP_21264_IboxMain(void *voidPtr)
                 }
                 branchPredicted = false;
             }
+
+            /*
+             * Now go retire all the instructions that we can, in one go.  If
+             * this aborts instructions, the aborting code will have already
+             * set the correct next PC.  If we stopped decoding because the LQ
+             * or SQ was full, we let the completing instructions know we may
+             * be waiting for them first.
+             */
+            if (lsqFull == true)
+            {
+                __atomic_store_n(&cpu->stallWaitingRetirement,
+                                 true,
+                                 __ATOMIC_SEQ_CST);
+            }
+            AXP_21264_Ibox_Retire(cpu);
+
+            /*
+             * If the LQ or SQ is still full, then wait for a load or store to
+             * complete, so that it can be retired.
+             */
+            if ((lsqFull == true) &&
+                (AXP_21264_Mbox_SlotAvailable(cpu, lsqLoad) == false))
+            {
+                AXP_COUNT(cpu, AXP_CNT_IBOX_STALLS);
+                pthread_cond_wait(&cpu->iBoxCondition, &cpu->iBoxMutex);
+            }
+            cpu->stallWaitingRetirement = false;
         }
 
         /*
@@ -2370,9 +2777,12 @@ void *AXP_21264_IboxMain(void *voidPtr)
          */
         if (((cpu->excPend == false) &&
              (AXP_IcacheValid(cpu, nextPC) == false)) ||
-            ((AXP_CountedQueueFull(&cpu->iq, AXP_NUM_FETCH_INS) < 0) ||
-             (AXP_CountedQueueFull(&cpu->fq, AXP_NUM_FETCH_INS) < 0)))
+            ((__atomic_load_n(&cpu->iqCount, __ATOMIC_ACQUIRE) +
+              AXP_NUM_FETCH_INS >= AXP_IQ_LEN) ||
+             (__atomic_load_n(&cpu->fqCount, __ATOMIC_ACQUIRE) +
+              AXP_NUM_FETCH_INS >= AXP_FQ_LEN)))
         {
+            AXP_COUNT(cpu, AXP_CNT_IBOX_STALLS);
             pthread_cond_wait(&cpu->iBoxCondition, &cpu->iBoxMutex);
         }
     }
@@ -0,0 +1,594 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the functions needed to implement the functional
+ *  execution mode of the Ibox.  In this mode, the Ibox executes each fetched
+ *  instruction in order and to completion before moving onto the next one.
+ *  There is no register renaming, the IQ and FQ are not used, and nothing is
+ *  ever in-flight in the ROB.  The same instruction implementations (through
+ *  AXP_Dispatcher), architectural registers, TLBs, caches, and PALcode entry
+ *  points are used as in the detailed (pipelined) mode, so the CPU can be
+ *  switched from one mode to the other.
+ *
+ * Revision History:
+ *
+ *  V01.000 15-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 15-Oct-2026 Jonathan D. Belanger
+ *  Added the translated block cache.  Hot blocks are recorded as they are
+ *  executed and then run from the recorded instructions.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Count the instructions retired in the performance counters.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Supply the instruction when getting an LQ or SQ slot.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Loads give back their LQ entry when retired.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Removed AXP_21264_Ibox_SetExecMode, which nothing called.  The execution
+ *  mode is set for each CPU from the configuration.
+ *
+ *  V01.006 16-Oct-2026 Jonathan D. Belanger
+ *  Stop at the end of the Icache block.  The fetched instructions after it
+ *  are not from the same block, and were being executed anyway.
+ *
+ *  V01.007 16-Oct-2026 Jonathan D. Belanger
+ *  The fetched line now says how many of its instructions are from the Icache
+ *  block, so only those are executed.
+ *
+ *  V01.008 16-Oct-2026 Jonathan D. Belanger
+ *  Restored AXP_21264_Ibox_SetExecMode, and added AXP_21264_Ibox_ExecModeCheck,
+ *  which requests a change in the execution mode once the configured number
+ *  of instructions have been retired.  A requested change stops the execution
+ *  of the fetched instructions at the next instruction boundary.
+ */
+#include "CommonUtilities/AXP_Configure.h"
+#include "CommonUtilities/AXP_Dumps.h"
+#include "CPU/Ibox/AXP_21264_Ibox.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Functional.h"
+#include "CPU/Ibox/AXP_21264_Ibox_InstructionDecoding.h"
+#include "CPU/Ibox/AXP_21264_Ibox_PCHandling.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Translate.h"
+#include "CPU/Mbox/AXP_21264_Mbox.h"
+#include "CommonUtilities/AXP_Trace.h"
+
+/*
+ * AXP_21264_Ibox_FunctionalRegs
+ *  This function is called to map the architectural registers of a decoded
+ *  instruction to the physical registers currently assigned to them, and to
+ *  load the source values into the instruction.  No renaming is performed, so
+ *  the destination is the physical register currently mapped to the
+ *  architectural one.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  instr:
+ *      A pointer to the decoded instruction.
+ *
+ * Output Parameters:
+ *  instr:
+ *      The src1, src2, and dest fields are set to the physical registers, and
+ *      the src1v and src2v fields to the values of the source registers.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_21264_Ibox_FunctionalRegs(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
+{
+    bool src1Float = ((instr->decodedReg.bits.src1 & AXP_REG_FP) == AXP_REG_FP);
+    bool src2Float = ((instr->decodedReg.bits.src2 & AXP_REG_FP) == AXP_REG_FP);
+    bool destFloat = ((instr->decodedReg.bits.dest & AXP_REG_FP) == AXP_REG_FP);
+
+    if (src1Float == true)
+    {
+        instr->src1 = cpu->pfMap[instr->aSrc1];
+        instr->src1v.fp.uq = cpu->pf[instr->src1].value;
+    }
+    else
+    {
+        instr->src1 = cpu->prMap[instr->aSrc1];
+        instr->src1v.r.uq = cpu->pr[instr->src1].value;
+    }
+    if (src2Float == true)
+    {
+        instr->src2 = cpu->pfMap[instr->aSrc2];
+        instr->src2v.fp.uq = cpu->pf[instr->src2].value;
+    }
+    else
+    {
+        instr->src2 = cpu->prMap[instr->aSrc2];
+        instr->src2v.r.uq = cpu->pr[instr->src2].value;
+    }
+    instr->dest = destFloat ?
+                    cpu->pfMap[instr->aDest] :
+                    cpu->prMap[instr->aDest];
+    instr->destv.r.uq = 0;
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Ibox_FunctionalRetire
+ *  This function is called to retire an instruction that has just completed
+ *  execution in functional mode.  This is the in-order equivalent of
+ *  AXP_21264_Ibox_Retire, except that there are no branch predictions to
+ *  verify and no renamed registers to free.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  instr:
+ *      A pointer to the instruction to be retired.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The next instruction is not the one following this one in the
+ *          fetched line (branch taken, exception, or stall).
+ *  false:  Continue with the next instruction.
+ */
+bool AXP_21264_Ibox_FunctionalRetire(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
+{
+    bool destFloat = ((instr->decodedReg.bits.dest & AXP_REG_FP) == AXP_REG_FP);
+    bool updateDest = false;
+    bool retVal = instr->stall;
+
+    /*
+     * A load gives back its LQ entry.  Nothing else is in-flight, so there is
+     * never an older store to make it read stale data.
+     */
+    switch (instr->opcode)
+    {
+        case LDBU:
+        case LDQ_U:
+        case LDW_U:
+        case HW_LD:
+        case LDF:
+        case LDG:
+        case LDS:
+        case LDT:
+        case LDL:
+        case LDQ:
+        case LDL_L:
+        case LDQ_L:
+            (void) AXP_21264_Mbox_RetireRead(cpu, instr->slot);
+            break;
+
+        default:
+            break;
+    }
+
+    /*
+     * If an exception occurred, let the Ibox know about it.  The main loop
+     * will pick up the PALcode entry point as the next PC.
+     */
+    if (instr->excRegMask != NoException)
+    {
+        u32 fault = AXP_ARITH;
+
+        if (instr->excRegMask == FloatingDisabledFault)
+        {
+            fault = AXP_FEN;
+        }
+        AXP_21264_Ibox_Event(cpu,
+                             fault,
+                             instr->pc,
+                             0,
+                             instr->opcode,
+                             0,
+                             false,
+                             true);
+        retVal = true;
+    }
+    else
+    {
+
+        /*
+         * Get the IPR value, so that it can be moved into the destination
+         * register below.
+         */
+        if (instr->opcode == HW_MFPR)
+        {
+            AXP_21264_Ibox_Retire_HW_MFPR(cpu, instr);
+        }
+
+        /*
+         * For a branch, the destination register is only updated when the
+         * branch is taken.  If it is, then the branched to PC is the next one
+         * to be fetched.
+         */
+        if (instr->type == Branch)
+        {
+            if (AXP_GET_PC(instr->branchPC) != 0)
+            {
+                updateDest = instr->decodedReg.bits.dest != 0;
+                AXP_21264_AddVPC(cpu, instr->branchPC);
+                retVal = true;
+            }
+        }
+        else
+        {
+            updateDest = instr->decodedReg.bits.dest != 0;
+        }
+
+        /*
+         * There was no renaming, so the value goes straight into the physical
+         * register currently mapped to the architectural one.
+         */
+        if ((updateDest == true) && (instr->aDest != AXP_UNMAPPED_REG))
+        {
+            if (destFloat == true)
+            {
+                cpu->pf[instr->dest].value = instr->destv.fp.uq;
+                cpu->pf[instr->dest].state = Valid;
+            }
+            else
+            {
+                cpu->pr[instr->dest].value = instr->destv.r.uq;
+                cpu->pr[instr->dest].state = Valid;
+            }
+        }
+
+        /*
+         * If a store, write it to the Dcache.
+         */
+        switch (instr->opcode)
+        {
+            case STW:
+            case STB:
+            case STQ_U:
+            case HW_ST:
+            case STF:
+            case STG:
+            case STS:
+            case STT:
+            case STL:
+            case STQ:
+            case STL_C:
+            case STQ_C:
+                AXP_21264_Mbox_RetireWrite(cpu, instr->slot);
+                break;
+
+            case HW_MTPR:
+                AXP_21264_Ibox_Retire_HW_MTPR(cpu, instr);
+                break;
+
+            case HW_RET:
+
+                /*
+                 * If this is a HW_RET/STALL and a write to the IC_FLUSH Pseudo
+                 * register was previously made, then we now need to flush the
+                 * Icache.
+                 */
+                if ((instr->type_hint_index == AXP_HW_RET) &&
+                    (instr->stall == true) &&
+                    (cpu->iCacheFlushPending == true))
+                {
+                    AXP_IcacheFlush(cpu, false);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+    instr->state = Retired;
+    AXP_COUNT(cpu, AXP_CNT_RETIRED);
+
+    if (AXP_IBOX_INST)
+    {
+        char insBuf[256];
+        char regBuf[128];
+
+        AXP_Decode_Instruction(&instr->pc, instr->instr, false, insBuf);
+        AXP_Dump_Registers(instr, cpu->pr, cpu->pf, regBuf);
+        AXP_TRACE_BEGIN();
+        AXP_TraceWrite("%s : %s", insBuf, regBuf);
+        AXP_TRACE_END();
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Ibox_Functional
+ *  This function is called by the Ibox main loop, when the CPU is in
+ *  functional mode, to execute the instructions just fetched from the Icache.
+ *  Each instruction is decoded, executed, and retired before the next one is
+ *  decoded.  We stop at the end of the fetched instructions, or when the flow
+ *  of control does not continue with the next instruction in the line.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  next:
+ *      A pointer to the instructions fetched from the Icache.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ *
+ * NOTE:    This is called with the Ibox mutex locked.  It is unlocked while the
+ *          instruction is being executed, because the instruction may need to
+ *          signal an event to the Ibox, or queue a request to the Mbox (which
+ *          may itself signal an event to the Ibox).
+ */
+void AXP_21264_Ibox_Functional(AXP_21264_CPU *cpu, AXP_INS_LINE *next)
+{
+    AXP_INSTRUCTION *instr;
+    AXP_PIPELINE pipeline;
+    AXP_PC nextPC;
+    u32 ii;
+    bool fpEnable;
+    bool done = false;
+
+    if (AXP_IBOX_CALL)
+    {
+        AXP_TRACE_BEGIN();
+        AXP_TraceWrite("AXP_21264_Ibox_Functional called for pc: 0x%016llx",
+                       AXP_GET_PC(next->instrPC[0]));
+        AXP_TRACE_END();
+    }
+
+    /*
+     * If these instructions have already been translated, then execute the
+     * translated block(s) instead.
+     */
+    if (AXP_21264_Xlate_Execute(cpu, next->instrPC[0]) == true)
+    {
+        return;
+    }
+
+    /*
+     * Nothing is ever in-flight in functional mode, so the ROB entry at the
+     * end of the ROB is available to hold the instruction being executed.
+     */
+    instr = &cpu->rob[cpu->robEnd];
+
+    for (ii = 0; ((ii < next->instrCount) && (done == false)); ii++)
+    {
+
+        /*
+         * Decode the instruction and get the values for its source registers.
+         */
+        AXP_Decode(cpu, next, ii, instr, &pipeline);
+        AXP_21264_Ibox_FunctionalRegs(cpu, instr);
+
+        /*
+         * The next PC is the one after this instruction, unless this
+         * instruction changes it.  We do this now, because CALL_PAL uses the
+         * next PC as its return address.
+         */
+        nextPC = instr->pc;
+        nextPC.pc++;
+        AXP_21264_AddVPC(cpu, nextPC);
+
+        /*
+         * If this is one of the potential NOOP instructions, then the
+         * instruction is already completed.
+         */
+        if (next->predecoded[ii].noop == true)
+        {
+            instr->state = WaitingRetirement;
+        }
+        else
+        {
+
+            /*
+             * If we have a load/store, we need to request an entry in either
+             * the LQ or SQ in the Mbox.
+             */
+            switch (next->predecoded[ii].slot)
+            {
+                case AXP_PREDECODE_LQ_SLOT:
+                    instr->slot = AXP_21264_Mbox_GetLQSlot(cpu, instr);
+                    break;
+
+                case AXP_PREDECODE_SQ_SLOT:
+                    instr->slot = AXP_21264_Mbox_GetSQSlot(cpu, instr);
+                    break;
+
+                default:
+                    break;
+            }
+
+            /*
+             * Floating-point instructions can only be executed when they are
+             * enabled.
+             */
+            if ((pipeline == FboxMul) || (pipeline == FboxOther))
+            {
+                pthread_mutex_lock(&cpu->iBoxIPRMutex);
+                fpEnable = cpu->pCtx.fpe == 1;
+                pthread_mutex_unlock(&cpu->iBoxIPRMutex);
+            }
+            else
+            {
+                fpEnable = true;
+            }
+
+            /*
+             * Execute the instruction.  If it completes later (through the
+             * Mbox), the completion routine will signal us.
+             */
+            instr->state = Executing;
+            if (fpEnable == true)
+            {
+                pthread_mutex_unlock(&cpu->iBoxMutex);
+                AXP_Dispatcher(cpu, instr);
+                pthread_mutex_lock(&cpu->iBoxMutex);
+            }
+            else
+            {
+                instr->excRegMask = FloatingDisabledFault;
+                instr->state = WaitingRetirement;
+            }
+            while ((instr->state != WaitingRetirement) &&
+                   (cpu->excPend == false) &&
+                   (cpu->cpuState == Run))
+            {
+                pthread_cond_wait(&cpu->iBoxCondition, &cpu->iBoxMutex);
+            }
+        }
+
+        /*
+         * If the instruction completed, then retire it.  Otherwise, an event
+         * occurred while it was executing (such as a DTB miss) and it will be
+         * executed again after the PALcode has handled the event.  Give its LQ
+         * or SQ entry back, so the Mbox does not try to complete it later.
+         */
+        if (instr->state == WaitingRetirement)
+        {
+            done = AXP_21264_Ibox_FunctionalRetire(cpu, instr);
+            if (cpu->xlateRec != NULL)
+            {
+                AXP_21264_Xlate_Record(cpu, instr, &next->predecoded[ii]);
+            }
+
+            /*
+             * A request to change the execution mode is honored at the next
+             * instruction boundary.
+             */
+            if (AXP_21264_Ibox_ExecModeCheck(cpu) == true)
+            {
+                done = true;
+            }
+        }
+        else
+        {
+            pthread_mutex_unlock(&cpu->iBoxMutex);
+            pthread_mutex_lock(&cpu->mBoxMutex);
+            switch (next->predecoded[ii].slot)
+            {
+                case AXP_PREDECODE_LQ_SLOT:
+                    AXP_21264_Mbox_PutLQSlot(cpu, instr->slot);
+                    break;
+
+                case AXP_PREDECODE_SQ_SLOT:
+                    AXP_21264_Mbox_PutSQSlot(cpu, instr->slot);
+                    break;
+
+                default:
+                    break;
+            }
+            pthread_mutex_unlock(&cpu->mBoxMutex);
+            pthread_mutex_lock(&cpu->iBoxMutex);
+            instr->state = Aborted;
+            done = true;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Ibox_ExecModeCheck
+ *  This function is called to determine if a change in the execution mode has
+ *  been requested.  If the CPU has retired the number of instructions at
+ *  which it is to switch to the other mode, then the change is requested now.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   A change in the execution mode has been requested.
+ *  false:  Continue in the current execution mode.
+ *
+ * NOTE:    This is called with the Ibox mutex locked.
+ */
+bool AXP_21264_Ibox_ExecModeCheck(AXP_21264_CPU *cpu)
+{
+    if ((cpu->execModeSwitch != 0) &&
+        (__atomic_load_n(&cpu->counters.value[AXP_CNT_RETIRED],
+                         __ATOMIC_RELAXED) >= cpu->execModeSwitch))
+    {
+        cpu->execModeSwitch = 0;
+        cpu->execModeReq =
+            (cpu->execMode == FunctionalMode) ? DetailedMode : FunctionalMode;
+        cpu->execModeChange = true;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (cpu->execModeChange);
+}
+
+/*
+ * AXP_21264_Ibox_SetExecMode
+ *  This function is called to request that the CPU change its execution mode.
+ *  The change takes place once the Ibox has retired all the instructions
+ *  currently in-flight.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  mode:
+ *      A value indicating the execution mode to be changed to.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ *
+ * NOTE:    This function must not be called from the Ibox thread, as it locks
+ *          the Ibox mutex.
+ */
+void AXP_21264_Ibox_SetExecMode(AXP_21264_CPU *cpu, AXP_21264_EXEC_MODE mode)
+{
+    pthread_mutex_lock(&cpu->iBoxMutex);
+    cpu->execModeReq = mode;
+    cpu->execModeChange = mode != cpu->execMode;
+    if (cpu->execModeChange == true)
+    {
+        pthread_cond_signal(&cpu->iBoxCondition);
+    }
+    pthread_mutex_unlock(&cpu->iBoxMutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
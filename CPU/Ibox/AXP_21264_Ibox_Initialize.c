@@ -31,6 +31,21 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.002 15-Oct-2026 Jonathan D. Belanger
+ *  Initialize the Icache block sequence numbers and contention counters.
+ *
+ *  V01.003 15-Oct-2026 Jonathan D. Belanger
+ *  Initialize the retirement statistics.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  The branch prediction tables are now in a single structure, which is
+ *  cleared all at once.  Only the first 1K of the 4K choice predictor counters
+ *  had been cleared.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Initialize the return stack, which is now circular, and the jump target
+ *  cache.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ibox/AXP_21264_Ibox.h"
@@ -186,22 +201,13 @@ bool AXP_21264_Ibox_Init(AXP_21264_CPU *cpu)
     /*
      * Initialize the branch prediction information.
      */
-    for (ii = 0; ii < ONE_K; ii++)
-    {
-        cpu->localHistoryTable.lcl_history[ii].cnt = 0;
-        cpu->localPredictor.lcl_pred[ii].cnt = 0;
-        cpu->choicePredictor.choice_pred[ii].cnt = 0;
-    }
-    for (ii = 0; ii < FOUR_K; ii++)
-    {
-        cpu->globalPredictor.gbl_pred[ii].cnt = 0;
-    }
-    cpu->globalPathHistory = 0;
-    for (ii = 0; ii < AXP_INFLIGHT_MAX; ii++)
+    memset(&cpu->branchPredictor, 0, sizeof(cpu->branchPredictor));
+    for (ii = 0; ii < AXP_RET_STACK_SIZE; ii++)
     {
         AXP_PUT_PC(cpu->predictionStack[ii], 0);
     }
-    cpu->predStackIdx = AXP_INFLIGHT_MAX;
+    cpu->predStackIdx = 0;
+    memset(&cpu->jumpCache, 0, sizeof(cpu->jumpCache));
 
     /*
      * Initialize the Ibox IPRs.
@@ -338,6 +344,8 @@ bool AXP_21264_Ibox_Init(AXP_21264_CPU *cpu)
     /*
      * Initialize the instruction cache.
      */
+    cpu->iCacheReadRetries = 0;
+    cpu->iCacheWriteWaits = 0;
     for (ii = 0; ii < AXP_CACHE_ENTRIES; ii++)
     {
         for (jj = 0; jj < AXP_2_WAY_CACHE; jj++)
@@ -353,10 +361,14 @@ bool AXP_21264_Ibox_Init(AXP_21264_CPU *cpu)
             cpu->iCache[ii][jj].tag = 0;
             cpu->iCache[ii][jj].set_0_1 = 0;
             cpu->iCache[ii][jj].res_1 = 0;
+            cpu->iCache[ii][jj].seq = 0;
             for (kk = 0; kk < AXP_ICACHE_LINE_INS; kk++)
             {
                 cpu->iCache[ii][jj].instructions[kk].instr = 0;
             }
+            memset(cpu->iCache[ii][jj].predecoded,
+                   0,
+                   sizeof(cpu->iCache[ii][jj].predecoded));
         }
     }
 
@@ -385,13 +397,18 @@ bool AXP_21264_Ibox_Init(AXP_21264_CPU *cpu)
         cpu->itb[ii].asn = 0;
         cpu->itb[ii]._asm = false;
         cpu->itb[ii].valid = false;
+        cpu->itb[ii].gh = 0;
     }
+    memset(&cpu->itbHash, 0, sizeof(AXP_21264_TLB_HASH));
+    memset(cpu->itbMicro, 0, sizeof(cpu->itbMicro));
+    cpu->itbMicroGen = 0;
 
     /*
      * Initialize the ReOrder Buffer (ROB).
      */
     cpu->robStart = 0;
     cpu->robEnd = 0;
+    memset(&cpu->retireStats, 0, sizeof(AXP_RETIRE_STATS));
     for (ii = 0; ii < AXP_INFLIGHT_MAX; ii++)
     {
         cpu->rob[ii].state = Retired;
@@ -36,10 +36,40 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.003 15-Oct-2026 Jonathan D. Belanger
+ *  Split the instruction decoding into AXP_Predecode, which determines all
+ *  the information that can be gotten from the instruction bits alone and is
+ *  called once per Icache fill, and AXP_Decode_Rename, which now only copies
+ *  the predecoded information and then maps and renames the registers.
+ *
+ *  V01.004 15-Oct-2026 Jonathan D. Belanger
+ *  Split AXP_Decode out of AXP_Decode_Rename, so that the functional
+ *  execution mode can decode an instruction without renaming its registers.
+ *
+ *  V01.005 15-Oct-2026 Jonathan D. Belanger
+ *  Wake the Ebox and Fbox pipelines after aborting instructions, so that the
+ *  aborted IQ/FQ entries are released right away.
+ *
+ *  V01.006 15-Oct-2026 Jonathan D. Belanger
+ *  When a physical register is marked Valid, hand the IQ/FQ entries waiting
+ *  on it to the pipelines.  After aborting instructions, only hand over the
+ *  aborted entries still waiting on a register, rather than waking all the
+ *  pipelines.
+ *
+ *  V01.007 16-Oct-2026 Jonathan D. Belanger
+ *  Count the calls to abort instructions, and the instructions aborted, in
+ *  the performance counters.
+ *
+ *  V01.008 16-Oct-2026 Jonathan D. Belanger
+ *  Aborted loads and stores that are not in the hands of the Mbox give back
+ *  their LQ or SQ entries.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ibox/AXP_21264_Ibox.h"
 #include "CPU/Ibox/AXP_21264_Ibox_InstructionDecoding.h"
+#include "CPU/Mbox/AXP_21264_Mbox.h"
+#include "CommonUtilities/AXP_Execute_Box.h"
 #include "CommonUtilities/AXP_Trace.h"
 
 /*
@@ -81,115 +111,93 @@ regDecodeFunc decodeFuncs[] =
 static char *regStateStr[] = {"Free", "Pending Update", "Valid"};
 
 /*
- * AXP_Decode_Rename
- *   This function is called to take a set of 4 instructions and decode them
- *   and then rename the architectural registers to physical ones.  The results
- *   are put onto either the Integer Queue or Floating-point Queue (FQ) for
- *   execution.
+ * AXP_Predecode
+ *   This function is called to decode everything that can be determined from
+ *   the instruction bits alone.  This is called when an instruction is fetched
+ *   from the Icache and has not already been predecoded since the Icache block
+ *   was filled.  The results are saved with the Icache block, so that the next
+ *   time the instruction is fetched, only the register renaming needs to be
+ *   performed.
  *
  * Input Parameters:
- *   cpu:
- *      A pointer to the structure containing all the fields needed to
- *      emulate an Alpha AXP 21264 CPU.
- *  next:
- *      A pointer to a location to receive the next 4 instructions to be
- *      processed.
- *  nextInstr:
- *      A value indicating which of the 4 instructions is to be processed.
+ *  instr:
+ *      A value containing the instruction to be predecoded.
  *
  * Output Parameters:
- *   decodedInsr:
- *       A pointer to the decoded version of the instruction.
- *   pipeline:
- *       A pointer to a location to receive the pipelines this instruction is
- *       allowed to execute.
+ *   predecoded:
+ *       A pointer to the location to receive the predecoded version of the
+ *       instruction.
  *
  * Return value:
  *   None.
  */
-void AXP_Decode_Rename(AXP_21264_CPU *cpu,
-                       AXP_INS_LINE *next,
-                       int nextInstr,
-                       AXP_INSTRUCTION *decodedInstr,
-                       AXP_PIPELINE *pipeline)
+void AXP_Predecode(AXP_INS_FMT instr, AXP_ICACHE_PREDECODE *predecoded)
 {
-    bool callingPAL = false;
-    bool src1Float = false;
-    bool src2Float = false;
-    bool destFloat = false;
     u32 function;
+    u16 whichQueue;
 
-    /*
-     * Decode the next instruction.
-     *
-     * First, Assign a unique ID to this instruction (the counter should
-     * auto-wrap) and initialize some of the other fields within the decoded
-     * instruction.
-     */
-    decodedInstr->uniqueID = cpu->instrCounter++;
-    decodedInstr->excRegMask = NoException;
+    memset(predecoded, 0, sizeof(AXP_ICACHE_PREDECODE));
 
     /*
      * Let's, decode the instruction.
      */
-    decodedInstr->instr.instr = next->instructions[nextInstr].instr;
-    decodedInstr->format = next->instrType[nextInstr];
-    decodedInstr->opcode = next->instructions[nextInstr].pal.opcode;
-    decodedInstr->stall = false;
-    switch (decodedInstr->format)
+    predecoded->instr.instr = instr.instr;
+    predecoded->format = AXP_InstructionFormat(instr);
+    predecoded->opcode = instr.pal.opcode;
+    switch (predecoded->format)
     {
         case Bra:
         case FPBra:
-            decodedInstr->displacement = next->instructions[nextInstr].br.branch_disp;
+            predecoded->displacement = instr.br.branch_disp;
             break;
 
         case FP:
-            decodedInstr->function = next->instructions[nextInstr].fp.func;
+            predecoded->function = instr.fp.func;
             break;
 
         case Mem:
         case Mbr:
-            decodedInstr->displacement = next->instructions[nextInstr].mem.mem.disp;
-            decodedInstr->stall = ((decodedInstr->opcode == STL_C)||
-                                   (decodedInstr->opcode == STQ_C));
+            predecoded->displacement = instr.mem.mem.disp;
+            predecoded->stall = ((predecoded->opcode == STL_C)||
+                                 (predecoded->opcode == STQ_C));
             break;
 
         case Mfc:
-            decodedInstr->function = next->instructions[nextInstr].mem.mem.func;
-            decodedInstr->stall = ((decodedInstr->opcode == MISC) &&
-                                   (decodedInstr->function == AXP_FUNC_MB));
+            predecoded->function = instr.mem.mem.func;
+            predecoded->stall = ((predecoded->opcode == MISC) &&
+                                 (predecoded->function == AXP_FUNC_MB));
             break;
 
         case Opr:
-            decodedInstr->function = next->instructions[nextInstr].oper1.func;
-            decodedInstr->useLiteral = next->instructions[nextInstr].oper1.fmt == 1;
+            predecoded->function = instr.oper1.func;
+            predecoded->useLiteral = instr.oper1.fmt == 1;
             break;
 
         case Pcd:
-            decodedInstr->function = next->instructions[nextInstr].pal.palcode_func;
-            callingPAL = true;
+            predecoded->function = instr.pal.palcode_func;
+            predecoded->callingPAL = true;
             break;
 
         case PAL:
-            switch (decodedInstr->opcode)
+            switch (predecoded->opcode)
             {
                 case HW_LD:
                 case HW_ST:
-                    decodedInstr->displacement = next->instructions[nextInstr].hw_ld.disp;
-                    decodedInstr->type_hint_index = next->instructions[nextInstr].hw_ld.type;
-                    decodedInstr->quadword = (next->instructions[nextInstr].hw_ld.len == 1);
+                    predecoded->displacement = instr.hw_ld.disp;
+                    predecoded->type_hint_index = instr.hw_ld.type;
+                    predecoded->quadword = (instr.hw_ld.len == 1);
                     break;
 
                 case HW_RET:
-                    decodedInstr->displacement = next->instructions[nextInstr].hw_ret.disp;
-                    decodedInstr->type_hint_index = next->instructions[nextInstr].hw_ret.hint;
-                    decodedInstr->stall = (next->instructions[nextInstr].hw_ret.stall == 1);
+                    predecoded->displacement = instr.hw_ret.disp;
+                    predecoded->type_hint_index = instr.hw_ret.hint;
+                    predecoded->stall = (instr.hw_ret.stall == 1);
                     break;
 
                 case HW_MFPR:
                 case HW_MTPR:
-                    decodedInstr->type_hint_index = next->instructions[nextInstr].hw_mxpr.index;
-                    decodedInstr->scbdMask = next->instructions[nextInstr].hw_mxpr.scbd_mask;
+                    predecoded->type_hint_index = instr.hw_mxpr.index;
+                    predecoded->scbdMask = instr.hw_mxpr.scbd_mask;
                     break;
 
                 default:
@@ -200,170 +208,362 @@ void AXP_Decode_Rename(AXP_21264_CPU *cpu,
         default:
             break;
     }
-    decodedInstr->type = AXP_OperationType(decodedInstr->opcode);
-    if ((decodedInstr->type == Other) && (decodedInstr->format != Res))
+    predecoded->type = AXP_OperationType(predecoded->opcode);
+    if ((predecoded->type == Other) && (predecoded->format != Res))
     {
-        decodedInstr->type = AXP_DecodeOperType(decodedInstr->opcode,
-                                                decodedInstr->function);
+        predecoded->type = AXP_DecodeOperType(predecoded->opcode,
+                                              predecoded->function);
     }
-    decodedInstr->decodedReg = AXP_RegisterDecoding(decodedInstr->opcode);
-    if (decodedInstr->decodedReg.bits.opcodeRegDecode != 0)
+    predecoded->decodedReg = AXP_RegisterDecoding(predecoded->opcode);
+    if (predecoded->decodedReg.bits.opcodeRegDecode != 0)
     {
-        decodedInstr->decodedReg.raw =
-            decodeFuncs[decodedInstr->decodedReg.bits.opcodeRegDecode](next->instructions[nextInstr]);
+        predecoded->decodedReg.raw =
+            decodeFuncs[predecoded->decodedReg.bits.opcodeRegDecode](instr);
     }
-    if ((decodedInstr->opcode == HW_MFPR) || (decodedInstr->opcode == HW_MFPR))
+    if ((predecoded->opcode == HW_MFPR) || (predecoded->opcode == HW_MFPR))
     {
-        function = decodedInstr->type_hint_index;
+        function = predecoded->type_hint_index;
     }
     else
     {
-        function = decodedInstr->function;
+        function = predecoded->function;
     }
-    *pipeline = AXP_InstructionPipeline(decodedInstr->opcode, function);
+    predecoded->pipeline = AXP_InstructionPipeline(predecoded->opcode,
+                                                   function);
 
     /*
      * Decode destination register
+     *
+     * NOTE:    The linkage register for a CALL_PAL depends upon the setting of
+     *          call_pal_r23 in the I_CTL IPR, so it is determined in
+     *          AXP_Decode_Rename.
      */
-    switch (decodedInstr->decodedReg.bits.dest)
+    switch (predecoded->decodedReg.bits.dest)
     {
         case AXP_REG_RA:
-            decodedInstr->aDest = next->instructions[nextInstr].oper1.ra;
+            predecoded->aDest = instr.oper1.ra;
             break;
 
         case AXP_REG_RB:
-            decodedInstr->aDest = next->instructions[nextInstr].oper1.rb;
+            predecoded->aDest = instr.oper1.rb;
             break;
 
         case AXP_REG_RC:
-            decodedInstr->aDest = next->instructions[nextInstr].oper1.rc;
+            predecoded->aDest = instr.oper1.rc;
             break;
 
         case AXP_REG_FA:
-            decodedInstr->aDest = next->instructions[nextInstr].fp.fa;
-            destFloat = true;
+            predecoded->aDest = instr.fp.fa;
+            predecoded->destFloat = true;
             break;
 
         case AXP_REG_FB:
-            decodedInstr->aDest = next->instructions[nextInstr].fp.fb;
-            destFloat = true;
+            predecoded->aDest = instr.fp.fb;
+            predecoded->destFloat = true;
             break;
 
         case AXP_REG_FC:
-            decodedInstr->aDest = next->instructions[nextInstr].fp.fc;
-            destFloat = true;
+            predecoded->aDest = instr.fp.fc;
+            predecoded->destFloat = true;
             break;
 
         default:
-
-            /*
-             *  If the instruction being decoded is a CALL_PAL, then there is a
-             *  linkage register (basically a return address after the CALL_PAL
-             *  has completed).  For Jumps, the is usually specified in the
-             *  register fields of the instruction.  For CALL_PAL, this is
-             *  either R23 or R27, depending upon the setting of the
-             *  call_pal_r23 in the I_CTL IPR.
-             */
-          if (decodedInstr->opcode == PAL00)
-          {
-              if (cpu->iCtl.call_pal_r23 == 1)
-              {
-                  decodedInstr->aDest = 23;
-              }
-              else
-              {
-                  decodedInstr->aDest = 27;
-              }
-          }
-          else
-          {
-              decodedInstr->aDest = AXP_UNMAPPED_REG;
-          }
-          break;
+            predecoded->aDest = AXP_UNMAPPED_REG;
+            break;
     }
 
     /*
      * Decode source1 register
      */
-    switch (decodedInstr->decodedReg.bits.src1)
+    switch (predecoded->decodedReg.bits.src1)
     {
         case AXP_REG_RA:
-            decodedInstr->aSrc1 = next->instructions[nextInstr].oper1.ra;
+            predecoded->aSrc1 = instr.oper1.ra;
             break;
 
         case AXP_REG_RB:
-            decodedInstr->aSrc1 = next->instructions[nextInstr].oper1.rb;
+            predecoded->aSrc1 = instr.oper1.rb;
             break;
 
         case AXP_REG_RC:
-            decodedInstr->aSrc1 = next->instructions[nextInstr].oper1.rc;
+            predecoded->aSrc1 = instr.oper1.rc;
             break;
 
         case AXP_REG_FA:
-            decodedInstr->aSrc1 = next->instructions[nextInstr].fp.fa;
-            src1Float = true;
+            predecoded->aSrc1 = instr.fp.fa;
+            predecoded->src1Float = true;
             break;
 
         case AXP_REG_FB:
-            decodedInstr->aSrc1 = next->instructions[nextInstr].fp.fb;
-            src1Float = true;
+            predecoded->aSrc1 = instr.fp.fb;
+            predecoded->src1Float = true;
             break;
 
         case AXP_REG_FC:
-            decodedInstr->aSrc1 = next->instructions[nextInstr].fp.fc;
-            src1Float = true;
+            predecoded->aSrc1 = instr.fp.fc;
+            predecoded->src1Float = true;
             break;
 
         default:
-            decodedInstr->aSrc1 = AXP_UNMAPPED_REG;
+            predecoded->aSrc1 = AXP_UNMAPPED_REG;
             break;
     }
 
     /*
      * Decode source2 register
      */
-    switch (decodedInstr->decodedReg.bits.src2)
+    switch (predecoded->decodedReg.bits.src2)
     {
         case AXP_REG_RA:
-            decodedInstr->aSrc2 = next->instructions[nextInstr].oper1.ra;
+            predecoded->aSrc2 = instr.oper1.ra;
             break;
 
         case AXP_REG_RB:
-            if (decodedInstr->useLiteral == true)
+            if (predecoded->useLiteral == true)
             {
-                decodedInstr->literal = next->instructions[nextInstr].oper2.lit;
-                decodedInstr->aSrc2 = AXP_UNMAPPED_REG;
+                predecoded->literal = instr.oper2.lit;
+                predecoded->aSrc2 = AXP_UNMAPPED_REG;
             }
             else
             {
-              decodedInstr->aSrc2 = next->instructions[nextInstr].oper1.rb;
+              predecoded->aSrc2 = instr.oper1.rb;
             }
             break;
 
         case AXP_REG_RC:
-            decodedInstr->aSrc2 = next->instructions[nextInstr].oper1.rc;
+            predecoded->aSrc2 = instr.oper1.rc;
             break;
 
         case AXP_REG_FA:
-            decodedInstr->aSrc2 = next->instructions[nextInstr].fp.fa;
-            src2Float = true;
+            predecoded->aSrc2 = instr.fp.fa;
+            predecoded->src2Float = true;
             break;
 
         case AXP_REG_FB:
-            decodedInstr->aSrc2 = next->instructions[nextInstr].fp.fb;
-            src2Float = true;
+            predecoded->aSrc2 = instr.fp.fb;
+            predecoded->src2Float = true;
             break;
 
         case AXP_REG_FC:
-            decodedInstr->aSrc2 = next->instructions[nextInstr].fp.fc;
-            src2Float = true;
+            predecoded->aSrc2 = instr.fp.fc;
+            predecoded->src2Float = true;
+            break;
+
+        default:
+            predecoded->aSrc2 = AXP_UNMAPPED_REG;
+            break;
+    }
+
+    /*
+     * If this is one of the potential NOOP instructions, then the instruction
+     * is already completed when it is decoded and does not need to be queued
+     * up.
+     */
+    predecoded->noop = (predecoded->pipeline == PipelineNone);
+    if (predecoded->aDest == AXP_UNMAPPED_REG)
+    {
+        switch (predecoded->opcode)
+        {
+            case INTA:
+            case INTL:
+            case INTM:
+            case INTS:
+            case LDQ_U:
+            case ITFP:
+                predecoded->noop = true;
+                break;
+
+            case FLTI:
+            case FLTL:
+            case FLTV:
+                if (predecoded->function != AXP_FUNC_MT_FPCR)
+                {
+                    predecoded->noop = true;
+                }
+                break;
+        }
+    }
+
+    /*
+     * Loads and stores need to have an entry in either the LQ or SQ in the
+     * Mbox allocated before they can be queued up.
+     */
+    switch (predecoded->opcode)
+    {
+        case LDBU:
+        case LDQ_U:
+        case LDW_U:
+        case HW_LD:
+        case LDF:
+        case LDG:
+        case LDS:
+        case LDT:
+        case LDL:
+        case LDQ:
+        case LDL_L:
+        case LDQ_L:
+            predecoded->slot = AXP_PREDECODE_LQ_SLOT;
+            break;
+
+        case STW:
+        case STB:
+        case STQ_U:
+        case HW_ST:
+        case STF:
+        case STG:
+        case STS:
+        case STT:
+        case STL:
+        case STQ:
+        case STL_C:
+        case STQ_C:
+            predecoded->slot = AXP_PREDECODE_SQ_SLOT;
             break;
 
         default:
-            decodedInstr->aSrc2 = AXP_UNMAPPED_REG;
+            predecoded->slot = AXP_PREDECODE_NO_SLOT;
             break;
     }
 
+    /*
+     * Determine which queue, the IQ or FQ, the instruction will be executed
+     * from.  The ITFP and FPTI opcodes need the function code to decide.
+     */
+    whichQueue = AXP_InstructionQueue(predecoded->opcode);
+    if (whichQueue == AXP_COND)
+    {
+        if (predecoded->opcode == ITFP)
+        {
+            if ((predecoded->function == AXP_FUNC_ITOFS) ||
+                (predecoded->function == AXP_FUNC_ITOFF) ||
+                (predecoded->function == AXP_FUNC_ITOFT))
+            {
+                whichQueue = AXP_IQ;
+            }
+            else
+            {
+                whichQueue = AXP_FQ;
+            }
+        }
+        else /* FPTI */
+        {
+            if ((predecoded->function == AXP_FUNC_FTOIT) ||
+                (predecoded->function == AXP_FUNC_FTOIS))
+            {
+                whichQueue = AXP_FQ;
+            }
+            else
+            {
+                whichQueue = AXP_IQ;
+            }
+        }
+    }
+    predecoded->whichQueue = whichQueue;
+    predecoded->valid = true;
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_Decode
+ *   This function is called to take one of a set of 4 predecoded instructions
+ *   and complete the decoding, up to, but not including, renaming the
+ *   architectural registers to physical ones.
+ *
+ * Input Parameters:
+ *   cpu:
+ *      A pointer to the structure containing all the fields needed to
+ *      emulate an Alpha AXP 21264 CPU.
+ *  next:
+ *      A pointer to a location to receive the next 4 instructions to be
+ *      processed.
+ *  nextInstr:
+ *      A value indicating which of the 4 instructions is to be processed.
+ *
+ * Output Parameters:
+ *   decodedInsr:
+ *       A pointer to the decoded version of the instruction.
+ *   pipeline:
+ *       A pointer to a location to receive the pipelines this instruction is
+ *       allowed to execute.
+ *
+ * Return value:
+ *   None.
+ */
+void AXP_Decode(AXP_21264_CPU *cpu,
+                AXP_INS_LINE *next,
+                int nextInstr,
+                AXP_INSTRUCTION *decodedInstr,
+                AXP_PIPELINE *pipeline)
+{
+    AXP_ICACHE_PREDECODE *predecoded = &next->predecoded[nextInstr];
+    bool callingPAL;
+
+    /*
+     * This should never happen, as the Icache predecodes the instructions it
+     * returns, but just in case.
+     */
+    if ((predecoded->valid == false) ||
+        (predecoded->instr.instr != next->instructions[nextInstr].instr))
+    {
+        AXP_Predecode(next->instructions[nextInstr], predecoded);
+    }
+
+    /*
+     * Decode the next instruction.
+     *
+     * First, Assign a unique ID to this instruction (the counter should
+     * auto-wrap) and initialize some of the other fields within the decoded
+     * instruction.
+     */
+    decodedInstr->uniqueID = cpu->instrCounter++;
+    decodedInstr->excRegMask = NoException;
+
+    /*
+     * Everything that can be determined from the instruction bits alone was
+     * done when the instruction was predecoded, so just copy it.
+     */
+    decodedInstr->instr.instr = predecoded->instr.instr;
+    decodedInstr->format = predecoded->format;
+    decodedInstr->opcode = predecoded->opcode;
+    decodedInstr->type = predecoded->type;
+    decodedInstr->decodedReg = predecoded->decodedReg;
+    decodedInstr->displacement = predecoded->displacement;
+    decodedInstr->literal = predecoded->literal;
+    decodedInstr->function = predecoded->function;
+    decodedInstr->type_hint_index = predecoded->type_hint_index;
+    decodedInstr->scbdMask = predecoded->scbdMask;
+    decodedInstr->useLiteral = predecoded->useLiteral;
+    decodedInstr->stall = predecoded->stall;
+    decodedInstr->quadword = predecoded->quadword;
+    decodedInstr->aSrc1 = predecoded->aSrc1;
+    decodedInstr->aSrc2 = predecoded->aSrc2;
+    decodedInstr->aDest = predecoded->aDest;
+    *pipeline = predecoded->pipeline;
+
+    /*
+     *  If the instruction being decoded is a CALL_PAL, then there is a
+     *  linkage register (basically a return address after the CALL_PAL
+     *  has completed).  For Jumps, the is usually specified in the
+     *  register fields of the instruction.  For CALL_PAL, this is
+     *  either R23 or R27, depending upon the setting of the
+     *  call_pal_r23 in the I_CTL IPR.
+     */
+    if (decodedInstr->opcode == PAL00)
+    {
+        if (cpu->iCtl.call_pal_r23 == 1)
+        {
+            decodedInstr->aDest = 23;
+        }
+        else
+        {
+            decodedInstr->aDest = 27;
+        }
+    }
+
     /*
      * When running in PALmode, the shadow registers may come into play.  If we
      * are in PALmode, then the PALshadow registers may come into play.  If so,
@@ -374,20 +574,66 @@ void AXP_Decode_Rename(AXP_21264_CPU *cpu,
      * check.
      */
     decodedInstr->pc = next->instrPC[nextInstr];
-    callingPAL |= (decodedInstr->pc.pal == AXP_PAL_MODE);
-    if (src1Float == false)
+    callingPAL = predecoded->callingPAL ||
+                 (decodedInstr->pc.pal == AXP_PAL_MODE);
+    if (predecoded->src1Float == false)
     {
         decodedInstr->aSrc1 = AXP_REG(decodedInstr->aSrc1, callingPAL);
     }
-    if (src2Float == false)
+    if (predecoded->src2Float == false)
     {
         decodedInstr->aSrc2 = AXP_REG(decodedInstr->aSrc2, callingPAL);
     }
-    if (destFloat == false)
+    if (predecoded->destFloat == false)
     {
         decodedInstr->aDest = AXP_REG(decodedInstr->aDest, callingPAL);
     }
 
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_Decode_Rename
+ *   This function is called to take one of a set of 4 predecoded instructions
+ *   and complete the decoding and then rename the architectural registers to
+ *   physical ones.  The results are put onto either the Integer Queue or
+ *   Floating-point Queue (FQ) for execution.
+ *
+ * Input Parameters:
+ *   cpu:
+ *      A pointer to the structure containing all the fields needed to
+ *      emulate an Alpha AXP 21264 CPU.
+ *  next:
+ *      A pointer to a location to receive the next 4 instructions to be
+ *      processed.
+ *  nextInstr:
+ *      A value indicating which of the 4 instructions is to be processed.
+ *
+ * Output Parameters:
+ *   decodedInsr:
+ *       A pointer to the decoded version of the instruction.
+ *   pipeline:
+ *       A pointer to a location to receive the pipelines this instruction is
+ *       allowed to execute.
+ *
+ * Return value:
+ *   None.
+ */
+void AXP_Decode_Rename(AXP_21264_CPU *cpu,
+                       AXP_INS_LINE *next,
+                       int nextInstr,
+                       AXP_INSTRUCTION *decodedInstr,
+                       AXP_PIPELINE *pipeline)
+{
+
+    /*
+     * Decode the instruction.
+     */
+    AXP_Decode(cpu, next, nextInstr, decodedInstr, pipeline);
+
     /*
      * We need to rename the architectural registers to physical
      * registers, now that we know which one, if any, is the
@@ -1085,6 +1331,7 @@ u32 AXP_UpdateRegisters(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         destPhys[instr->dest].value =
             destFloat ? instr->destv.fp.uq : instr->destv.r.uq;
         destPhys[instr->dest].state = Valid;
+        AXP_Execution_RegReady(cpu, instr->dest, destFloat);
     }
     destPhys[instr->dest].refCount--;
 
@@ -1230,6 +1477,7 @@ bool AXP_AbortInstructions(AXP_21264_CPU *cpu, AXP_INSTRUCTION *inst)
     u16 *destFlEnd;
     u32 endIdx = cpu->robEnd;
     bool rollbackRegisterMap;
+    bool releaseSlot;
     bool retVal = false;
 
     if (AXP_IBOX_CALL)
@@ -1262,6 +1510,7 @@ bool AXP_AbortInstructions(AXP_21264_CPU *cpu, AXP_INSTRUCTION *inst)
            (AXP_GET_PC(rob->pc) != AXP_GET_PC(inst->pc)))
     {
         rollbackRegisterMap = false;
+        releaseSlot = false;
 
         switch (rob->state)
         {
@@ -1270,9 +1519,12 @@ bool AXP_AbortInstructions(AXP_21264_CPU *cpu, AXP_INSTRUCTION *inst)
              * If the entry is queued or executing, the Ebox or Fbox have it.
              * Setting the state to Aborted, indicates to them that the\
              * execution of this instruction needs to be aborted.  We need to
-             * rollback the register mapping.
+             * rollback the register mapping.  A queued instruction is never
+             * going to get to the Mbox, but an executing one may still.
              */
             case Queued:
+            releaseSlot = true;
+            /* Fall through */
             case Executing:
             rob->state = Aborted;
             rollbackRegisterMap = true;
@@ -1280,11 +1532,12 @@ bool AXP_AbortInstructions(AXP_21264_CPU *cpu, AXP_INSTRUCTION *inst)
 
             /*
              * If it is waiting for retirement is retired.  We need to rollback
-             * the register mapping.
+             * the register mapping.  The Mbox is done with it.
              */
             case WaitingRetirement:
             rob->state = Retired;
             rollbackRegisterMap = true;
+            releaseSlot = true;
             break;
 
             /*
@@ -1297,6 +1550,50 @@ bool AXP_AbortInstructions(AXP_21264_CPU *cpu, AXP_INSTRUCTION *inst)
             break;
         }
 
+        /*
+         * A load or store the Mbox is not going to do anything more with
+         * gives back its LQ or SQ entry.  One that is still executing gives
+         * its entry back when the Mbox has completed it.
+         */
+        if (releaseSlot == true)
+        {
+            switch (rob->opcode)
+            {
+                case LDBU:
+                case LDQ_U:
+                case LDW_U:
+                case HW_LD:
+                case LDF:
+                case LDG:
+                case LDS:
+                case LDT:
+                case LDL:
+                case LDQ:
+                case LDL_L:
+                case LDQ_L:
+                    AXP_21264_Mbox_PutLQSlot(cpu, rob->slot);
+                    break;
+
+                case STW:
+                case STB:
+                case STQ_U:
+                case HW_ST:
+                case STF:
+                case STG:
+                case STS:
+                case STT:
+                case STL:
+                case STQ:
+                case STL_C:
+                case STQ_C:
+                    AXP_21264_Mbox_PutSQSlot(cpu, rob->slot);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
         /*
          * This is kind of what we really came here for.  If we need to
          * rollback the mapping, then we need to make the physical registers
@@ -1306,6 +1603,7 @@ bool AXP_AbortInstructions(AXP_21264_CPU *cpu, AXP_INSTRUCTION *inst)
          */
         if (rollbackRegisterMap == true)
         {
+            AXP_COUNT(cpu, AXP_CNT_ABORTED);
             if (AXP_IBOX_OPT2)
             {
                 AXP_TRACE_BEGIN();
@@ -1423,6 +1721,9 @@ bool AXP_AbortInstructions(AXP_21264_CPU *cpu, AXP_INSTRUCTION *inst)
                 destPhys[rob->prevDestMap].value = rob->prevDestValue;
             }
             destPhys[rob->prevDestMap].state = Valid;
+            AXP_Execution_RegReady(cpu,
+                                   rob->prevDestMap,
+                                   destPhys == cpu->pf);
         }
 
         /*
@@ -1441,6 +1742,14 @@ bool AXP_AbortInstructions(AXP_21264_CPU *cpu, AXP_INSTRUCTION *inst)
     AXP_RegisterRename_IntegrityCheck(cpu);
 #endif
 
+    /*
+     * The aborted instructions are still holding IQ/FQ entries.  Those still
+     * waiting on a register will never be handed to the pipelines, so do it
+     * now, so that they can get rid of them.
+     */
+    AXP_Execution_Aborted(cpu);
+    AXP_COUNT(cpu, AXP_CNT_ABORTS);
+
     /*
      * Return the results of this processing back to the caller.
      */
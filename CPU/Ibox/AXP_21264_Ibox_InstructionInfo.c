@@ -31,11 +31,25 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  IEEE operate instructions with denormal, infinite, or NaN operands, or
+ *  when the FPCR maps denormals to zero, are performed with integer arithmetic
+ *  instead of by the host.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  BSR is a branch format instruction, so that its 21-bit displacement is
+ *  decoded, rather than a 16-bit memory one.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  IEEE operate instructions whose result is too small to be normalized are
+ *  performed again with integer arithmetic, as the host delivers a denormal.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ibox/AXP_21264_Ibox_InstructionInfo.h"
 #include "CPU/Ebox/AXP_21264_Ebox.h"
 #include "CPU/Fbox/AXP_21264_Fbox.h"
+#include "CPU/Fbox/AXP_21264_Fbox_FPFunctions.h"
 
 /*
  * The following module specific structure and variable contains a list of the
@@ -107,7 +121,7 @@ static struct instructDecode insDecode[] =
     {   FPBra,  Branch, {.raw = AXP_SRC1_FA},  AXP_FQ, FboxOther},                                  /* 31   FBEQ        Floating branch if = zero   */
     {   FPBra,  Branch, {.raw = AXP_SRC1_FA},  AXP_FQ, FboxOther},                                  /* 32   FBLT        Floating branch if < zero   */
     {   FPBra,  Branch, {.raw = AXP_SRC1_FA},  AXP_FQ, FboxOther},                                  /* 33   FBLE        Floating branch if <= zero  */
-    {   Mbr,    Branch, {.raw = AXP_DEST_RA},  AXP_IQ, EboxL0},                                     /* 34   BSR         Branch to subroutine        */
+    {   Bra,    Branch, {.raw = AXP_DEST_RA},  AXP_IQ, EboxL0},                                     /* 34   BSR         Branch to subroutine        */
     {   FPBra,  Branch, {.raw = AXP_SRC1_FA},  AXP_FQ, FboxOther},                                  /* 35   FBNE        Floating branch if != zero  */
     {   FPBra,  Branch, {.raw = AXP_SRC1_FA},  AXP_FQ, FboxOther},                                  /* 36   FBGE        Floating branch if >=zero   */
     {   FPBra,  Branch, {.raw = AXP_SRC1_FA},  AXP_FQ, FboxOther},                                  /* 37   FBGT        Floating branch if > zero   */
@@ -473,6 +487,8 @@ void AXP_Dispatcher(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
         u32 tmp1;
         AXP_FP_FUNC tmp2;
     } fpFunc;
+    AXP_FBOX_FPCR insFpcr;
+    AXP_IBOX_EXC_SUM excSum;
     bool locked = false;
 
     goto *(&&OP_CALL_PAL + label[instr->opcode]);
@@ -868,6 +884,13 @@ FUNC_SQRTFG: /* FNC: 0xa */
     goto COMPL_RETIRE;
 
 FUNC_SQRTST: /* FNC: 0xb */
+    if (AXP_FP_SoftFloatNeeded(cpu, instr) == true)
+    {
+        instr->excRegMask = AXP_FP_SoftOperate(cpu, instr);
+        goto COMPL_RETIRE;
+    }
+    insFpcr = instr->insFpcr;
+    excSum = instr->excSum;
     switch (fpFunc.tmp2.src)
     {
         case AXP_FP_S:
@@ -882,7 +905,7 @@ FUNC_SQRTST: /* FNC: 0xb */
             goto RESERVED_OP;
             break;
     }
-    goto COMPL_RETIRE;
+    goto IEEE_RETIRE;
 
 OP_ADDF: /* OPCODE: 0x15 */
     fpFunc.tmp1 = instr->function;
@@ -1040,6 +1063,13 @@ FUNC_VAX_CVTQ:
 
 OP_ADDS: /* OPCODE: 0x16 */
     fpFunc.tmp1 = instr->function;
+    if (AXP_FP_SoftFloatNeeded(cpu, instr) == true)
+    {
+        instr->excRegMask = AXP_FP_SoftOperate(cpu, instr);
+        goto COMPL_RETIRE;
+    }
+    insFpcr = instr->insFpcr;
+    excSum = instr->excSum;
     goto *(&&FUNC_IEEE_ADD + opcode16Label[fpFunc.tmp2.fnc]);
 
 FUNC_IEEE_ADD:
@@ -1058,7 +1088,7 @@ FUNC_IEEE_ADD:
             goto RESERVED_OP;
             break;
     }
-    goto COMPL_RETIRE;
+    goto IEEE_RETIRE;
 
 FUNC_IEEE_SUB:
     switch (fpFunc.tmp2.src)
@@ -1076,7 +1106,7 @@ FUNC_IEEE_SUB:
             goto RESERVED_OP;
             break;
     }
-    goto COMPL_RETIRE;
+    goto IEEE_RETIRE;
 
 FUNC_IEEE_MUL:
     switch (fpFunc.tmp2.src)
@@ -1094,7 +1124,7 @@ FUNC_IEEE_MUL:
             goto RESERVED_OP;
             break;
     }
-    goto COMPL_RETIRE;
+    goto IEEE_RETIRE;
 
 FUNC_IEEE_DIV:
     switch (fpFunc.tmp2.src)
@@ -1112,7 +1142,7 @@ FUNC_IEEE_DIV:
             goto RESERVED_OP;
             break;
     }
-    goto COMPL_RETIRE;
+    goto IEEE_RETIRE;
 
 FUNC_IEEE_CMPUN:
     if (fpFunc.tmp2.src == AXP_FP_T)
@@ -1161,7 +1191,7 @@ FUNC_IEEE_CVTS:
             goto RESERVED_OP;
             break;
     }
-    goto COMPL_RETIRE;
+    goto IEEE_RETIRE;
 
 FUNC_IEEE_CVTT:
     switch (fpFunc.tmp2.src)
@@ -1178,7 +1208,7 @@ FUNC_IEEE_CVTT:
             goto RESERVED_OP;
             break;
     }
-    goto COMPL_RETIRE;
+    goto IEEE_RETIRE;
 
 FUNC_IEEE_CVTQ:
     if (fpFunc.tmp2.src == AXP_FP_T)
@@ -1580,6 +1610,22 @@ OP_BGT: /* OPCODE: 0x3f */
     instr->excRegMask = AXP_BGT(cpu, instr);
     goto COMPL_RETIRE;
 
+IEEE_RETIRE:
+
+    /*
+     * The host delivers a denormal for a result that is too small to be
+     * normalized, where the Alpha does not.  When it did, the instruction is
+     * performed again with integer arithmetic, without what the host set in
+     * the FPCR and excSum for it.
+     */
+    if (AXP_FP_SoftFloatRedo(cpu, instr) == true)
+    {
+        instr->insFpcr = insFpcr;
+        instr->excSum = excSum;
+        instr->excRegMask = AXP_FP_SoftOperate(cpu, instr);
+    }
+    goto COMPL_RETIRE;
+
 RESERVED_OP:
 
     /*
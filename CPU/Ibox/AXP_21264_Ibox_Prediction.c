@@ -31,16 +31,116 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  The tournament predictor now works on its own tables, rather than the CPU
+ *  structure, so that it can be run outside of the Ibox.  Added a number of
+ *  other branch prediction models, gshare, a small TAGE, and a perceptron,
+ *  behind a common interface, so that their cost and accuracy can be compared
+ *  with the tournament predictor's.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Added the prediction of the targets of unconditional branches, jumps, and
+ *  returns, from the return stack and the jump target cache, and the
+ *  recovery of the return stack when fetched instructions are aborted.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped the lines longer than 80 columns.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Ibox/AXP_21264_Ibox_Prediction.h"
+#include "CPU/Ibox/AXP_21264_Ibox.h"
+#include "CPU/Ibox/AXP_21264_Ibox_PCHandling.h"
 #include "CommonUtilities/AXP_Trace.h"
 
 /*
- * AXP_Branch_Prediction
+ * gshare, with a 14-bit global history XORed with the PC to index 16K 2-bit
+ * saturating counters.
+ */
+#define AXP_GSHARE_BITS         14
+#define AXP_GSHARE_SIZE         (1 << AXP_GSHARE_BITS)
+#define AXP_GSHARE_MASK         (AXP_GSHARE_SIZE - 1)
+
+typedef struct
+{
+    u8 counter[AXP_GSHARE_SIZE];
+    u32 history;
+} AXP_BP_GSHARE;
+
+/*
+ * A small TAGE (TAgged GEometric history length) predictor.  A 4K entry table
+ * of 2-bit counters, indexed by the PC alone, provides the prediction unless
+ * one of the tagged tables has an entry for the PC and the global history of
+ * its length.  The longest of these histories provides the prediction.
  *
- *  This function is called to determine if a branch should be taken or not.
- *  It uses past history, locally and globally, to determine this.
+ * Each table's length of history is kept folded down to the number of bits
+ * of its index, and of its tag (twice, to different lengths, so that they are
+ * not the same), by XORing each group of that many bits together.  These are
+ * updated as each branch is shifted into the history, rather than folded from
+ * it for every prediction.
+ */
+#define AXP_TAGE_TABLES         4
+#define AXP_TAGE_BASE_BITS      12
+#define AXP_TAGE_BASE_SIZE      (1 << AXP_TAGE_BASE_BITS)
+#define AXP_TAGE_INDEX_BITS     9
+#define AXP_TAGE_INDEX_SIZE     (1 << AXP_TAGE_INDEX_BITS)
+#define AXP_TAGE_TAG_BITS       8
+#define AXP_TAGE_CTR_MAX        3
+#define AXP_TAGE_CTR_MIN        -4
+#define AXP_TAGE_USEFUL_MAX     3
+#define AXP_TAGE_AGE_PERIOD     (256 * ONE_K)
+
+typedef struct
+{
+    u8 tag;
+    i8 counter;
+    u8 useful;
+} AXP_TAGE_ENTRY;
+
+typedef struct
+{
+    u8 base[AXP_TAGE_BASE_SIZE];
+    AXP_TAGE_ENTRY table[AXP_TAGE_TABLES][AXP_TAGE_INDEX_SIZE];
+    u64 history;
+    u16 foldIndex[AXP_TAGE_TABLES];
+    u16 foldTag[AXP_TAGE_TABLES];
+    u16 foldTag2[AXP_TAGE_TABLES];
+    u32 updates;
+} AXP_BP_TAGE;
+
+static const u8 _AXP_TAGE_HistoryLen[AXP_TAGE_TABLES] = {5, 12, 27, 60};
+
+/*
+ * The tag returned by the TAGE predictor has the table that provided the
+ * prediction (0 for the base table), the prediction, and the prediction that
+ * would have been made without the providing table.
+ */
+#define AXP_TAGE_PROVIDER(tag)  ((tag) & 0x7)
+#define AXP_TAGE_PRED           0x8
+#define AXP_TAGE_ALT            0x10
+
+/*
+ * A perceptron predictor, with 128 perceptrons, selected by the PC, each with
+ * a weight for 24 bits of global history and a bias weight.  The threshold is
+ * the one found best for this history length, 1.93 * 24 + 14.
+ */
+#define AXP_PERCEPTRONS         128
+#define AXP_PERCEPTRON_HISTORY  24
+#define AXP_PERCEPTRON_THETA    60
+#define AXP_PERCEPTRON_MAX      127
+#define AXP_PERCEPTRON_MIN      -127
+
+typedef struct
+{
+    i8 weight[AXP_PERCEPTRONS][AXP_PERCEPTRON_HISTORY + 1];
+    u32 history;
+} AXP_BP_PERCEPTRON;
+
+/*
+ * AXP_BP_TournamentPredict
+ *  This function is called to determine if a branch should be taken or not,
+ *  using the 21264's tournament predictor.  It uses past history, locally and
+ *  globally, to determine this.
  *
  *  The Local History Table is indexed by bits 2-11 of the VPC.  This entry
  *  contains a 10-bit value (0-1023), which is generated by indicating when
@@ -59,6 +159,169 @@
  *  Predictor is correct.
  *
  * Input Parameters:
+ *  bp:
+ *      A pointer to the tables of the predictor.
+ *  pc:
+ *      A value of the pc field of the Virtual Program Counter.
+ *  useGlobal:
+ *      A value of true when the choice predictor selects between the local
+ *      and global predictors, and false when only the local one is used.
+ *
+ * Output Parameters:
+ *  localTaken:
+ *      A location to receive a value of true when the local predictor
+ *      indicates that a branch should be taken.
+ *  globalTaken:
+ *      A location to receive a value of true when the global predictor
+ *      indicates that a branch should be taken.
+ *  choice:
+ *      A location to receive a value of true when the global predictor should
+ *      be selected, and false when the local predictor should be selected.
+ *      This parameter is only used when the localPredictor and GlobalPredictor
+ *      do not match.
+ *
+ * Return Value:
+ *  true:   Prediction logic indicates to take the branch.
+ *  false:  Prediction logic indicates to not take the branch.
+ */
+bool AXP_BP_TournamentPredict(AXP_BP_TOURNAMENT *bp,
+                              u64 pc,
+                              bool useGlobal,
+                              bool *localTaken,
+                              bool *globalTaken,
+                              bool *choice)
+{
+    int lcl_predictor_idx;
+    bool retVal;
+
+    /*
+     * Need to extract the index into the Local History Table from the VPC, and
+     * use this to determine the index into the Local Predictor Table.
+     */
+    lcl_predictor_idx =
+        bp->localHistoryTable.lcl_history[pc & AXP_MASK_10_BITS];
+
+    /*
+     * Return the take(true)/don't take(false) for each of the Predictor
+     * Tables.  The choice is determined and returned, but my not be used by
+     * the caller.
+     */
+    *localTaken = AXP_3BIT_TAKE(bp->localPredictor.lcl_pred[lcl_predictor_idx]);
+    if (useGlobal == true)
+    {
+        *globalTaken = AXP_2BIT_TAKE(
+            bp->globalPredictor.gbl_pred[bp->globalPathHistory]);
+        *choice = AXP_2BIT_TAKE(
+            bp->choicePredictor.choice_pred[bp->globalPathHistory]);
+    }
+    else
+    {
+        *globalTaken = false;
+        *choice = false; /* This will force choice to select Local */
+    }
+    if (*localTaken != *globalTaken)
+    {
+        retVal = (*choice == true) ? *globalTaken : *localTaken;
+    }
+    else
+    {
+        retVal = *localTaken;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_BP_TournamentUpdate
+ *  This function is called when the branch instruction is retired to update
+ *  the local, global, and choice prediction tables, and the local history
+ *  table and global path history information, of the tournament predictor.
+ *
+ * Input Parameters:
+ *  bp:
+ *      A pointer to the tables of the predictor.
+ *  pc:
+ *      A value of the pc field of the Virtual Program Counter.
+ *  taken:
+ *      A value indicating if the branch is being taken or not.
+ *  localTaken:
+ *      A value of what was predicted by the local predictor.
+ *  globalTaken:
+ *      A value of what was predicted by the global predictor.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_BP_TournamentUpdate(AXP_BP_TOURNAMENT *bp,
+                             u64 pc,
+                             bool taken,
+                             bool localTaken,
+                             bool globalTaken)
+{
+    int lcl_history_idx = pc & AXP_MASK_10_BITS;
+    int lcl_predictor_idx;
+
+    lcl_predictor_idx = bp->localHistoryTable.lcl_history[lcl_history_idx];
+
+    /*
+     * If the choice to take or not take a branch agreed with the local
+     * predictor, then indicate this for the choice predictor, by decrementing
+     * the saturation counter.  Otherwise, if it agreed with the global
+     * predictor, then indicate this by incrementing the saturation counter.
+     *
+     * NOTE:    If the branch taken does not match both the local and global
+     *          predictions, then we don't update the choice at all (we had a
+     *          misprediction).
+     */
+    if ((taken == localTaken) && (taken != globalTaken))
+    {
+        AXP_2BIT_DECR(bp->choicePredictor.choice_pred[bp->globalPathHistory]);
+    }
+    else if ((taken != localTaken) && (taken == globalTaken))
+    {
+        AXP_2BIT_INCR(bp->choicePredictor.choice_pred[bp->globalPathHistory]);
+    }
+
+    /*
+     * If the branch was taken, then indicate this in the local and global
+     * prediction tables, and local and global paths.  Otherwise, decrement
+     * the prediction tables and indicate the paths were not taken.
+     */
+    if (taken == true)
+    {
+        AXP_3BIT_INCR(bp->localPredictor.lcl_pred[lcl_predictor_idx]);
+        AXP_2BIT_INCR(bp->globalPredictor.gbl_pred[bp->globalPathHistory]);
+        AXP_LOCAL_PATH_TAKEN(
+            bp->localHistoryTable.lcl_history[lcl_history_idx]);
+        AXP_GLOBAL_PATH_TAKEN(bp->globalPathHistory);
+    }
+    else
+    {
+        AXP_3BIT_DECR(bp->localPredictor.lcl_pred[lcl_predictor_idx]);
+        AXP_2BIT_DECR(bp->globalPredictor.gbl_pred[bp->globalPathHistory]);
+        AXP_LOCAL_PATH_NOT_TAKEN(
+            bp->localHistoryTable.lcl_history[lcl_history_idx]);
+        AXP_GLOBAL_PATH_NOT_TAKEN(bp->globalPathHistory);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_Branch_Prediction
+ *  This function is called to determine if a branch should be taken or not.
+ *  How this is done is determined by the BP_MODE field of the I_CTL register.
+ *
+ * Input Parameters:
  *  cpu:
  *      A pointer to the structure containing the information needed to emulate
  *      a single CPU.
@@ -88,9 +351,6 @@ bool AXP_Branch_Prediction(AXP_21264_CPU *cpu,
                            bool *globalTaken,
                            bool *choice)
 {
-    LPTIndex lpt_index;
-    int lcl_history_idx;
-    int lcl_predictor_idx;
     bool retVal;
 
     if (AXP_IBOX_CALL)
@@ -111,41 +371,13 @@ bool AXP_Branch_Prediction(AXP_21264_CPU *cpu,
      */
     if ((cpu->iCtl.bp_mode & AXP_I_CTL_BP_MODE_FALL) != AXP_I_CTL_BP_MODE_FALL)
     {
-
-        /*
-         * Need to extract the index into the Local History Table from the VPC, and
-         * use this to determine the index into the Local Predictor Table.
-         */
-        lpt_index.vpc = vpc;
-        lcl_history_idx = lpt_index.index.index;
-        lcl_predictor_idx = cpu->localHistoryTable.lcl_history[lcl_history_idx].cnt;
-
-        /*
-         * Return the take(true)/don't take(false) for each of the Predictor
-         * Tables.  The choice is determined and returned, but my not be used by
-         * the caller.
-        */
-        *localTaken = AXP_3BIT_TAKE(cpu->localPredictor.lcl_pred[lcl_predictor_idx]);
-        if (cpu->iCtl.bp_mode == AXP_I_CTL_BP_MODE_CHOICE)
-        {
-            *globalTaken = AXP_2BIT_TAKE(
-            cpu->globalPredictor.gbl_pred[cpu->globalPathHistory]);
-            *choice = AXP_2BIT_TAKE(
-            cpu->choicePredictor.choice_pred[cpu->globalPathHistory]);
-        }
-        else
-        {
-            *globalTaken = false;
-            *choice = false; /* This will force choice to select Local */
-        }
-        if (*localTaken != *globalTaken)
-        {
-            retVal = (*choice == true) ? *globalTaken : *localTaken;
-        }
-        else
-        {
-            retVal = *localTaken;
-        }
+        retVal = AXP_BP_TournamentPredict(
+            &cpu->branchPredictor,
+            vpc.pc,
+            cpu->iCtl.bp_mode == AXP_I_CTL_BP_MODE_CHOICE,
+            localTaken,
+            globalTaken,
+            choice);
     }
     else
     {
@@ -202,10 +434,6 @@ void AXP_Branch_Direction(AXP_21264_CPU *cpu,
                           bool localTaken,
                           bool globalTaken)
 {
-    LPTIndex lpt_index;
-    int lcl_history_idx;
-    int lcl_predictor_idx;
-
     if (AXP_IBOX_CALL)
     {
         AXP_TRACE_BEGIN();
@@ -213,95 +441,900 @@ void AXP_Branch_Direction(AXP_21264_CPU *cpu,
                        AXP_GET_PC(vpc));
         AXP_TRACE_END();
     }
+    if (AXP_IBOX_OPT1)
+    {
+        AXP_TRACE_BEGIN();
+        AXP_TraceWrite("AXP_Branch_Direction for pc: 0x%016llx, Branch %s, "
+                       "Local Prediction %s, Global Prediction %s",
+                       AXP_GET_PC(vpc),
+                       taken ? "Taken" : "Not Taken",
+                       (taken == localTaken) ? "Correct" : "Wrong",
+                       (taken == globalTaken) ? "Correct" : "Wrong");
+        AXP_TRACE_END();
+    }
+    AXP_BP_TournamentUpdate(&cpu->branchPredictor,
+                            vpc.pc,
+                            taken,
+                            localTaken,
+                            globalTaken);
+    return;
+}
+
+/*
+ * _AXP_Branch_Hint
+ *  This function determines the operation on the return stack for a branch
+ *  instruction.  BSR and CALL_PAL push their return PC, like a JSR, and the
+ *  hint bits of JMP and HW_RET select the operation for these.
+ *
+ * Input Parameters:
+ *  instr:
+ *      A pointer to the decoded branch instruction.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  AXP_HW_JMP, AXP_HW_JSR, AXP_HW_RET, or AXP_HW_COROUTINE.
+ */
+static u8 _AXP_Branch_Hint(AXP_INSTRUCTION *instr)
+{
+    u8 retVal;
+
+    switch (instr->opcode)
+    {
+        case PAL00:
+        case BSR:
+            retVal = AXP_HW_JSR;
+            break;
+
+        case JMP:
+            retVal = AXP_JMP_TYPE(instr->displacement);
+            break;
+
+        case HW_RET:
+            retVal = instr->type_hint_index;
+            break;
+
+        default:
+            retVal = AXP_HW_JMP;
+            break;
+    }
 
     /*
-     * Need to extract the index into the Local History Table from the VPC, and
-     * use this to determine the index into the Local Predictor Table.
+     * Return back to the caller.
      */
-    lpt_index.vpc = vpc;
-    lcl_history_idx = lpt_index.index.index;
-    lcl_predictor_idx = cpu->localHistoryTable.lcl_history[lcl_history_idx].cnt;
+    return (retVal);
+}
+
+/*
+ * _AXP_Branch_Stack
+ *  This function performs the operation on the return stack for a branch
+ *  instruction.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  instr:
+ *      A pointer to the decoded branch instruction.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The PC popped from the return stack for a RET or JSR_COROUTINE, otherwise
+ *  the PC of the instruction after the branch.
+ */
+static AXP_PC _AXP_Branch_Stack(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
+{
+    AXP_PC retPC = instr->pc;
+
+    retPC.pc++;
+    switch (_AXP_Branch_Hint(instr))
+    {
+        case AXP_HW_JSR:
+            AXP_PUSH(retPC);
+            break;
+
+        case AXP_HW_RET:
+            AXP_POP(retPC);
+            break;
+
+        case AXP_HW_COROUTINE:
+            AXP_SWAP(retPC);
+            break;
+
+        default:
+            break;
+    }
 
     /*
-     * If the choice to take or not take a branch agreed with the local
-     * predictor, then indicate this for the choice predictor, by decrementing
-     * the saturation counter
+     * Return back to the caller.
      */
-    if ((taken == localTaken) && (taken != globalTaken))
+    return (retPC);
+}
+
+/*
+ * AXP_Branch_Target
+ *  This function is called for each instruction as it is fetched, to predict
+ *  whether it branches and, if so, to where.  The state of the return stack
+ *  is saved in the instruction first, so that it can be recovered if this
+ *  instruction, or one before it, causes the instructions after it to be
+ *  aborted.
+ *
+ *      Instruction         Predicted Target        Return Stack
+ *      ------------------- ----------------------- -------------------
+ *      Conditional branch  Displacement, if taken  --
+ *      BR                  Displacement            --
+ *      BSR                 Displacement            Push return PC
+ *      JMP                 Jump target cache       --
+ *      JSR                 Jump target cache       Push return PC
+ *      RET                 Return stack            Pop
+ *      JSR_COROUTINE       Return stack            Pop, push return PC
+ *      CALL_PAL            Not predicted           Push return PC
+ *
+ *  HW_RET is predicted as the JMP, JSR, RET, or JSR_COROUTINE its hint bits
+ *  indicate.  When the jump target cache does not have the JMP or JSR, the
+ *  target in its hint bits is predicted.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  instr:
+ *      A pointer to the decoded instruction.
+ *
+ * Output Parameters:
+ *  instr:
+ *      The kind of branch, the predictions, and the state of the return stack
+ *      are stored in this structure.
+ *
+ * Return Value:
+ *  true:   The instruction is predicted to branch to instr->predictedPC.
+ *  false:  The instruction is predicted to fall through.
+ */
+bool AXP_Branch_Target(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
+{
+    AXP_JMP_CACHE_ENTRY *entry;
+    AXP_PC retPC;
+    i64 hint;
+    bool choice;
+    bool retVal = false;
+
+    instr->predStackIdx = cpu->predStackIdx;
+    instr->predStackTop = cpu->predictionStack[cpu->predStackIdx];
+    instr->branchKind = AXP_BRANCH_NONE;
+    instr->localPredict = false;
+    instr->globalPredict = false;
+    AXP_PUT_PC(instr->predictedPC, 0);
+    if (instr->type == Branch)
     {
-        if (AXP_IBOX_OPT1)
+        retPC = _AXP_Branch_Stack(cpu, instr);
+        switch (instr->opcode)
         {
-            AXP_TRACE_BEGIN();
-            AXP_TraceWrite("AXP_Branch_Direction for pc: 0x%016llx, "
-                           "Local Prediction Correct",
-                           AXP_GET_PC(vpc));
-            AXP_TRACE_END();
+            case PAL00:
+                instr->branchKind = AXP_BRANCH_PAL;
+                break;
+
+            case BR:
+            case BSR:
+                instr->branchKind = AXP_BRANCH_UNCOND;
+                instr->predictedPC = AXP_21264_DisplaceVPC(
+                    cpu,
+                    instr->pc,
+                    instr->displacement + 1);
+                retVal = true;
+                break;
+
+            case JMP:
+            case HW_RET:
+                if (_AXP_Branch_Hint(instr) >= AXP_HW_RET)
+                {
+                    instr->branchKind = AXP_BRANCH_RETURN;
+                    instr->predictedPC = retPC;
+                    retVal = AXP_GET_PC(retPC) != 0;
+                }
+                else
+                {
+                    instr->branchKind = AXP_BRANCH_JUMP;
+                    entry = &cpu->jumpCache.entry[
+                        AXP_JMP_CACHE_INDEX(instr->pc.pc)];
+                    if ((entry->valid == true) &&
+                        (AXP_GET_PC(entry->pc) == AXP_GET_PC(instr->pc)))
+                    {
+                        instr->predictedPC = entry->target;
+                        retVal = true;
+                    }
+                    else if (instr->opcode == JMP)
+                    {
+
+                        /*
+                         * The hint is a signed 14-bit displacement.
+                         */
+                        hint = AXP_JMP_HINT(instr->displacement);
+                        hint = (hint ^ 0x2000) - 0x2000;
+                        instr->predictedPC = AXP_21264_DisplaceVPC(cpu,
+                                                                   instr->pc,
+                                                                   hint + 1);
+                        retVal = true;
+                    }
+                }
+                break;
+
+            default:
+                instr->branchKind = AXP_BRANCH_COND;
+                retVal = AXP_Branch_Prediction(cpu,
+                                               instr->pc,
+                                               &instr->localPredict,
+                                               &instr->globalPredict,
+                                               &choice);
+                if (retVal == true)
+                {
+                    instr->predictedPC = AXP_21264_DisplaceVPC(
+                        cpu,
+                        instr->pc,
+                        instr->displacement + 1);
+                }
+                break;
         }
-        AXP_2BIT_DECR(cpu->choicePredictor.choice_pred[cpu->globalPathHistory]);
     }
+    instr->branchPredict = retVal;
 
     /*
-     * Otherwise, if the choice to take or not take a branch agreed with the
-     * global predictor, then indicate this for the choice predictor, by
-     * incrementing the saturation counter
-     *
-     * NOTE:    If the branch taken does not match both the local and global
-     *          predictions, then we don't update the choice at all (we had a
-     *          misprediction).
+     * Return back to the caller.
      */
-    else if ((taken != localTaken) && (taken == globalTaken))
+    return (retVal);
+}
+
+/*
+ * AXP_Branch_Resolve
+ *  This function is called when a branch instruction is retired, to update
+ *  the branch prediction logic with where it actually went, and to determine
+ *  whether the instructions fetched after it were the correct ones.  The
+ *  returns and jumps, and those of them that were mispredicted, are counted.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  instr:
+ *      A pointer to the branch instruction being retired.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The branch was mispredicted, either whether it was taken or its
+ *          target.
+ *  false:  The branch was correctly predicted.
+ */
+bool AXP_Branch_Resolve(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
+{
+    AXP_JMP_CACHE_ENTRY *entry;
+    bool taken = AXP_GET_PC(instr->branchPC) != 0;
+    bool retVal;
+
+    retVal = (taken != instr->branchPredict) ||
+             ((taken == true) &&
+              (AXP_GET_PC(instr->branchPC) != AXP_GET_PC(instr->predictedPC)));
+    switch (instr->branchKind)
+    {
+        case AXP_BRANCH_COND:
+            AXP_Branch_Direction(cpu,
+                                 instr->pc,
+                                 taken,
+                                 instr->localPredict,
+                                 instr->globalPredict);
+            if (retVal == true)
+            {
+                AXP_COUNT(cpu, AXP_CNT_MISPREDICTS);
+            }
+            break;
+
+        case AXP_BRANCH_JUMP:
+            entry = &cpu->jumpCache.entry[AXP_JMP_CACHE_INDEX(instr->pc.pc)];
+            entry->pc = instr->pc;
+            entry->target = instr->branchPC;
+            entry->valid = true;
+            AXP_COUNT(cpu, AXP_CNT_JUMPS);
+            if (retVal == true)
+            {
+                AXP_COUNT(cpu, AXP_CNT_JMP_MISPREDICTS);
+            }
+            break;
+
+        case AXP_BRANCH_RETURN:
+            AXP_COUNT(cpu, AXP_CNT_RETURNS);
+            if (retVal == true)
+            {
+                AXP_COUNT(cpu, AXP_CNT_RET_MISPREDICTS);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_Branch_Recover
+ *  This function is called when the instructions fetched after an instruction
+ *  are aborted, to put the return stack back the way it was before they were
+ *  fetched.  Only the index and the entry on the top of the stack are saved
+ *  for each instruction, so a return address overwritten by a call after a
+ *  return that are both aborted is not recovered.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  instr:
+ *      A pointer to the instruction after which instructions are aborted.
+ *  reapply:
+ *      A value of true when the instruction itself is not going to be fetched
+ *      again, so its own operation on the return stack is kept.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_Branch_Recover(AXP_21264_CPU *cpu,
+                        AXP_INSTRUCTION *instr,
+                        bool reapply)
+{
+    cpu->predStackIdx = instr->predStackIdx;
+    cpu->predictionStack[cpu->predStackIdx] = instr->predStackTop;
+    if ((reapply == true) && (instr->type == Branch))
+    {
+        (void) _AXP_Branch_Stack(cpu, instr);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * _AXP_BP_Tournament_Predict, _AXP_BP_Local_Predict, _AXP_BP_Tournament_Update
+ *  These functions are the tournament predictor as a model, both with the
+ *  choice between the local and global predictors and with only the local
+ *  one, as the BP_MODE field of the I_CTL register selects.  The tag holds
+ *  the local (bit 0) and global (bit 1) predictions.
+ */
+static bool _AXP_BP_Tournament_Predict(void *state, u64 pc, u32 *tag)
+{
+    bool localTaken, globalTaken, choice;
+    bool retVal;
+
+    retVal = AXP_BP_TournamentPredict((AXP_BP_TOURNAMENT *) state,
+                                      pc,
+                                      true,
+                                      &localTaken,
+                                      &globalTaken,
+                                      &choice);
+    *tag = localTaken | (globalTaken << 1);
+    return (retVal);
+}
+
+static bool _AXP_BP_Local_Predict(void *state, u64 pc, u32 *tag)
+{
+    bool localTaken, globalTaken, choice;
+    bool retVal;
+
+    retVal = AXP_BP_TournamentPredict((AXP_BP_TOURNAMENT *) state,
+                                      pc,
+                                      false,
+                                      &localTaken,
+                                      &globalTaken,
+                                      &choice);
+    *tag = localTaken | (globalTaken << 1);
+    return (retVal);
+}
+
+static void _AXP_BP_Tournament_Update(void *state, u64 pc, bool taken, u32 tag)
+{
+    AXP_BP_TournamentUpdate((AXP_BP_TOURNAMENT *) state,
+                            pc,
+                            taken,
+                            (tag & 0x1) != 0,
+                            (tag & 0x2) != 0);
+    return;
+}
+
+/*
+ * _AXP_BP_FallThrough_Predict, _AXP_BP_FallThrough_Update
+ *  These functions are the model of predicting every branch to fall through,
+ *  as the BP_MODE field of the I_CTL register can select.
+ */
+static bool _AXP_BP_FallThrough_Predict(void *state, u64 pc, u32 *tag)
+{
+    *tag = 0;
+    return (false);
+}
+
+static void _AXP_BP_FallThrough_Update(void *state, u64 pc, bool taken, u32 tag)
+{
+    return;
+}
+
+/*
+ * _AXP_BP_GShare_Predict, _AXP_BP_GShare_Update
+ *  These functions are the gshare model.  The counters are kept as plain
+ *  values from 0 to 3, and predict taken from 2.
+ */
+static bool _AXP_BP_GShare_Predict(void *state, u64 pc, u32 *tag)
+{
+    AXP_BP_GSHARE *bp = (AXP_BP_GSHARE *) state;
+
+    *tag = (pc ^ bp->history) & AXP_GSHARE_MASK;
+    return (bp->counter[*tag] >= AXP_2BIT_TAKEN_MIN);
+}
+
+static void _AXP_BP_GShare_Update(void *state, u64 pc, bool taken, u32 tag)
+{
+    AXP_BP_GSHARE *bp = (AXP_BP_GSHARE *) state;
+    u8 *counter = &bp->counter[tag];
+
+    if (taken == true)
+    {
+        if (*counter < AXP_2BIT_MAX_VALUE)
+        {
+            (*counter)++;
+        }
+    }
+    else if (*counter > 0)
+    {
+        (*counter)--;
+    }
+    bp->history = ((bp->history << 1) | taken) & AXP_GSHARE_MASK;
+    return;
+}
+
+/*
+ * _AXP_TAGE_Fold
+ *  This function is called to update a folded history, as a branch is
+ *  shifted into the global history.  The new branch comes in at the bottom,
+ *  the one that has just become too old for the length of history is taken
+ *  out where it was folded to, and the bit shifted out of the top is wrapped
+ *  around to the bottom.
+ *
+ * Input Parameters:
+ *  fold:
+ *      A value of the folded history.
+ *  taken:
+ *      A value of the direction of the new branch.
+ *  outgoing:
+ *      A value of the direction of the branch that is now too old.
+ *  length:
+ *      A value of the number of bits of history folded.
+ *  bits:
+ *      A value of the number of bits they are folded to.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The updated folded history.
+ */
+static u16 _AXP_TAGE_Fold(u32 fold,
+                          u32 taken,
+                          u32 outgoing,
+                          u32 length,
+                          u32 bits)
+{
+    fold = (fold << 1) | taken;
+    fold ^= outgoing << (length % bits);
+    fold ^= fold >> bits;
+    return (fold & ((1 << bits) - 1));
+}
+
+/*
+ * _AXP_TAGE_Index, _AXP_TAGE_Tag
+ *  These functions are called to get the index into, and the tag for, a
+ *  tagged table, from the PC and the history of that table's length.  They
+ *  are computed differently, so that the PCs and histories that share an
+ *  index are unlikely to share a tag.
+ */
+static u32 _AXP_TAGE_Index(AXP_BP_TAGE *bp, u64 pc, int table)
+{
+    return ((pc ^
+             (pc >> (AXP_TAGE_INDEX_BITS - table)) ^
+             bp->foldIndex[table]) &
+            (AXP_TAGE_INDEX_SIZE - 1));
+}
+
+static u8 _AXP_TAGE_Tag(AXP_BP_TAGE *bp, u64 pc, int table)
+{
+    return ((pc ^ bp->foldTag[table] ^ (bp->foldTag2[table] << 1)) &
+            ((1 << AXP_TAGE_TAG_BITS) - 1));
+}
+
+/*
+ * _AXP_BP_TAGE_Predict
+ *  This function is called to predict a branch with the TAGE model.  The
+ *  tagged table with the longest history that has an entry for the branch
+ *  provides the prediction.  The next longest one, or the base table, provides
+ *  the alternate prediction.
+ *
+ * Input Parameters:
+ *  state:
+ *      A pointer to the state of the model.
+ *  pc:
+ *      A value of the pc field of the Virtual Program Counter.
+ *
+ * Output Parameters:
+ *  tag:
+ *      A location to receive the providing table and the predictions.
+ *
+ * Return Value:
+ *  true:   Take the branch.
+ *  false:  Do not take the branch.
+ */
+static bool _AXP_BP_TAGE_Predict(void *state, u64 pc, u32 *tag)
+{
+    AXP_BP_TAGE *bp = (AXP_BP_TAGE *) state;
+    AXP_TAGE_ENTRY *entry;
+    u32 provider = 0;
+    bool pred, alt;
+    int table;
+
+    pred = alt =
+        bp->base[pc & (AXP_TAGE_BASE_SIZE - 1)] >= AXP_2BIT_TAKEN_MIN;
+    for (table = 0; table < AXP_TAGE_TABLES; table++)
     {
-        if (AXP_IBOX_OPT1)
+        entry = &bp->table[table][_AXP_TAGE_Index(bp, pc, table)];
+        if (entry->tag == _AXP_TAGE_Tag(bp, pc, table))
         {
-            AXP_TRACE_BEGIN();
-            AXP_TraceWrite("AXP_Branch_Direction for pc: 0x%016llx, "
-                           "Global Prediction Correct",
-                           AXP_GET_PC(vpc));
-          AXP_TRACE_END();
+            alt = pred;
+            pred = entry->counter >= 0;
+            provider = table + 1;
         }
-        AXP_2BIT_INCR(cpu->choicePredictor.choice_pred[cpu->globalPathHistory]);
     }
+    *tag = provider |
+           (pred ? AXP_TAGE_PRED : 0) |
+           (alt ? AXP_TAGE_ALT : 0);
 
     /*
-     * If the branch was taken, then indicate this in the local and global
-     * prediction tables.  Additionally, indicate that the local and global
-     * paths were taken, when they agree.  Otherwise, decrement the appropriate
-     * predictions tables and indicate the local and global paths were not
-     * taken.
-     *
-     * NOTE:    If the local and global predictors indicated that the branch
-     *          should be taken, then both predictor are correct and should be
-     *          accounted for.
+     * Return the results back to the caller.
      */
-    if (taken == true)
+    return (pred);
+}
+
+/*
+ * _AXP_BP_TAGE_Update
+ *  This function is called to update the TAGE model with the actual direction
+ *  of a branch.  The providing table's counter is trained, and its entry is
+ *  marked useful when it was right and the alternate was not.  On a
+ *  misprediction, an entry is allocated in a table with a longer history than
+ *  the provider's, if one of them has an entry that is not useful.  If none
+ *  does, they are all made less useful, so that one will be next time.
+ *  Periodically, all entries are aged.
+ *
+ * Input Parameters:
+ *  state:
+ *      A pointer to the state of the model.
+ *  pc:
+ *      A value of the pc field of the Virtual Program Counter.
+ *  taken:
+ *      A value indicating if the branch was taken.
+ *  tag:
+ *      A value returned when the branch was predicted.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void _AXP_BP_TAGE_Update(void *state, u64 pc, bool taken, u32 tag)
+{
+    AXP_BP_TAGE *bp = (AXP_BP_TAGE *) state;
+    AXP_TAGE_ENTRY *entry;
+    u32 provider = AXP_TAGE_PROVIDER(tag);
+    bool pred = (tag & AXP_TAGE_PRED) != 0;
+    bool alt = (tag & AXP_TAGE_ALT) != 0;
+    bool allocated = false;
+    int table, ii;
+    u32 length, outgoing;
+    u8 *counter;
+
+    if (provider == 0)
     {
-        if (AXP_IBOX_OPT1)
+        counter = &bp->base[pc & (AXP_TAGE_BASE_SIZE - 1)];
+        if (taken == true)
+        {
+            if (*counter < AXP_2BIT_MAX_VALUE)
+            {
+                (*counter)++;
+            }
+        }
+        else if (*counter > 0)
         {
-            AXP_TRACE_BEGIN();
-            AXP_TraceWrite("AXP_Branch_Direction for pc: 0x%016llx, "
-                           "Branch Taken",
-                           AXP_GET_PC(vpc));
-            AXP_TRACE_END();
+            (*counter)--;
         }
-        AXP_3BIT_INCR(cpu->localPredictor.lcl_pred[lcl_predictor_idx]);
-        AXP_2BIT_INCR(cpu->globalPredictor.gbl_pred[cpu->globalPathHistory]);
-        AXP_LOCAL_PATH_TAKEN(cpu->localHistoryTable.lcl_history[lcl_history_idx].cnt);
-        AXP_GLOBAL_PATH_TAKEN(cpu->globalPathHistory);
     }
     else
     {
-        if (AXP_IBOX_OPT1)
+        table = provider - 1;
+        entry = &bp->table[table][_AXP_TAGE_Index(bp, pc, table)];
+        if (taken == true)
+        {
+            if (entry->counter < AXP_TAGE_CTR_MAX)
+            {
+                entry->counter++;
+            }
+        }
+        else if (entry->counter > AXP_TAGE_CTR_MIN)
+        {
+            entry->counter--;
+        }
+        if (pred != alt)
+        {
+            if (pred == taken)
+            {
+                if (entry->useful < AXP_TAGE_USEFUL_MAX)
+                {
+                    entry->useful++;
+                }
+            }
+            else if (entry->useful > 0)
+            {
+                entry->useful--;
+            }
+        }
+    }
+
+    /*
+     * On a misprediction, try to allocate an entry with a longer history.
+     */
+    if ((pred != taken) && (provider < AXP_TAGE_TABLES))
+    {
+        for (table = provider; (table < AXP_TAGE_TABLES) && !allocated; table++)
+        {
+            entry = &bp->table[table][_AXP_TAGE_Index(bp, pc, table)];
+            if (entry->useful == 0)
+            {
+                entry->tag = _AXP_TAGE_Tag(bp, pc, table);
+                entry->counter = taken ? 0 : -1;
+                allocated = true;
+            }
+        }
+        for (table = provider; (table < AXP_TAGE_TABLES) && !allocated; table++)
+        {
+            entry = &bp->table[table][_AXP_TAGE_Index(bp, pc, table)];
+            entry->useful--;
+        }
+    }
+
+    /*
+     * Age the useful counters, so that entries that were once useful can be
+     * replaced.
+     */
+    if (++bp->updates == AXP_TAGE_AGE_PERIOD)
+    {
+        bp->updates = 0;
+        for (table = 0; table < AXP_TAGE_TABLES; table++)
+        {
+            for (ii = 0; ii < AXP_TAGE_INDEX_SIZE; ii++)
+            {
+                bp->table[table][ii].useful >>= 1;
+            }
+        }
+    }
+
+    /*
+     * Shift the branch into the history, and each of the folded histories.
+     */
+    for (table = 0; table < AXP_TAGE_TABLES; table++)
+    {
+        length = _AXP_TAGE_HistoryLen[table];
+        outgoing = (bp->history >> (length - 1)) & 1;
+        bp->foldIndex[table] = _AXP_TAGE_Fold(bp->foldIndex[table],
+                                              taken,
+                                              outgoing,
+                                              length,
+                                              AXP_TAGE_INDEX_BITS);
+        bp->foldTag[table] = _AXP_TAGE_Fold(bp->foldTag[table],
+                                            taken,
+                                            outgoing,
+                                            length,
+                                            AXP_TAGE_TAG_BITS);
+        bp->foldTag2[table] = _AXP_TAGE_Fold(bp->foldTag2[table],
+                                             taken,
+                                             outgoing,
+                                             length,
+                                             AXP_TAGE_TAG_BITS - 1);
+    }
+    bp->history = (bp->history << 1) | taken;
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * _AXP_BP_Perceptron_Predict
+ *  This function is called to predict a branch with the perceptron model.
+ *  The output of the perceptron selected by the PC is its bias weight, plus
+ *  each history weight when that branch was taken, or minus it when it was
+ *  not.  The branch is predicted taken when the output is not negative.  The
+ *  weights are negated by complementing and subtracting -1, rather than
+ *  testing the history bit, so that there is no host branch to mispredict.
+ *
+ * Input Parameters:
+ *  state:
+ *      A pointer to the state of the model.
+ *  pc:
+ *      A value of the pc field of the Virtual Program Counter.
+ *
+ * Output Parameters:
+ *  tag:
+ *      A location to receive the output of the perceptron.
+ *
+ * Return Value:
+ *  true:   Take the branch.
+ *  false:  Do not take the branch.
+ */
+static bool _AXP_BP_Perceptron_Predict(void *state, u64 pc, u32 *tag)
+{
+    AXP_BP_PERCEPTRON *bp = (AXP_BP_PERCEPTRON *) state;
+    i8 *weight = bp->weight[pc % AXP_PERCEPTRONS];
+    i32 output = weight[0];
+    i32 negate;
+    int ii;
+
+    for (ii = 0; ii < AXP_PERCEPTRON_HISTORY; ii++)
+    {
+        negate = ((bp->history >> ii) & 1) - 1;
+        output += (weight[ii + 1] ^ negate) - negate;
+    }
+    *tag = (u32) output;
+    return (output >= 0);
+}
+
+/*
+ * _AXP_BP_Perceptron_Update
+ *  This function is called to train the perceptron that predicted a branch,
+ *  when the prediction was wrong or its output was not beyond the threshold.
+ *  Each weight is moved towards agreeing with the direction of the branch.
+ *
+ * Input Parameters:
+ *  state:
+ *      A pointer to the state of the model.
+ *  pc:
+ *      A value of the pc field of the Virtual Program Counter.
+ *  taken:
+ *      A value indicating if the branch was taken.
+ *  tag:
+ *      A value of the output of the perceptron.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void _AXP_BP_Perceptron_Update(void *state, u64 pc, bool taken, u32 tag)
+{
+    AXP_BP_PERCEPTRON *bp = (AXP_BP_PERCEPTRON *) state;
+    i8 *weight = bp->weight[pc % AXP_PERCEPTRONS];
+    i32 output = (i32) tag;
+    bool agree;
+    int ii;
+
+    if (((output >= 0) != taken) ||
+        ((output <= AXP_PERCEPTRON_THETA) && (output >= -AXP_PERCEPTRON_THETA)))
+    {
+        for (ii = 0; ii <= AXP_PERCEPTRON_HISTORY; ii++)
         {
-            AXP_TRACE_BEGIN();
-            AXP_TraceWrite("AXP_Branch_Direction for pc: 0x%016llx, Branch "
-                           "Not Taken",
-                           AXP_GET_PC(vpc));
-            AXP_TRACE_END();
+            agree = (ii == 0) ?
+                        taken :
+                        (((bp->history >> (ii - 1)) & 1) == taken);
+            if (agree)
+            {
+                if (weight[ii] < AXP_PERCEPTRON_MAX)
+                {
+                    weight[ii]++;
+                }
+            }
+            else if (weight[ii] > AXP_PERCEPTRON_MIN)
+            {
+                weight[ii]--;
+            }
         }
-        AXP_3BIT_DECR(cpu->localPredictor.lcl_pred[lcl_predictor_idx]);
-        AXP_2BIT_DECR(cpu->globalPredictor.gbl_pred[cpu->globalPathHistory]);
-        AXP_LOCAL_PATH_NOT_TAKEN(cpu->localHistoryTable.lcl_history[lcl_history_idx].cnt);
-        AXP_GLOBAL_PATH_NOT_TAKEN(cpu->globalPathHistory);
     }
+    bp->history = (bp->history << 1) | taken;
     return;
 }
+
+/*
+ * The branch prediction models.  The bits are what each would take in
+ * hardware: the tournament predictor's are the 21264's.
+ */
+static const AXP_BP_MODEL _AXP_BP_Models[] =
+{
+    {
+        "Tournament",
+        sizeof(AXP_BP_TOURNAMENT),
+        (ONE_K * 10) + (ONE_K * 3) + (FOUR_K * 2) + (FOUR_K * 2) + 12,
+        _AXP_BP_Tournament_Predict,
+        _AXP_BP_Tournament_Update
+    },
+    {
+        "Local",
+        sizeof(AXP_BP_TOURNAMENT),
+        (ONE_K * 10) + (ONE_K * 3),
+        _AXP_BP_Local_Predict,
+        _AXP_BP_Tournament_Update
+    },
+    {
+        "Fall-through",
+        1,
+        0,
+        _AXP_BP_FallThrough_Predict,
+        _AXP_BP_FallThrough_Update
+    },
+    {
+        "gshare",
+        sizeof(AXP_BP_GSHARE),
+        (AXP_GSHARE_SIZE * 2) + AXP_GSHARE_BITS,
+        _AXP_BP_GShare_Predict,
+        _AXP_BP_GShare_Update
+    },
+    {
+        "TAGE-lite",
+        sizeof(AXP_BP_TAGE),
+        (AXP_TAGE_BASE_SIZE * 2) +
+        (AXP_TAGE_TABLES * AXP_TAGE_INDEX_SIZE * (AXP_TAGE_TAG_BITS + 3 + 2)) +
+        64,
+        _AXP_BP_TAGE_Predict,
+        _AXP_BP_TAGE_Update
+    },
+    {
+        "Perceptron",
+        sizeof(AXP_BP_PERCEPTRON),
+        (AXP_PERCEPTRONS * (AXP_PERCEPTRON_HISTORY + 1) * 8) +
+        AXP_PERCEPTRON_HISTORY,
+        _AXP_BP_Perceptron_Predict,
+        _AXP_BP_Perceptron_Update
+    }
+};
+
+/*
+ * AXP_BP_Model
+ *  This function is called to get one of the branch prediction models.
+ *
+ * Input Parameters:
+ *  index:
+ *      A value of the index of the model, starting at 0.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  NULL:       There are not that many models.
+ *  Otherwise:  A pointer to the model.
+ */
+const AXP_BP_MODEL *AXP_BP_Model(u32 index)
+{
+    const AXP_BP_MODEL *retVal = NULL;
+
+    if (index < (sizeof(_AXP_BP_Models) / sizeof(_AXP_BP_Models[0])))
+    {
+        retVal = &_AXP_BP_Models[index];
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
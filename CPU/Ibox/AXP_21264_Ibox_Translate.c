@@ -0,0 +1,544 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the functions needed to implement the translated
+ *  block cache for the functional execution mode of the Ibox.
+ *
+ *  Each time the functional mode starts executing at a PC, the block for that
+ *  PC is looked up in the cache.  If it has not been translated, its profile
+ *  counter is incremented.  Once the counter reaches AXP_XLATE_HOT, the
+ *  decoded instructions are recorded the next time the block is executed, up
+ *  to and including the first branch, or the first instruction that cannot be
+ *  translated.  After that, the block is executed from the decoded
+ *  instructions directly through AXP_Dispatcher, without fetching from the
+ *  Icache, decoding, or unlocking the Ibox mutex.  The block executed after a
+ *  translated block is remembered (chained), so it does not have to be looked
+ *  up again.
+ *
+ *  Only the integer operate, byte manipulation, and branch instructions
+ *  outside of PALmode are translated.  Loads, stores, floating-point, the
+ *  HW_* and CALL_PAL instructions, and anything that stalls the Ibox, are
+ *  always executed by the functional mode one instruction at a time, as are
+ *  instructions that generate an exception.
+ *
+ *  The translations are discarded when the Icache is flushed, when an ITB
+ *  entry is invalidated, and when a store is made to a physical page that
+ *  contains translated instructions.
+ *
+ * Revision History:
+ *
+ *  V01.000 15-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  The execution mode is no longer changed while running.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  The physical pages of code run from a super page are now tracked, so that
+ *  a store to them discards the translations.  A block whose physical pages
+ *  cannot be found is not translated.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Go back to the Ibox main loop when a change in the execution mode has been
+ *  requested.
+ */
+#include "CommonUtilities/AXP_Configure.h"
+#include "CPU/Ibox/AXP_21264_Ibox.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Functional.h"
+#include "CPU/Ibox/AXP_21264_Ibox_PCHandling.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Translate.h"
+#include "CommonUtilities/AXP_Trace.h"
+
+/*
+ * Local Prototypes
+ */
+static AXP_XLATE_BLOCK *AXP_21264_Xlate_Lookup(AXP_21264_CPU *, u64, u32);
+static void AXP_21264_Xlate_Finish(AXP_21264_CPU *);
+static bool AXP_21264_Xlate_SetPage(AXP_21264_CPU *, u64);
+
+/*
+ * AXP_21264_Xlate_Lookup
+ *  This function is called to look up the block for a particular PC and
+ *  address space in the translated block cache.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  pc:
+ *      A value for the PC (including the PALmode bit) of the block.
+ *  asn:
+ *      A value for the address space number of the block.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  NULL:       The block is not in the cache.
+ *  Not NULL:   A pointer to the block (which may not yet be translated).
+ */
+static AXP_XLATE_BLOCK *AXP_21264_Xlate_Lookup(AXP_21264_CPU *cpu,
+                                               u64 pc,
+                                               u32 asn)
+{
+    AXP_XLATE_BLOCK *blk = &cpu->xlate[AXP_XLATE_HASH(pc)];
+
+    if ((blk->count == 0) || (blk->pc != pc) || (blk->asn != asn))
+    {
+        blk = NULL;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (blk);
+}
+
+/*
+ * AXP_21264_Xlate_SetPage
+ *  This function is called to indicate that a physical page contains
+ *  translated instructions.  The physical address comes from the super page
+ *  mapping, when the code is in a super page, or from the ITB otherwise.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  va:
+ *      A value for a virtual address in the translated block.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The physical page is now being tracked.
+ *  false:  The physical page could not be found.
+ */
+static bool AXP_21264_Xlate_SetPage(AXP_21264_CPU *cpu, u64 va)
+{
+    AXP_21264_TLB *itb;
+    u64 pa, page;
+    bool retVal = true;
+
+    if (AXP_va2paSuperPage(cpu, va, false, &pa) == false)
+    {
+        itb = AXP_findTLBEntry(cpu, va, false);
+        if (itb != NULL)
+        {
+            pa = itb->physAddr | (va & itb->keepMask);
+        }
+        else
+        {
+            retVal = false;
+        }
+    }
+    if (retVal == true)
+    {
+        page = (pa / AXP_21264_PAGE_SIZE) % AXP_XLATE_PAGES;
+        cpu->xlatePages[page / 64] |= (1ll << (page % 64));
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Xlate_Finish
+ *  This function is called when recording a block is complete.  If anything
+ *  was recorded, and the physical pages it is in can be tracked, then the
+ *  block is now translated.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void AXP_21264_Xlate_Finish(AXP_21264_CPU *cpu)
+{
+    AXP_XLATE_BLOCK *blk = cpu->xlateRec;
+    bool tracked = false;
+
+    /*
+     * A block is in no more than two pages, the one it starts in and the one
+     * it ends in.
+     */
+    if (blk->insCnt > 0)
+    {
+        tracked =
+            AXP_21264_Xlate_SetPage(cpu, AXP_GET_PC(blk->ins[0].pc)) &&
+            AXP_21264_Xlate_SetPage(cpu,
+                                    AXP_GET_PC(blk->ins[blk->insCnt - 1].pc));
+    }
+    if (tracked == true)
+    {
+        blk->valid = true;
+        cpu->xlateTranslated++;
+        if (AXP_IBOX_OPT2)
+        {
+            AXP_TRACE_BEGIN();
+            AXP_TraceWrite("AXP_21264_Xlate_Finish translated %u instructions "
+                           "at pc: 0x%016llx",
+                           blk->insCnt,
+                           blk->pc);
+            AXP_TRACE_END();
+        }
+    }
+
+    /*
+     * If nothing could be translated, or the block could not be tracked, then
+     * start profiling the block over again, rather than trying to record it
+     * every time it is executed.
+     */
+    else
+    {
+        blk->count = 1;
+    }
+    cpu->xlateRec = NULL;
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Xlate_Execute
+ *  This function is called by the functional mode, before it executes the
+ *  instructions fetched from the Icache.  If the block starting at the PC has
+ *  been translated, it is executed, along with any blocks chained to it.
+ *  Otherwise, the block is profiled, and if it has become hot, recording it
+ *  is started.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  pc:
+ *      A value for the PC of the first instruction to be executed.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   One or more translated blocks were executed.  The VPC has been
+ *          updated to the next PC to be fetched.
+ *  false:  Nothing was executed.
+ *
+ * NOTE:    This is called with the Ibox mutex locked.
+ */
+bool AXP_21264_Xlate_Execute(AXP_21264_CPU *cpu, AXP_PC pc)
+{
+    AXP_XLATE_BLOCK *blk, *nextBlk;
+    AXP_INSTRUCTION *instr;
+    AXP_PC exitPC;
+    u64 vpc = AXP_GET_PC(pc);
+    u32 asn = cpu->pCtx.asn;
+    u32 ii, chained = 0;
+    bool redirect, taken;
+    bool retVal = false;
+
+    /*
+     * We do not start recording a block while recording another one.
+     */
+    if (cpu->xlateRec != NULL)
+    {
+        return (retVal);
+    }
+    blk = AXP_21264_Xlate_Lookup(cpu, vpc, asn);
+
+    /*
+     * If the block is not translated, then count the number of times it has
+     * been entered.  When it becomes hot, record it.
+     */
+    if ((blk == NULL) || (blk->valid == false))
+    {
+        if (blk == NULL)
+        {
+            blk = &cpu->xlate[AXP_XLATE_HASH(vpc)];
+            memset(blk, 0, sizeof(AXP_XLATE_BLOCK));
+            blk->pc = vpc;
+            blk->asn = asn;
+        }
+        blk->count++;
+        if ((blk->count >= AXP_XLATE_HOT) && (pc.pal == 0))
+        {
+            blk->insCnt = 0;
+            cpu->xlateRec = blk;
+        }
+        return (retVal);
+    }
+
+    /*
+     * Nothing is ever in-flight in functional mode, so the ROB entry at the
+     * end of the ROB is available to hold the instruction being executed.
+     */
+    instr = &cpu->rob[cpu->robEnd];
+
+    /*
+     * Execute translated blocks until we get to one that has not been
+     * translated, or something needs the attention of the Ibox main loop.
+     */
+    while (blk != NULL)
+    {
+        retVal = true;
+        redirect = false;
+        for (ii = 0; ((ii < blk->insCnt) && (redirect == false)); ii++)
+        {
+            if (blk->noop[ii] == false)
+            {
+                *instr = blk->ins[ii];
+                instr->uniqueID = cpu->instrCounter++;
+                AXP_21264_Ibox_FunctionalRegs(cpu, instr);
+                instr->state = Executing;
+                AXP_Dispatcher(cpu, instr);
+                redirect = AXP_21264_Ibox_FunctionalRetire(cpu, instr);
+            }
+        }
+        cpu->xlateExecuted++;
+
+        /*
+         * If the final instruction did not change the PC, then the next PC
+         * is the one after it.  Otherwise, the retirement has already set it
+         * (a branch was taken or an exception occurred).
+         */
+        taken = redirect;
+        if (redirect == false)
+        {
+            exitPC = blk->ins[blk->insCnt - 1].pc;
+            exitPC.pc++;
+            AXP_21264_AddVPC(cpu, exitPC);
+        }
+        else
+        {
+            exitPC = instr->branchPC;
+        }
+
+        /*
+         * Go back to the Ibox main loop to handle exceptions, interrupts,
+         * mode changes, and every so often, just to make sure it gets a look.
+         */
+        if ((cpu->excPend == true) ||
+            (AXP_21264_Ibox_ExecModeCheck(cpu) == true) ||
+            (cpu->cpuState != Run) ||
+            (++chained >= AXP_XLATE_CHAIN_MAX))
+        {
+            blk = NULL;
+        }
+
+        /*
+         * Follow the chain to the next translated block.  If it is not there,
+         * look it up and chain it for the next time.
+         */
+        else
+        {
+            nextBlk = blk->chain[taken];
+            if ((nextBlk == NULL) ||
+                (nextBlk->valid == false) ||
+                (nextBlk->pc != AXP_GET_PC(exitPC)) ||
+                (nextBlk->asn != asn))
+            {
+                nextBlk = AXP_21264_Xlate_Lookup(cpu, AXP_GET_PC(exitPC), asn);
+                if ((nextBlk != NULL) && (nextBlk->valid == false))
+                {
+                    nextBlk = NULL;
+                }
+                blk->chain[taken] = nextBlk;
+            }
+            blk = nextBlk;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Xlate_Record
+ *  This function is called by the functional mode after each instruction is
+ *  retired, while a block is being recorded.  If the instruction can be
+ *  translated, it is added to the block.  Recording is complete at the first
+ *  branch, an instruction that cannot be translated, or when the block is
+ *  full.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  instr:
+ *      A pointer to the instruction that was just retired.
+ *  predecoded:
+ *      A pointer to the predecoded information for the instruction.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_21264_Xlate_Record(AXP_21264_CPU *cpu,
+                            AXP_INSTRUCTION *instr,
+                            AXP_ICACHE_PREDECODE *predecoded)
+{
+    AXP_XLATE_BLOCK *blk = cpu->xlateRec;
+    u64 expectedPC = blk->pc + (blk->insCnt * sizeof(AXP_INS_FMT));
+    bool xlate;
+
+    /*
+     * Determine if this instruction can be translated.  It has to be the next
+     * one in the block and have completed without an exception.
+     */
+    xlate = (AXP_GET_PC(instr->pc) == expectedPC) &&
+            (instr->pc.pal == 0) &&
+            (instr->excRegMask == NoException);
+    if ((xlate == true) && (predecoded->noop == false))
+    {
+        xlate = (predecoded->slot == AXP_PREDECODE_NO_SLOT) &&
+                (predecoded->whichQueue == AXP_IQ) &&
+                (predecoded->stall == false);
+        switch (instr->opcode)
+        {
+            case PAL00:
+            case MISC:
+            case HW_MFPR:
+            case HW_LD:
+            case HW_MTPR:
+            case HW_RET:
+            case HW_ST:
+                xlate = false;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    /*
+     * If it can, add it to the block.
+     */
+    if (xlate == true)
+    {
+        blk->ins[blk->insCnt] = *instr;
+        blk->noop[blk->insCnt] = predecoded->noop;
+        blk->insCnt++;
+    }
+
+    /*
+     * If this instruction ends the block, we are done recording.
+     */
+    if ((xlate == false) ||
+        (instr->type == Branch) ||
+        (blk->insCnt == AXP_XLATE_MAX_INS))
+    {
+        AXP_21264_Xlate_Finish(cpu);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Xlate_Flush
+ *  This function is called to discard all the translated blocks.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_21264_Xlate_Flush(AXP_21264_CPU *cpu)
+{
+    u32 ii;
+
+    if (AXP_IBOX_OPT1)
+    {
+        AXP_TRACE_BEGIN();
+        AXP_TraceWrite("AXP_21264_Xlate_Flush called (%llu translated, %llu "
+                       "executed)",
+                       cpu->xlateTranslated,
+                       cpu->xlateExecuted);
+        AXP_TRACE_END();
+    }
+
+    for (ii = 0; ii < AXP_XLATE_BLOCKS; ii++)
+    {
+        cpu->xlate[ii].valid = false;
+        cpu->xlate[ii].count = 0;
+        cpu->xlate[ii].chain[0] = NULL;
+        cpu->xlate[ii].chain[1] = NULL;
+    }
+    memset(cpu->xlatePages, 0, sizeof(cpu->xlatePages));
+    cpu->xlateRec = NULL;
+    cpu->xlateFlushes++;
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Xlate_CodeWrite
+ *  This function is called when a store is written to memory.  If the
+ *  physical page may contain translated instructions, all the translated
+ *  blocks are discarded.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  pa:
+ *      A value for the physical address being written.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_21264_Xlate_CodeWrite(AXP_21264_CPU *cpu, u64 pa)
+{
+    u64 page = (pa / AXP_21264_PAGE_SIZE) % AXP_XLATE_PAGES;
+
+    if ((cpu->xlatePages[page / 64] & (1ll << (page % 64))) != 0)
+    {
+        AXP_21264_Xlate_Flush(cpu);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
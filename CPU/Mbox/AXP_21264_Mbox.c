@@ -44,6 +44,40 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.005 15-Oct-2026 Jonathan D. Belanger
+ *  A retired store to a page containing translated instructions discards the
+ *  translated blocks.
+ *
+ *  V01.006 16-Oct-2026 Jonathan D. Belanger
+ *  Count the stores that miss the Dcache in the performance counters.
+ *
+ *  V01.007 16-Oct-2026 Jonathan D. Belanger
+ *  The Mbox now keeps work lists of the LQ and SQ entries that have something
+ *  to be done, rather than looking at every entry each time it is signaled.
+ *  The completion routine (Ebox or Fbox) is determined when the entry is
+ *  assigned.  A completed store is now only completed once, and an entry that
+ *  faulted is no longer retried until the instruction is executed again.
+ *
+ *  V01.008 16-Oct-2026 Jonathan D. Belanger
+ *  Loads now get their data from older stores still in the SQ, which are
+ *  found by quadword address, a byte at a time, so that partial overlaps are
+ *  handled (the data was previously only taken from a store to the same
+ *  address, and incorrectly).  LQ entries are now kept until the load is
+ *  retired, so that a store whose address becomes known after a younger load
+ *  to the same bytes has read its data can have the load replayed.
+ *
+ *  V01.009 16-Oct-2026 Jonathan D. Belanger
+ *  Added AXP_21264_Mbox_SlotAvailable, so that the Ibox can stall decoding a
+ *  load or store when the LQ or SQ is full.  An aborted load or store that
+ *  faults when it is initialized gives its entry back.
+ *
+ *  V01.010 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped a line longer than 80 columns.
+ *
+ *  V01.011 16-Oct-2026 Jonathan D. Belanger
+ *  Added AXP_21264_Mbox_QueuesEmpty, so that the Ibox can tell when all the
+ *  loads and stores have drained before changing the execution mode.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Mbox/AXP_21264_Mbox.h"
@@ -51,8 +85,225 @@
 #include "CPU/Ebox/AXP_21264_Ebox.h"
 #include "CPU/Fbox/AXP_21264_Fbox.h"
 #include "CPU/Cbox/AXP_21264_Cbox.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Translate.h"
 #include "CommonUtilities/AXP_Trace.h"
 
+/*
+ * AXP_21264_Mbox_SetState
+ *  This function is called to change the state of an LQ or SQ entry.  The
+ *  entry is removed from the work list for its old state and, if the Mbox has
+ *  something to do in the new state, added to the work list for that state.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  load:
+ *      A value indicating whether the entry is in the LQ (true) or SQ (false).
+ *  entry:
+ *      The value of the index into the LQ or SQ.
+ *  state:
+ *      A value indicating the new state for the entry.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ *
+ * NOTE: When we are called, the Mbox mutex is already locked.  No need to lock
+ * it here.
+ */
+static void AXP_21264_Mbox_SetState(AXP_21264_CPU *cpu,
+                                    bool load,
+                                    u32 entry,
+                                    AXP_MBOX_QUEUE_STATE state)
+{
+    u32 *work = (load == true) ? cpu->lqWork : cpu->sqWork;
+    u32 bit = 1 << entry;
+    int ii;
+
+    for (ii = 0; ii < AXP_MBOX_WORK_MAX; ii++)
+    {
+        work[ii] &= ~bit;
+    }
+    switch (state)
+    {
+        case Initial:
+            work[AXP_MBOX_WORK_INITIAL] |= bit;
+            break;
+
+        case LQReadPending:
+        case SQWritePending:
+            work[AXP_MBOX_WORK_PENDING] |= bit;
+            break;
+
+        case LQComplete:
+        case SQComplete:
+            work[AXP_MBOX_WORK_COMPLETE] |= bit;
+            break;
+
+        default:
+            break;
+    }
+    if (load == true)
+    {
+        cpu->lq[entry].state = state;
+    }
+    else
+    {
+        cpu->sq[entry].state = state;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Mbox_TakeWork
+ *  This function is called to take the oldest entry off of one of the work
+ *  lists.  An entry that is no longer in the state for the work list (the
+ *  Ibox gave the entry back before the Mbox got to it) is discarded.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  load:
+ *      A value indicating whether to take from the LQ (true) or SQ (false)
+ *      work lists.
+ *  list:
+ *      A value indicating the work list to take the entry from.
+ *
+ * Output Parameters:
+ *  entry:
+ *      A pointer to the location to receive the index into the LQ or SQ.
+ *
+ * Return Value:
+ *  true:   An entry was taken off the work list.
+ *  false:  The work list is empty.
+ *
+ * NOTE: When we are called, the Mbox mutex is already locked.  No need to lock
+ * it here.
+ */
+static bool AXP_21264_Mbox_TakeWork(AXP_21264_CPU *cpu,
+                                    bool load,
+                                    AXP_MBOX_WORK list,
+                                    u8 *entry)
+{
+    u32 *work = (load == true) ? &cpu->lqWork[list] : &cpu->sqWork[list];
+    AXP_MBOX_QUEUE *queue = (load == true) ? cpu->lq : cpu->sq;
+    AXP_MBOX_QUEUE_STATE state;
+    bool retVal = false;
+
+    while ((retVal == false) && (*work != 0))
+    {
+        *entry = __builtin_ctz(*work);
+        *work &= *work - 1;
+        state = queue[*entry].state;
+        switch (list)
+        {
+            case AXP_MBOX_WORK_INITIAL:
+                retVal = state == Initial;
+                break;
+
+            case AXP_MBOX_WORK_PENDING:
+                retVal = (state == LQReadPending) || (state == SQWritePending);
+                break;
+
+            default:
+                retVal = (state == LQComplete) || (state == SQComplete);
+                break;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Mbox_SlotAvailable
+ *  This function is called by the Ibox to determine if there is an LQ or SQ
+ *  slot available, before decoding a load or store.  Only the Ibox assigns
+ *  slots, so a slot that is available when we return is still available when
+ *  the Ibox goes to get it.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  load:
+ *      A value of true indicates the LQ, otherwise the SQ.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   There is a slot available.
+ *  false:  The queue is full.
+ */
+bool AXP_21264_Mbox_SlotAvailable(AXP_21264_CPU *cpu, bool load)
+{
+    pthread_mutex_t *mutex = (load == true) ? &cpu->lqMutex : &cpu->sqMutex;
+    bool retVal;
+
+    pthread_mutex_lock(mutex);
+    if (load == true)
+    {
+        retVal = cpu->lqNext < AXP_MBOX_QUEUE_LEN;
+    }
+    else
+    {
+        retVal = cpu->sqNext < AXP_MBOX_QUEUE_LEN;
+    }
+    pthread_mutex_unlock(mutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Mbox_QueuesEmpty
+ *  This function is called by the Ibox to determine if every LQ and SQ slot
+ *  has been given back, before changing the execution mode.  A slot is given
+ *  back when its instruction is retired, or by the Mbox when its instruction
+ *  was aborted.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The LQ and SQ are empty.
+ *  false:  At least one LQ or SQ slot is still in use.
+ */
+bool AXP_21264_Mbox_QueuesEmpty(AXP_21264_CPU *cpu)
+{
+    bool retVal;
+
+    pthread_mutex_lock(&cpu->lqMutex);
+    retVal = cpu->lqNext == 0;
+    pthread_mutex_unlock(&cpu->lqMutex);
+    pthread_mutex_lock(&cpu->sqMutex);
+    retVal = retVal && (cpu->sqNext == 0);
+    pthread_mutex_unlock(&cpu->sqMutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * AXP_21264_Mbox_GetLQSlot
  *  This function is called to get the next available Load slot.  They are
@@ -72,7 +323,7 @@
  *  The value of the slot to be used for the Load instruction.  If there are no
  *  slots available a value of the size of the LoadQueue will be returned.
  */
-u32 AXP_21264_Mbox_GetLQSlot(AXP_21264_CPU *cpu)
+u32 AXP_21264_Mbox_GetLQSlot(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
     u32 retVal = AXP_MBOX_QUEUE_LEN;
 
@@ -90,6 +341,14 @@ u32 AXP_21264_Mbox_GetLQSlot(AXP_21264_CPU *cpu)
     {
         retVal = cpu->lqNext++;
         cpu->lq[retVal].state = Assigned;
+        if ((instr->opcode >= LDF) && (instr->opcode <= STT))
+        {
+            cpu->lq[retVal].complRtn = AXP_21264_Fbox_Compl;
+        }
+        else
+        {
+            cpu->lq[retVal].complRtn = AXP_21264_Ebox_Compl;
+        }
     }
 
     /*
@@ -215,7 +474,10 @@ void AXP_21264_Mbox_ReadMem(AXP_21264_CPU *cpu,
     cpu->lq[slot].virtAddress = virtAddr;
     cpu->lq[slot].instr = instr;
     cpu->lq[slot].instr->excRegMask = NoException;
-    cpu->lq[slot].state = Initial;
+    cpu->lq[slot].uniqueID = instr->uniqueID;
+    cpu->lq[slot].fwdMask = 0;
+    cpu->lq[slot].replay = false;
+    AXP_21264_Mbox_SetState(cpu, true, slot, Initial);
 
     /*
      * Notify the Mbox that there is something to process and unlock the Mbox
@@ -249,7 +511,7 @@ void AXP_21264_Mbox_ReadMem(AXP_21264_CPU *cpu,
  *  The value of the slot to be used for the Store instruction.  If there are no
  *  slots available a value of the size of the StoreQueue will be returned.
  */
-u32 AXP_21264_Mbox_GetSQSlot(AXP_21264_CPU *cpu)
+u32 AXP_21264_Mbox_GetSQSlot(AXP_21264_CPU *cpu, AXP_INSTRUCTION *instr)
 {
     u32 retVal = AXP_MBOX_QUEUE_LEN;
 
@@ -267,6 +529,14 @@ u32 AXP_21264_Mbox_GetSQSlot(AXP_21264_CPU *cpu)
     {
         retVal = cpu->sqNext++;
         cpu->sq[retVal].state = Assigned;
+        if ((instr->opcode >= LDF) && (instr->opcode <= STT))
+        {
+            cpu->sq[retVal].complRtn = AXP_21264_Fbox_Compl;
+        }
+        else
+        {
+            cpu->sq[retVal].complRtn = AXP_21264_Ebox_Compl;
+        }
     }
 
     /*
@@ -394,7 +664,8 @@ void AXP_21264_Mbox_WriteMem(AXP_21264_CPU *cpu,
     cpu->sq[slot].virtAddress = virtAddr;
     cpu->sq[slot].instr = instr;
     cpu->sq[slot].instr->excRegMask = NoException;
-    cpu->sq[slot].state = Initial;
+    cpu->sq[slot].uniqueID = instr->uniqueID;
+    AXP_21264_Mbox_SetState(cpu, false, slot, Initial);
 
     /*
      * Notify the Mbox that there is something to process and unlock the Mbox
@@ -520,7 +791,7 @@ void AXP_21264_Mbox_CboxCompl(AXP_21264_CPU *cpu,
         signalCond = sqEntry->state == CboxPending;
         if (signalCond == true)
         {
-            sqEntry->state = SQWritePending;
+            AXP_21264_Mbox_SetState(cpu, false, entry, SQWritePending);
         }
     }
     else
@@ -534,7 +805,7 @@ void AXP_21264_Mbox_CboxCompl(AXP_21264_CPU *cpu,
         signalCond = lqEntry->state == CboxPending;
         if (signalCond == true)
         {
-            lqEntry->state = LQReadPending;
+            AXP_21264_Mbox_SetState(cpu, true, entry, LQReadPending);
         }
 
         if (lqEntry->IOflag == true)
@@ -560,10 +831,48 @@ void AXP_21264_Mbox_CboxCompl(AXP_21264_CPU *cpu,
 }
 
 /*
- * AXP_21264_Mbox_TryCaches
- *  This function is called to see if what we are looking to do with the cache
- *  can be done.  It checks the Dcache state and if acceptable, does the things
- *  needed for the Ibox to retire the associated instruction.
+ * AXP_21264_Mbox_ByteMask
+ *  This function is called to convert a mask of the bytes within a quadword
+ *  to a mask of the bits in those bytes.
+ *
+ * Input Parameters:
+ *  bytes:
+ *      A value with a bit set for each byte in the quadword.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  A quadword value with all the bits in each of the bytes set.
+ */
+static u64 AXP_21264_Mbox_ByteMask(u8 bytes)
+{
+    u64 retVal = 0;
+    int ii;
+
+    for (ii = 0; ii < 8; ii++)
+    {
+        if ((bytes & (1 << ii)) != 0)
+        {
+            retVal |= (u64) 0xff << (ii * 8);
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Mbox_Forward
+ *  This function is called to get the data for a load from the stores, older
+ *  than the load, that are still in the SQ.  Only the SQ entries in the bucket
+ *  for the quadword being loaded are looked at.  Each byte comes from the
+ *  youngest of the older stores that wrote it, so a load can get its data from
+ *  more than one store.  A store conditional may not succeed, so a load that
+ *  needs bytes from one gets them from the Dcache and is replayed when
+ *  retired (by which time the store conditional has been done).
  *
  * Input Parameters:
  *  cpu:
@@ -573,78 +882,230 @@ void AXP_21264_Mbox_CboxCompl(AXP_21264_CPU *cpu,
  *      The value of the index into the LQ.
  *
  * Output Parameters:
- *  lqEntry:
- *      A pointer to the entry which has been set up so that the instruction
- *      can be retired (either when the data arrives or now).
+ *  data:
+ *      A pointer to the location to receive the quadword, with the forwarded
+ *      bytes in the places they are in memory.
  *
  * Return Value:
- *  None.
+ *  A mask of the bytes, within the quadword, forwarded from the SQ.
  *
  * NOTE: When we are called, the Mbox mutex is already locked.  No need to lock
  * it here.
  */
-void AXP_21264_Mbox_TryCaches(AXP_21264_CPU *cpu, u8 entry)
+static u8 AXP_21264_Mbox_Forward(AXP_21264_CPU *cpu, u8 entry, u64 *data)
 {
     AXP_MBOX_QUEUE *lqEntry = &cpu->lq[entry];
-    AXP_DCACHE_LOC dcacheLoc;
-    u32 cacheStatus;
-    u8 nextOlderStore;
-    int ii;
-    bool olderStore = false;
+    AXP_MBOX_QUEUE *sqEntry;
+    u32 candidates = cpu->sqIndex[AXP_MBOX_SQ_HASH(lqEntry->physAddress)];
+    u32 older = 0;
+    u8 need = AXP_MBOX_BYTES(lqEntry->physAddress, lqEntry->len);
+    u8 bytes;
+    int youngest, ii;
+    u8 retVal = 0;
+
+    *data = 0;
 
     /*
-     * Loop through each of the SQ entries.
+     * Only naturally aligned loads can have their data forwarded.  The others
+     * get an alignment fault from the Dcache.
      */
-    for (ii = 0; ii < AXP_MBOX_QUEUE_LEN; ii++)
+    if ((lqEntry->physAddress & (lqEntry->len - 1)) == 0)
     {
 
         /*
-         * Look deeper at the SQ entries that are in process.
+         * Find the stores, older than the load, to the same quadword.  Those
+         * with a fault are not going to write anything.
          */
-        if ((cpu->sq[ii].state == Initial) ||
-            (cpu->sq[ii].state == CboxPending) ||
-            (cpu->sq[ii].state == SQWritePending) ||
-            (cpu->sq[ii].state == SQComplete))
+        while (candidates != 0)
         {
-
-            /*
-             * If the address for the store matches that for the load and
-             * the length for the store is greater than or equal to the load
-             * and the store is older than the load,, then we can source from
-             * the store (instead of the Dcache and/or Bcache).
-             */
-            if ((lqEntry->virtAddress == cpu->sq[ii].virtAddress) &&
-                (lqEntry->len <= cpu->sq[ii].len) &&
-                (lqEntry->instr->uniqueID < cpu->sq[ii].instr->uniqueID))
+            ii = __builtin_ctz(candidates);
+            candidates &= candidates - 1;
+            sqEntry = &cpu->sq[ii];
+            if (((sqEntry->state == CboxPending) ||
+                 (sqEntry->state == SQWritePending) ||
+                 (sqEntry->state == SQComplete)) &&
+                (sqEntry->IOflag == false) &&
+                (sqEntry->instr->excRegMask == NoException) &&
+                (AXP_MBOX_QW(sqEntry->physAddress) ==
+                 AXP_MBOX_QW(lqEntry->physAddress)) &&
+                AXP_MBOX_OLDER(sqEntry->uniqueID, lqEntry->uniqueID))
             {
+                older |= 1 << ii;
+            }
+        }
 
-                /*
-                 * OK, there may have been multiple stores to the same address,
-                 * so get the most recent older store.  Otherwise, if this is
-                 * the first one, set the index and the flag.
-                 */
-                if ((olderStore == true) &&
-                    (cpu->sq[ii].instr->uniqueID >
-                     cpu->sq[nextOlderStore].instr->uniqueID))
+        /*
+         * Take the bytes still needed from the youngest of the older stores,
+         * until either we have them all or there are no more stores.
+         */
+        while ((older != 0) && (need != 0))
+        {
+            youngest = __builtin_ctz(older);
+            for (ii = youngest + 1; ii < AXP_MBOX_QUEUE_LEN; ii++)
+            {
+                if (((older & (1 << ii)) != 0) &&
+                    AXP_MBOX_OLDER(cpu->sq[youngest].uniqueID,
+                                   cpu->sq[ii].uniqueID))
                 {
-                    nextOlderStore = ii;
+                    youngest = ii;
                 }
-                else if (olderStore == false)
+            }
+            older &= ~(1 << youngest);
+            sqEntry = &cpu->sq[youngest];
+            bytes = AXP_MBOX_BYTES(sqEntry->physAddress, sqEntry->len) & need;
+            if (bytes != 0)
+            {
+                if ((sqEntry->instr->opcode == STL_C) ||
+                    (sqEntry->instr->opcode == STQ_C))
+                {
+                    lqEntry->replay = true;
+                }
+                else
+                {
+                    if (retVal == 0)
+                    {
+                        lqEntry->fwdID = sqEntry->uniqueID;
+                    }
+                    *data |= (sqEntry->value <<
+                              ((sqEntry->physAddress & 0x7) * 8)) &
+                             AXP_21264_Mbox_ByteMask(bytes);
+                    retVal |= bytes;
+                }
+                need &= ~bytes;
+            }
+        }
+    }
+    lqEntry->fwdMask = retVal;
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21264_Mbox_OrderCheck
+ *  This function is called when the physical address of a store becomes
+ *  known.  Any load, younger than the store, that has already read the bytes
+ *  written by the store, without getting them from this store (or a younger
+ *  one), read stale data.  This is the 21264 load-store order trap, and the
+ *  load is marked to be replayed when the Ibox goes to retire it.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  entry:
+ *      The value of the index into the SQ.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ *
+ * NOTE: When we are called, the Mbox mutex is already locked.  No need to lock
+ * it here.
+ */
+static void AXP_21264_Mbox_OrderCheck(AXP_21264_CPU *cpu, u8 entry)
+{
+    AXP_MBOX_QUEUE *sqEntry = &cpu->sq[entry];
+    AXP_MBOX_QUEUE *lqEntry;
+    u8 bytes;
+    int ii;
+
+    for (ii = 0; ii < AXP_MBOX_QUEUE_LEN; ii++)
+    {
+        lqEntry = &cpu->lq[ii];
+        if ((lqEntry->state == LQComplete) &&
+            (lqEntry->IOflag == false) &&
+            (lqEntry->replay == false) &&
+            (lqEntry->instr->excRegMask == NoException) &&
+            (AXP_MBOX_QW(lqEntry->physAddress) ==
+             AXP_MBOX_QW(sqEntry->physAddress)) &&
+            AXP_MBOX_OLDER(sqEntry->uniqueID, lqEntry->uniqueID))
+        {
+            bytes = AXP_MBOX_BYTES(lqEntry->physAddress, lqEntry->len) &
+                    AXP_MBOX_BYTES(sqEntry->physAddress, sqEntry->len);
+            if ((bytes != 0) &&
+                (((bytes & ~lqEntry->fwdMask) != 0) ||
+                 AXP_MBOX_OLDER(lqEntry->fwdID, sqEntry->uniqueID)))
+            {
+                lqEntry->replay = true;
+                if (AXP_MBOX_OPT2)
                 {
-                    nextOlderStore = ii;
-                    olderStore = true;
+                    AXP_TRACE_BEGIN();
+                    AXP_TraceWrite("Mbox load at pc 0x%016llx to be replayed "
+                                   "for store at pc 0x%016llx, pa 0x%016llx",
+                                   AXP_GET_PC(lqEntry->instr->pc),
+                                   AXP_GET_PC(sqEntry->instr->pc),
+                                   sqEntry->physAddress);
+                    AXP_TRACE_END();
                 }
             }
         }
     }
 
     /*
-     * IF we didn't find an older store, we need to see if the information we
-     * need is in the Dcache or Bcache and in the proper state.
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21264_Mbox_TryCaches
+ *  This function is called to see if what we are looking to do with the cache
+ *  can be done.  The data is first looked for in the older stores still in the
+ *  SQ.  If it is not all there, then we check the Dcache state and if
+ *  acceptable, read the rest from it.  Either way, we do the things needed for
+ *  the Ibox to retire the associated instruction.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  entry:
+ *      The value of the index into the LQ.
+ *
+ * Output Parameters:
+ *  lqEntry:
+ *      A pointer to the entry which has been set up so that the instruction
+ *      can be retired (either when the data arrives or now).
+ *
+ * Return Value:
+ *  None.
+ *
+ * NOTE: When we are called, the Mbox mutex is already locked.  No need to lock
+ * it here.
+ */
+void AXP_21264_Mbox_TryCaches(AXP_21264_CPU *cpu, u8 entry)
+{
+    AXP_MBOX_QUEUE *lqEntry = &cpu->lq[entry];
+    u64 fwdData;
+    u32 cacheStatus;
+    int shift = (lqEntry->physAddress & 0x7) * 8;
+    u8 fwdMask;
+    bool DcHit = false;
+
+    /*
+     * First see how much of the data can be forwarded from older stores.  If
+     * all of it can, then there is no need to look in the caches.
+     */
+    fwdMask = AXP_21264_Mbox_Forward(cpu, entry, &fwdData);
+    if ((fwdMask != 0) &&
+        (fwdMask == AXP_MBOX_BYTES(lqEntry->physAddress, lqEntry->len)))
+    {
+        lqEntry->instr->destv.r.uq = fwdData >> shift;
+        AXP_COUNT(cpu, AXP_CNT_LOAD_FORWARDS);
+        AXP_21264_Mbox_SetState(cpu, true, entry, LQComplete);
+    }
+
+    /*
+     * We need to see if the information we need is in the Dcache or Bcache
+     * and in the proper state.
      */
-    if (olderStore == false)
+    else
     {
-        bool DcHit = false;
 
         /*
          * Get the status for the Dcache for the current Va/PA pair.
@@ -655,7 +1116,7 @@ void AXP_21264_Mbox_TryCaches(AXP_21264_CPU *cpu, u8 entry)
                                                        lqEntry->len,
                                                        true,
                                                        &cacheStatus,
-                                                       &dcacheLoc,
+                                                       &lqEntry->dcacheLoc,
                                                        false);
 
         /*
@@ -673,11 +1134,12 @@ void AXP_21264_Mbox_TryCaches(AXP_21264_CPU *cpu, u8 entry)
             /*
              * Missed both Caches (Dcache and Bcache).  Put an entry in the
              * Missed Address File (MAF) for the Cbox to process.  There is
-             * nothing else for us to do here.
+             * nothing else for us to do here.  When the data arrives, we will
+             * be called again, and the stores looked at again.
              */
             if (AXP_CACHE_MISS(cacheStatus) == true)
             {
-                lqEntry->state = CboxPending;
+                AXP_21264_Mbox_SetState(cpu, true, entry, CboxPending);
                 AXP_21264_Add_MAF(cpu,
                                   LDx,
                                   lqEntry->physAddress,
@@ -698,7 +1160,9 @@ void AXP_21264_Mbox_TryCaches(AXP_21264_CPU *cpu, u8 entry)
                  * need to evict the current block (possibly the same index and
                  * set, but not the same physical tag).
                  */
-                AXP_CopyBcacheToDcache(cpu, &dcacheLoc, lqEntry->physAddress);
+                AXP_CopyBcacheToDcache(cpu,
+                                       &lqEntry->dcacheLoc,
+                                       lqEntry->physAddress);
                 DcHit = true;
             }
         }
@@ -706,7 +1170,8 @@ void AXP_21264_Mbox_TryCaches(AXP_21264_CPU *cpu, u8 entry)
             DcHit = true;
 
         /*
-         * If we hit in the Dcache, them read the data out of it.
+         * If we hit in the Dcache, them read the data out of it.  Any bytes
+         * forwarded from the SQ replace those read from the Dcache.
          */
         if (DcHit == true)
         {
@@ -717,36 +1182,16 @@ void AXP_21264_Mbox_TryCaches(AXP_21264_CPU *cpu, u8 entry)
                                   lqEntry->len,
                                   &lqEntry->instr->destv.r,
                                   NULL);
-            lqEntry->state = LQComplete;
-        }
-    }
-
-    /*
-     * We found what we were looking for in a store that is older than the load
-     * currently being processed.
-     */
-    else
-    {
-        lqEntry->instr->destv.r.uq = 0;
-        switch (lqEntry->len)
-        {
-            case 1:
-                lqEntry->instr->destv.r.ub = *((u8 *) &cpu->sq[nextOlderStore].value);
-                break;
-
-            case 2:
-                lqEntry->instr->destv.r.uw = *((u16 *) cpu->sq[nextOlderStore].value);
-                break;
-
-            case 4:
-                lqEntry->instr->destv.r.ul = *((u32 *) cpu->sq[nextOlderStore].value);
-                break;
-
-            case 8:
-                lqEntry->instr->destv.r.uq = *((u64 *) cpu->sq[nextOlderStore].value);
-                break;
+            if (fwdMask != 0)
+            {
+                lqEntry->instr->destv.r.uq =
+                    (lqEntry->instr->destv.r.uq &
+                     ~(AXP_21264_Mbox_ByteMask(fwdMask) >> shift)) |
+                    (fwdData >> shift);
+                AXP_COUNT(cpu, AXP_CNT_LOAD_FORWARDS);
+            }
+            AXP_21264_Mbox_SetState(cpu, true, entry, LQComplete);
         }
-        lqEntry->state = LQComplete;
     }
     return;
 }
@@ -849,7 +1294,8 @@ void AXP_21264_Mbox_LQ_Init(AXP_21264_CPU *cpu, u8 entry)
          */
         if (lqEntry->IOflag == false)
         {
-            lqEntry->state = LQReadPending; /* We'll start with this value */
+            /* We'll start with this value */
+            AXP_21264_Mbox_SetState(cpu, true, entry, LQReadPending);
             AXP_21264_Mbox_TryCaches(cpu, entry);
         }
 
@@ -859,7 +1305,7 @@ void AXP_21264_Mbox_LQ_Init(AXP_21264_CPU *cpu, u8 entry)
          */
         else
         {
-            lqEntry->state = CboxPending;
+            AXP_21264_Mbox_SetState(cpu, true, entry, CboxPending);
             AXP_21264_Add_MAF(cpu,
                               LDx,
                               lqEntry->physAddress,
@@ -892,11 +1338,21 @@ void AXP_21264_Mbox_LQ_Init(AXP_21264_CPU *cpu, u8 entry)
          * If the fault that occurred is DFAULT, then we found the DTB entry,
          * but the privileges on it were not what is needed to complete the
          * instruction.  For the other possible exceptions, we should get
-         * called back.
+         * called back, so the entry goes back to waiting for the load to be
+         * requested again.  A load that has already been aborted is never
+         * going to be requested again, so its entry is given back.
          */
         if (fault == AXP_DFAULT)
         {
-            lqEntry->state = LQComplete;
+            AXP_21264_Mbox_SetState(cpu, true, entry, LQComplete);
+        }
+        else if (lqEntry->instr->state == Aborted)
+        {
+            AXP_21264_Mbox_PutLQSlot(cpu, entry);
+        }
+        else
+        {
+            AXP_21264_Mbox_SetState(cpu, true, entry, Assigned);
         }
     }
 
@@ -1027,7 +1483,8 @@ void AXP_21264_Mbox_SQ_Pending(AXP_21264_CPU *cpu, u8 entry)
                   AXP_CACHE_DIRTY_SHARED(cacheStatus));
         if (DcHit == false)
         {
-            sqEntry->state = CboxPending;
+            AXP_COUNT(cpu, AXP_CNT_DCACHE_WRITE_MISSES);
+            AXP_21264_Mbox_SetState(cpu, false, entry, CboxPending);
             if ((sqEntry->instr->opcode == STL_C) ||
                 (sqEntry->instr->opcode == STQ_C))
             {
@@ -1060,7 +1517,7 @@ void AXP_21264_Mbox_SQ_Pending(AXP_21264_CPU *cpu, u8 entry)
              */
             if (DcW == false)
             {
-                sqEntry->state = CboxPending;
+                AXP_21264_Mbox_SetState(cpu, false, entry, CboxPending);
                 if ((sqEntry->instr->opcode == STL_C) ||
                     (sqEntry->instr->opcode == STQ_C))
                 {
@@ -1085,7 +1542,7 @@ void AXP_21264_Mbox_SQ_Pending(AXP_21264_CPU *cpu, u8 entry)
              */
             else
             {
-                sqEntry->state = SQComplete;
+                AXP_21264_Mbox_SetState(cpu, false, entry, SQComplete);
             }
         }
     }
@@ -1106,7 +1563,7 @@ void AXP_21264_Mbox_SQ_Pending(AXP_21264_CPU *cpu, u8 entry)
                              sqEntry->instr->aSrc1,
                              true,
                              false);
-        sqEntry->state = SQComplete;
+        AXP_21264_Mbox_SetState(cpu, false, entry, SQComplete);
     }
 
     /*
@@ -1232,7 +1689,23 @@ void AXP_21264_Mbox_SQ_Init(AXP_21264_CPU *cpu, u8 entry)
          */
         if (sqEntry->IOflag == false)
         {
-            sqEntry->state = SQWritePending; /* We'll start with this value */
+            u32 bit = 1 << entry;
+            int ii;
+
+            /*
+             * Put the entry into the bucket for its address, so that younger
+             * loads can find it, and see if any of them has already read
+             * stale data.
+             */
+            for (ii = 0; ii < AXP_MBOX_SQ_HASH_LEN; ii++)
+            {
+                cpu->sqIndex[ii] &= ~bit;
+            }
+            cpu->sqIndex[AXP_MBOX_SQ_HASH(sqEntry->physAddress)] |= bit;
+            AXP_21264_Mbox_OrderCheck(cpu, entry);
+
+            /* We'll start with this value */
+            AXP_21264_Mbox_SetState(cpu, false, entry, SQWritePending);
             AXP_21264_Mbox_SQ_Pending(cpu, entry);
         }
 
@@ -1248,7 +1721,7 @@ void AXP_21264_Mbox_SQ_Init(AXP_21264_CPU *cpu, u8 entry)
                                -(entry + 1), /* We need to take zero out of play */
                                (u8 *) &sqEntry->value,
                                sqEntry->len);
-            sqEntry->state = SQComplete;
+            AXP_21264_Mbox_SetState(cpu, false, entry, SQComplete);
         }
     }
     else
@@ -1275,11 +1748,21 @@ void AXP_21264_Mbox_SQ_Init(AXP_21264_CPU *cpu, u8 entry)
          * If the fault that occurred is DFAULT, then we found the DTB entry,
          * but the privileges on it were not what is needed to complete the
          * instruction.  For the other possible exceptions, we should get
-         * called back.
+         * called back, so the entry goes back to waiting for the store to be
+         * requested again.  A store that has already been aborted is never
+         * going to be requested again, so its entry is given back.
          */
         if (fault == AXP_DFAULT)
         {
-            sqEntry->state = SQComplete;
+            AXP_21264_Mbox_SetState(cpu, false, entry, SQComplete);
+        }
+        else if (sqEntry->instr->state == Aborted)
+        {
+            AXP_21264_Mbox_PutSQSlot(cpu, entry);
+        }
+        else
+        {
+            AXP_21264_Mbox_SetState(cpu, false, entry, Assigned);
         }
     }
 
@@ -1292,9 +1775,11 @@ void AXP_21264_Mbox_SQ_Init(AXP_21264_CPU *cpu, u8 entry)
 /*
  * AXP_21264_Mbox_Process_Q
  *  This function is called because we just received and indication that one or
- *  more entries in the LQ and/or SQ require processed.  This function searches
- *  through all the entries and determines the next processing that is
- *  required.
+ *  more entries in the LQ and/or SQ require processed.  This function takes
+ *  the entries off of the work lists, oldest first, and performs the next
+ *  processing that is required.  Entries that complete are put on the work
+ *  list of completed entries, and completed before we return.  New stores are
+ *  looked at first, so that loads can have their data forwarded from them.
  *
  * Input Parameters:
  *  cpu:
@@ -1312,122 +1797,79 @@ void AXP_21264_Mbox_SQ_Init(AXP_21264_CPU *cpu, u8 entry)
  */
 void AXP_21264_Mbox_Process_Q(AXP_21264_CPU *cpu)
 {
-    u32 ii;
+    u8 entry;
 
     /*
-     * First the Load Queue (LQ) entries.
+     * First the new Store Queue (SQ) entries, so that we know where they are
+     * going to write.
      */
-    for (ii = 0; ii < AXP_MBOX_QUEUE_LEN; ii++)
+    while (AXP_21264_Mbox_TakeWork(cpu, false, AXP_MBOX_WORK_INITIAL, &entry))
     {
-        switch (cpu->lq[ii].state)
-        {
-            case Initial:
-                AXP_21264_Mbox_LQ_Init(cpu, ii);
-                break;
-
-            case LQReadPending:
-                if (cpu->lq[ii].IOflag == false)
-                {
-                    AXP_21264_Mbox_TryCaches(cpu, ii);
-                }
-                else
-                {
-                    cpu->lq[ii].instr->destv.r.uq = cpu->lq[ii].IOdata;
-                    cpu->lq[ii].state = LQComplete;
-                }
-                break;
+        AXP_21264_Mbox_SQ_Init(cpu, entry);
+    }
 
-            default:
-                /* nothing to be done */
-                break;
+    /*
+     * Then the Load Queue (LQ) entries.  New entries are initialized, and
+     * those that are ready have their data read.
+     */
+    while (AXP_21264_Mbox_TakeWork(cpu, true, AXP_MBOX_WORK_INITIAL, &entry))
+    {
+        AXP_21264_Mbox_LQ_Init(cpu, entry);
+    }
+    while (AXP_21264_Mbox_TakeWork(cpu, true, AXP_MBOX_WORK_PENDING, &entry))
+    {
+        if (cpu->lq[entry].IOflag == false)
+        {
+            AXP_21264_Mbox_TryCaches(cpu, entry);
         }
-
-        /*
-         * Because the above calls can and do complete LQ entries by the time
-         * they return.  If the state of the entry is now Complete, then call
-         * the code to finish up with this request and get it back to the Ebox
-         * or Fbox.
-         */
-        if (cpu->lq[ii].state == LQComplete)
+        else
         {
-            void (*complRtn)();
-
-            /*
-             * We are either completing an Integer Load or a Floating-Point
-             * Load.  Select the completion routine, based on the instruction
-             * type.
-             */
-            if ((cpu->lq[ii].instr->opcode == LDBU) ||
-                (cpu->lq[ii].instr->opcode == LDW_U) ||
-                (cpu->lq[ii].instr->opcode == LDL) ||
-                (cpu->lq[ii].instr->opcode == LDL_L) ||
-                (cpu->lq[ii].instr->opcode == LDQ) ||
-                (cpu->lq[ii].instr->opcode == LDQ_U) ||
-                (cpu->lq[ii].instr->opcode == LDQ_L) ||
-                (cpu->lq[ii].instr->opcode == HW_LD))
-            {
-                complRtn = AXP_21264_Ebox_Compl;
-            }
-            else
-            {
-                complRtn = AXP_21264_Fbox_Compl;
-            }
-            complRtn(cpu, cpu->lq[ii].instr);
-            AXP_21264_Mbox_PutLQSlot(cpu, ii);
+            cpu->lq[entry].instr->destv.r.uq = cpu->lq[entry].IOdata;
+            AXP_21264_Mbox_SetState(cpu, true, entry, LQComplete);
         }
     }
 
     /*
-     * Last the store Queue (SQ) entries.
+     * The above calls can and do complete LQ entries by the time they return.
+     * For each completed entry, call the code to finish up with this request
+     * and get it back to the Ebox or Fbox.  The entry stays in the LQ, in the
+     * LQComplete state, until the Ibox retires the load, so that older stores
+     * can still check it.  The entry for an aborted load is given back now.
      */
-    for (ii = 0; ii < AXP_MBOX_QUEUE_LEN; ii++)
+    while (AXP_21264_Mbox_TakeWork(cpu, true, AXP_MBOX_WORK_COMPLETE, &entry))
     {
-        switch (cpu->sq[ii].state)
+        if (cpu->lq[entry].instr->state == Aborted)
         {
-            case Initial:
-                AXP_21264_Mbox_SQ_Init(cpu, ii);
-                break;
-
-            case SQWritePending:
-                AXP_21264_Mbox_SQ_Pending(cpu, ii);
-                break;
+            AXP_21264_Mbox_PutLQSlot(cpu, entry);
+        }
+        else
+        {
+            cpu->lq[entry].complRtn(cpu, cpu->lq[entry].instr);
+        }
+    }
 
-            default:
-                /* nothing to be done */
-                break;
+    /*
+     * Last the rest of the Store Queue (SQ) entries.
+     */
+    while (AXP_21264_Mbox_TakeWork(cpu, false, AXP_MBOX_WORK_PENDING, &entry))
+    {
+        AXP_21264_Mbox_SQ_Pending(cpu, entry);
+    }
 
+    /*
+     * Completed stores are only completed once.  The entry stays in the SQ,
+     * in the SQComplete state, until the Ibox retires the store.  The entry
+     * for an aborted store is given back now.
+     */
+    while (AXP_21264_Mbox_TakeWork(cpu, false, AXP_MBOX_WORK_COMPLETE, &entry))
+    {
+        if (cpu->sq[entry].instr->state == Aborted)
+        {
+            AXP_21264_Mbox_PutSQSlot(cpu, entry);
         }
-
-        /*
-         * Because the above calls can and do complete SQ entries by the time
-         * they return.  If the state of the entry is now Complete, then call
-         * the code to finish up with this request and get it back to the Ibox.
-         */
-        if (cpu->sq[ii].state == SQComplete)
+        else
         {
-            void (*complRtn)();
-
-            /*
-             * We are either completing an Integer Store or a Floating-Point
-             * store.  Use the instruction to determine which completion
-             * function to call (Ebox - Integer or Fbox - Floating-point).
-             */
-            if ((cpu->sq[ii].instr->opcode == STB) ||
-                (cpu->sq[ii].instr->opcode == STW) ||
-                (cpu->sq[ii].instr->opcode == STL) ||
-                (cpu->sq[ii].instr->opcode == STL_C) ||
-                (cpu->sq[ii].instr->opcode == STQ) ||
-                (cpu->sq[ii].instr->opcode == STQ_U) ||
-                (cpu->sq[ii].instr->opcode == STQ_C) ||
-                (cpu->sq[ii].instr->opcode == HW_ST))
-            {
-                complRtn = AXP_21264_Ebox_Compl;
-            }
-            else
-            {
-                complRtn = AXP_21264_Fbox_Compl;
-            }
-            complRtn(cpu, cpu->sq[ii].instr);
+            cpu->sq[entry].complRtn(cpu, cpu->sq[entry].instr);
         }
     }
     return;
@@ -1460,6 +1902,12 @@ void AXP_21264_Mbox_Process_Q(AXP_21264_CPU *cpu)
  */
 void AXP_21264_Mbox_RetireWrite(AXP_21264_CPU *cpu, u8 slot)
 {
+
+    /*
+     * If this is a write to instructions that have been translated, then the
+     * translations need to be discarded.
+     */
+    AXP_21264_Xlate_CodeWrite(cpu, cpu->sq[slot].physAddress);
     AXP_DcacheWrite(cpu,
                     &cpu->sq[slot].dcacheLoc,
                     cpu->sq[slot].len,
@@ -1469,6 +1917,46 @@ void AXP_21264_Mbox_RetireWrite(AXP_21264_CPU *cpu, u8 slot)
     return;
 }
 
+/*
+ * AXP_21264_Mbox_RetireRead
+ *  This function is called by the Ibox when retiring the associated Load.  The
+ *  LQ entry is given back.  If an older store, whose address was not known
+ *  when the load read its data, wrote some of the same bytes, then the load
+ *  read stale data and has to be replayed.  By the time the load is retired,
+ *  all the older stores have been written to the Dcache, so the replayed load
+ *  reads the correct data.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  slot:
+ *      A value indicating the assigned Load Queue (LQ) where this read entry
+ *      was stored.
+ *
+ * Output Parameters:
+ *   None.
+ *
+ * Return Values:
+ *  true:   The load needs to be replayed.
+ *  false:  The load can be retired.
+ *
+ * NOTE:    The Ibox calls this function with no Mbox mutexes locked.  Also,
+ *          this call does not result in a signal to the Mbox.
+ */
+bool AXP_21264_Mbox_RetireRead(AXP_21264_CPU *cpu, u8 slot)
+{
+    bool retVal = cpu->lq[slot].replay;
+
+    cpu->lq[slot].replay = false;
+    AXP_21264_Mbox_PutLQSlot(cpu, slot);
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * AXP_21264_Mbox_WorkQueued
  *  This function is called to determine if there is any work to be processed.
@@ -1492,22 +1980,11 @@ bool AXP_21264_Mbox_WorkQueued(AXP_21264_CPU *cpu)
     int ii;
 
     /*
-     * If anything has been queued up for processing, then return true as soon
-     * as one is found.
+     * If anything is on one of the work lists, then return true.
      */
-    for (ii = 0; ((ii < AXP_MBOX_QUEUE_LEN) && (retVal == false)); ii++)
+    for (ii = 0; ((ii < AXP_MBOX_WORK_MAX) && (retVal == false)); ii++)
     {
-        if (cpu->lq[ii].state == Initial)
-        {
-            retVal = true;
-        }
-    }
-    for (ii = 0; ((ii < AXP_MBOX_QUEUE_LEN) && (retVal == false)); ii++)
-    {
-        if (cpu->sq[ii].state == Initial)
-        {
-            retVal = true;
-        }
+        retVal = (cpu->lqWork[ii] != 0) || (cpu->sqWork[ii] != 0);
     }
 
     /*
@@ -1546,7 +2023,7 @@ void AXP_21264_Mbox_UpdateDcache(AXP_21264_CPU *cpu,
                                  u8 status)
 {
     bool signalCond = false;
-    bool loadFlag = lqSqEntry <= 0;
+    bool loadFlag = lqSqEntry > 0;
     u8 entry = abs(lqSqEntry) - 1;
     AXP_MBOX_QUEUE *qEntry =
             (loadFlag == true) ? &cpu->lq[entry] : &cpu->sq[entry];
@@ -1572,7 +2049,11 @@ void AXP_21264_Mbox_UpdateDcache(AXP_21264_CPU *cpu,
     signalCond = qEntry->state == CboxPending;
     if (signalCond == true)
     {
-        qEntry->state = (loadFlag == true) ? LQReadPending : SQWritePending;
+        AXP_21264_Mbox_SetState(cpu,
+                                loadFlag,
+                                entry,
+                                (loadFlag == true) ?
+                                    LQReadPending : SQWritePending);
     }
 
     /*
@@ -1653,9 +2134,12 @@ bool AXP_21264_Mbox_Init(AXP_21264_CPU *cpu)
         cpu->lq[ii].value = 0;
         cpu->lq[ii].virtAddress = 0;
         cpu->lq[ii].instr = NULL;
+        cpu->lq[ii].complRtn = NULL;
         cpu->lq[ii].state = QNotInUse;
         cpu->lq[ii].IOflag = false;
         cpu->lq[ii].lockCond = false;
+        cpu->lq[ii].fwdMask = 0;
+        cpu->lq[ii].replay = false;
     }
     cpu->lqNext = 0;
     for (ii = 0; ii < AXP_MBOX_QUEUE_LEN; ii++)
@@ -1663,11 +2147,15 @@ bool AXP_21264_Mbox_Init(AXP_21264_CPU *cpu)
         cpu->sq[ii].value = 0;
         cpu->sq[ii].virtAddress = 0;
         cpu->sq[ii].instr = NULL;
+        cpu->sq[ii].complRtn = NULL;
         cpu->sq[ii].state = QNotInUse;
         cpu->sq[ii].IOflag = false;
         cpu->sq[ii].lockCond = false;
     }
     cpu->sqNext = 0;
+    memset(cpu->lqWork, 0, sizeof(cpu->lqWork));
+    memset(cpu->sqWork, 0, sizeof(cpu->sqWork));
+    memset(cpu->sqIndex, 0, sizeof(cpu->sqIndex));
     for (ii = 0; ii < AXP_TB_LEN; ii++)
     {
         cpu->dtb[ii].virtAddr = 0;
@@ -1689,7 +2177,11 @@ bool AXP_21264_Mbox_Init(AXP_21264_CPU *cpu)
         cpu->dtb[ii].asn = 0;
         cpu->dtb[ii]._asm = false;
         cpu->dtb[ii].valid = false;
+        cpu->dtb[ii].gh = 0;
     }
+    memset(&cpu->dtbHash, 0, sizeof(AXP_21264_TLB_HASH));
+    memset(cpu->dtbMicro, 0, sizeof(cpu->dtbMicro));
+    cpu->dtbMicroGen = 0;
     cpu->nextDTB = 0;
     cpu->tbMissOutstanding = false;
     cpu->dtbTag0.res_1 = 0;
@@ -37,6 +37,9 @@
  *  header block will contain a place for the block to be queued up, so that we
  *  can detect when a block is deallocated more than once, or not deallocated
  *  at all.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  A RAW disk handle is now recognized as a valid block.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CommonUtilities/AXP_Blocks.h"
@@ -604,6 +607,8 @@ AXP_BLOCK_TYPE AXP_ReturnType_Block(void *block)
               (head->size == _ssd_blk_size)) ||
              ((head->type == AXP_VHDX_BLK) &&
               (head->size == _vhdx_blk_size)) ||
+             ((head->type == AXP_RAW_BLK) &&
+              (head->size == _raw_blk_size)) ||
              ((head->type == AXP_VOID_BLK) &&
               (head->size >= _head_tail_size))) &&
             (head->magicNumber == AXP_HD_MAGIC) &&
@@ -34,6 +34,27 @@
  *  name, where I will copy the value into a supplied buffer, but since I do
  *  not change the parent to No<Name>, the value is copied into a global
  *  variable, then we return back to the caller, where it does it again.
+ *
+ *  V01.003 15-Oct-2026 Jonathan D. Belanger
+ *  Added parsing of the CPU execution Mode element, which may have a CPU
+ *  number attribute to set the mode of a single CPU.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Added parsing of the CounterFile and CounterInterval elements, which
+ *  specify the CSV file to which the CPU performance counters are written,
+ *  and how often.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Added parsing of the DARRAYs Backing element, which specifies how the host
+ *  memory for the emulated physical memory is obtained.
+ *
+ *  V01.006 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped the CounterFile and per-CPU Mode code to fit in 80 columns.
+ *
+ *  V01.007 16-Oct-2026 Jonathan D. Belanger
+ *  Added parsing of the CPUs ModeSwitch element, which is the number of
+ *  instructions each CPU retires before it switches from its configured
+ *  execution mode to the other one.
  */
 #include "CommonUtilities/AXP_Utility.h"
 #include "CommonUtilities/AXP_Configure.h"
@@ -68,9 +89,14 @@
  *            Count             number
  *            Generation        string
  *            Pass              number
+ *            Mode (number)     Detailed, Functional
+ *            CounterFile       file-specification
+ *            CounterInterval   number (milliseconds)
+ *            ModeSwitch        number (instructions)
  *        DARRAY
  *            Count             number
  *            Size              decimal(MB, GB)
+ *            Backing           Sparse, Huge, Allocate
  *        Disks
  *            *Disk (number)
  *            Type              Disk, CDROM, RWCDROM
@@ -112,8 +138,15 @@ static AXP_21264_CONFIG _axp_21264_config_ =
     .system.cpus.config = NULL,
     .system.cpus.count = 0,
     .system.cpus.minorType = 0,
+    .system.cpus.mode = DetailedMode,
+    .system.cpus.modeSpecified = 0,
+    .system.cpus.modeFunctional = 0,
+    .system.cpus.counterFile = NULL,
+    .system.cpus.counterInterval = 1000,
+    .system.cpus.modeSwitch = 0,
     .system.darrays.size = 0,
-    .system.darrays.count = 0
+    .system.darrays.count = 0,
+    .system.darrays.backing = SparseBacking
 };
 
 /*
@@ -257,12 +290,17 @@ static struct AXP_CPUS _cpu_level_nodes[] =
     {"Count", CPUCount},
     {"Generation", Generation},
     {"Pass", MfgPass},
+    {"Mode", CPUMode},
+    {"CounterFile", CounterFile},
+    {"CounterInterval", CounterInterval},
+    {"ModeSwitch", ModeSwitch},
     {NULL, NoCPUs}
 };
 static struct AXP_DARRAYS _darray_level_nodes[] =
 {
     {"Count", DARRAYCount},
     {"Size", DARRAYSize},
+    {"Backing", DARRAYBacking},
     {NULL, NoDARRAYs}
 };
 static struct AXP_Disks _disks_level_nodes[] =
@@ -2108,8 +2146,12 @@ static void parse_disks_names(xmlDocPtr doc,
  *    <DARRAYs>
  *        <Count>4</Count>
  *        <Size>4.0GB</Size>
+ *        <Backing>Sparse</Backing>
  *    </DARRAYs>
  *
+ *  The Backing element is one of Sparse (the default), Huge, or Allocate.  An
+ *  unrecognized value is treated as Sparse.
+ *
  * Input Parameters:
  *  doc:
  *      A pointer to the XML document node being parsed.
@@ -2216,6 +2258,23 @@ static void parse_darrays_names(xmlDocPtr doc,
                     _axp_21264_config_.system.darrays.size = AXP_cvtSizeStr(nodeValue);
                     break;
 
+                case DARRAYBacking:
+                    if (strcmp(nodeValue, "Huge") == 0)
+                    {
+                        _axp_21264_config_.system.darrays.backing = HugeBacking;
+                    }
+                    else if (strcmp(nodeValue, "Allocate") == 0)
+                    {
+                        _axp_21264_config_.system.darrays.backing =
+                            AllocateBacking;
+                    }
+                    else
+                    {
+                        _axp_21264_config_.system.darrays.backing =
+                            SparseBacking;
+                    }
+                    break;
+
                 case NoDARRAYs:
                 default:
                     break;
@@ -2240,8 +2299,20 @@ static void parse_darrays_names(xmlDocPtr doc,
  *        <Count>1</Count>
  *        <Generation>EV68CB</Generation>
  *        <Pass>5</Pass>
+ *        <Mode>Detailed</Mode>
+ *        <Mode number="1">Functional</Mode>
+ *        <CounterFile>DECaxp Counters.csv</CounterFile>
+ *        <CounterInterval>1000</CounterInterval>
+ *        <ModeSwitch>100000000</ModeSwitch>
  *    </CPUs>
  *
+ *  The Mode element without a number attribute sets the execution mode for
+ *  all the CPUs.  With a number attribute, it sets the mode for just that
+ *  CPU.  The CounterFile element turns on the periodic writing of the
+ *  performance counters, every CounterInterval milliseconds.  The ModeSwitch
+ *  element has each CPU switch from its mode to the other one, once it has
+ *  retired that many instructions.
+ *
  * Input Parameters:
  *  doc:
  *      A pointer to the XML document node being parsed.
@@ -2265,9 +2336,11 @@ static void parse_cpus_names(xmlDocPtr doc,
                              char *value)
 {
     xmlNode *cur_node = NULL;
+    xmlAttr *attr;
     char *ptr;
     char nodeValue[80];
     int ii;
+    i32 cpuNum = -1;
     bool found;
 
     /*
@@ -2308,6 +2381,28 @@ static void parse_cpus_names(xmlDocPtr doc,
                     found = true;
                 }
             }
+
+            /*
+             * The Mode element can have a CPU number as part of its
+             * definition.  Get it and convert it.
+             */
+            cpuNum = -1;
+            for (attr = cur_node->properties; attr != NULL; attr = attr->next)
+            {
+                if (strcmp((char *) attr->name, "number") == 0)
+                {
+                    xmlChar *attrVal = xmlNodeListGetString(doc,
+                                                            attr->children,
+                                                            1);
+
+                    AXP_stripXmlString(attrVal);
+                    if (xmlStrlen(attrVal) > 0)
+                    {
+                        cpuNum = strtol((char *) attrVal, &ptr, 10);
+                    }
+                    xmlFree(attrVal);
+                }
+            }
         }
 
         /*
@@ -2364,6 +2459,59 @@ static void parse_cpus_names(xmlDocPtr doc,
                                                                        10);
                     break;
 
+                case CPUMode:
+                    if (cpuNum < 0)
+                    {
+                        if (strcmp(nodeValue, "Functional") == 0)
+                        {
+                            _axp_21264_config_.system.cpus.mode =
+                                FunctionalMode;
+                        }
+                        else
+                        {
+                            _axp_21264_config_.system.cpus.mode = DetailedMode;
+                        }
+                    }
+                    else if (cpuNum < 32)
+                    {
+                        _axp_21264_config_.system.cpus.modeSpecified |=
+                            (1 << cpuNum);
+                        if (strcmp(nodeValue, "Functional") == 0)
+                        {
+                            _axp_21264_config_.system.cpus.modeFunctional |=
+                                (1 << cpuNum);
+                        }
+                        else
+                        {
+                            _axp_21264_config_.system.cpus.modeFunctional &=
+                                ~(1 << cpuNum);
+                        }
+                    }
+                    break;
+
+                case CounterFile:
+                    _axp_21264_config_.system.cpus.counterFile =
+                        AXP_Allocate_Block(
+                            -(strlen(nodeValue) + 1),
+                            _axp_21264_config_.system.cpus.counterFile);
+                    strcpy(_axp_21264_config_.system.cpus.counterFile,
+                           nodeValue);
+                    break;
+
+                case CounterInterval:
+                    _axp_21264_config_.system.cpus.counterInterval =
+                        strtoul(nodeValue, &ptr, 10);
+                    if (_axp_21264_config_.system.cpus.counterInterval == 0)
+                    {
+                        _axp_21264_config_.system.cpus.counterInterval = 1000;
+                    }
+                    break;
+
+                case ModeSwitch:
+                    _axp_21264_config_.system.cpus.modeSwitch =
+                        strtoull(nodeValue, &ptr, 10);
+                    break;
+
                 case NoCPUs:
                 default:
                     break;
@@ -3420,6 +3568,131 @@ u32 AXP_ConfigGet_CPUCount(void)
     return (retVal);
 }
 
+/*
+ * AXP_ConfigGet_CPUMode
+ *  This function is called to return the execution mode for a particular CPU.
+ *  If a mode was not specified for the CPU itself, then the mode for all CPUs
+ *  is returned.
+ *
+ * Input Parameters:
+ *  cpuID:
+ *      A value indicating the CPU for which the execution mode is requested.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  DetailedMode:   The CPU is to be emulated as the pipelined 21264.
+ *  FunctionalMode: The CPU is to execute instructions in order, one at a time.
+ */
+AXP_21264_EXEC_MODE AXP_ConfigGet_CPUMode(u32 cpuID)
+{
+    AXP_21264_EXEC_MODE retVal;
+
+    /*
+     * Lock the interface mutex, get the execution mode, then unlock the
+     * mutex.
+     */
+    pthread_mutex_lock(&_axp_config_mutex_);
+    retVal = _axp_21264_config_.system.cpus.mode;
+    if ((cpuID < 32) &&
+        ((_axp_21264_config_.system.cpus.modeSpecified & (1 << cpuID)) != 0))
+    {
+        if ((_axp_21264_config_.system.cpus.modeFunctional & (1 << cpuID)) != 0)
+        {
+            retVal = FunctionalMode;
+        }
+        else
+        {
+            retVal = DetailedMode;
+        }
+    }
+    pthread_mutex_unlock(&_axp_config_mutex_);
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_ConfigGet_ModeSwitch
+ *  This function is called to return the number of instructions each CPU
+ *  retires before it switches from its configured execution mode to the other
+ *  one.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:      The CPUs never switch execution modes.
+ *  >0:     The number of instructions retired before switching.
+ */
+u64 AXP_ConfigGet_ModeSwitch(void)
+{
+    u64 retVal;
+
+    /*
+     * Lock the interface mutex, get the number of instructions, then unlock
+     * the mutex.
+     */
+    pthread_mutex_lock(&_axp_config_mutex_);
+    retVal = _axp_21264_config_.system.cpus.modeSwitch;
+    pthread_mutex_unlock(&_axp_config_mutex_);
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_ConfigGet_CounterFile
+ *  This function is called to return the name of the CSV file to which the
+ *  CPU performance counters are to be written, and how often.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  counterFile:
+ *      A pointer to a character string to receive the configuration defined
+ *      counter filename.
+ *  interval:
+ *      A pointer to a location to receive the number of milliseconds between
+ *      each time the counters are written.
+ *
+ * Return Values:
+ *  false:  A counter file was not configured.
+ *  true:   A counter file was configured, and returned.
+ */
+bool AXP_ConfigGet_CounterFile(char *counterFile, u32 *interval)
+{
+    bool retVal = false;
+
+    /*
+     * Lock the interface mutex, copy the values into the return variables,
+     * then unlock the mutex.
+     */
+    pthread_mutex_lock(&_axp_config_mutex_);
+    if ((counterFile != NULL) &&
+        (_axp_21264_config_.system.cpus.counterFile != NULL))
+    {
+        strcpy(counterFile, _axp_21264_config_.system.cpus.counterFile);
+        *interval = _axp_21264_config_.system.cpus.counterInterval;
+        retVal = true;
+    }
+    pthread_mutex_unlock(&_axp_config_mutex_);
+
+    /*
+     * Return the outcome back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * AXP_ConfigGet_InitFile
  *  This function is called to return the value of the Initialization filename.
@@ -3704,6 +3977,40 @@ void AXP_ConfigGet_DarrayInfo(u32 *memArrayCnt, u64 *memArraySize)
     return;
 }
 
+/*
+ * AXP_ConfigGet_DarrayBacking
+ *  This function is called to return how the host memory for the Memory
+ *  Arrays is to be obtained.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  SparseBacking:      Reserve the address space, getting the memory on first
+ *                      touch.
+ *  HugeBacking:        As for SparseBacking, but using huge pages.
+ *  AllocateBacking:    Get all the memory when the arrays are allocated.
+ */
+AXP_21264_DARRAY_BACKING AXP_ConfigGet_DarrayBacking(void)
+{
+    AXP_21264_DARRAY_BACKING retVal;
+
+    /*
+     * Lock the interface mutex, get the backing, then unlock the mutex.
+     */
+    pthread_mutex_lock(&_axp_config_mutex_);
+    retVal = _axp_21264_config_.system.darrays.backing;
+    pthread_mutex_unlock(&_axp_config_mutex_);
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * AXP_TraceConfig
  *  This function is called to write out the configuration information to the
@@ -3727,6 +4034,7 @@ void AXP_TraceConfig(void)
     int idx = 0;
     int ii;
     bool configComplete = false;
+    bool functional;
 
     configComplete = ((_axp_21264_config_.owner.first != NULL) &&
                       (_axp_21264_config_.owner.last != NULL) &&
@@ -3805,6 +4113,34 @@ void AXP_TraceConfig(void)
                            _axp_21264_config_.system.cpus.config->majorType);
             AXP_TraceWrite("\t\t\tMinor Type:\t\t%d",
                            _axp_21264_config_.system.cpus.minorType);
+            AXP_TraceWrite("\t\t\tMode:\t\t\t%s",
+                           (_axp_21264_config_.system.cpus.mode ==
+                            FunctionalMode) ? "Functional" : "Detailed");
+            for (ii = 0; ii < 32; ii++)
+            {
+                if ((_axp_21264_config_.system.cpus.modeSpecified &
+                     (1 << ii)) != 0)
+                {
+                    functional =
+                        (_axp_21264_config_.system.cpus.modeFunctional &
+                         (1 << ii)) != 0;
+                    AXP_TraceWrite("\t\t\tCPU %u Mode:\t\t%s",
+                                   ii,
+                                   functional ? "Functional" : "Detailed");
+                }
+            }
+            if (_axp_21264_config_.system.cpus.modeSwitch != 0)
+            {
+                AXP_TraceWrite("\t\t\tMode Switch:\t\t%llu instructions",
+                               _axp_21264_config_.system.cpus.modeSwitch);
+            }
+            if (_axp_21264_config_.system.cpus.counterFile != NULL)
+            {
+                AXP_TraceWrite("\t\t\tCounter File:\t\t%s",
+                               _axp_21264_config_.system.cpus.counterFile);
+                AXP_TraceWrite("\t\t\tCounter Interval:\t%u ms",
+                               _axp_21264_config_.system.cpus.counterInterval);
+            }
             cacheSize = _axp_21264_config_.system.cpus.config->iCacheSize;
             while (cacheSize > ONE_K)
             {
@@ -3864,6 +4200,11 @@ void AXP_TraceConfig(void)
                 idx++;
             }
             AXP_TraceWrite("\t\t\tSize:\t\t\t%llu%s", cacheSize, bytes[idx]);
+            AXP_TraceWrite("\t\t\tBacking:\t\t%s",
+                           (_axp_21264_config_.system.darrays.backing ==
+                            HugeBacking) ? "Huge" :
+                           ((_axp_21264_config_.system.darrays.backing ==
+                             AllocateBacking) ? "Allocate" : "Sparse"));
             AXP_TraceWrite("\t\tNetworks:");
             AXP_TraceWrite("\t\t\tNumber:\t\t\t%u",
                            _axp_21264_config_.system.networkCount);
@@ -37,26 +37,60 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.003 15-Oct-2026 Jonathan D. Belanger
+ *  Replaced the scan of the shared IQ/FQ, under the Ebox/Fbox mutex, with a
+ *  lock-free ring per pipeline.  The Ibox works out which pipelines can
+ *  execute an instruction when it is queued, puts the entry onto just those
+ *  rings, and wakes just those pipelines.  A pipeline keeps the entries it has
+ *  taken off its ring in a private pending list, and claims one for execution
+ *  by atomically swapping its ticket to zero.
+ *
+ *  V01.004 15-Oct-2026 Jonathan D. Belanger
+ *  Instructions are no longer handed to the pipelines until their source
+ *  registers have been written.  The Ibox keeps a wakeup matrix, with a row
+ *  for each physical register, of the IQ/FQ entries waiting on it.  When a
+ *  register is written, only the entries in its row are looked at, so the
+ *  pipelines no longer repeatedly poll the registers of instructions that are
+ *  not ready.  Also fixed AXP_RegistersLoad, which was loading the second
+ *  source register into src1v, using the first source register number.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  The Ibox is signaled that an instruction has completed through
+ *  AXP_21264_Ibox_Completed, which signals it under the Ibox mutex.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CPU/Fbox/AXP_21264_Fbox.h"
 #include "CPU/Ibox/AXP_21264_Ibox.h"
 #include "CPU/Ibox/AXP_21264_Ibox_InstructionInfo.h"
 #include "CommonUtilities/AXP_Trace.h"
+#include "CommonUtilities/AXP_Execute_Box.h"
+#include <sched.h>
 
 #define AXP_PIPE_OPTIONS    10
-static AXP_PIPELINE pipeCond[AXP_PIPE_OPTIONS][3] =
+#define AXP_PIPE_L0         AXP_21264_PIPE_MASK(AXP_21264_EBOX_L0)
+#define AXP_PIPE_L1         AXP_21264_PIPE_MASK(AXP_21264_EBOX_L1)
+#define AXP_PIPE_U0         AXP_21264_PIPE_MASK(AXP_21264_EBOX_U0)
+#define AXP_PIPE_U1         AXP_21264_PIPE_MASK(AXP_21264_EBOX_U1)
+#define AXP_PIPE_FMUL       AXP_21264_PIPE_MASK(AXP_21264_PIPE_FMUL)
+#define AXP_PIPE_FOTH       AXP_21264_PIPE_MASK(AXP_21264_PIPE_FOTH)
+
+/*
+ * The pipelines that are able to execute an instruction, indexed by the
+ * instruction's AXP_PIPELINE value.
+ */
+static const u32 pipeEligible[AXP_PIPE_OPTIONS] =
 {
-    {PipelineNone,  PipelineNone,   PipelineNone},
-    {EboxU0,        EboxU0U1,       EboxL0L1U0U1},
-    {EboxU1,        EboxU0U1,       EboxL0L1U0U1},
-    {PipelineNone,  PipelineNone,   PipelineNone},
-    {EboxL0,        EboxL0L1,       EboxL0L1U0U1},
-    {EboxL1,        EboxL0L1,       EboxL0L1U0U1},
-    {PipelineNone,  PipelineNone,   PipelineNone},
-    {PipelineNone,  PipelineNone,   PipelineNone},
-    {FboxMul,       FboxMul,        FboxMul},
-    {FboxOther,     FboxOther,      FboxOther}
+    0,                                                  /* PipelineNone */
+    AXP_PIPE_U0,                                        /* EboxU0       */
+    AXP_PIPE_U1,                                        /* EboxU1       */
+    AXP_PIPE_U0 | AXP_PIPE_U1,                          /* EboxU0U1     */
+    AXP_PIPE_L0,                                        /* EboxL0       */
+    AXP_PIPE_L1,                                        /* EboxL1       */
+    AXP_PIPE_L0 | AXP_PIPE_L1,                          /* EboxL0L1     */
+    AXP_PIPE_L0 | AXP_PIPE_L1 | AXP_PIPE_U0 | AXP_PIPE_U1, /* EboxL0L1U0U1 */
+    AXP_PIPE_FMUL,                                      /* FboxMul      */
+    AXP_PIPE_FOTH                                       /* FboxOther    */
 };
 static char *pipelineStr[] =
 {
@@ -93,15 +127,15 @@ static char *insStateStr[] =
     "Aborted"
 };
 static char *regStateStr[] = {"Free", "Pending Update", "Valid"};
-static char *eBoxClusterStr[] = {"L0", "L1", "U0", "U1"};
-static char *fBoxClusterStr[] = {"MULTIPLY", "OTHER"};
 
 /*
- * AXP_RegisterReady
- *  This function is called to determine if a queued instruction's registers
- *  are ready for execution.  If one or more registers is waiting for a
- *  previous instruction to finish its execution and store the value this
- *  instruction needs.
+ * AXP_RegistersWaiting
+ *  This function is called by the Ibox, when an instruction is being queued,
+ *  to determine which of the instruction's source registers are still waiting
+ *  for a previous instruction to finish its execution and store the value
+ *  this instruction needs.  The entry is recorded in the wakeup matrix row of
+ *  each of these registers, so that it can be handed to the pipelines when
+ *  the last of them has been written.
  *
  * Input Parameters:
  *  cpu:
@@ -113,22 +147,25 @@ static char *fBoxClusterStr[] = {"MULTIPLY", "OTHER"};
  *      used and which are needed for this instruction.
  *
  * Output Parameters:
- *  None.
+ *  entry:
+ *      The waitCnt field is set to the number of registers being waited on.
  *
  * Return Values:
- *   true:      The registers for instruction execution are ready.
- *   false:     The registers for instruction execution are NOT ready.
+ *   0:         The registers for instruction execution are ready.
+ *   Otherwise: The number of registers being waited on.
  */
-static bool AXP_RegistersReady(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
+static u8 AXP_RegistersWaiting(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
 {
     AXP_REGISTERS *src1Reg;
     AXP_REGISTERS *src2Reg;
     AXP_REGISTERS *destReg;
+    u64 *src1Wake;
+    u64 *src2Wake;
+    u64 bit = 1ULL << entry->wakeBit;
     char *warn = "";
     bool src1Float;
     bool src2Float;
     bool destFloat;
-    bool retVal;
 
     src1Float = ((entry->ins->decodedReg.bits.src1 & AXP_REG_FP) == AXP_REG_FP);
     src2Float = ((entry->ins->decodedReg.bits.src2 & AXP_REG_FP) == AXP_REG_FP);
@@ -137,6 +174,14 @@ static bool AXP_RegistersReady(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
     src1Reg = (src1Float ? cpu->pf : cpu->pr);
     src2Reg = (src2Float ? cpu->pf : cpu->pr);
     destReg = (destFloat ? cpu->pf : cpu->pr);
+    src1Wake = (src1Float ? cpu->pfWake : cpu->prWake);
+    src2Wake = (src2Float ? cpu->pfWake : cpu->prWake);
+
+    /*
+     * The destination register was set to PendingUpdate when it was renamed,
+     * and stays that way until this instruction retires, so there is nothing
+     * to wait for.  It is only checked here to catch renaming problems.
+     */
     if (destReg[entry->ins->dest].state !=
             ((entry->ins->dest == AXP_UNMAPPED_REG) ? Valid : PendingUpdate))
     {
@@ -145,7 +190,7 @@ static bool AXP_RegistersReady(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
     if (AXP_UTL_OPT2)
     {
         AXP_TRACE_BEGIN();
-        AXP_TraceWrite("AXP_RegistersReady checking registers at pc = "
+        AXP_TraceWrite("AXP_RegistersWaiting checking registers at pc = "
                        "0x%016llx, opcode = 0x%02x:",
                        AXP_GET_PC(entry->ins->pc),
                        (u32) entry->ins->opcode);
@@ -171,12 +216,65 @@ static bool AXP_RegistersReady(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
         AXP_TRACE_END();
     }
 
-    retVal = ((src1Reg[entry->ins->src1].state == Valid) &&
-              (src2Reg[entry->ins->src2].state == Valid) &&
-              (destReg[entry->ins->dest].state ==
-                  ((entry->ins->dest == AXP_UNMAPPED_REG) ?
-                          Valid :
-                          PendingUpdate)));
+    /*
+     * Record the entry against each source register that has not been written
+     * yet.  If both sources are the same physical register, it is only waited
+     * on once.
+     */
+    entry->waitCnt = 0;
+    if (src1Reg[entry->ins->src1].state != Valid)
+    {
+        src1Wake[entry->ins->src1] |= bit;
+        entry->waitCnt++;
+    }
+    if ((src2Reg[entry->ins->src2].state != Valid) &&
+        ((src2Wake[entry->ins->src2] & bit) == 0))
+    {
+        src2Wake[entry->ins->src2] |= bit;
+        entry->waitCnt++;
+    }
+    if (entry->waitCnt != 0)
+    {
+        cpu->xqWaiting |= bit;
+    }
+
+    /*
+     * Return the result back to the caller.
+     */
+    return (entry->waitCnt);
+}
+
+/*
+ * AXP_RegistersLoad
+ *  This function is called once a pipeline has claimed a queued instruction
+ *  whose registers are ready, to move the contents of the source registers
+ *  into the location where the instruction execution expects to find them.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the structure containing the information needed to emulate
+ *      a single CPU.
+ *  entry:
+ *      A pointer to the entry containing all the pre-parsed information of the
+ *      instruction.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void AXP_RegistersLoad(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
+{
+    AXP_REGISTERS *src1Reg;
+    AXP_REGISTERS *src2Reg;
+    bool src1Float;
+    bool src2Float;
+
+    src1Float = ((entry->ins->decodedReg.bits.src1 & AXP_REG_FP) == AXP_REG_FP);
+    src2Float = ((entry->ins->decodedReg.bits.src2 & AXP_REG_FP) == AXP_REG_FP);
+    src1Reg = (src1Float ? cpu->pf : cpu->pr);
+    src2Reg = (src2Float ? cpu->pf : cpu->pr);
 
     /*
      * Move the contents of the source registers into the location where the
@@ -192,15 +290,371 @@ static bool AXP_RegistersReady(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
     }
     if (src2Float)
     {
-        entry->ins->src1v.fp.uq = src2Reg[entry->ins->src1].value;
+        entry->ins->src2v.fp.uq = src2Reg[entry->ins->src2].value;
     }
     else
     {
-        entry->ins->src1v.r.uq = src2Reg[entry->ins->src1].value;
+        entry->ins->src2v.r.uq = src2Reg[entry->ins->src2].value;
     }
 
     /*
-     * Return the result back to the caller.
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_Execution_Issue
+ *  This function is called by the Ibox to hand an instruction, whose registers
+ *  are all ready (or which has been aborted), to the pipelines.  The pipelines
+ *  that can execute the instruction are determined here, and the entry is put
+ *  onto the ring of each of those pipelines.  The first one to claim the entry
+ *  gets to execute it.  Only one of those pipelines is signaled, preferring
+ *  one that is not asleep, since that costs no more than an atomic increment.
+ *  A sleeping pipeline that is not signaled will just find the entry already
+ *  claimed when it gets around to it.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure where the instruction queues are
+ *      located.
+ *  entry:
+ *      A pointer to the IQ or FQ entry, with the instruction and pipeline
+ *      already filled in.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void AXP_Execution_Issue(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
+{
+    u32 eligible = pipeEligible[entry->pipeline];
+    u32 ticket;
+    int wake = -1;
+    int ii;
+
+    /*
+     * The Ibox is the only one handing out tickets, so this does not need to
+     * be atomic.  Zero means the entry has been claimed, so skip over it.
+     */
+    if (++cpu->xqTicket == 0)
+    {
+        cpu->xqTicket = 1;
+    }
+    ticket = cpu->xqTicket;
+    __atomic_store_n(&entry->ticket, ticket, __ATOMIC_RELEASE);
+
+    for (ii = 0; ii < AXP_21264_PIPES; ii++)
+    {
+        if ((eligible & AXP_21264_PIPE_MASK(ii)) != 0)
+        {
+
+            /*
+             * The ring can only be full if the pipeline has fallen behind in
+             * taking entries off of it.  It will not stay that way for long.
+             */
+            while ((AXP_SPSCRing_Put(&cpu->pipeQ[ii].ring, entry, ticket) ==
+                    false) &&
+                   (cpu->cpuState != ShuttingDown))
+            {
+                AXP_EventCount_Signal(&cpu->pipeQ[ii].wake);
+                sched_yield();
+            }
+            if ((wake < 0) ||
+                (AXP_EventCount_Sleeping(&cpu->pipeQ[ii].wake) == false))
+            {
+                wake = ii;
+            }
+        }
+    }
+    if (wake >= 0)
+    {
+        AXP_EventCount_Signal(&cpu->pipeQ[wake].wake);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_Execution_Entry
+ *  This function is called to get the IQ or FQ entry for a bit in the wakeup
+ *  matrix.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure where the instruction queues are
+ *      located.
+ *  wakeBit:
+ *      A value of the bit in the wakeup matrix.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  A pointer to the IQ or FQ entry.
+ */
+static inline AXP_QUEUE_ENTRY *AXP_Execution_Entry(AXP_21264_CPU *cpu,
+                                                   u32 wakeBit)
+{
+    return ((wakeBit < AXP_IQ_LEN) ?
+                &cpu->iqEntries[wakeBit] :
+                &cpu->fqEntries[wakeBit - AXP_IQ_LEN]);
+}
+
+/*
+ * AXP_Execution_Enqueue
+ *  This function is called by the Ibox to queue an instruction for execution.
+ *  If all the instruction's source registers are valid, it is handed straight
+ *  to the pipelines.  Otherwise, it is recorded in the wakeup matrix, and is
+ *  handed to the pipelines by AXP_Execution_RegReady, when the last of the
+ *  registers it is waiting on has been written.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure where the instruction queues are
+ *      located.
+ *  entry:
+ *      A pointer to the IQ or FQ entry, with the instruction and pipeline
+ *      already filled in.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_Execution_Enqueue(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
+{
+    if (AXP_RegistersWaiting(cpu, entry) == 0)
+    {
+        AXP_Execution_Issue(cpu, entry);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_Execution_RegReady
+ *  This function is called by the Ibox after it has written a value into a
+ *  physical register and marked it Valid.  Each IQ/FQ entry waiting on that
+ *  register has its wait count decremented, and those with nothing left to
+ *  wait on are handed to the pipelines.  Only the entries that depend upon
+ *  the register are looked at.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure where the instruction queues are
+ *      located.
+ *  physReg:
+ *      A value of the physical register that was just written.
+ *  fpReg:
+ *      A value indicating whether this is a floating-point register.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_Execution_RegReady(AXP_21264_CPU *cpu, u16 physReg, bool fpReg)
+{
+    AXP_QUEUE_ENTRY *entry;
+    u64 *wake = (fpReg ? &cpu->pfWake[physReg] : &cpu->prWake[physReg]);
+    u64 waiting = *wake;
+    u32 wakeBit;
+
+    *wake = 0;
+    while (waiting != 0)
+    {
+        wakeBit = __builtin_ctzll(waiting);
+        waiting &= waiting - 1;
+        entry = AXP_Execution_Entry(cpu, wakeBit);
+        if (--entry->waitCnt == 0)
+        {
+            cpu->xqWaiting &= ~(1ULL << wakeBit);
+            AXP_Execution_Issue(cpu, entry);
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_Execution_Aborted
+ *  This function is called by the Ibox after it has aborted one or more
+ *  instructions.  Any of these still waiting on a register are removed from
+ *  the wakeup matrix and handed to the pipelines, which will return their
+ *  IQ/FQ entries without executing them.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure where the instruction queues are
+ *      located.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_Execution_Aborted(AXP_21264_CPU *cpu)
+{
+    AXP_QUEUE_ENTRY *entry;
+    u64 waiting = cpu->xqWaiting;
+    u64 aborted = 0;
+    u32 wakeBit;
+    int ii;
+
+    while (waiting != 0)
+    {
+        wakeBit = __builtin_ctzll(waiting);
+        waiting &= waiting - 1;
+        entry = AXP_Execution_Entry(cpu, wakeBit);
+        if (entry->ins->state == Aborted)
+        {
+            aborted |= 1ULL << wakeBit;
+            entry->waitCnt = 0;
+            AXP_Execution_Issue(cpu, entry);
+        }
+    }
+    if (aborted != 0)
+    {
+        cpu->xqWaiting &= ~aborted;
+        for (ii = 0; ii < AXP_INT_PHYS_REG; ii++)
+        {
+            cpu->prWake[ii] &= ~aborted;
+        }
+        for (ii = 0; ii < AXP_FP_PHYS_REG; ii++)
+        {
+            cpu->pfWake[ii] &= ~aborted;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_Execution_Claim
+ *  This function is called by a pipeline to claim the next entry the Ibox has
+ *  put onto its ring.  Everything on the ring is ready to be executed, or has
+ *  been aborted.  Entries that some other pipeline has already claimed are
+ *  skipped.
+ *
+ *  NOTE:   HRM 5.2.14 - Ibox Control Register (page 5-18)
+ *
+ *          Single Issue Mode forces instructions to issue only from the
+ *          bottom-most entries of the IQ and FQ.  Entries are put onto the
+ *          rings in the order they become ready, and are taken off in that
+ *          same order, which is as close to this as we get.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure where the instruction queues are
+ *      located.
+ *  pq:
+ *      A pointer to the pipeline queue.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL:       Nothing can be executed by this pipeline right now.
+ *  Otherwise:  A pointer to the entry now owned by this pipeline.
+ */
+static AXP_QUEUE_ENTRY *AXP_Execution_Claim(AXP_21264_CPU *cpu,
+                                            AXP_PIPE_QUEUE *pq)
+{
+    AXP_QUEUE_ENTRY *retVal = NULL;
+    AXP_QUEUE_ENTRY *entry;
+    AXP_SPSC_SLOT slot;
+    u32 ticket;
+
+    while ((retVal == NULL) && (AXP_SPSCRing_Get(&pq->ring, &slot) == true))
+    {
+        entry = (AXP_QUEUE_ENTRY *) slot.item;
+        ticket = slot.tag;
+
+        /*
+         * TODO:    We need to take into account the scoreboard bits.
+         *
+         * HRM: 6.5.1 IPR Scoreboard Bits (page 6-8)
+         *
+         * In previous Alpha implementations, IPR registers were not
+         * scoreboarded in hardware.  Software was required to schedule
+         * HW_MTPR and HW_MFPR instructions for each machine's pipeline
+         * organization in order to ensure correct behavior. This software
+         * scheduling task is more difficult in the 21264 because the Ibox
+         * performs dynamic scheduling. Hence, eight extra scoreboard bits are
+         * used within the IQ to help maintain correct IPR access order. The
+         * HW_MTPR and HW_MFPR instruction formats contain an 8-bit field that
+         * is used as an IPR scoreboard bit mask to specify which of the eight
+         * IPR scoreboard bits are to be applied to the instruction.
+         *
+         * If any of the unmasked scoreboard bits are set when an instruction
+         * is about to enter the IQ, then the instruction, and those behind it,
+         * are stalled outside the IQ until all the unmasked scoreboard bits
+         * are clear and the queue does not contain any implicit or explicit
+         * readers that were dependent on those bits when they entered the
+         * queue. When all the unmasked scoreboard bits are clear, and the
+         * queue does not contain any of those readers, the instruction enters
+         * the IQ and the unmasked scoreboard bits are set.
+         *
+         * HW_MFPR instructions are stalled in the IQ until all their unmasked
+         * IPR scoreboard bits are clear.
+         *
+         * When scoreboard bits [3:0] and [7:4] are set, their effect on other
+         * instructions is different, and they are cleared in a different
+         * manner.  If any of scoreboard bits [3:0] are set when a load or
+         * store instruction enters the IQ, that load or store instruction will
+         * not be issued from the IQ until those scoreboard bits are clear.
+         *
+         * Scoreboard bits [3:0] are cleared when the HW_MTPR instructions that
+         * set them are issued (or are aborted).  Bits [7:4] are cleared when
+         * the HW_MTPR instructions that set them are retired (or are aborted).
+         *
+         * Bits [3:0] are used for the DTB_TAG and DTB_PTE register pairs
+         * within the DTB fill flows. These bits can be used to order writes to
+         * the DTB for load and store instructions.  See Sections 5.3.1 and
+         * 6.9.1.
+         *
+         * Bit [0] is used in both DTB and ITB fill flows to trigger, in
+         * hardware, a lightweight memory barrier (TB-MB) to be inserted
+         * between a LD_VPTE and the corresponding virtual-mode load
+         * instruction that missed in the TB.
+         */
+
+        /*
+         * If the claim fails, another pipeline got here first, and the entry
+         * may even have been reused for another instruction.  Either way, it
+         * is not ours to execute.
+         */
+        if (__atomic_compare_exchange_n(&entry->ticket,
+                                        &ticket,
+                                        0,
+                                        false,
+                                        __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE) == true)
+        {
+            retVal = entry;
+        }
+    }
+
+    /*
+     * Return what we found back to the caller.
      */
     return (retVal);
 }
@@ -209,9 +663,8 @@ static bool AXP_RegistersReady(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
  * AXP_Execution_Box
  *  This function is called by both the Ebox and Fbox.  The processing loops
  *  for both of them are incredibly similar.  The only real differences are the
- *  determination if a particular pipeline is allowed to execute a particular
- *  instruction, and returning a completed instruction queue entry back to the
- *  pool for a subsequent instruction.
+ *  pipeline queue being processed, and returning a completed instruction queue
+ *  entry back to the pool for a subsequent instruction.
  *
  * Input Parameters:
  *  cpu:
@@ -226,13 +679,6 @@ static bool AXP_RegistersReady(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
  *          EboxL1
  *          FboxMul
  *          FboxOther
- *  cond:
- *      A pointer to the condition variable associated with the pipeline.
- *  mutex:
- *      A pointer to the mutex variable associated with the pipeline.
- *  regCheckEntry:
- *      A pointer to the function to determine if the registers are ready for
- *      the instruction to be allowed to execute.
  *  returnEntry:
  *      A pointer to the function to return the dequeued entry back to the
  *      pool for a later instruction to be executed.
@@ -245,64 +691,42 @@ static bool AXP_RegistersReady(AXP_21264_CPU *cpu, AXP_QUEUE_ENTRY *entry)
  */
 void AXP_Execution_Box(AXP_21264_CPU *cpu,
                        AXP_PIPELINE pipeline,
-                       AXP_COUNTED_QUEUE *queue,
-                       pthread_cond_t *cond,
-                       pthread_mutex_t *mutex,
                        void (*returnEntry)(AXP_21264_CPU *, AXP_QUEUE_ENTRY *))
 {
-    AXP_QUEUE_ENTRY *entry, *next;
-    u16 *clusterCounter;
+    AXP_PIPE_QUEUE *pq;
+    AXP_QUEUE_ENTRY *entry;
     AXP_INS_STATE state;
-    int clusterCountIdx;
+    u32 key;
     bool fpEnable;
-    bool eBox;
-    bool nothingReadyForMe = false;
 
     switch (pipeline)
     {
         case EboxL0:
-            clusterCountIdx = AXP_21264_EBOX_L0;
-            clusterCounter = cpu->eBoxClusterCounter;
-            eBox = true;
+            pq = &cpu->pipeQ[AXP_21264_EBOX_L0];
             break;
 
         case EboxL1:
-            clusterCountIdx = AXP_21264_EBOX_L1;
-            clusterCounter = cpu->eBoxClusterCounter;
-            eBox = true;
+            pq = &cpu->pipeQ[AXP_21264_EBOX_L1];
             break;
 
         case EboxU0:
-            clusterCountIdx = AXP_21264_EBOX_U0;
-            clusterCounter = cpu->eBoxClusterCounter;
-            eBox = true;
+            pq = &cpu->pipeQ[AXP_21264_EBOX_U0];
             break;
 
         case EboxU1:
-            clusterCountIdx = AXP_21264_EBOX_U1;
-            clusterCounter = cpu->eBoxClusterCounter;
-            eBox = true;
+            pq = &cpu->pipeQ[AXP_21264_EBOX_U1];
             break;
 
         case FboxMul:
-            clusterCountIdx = AXP_21264_FBOX_MULTIPLY;
-            clusterCounter = cpu->fBoxClusterCounter;
-            eBox = false;
+            pq = &cpu->pipeQ[AXP_21264_PIPE_FMUL];
             break;
 
         case FboxOther:
         default:    /* This is just to keep the compiler from complaining */
-            clusterCountIdx = AXP_21264_FBOX_OTHER;
-            clusterCounter = cpu->fBoxClusterCounter;
-            eBox = false;
+            pq = &cpu->pipeQ[AXP_21264_PIPE_FOTH];
             break;
     }
 
-    /*
-     * Before we go into the loop, lock the E/Fbox mutex.
-     */
-    pthread_mutex_lock(mutex);
-
     /*
      * While we are not shutting down, we'll continue to try and process
      * instructions.
@@ -311,401 +735,140 @@ void AXP_Execution_Box(AXP_21264_CPU *cpu,
     {
 
         /*
-         * Next we need to do is see if there is nothing to process,
-         * then wait for something to get queued up.
+         * Get the event count key before looking for something to do.  If the
+         * Ibox hands us something after this, the wait below will return
+         * straight away.
          */
-        while ((cpu->cpuState != ShuttingDown) &&
-               ((AXP_CountedQueueFull(queue, 0) == 1) ||
-                (clusterCounter[clusterCountIdx] == 0) ||
-                (nothingReadyForMe == true)))
+        key = AXP_EventCount_Prepare(&pq->wake);
+        entry = AXP_Execution_Claim(cpu, pq);
+        if (entry == NULL)
         {
-            nothingReadyForMe = false;
-            pthread_cond_wait(cond, mutex);
             if (AXP_UTL_OPT2)
             {
                 AXP_TRACE_BEGIN();
-                AXP_TraceWrite("%s signaled [%s] = %u.",
-                               pipelineStr[pipeline],
-                               (eBox ? eBoxClusterStr[clusterCountIdx] :
-                                       fBoxClusterStr[clusterCountIdx]),
-                               clusterCounter[clusterCountIdx]);
+                AXP_TraceWrite("%s has nothing to process.",
+                               pipelineStr[pipeline]);
                 AXP_TRACE_END();
             }
+            if (cpu->cpuState != ShuttingDown)
+            {
+                pq->sleeps++;
+                AXP_EventCount_Wait(&pq->wake, key);
+            }
+            continue;
+        }
+        if (AXP_UTL_OPT2)
+        {
+            AXP_TRACE_BEGIN();
+            AXP_TraceWrite("%s claimed "
+                           "pc = 0x%016llx, "
+                           "opcode = 0x%02x, "
+                           "pipeline = %s, "
+                           "state = %s.",
+                           pipelineStr[pipeline],
+                           AXP_GET_PC(entry->ins->pc),
+                           (u32) entry->ins->opcode,
+                           insPipelineStr[entry->pipeline],
+                           insStateStr[entry->ins->state]);
+            AXP_TRACE_END();
         }
 
         /*
-         * If we are not shutting down, then we may have something to process.
-         * Let's go looking for trouble.
+         * First we need to lock the ROB mutex.  We don't want some other
+         * thread changing the contents while we are looking at it.  We are
+         * looking to see if the instruction was aborted.
          */
-        if (cpu->cpuState != ShuttingDown)
+        pthread_mutex_lock(&cpu->robMutex);
+        if ((state = entry->ins->state) == Queued)
         {
+            entry->ins->state = Executing;
+        }
+        pthread_mutex_unlock(&cpu->robMutex);
+        if (state == Aborted)
+        {
+            (*returnEntry)(cpu, entry);
+            continue;
+        }
+        pq->issued++;
 
-            /*
-             * We need to prevent multiple threads trying to update this queue.
-             */
-            AXP_LockCountedQueue(queue);
-            entry = (AXP_QUEUE_ENTRY *) queue->flink;
-
-            /*
-             * Search through the queue of pending integer pipeline
-             * instructions.  If we find one for this cluster, then break out
-             * of this loop.  Otherwise, move on to the next entry in the
-             * queue.  Since the queue eventually points back to the
-             * parent/header, this will exit the loop as well.
-             */
-            while ((AXP_COUNTED_QUEUE *) entry != queue)
-            {
-
-                /*
-                 * TODO:    We need to take into account the scoreboard bits.
-                 *
-                 * HRM: 6.5.1 IPR Scoreboard Bits (page 6-8)
-                 *
-                 * In previous Alpha implementations, IPR registers were not
-                 * scoreboarded in hardware.  Software was required to schedule
-                 * HW_MTPR and HW_MFPR instructions for each machines pipeline
-                 * organization in order to ensure correct behavior. This
-                 * software scheduling task is more difficult in the 21264
-                 * because the Ibox performs dynamic scheduling. Hence, eight
-                 * extra scoreboard bits are used within the IQ to help
-                 * maintain correct IPR access order. The HW_MTPR and HW_MFPR
-                 * instruction formats contain an 8-bit field that is used as
-                 * an IPR scoreboard bit mask to specify which of the eight IPR
-                 * scoreboard bits are to be applied to the instruction.
-                 *
-                 * If any of the unmasked scoreboard bits are set when an
-                 * instruction is about to enter the IQ, then the instruction,
-                 * and those behind it, are stalled outside the IQ until all
-                 * the unmasked scoreboard bits are clear and the queue does
-                 * not contain any implicit or explicit readers that were
-                 * dependent on those bits when they entered the queue. When
-                 * all the unmasked scoreboard bits are clear, and the queue
-                 * does not contain any of those readers, the instruction
-                 * enters the IQ and the unmasked scoreboard bits are set.
-                 *
-                 * HW_MFPR instructions are stalled in the IQ until all their
-                 * unmasked IPR scoreboard bits are clear.
-                 *
-                 * When scoreboard bits [3:0] and [7:4] are set, their effect
-                 * on other instructions is different, and they are cleared in
-                 * a different manner.  If any of scoreboard bits [3:0] are set
-                 * when a load or store instruction enters the IQ, that load or
-                 * store instruction will not be issued from the IQ until those
-                 * scoreboard bits are clear.
-                 *
-                 * Scoreboard bits [3:0] are cleared when the HW_MTPR
-                 * instructions that set them are issued (or are aborted).
-                 * Bits [7:4] are cleared when the HW_MTPR instructions that
-                 * set them are retired (or are aborted).
-                 *
-                 * Bits [3:0] are used for the DTB_TAG and DTB_PTE register
-                 * pairs within the DTB fill flows. These bits can be used to
-                 * order writes to the DTB for load and store instructions.
-                 * See Sections 5.3.1 and 6.9.1.
-                 *
-                 * Bit [0] is used in both DTB and ITB fill flows to trigger,
-                 * in hardware, a lightweight memory barrier (TB-MB) to be
-                 * inserted between a LD_VPTE and the corresponding
-                 * virtual-mode load instruction that missed in the TB.
-                 *
-                 * NOTE: Because of the out-of-order execution of the IQ and
-                 *       FQ, this code needs to keep track of the scoreboard
-                 *       bits as the instruction is considered for execution.
-                 *       What we don't want to happen is have a load/store
-                 *       executed before the HW_MTPR DTB_TAG and DTB_PTE that
-                 *       could change the addresses the load/store utilize.  We
-                 *       also need to maintain a current scoreboard, that is
-                 *       will be used by the Ibox to know when to queue up or
-                 *       not more instructions that may depend on the value of
-                 *       the IPRs.
-                 */
-
-                /*
-                 * Get the next queued entry, because if an instruction was
-                 * aborted, but not yet dequeued, we are going to have to get
-                 * rid of this entry and not process it.
-                 */
-                next = (AXP_QUEUE_ENTRY *) entry->header.flink;
-
-                if (AXP_UTL_OPT2)
-                {
-                    AXP_TRACE_BEGIN();
-                    AXP_TraceWrite("%s queue = 0x%016llx, entry = 0x%016llx, "
-                                   "next = 0x%016llx",
-                                   pipelineStr[pipeline],
-                                   queue,
-                                   entry,
-                                   next);
-                    AXP_TraceWrite("%s checking at "
-                                   "pc = 0x%016llx, "
-                                   "opcode = 0x%02x, "
-                                   "pipeline = %s, "
-                                   "state = %s.",
-                                   pipelineStr[pipeline],
-                                   AXP_GET_PC(entry->ins->pc),
-                                   (u32) entry->ins->opcode,
-                                   insPipelineStr[entry->pipeline],
-                                   insStateStr[entry->ins->state]);
-                    AXP_TRACE_END();
-                }
-
-                /*
-                 * If this entry can be executed by this pipeline, and the
-                 * registers are all ready, and some other pipeline has not
-                 * already started processing this entry, or the instruction is
-                 * being aborted, then we should process/abort it now.
-                 *
-                 * NOTE:    Because of the way we have to lock/unlock/lock the
-                 *          eBoxMutex/fBoxMutex and the robMutex, it is
-                 *          possible for an instruction that can be executed in
-                 *          more than one pipeline to have already been picked
-                 *          up for processing/aborting.
-                 */
-                if (((((entry->pipeline == pipeCond[pipeline][0]) ||
-                       (entry->pipeline == pipeCond[pipeline][1]) ||
-                       (entry->pipeline == pipeCond[pipeline][2])) &&
-                      (AXP_RegistersReady(cpu, entry) == true)) ||
-                     (entry->ins->state == Aborted)) &&
-                    (entry->processing == false))
-                {
-                    entry->processing = true;
-                    break;
-                }
-
-                pthread_mutex_lock(&cpu->iBoxIPRMutex);
-
-                /*
-                 * HRM 5.2.14 - Ibox Control Register (page 5-18)
-                 *
-                 * If we are in Single Issue Mode, when set, this bit forces
-                 * instructions to issue only from the bottom-most entries of
-                 * the IQ and FQ.  Bottom-most in this implementation is
-                 * pointed to by the forward link of the queue head.  Setting
-                 * the next entry to look at as the queue head will cause this
-                 * while loop to exit.
-                 */
-                if (cpu->iCtl.single_issue_h == 1)
-                {
-                    entry = (AXP_QUEUE_ENTRY *) queue;
-                }
-                else
-                {
-                    entry = next;
-                }
-                pthread_mutex_unlock(&cpu->iBoxIPRMutex);
-            }
-
-            /*
-             * If we did not find an instruction to execute, then go back to
-             * the beginning of the loop.  Since we did not unlock the mutex,
-             * we do not need to lock it now.
-             */
-            if ((AXP_COUNTED_QUEUE *) entry == queue)
-            {
-                if (AXP_UTL_OPT2)
-                {
-                    AXP_TRACE_BEGIN();
-                    AXP_TraceWrite("%s has nothing to process.",
-                                   pipelineStr[pipeline]);
-                    AXP_TRACE_END();
-                }
-                nothingReadyForMe = true;
-                AXP_UnlockCountedQueue(queue);
-                continue;
-            }
+        /*
+         * If Floating-Point instructions are enabled, then call the dispatcher
+         * to dispatch this instruction to the correct function to execute the
+         * instruction.  Otherwise, set the appropriate exception value.  To
+         * keep the following code simpler, we set the fpEnable flag to true
+         * for all integer instructions.
+         */
+        if ((pipeline == FboxMul) || (pipeline == FboxOther))
+        {
+            pthread_mutex_lock(&cpu->iBoxIPRMutex);
+            fpEnable = cpu->pCtx.fpe == 1;
+            pthread_mutex_unlock(&cpu->iBoxIPRMutex);
+        }
+        else
+        {
+            fpEnable = true;
+        }
 
-            /*
-             * First we need to lock the ROB mutex.  We don't want some
-             * other thread changing the contents while we are looking at
-             * it.  We are looking to see if the instruction was aborted.
-             */
-            pthread_mutex_lock(&cpu->robMutex);
-            if ((state = entry->ins->state) == Queued)
-            {
-                entry->ins->state = Executing;
-            }
-            pthread_mutex_unlock(&cpu->robMutex);
-            if (state == Aborted)
-            {
-                AXP_RemoveCountedQueue((AXP_CQUE_ENTRY *) entry, true);
-                if ((entry->pipeline == EboxU0) ||
-                    (entry->pipeline == EboxU0U1) ||
-                    (entry->pipeline == EboxL0L1U0U1))
-                {
-                    cpu->eBoxClusterCounter[AXP_21264_EBOX_U0]--;
-                }
-                if ((entry->pipeline == EboxU1) ||
-                    (entry->pipeline == EboxU0U1) ||
-                    (entry->pipeline == EboxL0L1U0U1))
-                {
-                    cpu->eBoxClusterCounter[AXP_21264_EBOX_U1]--;
-                }
-                if ((entry->pipeline == EboxL0) ||
-                    (entry->pipeline == EboxL0L1) ||
-                    (entry->pipeline == EboxL0L1U0U1))
-                {
-                    cpu->eBoxClusterCounter[AXP_21264_EBOX_L0]--;
-                }
-                if ((entry->pipeline == EboxL1) ||
-                    (entry->pipeline == EboxL0L1) ||
-                    (entry->pipeline == EboxL0L1U0U1))
-                {
-                    cpu->eBoxClusterCounter[AXP_21264_EBOX_L1]--;
-                }
-                if (entry->pipeline == FboxMul)
-                {
-                    cpu->fBoxClusterCounter[AXP_21264_FBOX_MULTIPLY]--;
-                }
-                else if (entry->pipeline == FboxOther)
-                {
-                    cpu->fBoxClusterCounter[AXP_21264_FBOX_OTHER]--;
-                }
-                entry->processing = false;
-                (*returnEntry)(cpu, entry);
-                continue;
-            }
+        if (fpEnable == true)
+        {
 
             /*
-             * OK, we have something to execute.  Mark the entry as such and
-             * dequeue it from the queue.  Then, dispatch it to the function
-             * to execute the instruction.
+             * Call the dispatcher to dispatch this instruction to the correct
+             * function to execute the instruction.
              */
             if (AXP_UTL_OPT2)
             {
                 AXP_TRACE_BEGIN();
-                AXP_TraceWrite("%s has something to process at "
-                               "pc = 0x%016llx, opcode = 0x%02x.",
+                AXP_TraceWrite("%s dispatching instruction, opcode = 0x%02x",
                                pipelineStr[pipeline],
-                               AXP_GET_PC(entry->ins->pc),
-                               (u32) entry->ins->opcode);
+                               entry->ins->opcode);
                 AXP_TRACE_END();
             }
-            AXP_RemoveCountedQueue((AXP_CQUE_ENTRY *) entry, true);
-            if ((entry->pipeline == EboxU0) ||
-                (entry->pipeline == EboxU0U1) ||
-                (entry->pipeline == EboxL0L1U0U1))
-            {
-                cpu->eBoxClusterCounter[AXP_21264_EBOX_U0]--;
-            }
-            if ((entry->pipeline == EboxU1) ||
-                (entry->pipeline == EboxU0U1) ||
-                (entry->pipeline == EboxL0L1U0U1))
-            {
-                cpu->eBoxClusterCounter[AXP_21264_EBOX_U1]--;
-            }
-            if ((entry->pipeline == EboxL0) ||
-                (entry->pipeline == EboxL0L1) ||
-                (entry->pipeline == EboxL0L1U0U1))
-            {
-                cpu->eBoxClusterCounter[AXP_21264_EBOX_L0]--;
-            }
-            if ((entry->pipeline == EboxL1) ||
-                (entry->pipeline == EboxL0L1) ||
-                (entry->pipeline == EboxL0L1U0U1))
-            {
-                cpu->eBoxClusterCounter[AXP_21264_EBOX_L1]--;
-            }
-            if (entry->pipeline == FboxMul)
-            {
-                cpu->fBoxClusterCounter[AXP_21264_FBOX_MULTIPLY]--;
-            }
-            else if (entry->pipeline == FboxOther)
-            {
-                cpu->fBoxClusterCounter[AXP_21264_FBOX_OTHER]--;
-            }
 
             /*
-             * If Floating-Point instructions are enabled, then call the
-             * dispatcher to dispatch this instruction to the correct function
-             * to execute the instruction.  Otherwise, set the appropriate
-             * exception value.  To keep the following code simpler, we set the
-             * fpEnable flag to true for all integer instructions.
+             * Now we can load the source registers and call the dispatcher to
+             * execute the instruction.
              */
-            if ((pipeline == FboxMul) || (pipeline == FboxOther))
-            {
-                pthread_mutex_lock(&cpu->iBoxIPRMutex);
-                fpEnable = cpu->pCtx.fpe
-                           == 1;
-                pthread_mutex_unlock(&cpu->iBoxIPRMutex);
-            }
-            else
-            {
-                fpEnable = true;
-            }
-
-            if (fpEnable == true)
+            AXP_RegistersLoad(cpu, entry);
+            AXP_Dispatcher(cpu, entry->ins);
+            if (AXP_UTL_OPT2)
             {
-
-                /*
-                 * Call the dispatcher to dispatch this instruction to the correct
-                 * function to execute the instruction.
-                 */
-                if (AXP_UTL_OPT2)
-                {
-                    AXP_TRACE_BEGIN();
-                    AXP_TraceWrite("%s dispatching instruction, opcode = 0x%02x",
-                                   pipelineStr[pipeline],
-                                   entry->ins->opcode);
-                    AXP_TRACE_END();
-                }
-
-                /*
-                 * Now we can call the dispatcher to execute the instruction.
-                 */
-                AXP_Dispatcher(cpu, entry->ins);
-                if (AXP_UTL_OPT2)
-                {
-                    AXP_TRACE_BEGIN();
-                    AXP_TraceWrite("%s dispatched instruction, opcode = 0x%02x",
-                                   pipelineStr[pipeline],
-                                   entry->ins->opcode);
-                    AXP_TRACE_END();
-                }
+                AXP_TRACE_BEGIN();
+                AXP_TraceWrite("%s dispatched instruction, opcode = 0x%02x",
+                               pipelineStr[pipeline],
+                               entry->ins->opcode);
+                AXP_TRACE_END();
             }
-            else
+        }
+        else
+        {
+            if (AXP_UTL_OPT2)
             {
-                if (AXP_UTL_OPT2)
-                {
-                    AXP_TRACE_BEGIN();
-                    AXP_TraceWrite("Fbox %s : Floating point instructions are "
-                                   "currently disabled.",
-                                   pipelineStr[pipeline]);
-                    AXP_TRACE_END();
-                }
-                pthread_mutex_lock(&cpu->robMutex);
-                entry->ins->excRegMask = FloatingDisabledFault;
-                entry->ins->state = WaitingRetirement;
-                pthread_mutex_unlock(&cpu->robMutex);
+                AXP_TRACE_BEGIN();
+                AXP_TraceWrite("Fbox %s : Floating point instructions are "
+                               "currently disabled.",
+                               pipelineStr[pipeline]);
+                AXP_TRACE_END();
             }
+            pthread_mutex_lock(&cpu->robMutex);
+            entry->ins->excRegMask = FloatingDisabledFault;
+            entry->ins->state = WaitingRetirement;
+            pthread_mutex_unlock(&cpu->robMutex);
+        }
 
-            /*
-             * Return the entry back to the pool for future instructions.
-             */
-            entry->processing = false;
-            (*returnEntry)(cpu, entry);
+        /*
+         * Return the entry back to the pool for future instructions.
+         */
+        (*returnEntry)(cpu, entry);
 
-            /*
-             * Before we go process any more instructions, let's make sure that
-             * the iBox is not stalled.  If it is, then it may have an
-             * instruction that it can retire.
-             *
-             * NOTE:    We intentionally do not have the mutex locked.  Doing
-             *          so causes the emulator to get locked up (the Ibox
-             *          rarely unlocks the mutex, so we'd effectively get
-             *          ourselves into a deadlock.
-             */
-            if (cpu->stallWaitingRetirement == true)
-            {
-                pthread_cond_signal(&cpu->iBoxCondition);
-            }
-        }
+        /*
+         * Before we go process any more instructions, let's make sure that
+         * the iBox is not stalled.  If it is, then it may have an instruction
+         * that it can retire.
+         */
+        AXP_21264_Ibox_Completed(cpu);
     }
 
-    /*
-     * Last things last, lock the Ebox mutex.
-     */
-    pthread_mutex_unlock(mutex);
-
     /*
      * Return back to the caller.
      */
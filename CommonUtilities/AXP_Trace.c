@@ -30,19 +30,485 @@
  *
  *  V01.001 01-Jun-2019 Jonathan D. Belanger
  *  Reformatted to remove tabs and be consistent with other source files.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Added the binary trace format, selected with AXP_LOGFORMAT=binary.  Each
+ *  thread writes its trace records, without formatting them, into its own
+ *  ring buffer, and a background thread drains the ring buffers into the
+ *  trace file.  There is no locking when writing a trace record.  Also added
+ *  the function to decode the binary trace file back into the text format.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Determine the trace flags once, when tracing is initialized (or ended),
+ *  rather than having each trace macro decode AXP_LOGMASK.  Before, when
+ *  tracing was not on, every trace macro also called AXP_TraceInit.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Only stop the drainer thread, and close the binary trace file, when the
+ *  thread was started.  AXP_LOGFORMAT=binary, without a mask or with a trace
+ *  file that could not be opened, would join a thread that was never created
+ *  and close a NULL file.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped a line longer than 80 columns.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CommonUtilities/AXP_Utility.h"
 #include "CommonUtilities/AXP_Trace.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 static char *AXPTRCLOG = "AXP_LOGMASK";
 static char *AXPTRCFIL = "AXP_LOGFILE";
+static char *AXPTRCFMT = "AXP_LOGFORMAT";
 AXP_TRCLOG _axp_trc_log_ = 0;
 static char _axp_trc_out_[81];
 static pthread_once_t _axp_trc_log_once_ = PTHREAD_ONCE_INIT;
 static FILE *_axp_trc_fp_;
 bool _axp_trc_active_ = false;
 
+/*
+ * The flag for each type of tracing, and the component and bits within the
+ * component, in AXP_LOGMASK, that turn it on.
+ */
+u8 _axp_trc_flags_[AXP_TRCFLG_MAX] =
+{
+    [0 ... AXP_TRCFLG_MAX - 1] = AXP_TRC_FLAG_UNSET
+};
+
+static const struct
+{
+    AXP_TRCLOG comp;
+    u32 shift;
+    u32 bits;
+} _axp_trc_flag_bits_[AXP_TRCFLG_MAX] =
+{
+#define AXP_TRC_FLAG_BITS(name, comp, bits)				\
+    {AXP_COMP_##comp, AXP_SHIFT_##comp, (bits)},
+    AXP_TRC_FLAG_LIST(AXP_TRC_FLAG_BITS)
+#undef AXP_TRC_FLAG_BITS
+};
+
+/*
+ * The following are used for the binary trace format.  Each thread gets its
+ * own ring buffer the first time it writes a trace record.  The thread is the
+ * only one to move the head and the drainer is the only one to move the tail.
+ * When the ring buffer is full, the record is dropped, rather than waiting
+ * for the drainer.
+ */
+typedef struct
+{
+    u8 bytes[AXP_TRC_SLOT_LEN];
+} AXP_TRC_SLOT;
+
+typedef struct AXP_TRC_RING
+{
+    struct AXP_TRC_RING *next;
+    u32 id;
+    u64 head;
+    u64 tail;
+    u64 dropped;
+    AXP_TRC_SLOT slots[AXP_TRC_RING_SLOTS];
+} AXP_TRC_RING;
+
+/*
+ * The format strings are given an id the first time they are used.  The hash
+ * table is keyed on the address of the format string, and only written with
+ * the format mutex locked.  The format text is copied, so that a format that
+ * is not a string literal (it is in a buffer that has since changed) can be
+ * detected.
+ */
+typedef struct
+{
+    const char *fmt;
+    u32 id;
+} AXP_TRC_FMT_HASH;
+
+static bool _axp_trc_binary_ = false;
+static AXP_TRC_RING *_axp_trc_rings_ = NULL;
+static u32 _axp_trc_ring_ids_ = 0;
+static __thread AXP_TRC_RING *_axp_trc_ring_ = NULL;
+static pthread_mutex_t _axp_trc_fmt_mutex_ = PTHREAD_MUTEX_INITIALIZER;
+static AXP_TRC_FMT_HASH _axp_trc_fmt_hash_[AXP_TRC_MAX_FORMATS * 2];
+static char *_axp_trc_fmts_[AXP_TRC_MAX_FORMATS];
+static u32 _axp_trc_fmt_cnt_ = 0;
+static u32 _axp_trc_fmt_written_ = 0;
+static pthread_t _axp_trc_drainer_;
+static bool _axp_trc_drainer_started_ = false;
+static bool _axp_trc_drainer_stop_ = false;
+static bool _axp_trc_ended_ = false;
+
+/*
+ * AXP_TraceStamp
+ *  This function is called to get the time stamp for a binary trace record.
+ *  Where there is a time stamp counter, we use it, because it is much cheaper
+ *  to read than the time of day.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The current value of the time stamp counter.
+ */
+static inline u64 AXP_TraceStamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (__rdtsc());
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((u64) now.tv_sec * 1000000000ll) + now.tv_nsec);
+#endif
+}
+
+/*
+ * AXP_TraceChunk
+ *  This function is called to write a chunk to the binary trace file.  Only
+ *  the drainer (or the last call to drain, once the drainer has stopped)
+ *  writes to the file.
+ *
+ * Input Parameters:
+ *  type:
+ *      A value indicating the type of chunk being written.
+ *  id:
+ *      A value for the id field of the chunk.
+ *  data:
+ *      A pointer to the data for the chunk.
+ *  len:
+ *      A value indicating the number of bytes in data.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void AXP_TraceChunk(AXP_TRC_CHUNK_TYPE type,
+                           u32 id,
+                           const void *data,
+                           u32 len)
+{
+    AXP_TRC_CHUNK chunk = {.type = type, .id = id, .len = len, .res = 0};
+
+    fwrite(&chunk, sizeof(chunk), 1, _axp_trc_fp_);
+    fwrite(data, 1, len, _axp_trc_fp_);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_TraceClock
+ *  This function is called to write the current time stamp counter and time
+ *  of day to the binary trace file, so that the decoder can convert the time
+ *  stamps into the time of day.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void AXP_TraceClock(void)
+{
+    AXP_TRC_CLOCK clock;
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    clock.stamp = AXP_TraceStamp();
+    clock.nsec = ((u64) now.tv_sec * 1000000000ll) + now.tv_nsec;
+    AXP_TraceChunk(AXP_TRC_CHUNK_CLOCK, 0, &clock, sizeof(clock));
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_TraceFormatId
+ *  This function is called to get the id for a format string.  The first time
+ *  a format string is seen, it is given the next id.  Format strings that are
+ *  not string literals (the text at the address has changed since the format
+ *  was given its id) are given format 0.
+ *
+ * Input Parameters:
+ *  fmt:
+ *      A pointer to the format string.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:      The format needs to be formatted before it is recorded.
+ *  >0:     The id for the format string.
+ */
+static u32 AXP_TraceFormatId(const char *fmt)
+{
+    const u32 mask = (AXP_TRC_MAX_FORMATS * 2) - 1;
+    const char *entry;
+    u32 idx = (u32) (((u64) fmt >> 3) * 0x9e3779b1) & mask;
+    u32 retVal = 0;
+    bool found = false;
+
+    /*
+     * Look for the format, without locking the mutex.
+     */
+    while ((entry = __atomic_load_n(&_axp_trc_fmt_hash_[idx].fmt,
+                                    __ATOMIC_ACQUIRE)) != NULL)
+    {
+        if (entry == fmt)
+        {
+            retVal = _axp_trc_fmt_hash_[idx].id;
+            found = true;
+            break;
+        }
+        idx = (idx + 1) & mask;
+    }
+
+    /*
+     * If we did not find it, then lock the mutex and add it.  Someone else
+     * may have added it, or another format into the same place in the hash
+     * table, while we were getting the mutex.
+     */
+    if (found == false)
+    {
+        pthread_mutex_lock(&_axp_trc_fmt_mutex_);
+        while ((_axp_trc_fmt_hash_[idx].fmt != NULL) &&
+               (_axp_trc_fmt_hash_[idx].fmt != fmt))
+        {
+            idx = (idx + 1) & mask;
+        }
+        if (_axp_trc_fmt_hash_[idx].fmt == fmt)
+        {
+            retVal = _axp_trc_fmt_hash_[idx].id;
+        }
+        else if (_axp_trc_fmt_cnt_ < AXP_TRC_MAX_FORMATS)
+        {
+            retVal = _axp_trc_fmt_cnt_;
+            _axp_trc_fmts_[retVal] = strdup(fmt);
+            _axp_trc_fmt_hash_[idx].id = retVal;
+            __atomic_store_n(&_axp_trc_fmt_hash_[idx].fmt,
+                             fmt,
+                             __ATOMIC_RELEASE);
+            __atomic_store_n(&_axp_trc_fmt_cnt_, retVal + 1, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&_axp_trc_fmt_mutex_);
+    }
+
+    /*
+     * If the format string is no longer what it was when it was given its id,
+     * then it is not a string literal.
+     */
+    if ((retVal != 0) && (strcmp(_axp_trc_fmts_[retVal], fmt) != 0))
+    {
+        retVal = 0;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_TraceRing
+ *  This function is called to get the ring buffer for the current thread.
+ *  The first time a thread calls this function, its ring buffer is allocated
+ *  and added to the list the drainer drains.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL:       The ring buffer could not be allocated.
+ *  Not NULL:   A pointer to the ring buffer for the current thread.
+ */
+static AXP_TRC_RING *AXP_TraceRing(void)
+{
+    AXP_TRC_RING *ring = _axp_trc_ring_;
+
+    if (ring == NULL)
+    {
+        ring = calloc(1, sizeof(AXP_TRC_RING));
+        if (ring != NULL)
+        {
+            ring->id = __atomic_fetch_add(&_axp_trc_ring_ids_,
+                                          1,
+                                          __ATOMIC_RELAXED);
+            ring->next = __atomic_load_n(&_axp_trc_rings_, __ATOMIC_RELAXED);
+            while (__atomic_compare_exchange_n(&_axp_trc_rings_,
+                                               &ring->next,
+                                               ring,
+                                               true,
+                                               __ATOMIC_RELEASE,
+                                               __ATOMIC_RELAXED) == false)
+            {
+                continue;
+            }
+            _axp_trc_ring_ = ring;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (ring);
+}
+
+/*
+ * AXP_TraceDrain
+ *  This function is called to write everything in the ring buffers to the
+ *  binary trace file.  For each ring buffer, the head is read before the new
+ *  format strings are written, so that the format strings for all the records
+ *  written are in the file before them.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void AXP_TraceDrain(void)
+{
+    AXP_TRC_RING *ring;
+    u64 head, tail;
+    u32 fmtCnt;
+    u32 start, cnt;
+
+    for (ring = __atomic_load_n(&_axp_trc_rings_, __ATOMIC_ACQUIRE);
+         ring != NULL;
+         ring = ring->next)
+    {
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        tail = ring->tail;
+
+        /*
+         * Write out the format strings we have not already written.
+         */
+        fmtCnt = __atomic_load_n(&_axp_trc_fmt_cnt_, __ATOMIC_ACQUIRE);
+        while (_axp_trc_fmt_written_ < fmtCnt)
+        {
+            AXP_TraceChunk(AXP_TRC_CHUNK_FORMAT,
+                           _axp_trc_fmt_written_,
+                           _axp_trc_fmts_[_axp_trc_fmt_written_],
+                           strlen(_axp_trc_fmts_[_axp_trc_fmt_written_]) + 1);
+            _axp_trc_fmt_written_++;
+        }
+
+        /*
+         * Now write out the records.  If they wrap around the end of the ring
+         * buffer, they are written in 2 chunks.
+         */
+        while (tail != head)
+        {
+            start = tail & (AXP_TRC_RING_SLOTS - 1);
+            cnt = AXP_TRC_RING_SLOTS - start;
+            if (cnt > (head - tail))
+            {
+                cnt = head - tail;
+            }
+            AXP_TraceChunk(AXP_TRC_CHUNK_RECORDS,
+                           ring->id,
+                           &ring->slots[start],
+                           cnt * AXP_TRC_SLOT_LEN);
+            tail += cnt;
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+    AXP_TraceClock();
+    fflush(_axp_trc_fp_);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_TraceDrainer
+ *  This is the main function for the thread that drains the ring buffers into
+ *  the binary trace file, every 10 milliseconds, until tracing is ended.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      Not used.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL.
+ */
+static void *AXP_TraceDrainer(void *voidPtr)
+{
+    struct timespec interval = {.tv_sec = 0, .tv_nsec = 10000000};
+
+    while (__atomic_load_n(&_axp_trc_drainer_stop_, __ATOMIC_ACQUIRE) == false)
+    {
+        nanosleep(&interval, NULL);
+        AXP_TraceDrain();
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (NULL);
+}
+
+/*
+ * AXP_TraceSetFlags
+ *  This function is called to set the flag for each type of tracing, from the
+ *  trace mask.  When tracing is not active, all the flags are turned off.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void AXP_TraceSetFlags(void)
+{
+    AXP_TRCLOG mask;
+    int ii;
+
+    for (ii = 0; ii < AXP_TRCFLG_MAX; ii++)
+    {
+        mask = (_axp_trc_log_ & _axp_trc_flag_bits_[ii].comp) >>
+               _axp_trc_flag_bits_[ii].shift;
+        __atomic_store_n(&_axp_trc_flags_[ii],
+                         ((_axp_trc_active_ == true) &&
+                          ((mask & _axp_trc_flag_bits_[ii].bits) ==
+                           _axp_trc_flag_bits_[ii].bits)) ?
+                             AXP_TRC_FLAG_ON : AXP_TRC_FLAG_OFF,
+                         __ATOMIC_RELEASE);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
 /*
  * AXP_TraceInit_Once
  *  This function is called using the pthread_once function to make sure that
@@ -70,20 +536,74 @@ void AXP_TraceInit_Once(void)
     {
         sscanf(getEnvStr, "0x%08x", &_axp_trc_log_);
     }
+    getEnvStr = getenv(AXPTRCFMT);
+    if ((getEnvStr != NULL) && (strcmp(getEnvStr, "binary") == 0))
+    {
+        _axp_trc_binary_ = true;
+    }
     if (_axp_trc_log_ != 0)
     {
         getEnvStr = getenv(AXPTRCFIL);
-        if (getEnvStr == NULL)
+        if ((getEnvStr == NULL) && (_axp_trc_binary_ == false))
         {
             strcpy(_axp_trc_out_, "Standard Output");
             _axp_trc_fp_ = stdout;
         }
         else
         {
-            sscanf(getEnvStr, "%80s", _axp_trc_out_);
+            sscanf((getEnvStr != NULL) ? getEnvStr : "DECaxp.trc",
+                   "%80s",
+                   _axp_trc_out_);
             _axp_trc_fp_ = fopen(_axp_trc_out_, "w");
         }
-        _axp_trc_active_ = true;
+
+        /*
+         * For the binary format, write the header, set up format 0, and start
+         * the thread that drains the ring buffers into the file.  Anything
+         * left in the ring buffers is written when tracing is ended, which
+         * will be at exit if not before.
+         */
+        if ((_axp_trc_binary_ == true) && (_axp_trc_fp_ != NULL))
+        {
+            fwrite(AXP_TRC_MAGIC, 1, AXP_TRC_MAGIC_LEN, _axp_trc_fp_);
+            AXP_TraceClock();
+            _axp_trc_fmts_[0] = strdup("%s");
+            _axp_trc_fmt_cnt_ = 1;
+            if (pthread_create(&_axp_trc_drainer_,
+                               NULL,
+                               AXP_TraceDrainer,
+                               NULL) == 0)
+            {
+                _axp_trc_drainer_started_ = true;
+                atexit(AXP_TraceEnd);
+            }
+            else
+            {
+                fclose(_axp_trc_fp_);
+                _axp_trc_fp_ = NULL;
+            }
+        }
+
+        /*
+         * If we could not open the trace file, then there is no tracing.
+         */
+        if (_axp_trc_fp_ == NULL)
+        {
+            _axp_trc_log_ = 0;
+        }
+        else
+        {
+            _axp_trc_active_ = true;
+        }
+    }
+
+    /*
+     * Set the trace flags before writing anything, so that nothing we call
+     * tries to initialize tracing again.
+     */
+    AXP_TraceSetFlags();
+    if (_axp_trc_active_ == true)
+    {
         AXP_TraceWrite("Digital Alpha AXP 21264 CPU Emulator Trace Utility.");
         AXP_TraceWrite("AXP_TRCLOG = 0x%08x : AXP_TRCFIL = %s",
                        _axp_trc_log_,
@@ -126,6 +646,36 @@ bool AXP_TraceInit(void)
     return (retVal);
 }
 
+/*
+ * AXP_TraceFlag
+ *  This function is called by the trace macros when the flag for a type of
+ *  tracing has not yet been set, which is only until tracing is initialized.
+ *
+ * Input Parameters:
+ *  flag:
+ *      A value indicating the type of tracing being checked.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   This type of tracing is turned on.
+ *  false:  This type of tracing is turned off.
+ */
+bool AXP_TraceFlag(AXP_TRC_FLAG flag)
+{
+    bool retVal;
+
+    AXP_TraceInit();
+    retVal = __atomic_load_n(&_axp_trc_flags_[flag], __ATOMIC_ACQUIRE) ==
+             AXP_TRC_FLAG_ON;
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * AXP_TraceEnd
  *  This function is called end the tracing.
@@ -146,6 +696,254 @@ void AXP_TraceEnd(void)
      * Turn off the tracing.
      */
     _axp_trc_active_ = false;
+    AXP_TraceSetFlags();
+
+    /*
+     * For the binary format, stop the drainer and write out whatever is left
+     * in the ring buffers.  This can be called more than once (it is also
+     * called at exit), but we only do this the once, and only if the drainer
+     * was started.
+     */
+    if ((_axp_trc_drainer_started_ == true) &&
+        (__atomic_exchange_n(&_axp_trc_ended_,
+                             true,
+                             __ATOMIC_ACQ_REL) == false))
+    {
+        __atomic_store_n(&_axp_trc_drainer_stop_, true, __ATOMIC_RELEASE);
+        pthread_join(_axp_trc_drainer_, NULL);
+        AXP_TraceDrain();
+        fclose(_axp_trc_fp_);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_TraceRecord
+ *  This function is called by AXP_TraceWrite, for the binary trace format, to
+ *  write a trace record into the ring buffer for the current thread.  The
+ *  format string is only looked at to determine the type of each argument, so
+ *  that it can be saved as a u64 (or a string).  The formatting is done by
+ *  the decoder.  Formats that are not string literals are formatted here and
+ *  saved as a string, using format 0.
+ *
+ * Input Parameters:
+ *  fmt:
+ *      A pointer to a format string.
+ *  ap:
+ *      The variable argument list.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void AXP_TraceRecord(const char *fmt, va_list ap)
+{
+    AXP_TRC_SLOT buf[AXP_TRC_MAX_SLOTS];
+    AXP_TRC_RECORD *rec = (AXP_TRC_RECORD *) buf;
+    AXP_TRC_RING *ring = AXP_TraceRing();
+    u64 args[AXP_TRC_MAX_ARGS];
+    char strs[AXP_TRC_MAX_SLOTS * AXP_TRC_SLOT_LEN];
+    const u32 strMax = sizeof(buf) - sizeof(AXP_TRC_RECORD) - sizeof(args);
+    u32 strLen = 0;
+    u32 argCnt = 0;
+    u32 slots, ii;
+    u64 head, tail;
+    const char *ptr;
+    const char *str;
+    double dbl;
+    int longs;
+    bool longDbl;
+
+    rec->stamp = AXP_TraceStamp();
+    rec->fmtId = AXP_TraceFormatId(fmt);
+
+    /*
+     * If the format is not a string literal, then format it now.  Otherwise,
+     * go through the format string and save each of the arguments.
+     */
+    if (rec->fmtId == 0)
+    {
+        int len = vsnprintf(strs, strMax, fmt, ap);
+
+        strLen = ((len < 0) ? 0 : ((len < strMax) ? len : (strMax - 1))) + 1;
+        strs[strLen - 1] = '\0';
+        args[argCnt++] = strLen - 1;
+    }
+    else
+    {
+        for (ptr = fmt; ((*ptr != '\0') && (argCnt < AXP_TRC_MAX_ARGS)); ptr++)
+        {
+
+            /*
+             * Skip to the conversion character, saving the arguments for
+             * any width or precision given as an asterisk.
+             */
+            if (*ptr != '%')
+            {
+                continue;
+            }
+            ptr++;
+            if (*ptr == '%')
+            {
+                continue;
+            }
+            while ((*ptr != '\0') && (strchr("-+ #0'", *ptr) != NULL))
+            {
+                ptr++;
+            }
+            if (*ptr == '*')
+            {
+                args[argCnt++] = (u64) (i64) va_arg(ap, int);
+                ptr++;
+            }
+            while (isdigit(*ptr))
+            {
+                ptr++;
+            }
+            if (*ptr == '.')
+            {
+                ptr++;
+                if ((*ptr == '*') && (argCnt < AXP_TRC_MAX_ARGS))
+                {
+                    args[argCnt++] = (u64) (i64) va_arg(ap, int);
+                    ptr++;
+                }
+                while (isdigit(*ptr))
+                {
+                    ptr++;
+                }
+            }
+            longs = 0;
+            longDbl = false;
+            while ((*ptr != '\0') && (strchr("hlLqjzt", *ptr) != NULL))
+            {
+                if (*ptr == 'L')
+                {
+                    longDbl = true;
+                }
+                else if (*ptr != 'h')
+                {
+                    longs++;
+                }
+                ptr++;
+            }
+            if ((*ptr == '\0') || (argCnt == AXP_TRC_MAX_ARGS))
+            {
+                break;
+            }
+            switch (*ptr)
+            {
+                case 'd':
+                case 'i':
+                    if (longs > 0)
+                    {
+                        args[argCnt++] = (u64) va_arg(ap, long long);
+                    }
+                    else
+                    {
+                        args[argCnt++] = (u64) (i64) va_arg(ap, int);
+                    }
+                    break;
+
+                case 'u':
+                case 'o':
+                case 'x':
+                case 'X':
+                case 'c':
+                    if (longs > 0)
+                    {
+                        args[argCnt++] = va_arg(ap, unsigned long long);
+                    }
+                    else
+                    {
+                        args[argCnt++] = va_arg(ap, unsigned int);
+                    }
+                    break;
+
+                case 'p':
+                case 'n':
+                    args[argCnt++] = (u64) va_arg(ap, void *);
+                    break;
+
+                case 'f':
+                case 'F':
+                case 'e':
+                case 'E':
+                case 'g':
+                case 'G':
+                case 'a':
+                case 'A':
+                    if (longDbl == true)
+                    {
+                        dbl = (double) va_arg(ap, long double);
+                    }
+                    else
+                    {
+                        dbl = va_arg(ap, double);
+                    }
+                    memcpy(&args[argCnt++], &dbl, sizeof(dbl));
+                    break;
+
+                case 's':
+                    str = va_arg(ap, const char *);
+                    if (str == NULL)
+                    {
+                        str = "(null)";
+                    }
+                    ii = 0;
+                    while ((str[ii] != '\0') && ((strLen + ii + 1) < strMax))
+                    {
+                        strs[strLen + ii] = str[ii];
+                        ii++;
+                    }
+                    strs[strLen + ii] = '\0';
+                    strLen += ii + 1;
+                    args[argCnt++] = ii;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    /*
+     * Put the record together, after the header.
+     */
+    rec->argCnt = argCnt;
+    rec->len = (argCnt * sizeof(u64)) + strLen;
+    rec->res = 0;
+    memcpy(rec + 1, args, argCnt * sizeof(u64));
+    memcpy((u8 *) (rec + 1) + (argCnt * sizeof(u64)), strs, strLen);
+    slots = AXP_TRC_RECORD_SLOTS(rec->len);
+
+    /*
+     * If there is room in the ring buffer, then copy the record into it.
+     * Otherwise, the record is dropped.
+     */
+    if (ring != NULL)
+    {
+        head = ring->head;
+        tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if ((head + slots - tail) > AXP_TRC_RING_SLOTS)
+        {
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            for (ii = 0; ii < slots; ii++)
+            {
+                ring->slots[(head + ii) & (AXP_TRC_RING_SLOTS - 1)] = buf[ii];
+            }
+            __atomic_store_n(&ring->head, head + slots, __ATOMIC_RELEASE);
+        }
+    }
 
     /*
      * Return back to the caller.
@@ -178,26 +976,40 @@ void AXP_TraceWrite(char *fmt, ...)
     struct tm timeNow;
 
     /*
-     * Write out a time-stamp followed by a colon and a space character
+     * For the binary format, just record the arguments.  The time-stamp and
+     * text are generated when the trace file is decoded.
      */
-    gettimeofday(&now, NULL);
-    strftime(outBuf,
-             sizeof(outBuf),
-             "%H:%M:%S",
-             localtime_r(&now.tv_sec, &timeNow));
-    fprintf(_axp_trc_fp_, "%s.%03ld: ", outBuf, (now.tv_usec / 1000));
+    if (_axp_trc_binary_ == true)
+    {
+        va_start(ap, fmt);
+        AXP_TraceRecord(fmt, ap);
+        va_end(ap);
+    }
+    else
+    {
 
-    /*
-     * Now generate the rest of the requested text.
-     */
-    va_start(ap, fmt);
-    vfprintf(_axp_trc_fp_, fmt, ap);
-    va_end(ap);
+        /*
+         * Write out a time-stamp followed by a colon and a space character
+         */
+        gettimeofday(&now, NULL);
+        strftime(outBuf,
+                 sizeof(outBuf),
+                 "%H:%M:%S",
+                 localtime_r(&now.tv_sec, &timeNow));
+        fprintf(_axp_trc_fp_, "%s.%03ld: ", outBuf, (now.tv_usec / 1000));
 
-    /*
-     * End it with a new-line.
-     */
-    fprintf(_axp_trc_fp_, "\n");
+        /*
+         * Now generate the rest of the requested text.
+         */
+        va_start(ap, fmt);
+        vfprintf(_axp_trc_fp_, fmt, ap);
+        va_end(ap);
+
+        /*
+         * End it with a new-line.
+         */
+        fprintf(_axp_trc_fp_, "\n");
+    }
 
     /*
      * Return back to the caller.
@@ -275,9 +1087,13 @@ void AXP_TraceLock(void)
 {
 
     /*
-     * Lock the file stream.
+     * Lock the file stream.  The binary format does not need to, because each
+     * thread has its own ring buffer.
      */
-    flockfile(_axp_trc_fp_);
+    if (_axp_trc_binary_ == false)
+    {
+        flockfile(_axp_trc_fp_);
+    }
 
     /*
      * Return back to the caller,
@@ -306,10 +1122,518 @@ void AXP_TraceUnlock(void)
     /*
      * Unlock the file stream.
      */
-    funlockfile(_axp_trc_fp_);
+    if (_axp_trc_binary_ == false)
+    {
+        funlockfile(_axp_trc_fp_);
+    }
 
     /*
      * Return back to the caller,
      */
     return;
 }
+
+/*
+ * AXP_TraceDropped
+ *  This function is called to get the number of binary trace records that were
+ *  dropped, because the ring buffer for the thread writing them was full.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of trace records dropped, for all threads.
+ */
+u64 AXP_TraceDropped(void)
+{
+    AXP_TRC_RING *ring;
+    u64 retVal = 0;
+
+    for (ring = __atomic_load_n(&_axp_trc_rings_, __ATOMIC_ACQUIRE);
+         ring != NULL;
+         ring = ring->next)
+    {
+        retVal += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * The following are used when decoding a binary trace file.  The records for
+ * each thread are collected together, and then sorted into time stamp order.
+ */
+typedef struct
+{
+    u8 *data;
+    u64 len;
+    u64 size;
+} AXP_TRC_THREAD_BUF;
+
+typedef struct
+{
+    u64 stamp;
+    u32 thread;
+    u32 seq;
+    AXP_TRC_RECORD *rec;
+} AXP_TRC_DECODED;
+
+/*
+ * AXP_TraceDecodeCompare
+ *  This function is called by qsort to compare 2 decoded trace records.  The
+ *  records are sorted by time stamp, then thread, then the order in which the
+ *  thread wrote them.
+ *
+ * Input Parameters:
+ *  a:
+ *      A pointer to the first decoded trace record.
+ *  b:
+ *      A pointer to the second decoded trace record.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  <0:     a goes before b.
+ *  0:      a and b are the same.
+ *  >0:     a goes after b.
+ */
+static int AXP_TraceDecodeCompare(const void *a, const void *b)
+{
+    const AXP_TRC_DECODED *recA = (const AXP_TRC_DECODED *) a;
+    const AXP_TRC_DECODED *recB = (const AXP_TRC_DECODED *) b;
+    int retVal;
+
+    if (recA->stamp != recB->stamp)
+    {
+        retVal = (recA->stamp < recB->stamp) ? -1 : 1;
+    }
+    else if (recA->thread != recB->thread)
+    {
+        retVal = (recA->thread < recB->thread) ? -1 : 1;
+    }
+    else
+    {
+        retVal = (recA->seq < recB->seq) ? -1 : (recA->seq > recB->seq);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_TraceFormat
+ *  This function is called to generate the text for a binary trace record,
+ *  from its format string and arguments.  Each conversion in the format string
+ *  is given the argument, of the type it expects, in turn.
+ *
+ * Input Parameters:
+ *  outLen:
+ *      A value indicating the size of the out buffer.
+ *  fmt:
+ *      A pointer to the format string for the record.
+ *  rec:
+ *      A pointer to the trace record.
+ *
+ * Output Parameters:
+ *  out:
+ *      A pointer to the buffer to receive the text.
+ *
+ * Return Values:
+ *  None.
+ */
+#define AXP_TRC_PRINT(value)                                                \
+    ((stars == 0) ?                                                         \
+     snprintf(&out[pos], outLen - pos, spec, (value)) :                     \
+     ((stars == 1) ?                                                        \
+      snprintf(&out[pos], outLen - pos, spec, star[0], (value)) :           \
+      snprintf(&out[pos], outLen - pos, spec, star[0], star[1], (value))))
+
+static void AXP_TraceFormat(char *out,
+                            size_t outLen,
+                            const char *fmt,
+                            AXP_TRC_RECORD *rec)
+{
+    u64 *args = (u64 *) (rec + 1);
+    const char *strs = (const char *) (args + rec->argCnt);
+    const char *ptr;
+    char spec[32];
+    char hMods[3];
+    size_t pos = 0;
+    u32 specLen, hLen;
+    u32 argIdx = 0;
+    u32 strOff = 0;
+    int star[2];
+    int stars;
+    int longs;
+    int len = 0;
+    double dbl;
+
+    for (ptr = fmt; ((*ptr != '\0') && (pos < (outLen - 1))); ptr++)
+    {
+        if (*ptr != '%')
+        {
+            out[pos++] = *ptr;
+            continue;
+        }
+        ptr++;
+        if (*ptr == '%')
+        {
+            out[pos++] = '%';
+            continue;
+        }
+
+        /*
+         * Copy the flags, width and precision into the conversion
+         * specification, and get the arguments for any asterisks.
+         */
+        specLen = 0;
+        spec[specLen++] = '%';
+        stars = 0;
+        while ((*ptr != '\0') &&
+               (strchr("-+ #0'", *ptr) != NULL) &&
+               (specLen < 8))
+        {
+            spec[specLen++] = *ptr++;
+        }
+        if ((*ptr == '*') && (argIdx < rec->argCnt))
+        {
+            star[stars++] = (int) args[argIdx++];
+            spec[specLen++] = *ptr++;
+        }
+        while (isdigit(*ptr) && (specLen < 16))
+        {
+            spec[specLen++] = *ptr++;
+        }
+        if (*ptr == '.')
+        {
+            spec[specLen++] = *ptr++;
+            if ((*ptr == '*') && (argIdx < rec->argCnt))
+            {
+                star[stars++] = (int) args[argIdx++];
+                spec[specLen++] = *ptr++;
+            }
+            while (isdigit(*ptr) && (specLen < 24))
+            {
+                spec[specLen++] = *ptr++;
+            }
+        }
+
+        /*
+         * The length modifiers are replaced, because all the arguments were
+         * saved as a u64.
+         */
+        longs = 0;
+        hLen = 0;
+        while ((*ptr != '\0') && (strchr("hlLqjzt", *ptr) != NULL))
+        {
+            if ((*ptr == 'h') && (hLen < 2))
+            {
+                hMods[hLen++] = 'h';
+            }
+            else if (*ptr != 'L')
+            {
+                longs++;
+            }
+            ptr++;
+        }
+        if ((*ptr == '\0') || (argIdx >= rec->argCnt))
+        {
+            break;
+        }
+        switch (*ptr)
+        {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                if (longs > 0)
+                {
+                    spec[specLen++] = 'l';
+                    spec[specLen++] = 'l';
+                    spec[specLen++] = *ptr;
+                    spec[specLen] = '\0';
+                    len = AXP_TRC_PRINT((long long) args[argIdx]);
+                }
+                else
+                {
+                    memcpy(&spec[specLen], hMods, hLen);
+                    specLen += hLen;
+                    spec[specLen++] = *ptr;
+                    spec[specLen] = '\0';
+                    len = AXP_TRC_PRINT((int) args[argIdx]);
+                }
+                break;
+
+            case 'c':
+                spec[specLen++] = 'c';
+                spec[specLen] = '\0';
+                len = AXP_TRC_PRINT((int) args[argIdx]);
+                break;
+
+            case 'p':
+                spec[specLen++] = 'p';
+                spec[specLen] = '\0';
+                len = AXP_TRC_PRINT((void *) args[argIdx]);
+                break;
+
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                spec[specLen++] = *ptr;
+                spec[specLen] = '\0';
+                memcpy(&dbl, &args[argIdx], sizeof(dbl));
+                len = AXP_TRC_PRINT(dbl);
+                break;
+
+            case 's':
+                spec[specLen++] = 's';
+                spec[specLen] = '\0';
+                len = AXP_TRC_PRINT(&strs[strOff]);
+                strOff += args[argIdx] + 1;
+                break;
+
+            default:
+                len = 0;
+                break;
+        }
+        argIdx++;
+        if (len > 0)
+        {
+            pos += len;
+            if (pos >= outLen)
+            {
+                pos = outLen - 1;
+            }
+        }
+    }
+    out[pos] = '\0';
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_TraceDecode
+ *  This function is called to decode a binary trace file into the text
+ *  format.  The records from all the threads are written in time stamp order,
+ *  with each time stamp converted to the time of day.
+ *
+ * Input Parameters:
+ *  in:
+ *      A pointer to the binary trace file, opened for reading.
+ *  out:
+ *      A pointer to the file to receive the text.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  -1:     The input is not a binary trace file.
+ *  >=0:    The number of trace records decoded.
+ */
+int AXP_TraceDecode(FILE *in, FILE *out)
+{
+    AXP_TRC_CHUNK chunk;
+    AXP_TRC_CLOCK first = {0, 0}, last = {0, 0};
+    AXP_TRC_THREAD_BUF *threads = NULL;
+    AXP_TRC_DECODED *decoded = NULL;
+    AXP_TRC_RECORD *rec;
+    char **fmts = NULL;
+    char magic[AXP_TRC_MAGIC_LEN];
+    char text[AXP_TRC_MAX_SLOTS * AXP_TRC_SLOT_LEN * 2];
+    char timeBuf[16];
+    const char *fmt;
+    u8 *data;
+    u32 fmtCnt = 0;
+    u32 threadCnt = 0;
+    u32 ii, seq;
+    u64 off, decodedCnt = 0, decodedSize = 0;
+    u64 nsec;
+    double rate = 1.0;
+    bool haveClock = false;
+    struct tm timeNow;
+    time_t secs;
+    int retVal = -1;
+
+    if ((fread(magic, 1, AXP_TRC_MAGIC_LEN, in) == AXP_TRC_MAGIC_LEN) &&
+        (memcmp(magic, AXP_TRC_MAGIC, AXP_TRC_MAGIC_LEN) == 0))
+    {
+
+        /*
+         * Read in all the chunks.  The format strings are kept, the records
+         * are appended to those already read for their thread, and the first
+         * and last clocks are used to convert the time stamps.
+         */
+        while (fread(&chunk, sizeof(chunk), 1, in) == 1)
+        {
+            data = malloc(chunk.len);
+            if ((data == NULL) || (fread(data, 1, chunk.len, in) != chunk.len))
+            {
+                free(data);
+                break;
+            }
+            switch (chunk.type)
+            {
+                case AXP_TRC_CHUNK_FORMAT:
+                    if (chunk.id >= fmtCnt)
+                    {
+                        fmts = realloc(fmts, (chunk.id + 1) * sizeof(char *));
+                        for (ii = fmtCnt; ii <= chunk.id; ii++)
+                        {
+                            fmts[ii] = NULL;
+                        }
+                        fmtCnt = chunk.id + 1;
+                    }
+                    free(fmts[chunk.id]);
+                    fmts[chunk.id] = (char *) data;
+                    data = NULL;
+                    break;
+
+                case AXP_TRC_CHUNK_RECORDS:
+                    if (chunk.id >= threadCnt)
+                    {
+                        threads = realloc(threads,
+                                          (chunk.id + 1) *
+                                          sizeof(AXP_TRC_THREAD_BUF));
+                        memset(&threads[threadCnt],
+                               0,
+                               (chunk.id + 1 - threadCnt) *
+                               sizeof(AXP_TRC_THREAD_BUF));
+                        threadCnt = chunk.id + 1;
+                    }
+                    if ((threads[chunk.id].len + chunk.len) >
+                        threads[chunk.id].size)
+                    {
+                        threads[chunk.id].size =
+                            (threads[chunk.id].len + chunk.len) * 2;
+                        threads[chunk.id].data =
+                            realloc(threads[chunk.id].data,
+                                    threads[chunk.id].size);
+                    }
+                    memcpy(&threads[chunk.id].data[threads[chunk.id].len],
+                           data,
+                           chunk.len);
+                    threads[chunk.id].len += chunk.len;
+                    break;
+
+                case AXP_TRC_CHUNK_CLOCK:
+                    if (haveClock == false)
+                    {
+                        memcpy(&first, data, sizeof(first));
+                        haveClock = true;
+                    }
+                    memcpy(&last, data, sizeof(last));
+                    break;
+
+                default:
+                    break;
+            }
+            free(data);
+        }
+
+        /*
+         * Now, find each of the records for each thread, then sort them.
+         */
+        for (ii = 0; ii < threadCnt; ii++)
+        {
+            off = 0;
+            seq = 0;
+            while ((off + sizeof(AXP_TRC_RECORD)) <= threads[ii].len)
+            {
+                rec = (AXP_TRC_RECORD *) &threads[ii].data[off];
+                if ((off + (AXP_TRC_RECORD_SLOTS(rec->len) *
+                            AXP_TRC_SLOT_LEN)) > threads[ii].len)
+                {
+                    break;
+                }
+                if (decodedCnt == decodedSize)
+                {
+                    decodedSize = (decodedSize == 0) ? 4096 : (decodedSize * 2);
+                    decoded = realloc(decoded,
+                                      decodedSize * sizeof(AXP_TRC_DECODED));
+                }
+                decoded[decodedCnt].stamp = rec->stamp;
+                decoded[decodedCnt].thread = ii;
+                decoded[decodedCnt].seq = seq++;
+                decoded[decodedCnt].rec = rec;
+                decodedCnt++;
+                off += AXP_TRC_RECORD_SLOTS(rec->len) * AXP_TRC_SLOT_LEN;
+            }
+        }
+        if (decodedCnt > 0)
+        {
+            qsort(decoded,
+                  decodedCnt,
+                  sizeof(AXP_TRC_DECODED),
+                  AXP_TraceDecodeCompare);
+        }
+
+        /*
+         * Write out the text for each record, with the same time-stamp format
+         * that AXP_TraceWrite uses.
+         */
+        if (last.stamp != first.stamp)
+        {
+            rate = (double) (last.nsec - first.nsec) /
+                   (double) (last.stamp - first.stamp);
+        }
+        for (off = 0; off < decodedCnt; off++)
+        {
+            rec = decoded[off].rec;
+            nsec = first.nsec +
+                   (i64) ((double) (i64) (rec->stamp - first.stamp) * rate);
+            secs = nsec / 1000000000ll;
+            strftime(timeBuf,
+                     sizeof(timeBuf),
+                     "%H:%M:%S",
+                     localtime_r(&secs, &timeNow));
+            fmt = ((rec->fmtId < fmtCnt) && (fmts[rec->fmtId] != NULL)) ?
+                fmts[rec->fmtId] : "<unknown format>";
+            AXP_TraceFormat(text, sizeof(text), fmt, rec);
+            fprintf(out,
+                    "%s.%03llu: %s\n",
+                    timeBuf,
+                    (nsec / 1000000ll) % 1000,
+                    text);
+        }
+        retVal = decodedCnt;
+    }
+
+    /*
+     * Free everything we allocated.
+     */
+    for (ii = 0; ii < fmtCnt; ii++)
+    {
+        free(fmts[ii]);
+    }
+    free(fmts);
+    for (ii = 0; ii < threadCnt; ii++)
+    {
+        free(threads[ii].data);
+    }
+    free(threads);
+    free(decoded);
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
@@ -59,6 +59,9 @@
  *  GCC 7.4.0, and possibly earlier, turns on strict-aliasing rules by default.
  *  It is also reporting potentially uninitialized variables where it did not
  *  previously.  That is what occurred in this module.
+ *
+ *  V01.007 15-Oct-2026 Jonathan D. Belanger
+ *  Added the single-producer/single-consumer ring and event count functions.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CommonUtilities/AXP_Utility.h"
@@ -1148,6 +1151,325 @@ bool AXP_CondQueue_Empty(AXP_COND_Q_HDR *queue)
     return (retVal);
 }
 
+/*
+ * AXP_SPSCRing_Init
+ *  This function is called to initialize a single-producer/single-consumer
+ *  ring to empty.
+ *
+ * Input Parameters:
+ *  ring:
+ *      A pointer to the ring to be initialized.
+ *
+ * Output Parameters:
+ *  ring:
+ *      A pointer to the initialized ring.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_SPSCRing_Init(AXP_SPSC_RING *ring)
+{
+    ring->head = ring->tail = 0;
+    memset(ring->slot, 0, sizeof(ring->slot));
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_SPSCRing_Put
+ *  This function is called by the producer to put an item onto the tail of a
+ *  single-producer/single-consumer ring.  The slot is filled in before the
+ *  tail is moved, and the tail is stored with release semantics, so the
+ *  consumer can never see the new tail before it can see the slot contents.
+ *
+ * Input Parameters:
+ *  ring:
+ *      A pointer to the ring onto which the item is to be put.
+ *  item:
+ *      A pointer to the item to be put onto the ring.
+ *  tag:
+ *      A value to be returned to the consumer along with the item.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The item was put onto the ring.
+ *  false:  The ring is full.
+ */
+bool AXP_SPSCRing_Put(AXP_SPSC_RING *ring, void *item, u32 tag)
+{
+    u32 tail = ring->tail;
+    bool retVal = false;
+
+    /*
+     * Only the producer writes the tail, so we can read it directly.  The head
+     * is written by the consumer, and needs to be read with acquire semantics,
+     * so that we do not reuse a slot the consumer has yet to read.
+     */
+    if ((tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) <
+        AXP_SPSC_RING_LEN)
+    {
+        ring->slot[tail & AXP_SPSC_RING_MASK].item = item;
+        ring->slot[tail & AXP_SPSC_RING_MASK].tag = tag;
+        __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+        retVal = true;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_SPSCRing_Get
+ *  This function is called by the consumer to take the item off the head of a
+ *  single-producer/single-consumer ring.
+ *
+ * Input Parameters:
+ *  ring:
+ *      A pointer to the ring from which the item is to be taken.
+ *
+ * Output Parameters:
+ *  slot:
+ *      A pointer to a location to receive the item and its tag.
+ *
+ * Return Value:
+ *  true:   An item was taken off the ring.
+ *  false:  The ring is empty.
+ */
+bool AXP_SPSCRing_Get(AXP_SPSC_RING *ring, AXP_SPSC_SLOT *slot)
+{
+    u32 head = ring->head;
+    bool retVal = false;
+
+    /*
+     * Only the consumer writes the head, so we can read it directly.  The tail
+     * is read with acquire semantics, so that the slot contents written before
+     * it was moved are visible to us.
+     */
+    if (head != __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE))
+    {
+        *slot = ring->slot[head & AXP_SPSC_RING_MASK];
+        __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+        retVal = true;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_SPSCRing_Count
+ *  This function is called to get the number of items currently on a
+ *  single-producer/single-consumer ring.  When called from a thread other than
+ *  the producer or consumer, the value is only a snapshot.
+ *
+ * Input Parameters:
+ *  ring:
+ *      A pointer to the ring to be counted.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The number of items on the ring.
+ */
+u32 AXP_SPSCRing_Count(AXP_SPSC_RING *ring)
+{
+    return (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) -
+            __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE));
+}
+
+/*
+ * AXP_EventCount_Init
+ *  This function is called to initialize an event count.
+ *
+ * Input Parameters:
+ *  ec:
+ *      A pointer to the event count to be initialized.
+ *
+ * Output Parameters:
+ *  ec:
+ *      A pointer to the initialized event count.
+ *
+ * Return Value:
+ *  true:   Event count initialized successfully.
+ *  false:  Event count initialization failed.
+ */
+bool AXP_EventCount_Init(AXP_EVENT_COUNT *ec)
+{
+    bool retVal = false;
+
+    ec->seq = 0;
+    ec->waiters = 0;
+    ec->spin = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? AXP_EVENT_COUNT_SPIN : 0;
+    if (pthread_mutex_init(&ec->mutex, NULL) == 0)
+    {
+        if (pthread_cond_init(&ec->cond, NULL) == 0)
+        {
+            retVal = true;
+        }
+        else
+        {
+            pthread_mutex_destroy(&ec->mutex);
+        }
+    }
+
+    /*
+     * Return the results of the initialization back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_EventCount_Prepare
+ *  This function is called by a consumer, before it checks for work, to get
+ *  the key it will pass to AXP_EventCount_Wait should there be no work.  Any
+ *  signal after this call causes that wait to return immediately.
+ *
+ * Input Parameters:
+ *  ec:
+ *      A pointer to the event count.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The current sequence of the event count.
+ */
+u32 AXP_EventCount_Prepare(AXP_EVENT_COUNT *ec)
+{
+    return (__atomic_load_n(&ec->seq, __ATOMIC_SEQ_CST));
+}
+
+/*
+ * AXP_EventCount_Wait
+ *  This function is called by a consumer that found no work to wait until a
+ *  producer signals the event count.  If the producer has already signaled
+ *  since the key was obtained, this returns without waiting.  Only the
+ *  first signal after the consumer goes to sleep goes through the mutex and
+ *  condition variable.
+ *
+ * Input Parameters:
+ *  ec:
+ *      A pointer to the event count.
+ *  key:
+ *      The value returned by AXP_EventCount_Prepare.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_EventCount_Wait(AXP_EVENT_COUNT *ec, u32 key)
+{
+    u32 spin;
+
+    /*
+     * The producer is usually only a moment behind, so when there is more
+     * than one processor, spin for a little while before paying for the trip
+     * through the mutex and condition variable (and the system call on both
+     * sides that goes along with it).
+     */
+    for (spin = 0; spin < ec->spin; spin++)
+    {
+        if (__atomic_load_n(&ec->seq, __ATOMIC_ACQUIRE) != key)
+        {
+            return;
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    pthread_mutex_lock(&ec->mutex);
+
+    /*
+     * Let the producer know we are about to sleep before looking at the
+     * sequence one last time.  A producer that bumps the sequence after this
+     * point will see the flag and go through the mutex to signal us, and since
+     * we hold the mutex until we are on the condition variable, that signal
+     * cannot be lost.  The producer clears the flag when it signals, so we set
+     * it again each time around.
+     */
+    while (true)
+    {
+        __atomic_store_n(&ec->waiters, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&ec->seq, __ATOMIC_SEQ_CST) != key)
+        {
+            break;
+        }
+        pthread_cond_wait(&ec->cond, &ec->mutex);
+    }
+    pthread_mutex_unlock(&ec->mutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_EventCount_Sleeping
+ *  This function is called by a producer to find out if the consumer of an
+ *  event count is asleep, or about to be.  When the consumer is not, a signal
+ *  costs nothing more than a couple of atomic operations.
+ *
+ * Input Parameters:
+ *  ec:
+ *      A pointer to the event count.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The consumer is, or is about to be, waiting.
+ *  false:  The consumer is not waiting.
+ */
+bool AXP_EventCount_Sleeping(AXP_EVENT_COUNT *ec)
+{
+    return (__atomic_load_n(&ec->waiters, __ATOMIC_SEQ_CST) != 0);
+}
+
+/*
+ * AXP_EventCount_Signal
+ *  This function is called by a producer to wake the consumer waiting on an
+ *  event count.  When there is no one waiting, this is just an atomic
+ *  increment.
+ *
+ * Input Parameters:
+ *  ec:
+ *      A pointer to the event count.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+void AXP_EventCount_Signal(AXP_EVENT_COUNT *ec)
+{
+    __atomic_add_fetch(&ec->seq, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&ec->waiters, 0, __ATOMIC_SEQ_CST) != 0)
+    {
+        pthread_mutex_lock(&ec->mutex);
+        pthread_cond_broadcast(&ec->cond);
+        pthread_mutex_unlock(&ec->mutex);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
 /*
  * AXP_LoadExecutable
  *  This function is called to open an executable file and load the contents
@@ -26,6 +26,10 @@
  *
  *  V01.001 01-Jun-2019 Jonathan D. Belanger
  *  Reformatted to remove tabs and be consistent with other source files.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Wait for the performance counters to be written for the last time before
+ *  exiting.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CommonUtilities/AXP_Utility.h"
@@ -154,6 +158,7 @@ int main(int argc, char **argv)
              */
             AXP_21264_Unlock_CPU(cpu);
             pthread_join(cpu->cBoxThreadID, NULL);
+            AXP_21264_Counters_Stop(cpu);
 
             /*
             * The following calls are just to keep the linker happy.
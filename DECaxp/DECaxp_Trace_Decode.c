@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the code to read in a binary trace file, written
+ *  when AXP_LOGFORMAT=binary, and convert it to the text format written by the
+ *  Digital Alpha AXP 21264 Emulator when tracing to a text file.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Trace.h"
+
+/*
+ * main
+ *  This function is called by the image activator.
+ *
+ * Input Parameters:
+ *  argc:
+ *      A value indicating the number of entries in the argv parameter.  This
+ *      parameter is always one more than the actual arguments provided on the
+ *      command line.
+ *  argv:
+ *      An array, limit argc, of strings representing the image filename being
+ *      executed, followed by the binary trace file and, optionally, the text
+ *      file to be written (the default is standard output).
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  Normal Successful Completion.
+ *  !0: An Error occurred that is causing the image to exit.
+ */
+int main(int argc, char **argv)
+{
+    FILE *inFP;
+    FILE *outFP = stdout;
+    int records;
+    int retVal = 0;
+
+    if ((argc == 2) || (argc == 3))
+    {
+        inFP = fopen(argv[1], "rb");
+        if (argc == 3)
+        {
+            outFP = fopen(argv[2], "w");
+        }
+        if ((inFP != NULL) && (outFP != NULL))
+        {
+            records = AXP_TraceDecode(inFP, outFP);
+            if (records < 0)
+            {
+                fprintf(stderr,
+                        "%%DECAXP-E-NOTTRACE, %s is not a binary trace "
+                        "file.\n",
+                        argv[1]);
+                retVal = -1;
+            }
+        }
+        else
+        {
+            fprintf(stderr,
+                    "%%DECAXP-E-OPENERR, Unable to open %s.\n",
+                    (inFP == NULL) ? argv[1] : argv[2]);
+            retVal = -1;
+        }
+        if (inFP != NULL)
+        {
+            fclose(inFP);
+        }
+        if ((outFP != NULL) && (outFP != stdout))
+        {
+            fclose(outFP);
+        }
+    }
+    else
+    {
+        fprintf(stderr,
+                "%%DECAXP-F-USAGE, DECaxp_Trace_Decode trace-file "
+                "[text-file]\n");
+        retVal = -1;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
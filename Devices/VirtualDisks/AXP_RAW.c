@@ -33,14 +33,27 @@
  *  either have a null value or the address of the block being allocated (so
  *  that it can be replaced) provided on the call, or the call will get a
  *  segmentation fault.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  A RAW disk can now be a file as well as a device, and the handle is
+ *  returned from the open, and the file path is no longer mistaken for a
+ *  block to be replaced when it is allocated.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Added the functions to read and write sectors, which copy them to and from
+ *  the disk's mapping into memory when it has been mapped, and otherwise use
+ *  the file descriptor.
  */
 #include "Devices/VirtualDisks/AXP_RAW.h"
 #include "CommonUtilities/AXP_Blocks.h"
+#include <sys/stat.h>
+#include <errno.h>
 
 /*
  * _GetDiskInfo
  *  This function is called to get various pieces of information from the newly
- *  opened device using ioctl.
+ *  opened device using ioctl.  When it is a file, rather than a device, the
+ *  information comes from the file's status instead.
  *
  * Input Parameters:
  *  raw:
@@ -60,6 +73,25 @@ static bool _GetDiskInfo(AXP_RAW_Handle *raw)
     bool retVal = true, done = false;
     int ioctlCnt = 0;
     int ro;
+    struct stat st;
+
+    /*
+     * A file is as big as it is, and has the standard sector size for the
+     * kind of disk it holds.
+     */
+    if (fstat(raw->fd, &st) != 0)
+    {
+        retVal = false;
+    }
+    else if (S_ISBLK(st.st_mode) == 0)
+    {
+        raw->readOnly = raw->deviceID == STORAGE_TYPE_DEV_ISO;
+        raw->diskSize = st.st_size;
+        raw->blkSize = st.st_blksize;
+        raw->sectorSize = (raw->deviceID == STORAGE_TYPE_DEV_ISO) ?
+            AXP_ISO_SEC_DEF : AXP_VHD_SEC_DEF;
+        done = true;
+    }
 
     /*
      * Let's get information about the device.
@@ -83,7 +115,7 @@ static bool _GetDiskInfo(AXP_RAW_Handle *raw)
 
             case 3:
                 retVal = ioctl(raw->fd, BLKSSZGET, &raw->sectorSize) == 0;
-                /* no break */
+                /* no break */
 
             default:
                 done = true;
@@ -153,12 +185,13 @@ u32 _AXP_RAW_Open(char *path,
     raw = (AXP_RAW_Handle *) AXP_Allocate_Block(AXP_RAW_BLK);
     if (raw != NULL)
     {
+        raw->fd = -1;
 
         /*
          * Allocate a buffer long enough for for the filename (plus null
          * character).
          */
-        raw->filePath = AXP_Allocate_Block(-(strlen(path) + 1), path);
+        raw->filePath = AXP_Allocate_Block(-(strlen(path) + 1), raw->filePath);
         if (raw->filePath != NULL)
         {
             int mode = (deviceID == STORAGE_TYPE_DEV_ISO) ? O_RDONLY : O_RDWR;
@@ -182,6 +215,10 @@ u32 _AXP_RAW_Open(char *path,
                 {
                     retVal = AXP_VHD_READ_FAULT;
                 }
+                else
+                {
+                    *handle = (AXP_VHD_HANDLE) raw;
+                }
             }
             else
             {
@@ -213,3 +250,190 @@ u32 _AXP_RAW_Open(char *path,
      */
     return(retVal);
 }
+
+/*
+ * _AXP_RAW_ReadSectors
+ *  Reads one or more sectors from a RAW disk.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the RAW disk.
+ *  lba:
+ *      A value representing the Logical Block Address from where the read is
+ *      to be started.
+ *  sectorsRead:
+ *      A pointer to a value representing the number of sectors to be read.
+ *
+ * Output Parameters:
+ *  sectorsRead:
+ *      A pointer to an unsigned 32-bit value to receive the actual number of
+ *      sectors read.
+ *  outBuf:
+ *      A pointer to an unsigned 8-bit array in which to receive the read in
+ *      data.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     An error occurred reading from the disk.
+ */
+u32 _AXP_RAW_ReadSectors(AXP_VHD_HANDLE handle,
+                         u64 lba,
+                         u32 *sectorsRead,
+                         u8 *outBuf)
+{
+    AXP_RAW_Handle *raw = (AXP_RAW_Handle *) handle;
+    u64 offset = lba * (u64) raw->sectorSize;
+    size_t length = (size_t) *sectorsRead * raw->sectorSize;
+    size_t done = 0;
+    ssize_t xfer;
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if (raw->mapping != NULL)
+    {
+        retVal = AXP_VHD_MMAP_Read(raw->mapping, offset, outBuf, &length);
+        done = length;
+    }
+    else
+    {
+        while ((done < length) && (retVal == AXP_VHD_SUCCESS))
+        {
+            xfer = pread(raw->fd, &outBuf[done], length - done, offset + done);
+            if (xfer > 0)
+            {
+                done += xfer;
+            }
+            else if ((xfer == 0) || (errno != EINTR))
+            {
+                retVal = AXP_VHD_READ_FAULT;
+            }
+        }
+    }
+    *sectorsRead = done / raw->sectorSize;
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return(retVal);
+}
+
+/*
+ * _AXP_RAW_WriteSectors
+ *  Writes one or more sectors to a RAW disk.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the RAW disk.
+ *  lba:
+ *      A value representing the Logical Block Address from where the write
+ *      is to be started.
+ *  sectorsWritten:
+ *      A pointer to a value representing the number of sectors to be written.
+ *  inBuf:
+ *      A pointer to an unsigned 8-bit array to be written to the disk.
+ *
+ * Output Parameters:
+ *  sectorsWritten:
+ *      A pointer to an unsigned 32-bit value to receive the actual number of
+ *      sectors written.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the disk, or it is
+ *                          read-only.
+ */
+u32 _AXP_RAW_WriteSectors(AXP_VHD_HANDLE handle,
+                          u64 lba,
+                          u32 *sectorsWritten,
+                          u8 *inBuf)
+{
+    AXP_RAW_Handle *raw = (AXP_RAW_Handle *) handle;
+    u64 offset = lba * (u64) raw->sectorSize;
+    size_t length = (size_t) *sectorsWritten * raw->sectorSize;
+    size_t done = 0;
+    ssize_t xfer;
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if (raw->readOnly == true)
+    {
+        retVal = AXP_VHD_WRITE_FAULT;
+    }
+    else if (raw->mapping != NULL)
+    {
+        retVal = AXP_VHD_MMAP_Write(raw->mapping, offset, inBuf, &length);
+        done = length;
+    }
+    else
+    {
+        while ((done < length) && (retVal == AXP_VHD_SUCCESS))
+        {
+            xfer = pwrite(raw->fd, &inBuf[done], length - done, offset + done);
+            if (xfer > 0)
+            {
+                done += xfer;
+            }
+            else if ((xfer == 0) || (errno != EINTR))
+            {
+                retVal = AXP_VHD_WRITE_FAULT;
+            }
+        }
+    }
+    *sectorsWritten = done / raw->sectorSize;
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return(retVal);
+}
+
+/*
+ * _AXP_RAW_SubmitSectors
+ *  Submits a batch of sector reads, writes, and flushes for a RAW disk.  A
+ *  RAW disk has no I/O engine, so this can only be done once it has been
+ *  mapped into memory, and each request is completed before this returns.
+ *  The parameters have already been checked.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the RAW disk.
+ *  reqs:
+ *      A pointer to an array of pointers to the requests.  The op, lba,
+ *      sectors, buf, and done fields are set in each.
+ *  count:
+ *      A value indicating the number of requests.
+ *
+ * Output Parameters:
+ *  reqs:
+ *      A pointer to an array of pointers to the requests, with the offset,
+ *      length, status, transferred, and complete fields set in each.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_CALL_NOT_IMPL:  The disk has not been mapped into memory.
+ */
+u32 _AXP_RAW_SubmitSectors(AXP_VHD_HANDLE handle,
+                           AXP_VHD_IO_REQ **reqs,
+                           u32 count)
+{
+    AXP_RAW_Handle *raw = (AXP_RAW_Handle *) handle;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 ii;
+
+    if (raw->mapping != NULL)
+    {
+        for (ii = 0; ii < count; ii++)
+        {
+            reqs[ii]->offset = reqs[ii]->lba * (u64) raw->sectorSize;
+            reqs[ii]->length = (size_t) reqs[ii]->sectors * raw->sectorSize;
+        }
+        AXP_VHD_MMAP_Submit(raw->mapping, reqs, count);
+    }
+    else
+    {
+        retVal = AXP_VHD_CALL_NOT_IMPL;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return(retVal);
+}
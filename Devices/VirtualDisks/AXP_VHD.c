@@ -29,10 +29,217 @@
  *  either have a null value or the address of the block being allocated (so
  *  that it can be replaced) provided on the call, or the call will get a
  *  segmentation fault.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  The file is no longer truncated when it is reopened for read/write, and
+ *  the disk type is now written to the footer, so that a newly created VHD
+ *  can be opened.  The sector size is no longer derived from the CHS
+ *  geometry.  The sectors of a fixed VHD are read and written by an
+ *  asynchronous I/O engine, which can also be given a batch of them to
+ *  complete asynchronously.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  The sectors of a dynamic or differencing VHD are now read and written
+ *  using a block map kept in memory, and blocks are allocated a batch at a
+ *  time.  A differencing VHD can be created, and its parent is opened with
+ *  it.  Creating a dynamic VHD no longer clears the BAT offset before the
+ *  Dynamic Disk Header is written, pads the BAT to a sector rather than
+ *  writing past its end, and calculates the footer checksum after the data
+ *  offset is set.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Once a fixed VHD has been mapped into memory, its sectors are read and
+ *  written by copying them to and from the mapping.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped lines longer than 80 columns.
  */
 #include "CommonUtilities/AXP_Blocks.h"
 #include "Devices/VirtualDisks/AXP_VHD.h"
 #include "Devices/VirtualDisks/AXP_VHDX.h"
+#include "Devices/VirtualDisks/AXP_VHD_BlockMap.h"
+#include "Devices/VirtualDisks/AXP_VirtualDisk.h"
+#include <limits.h>
+
+/*
+ * _AXP_VHD_ParentLocator
+ *  This function is called to build the W2ku parent locator for a
+ *  differencing disk, which is the absolute path to the parent as a UTF-16
+ *  string.  Each byte of the path is stored as one character, so the path
+ *  comes back exactly as it was.
+ *
+ * Input Parameters:
+ *  parentPath:
+ *      A pointer to the path to the parent.
+ *
+ * Output Parameters:
+ *  locatorLen:
+ *      A pointer to the number of bytes in the locator.
+ *
+ * Return Values:
+ *  NULL:       The path could not be resolved, or there was no memory.
+ *  Otherwise:  A pointer to the locator, to be freed by the caller.
+ */
+static u16 *_AXP_VHD_ParentLocator(char *parentPath, u32 *locatorLen)
+{
+    char absPath[PATH_MAX];
+    u16 *retVal = NULL;
+    size_t ii, len;
+
+    if (realpath(parentPath, absPath) != NULL)
+    {
+        len = strlen(absPath);
+        retVal = calloc(len, sizeof(u16));
+        if (retVal != NULL)
+        {
+            for (ii = 0; ii < len; ii++)
+            {
+                retVal[ii] = (u8) absPath[ii];
+            }
+            *locatorLen = len * sizeof(u16);
+        }
+    }
+
+    /*
+     * Return the locator back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_OpenParent
+ *  This function is called to open the parent of a differencing disk, using
+ *  the disk's W2ku parent locator.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the differencing disk.
+ *  dyn:
+ *      A pointer to the disk's Dynamic Disk Header.
+ *
+ * Output Parameters:
+ *  vhd:
+ *      A pointer to the handle, with the parent's handle set.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_FILE_CORRUPT:   There is no parent locator the parent can be found
+ *                          with.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory to perform operation.
+ *  Otherwise, the status of opening the parent.
+ */
+static u32 _AXP_VHD_OpenParent(AXP_VHDX_Handle *vhd, AXP_VHD_Dynamic *dyn)
+{
+    AXP_VHD_ParentLoc *loc = NULL;
+    char *parentPath;
+    u16 *locator;
+    size_t outLen;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 ii;
+
+    for (ii = 0; ((ii < AXP_VHD_PARENT_LOC_CNT) && (loc == NULL)); ii++)
+    {
+        if ((dyn->parentLoc[ii].code == AXP_VHD_PCODE_W2ku) &&
+            (dyn->parentLoc[ii].dataLen != 0))
+        {
+            loc = &dyn->parentLoc[ii];
+        }
+    }
+    if (loc != NULL)
+    {
+        locator = malloc(loc->dataLen);
+        parentPath = calloc((loc->dataLen / sizeof(u16)) + 1, sizeof(char));
+        if ((locator != NULL) && (parentPath != NULL))
+        {
+            outLen = loc->dataLen;
+            if ((AXP_ReadFromOffset(vhd->fp,
+                                    (u8 *) locator,
+                                    &outLen,
+                                    loc->dataOff) == true) &&
+                (outLen == loc->dataLen))
+            {
+                for (ii = 0; ii < (loc->dataLen / sizeof(u16)); ii++)
+                {
+                    parentPath[ii] = (char) locator[ii];
+                }
+                retVal = _AXP_VHD_Open(parentPath,
+                                       OPEN_NONE,
+                                       STORAGE_TYPE_DEV_VHD,
+                                       &vhd->parent);
+            }
+            else
+            {
+                retVal = AXP_VHD_FILE_CORRUPT;
+            }
+        }
+        else
+        {
+            retVal = AXP_VHD_OUTOFMEMORY;
+        }
+        free(locator);
+        free(parentPath);
+    }
+    else
+    {
+        retVal = AXP_VHD_FILE_CORRUPT;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_LoadMap
+ *  This function is called when a dynamic or differencing VHD is opened, to
+ *  fill in the block map from the BAT.  Each BAT entry is the sector offset
+ *  of the block's sector bitmap, and the block's data follows the bitmap.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle, with the BAT read in.
+ *  footerOff:
+ *      A value indicating the offset of the footer at the end of the file.
+ *      This is where the next block will be allocated.
+ *
+ * Output Parameters:
+ *  vhd:
+ *      A pointer to the handle, with the block map filled in.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory for the block map.
+ */
+static u32 _AXP_VHD_LoadMap(AXP_VHDX_Handle *vhd, u64 footerOff)
+{
+    AXP_VHD_BAT_ENT *bat = (AXP_VHD_BAT_ENT *) vhd->bat;
+    u32 bitmapSize;
+    u32 retVal;
+    u32 ii;
+
+    bitmapSize = ((vhd->blkSize / vhd->sectorSize) + 7) / 8;
+    bitmapSize += (AXP_VHD_SEC_DEF - (bitmapSize % AXP_VHD_SEC_DEF)) %
+                  AXP_VHD_SEC_DEF;
+    retVal = AXP_VHD_MapInit(vhd, vhd->batCount, bitmapSize);
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+        for (ii = 0; ii < vhd->batCount; ii++)
+        {
+            if (bat[ii] != AXP_VHD_BAT_UNUSED)
+            {
+                vhd->blkOffsets[ii] = ((u64) bat[ii] * AXP_VHD_SEC_DEF) +
+                                      bitmapSize;
+            }
+        }
+        vhd->fileEnd = footerOff;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
 
 /*
  * AXP_VHD_Checksum
@@ -243,8 +450,11 @@ u32 _AXP_VHD_Create(char *path,
     AXP_VHDX_Handle *vhd;
     AXP_VHD_Footer foot;
     AXP_VHD_Dynamic dyn;
+    AXP_VHD_DiskGeo chs;
     u64 eofOff;
     time_t now;
+    u16 *locator = NULL;
+    u32 locatorLen = 0;
     u32 retVal = AXP_VHD_SUCCESS;
     bool writeRet = true;
 
@@ -313,6 +523,40 @@ u32 _AXP_VHD_Create(char *path,
         retVal = AXP_VHD_OUTOFMEMORY;
     }
 
+    /*
+     * A differencing disk is the same size as its parent, and has a parent
+     * locator that gets back to it.  The parent is kept open, so that the
+     * sectors the differencing disk does not have can be read from it.
+     */
+    if ((retVal == AXP_VHD_SUCCESS) &&
+        (vhd->fixed == false) &&
+        (parentPath != NULL))
+    {
+        retVal = _AXP_VHD_Open(parentPath,
+                               OPEN_NONE,
+                               STORAGE_TYPE_DEV_VHD,
+                               &vhd->parent);
+        if (retVal == AXP_VHD_SUCCESS)
+        {
+            vhd->differencing = true;
+            diskSize = ((AXP_VHDX_Handle *) vhd->parent)->diskSize;
+            vhd->diskSize = diskSize;
+            locator = _AXP_VHD_ParentLocator(parentPath, &locatorLen);
+            if (locator == NULL)
+            {
+                retVal = AXP_VHD_OUTOFMEMORY;
+            }
+        }
+        if (retVal != AXP_VHD_SUCCESS)
+        {
+            fclose(vhd->fp);
+            vhd->fp = NULL;
+            remove(path);
+            AXP_VHD_MapFree(vhd);
+            AXP_Deallocate_Block(vhd);
+        }
+    }
+
     /*
      * OK, if we get this far, the parameters are good, the handle has been
      * created, and the file has been opened.  Now it's time to initialize it.
@@ -398,14 +642,27 @@ u32 _AXP_VHD_Create(char *path,
         foot.cookie = AXP_VHDFILE_SIG;
         foot.features = AXP_FEATURES_RES;
         foot.formatVer = AXP_FORMAT_VER;
-        foot.dataOffset = vhd->fixed ? AXP_FIXED_OFFSET : 0;
+        foot.dataOffset = vhd->fixed ?
+            AXP_FIXED_OFFSET :
+            sizeof(AXP_VHD_Footer);
         time(&now);
         foot.timestamp = (u32) (now - 946684800); /* secs from 01/01/00 0:00 */
         foot.creator = AXP_VHD_CREATOR;
         foot.creatorVer = AXP_CREATOR_VER;
         foot.creatorHostOS = AXP_CREATOR_HOST;
         foot.originalSize = foot.currentSize = diskSize;
-        AXP_VHD_CHSCalc(diskSize, sectorSize, &foot.chs);
+        AXP_VHD_CHSCalc(diskSize, sectorSize, &chs);
+        foot.chs = chs;
+        if (vhd->fixed == true)
+        {
+            foot.diskType = DiskFixed;
+        }
+        else
+        {
+            foot.diskType = (vhd->parent == NULL) ?
+                DiskDynamic :
+                DiskDifferencing;
+        }
         foot.checksum = AXP_VHD_Checksum((u8 *) &foot, sizeof(AXP_VHD_Footer));
 
         /*
@@ -458,94 +715,113 @@ u32 _AXP_VHD_Create(char *path,
          */
         if (vhd->fixed == false)
         {
-            u32 unused, ii;
             u64 curOffset = 0;
-            AXP_VHD_BAT_ENT blockOff = AXP_VHD_BAT_UNUSED;
-
-            /*
-             * Because this is a dynamic file, the footer is replicated at the
-             * top of the file and the Dynamic Disk Header record is after
-             * that.  Therefore, the dataOffset for the record at the top of
-             * the file should be set to the location where the Dynamic Disk
-             * Header Record begins.
-             */
-            foot.dataOffset = sizeof(AXP_VHD_Footer);
+            u32 bitmapSize;
+            u32 ii;
 
             /*
-             * Initialize the Dynamic Disk Header Record
+             * Initialize the Dynamic Disk Header Record.  Because this is a
+             * dynamic file, the footer is replicated at the top of the file
+             * and the Dynamic Disk Header record is after that.  The BAT
+             * follows the Dynamic Disk Header, and always ends on a sector
+             * boundary, so there may be some additional unused entries.
              */
             memset(&dyn, 0, sizeof(AXP_VHD_Dynamic));
             dyn.cookie = AXP_VHD_DYNAMIC_SIG;
             dyn.dataOff = AXP_VHD_DATA_OFFSET;
             vhd->batOffset = dyn.tableOff = sizeof(AXP_VHD_Footer) +
                     sizeof(AXP_VHD_Dynamic);
-            vhd->batCount = dyn.maxTableEnt = diskSize / blkSize;
+            vhd->batCount = dyn.maxTableEnt =
+                (diskSize + blkSize - 1) / blkSize;
             vhd->batLength = vhd->batCount * sizeof(AXP_VHD_BAT_ENT);
+            vhd->batLength += (AXP_VHD_SEC_DEF -
+                               (vhd->batLength % AXP_VHD_SEC_DEF)) %
+                              AXP_VHD_SEC_DEF;
             dyn.headerVer = AXP_VHD_HEADER_VER;
             dyn.blockSize = blkSize;
+            curOffset = vhd->batOffset + vhd->batLength;
+
+            /*
+             * A differencing disk has the path to its parent in the Parent
+             * Unicode Name, and in a parent locator just after the BAT.
+             */
+            if (vhd->parent != NULL)
+            {
+                for (ii = 0;
+                     ((ii < (locatorLen / sizeof(u16))) &&
+                      (ii < (AXP_VHD_PARENT_NAME_LEN - 1)));
+                     ii++)
+                {
+                    dyn.parentName[ii] = (locator[ii] << 8) |
+                                         (locator[ii] >> 8);
+                }
+                dyn.parentLoc[0].code = AXP_VHD_PCODE_W2ku;
+                dyn.parentLoc[0].dataLen = locatorLen;
+                dyn.parentLoc[0].dataSpace =
+                    (locatorLen + AXP_VHD_SEC_DEF - 1) / AXP_VHD_SEC_DEF;
+                dyn.parentLoc[0].dataOff = curOffset;
+                curOffset += dyn.parentLoc[0].dataSpace * AXP_VHD_SEC_DEF;
+            }
             dyn.checksum = AXP_VHD_Checksum((u8 *) &dyn,
                                             sizeof(AXP_VHD_Dynamic));
+            eofOff = curOffset;
 
             /*
-             * Now we need to figure out the Block Allocation Table (BAT).  The
-             * BAT always ends on a sector boundary, so we may have some
-             * additional unused BAT entries.
-             *
-             * The number of unused entries is the distance, in u32 values, to
-             * the end of the sector.  This is calculated as follows:
-             *
-             *  sectorSize - ((tableOffset + tableSize) % sectorSize)
-             *  tableSize = maxTableEntries * 4 [size of 32-bit offset value]
-             *
+             * Every block has a sector bitmap in front of it, which is
+             * padded out to a sector boundary.
              */
-            unused = sectorSize -
-                    ((dyn.tableOff + (dyn.maxTableEnt * sizeof(u32))) %
-                       sectorSize);
-
+            bitmapSize = ((blkSize / sectorSize) + 7) / 8;
+            bitmapSize += (AXP_VHD_SEC_DEF - (bitmapSize % AXP_VHD_SEC_DEF)) %
+                          AXP_VHD_SEC_DEF;
             vhd->bat = AXP_Allocate_Block(-vhd->batLength, vhd->bat);
             if (vhd->bat != NULL)
             {
-                AXP_VHD_BAT_ENT *batPtr = (AXP_VHD_BAT_ENT *) vhd->bat;
+                retVal = AXP_VHD_MapInit(vhd, vhd->batCount, bitmapSize);
+                vhd->fileEnd = eofOff;
+            }
+            else
+            {
+                retVal = AXP_VHD_OUTOFMEMORY;
+            }
+            if (retVal == AXP_VHD_SUCCESS)
+            {
+                memset(vhd->bat, 0xff, vhd->batLength);
 
                 /*
                  * So we are ready to write out the dynamic portions of the VHD
                  * file.  The initial file will be laid out as follows:
                  *
-                 *   1) Copy of hard disk footer    512
-                 *   2) Dynamic Disk Header        1024
+                 *   1) Copy of hard disk footer        512
+                 *   2) Dynamic Disk Header             1024
                  *   3) BAT (Block Allocation table)    As needed.
-                 *   4) Hard Disk Footer        512
+                 *   4) Parent locator                  As needed.
+                 *   5) Hard Disk Footer                512
                  */
                 writeRet = AXP_WriteAtOffset(vhd->fp,
                                              &foot,
                                              sizeof(AXP_VHD_Footer),
-                                             curOffset);
-                dyn.tableOff = 0; /* there is nothing after the footer record */
-                curOffset += sizeof(AXP_VHD_Footer);
+                                             0);
                 if (writeRet == true)
                 {
                     writeRet = AXP_WriteAtOffset(vhd->fp,
                                                  &dyn,
                                                  sizeof(AXP_VHD_Dynamic),
-                                                 curOffset);
+                                                 sizeof(AXP_VHD_Footer));
                 }
-                curOffset += sizeof(AXP_VHD_Dynamic);
-                for (ii = 0;
-                     ((ii < (dyn.maxTableEnt + unused)) && (writeRet == true));
-                     ii++)
+                if (writeRet == true)
                 {
-                    batPtr[ii] = blockOff;
                     writeRet = AXP_WriteAtOffset(vhd->fp,
-                                                 &blockOff,
-                                                 sizeof(blockOff),
-                                                 curOffset);
-                    curOffset += sizeof(blockOff);
+                                                 vhd->bat,
+                                                 vhd->batLength,
+                                                 vhd->batOffset);
+                }
+                if ((writeRet == true) && (vhd->parent != NULL))
+                {
+                    writeRet = AXP_WriteAtOffset(vhd->fp,
+                                                 locator,
+                                                 locatorLen,
+                                                 dyn.parentLoc[0].dataOff);
                 }
-                eofOff = curOffset;
-            }
-            else
-            {
-                retVal = AXP_VHD_OUTOFMEMORY;
             }
         }
         else
@@ -565,15 +841,17 @@ u32 _AXP_VHD_Create(char *path,
         }
         if ((writeRet == true) && (retVal == AXP_VHD_SUCCESS))
         {
-            vhd->fp = freopen(path, "wb+", vhd->fp);
+            vhd->fp = freopen(path, "rb+", vhd->fp);
             if (vhd->fp == NULL)
             {
                 remove(path); /* Delete the file */
+                AXP_VHD_MapFree(vhd);
                 AXP_Deallocate_Block(vhd);
                 retVal = AXP_VHD_INV_HANDLE;
             }
             else
             {
+                AXP_VHD_StartIO(vhd);
                 *handle = (AXP_VHD_HANDLE) vhd;
             }
         }
@@ -585,6 +863,7 @@ u32 _AXP_VHD_Create(char *path,
             }
             vhd->fp = NULL; /* Prevent Deallocate Blocks closing again */
             remove(path); /* Delete the file */
+            AXP_VHD_MapFree(vhd);
             AXP_Deallocate_Block(vhd);
             if (retVal == AXP_VHD_SUCCESS)
             {
@@ -593,6 +872,8 @@ u32 _AXP_VHD_Create(char *path,
         }
     }
 
+    free(locator);
+
     /*
      * Return the result of this call back to the caller.
      */
@@ -632,8 +913,10 @@ u32 _AXP_VHD_Open(char *path,
 {
     AXP_VHDX_Handle *vhd;
     AXP_VHD_Footer *footer;
+    AXP_VHD_Dynamic dyn;
     u8 footerBuf[sizeof(AXP_VHD_Footer) + 1];
     i64 fileSize;
+    i64 footerOff;
     size_t outLen;
     u32 retVal = AXP_VHD_SUCCESS;
     u32 oldChecksum;
@@ -763,10 +1046,14 @@ u32 _AXP_VHD_Open(char *path,
                                 vhd->cylinders = footer->chs.cylinders;
                                 vhd->heads = footer->chs.heads;
                                 vhd->sectors = footer->chs.sectors;
-                                vhd->sectorSize = vhd->diskSize /
-                                        ((u64) vhd->cylinders *
-                                         (u64) vhd->heads *
-                                         (u64) vhd->sectors);
+
+                                /*
+                                 * The CHS geometry only approximates the
+                                 * size of the disk, so it cannot be used to
+                                 * determine the sector size.  A VHD's sectors
+                                 * are always 512 bytes.
+                                 */
+                                vhd->sectorSize = AXP_VHD_SEC_DEF;
                                 vhd->fixed = footer->diskType == DiskFixed;
                             }
                             else
@@ -783,7 +1070,6 @@ u32 _AXP_VHD_Open(char *path,
                         if ((retVal == AXP_VHD_SUCCESS) &&
                             (vhd->fixed == false))
                         {
-                            AXP_VHD_Dynamic dyn;
 
                             /*
                              * The footer record is 512 bytes and the dynamic
@@ -838,23 +1124,49 @@ u32 _AXP_VHD_Open(char *path,
                                  * BAT information, but first allocate an array
                                  * of sufficient size.
                                  */
-                                vhd->bat = AXP_Allocate_Block(-vhd->batLength,
-                                                              vhd->bat);
-                                if (vhd->bat != NULL)
+                                if (retVal == AXP_VHD_SUCCESS)
                                 {
-                                    outLen = vhd->batLength;
-                                    if (AXP_ReadFromOffset(vhd->fp,
-                                                           (u8 *) vhd->bat,
-                                                           &outLen,
-                                                           vhd->batOffset)
-                                        == false)
+                                    vhd->bat =
+                                        AXP_Allocate_Block(-vhd->batLength,
+                                                           vhd->bat);
+                                    if (vhd->bat != NULL)
+                                    {
+                                        outLen = vhd->batLength;
+                                        if (AXP_ReadFromOffset(vhd->fp,
+                                                               (u8 *) vhd->bat,
+                                                               &outLen,
+                                                               vhd->batOffset)
+                                            == false)
+                                        {
+                                            retVal = AXP_VHD_READ_FAULT;
+                                        }
+                                    }
+                                    else
                                     {
-                                        retVal = AXP_VHD_READ_FAULT;
+                                        retVal = AXP_VHD_OUTOFMEMORY;
                                     }
                                 }
-                                else
+
+                                /*
+                                 * Build the block map from the BAT.  New
+                                 * blocks go where the footer is now.  Then, if
+                                 * this is a differencing disk, open its
+                                 * parent.
+                                 */
+                                if (retVal == AXP_VHD_SUCCESS)
                                 {
-                                    retVal = AXP_VHD_OUTOFMEMORY;
+                                    footerOff = fileSize -
+                                                sizeof(AXP_VHD_Footer) +
+                                                ((u8 *) footer - footerBuf);
+                                    retVal = _AXP_VHD_LoadMap(vhd, footerOff);
+                                }
+                                vhd->differencing =
+                                    footer->diskType == DiskDifferencing;
+                                if ((retVal == AXP_VHD_SUCCESS) &&
+                                    (vhd->differencing == true) &&
+                                    (flags != OPEN_NO_PARENTS))
+                                {
+                                    retVal = _AXP_VHD_OpenParent(vhd, &dyn);
                                 }
                             }
                             else
@@ -894,13 +1206,14 @@ u32 _AXP_VHD_Open(char *path,
      */
     if (retVal == AXP_VHD_SUCCESS)
     {
-        vhd->fp = freopen(path, "wb+", vhd->fp);
+        vhd->fp = freopen(path, "rb+", vhd->fp);
         if (vhd->fp == NULL)
         {
             retVal = AXP_VHD_INV_HANDLE;
         }
         else
         {
+            AXP_VHD_StartIO(vhd);
             *handle = (AXP_VHD_HANDLE) vhd;
         }
     }
@@ -912,6 +1225,7 @@ u32 _AXP_VHD_Open(char *path,
      */
     if ((retVal != AXP_VHD_SUCCESS) && (vhd != NULL ))
     {
+        AXP_VHD_MapFree(vhd);
         AXP_Deallocate_Block(vhd);
     }
 
@@ -932,14 +1246,14 @@ u32 _AXP_VHD_Open(char *path,
  *  lba:
  *      A value representing the Logical Block Address from where the read is
  *      to be started.
- *  sectorsRead: TODO
+ *  sectorsRead:
  *      A pointer to a value representing the number of sectors to be read from
  *      the VHD.
  *
  * Output Parameters:
- *  sectorsRead: TODO
+ *  sectorsRead:
  *      A pointer to an unsigned 32-bit value to receive the actual number of
- *      bytes read.
+ *      sectors read.
  *  outBuf:
  *      A pointer to an unsigned 8-bit array in which to receive the read in
  *      data.
@@ -950,77 +1264,45 @@ u32 _AXP_VHD_Open(char *path,
  */
 u32 _AXP_VHD_ReadSectors(AXP_VHD_HANDLE handle,
                          u64 lba,
-                         size_t *sectorsRead,
+                         u32 *sectorsRead,
                          u8 *outBuf)
 {
     AXP_VHDX_Handle *vhd = (AXP_VHDX_Handle *) handle;
     u64 offset;
+    size_t length;
     u32 retVal = AXP_VHD_SUCCESS;
 
     /*
      * If this is a fixed sized VHD, then all the blocks for the disk have been
-     * preallocated.  Go ahead and read from the file.
+     * preallocated.  Go ahead and read from the file, or copy from it if it
+     * has been mapped into memory.
      */
     if (vhd->fixed == true)
     {
         offset = lba * (u64) vhd->sectorSize;
-        *sectorsRead *= vhd->sectorSize;
-        if (AXP_ReadFromOffset(vhd->fp, outBuf, sectorsRead, offset) == true)
+        length = (size_t) *sectorsRead * vhd->sectorSize;
+        if (vhd->mapping != NULL)
         {
-            *sectorsRead /= vhd->sectorSize;
+            retVal = AXP_VHD_MMAP_Read(vhd->mapping, offset, outBuf, &length);
         }
         else
         {
-            retVal = AXP_VHD_READ_FAULT;
+            retVal = AXP_VHD_Transfer(vhd,
+                                       AXP_VHD_IO_Read,
+                                       offset,
+                                       outBuf,
+                                       &length);
         }
+        *sectorsRead = length / vhd->sectorSize;
     }
 
     /*
-     * OK, we have a dynamic VHD.  We need to determine a few things.  First,
-     * is the block we are looking to read in the file.  And second, if it is,
-     * then find out where it is located and read it in.  NOTE: There is
-     * nothing to say that sectors are continuous, so we are going to have read
-     * them in one at a time.
+     * OK, we have a dynamic or differencing VHD.  The block map knows where
+     * each block is in the file, if it is there at all.
      */
     else
     {
-        AXP_VHD_BAT_ENT *bat = (AXP_VHD_BAT_ENT *) vhd->bat;
-        u8 *bufPtr = outBuf;
-        u32 sectorsPerBlk = vhd->blkSize / vhd->sectorSize;
-        u64 blkNum = lba / (u64) sectorsPerBlk;
-        u32 bitMapBytes = (7 + sectorsPerBlk) / 8;
-        u32 bitMapSects = (bitMapBytes + vhd->sectorSize - 1) / vhd->sectorSize;
-        u32 sectorsInRead = sectorsPerBlk - lba % sectorsPerBlk;
-        u32 sectorsRem = *sectorsRead;
-        u64 bytesInRead = sectorsInRead * vhd->sectorSize;
-
-        *sectorsRead = 0;
-        while ((sectorsRem > 0) && (retVal == AXP_VHD_SUCCESS))
-        {
-            if (bat[blkNum] == AXP_VHD_BAT_UNUSED)
-            {
-                memset(bufPtr, 0, bytesInRead);
-            }
-            else
-            {
-                offset = ((u64) bat[blkNum] + lba % (u64) sectorsPerBlk
-                        + (u64) bitMapSects)
-                        * (u64) vhd->sectorSize;
-                if (AXP_ReadFromOffset(vhd->fp,
-                                       bufPtr,
-                                       (size_t *) &bytesInRead,
-                                       offset) == true)
-                {
-                    /* TODO: finish */
-                    sectorsRem -= sectorsInRead;
-                    bufPtr = &bufPtr[bytesInRead];
-                }
-                else
-                {
-                    retVal = AXP_VHD_READ_FAULT;
-                }
-            }
-        }
+        retVal = AXP_VHD_MapRead(vhd, lba, sectorsRead, outBuf);
     }
 
     /*
@@ -1040,16 +1322,16 @@ u32 _AXP_VHD_ReadSectors(AXP_VHD_HANDLE handle,
  *  lba:
  *      A value representing the Logical Block Address from where the read is
  *      to be started.
- *  sectorsWritten: TODO
+ *  sectorsWritten:
  *      A pointer to a value representing the number of sectors to be written
  *      to the VHD.
  *  inBuf:
  *      A pointer to an unsigned 8-bit array to be written to the file.
  *
  * Output Parameters:
- *  sectorsWritten: TODO
+ *  sectorsWritten:
  *      A pointer to an unsigned 32-bit value to receive the actual number of
- *      bytes written.
+ *      sectors written.
  *
  * Return Values:
  *  AXP_VHD_SUCCESS:        Normal Successful Completion.
@@ -1062,39 +1344,261 @@ u32 _AXP_VHD_WriteSectors(AXP_VHD_HANDLE handle,
 {
     AXP_VHDX_Handle *vhd = (AXP_VHDX_Handle *) handle;
     u64 offset;
+    size_t length;
     u32 retVal = AXP_VHD_SUCCESS;
 
     /*
      * If this is a fixed sized VHD, then all the blocks for the disk have been
-     * preallocated.  Go ahead and read from the file.
+     * preallocated.  Go ahead and write to the file, or copy to it if it has
+     * been mapped into memory.
      */
     if (vhd->fixed == true)
     {
         offset = lba * (u64) vhd->sectorSize;
-        *sectorsWritten *= vhd->sectorSize;
-        if (AXP_WriteAtOffset(vhd->fp,
-                              inBuf,
-                              (size_t) sectorsWritten,
-                              offset) == true)
+        length = (size_t) *sectorsWritten * vhd->sectorSize;
+        if (vhd->mapping != NULL)
         {
-            *sectorsWritten /= vhd->sectorSize;
+            retVal = AXP_VHD_MMAP_Write(vhd->mapping, offset, inBuf, &length);
         }
         else
         {
-            retVal = AXP_VHD_WRITE_FAULT;
+            retVal = AXP_VHD_Transfer(vhd,
+                                       AXP_VHD_IO_Write,
+                                       offset,
+                                       inBuf,
+                                       &length);
         }
+        *sectorsWritten = length / vhd->sectorSize;
     }
 
     /*
-     * OK, we have a dynamic VHD.  We need to determine a few things.  First,
-     * is the block we are looking to write in the file.  And second, if it is,
-     * then find out where it is located and write it.  NOTE: There is
-     * nothing to say that sectors are contiguous, so we are going to have to
-     * write them one at a time.
+     * OK, we have a dynamic or differencing VHD.  The block map allocates any
+     * blocks that are not yet in the file before writing to them.
      */
     else
     {
+        retVal = AXP_VHD_MapWrite(vhd, lba, sectorsWritten, inBuf);
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_SubmitSectors
+ *  Submits a batch of sector reads, writes, and flushes for a virtual hard
+ *  disk (VHD) image file, to be completed asynchronously.  The parameters
+ *  have already been checked.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the virtual disk.
+ *  reqs:
+ *      A pointer to an array of pointers to the requests.  The op, lba,
+ *      sectors, buf, and done fields are set in each.
+ *  count:
+ *      A value indicating the number of requests.
+ *
+ * Output Parameters:
+ *  reqs:
+ *      A pointer to an array of pointers to the requests, with the offset and
+ *      length in the file set in each.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_CALL_NOT_IMPL:  A fixed VHD has neither an I/O engine nor a
+ *                          mapping into memory.
+ *  AXP_VHD_WRITE_FAULT:    The requests could not be submitted.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory to perform operation.
+ */
+u32 _AXP_VHD_SubmitSectors(AXP_VHD_HANDLE handle,
+                           AXP_VHD_IO_REQ **reqs,
+                           u32 count)
+{
+    AXP_VHDX_Handle *vhd = (AXP_VHDX_Handle *) handle;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 ii;
+
+    /*
+     * The sectors of a fixed VHD are at the start of the file, in order.  When
+     * they have been mapped into memory, the requests are completed by
+     * copying them, rather than by the I/O engine.
+     */
+    if ((vhd->fixed == true) &&
+        ((vhd->mapping != NULL) || (vhd->io != NULL)))
+    {
+        for (ii = 0; ii < count; ii++)
+        {
+            reqs[ii]->offset = reqs[ii]->lba * (u64) vhd->sectorSize;
+            reqs[ii]->length = (size_t) reqs[ii]->sectors * vhd->sectorSize;
+        }
+        if (vhd->mapping != NULL)
+        {
+            AXP_VHD_MMAP_Submit(vhd->mapping, reqs, count);
+        }
+        else
+        {
+            retVal = AXP_VHD_IO_Submit(vhd->io, reqs, count);
+        }
+    }
+
+    /*
+     * The sectors of a dynamic or differencing VHD are wherever their blocks
+     * were allocated.
+     */
+    else if (vhd->blkOffsets != NULL)
+    {
+        retVal = AXP_VHD_MapSubmit(vhd, reqs, count);
+    }
+    else
+    {
+        retVal = AXP_VHD_CALL_NOT_IMPL;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_AllocateBlocks
+ *  Allocates blocks at the end of a dynamic or differencing virtual hard disk
+ *  (VHD) image file.  The blocks are put one after the other where the footer
+ *  is now, and the footer is moved after the last of them.  The BAT entries
+ *  for all the blocks are written with a single write.  The caller holds the
+ *  block map mutex.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the virtual disk.
+ *  blks:
+ *      A pointer to an array of the numbers of the blocks to be allocated.
+ *  count:
+ *      A value indicating the number of blocks in the array.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     An error occurred reading the footer.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the VHD file.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory to perform operation.
+ */
+u32 _AXP_VHD_AllocateBlocks(AXP_VHD_HANDLE handle, u32 *blks, u32 count)
+{
+    AXP_VHDX_Handle *vhd = (AXP_VHDX_Handle *) handle;
+    AXP_VHD_BAT_ENT *bat = (AXP_VHD_BAT_ENT *) vhd->bat;
+    u8 footer[sizeof(AXP_VHD_Footer)];
+    u8 *bitmap = NULL;
+    u64 offset = vhd->fileEnd;
+    size_t length = sizeof(AXP_VHD_Footer);
+    u32 retVal;
+    u32 lo = vhd->batCount;
+    u32 hi = 0;
+    u32 ii;
+
+    if (vhd->differencing == false)
+    {
+        bitmap = malloc(vhd->bitmapSize);
+        if (bitmap != NULL)
+        {
+            memset(bitmap, 0xff, vhd->bitmapSize);
+        }
+    }
+    if ((vhd->differencing == false) && (bitmap == NULL))
+    {
+        retVal = AXP_VHD_OUTOFMEMORY;
+    }
+    else
+    {
+        retVal = AXP_VHD_Transfer(vhd,
+                                  AXP_VHD_IO_Read,
+                                  offset,
+                                  footer,
+                                  &length);
+        if ((retVal == AXP_VHD_SUCCESS) && (length != sizeof(AXP_VHD_Footer)))
+        {
+            retVal = AXP_VHD_READ_FAULT;
+        }
+    }
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+
+        /*
+         * Each block is its sector bitmap followed by its data.
+         */
+        for (ii = 0; ii < count; ii++)
+        {
+            bat[blks[ii]] = offset / AXP_VHD_SEC_DEF;
+            vhd->blkOffsets[blks[ii]] = offset + vhd->bitmapSize;
+            offset += vhd->bitmapSize + vhd->blkSize;
+            lo = (blks[ii] < lo) ? blks[ii] : lo;
+            hi = (blks[ii] > hi) ? blks[ii] : hi;
+        }
+
+        /*
+         * Move the footer to the new end of the file, which also extends the
+         * file with zeros.  The only part of the new blocks that was not zero
+         * is where the footer was.  All the sectors in a new block of a
+         * dynamic disk are present, so each one's sector bitmap is all ones.
+         */
+        retVal = AXP_VHD_Transfer(vhd,
+                                  AXP_VHD_IO_Write,
+                                  offset,
+                                  footer,
+                                  &length);
+        if ((retVal == AXP_VHD_SUCCESS) && (vhd->differencing == true))
+        {
+            memset(footer, 0, sizeof(footer));
+            retVal = AXP_VHD_Transfer(vhd,
+                                      AXP_VHD_IO_Write,
+                                      vhd->fileEnd,
+                                      footer,
+                                      &length);
+        }
+        for (ii = 0;
+             ((ii < count) &&
+              (retVal == AXP_VHD_SUCCESS) &&
+              (vhd->differencing == false));
+             ii++)
+        {
+            length = vhd->bitmapSize;
+            retVal = AXP_VHD_Transfer(vhd,
+                                      AXP_VHD_IO_Write,
+                                      vhd->blkOffsets[blks[ii]] -
+                                      vhd->bitmapSize,
+                                      bitmap,
+                                      &length);
+        }
+        if (retVal == AXP_VHD_SUCCESS)
+        {
+            length = (hi - lo + 1) * sizeof(AXP_VHD_BAT_ENT);
+            retVal = AXP_VHD_Transfer(vhd,
+                                      AXP_VHD_IO_Write,
+                                      vhd->batOffset +
+                                      (lo * sizeof(AXP_VHD_BAT_ENT)),
+                                      (u8 *) &bat[lo],
+                                      &length);
+        }
+        if (retVal == AXP_VHD_SUCCESS)
+        {
+            vhd->fileEnd = offset;
+        }
+        else
+        {
+            for (ii = 0; ii < count; ii++)
+            {
+                bat[blks[ii]] = AXP_VHD_BAT_UNUSED;
+                vhd->blkOffsets[blks[ii]] = 0;
+            }
+            retVal = AXP_VHD_WRITE_FAULT;
+        }
     }
+    free(bitmap);
 
     /*
      * Return the outcome of this call back to the caller.
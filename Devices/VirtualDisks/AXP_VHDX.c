@@ -29,6 +29,21 @@
  *  either have a null value or the address of the block being allocated (so
  *  that it can be replaced) provided on the call, or the call will get a
  *  segmentation fault.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  The file is no longer truncated when it is reopened for read/write, the
+ *  metadata table entries are no longer all read from the first one, and the
+ *  Sector Bitmap Block entries are placed after every chunk of Payload Block
+ *  entries.  The region table checksums are calculated over the region
+ *  tables, rather than the pointers to them, and the GUIDs in them are
+ *  converted from their on-disk format before they are looked up.  The
+ *  sectors are now read and written using a block map, loaded from the BAT,
+ *  and blocks are allocated a batch at a time.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  A file that cannot be opened, or that is too small to hold the header
+ *  section, is no longer reopened for read/write.  Before, the block map was
+ *  loaded using the size of a file that was never determined.
  */
 #include "Devices/VirtualDisks/AXP_VirtualDisk.h"
 #include "CommonUtilities/AXP_Utility.h"
@@ -36,11 +51,14 @@
 #include "CommonUtilities/AXP_Blocks.h"
 #include "CommonUtilities/AXP_Trace.h"
 #include "Devices/VirtualDisks/AXP_VHDX.h"
+#include "Devices/VirtualDisks/AXP_VHD_BlockMap.h"
+#include <unistd.h>
 
 /*
  * Local Prototypes
  */
 static void _AXP_VHD_CreateCleanup(AXP_VHDX_Handle *, char *);
+static u32 _AXP_VHDX_LoadMap(AXP_VHDX_Handle *, i64);
 
 /*
  * _AXP_VHD_CreateCleanup
@@ -81,6 +99,91 @@ static void _AXP_VHD_CreateCleanup(AXP_VHDX_Handle *vhdx, char *path)
     return;
 }
 
+/*
+ * _AXP_VHDX_LoadMap
+ *  This function is called once a VHDX has been opened for read/write, to
+ *  read in the BAT and build the block map from it.  The Payload Block
+ *  entries are interleaved with a Sector Bitmap Block entry after every
+ *  chunkRatio of them.  Only blocks that are fully present are in the file;
+ *  the rest read as zeros.  New blocks are allocated, on 1MB boundaries, at
+ *  the end of the file.
+ *
+ * Input Parameters:
+ *  vhdx:
+ *      A pointer to the VHDX Handle.
+ *  fileSize:
+ *      A value indicating the current size of the file.
+ *
+ * Output Parameters:
+ *  vhdx:
+ *      A pointer to the VHDX Handle, with the BAT and block map loaded.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     An error occurred reading the BAT.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory to perform operation.
+ */
+static u32 _AXP_VHDX_LoadMap(AXP_VHDX_Handle *vhdx, i64 fileSize)
+{
+    AXP_VHDX_BAT_ENT *bat;
+    size_t outLen = vhdx->batLength;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 blkCount, ii;
+
+    vhdx->chunkRatio = (8 * ONE_M * (u64) vhdx->sectorSize) / vhdx->blkSize;
+    blkCount = (vhdx->diskSize + vhdx->blkSize - 1) / vhdx->blkSize;
+    vhdx->bat = AXP_Allocate_Block(-vhdx->batLength, vhdx->bat);
+    if (vhdx->bat != NULL)
+    {
+        if ((AXP_VHD_Transfer(vhdx,
+                              AXP_VHD_IO_Read,
+                              vhdx->batOffset,
+                              vhdx->bat,
+                              &outLen) != AXP_VHD_SUCCESS) ||
+            (outLen != vhdx->batLength))
+        {
+            retVal = AXP_VHD_READ_FAULT;
+        }
+    }
+    else
+    {
+        retVal = AXP_VHD_OUTOFMEMORY;
+    }
+    if ((retVal == AXP_VHD_SUCCESS) &&
+        ((blkCount + ((blkCount - 1) / vhdx->chunkRatio)) >
+         (vhdx->batLength / AXP_VHDX_BAT_ENT_LEN)))
+    {
+        retVal = AXP_VHD_FILE_CORRUPT;
+    }
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+        retVal = AXP_VHD_MapInit(vhdx, blkCount, 0);
+    }
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+        bat = (AXP_VHDX_BAT_ENT *) vhdx->bat;
+        for (ii = 0; ii < blkCount; ii++)
+        {
+            if (bat[ii + (ii / vhdx->chunkRatio)].state ==
+                AXP_VHDX_PAYL_BLK_FULLY_PRESENT)
+            {
+                vhdx->blkOffsets[ii] =
+                    bat[ii + (ii / vhdx->chunkRatio)].fileOff * ONE_M;
+            }
+        }
+        vhdx->fileEnd = ((fileSize + ONE_M - 1) / ONE_M) * ONE_M;
+        if (vhdx->fileEnd < AXP_VHDX_DATA_LOC)
+        {
+            vhdx->fileEnd = AXP_VHDX_DATA_LOC;
+        }
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * _AXP_VHDX_Create
  *  Creates a virtual hard disk (VHDX) image file.
@@ -515,34 +618,28 @@ u32 _AXP_VHDX_Create(char *path,
         {
 
             /*
-             * If we are writing a Sector Bitmap Block, then we need to make
-             * sure the state and offset are correct.
+             * Every chunkRatio Payload Blocks are followed by a Sector Bitmap
+             * Block.  Only a Payload Block uses up space in the file.
              */
-            if ((ii != 0) && ((ii % chunkRatio) == 0))
+            if ((ii % (chunkRatio + 1)) == chunkRatio)
             {
                 batEnt->state = AXP_VHDX_SB_BLK_NOT_PRESENT;
                 batEnt->fileOff = 0;
             }
-            writeRet = AXP_WriteAtOffset(vhdx->fp,
-                                         outBuf,
-                                         AXP_VHDX_BAT_ENT_LEN,
-                                         batOff);
-
-            /*
-             * If we just wrote a Sector Bitmap Block, then we need to set the
-             * state and offset back to what it should be for a Payload Block.
-             */
-            if ((ii != 0) && ((ii % chunkRatio) == 0))
+            else
             {
                 batEnt->state = batState;
                 batEnt->fileOff = blkOffset / ONE_M;
+                if (vhdx->fixed == true)
+                {
+                    blkOffset += blkSize;
+                }
             }
+            writeRet = AXP_WriteAtOffset(vhdx->fp,
+                                         outBuf,
+                                         AXP_VHDX_BAT_ENT_LEN,
+                                         batOff);
             batOff += AXP_VHDX_BAT_ENT_LEN;
-
-            if (vhdx->fixed == true)
-            {
-                blkOffset += blkSize;
-            }
         }
         if (writeRet == false)
         {
@@ -881,8 +978,22 @@ u32 _AXP_VHDX_Create(char *path,
 
     if (retVal == AXP_VHD_SUCCESS)
     {
-        vhdx->fp = freopen(path, "wb+", vhdx->fp);
-        if (vhdx->fp == NULL)
+        vhdx->fp = freopen(path, "rb+", vhdx->fp);
+        if (vhdx->fp != NULL)
+        {
+            AXP_VHD_StartIO(vhdx);
+            vhdx->batLength = AXP_VHDX_BAT_LEN;
+            retVal = _AXP_VHDX_LoadMap(vhdx, AXP_GetFileSize(vhdx->fp));
+            if (retVal != AXP_VHD_SUCCESS)
+            {
+                AXP_VHD_IO_Destroy(vhdx->io);
+                vhdx->io = NULL;
+                AXP_VHD_MapFree(vhdx);
+                _AXP_VHD_CreateCleanup(vhdx, path);
+                AXP_Deallocate_Block(vhdx);
+            }
+        }
+        else
         {
             _AXP_VHD_CreateCleanup(vhdx, path);
             AXP_Deallocate_Block(vhdx);
@@ -945,13 +1056,15 @@ u32 _AXP_VHDX_Open(char *path,
     AXP_VHDX_META_FILE metaFile;
     AXP_VHDX_META_DISK metaDisk;
     AXP_VHDX_META_SEC metaSec;
-    i64 fileSize;
+    i64 fileSize = 0;
     size_t outLen;
     int currentHdr = -1, currentReg = -1;
     int ii;
     u32 offset;
     u32 oldChecksum, newChecksum;
     u32 retVal = AXP_VHD_SUCCESS;
+    AXP_VHDX_GUID guid;
+    bool hasParent = false;
 
     /*
      * Let's allocate the block we need to maintain access to the virtual disk
@@ -1181,7 +1294,7 @@ u32 _AXP_VHDX_Open(char *path,
                             newChecksum = 0;
                             oldChecksum = reg[0]->checkSum;
                             reg[0]->checkSum = 0;
-                            newChecksum = AXP_Crc32((u8 *) &reg[0],
+                            newChecksum = AXP_Crc32((u8 *) reg[0],
                                                     SIXTYFOUR_K,
                                                     false,
                                                     newChecksum);
@@ -1209,7 +1322,7 @@ u32 _AXP_VHDX_Open(char *path,
                                 newChecksum = 0;
                                 oldChecksum = reg[1]->checkSum;
                                 reg[1]->checkSum = 0;
-                                newChecksum = AXP_Crc32((u8 *) &reg[1],
+                                newChecksum = AXP_Crc32((u8 *) reg[1],
                                                         SIXTYFOUR_K,
                                                         false,
                                                         newChecksum);
@@ -1245,7 +1358,9 @@ u32 _AXP_VHDX_Open(char *path,
                         for (ii = 0; ii < reg[currentReg]->entryCnt; ii++)
                         {
                             ent = (AXP_VHDX_REG_ENT *) &inBuf[currentReg][offset];
-                            switch (AXP_VHD_KnownGUID(&ent->guid))
+                            guid = ent->guid;
+                            AXP_Convert_From(GUID, &guid, &guid);
+                            switch (AXP_VHD_KnownGUID(&guid))
                             {
                                 case AXP_Block_Allocation_Table:
                                     if (ent->req == 1)
@@ -1300,7 +1415,9 @@ u32 _AXP_VHDX_Open(char *path,
                                  ii++)
                             {
                                 metaEnt = (AXP_VHDX_META_ENT *) &inBuf[0][offset];
-                                switch (AXP_VHD_KnownGUID(&metaEnt->guid))
+                                guid = metaEnt->guid;
+                                AXP_Convert_From(GUID, &guid, &guid);
+                                switch (AXP_VHD_KnownGUID(&guid))
                                 {
                                     case AXP_File_Parameter:
                                         if (metaEnt->isRequired == 1)
@@ -1314,6 +1431,8 @@ u32 _AXP_VHDX_Open(char *path,
                                             {
                                                 vhdx->blkSize = metaFile.blkSize;
                                                 vhdx->fixed = metaFile.leaveBlksAlloc == 1;
+                                                hasParent =
+                                                    metaFile.hasParent == 1;
                                             }
                                             else
                                             {
@@ -1396,6 +1515,7 @@ u32 _AXP_VHDX_Open(char *path,
                                     default:
                                         break;
                                 }
+                                offset += AXP_VHDX_META_ENT_LEN;
                             }
 
                         }
@@ -1405,6 +1525,14 @@ u32 _AXP_VHDX_Open(char *path,
                         }
                     }
                 }
+                else
+                {
+                    retVal = AXP_VHD_FILE_CORRUPT;
+                }
+            }
+            else
+            {
+                retVal = AXP_VHD_FILE_NOT_FOUND;
             }
         }
         else
@@ -1423,14 +1551,32 @@ u32 _AXP_VHDX_Open(char *path,
      */
     if (retVal == AXP_VHD_SUCCESS)
     {
-        vhdx->fp = freopen(path, "wb+", vhdx->fp);
+        vhdx->fp = freopen(path, "rb+", vhdx->fp);
         if (vhdx->fp == NULL)
         {
             retVal = AXP_VHD_INV_HANDLE;
         }
         else
         {
-            *handle = (AXP_VHD_HANDLE) vhdx;
+            AXP_VHD_StartIO(vhdx);
+
+            /*
+             * The sectors of a differencing VHDX cannot be read or written
+             * yet, so there is no need for its block map.
+             */
+            if (hasParent == false)
+            {
+                retVal = _AXP_VHDX_LoadMap(vhdx, fileSize);
+            }
+            if (retVal == AXP_VHD_SUCCESS)
+            {
+                *handle = (AXP_VHD_HANDLE) vhdx;
+            }
+            else
+            {
+                AXP_VHD_IO_Destroy(vhdx->io);
+                vhdx->io = NULL;
+            }
         }
     }
 
@@ -1441,6 +1587,7 @@ u32 _AXP_VHDX_Open(char *path,
      */
     if ((retVal != AXP_VHD_SUCCESS) && (vhdx != NULL ))
     {
+        AXP_VHD_MapFree(vhdx);
         AXP_Deallocate_Block(vhdx);
     }
 
@@ -1449,3 +1596,224 @@ u32 _AXP_VHDX_Open(char *path,
      */
     return (retVal);
 }
+
+/*
+ * _AXP_VHDX_ReadSectors
+ *  Reads one or more sectors from a virtual hard disk (VHDX) image file.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the virtual disk from
+ *      which to read.
+ *  lba:
+ *      A value representing the Logical Block Address from where the read is
+ *      to be started.
+ *  sectorsRead:
+ *      A pointer to a value representing the number of sectors to be read from
+ *      the VHDX.
+ *
+ * Output Parameters:
+ *  sectorsRead:
+ *      A pointer to an unsigned 32-bit value to receive the actual number of
+ *      sectors read.
+ *  outBuf:
+ *      A pointer to an unsigned 8-bit array in which to receive the read in
+ *      data.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     An error occurred reading from the VHDX file.
+ *  AXP_VHD_CALL_NOT_IMPL:  The VHDX is a differencing disk.
+ */
+u32 _AXP_VHDX_ReadSectors(AXP_VHD_HANDLE handle,
+                          u64 lba,
+                          u32 *sectorsRead,
+                          u8 *outBuf)
+{
+    AXP_VHDX_Handle *vhdx = (AXP_VHDX_Handle *) handle;
+    u32 retVal = AXP_VHD_CALL_NOT_IMPL;
+
+    if (vhdx->blkOffsets != NULL)
+    {
+        retVal = AXP_VHD_MapRead(vhdx, lba, sectorsRead, outBuf);
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHDX_WriteSectors
+ *  Writes one or more sectors to a virtual hard disk (VHDX) image file.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the virtual disk to
+ *      which to write.
+ *  lba:
+ *      A value representing the Logical Block Address from where the write is
+ *      to be started.
+ *  sectorsWritten:
+ *      A pointer to a value representing the number of sectors to be written
+ *      to the VHDX.
+ *  inBuf:
+ *      A pointer to an unsigned 8-bit array to be written to the file.
+ *
+ * Output Parameters:
+ *  sectorsWritten:
+ *      A pointer to an unsigned 32-bit value to receive the actual number of
+ *      sectors written.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the VHDX file.
+ *  AXP_VHD_CALL_NOT_IMPL:  The VHDX is a differencing disk.
+ */
+u32 _AXP_VHDX_WriteSectors(AXP_VHD_HANDLE handle,
+                           u64 lba,
+                           u32 *sectorsWritten,
+                           u8 *inBuf)
+{
+    AXP_VHDX_Handle *vhdx = (AXP_VHDX_Handle *) handle;
+    u32 retVal = AXP_VHD_CALL_NOT_IMPL;
+
+    if (vhdx->blkOffsets != NULL)
+    {
+        retVal = AXP_VHD_MapWrite(vhdx, lba, sectorsWritten, inBuf);
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHDX_SubmitSectors
+ *  Submits a batch of sector reads, writes, and flushes for a virtual hard
+ *  disk (VHDX) image file, to be completed asynchronously.  The parameters
+ *  have already been checked.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the virtual disk.
+ *  reqs:
+ *      A pointer to an array of pointers to the requests.  The op, lba,
+ *      sectors, buf, and done fields are set in each.
+ *  count:
+ *      A value indicating the number of requests.
+ *
+ * Output Parameters:
+ *  reqs:
+ *      A pointer to an array of pointers to the requests, with the offset and
+ *      length in the file set in each one handed to the I/O engine.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_CALL_NOT_IMPL:  The VHDX is a differencing disk.
+ *  AXP_VHD_WRITE_FAULT:    The requests could not be submitted.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory to perform operation.
+ */
+u32 _AXP_VHDX_SubmitSectors(AXP_VHD_HANDLE handle,
+                            AXP_VHD_IO_REQ **reqs,
+                            u32 count)
+{
+    AXP_VHDX_Handle *vhdx = (AXP_VHDX_Handle *) handle;
+    u32 retVal = AXP_VHD_CALL_NOT_IMPL;
+
+    if (vhdx->blkOffsets != NULL)
+    {
+        retVal = AXP_VHD_MapSubmit(vhdx, reqs, count);
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHDX_AllocateBlocks
+ *  Allocates blocks at the end of a virtual hard disk (VHDX) image file.  The
+ *  blocks are put one after the other, each on a 1MB boundary as the BAT
+ *  requires, the file is extended with zeros to hold them, and the BAT
+ *  entries for all of them are written with a single write.  The caller
+ *  holds the block map mutex.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A pointer to the handle object that represents the virtual disk.
+ *  blks:
+ *      A pointer to an array of the numbers of the blocks to be allocated.
+ *  count:
+ *      A value indicating the number of blocks in the array.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the VHDX file.
+ */
+u32 _AXP_VHDX_AllocateBlocks(AXP_VHD_HANDLE handle, u32 *blks, u32 count)
+{
+    AXP_VHDX_Handle *vhdx = (AXP_VHDX_Handle *) handle;
+    AXP_VHDX_BAT_ENT *bat = (AXP_VHDX_BAT_ENT *) vhdx->bat;
+    u64 offset = vhdx->fileEnd;
+    size_t length;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 lo = vhdx->batLength / AXP_VHDX_BAT_ENT_LEN;
+    u32 hi = 0;
+    u32 ii, ent;
+
+    for (ii = 0; ii < count; ii++)
+    {
+        ent = blks[ii] + (blks[ii] / vhdx->chunkRatio);
+        bat[ent].state = AXP_VHDX_PAYL_BLK_FULLY_PRESENT;
+        bat[ent].fileOff = offset / ONE_M;
+        vhdx->blkOffsets[blks[ii]] = offset;
+        offset += ((vhdx->blkSize + ONE_M - 1) / ONE_M) * ONE_M;
+        lo = (ent < lo) ? ent : lo;
+        hi = (ent > hi) ? ent : hi;
+    }
+
+    /*
+     * Extend the file to hold the new blocks, then point the BAT at them.
+     */
+    fflush(vhdx->fp);
+    if (ftruncate(vhdx->fd, offset) == 0)
+    {
+        length = (hi - lo + 1) * AXP_VHDX_BAT_ENT_LEN;
+        retVal = AXP_VHD_Transfer(vhdx,
+                                  AXP_VHD_IO_Write,
+                                  vhdx->batOffset + (lo * AXP_VHDX_BAT_ENT_LEN),
+                                  (u8 *) &bat[lo],
+                                  &length);
+    }
+    else
+    {
+        retVal = AXP_VHD_WRITE_FAULT;
+    }
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+        vhdx->fileEnd = offset;
+    }
+    else
+    {
+        for (ii = 0; ii < count; ii++)
+        {
+            ent = blks[ii] + (blks[ii] / vhdx->chunkRatio);
+            bat[ent].state = AXP_VHDX_PAYL_BLK_NOT_PRESENT;
+            bat[ent].fileOff = 0;
+            vhdx->blkOffsets[blks[ii]] = 0;
+        }
+        retVal = AXP_VHD_WRITE_FAULT;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
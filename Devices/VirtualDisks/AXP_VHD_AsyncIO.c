@@ -0,0 +1,951 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the code to read, write, and flush a virtual
+ *  disk file asynchronously.  Requests are handed to an engine, which has up
+ *  to a set number of them in flight at once, and calls back when each one
+ *  completes.  The engine uses the host's io_uring when it has one, where a
+ *  batch of requests is submitted with a single system call and a thread
+ *  reaps the completions.  Otherwise, a pool of threads performs the requests
+ *  with preadv and pwritev, combining contiguous requests into one call.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#include "Devices/VirtualDisks/AXP_VHD_AsyncIO.h"
+#include "Devices/VirtualDisks/AXP_VirtualDisk.h"
+#include <linux/io_uring.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+
+struct _AXP_VHD_IO_ENGINE
+{
+    int fd;
+    AXP_VHD_IO_TYPE type;
+    u32 depth;
+
+    /*
+     * The mutex protects the counts and the thread pool's queue.  The
+     * condition variable is broadcast when a request completes, and the work
+     * condition variable is signaled when the thread pool has something to
+     * do.
+     */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_cond_t workCond;
+    u32 inFlight;       /* submitted, not yet called back */
+    u32 pending;        /* submitted, call back not yet returned */
+    u32 maxInFlight;
+    bool shutdown;
+
+    /*
+     * The thread pool.
+     */
+    u32 threadCount;
+    pthread_t threads[AXP_VHD_IO_THREADS];
+    AXP_VHD_IO_REQ *head;
+    AXP_VHD_IO_REQ *tail;
+
+    /*
+     * The io_uring, and the thread that reaps its completions.
+     */
+    int ringFd;
+    pthread_t reaper;
+    u32 *sqHead;
+    u32 *sqTail;
+    u32 *sqMask;
+    u32 *sqArray;
+    u32 *cqHead;
+    u32 *cqTail;
+    u32 *cqMask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sqMap;
+    void *cqMap;
+    size_t sqMapLen;
+    size_t cqMapLen;
+    size_t sqesLen;
+};
+
+/*
+ * _AXP_VHD_IO_Complete
+ *  This function is called when a request has completed, to call back the
+ *  requester and let anyone waiting on the engine know.  The request is no
+ *  longer counted as in flight before the call back, so that the call back
+ *  can submit another request.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *  req:
+ *      A pointer to the completed request.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void _AXP_VHD_IO_Complete(AXP_VHD_IO_ENGINE *io, AXP_VHD_IO_REQ *req)
+{
+    if ((req->status == AXP_VHD_SUCCESS) &&
+        (req->op != AXP_VHD_IO_Flush) &&
+        (req->transferred != req->length))
+    {
+        req->status = (req->op == AXP_VHD_IO_Read) ?
+            AXP_VHD_READ_FAULT : AXP_VHD_WRITE_FAULT;
+    }
+    pthread_mutex_lock(&io->mutex);
+    io->inFlight--;
+    pthread_cond_broadcast(&io->cond);
+    pthread_mutex_unlock(&io->mutex);
+    if (req->done != NULL)
+    {
+        (*req->done)(req);
+    }
+    pthread_mutex_lock(&io->mutex);
+    io->pending--;
+    req->complete = true;
+    pthread_cond_broadcast(&io->cond);
+    pthread_mutex_unlock(&io->mutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * _AXP_VHD_IO_PrepSQE
+ *  This function is called, with the engine mutex locked, to fill in the next
+ *  io_uring submission queue entry for a request, or for what remains of it.
+ *  The entry is not visible to the kernel until the tail is moved.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *  req:
+ *      A pointer to the request, or NULL to wake the reaper to shut down.
+ *  tail:
+ *      A value indicating the submission queue tail to fill in.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void _AXP_VHD_IO_PrepSQE(AXP_VHD_IO_ENGINE *io,
+                                AXP_VHD_IO_REQ *req,
+                                u32 tail)
+{
+    u32 index = tail & *io->sqMask;
+    struct io_uring_sqe *sqe = &io->sqes[index];
+
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->fd = io->fd;
+    sqe->user_data = (u64) req;
+    if (req == NULL)
+    {
+        sqe->opcode = IORING_OP_NOP;
+    }
+    else if (req->op == AXP_VHD_IO_Flush)
+    {
+
+        /*
+         * A flush waits for everything submitted before it.
+         */
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        sqe->flags = IOSQE_IO_DRAIN;
+    }
+    else
+    {
+        req->iov.iov_base = req->buf + req->transferred;
+        req->iov.iov_len = req->length - req->transferred;
+        sqe->opcode = (req->op == AXP_VHD_IO_Read) ?
+            IORING_OP_READV : IORING_OP_WRITEV;
+        sqe->addr = (u64) &req->iov;
+        sqe->len = 1;
+        sqe->off = req->offset + req->transferred;
+    }
+    io->sqArray[index] = index;
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * _AXP_VHD_IO_Enter
+ *  This function is called, with the engine mutex locked, to make the
+ *  submission queue entries filled in up to the new tail visible, and have the
+ *  kernel start them.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *  tail:
+ *      A value indicating the new submission queue tail.
+ *  count:
+ *      A value indicating the number of entries being submitted.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  true:   The entries were submitted.
+ *  false:  The kernel would not take them.
+ */
+static bool _AXP_VHD_IO_Enter(AXP_VHD_IO_ENGINE *io, u32 tail, u32 count)
+{
+    long ret;
+
+    __atomic_store_n(io->sqTail, tail, __ATOMIC_RELEASE);
+    do
+    {
+        ret = syscall(__NR_io_uring_enter, io->ringFd, count, 0, 0, NULL, 0);
+    } while ((ret < 0) && (errno == EINTR));
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (ret == count);
+}
+
+/*
+ * _AXP_VHD_IO_Reaper
+ *  This is the main function for the thread that reaps the io_uring
+ *  completions.  A read or write that only transferred part of what was asked
+ *  for is resubmitted for the rest.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      A pointer to the engine.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL.
+ */
+static void *_AXP_VHD_IO_Reaper(void *voidPtr)
+{
+    AXP_VHD_IO_ENGINE *io = (AXP_VHD_IO_ENGINE *) voidPtr;
+    AXP_VHD_IO_REQ *req;
+    struct io_uring_cqe *cqe;
+    u32 head, tail;
+    i32 res;
+    bool done = false;
+
+    while (done == false)
+    {
+        head = *io->cqHead;
+        tail = __atomic_load_n(io->cqTail, __ATOMIC_ACQUIRE);
+        if (head == tail)
+        {
+            (void) syscall(__NR_io_uring_enter,
+                           io->ringFd,
+                           0,
+                           1,
+                           IORING_ENTER_GETEVENTS,
+                           NULL,
+                           0);
+            continue;
+        }
+        cqe = &io->cqes[head & *io->cqMask];
+        req = (AXP_VHD_IO_REQ *) cqe->user_data;
+        res = cqe->res;
+        __atomic_store_n(io->cqHead, head + 1, __ATOMIC_RELEASE);
+        if (req == NULL)
+        {
+            done = true;
+        }
+        else if (res < 0)
+        {
+            req->status = (req->op == AXP_VHD_IO_Read) ?
+                AXP_VHD_READ_FAULT : AXP_VHD_WRITE_FAULT;
+            _AXP_VHD_IO_Complete(io, req);
+        }
+        else
+        {
+            if (req->op != AXP_VHD_IO_Flush)
+            {
+                req->transferred += res;
+            }
+            if ((res > 0) &&
+                (req->op != AXP_VHD_IO_Flush) &&
+                (req->transferred < req->length))
+            {
+                pthread_mutex_lock(&io->mutex);
+                tail = *io->sqTail;
+                _AXP_VHD_IO_PrepSQE(io, req, tail);
+                if (_AXP_VHD_IO_Enter(io, tail + 1, 1) == false)
+                {
+                    req->status = (req->op == AXP_VHD_IO_Read) ?
+                        AXP_VHD_READ_FAULT : AXP_VHD_WRITE_FAULT;
+                    pthread_mutex_unlock(&io->mutex);
+                    _AXP_VHD_IO_Complete(io, req);
+                }
+                else
+                {
+                    pthread_mutex_unlock(&io->mutex);
+                }
+            }
+            else
+            {
+                _AXP_VHD_IO_Complete(io, req);
+            }
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (NULL);
+}
+
+/*
+ * _AXP_VHD_IO_Worker
+ *  This is the main function for each of the threads in the thread pool.  It
+ *  takes the request at the head of the queue, along with any that follow it
+ *  and continue where it leaves off in the file, and performs them with a
+ *  single preadv or pwritev.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      A pointer to the engine.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL.
+ */
+static void *_AXP_VHD_IO_Worker(void *voidPtr)
+{
+    AXP_VHD_IO_ENGINE *io = (AXP_VHD_IO_ENGINE *) voidPtr;
+    AXP_VHD_IO_REQ *batch[AXP_VHD_IO_MAX_IOV];
+    struct iovec iov[AXP_VHD_IO_MAX_IOV];
+    AXP_VHD_IO_REQ *req;
+    struct iovec *iovPtr;
+    size_t total, remaining;
+    ssize_t ret;
+    u64 offset;
+    u32 count, iovCnt, status, ii;
+
+    pthread_mutex_lock(&io->mutex);
+    while (true)
+    {
+        while ((io->head == NULL) && (io->shutdown == false))
+        {
+            pthread_cond_wait(&io->workCond, &io->mutex);
+        }
+        if (io->head == NULL)
+        {
+            break;
+        }
+
+        /*
+         * Take the request at the head of the queue, and those that directly
+         * follow it in the file.
+         */
+        req = io->head;
+        batch[0] = req;
+        count = 1;
+        total = req->length;
+        req = req->next;
+        while ((req != NULL) &&
+               (count < AXP_VHD_IO_MAX_IOV) &&
+               (batch[0]->op != AXP_VHD_IO_Flush) &&
+               (req->op == batch[0]->op) &&
+               (req->offset == (batch[0]->offset + total)))
+        {
+            batch[count++] = req;
+            total += req->length;
+            req = req->next;
+        }
+        io->head = req;
+        if (req == NULL)
+        {
+            io->tail = NULL;
+        }
+        pthread_mutex_unlock(&io->mutex);
+
+        /*
+         * Do the I/O.
+         */
+        status = AXP_VHD_SUCCESS;
+        if (batch[0]->op == AXP_VHD_IO_Flush)
+        {
+            if (fdatasync(io->fd) != 0)
+            {
+                status = AXP_VHD_WRITE_FAULT;
+            }
+        }
+        else
+        {
+            for (ii = 0; ii < count; ii++)
+            {
+                iov[ii].iov_base = batch[ii]->buf;
+                iov[ii].iov_len = batch[ii]->length;
+            }
+            iovPtr = iov;
+            iovCnt = count;
+            offset = batch[0]->offset;
+            remaining = total;
+            while (remaining > 0)
+            {
+                if (batch[0]->op == AXP_VHD_IO_Read)
+                {
+                    ret = preadv(io->fd, iovPtr, iovCnt, offset);
+                }
+                else
+                {
+                    ret = pwritev(io->fd, iovPtr, iovCnt, offset);
+                }
+                if ((ret < 0) && (errno == EINTR))
+                {
+                    continue;
+                }
+                if (ret <= 0)
+                {
+                    break;
+                }
+                offset += ret;
+                remaining -= ret;
+
+                /*
+                 * Move past what was transferred, should there be more.
+                 */
+                while ((iovCnt > 0) && ((size_t) ret >= iovPtr->iov_len))
+                {
+                    ret -= iovPtr->iov_len;
+                    iovPtr++;
+                    iovCnt--;
+                }
+                if (iovCnt > 0)
+                {
+                    iovPtr->iov_base = (u8 *) iovPtr->iov_base + ret;
+                    iovPtr->iov_len -= ret;
+                }
+            }
+            total -= remaining;
+        }
+
+        /*
+         * Let each of the requesters know how its request went.
+         */
+        for (ii = 0; ii < count; ii++)
+        {
+            req = batch[ii];
+            req->status = status;
+            req->transferred = (total < req->length) ? total : req->length;
+            total -= req->transferred;
+            _AXP_VHD_IO_Complete(io, req);
+        }
+        pthread_mutex_lock(&io->mutex);
+    }
+    pthread_mutex_unlock(&io->mutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return (NULL);
+}
+
+/*
+ * _AXP_VHD_IO_UringInit
+ *  This function is called to set up an io_uring for an engine, and start the
+ *  thread that reaps its completions.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *
+ * Output Parameters:
+ *  io:
+ *      A pointer to the engine, with the io_uring set up.
+ *
+ * Return Values:
+ *  true:   The io_uring is ready to use.
+ *  false:  The host does not have io_uring, or it could not be set up.
+ */
+static bool _AXP_VHD_IO_UringInit(AXP_VHD_IO_ENGINE *io)
+{
+    struct io_uring_params params;
+    u8 *sq, *cq;
+    bool retVal = false;
+
+    memset(&params, 0, sizeof(params));
+    io->ringFd = syscall(__NR_io_uring_setup, io->depth, &params);
+    if (io->ringFd >= 0)
+    {
+        io->sqMapLen = params.sq_off.array + (params.sq_entries * sizeof(u32));
+        io->cqMapLen = params.cq_off.cqes +
+            (params.cq_entries * sizeof(struct io_uring_cqe));
+        io->sqesLen = params.sq_entries * sizeof(struct io_uring_sqe);
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+        {
+            if (io->cqMapLen > io->sqMapLen)
+            {
+                io->sqMapLen = io->cqMapLen;
+            }
+            io->cqMapLen = 0;
+        }
+        io->sqMap = mmap(NULL,
+                         io->sqMapLen,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE,
+                         io->ringFd,
+                         IORING_OFF_SQ_RING);
+        io->cqMap = (io->cqMapLen == 0) ? io->sqMap :
+            mmap(NULL,
+                 io->cqMapLen,
+                 PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE,
+                 io->ringFd,
+                 IORING_OFF_CQ_RING);
+        io->sqes = mmap(NULL,
+                        io->sqesLen,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE,
+                        io->ringFd,
+                        IORING_OFF_SQES);
+        if ((io->sqMap != MAP_FAILED) &&
+            (io->cqMap != MAP_FAILED) &&
+            (io->sqes != MAP_FAILED))
+        {
+            sq = (u8 *) io->sqMap;
+            cq = (u8 *) io->cqMap;
+            io->sqHead = (u32 *) (sq + params.sq_off.head);
+            io->sqTail = (u32 *) (sq + params.sq_off.tail);
+            io->sqMask = (u32 *) (sq + params.sq_off.ring_mask);
+            io->sqArray = (u32 *) (sq + params.sq_off.array);
+            io->cqHead = (u32 *) (cq + params.cq_off.head);
+            io->cqTail = (u32 *) (cq + params.cq_off.tail);
+            io->cqMask = (u32 *) (cq + params.cq_off.ring_mask);
+            io->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+            retVal = pthread_create(&io->reaper,
+                                    NULL,
+                                    _AXP_VHD_IO_Reaper,
+                                    io) == 0;
+        }
+
+        /*
+         * If something did not work out, put back what did.
+         */
+        if (retVal == false)
+        {
+            if ((io->sqes != NULL) && (io->sqes != MAP_FAILED))
+            {
+                munmap(io->sqes, io->sqesLen);
+            }
+            if ((io->cqMapLen != 0) &&
+                (io->cqMap != NULL) &&
+                (io->cqMap != MAP_FAILED))
+            {
+                munmap(io->cqMap, io->cqMapLen);
+            }
+            if ((io->sqMap != NULL) && (io->sqMap != MAP_FAILED))
+            {
+                munmap(io->sqMap, io->sqMapLen);
+            }
+            close(io->ringFd);
+            io->ringFd = -1;
+        }
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_IO_Create
+ *  This function is called to create an engine to perform asynchronous I/O
+ *  on an open file.
+ *
+ * Input Parameters:
+ *  fd:
+ *      A value of the file descriptor for the open file.
+ *  depth:
+ *      A value indicating the most requests to be in flight at once.  Zero
+ *      selects the default.
+ *  type:
+ *      A value indicating what should perform the I/O.  AXP_VHD_IO_Auto uses
+ *      io_uring, if the host has it, and the thread pool if it does not.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL:       The engine could not be created.
+ *  Otherwise:  A pointer to the engine.
+ */
+AXP_VHD_IO_ENGINE *AXP_VHD_IO_Create(int fd, u32 depth, AXP_VHD_IO_TYPE type)
+{
+    AXP_VHD_IO_ENGINE *io;
+    bool ready = false;
+
+    io = calloc(1, sizeof(AXP_VHD_IO_ENGINE));
+    if (io != NULL)
+    {
+        io->fd = fd;
+        io->ringFd = -1;
+        io->depth = (depth == 0) ? AXP_VHD_IO_DEPTH :
+            ((depth > AXP_VHD_IO_MAX_DEPTH) ? AXP_VHD_IO_MAX_DEPTH : depth);
+        pthread_mutex_init(&io->mutex, NULL);
+        pthread_cond_init(&io->cond, NULL);
+        pthread_cond_init(&io->workCond, NULL);
+        if (type != AXP_VHD_IO_Threads)
+        {
+            ready = _AXP_VHD_IO_UringInit(io);
+            io->type = AXP_VHD_IO_Uring;
+        }
+        if ((ready == false) && (type != AXP_VHD_IO_Uring))
+        {
+            io->type = AXP_VHD_IO_Threads;
+            for (io->threadCount = 0;
+                 io->threadCount < AXP_VHD_IO_THREADS;
+                 io->threadCount++)
+            {
+                if (pthread_create(&io->threads[io->threadCount],
+                                   NULL,
+                                   _AXP_VHD_IO_Worker,
+                                   io) != 0)
+                {
+                    break;
+                }
+            }
+            ready = io->threadCount > 0;
+        }
+        if (ready == false)
+        {
+            pthread_cond_destroy(&io->workCond);
+            pthread_cond_destroy(&io->cond);
+            pthread_mutex_destroy(&io->mutex);
+            free(io);
+            io = NULL;
+        }
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (io);
+}
+
+/*
+ * AXP_VHD_IO_Destroy
+ *  This function is called to wait for the requests in flight to complete,
+ *  then stop the engine's threads and release it.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.  This may be NULL.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_VHD_IO_Destroy(AXP_VHD_IO_ENGINE *io)
+{
+    u32 ii;
+
+    if (io != NULL)
+    {
+        AXP_VHD_IO_Wait(io);
+        pthread_mutex_lock(&io->mutex);
+        io->shutdown = true;
+        if (io->type == AXP_VHD_IO_Uring)
+        {
+            u32 tail = *io->sqTail;
+
+            _AXP_VHD_IO_PrepSQE(io, NULL, tail);
+            (void) _AXP_VHD_IO_Enter(io, tail + 1, 1);
+        }
+        pthread_cond_broadcast(&io->workCond);
+        pthread_mutex_unlock(&io->mutex);
+        if (io->type == AXP_VHD_IO_Uring)
+        {
+            pthread_join(io->reaper, NULL);
+            munmap(io->sqes, io->sqesLen);
+            if (io->cqMapLen != 0)
+            {
+                munmap(io->cqMap, io->cqMapLen);
+            }
+            munmap(io->sqMap, io->sqMapLen);
+            close(io->ringFd);
+        }
+        for (ii = 0; ii < io->threadCount; ii++)
+        {
+            pthread_join(io->threads[ii], NULL);
+        }
+        pthread_cond_destroy(&io->workCond);
+        pthread_cond_destroy(&io->cond);
+        pthread_mutex_destroy(&io->mutex);
+        free(io);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_VHD_IO_Type
+ *  This function is called to find out what is performing an engine's I/O.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_IO_Uring:   The host's io_uring.
+ *  AXP_VHD_IO_Threads: The thread pool.
+ */
+AXP_VHD_IO_TYPE AXP_VHD_IO_Type(AXP_VHD_IO_ENGINE *io)
+{
+    return (io->type);
+}
+
+/*
+ * AXP_VHD_IO_Submit
+ *  This function is called to submit a batch of requests.  Each request has
+ *  its op, buf, offset, and length set, and optionally a done function.  When
+ *  the engine already has as many requests in flight as it allows, this waits
+ *  for some to complete.  With io_uring, the requests that fit are given to
+ *  the kernel with a single system call.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *  reqs:
+ *      A pointer to an array of pointers to the requests.
+ *  count:
+ *      A value indicating the number of requests in the array.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        All the requests were submitted.
+ *  AXP_VHD_WRITE_FAULT:    The kernel would not take a request.  Those before
+ *                          it were submitted, and it and those after it were
+ *                          not.
+ */
+u32 AXP_VHD_IO_Submit(AXP_VHD_IO_ENGINE *io, AXP_VHD_IO_REQ **reqs, u32 count)
+{
+    AXP_VHD_IO_REQ *req;
+    u32 tail, batch;
+    u32 ii = 0;
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    pthread_mutex_lock(&io->mutex);
+    while ((ii < count) && (retVal == AXP_VHD_SUCCESS))
+    {
+
+        /*
+         * Wait for room, and for a flush, for the thread pool to complete
+         * everything before it.  The io_uring does the latter itself.
+         */
+        while ((io->inFlight >= io->depth) ||
+               ((io->type == AXP_VHD_IO_Threads) &&
+                (reqs[ii]->op == AXP_VHD_IO_Flush) &&
+                (io->inFlight > 0)))
+        {
+            pthread_cond_wait(&io->cond, &io->mutex);
+        }
+
+        /*
+         * Queue up as many of the requests as there is room for.
+         */
+        tail = (io->type == AXP_VHD_IO_Uring) ? *io->sqTail : 0;
+        batch = 0;
+        while ((ii < count) && (io->inFlight < io->depth))
+        {
+            req = reqs[ii];
+            if ((batch > 0) &&
+                (io->type == AXP_VHD_IO_Threads) &&
+                (req->op == AXP_VHD_IO_Flush))
+            {
+                break;
+            }
+            req->status = AXP_VHD_SUCCESS;
+            req->transferred = 0;
+            req->complete = false;
+            req->next = NULL;
+            if (io->type == AXP_VHD_IO_Uring)
+            {
+                _AXP_VHD_IO_PrepSQE(io, req, tail + batch);
+            }
+            else
+            {
+                if (io->tail == NULL)
+                {
+                    io->head = req;
+                }
+                else
+                {
+                    io->tail->next = req;
+                }
+                io->tail = req;
+            }
+            io->inFlight++;
+            io->pending++;
+            batch++;
+            ii++;
+        }
+        if (io->inFlight > io->maxInFlight)
+        {
+            io->maxInFlight = io->inFlight;
+        }
+
+        /*
+         * Start them.
+         */
+        if (io->type == AXP_VHD_IO_Uring)
+        {
+            if (_AXP_VHD_IO_Enter(io, tail + batch, batch) == false)
+            {
+                io->inFlight -= batch;
+                io->pending -= batch;
+                retVal = AXP_VHD_WRITE_FAULT;
+            }
+        }
+        else if (batch > 1)
+        {
+            pthread_cond_broadcast(&io->workCond);
+        }
+        else
+        {
+            pthread_cond_signal(&io->workCond);
+        }
+    }
+    pthread_mutex_unlock(&io->mutex);
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_IO_Transfer
+ *  This function is called to perform a single request, and wait for it to
+ *  complete.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *  req:
+ *      A pointer to the request.  The done function is not used.
+ *
+ * Output Parameters:
+ *  req:
+ *      A pointer to the request, with the status and bytes transferred.
+ *
+ * Return Values:
+ *  The status of the request.
+ */
+u32 AXP_VHD_IO_Transfer(AXP_VHD_IO_ENGINE *io, AXP_VHD_IO_REQ *req)
+{
+    u32 retVal;
+
+    req->done = NULL;
+    retVal = AXP_VHD_IO_Submit(io, &req, 1);
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+        pthread_mutex_lock(&io->mutex);
+        while (req->complete == false)
+        {
+            pthread_cond_wait(&io->cond, &io->mutex);
+        }
+        pthread_mutex_unlock(&io->mutex);
+        retVal = req->status;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_IO_Wait
+ *  This function is called to wait for all the requests submitted to complete,
+ *  and their done functions to return.  This must not be called from a done
+ *  function.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_VHD_IO_Wait(AXP_VHD_IO_ENGINE *io)
+{
+    pthread_mutex_lock(&io->mutex);
+    while (io->pending > 0)
+    {
+        pthread_cond_wait(&io->cond, &io->mutex);
+    }
+    pthread_mutex_unlock(&io->mutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_VHD_IO_MaxInFlight
+ *  This function is called to get the most requests the engine has had in
+ *  flight at once.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The high water mark of requests in flight.
+ */
+u32 AXP_VHD_IO_MaxInFlight(AXP_VHD_IO_ENGINE *io)
+{
+    return (io->maxInFlight);
+}
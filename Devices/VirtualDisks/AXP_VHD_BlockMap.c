@@ -0,0 +1,1129 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the code to read and write the sectors of a
+ *  dynamic or differencing virtual disk.  The file offset of each block is
+ *  kept in memory, so a request is turned into file I/O without reading the
+ *  Block Allocation Table.  Sectors that are next to each other in the file
+ *  are read or written with a single I/O, even across blocks.  Sectors in a
+ *  block that has not been allocated are returned as zeros (or, for a
+ *  differencing disk, read from the parent) without touching the file.  All
+ *  the blocks that a write, or a batch of them, needs are allocated at once.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped a line longer than 80 columns.
+ */
+#include "Devices/VirtualDisks/AXP_VHD_BlockMap.h"
+#include "Devices/VirtualDisks/AXP_VirtualDisk.h"
+#include "Devices/VirtualDisks/AXP_VHD.h"
+#include "CommonUtilities/AXP_Blocks.h"
+#include <unistd.h>
+
+/*
+ * A run of sectors that are contiguous in both the file and the buffer, still
+ * to be read or written.
+ */
+typedef struct
+{
+    u64 offset;
+    u8 *buf;
+    size_t length;
+} AXP_VHD_MAP_RUN;
+
+/*
+ * _AXP_VHD_MapFlushRun
+ *  This function is called to read or write the run of sectors accumulated so
+ *  far, if there is one.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  op:
+ *      A value indicating whether to read or write.
+ *  run:
+ *      A pointer to the run.
+ *
+ * Output Parameters:
+ *  run:
+ *      A pointer to the run, now empty.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     An error occurred reading from the file.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the file.
+ */
+static u32 _AXP_VHD_MapFlushRun(AXP_VHDX_Handle *vhd,
+                                AXP_VHD_IO_OP op,
+                                AXP_VHD_MAP_RUN *run)
+{
+    size_t length = run->length;
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if (run->length != 0)
+    {
+        retVal = AXP_VHD_Transfer(vhd, op, run->offset, run->buf, &length);
+        if ((retVal == AXP_VHD_SUCCESS) && (length != run->length))
+        {
+            retVal = (op == AXP_VHD_IO_Read) ?
+                AXP_VHD_READ_FAULT :
+                AXP_VHD_WRITE_FAULT;
+        }
+        run->length = 0;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_MapAddRun
+ *  This function is called to add sectors to the run being accumulated.  If
+ *  they do not follow on from the run, in both the file and the buffer, the
+ *  run is read or written first, and a new one started.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  op:
+ *      A value indicating whether to read or write.
+ *  run:
+ *      A pointer to the run.
+ *  offset:
+ *      A value indicating the offset of the sectors in the file.
+ *  buf:
+ *      A pointer to where the sectors are in the caller's buffer.
+ *  length:
+ *      A value indicating the number of bytes in the sectors.
+ *
+ * Output Parameters:
+ *  run:
+ *      A pointer to the run, with the sectors added.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     An error occurred reading from the file.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the file.
+ */
+static u32 _AXP_VHD_MapAddRun(AXP_VHDX_Handle *vhd,
+                              AXP_VHD_IO_OP op,
+                              AXP_VHD_MAP_RUN *run,
+                              u64 offset,
+                              u8 *buf,
+                              size_t length)
+{
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if ((run->length != 0) &&
+        ((run->offset + run->length) == offset) &&
+        (&run->buf[run->length] == buf))
+    {
+        run->length += length;
+    }
+    else
+    {
+        retVal = _AXP_VHD_MapFlushRun(vhd, op, run);
+        run->offset = offset;
+        run->buf = buf;
+        run->length = length;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_MapBitmap
+ *  This function is called to get the sector bitmap for a block, reading it
+ *  in from the file the first time it is needed.  The map mutex must be
+ *  held.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  blk:
+ *      A value indicating the block.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL:       The bitmap could not be read.
+ *  Otherwise:  A pointer to the block's sector bitmap.
+ */
+static u8 *_AXP_VHD_MapBitmap(AXP_VHDX_Handle *vhd, u32 blk)
+{
+    u8 *retVal = vhd->bitmaps[blk];
+    size_t length = vhd->bitmapSize;
+
+    if (retVal == NULL)
+    {
+        retVal = calloc(1, vhd->bitmapSize);
+        if ((retVal != NULL) && (vhd->blkOffsets[blk] != 0))
+        {
+            if ((AXP_VHD_Transfer(vhd,
+                                  AXP_VHD_IO_Read,
+                                  vhd->blkOffsets[blk] - vhd->bitmapSize,
+                                  retVal,
+                                  &length) != AXP_VHD_SUCCESS) ||
+                (length != vhd->bitmapSize))
+            {
+                free(retVal);
+                retVal = NULL;
+            }
+        }
+        vhd->bitmaps[blk] = retVal;
+    }
+
+    /*
+     * Return the bitmap back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_MapFromParent
+ *  This function is called to fill in sectors a differencing disk does not
+ *  have from its parent, or with zeros if there is no parent.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  lba:
+ *      A value indicating the first sector.
+ *  sectors:
+ *      A value indicating the number of sectors.
+ *
+ * Output Parameters:
+ *  buf:
+ *      A pointer to the location to receive the sectors.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     The parent could not supply the sectors.
+ */
+static u32 _AXP_VHD_MapFromParent(AXP_VHDX_Handle *vhd,
+                                  u64 lba,
+                                  u32 sectors,
+                                  u8 *buf)
+{
+    u32 sectorsRead = sectors;
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if (vhd->parent == NULL)
+    {
+        memset(buf, 0, (size_t) sectors * vhd->sectorSize);
+    }
+    else
+    {
+        retVal = AXP_VHD_ReadSectors(vhd->parent, lba, &sectorsRead, buf);
+        if ((retVal != AXP_VHD_SUCCESS) || (sectorsRead != sectors))
+        {
+            retVal = AXP_VHD_READ_FAULT;
+        }
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_MapReserve
+ *  This function is called to add the blocks, that a write needs and that
+ *  have not been allocated, to the list of blocks to be allocated.  The map
+ *  mutex must be held.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  lba:
+ *      A value indicating the first sector to be written.
+ *  sectors:
+ *      A value indicating the number of sectors to be written.
+ *  blks:
+ *      A pointer to the list of blocks to be allocated.
+ *  count:
+ *      A pointer to the number of blocks in the list.
+ *
+ * Output Parameters:
+ *  blks:
+ *      A pointer to the list, with any new blocks added.
+ *  count:
+ *      A pointer to the number of blocks now in the list.
+ *
+ * Return Values:
+ *  None.
+ */
+static void _AXP_VHD_MapReserve(AXP_VHDX_Handle *vhd,
+                                u64 lba,
+                                u32 sectors,
+                                u32 *blks,
+                                u32 *count)
+{
+    u32 sectorsPerBlk = vhd->blkSize / vhd->sectorSize;
+    u32 blk, last, ii;
+
+    if (sectors > 0)
+    {
+        last = (lba + sectors - 1) / sectorsPerBlk;
+        for (blk = lba / sectorsPerBlk; blk <= last; blk++)
+        {
+            if (vhd->blkOffsets[blk] == 0)
+            {
+                for (ii = 0; ((ii < *count) && (blks[ii] != blk)); ii++)
+                {
+                    continue;
+                }
+                if (ii == *count)
+                {
+                    blks[(*count)++] = blk;
+                }
+            }
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * _AXP_VHD_MapAllocate
+ *  This function is called to allocate a list of blocks in the file.  The map
+ *  mutex must be held.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  blks:
+ *      A pointer to the list of blocks to be allocated.
+ *  count:
+ *      A value indicating the number of blocks in the list.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the file.
+ *  AXP_VHD_OUTOFMEMORY:    There is no memory for a new block's bitmap.
+ */
+static u32 _AXP_VHD_MapAllocate(AXP_VHDX_Handle *vhd, u32 *blks, u32 count)
+{
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 ii;
+
+    if (count > 0)
+    {
+        switch (vhd->deviceID)
+        {
+            case STORAGE_TYPE_DEV_VHD:
+                retVal = _AXP_VHD_AllocateBlocks((AXP_VHD_HANDLE) vhd,
+                                                 blks,
+                                                 count);
+                break;
+
+            case STORAGE_TYPE_DEV_VHDX:
+                retVal = _AXP_VHDX_AllocateBlocks((AXP_VHD_HANDLE) vhd,
+                                                  blks,
+                                                  count);
+                break;
+
+            default:
+                retVal = AXP_VHD_CALL_NOT_IMPL;
+                break;
+        }
+
+        /*
+         * The sector bitmap of a new block of a differencing disk is all
+         * zeros.  A dynamic disk does not need to keep its bitmaps.
+         */
+        for (ii = 0;
+             ((ii < count) &&
+              (retVal == AXP_VHD_SUCCESS) &&
+              (vhd->differencing == true));
+             ii++)
+        {
+            if (vhd->bitmaps[blks[ii]] == NULL)
+            {
+                vhd->bitmaps[blks[ii]] = calloc(1, vhd->bitmapSize);
+                if (vhd->bitmaps[blks[ii]] == NULL)
+                {
+                    retVal = AXP_VHD_OUTOFMEMORY;
+                }
+            }
+        }
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_MapMark
+ *  This function is called, after sectors have been written, to set their
+ *  bits in the sector bitmaps.  Only the sectors of a bitmap that changed are
+ *  written back to the file.  The map mutex must be held.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  lba:
+ *      A value indicating the first sector written.
+ *  sectors:
+ *      A value indicating the number of sectors written.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the file.
+ */
+static u32 _AXP_VHD_MapMark(AXP_VHDX_Handle *vhd, u64 lba, u32 sectors)
+{
+    u32 sectorsPerBlk = vhd->blkSize / vhd->sectorSize;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 blk, first, count, ii, lo, hi;
+    size_t length;
+    u8 *bitmap;
+
+    while ((sectors > 0) && (retVal == AXP_VHD_SUCCESS))
+    {
+        blk = lba / sectorsPerBlk;
+        first = lba % sectorsPerBlk;
+        count = sectorsPerBlk - first;
+        if (count > sectors)
+        {
+            count = sectors;
+        }
+        bitmap = _AXP_VHD_MapBitmap(vhd, blk);
+        if (bitmap != NULL)
+        {
+            lo = vhd->bitmapSize;
+            hi = 0;
+            for (ii = first; ii < (first + count); ii++)
+            {
+                if (AXP_VHD_MAP_TEST(bitmap, ii) == false)
+                {
+                    bitmap[ii >> 3] |= AXP_VHD_MAP_BIT(ii);
+                    lo = (lo < (ii >> 3)) ? lo : (ii >> 3);
+                    hi = ii >> 3;
+                }
+            }
+
+            /*
+             * Write back the sectors of the bitmap that changed.
+             */
+            if (lo <= hi)
+            {
+                lo -= lo % vhd->sectorSize;
+                hi += vhd->sectorSize - (hi % vhd->sectorSize);
+                hi = (hi < vhd->bitmapSize) ? hi : vhd->bitmapSize;
+                length = hi - lo;
+                retVal = AXP_VHD_Transfer(vhd,
+                                          AXP_VHD_IO_Write,
+                                          vhd->blkOffsets[blk] -
+                                          vhd->bitmapSize + lo,
+                                          &bitmap[lo],
+                                          &length);
+            }
+        }
+        else
+        {
+            retVal = AXP_VHD_WRITE_FAULT;
+        }
+        lba += count;
+        sectors -= count;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * _AXP_VHD_MapExtent
+ *  This function is called to determine if all the sectors of a request are
+ *  in the file, one after the other, so that the request can be handed to
+ *  the I/O engine as it is.  For a differencing disk, they must also all be
+ *  marked as present in the sector bitmaps.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  req:
+ *      A pointer to the request.
+ *
+ * Output Parameters:
+ *  req:
+ *      A pointer to the request, with the offset and length in the file set
+ *      if it can be handed to the I/O engine.
+ *
+ * Return Values:
+ *  true:   The request can be handed to the I/O engine.
+ *  false:  The request needs to be broken up.
+ */
+static bool _AXP_VHD_MapExtent(AXP_VHDX_Handle *vhd, AXP_VHD_IO_REQ *req)
+{
+    u32 sectorsPerBlk = vhd->blkSize / vhd->sectorSize;
+    u64 lba = req->lba;
+    u64 offset, next = 0;
+    u32 sectors = req->sectors;
+    u32 blk, first, count, ii;
+    u8 *bitmap;
+    bool retVal = (sectors > 0);
+
+    while ((sectors > 0) && (retVal == true))
+    {
+        blk = lba / sectorsPerBlk;
+        first = lba % sectorsPerBlk;
+        count = sectorsPerBlk - first;
+        if (count > sectors)
+        {
+            count = sectors;
+        }
+        offset = vhd->blkOffsets[blk] + ((u64) first * vhd->sectorSize);
+        if ((vhd->blkOffsets[blk] == 0) ||
+            ((lba != req->lba) && (offset != next)))
+        {
+            retVal = false;
+        }
+        else if (vhd->differencing == true)
+        {
+            pthread_mutex_lock(&vhd->mapMutex);
+            bitmap = _AXP_VHD_MapBitmap(vhd, blk);
+            for (ii = first;
+                 ((ii < (first + count)) && (retVal == true));
+                 ii++)
+            {
+                retVal = (bitmap != NULL) && AXP_VHD_MAP_TEST(bitmap, ii);
+            }
+            pthread_mutex_unlock(&vhd->mapMutex);
+        }
+        if (lba == req->lba)
+        {
+            req->offset = offset;
+        }
+        next = offset + ((u64) count * vhd->sectorSize);
+        lba += count;
+        sectors -= count;
+    }
+    req->length = (size_t) req->sectors * vhd->sectorSize;
+
+    /*
+     * Return the result back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MapInit
+ *  This function is called when a dynamic or differencing disk is created or
+ *  opened, to allocate the block map.  The caller fills in the offset of each
+ *  block that has been allocated, and where the next one will go.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  blkCount:
+ *      A value indicating the number of blocks in the disk.
+ *  bitmapSize:
+ *      A value indicating the number of bytes in the file in front of each
+ *      block for its sector bitmap, or zero if blocks do not have one.
+ *
+ * Output Parameters:
+ *  vhd:
+ *      A pointer to the handle, with an empty block map.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory for the block map.
+ */
+u32 AXP_VHD_MapInit(AXP_VHDX_Handle *vhd, u32 blkCount, u32 bitmapSize)
+{
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    vhd->blkCount = blkCount;
+    vhd->bitmapSize = bitmapSize;
+    vhd->blkOffsets = calloc(blkCount, sizeof(u64));
+    if (bitmapSize != 0)
+    {
+        vhd->bitmaps = calloc(blkCount, sizeof(u8 *));
+    }
+    if ((vhd->blkOffsets == NULL) ||
+        ((bitmapSize != 0) && (vhd->bitmaps == NULL)))
+    {
+        free(vhd->blkOffsets);
+        free(vhd->bitmaps);
+        vhd->blkOffsets = NULL;
+        vhd->bitmaps = NULL;
+        retVal = AXP_VHD_OUTOFMEMORY;
+    }
+    else
+    {
+        pthread_mutex_init(&vhd->mapMutex, NULL);
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MapFree
+ *  This function is called when a virtual disk is closed, to free the block
+ *  map and the in-memory Block Allocation Table, and close the parent of a
+ *  differencing disk.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *
+ * Output Parameters:
+ *  vhd:
+ *      A pointer to the handle, with no block map.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_VHD_MapFree(AXP_VHDX_Handle *vhd)
+{
+    u32 ii;
+
+    if (vhd->blkOffsets != NULL)
+    {
+        if (vhd->bitmaps != NULL)
+        {
+            for (ii = 0; ii < vhd->blkCount; ii++)
+            {
+                free(vhd->bitmaps[ii]);
+            }
+            free(vhd->bitmaps);
+            vhd->bitmaps = NULL;
+        }
+        free(vhd->blkOffsets);
+        vhd->blkOffsets = NULL;
+        pthread_mutex_destroy(&vhd->mapMutex);
+    }
+    if (vhd->parent != NULL)
+    {
+        AXP_VHD_CloseHandle(vhd->parent);
+        vhd->parent = NULL;
+    }
+    if (vhd->bat != NULL)
+    {
+        AXP_Deallocate_Block(vhd->bat);
+        vhd->bat = NULL;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_VHD_StartIO
+ *  This function is called once a virtual disk file has been opened for
+ *  read/write, to create the engine that will read and write its sectors.  If
+ *  one cannot be created, the sectors are read and written using the file
+ *  pointer.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *
+ * Output Parameters:
+ *  vhd:
+ *      A pointer to the handle, with the file descriptor and I/O engine set.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_VHD_StartIO(AXP_VHDX_Handle *vhd)
+{
+    vhd->fd = fileno(vhd->fp);
+    vhd->io = AXP_VHD_IO_Create(vhd->fd, AXP_VHD_IO_DEPTH, AXP_VHD_IO_Auto);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_VHD_Transfer
+ *  This function is called to read or write a contiguous run of bytes in a
+ *  virtual disk file, and wait for it to complete.  The I/O engine is used if
+ *  there is one, otherwise the file pointer.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  op:
+ *      A value indicating whether to read or write.
+ *  offset:
+ *      A value indicating the offset within the file.
+ *  buf:
+ *      A pointer to the data to be written.
+ *  length:
+ *      A pointer to the number of bytes to transfer.
+ *
+ * Output Parameters:
+ *  buf:
+ *      A pointer to the location to receive the data read.
+ *  length:
+ *      A pointer to the number of bytes actually transferred.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     An error occurred reading from the file.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the file.
+ */
+u32 AXP_VHD_Transfer(AXP_VHDX_Handle *vhd,
+                     AXP_VHD_IO_OP op,
+                     u64 offset,
+                     u8 *buf,
+                     size_t *length)
+{
+    AXP_VHD_IO_REQ req;
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if (vhd->io != NULL)
+    {
+        req.op = op;
+        req.buf = buf;
+        req.offset = offset;
+        req.length = *length;
+        retVal = AXP_VHD_IO_Transfer(vhd->io, &req);
+        *length = req.transferred;
+    }
+    else if (op == AXP_VHD_IO_Read)
+    {
+        if (AXP_ReadFromOffset(vhd->fp, buf, length, offset) == false)
+        {
+            retVal = AXP_VHD_READ_FAULT;
+        }
+    }
+    else if (AXP_WriteAtOffset(vhd->fp, buf, *length, offset) == false)
+    {
+        retVal = AXP_VHD_WRITE_FAULT;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MapRead
+ *  This function is called to read sectors from a dynamic or differencing
+ *  virtual disk.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  lba:
+ *      A value indicating the first sector to be read.
+ *  sectorsRead:
+ *      A pointer to the number of sectors to be read.
+ *
+ * Output Parameters:
+ *  sectorsRead:
+ *      A pointer to the number of sectors actually read.
+ *  outBuf:
+ *      A pointer to the location to receive the sectors.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT:     An error occurred reading from the file.
+ */
+u32 AXP_VHD_MapRead(AXP_VHDX_Handle *vhd,
+                    u64 lba,
+                    u32 *sectorsRead,
+                    u8 *outBuf)
+{
+    AXP_VHD_MAP_RUN run = {0, NULL, 0};
+    u32 sectorsPerBlk = vhd->blkSize / vhd->sectorSize;
+    u32 sectors = *sectorsRead;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 blk, first, count, ii, len;
+    u8 *bitmap;
+    bool present;
+
+    while ((sectors > 0) && (retVal == AXP_VHD_SUCCESS))
+    {
+        blk = lba / sectorsPerBlk;
+        first = lba % sectorsPerBlk;
+        count = sectorsPerBlk - first;
+        if (count > sectors)
+        {
+            count = sectors;
+        }
+
+        /*
+         * A block that has not been allocated has nothing in the file.
+         */
+        if (vhd->blkOffsets[blk] == 0)
+        {
+            retVal = _AXP_VHD_MapFlushRun(vhd, AXP_VHD_IO_Read, &run);
+            if (retVal == AXP_VHD_SUCCESS)
+            {
+                retVal = _AXP_VHD_MapFromParent(vhd, lba, count, outBuf);
+            }
+        }
+
+        /*
+         * Everything in an allocated block of a dynamic disk is in the file.
+         */
+        else if (vhd->differencing == false)
+        {
+            retVal = _AXP_VHD_MapAddRun(vhd,
+                                        AXP_VHD_IO_Read,
+                                        &run,
+                                        vhd->blkOffsets[blk] +
+                                        ((u64) first * vhd->sectorSize),
+                                        outBuf,
+                                        (size_t) count * vhd->sectorSize);
+        }
+
+        /*
+         * A differencing disk's block can have some sectors in the file, and
+         * the rest in the parent.  Read each run of them from the right place.
+         */
+        else
+        {
+            pthread_mutex_lock(&vhd->mapMutex);
+            bitmap = _AXP_VHD_MapBitmap(vhd, blk);
+            pthread_mutex_unlock(&vhd->mapMutex);
+            if (bitmap == NULL)
+            {
+                retVal = AXP_VHD_READ_FAULT;
+            }
+            for (ii = 0; ((ii < count) && (retVal == AXP_VHD_SUCCESS)); )
+            {
+                present = AXP_VHD_MAP_TEST(bitmap, first + ii);
+                for (len = 1;
+                     (((ii + len) < count) &&
+                      (AXP_VHD_MAP_TEST(bitmap, first + ii + len) == present));
+                     len++)
+                {
+                    continue;
+                }
+                if (present == true)
+                {
+                    retVal = _AXP_VHD_MapAddRun(vhd,
+                                                AXP_VHD_IO_Read,
+                                                &run,
+                                                vhd->blkOffsets[blk] +
+                                                ((u64) (first + ii) *
+                                                 vhd->sectorSize),
+                                                &outBuf[ii * vhd->sectorSize],
+                                                (size_t) len * vhd->sectorSize);
+                }
+                else
+                {
+                    retVal = _AXP_VHD_MapFlushRun(vhd, AXP_VHD_IO_Read, &run);
+                    if (retVal == AXP_VHD_SUCCESS)
+                    {
+                        retVal = _AXP_VHD_MapFromParent(vhd,
+                                                        lba + ii,
+                                                        len,
+                                                        &outBuf[ii *
+                                                            vhd->sectorSize]);
+                    }
+                }
+                ii += len;
+            }
+        }
+        lba += count;
+        outBuf += (size_t) count * vhd->sectorSize;
+        sectors -= count;
+    }
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+        retVal = _AXP_VHD_MapFlushRun(vhd, AXP_VHD_IO_Read, &run);
+    }
+    if (retVal != AXP_VHD_SUCCESS)
+    {
+        *sectorsRead = 0;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MapWrite
+ *  This function is called to write sectors to a dynamic or differencing
+ *  virtual disk.  Any blocks that have not been allocated are allocated
+ *  first, all at once.  The sector bitmaps are updated after the sectors have
+ *  been written.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  lba:
+ *      A value indicating the first sector to be written.
+ *  sectorsWritten:
+ *      A pointer to the number of sectors to be written.
+ *  inBuf:
+ *      A pointer to the sectors to be written.
+ *
+ * Output Parameters:
+ *  sectorsWritten:
+ *      A pointer to the number of sectors actually written.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred writing to the file.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory to allocate the blocks.
+ */
+u32 AXP_VHD_MapWrite(AXP_VHDX_Handle *vhd,
+                     u64 lba,
+                     u32 *sectorsWritten,
+                     u8 *inBuf)
+{
+    AXP_VHD_MAP_RUN run = {0, NULL, 0};
+    u32 sectorsPerBlk = vhd->blkSize / vhd->sectorSize;
+    u32 sectors = *sectorsWritten;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 blk, first, count, blkCount = 0;
+    u32 *blks;
+    u64 next = lba;
+
+    /*
+     * Allocate the blocks this write needs.
+     */
+    blks = calloc((sectors / sectorsPerBlk) + 2, sizeof(u32));
+    if (blks != NULL)
+    {
+        pthread_mutex_lock(&vhd->mapMutex);
+        _AXP_VHD_MapReserve(vhd, lba, sectors, blks, &blkCount);
+        retVal = _AXP_VHD_MapAllocate(vhd, blks, blkCount);
+        pthread_mutex_unlock(&vhd->mapMutex);
+        free(blks);
+    }
+    else
+    {
+        retVal = AXP_VHD_OUTOFMEMORY;
+    }
+
+    /*
+     * Now write the sectors, as few runs as there can be.
+     */
+    while ((sectors > 0) && (retVal == AXP_VHD_SUCCESS))
+    {
+        blk = next / sectorsPerBlk;
+        first = next % sectorsPerBlk;
+        count = sectorsPerBlk - first;
+        if (count > sectors)
+        {
+            count = sectors;
+        }
+        retVal = _AXP_VHD_MapAddRun(vhd,
+                                    AXP_VHD_IO_Write,
+                                    &run,
+                                    vhd->blkOffsets[blk] +
+                                    ((u64) first * vhd->sectorSize),
+                                    inBuf,
+                                    (size_t) count * vhd->sectorSize);
+        next += count;
+        inBuf += (size_t) count * vhd->sectorSize;
+        sectors -= count;
+    }
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+        retVal = _AXP_VHD_MapFlushRun(vhd, AXP_VHD_IO_Write, &run);
+    }
+
+    /*
+     * Finally, mark the sectors of a differencing disk as being present.
+     */
+    if ((retVal == AXP_VHD_SUCCESS) && (vhd->differencing == true))
+    {
+        pthread_mutex_lock(&vhd->mapMutex);
+        retVal = _AXP_VHD_MapMark(vhd, lba, *sectorsWritten);
+        pthread_mutex_unlock(&vhd->mapMutex);
+    }
+    if (retVal != AXP_VHD_SUCCESS)
+    {
+        *sectorsWritten = 0;
+    }
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MapSubmit
+ *  This function is called to submit a batch of sector reads, writes, and
+ *  flushes for a dynamic or differencing virtual disk.  All the blocks that
+ *  the writes need are allocated at once.  Each request that is one run of
+ *  sectors in the file is handed to the I/O engine.  The rest are broken up
+ *  and completed before this function returns, as are reads of blocks that
+ *  have not been allocated.
+ *
+ * Input Parameters:
+ *  vhd:
+ *      A pointer to the handle for the virtual disk.
+ *  reqs:
+ *      A pointer to an array of pointers to the requests.
+ *  count:
+ *      A value indicating the number of requests.
+ *
+ * Output Parameters:
+ *  reqs:
+ *      A pointer to an array of pointers to the requests, with the offset and
+ *      length in the file set in each one handed to the I/O engine.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    An error occurred allocating the blocks, or the
+ *                          requests could not be submitted.
+ *  AXP_VHD_OUTOFMEMORY:    Insufficient memory to perform operation.
+ */
+u32 AXP_VHD_MapSubmit(AXP_VHDX_Handle *vhd, AXP_VHD_IO_REQ **reqs, u32 count)
+{
+    AXP_VHD_IO_REQ **direct;
+    AXP_VHD_IO_REQ *req;
+    u32 sectorsPerBlk = vhd->blkSize / vhd->sectorSize;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 maxBlks = 0, blkCount = 0, directCount = 0;
+    u32 ii, sectors;
+    u32 *blks;
+
+    /*
+     * Allocate all the blocks the writes in the batch need.
+     */
+    for (ii = 0; ii < count; ii++)
+    {
+        if (reqs[ii]->op == AXP_VHD_IO_Write)
+        {
+            maxBlks += (reqs[ii]->sectors / sectorsPerBlk) + 2;
+        }
+    }
+    direct = calloc(count, sizeof(AXP_VHD_IO_REQ *));
+    blks = calloc(maxBlks + 1, sizeof(u32));
+    if ((direct != NULL) && (blks != NULL))
+    {
+        pthread_mutex_lock(&vhd->mapMutex);
+        for (ii = 0; ii < count; ii++)
+        {
+            if (reqs[ii]->op == AXP_VHD_IO_Write)
+            {
+                _AXP_VHD_MapReserve(vhd,
+                                    reqs[ii]->lba,
+                                    reqs[ii]->sectors,
+                                    blks,
+                                    &blkCount);
+            }
+        }
+        retVal = _AXP_VHD_MapAllocate(vhd, blks, blkCount);
+        pthread_mutex_unlock(&vhd->mapMutex);
+    }
+    else
+    {
+        retVal = AXP_VHD_OUTOFMEMORY;
+    }
+
+    /*
+     * Hand the requests that can go as they are to the I/O engine, and do the
+     * rest here.  A write to sectors a differencing disk does not have yet is
+     * done here, so that they are marked as present only once they have been
+     * written.
+     */
+    for (ii = 0; ((ii < count) && (retVal == AXP_VHD_SUCCESS)); ii++)
+    {
+        req = reqs[ii];
+        if ((vhd->io != NULL) &&
+            ((req->op == AXP_VHD_IO_Flush) ||
+             (_AXP_VHD_MapExtent(vhd, req) == true)))
+        {
+            direct[directCount++] = req;
+        }
+        else
+        {
+            sectors = req->sectors;
+            switch (req->op)
+            {
+                case AXP_VHD_IO_Read:
+                    req->status = AXP_VHD_MapRead(vhd,
+                                                  req->lba,
+                                                  &sectors,
+                                                  req->buf);
+                    break;
+
+                case AXP_VHD_IO_Write:
+                    req->status = AXP_VHD_MapWrite(vhd,
+                                                   req->lba,
+                                                   &sectors,
+                                                   req->buf);
+                    break;
+
+                case AXP_VHD_IO_Flush:
+                default:
+                    fflush(vhd->fp);
+                    req->status = (fdatasync(vhd->fd) == 0) ?
+                        AXP_VHD_SUCCESS :
+                        AXP_VHD_WRITE_FAULT;
+                    sectors = 0;
+                    break;
+            }
+            req->length = (size_t) req->sectors * vhd->sectorSize;
+            req->transferred = (size_t) sectors * vhd->sectorSize;
+            if (req->done != NULL)
+            {
+                req->done(req);
+            }
+            req->complete = true;
+        }
+    }
+    if ((retVal == AXP_VHD_SUCCESS) && (directCount > 0))
+    {
+        retVal = AXP_VHD_IO_Submit(vhd->io, direct, directCount);
+    }
+    free(direct);
+    free(blks);
+
+    /*
+     * Return the outcome of this call back to the caller.
+     */
+    return (retVal);
+}
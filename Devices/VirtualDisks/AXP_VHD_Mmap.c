@@ -0,0 +1,422 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the code to read and write the sectors of a
+ *  RAW or fixed VHD disk through a mapping of the file into memory.  The
+ *  sectors of these disks are at the start of the file, one after the other,
+ *  so a read or write is a copy to or from the mapping, with no system call
+ *  or seek.  How soon the host writes what was copied into the mapping back
+ *  to the file is set when the mapping is created.  In write back mode, it is
+ *  only certain to be in the file after a flush, which the guest asks for
+ *  when it needs it to be.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#include "Devices/VirtualDisks/AXP_VHD_Mmap.h"
+#include "Devices/VirtualDisks/AXP_VirtualDisk.h"
+#include <unistd.h>
+#include <sys/mman.h>
+
+struct _AXP_VHD_MMAP
+{
+    u8 *base;
+    u64 length;
+    u64 pageSize;
+    bool readOnly;
+    AXP_VHD_MMAP_SYNC sync;
+
+    /*
+     * The mutex protects the range of pages written since the last flush.
+     * When nothing has been, dirtyLow is greater than dirtyHigh.
+     */
+    pthread_mutex_t mutex;
+    u64 dirtyLow;
+    u64 dirtyHigh;
+};
+
+/*
+ * AXP_VHD_MMAP_Create
+ *  This function is called to map the first part of an open file into
+ *  memory, and tell the host how it will be accessed.
+ *
+ * Input Parameters:
+ *  fd:
+ *      A value of the file descriptor for the open file.
+ *  length:
+ *      A value indicating the number of bytes, from the start of the file, to
+ *      be mapped.
+ *  readOnly:
+ *      A boolean indicating that the mapping will not be written.
+ *  advice:
+ *      A value indicating how the mapping will be accessed.
+ *  sync:
+ *      A value indicating when what is written to the mapping should be
+ *      written to the file.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL:       The file could not be mapped.
+ *  Otherwise:  A pointer to the mapping.
+ */
+AXP_VHD_MMAP *AXP_VHD_MMAP_Create(int fd,
+                                  u64 length,
+                                  bool readOnly,
+                                  AXP_VHD_MMAP_ADVICE advice,
+                                  AXP_VHD_MMAP_SYNC sync)
+{
+    AXP_VHD_MMAP *map = NULL;
+    void *base;
+    int prot = readOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+    int hint;
+
+    if (length > 0)
+    {
+        base = mmap(NULL, length, prot, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED)
+        {
+            map = calloc(1, sizeof(AXP_VHD_MMAP));
+            if (map != NULL)
+            {
+                map->base = (u8 *) base;
+                map->length = length;
+                map->pageSize = sysconf(_SC_PAGESIZE);
+                map->readOnly = readOnly;
+                map->sync = sync;
+                map->dirtyLow = length;
+                map->dirtyHigh = 0;
+                pthread_mutex_init(&map->mutex, NULL);
+                switch (advice)
+                {
+                    case AXP_VHD_MMAP_Sequential:
+                        hint = MADV_SEQUENTIAL;
+                        break;
+
+                    case AXP_VHD_MMAP_Random:
+                        hint = MADV_RANDOM;
+                        break;
+
+                    case AXP_VHD_MMAP_WillNeed:
+                        hint = MADV_WILLNEED;
+                        break;
+
+                    case AXP_VHD_MMAP_Normal:
+                    default:
+                        hint = MADV_NORMAL;
+                        break;
+                }
+
+                /*
+                 * The advice is only a hint, so the mapping is still good if
+                 * the host does not take it.
+                 */
+                (void) madvise(base, length, hint);
+            }
+            else
+            {
+                munmap(base, length);
+            }
+        }
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (map);
+}
+
+/*
+ * AXP_VHD_MMAP_Destroy
+ *  This function is called to write anything still dirty back to the file,
+ *  and unmap and release the mapping.
+ *
+ * Input Parameters:
+ *  map:
+ *      A pointer to the mapping.  This may be NULL.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_VHD_MMAP_Destroy(AXP_VHD_MMAP *map)
+{
+    if (map != NULL)
+    {
+        (void) AXP_VHD_MMAP_Flush(map);
+        munmap(map->base, map->length);
+        pthread_mutex_destroy(&map->mutex);
+        free(map);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_VHD_MMAP_Read
+ *  This function is called to copy bytes out of the mapping.
+ *
+ * Input Parameters:
+ *  map:
+ *      A pointer to the mapping.
+ *  offset:
+ *      A value indicating the offset in the file of the first byte.
+ *  buf:
+ *      A pointer to the buffer to receive the bytes.
+ *  length:
+ *      A pointer to the number of bytes to be read.
+ *
+ * Output Parameters:
+ *  length:
+ *      A pointer to receive the number of bytes actually read.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:    Normal Successful Completion.
+ *  AXP_VHD_READ_FAULT: The bytes are not all within the mapping.
+ */
+u32 AXP_VHD_MMAP_Read(AXP_VHD_MMAP *map, u64 offset, u8 *buf, size_t *length)
+{
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if ((offset <= map->length) && (*length <= (map->length - offset)))
+    {
+        memcpy(buf, &map->base[offset], *length);
+    }
+    else
+    {
+        *length = 0;
+        retVal = AXP_VHD_READ_FAULT;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MMAP_Write
+ *  This function is called to copy bytes into the mapping.  Depending upon
+ *  the mapping's sync mode, the pages written are written to the file before
+ *  returning, are started being written to the file, or are left for the next
+ *  flush.
+ *
+ * Input Parameters:
+ *  map:
+ *      A pointer to the mapping.
+ *  offset:
+ *      A value indicating the offset in the file of the first byte.
+ *  buf:
+ *      A pointer to the bytes to be written.
+ *  length:
+ *      A pointer to the number of bytes to be written.
+ *
+ * Output Parameters:
+ *  length:
+ *      A pointer to receive the number of bytes actually written.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    The bytes are not all within the mapping, the
+ *                          mapping is read-only, or they could not be written
+ *                          to the file.
+ */
+u32 AXP_VHD_MMAP_Write(AXP_VHD_MMAP *map, u64 offset, u8 *buf, size_t *length)
+{
+    u32 retVal = AXP_VHD_SUCCESS;
+    u64 low, high;
+
+    if ((map->readOnly == false) &&
+        (offset <= map->length) &&
+        (*length <= (map->length - offset)))
+    {
+        memcpy(&map->base[offset], buf, *length);
+        low = offset & ~(map->pageSize - 1);
+        high = offset + *length;
+        if (map->sync == AXP_VHD_MMAP_WriteThrough)
+        {
+            if (msync(&map->base[low], high - low, MS_SYNC) != 0)
+            {
+                retVal = AXP_VHD_WRITE_FAULT;
+            }
+        }
+        else
+        {
+            if (map->sync == AXP_VHD_MMAP_Async)
+            {
+                (void) msync(&map->base[low], high - low, MS_ASYNC);
+            }
+            pthread_mutex_lock(&map->mutex);
+            if (low < map->dirtyLow)
+            {
+                map->dirtyLow = low;
+            }
+            if (high > map->dirtyHigh)
+            {
+                map->dirtyHigh = high;
+            }
+            pthread_mutex_unlock(&map->mutex);
+        }
+    }
+    else
+    {
+        *length = 0;
+        retVal = AXP_VHD_WRITE_FAULT;
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MMAP_Flush
+ *  This function is called to write everything written to the mapping since
+ *  the last flush to the file, and wait for it to get there.
+ *
+ * Input Parameters:
+ *  map:
+ *      A pointer to the mapping.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_WRITE_FAULT:    The pages could not be written to the file.
+ */
+u32 AXP_VHD_MMAP_Flush(AXP_VHD_MMAP *map)
+{
+    u32 retVal = AXP_VHD_SUCCESS;
+    u64 low, high;
+
+    /*
+     * Take the dirty range, so that writes made while it is being written to
+     * the file are left for the next flush.
+     */
+    pthread_mutex_lock(&map->mutex);
+    low = map->dirtyLow;
+    high = map->dirtyHigh;
+    map->dirtyLow = map->length;
+    map->dirtyHigh = 0;
+    pthread_mutex_unlock(&map->mutex);
+    if (low < high)
+    {
+        if (msync(&map->base[low], high - low, MS_SYNC) != 0)
+        {
+            retVal = AXP_VHD_WRITE_FAULT;
+
+            /*
+             * Put the range back, so that the next flush tries again.
+             */
+            pthread_mutex_lock(&map->mutex);
+            if (low < map->dirtyLow)
+            {
+                map->dirtyLow = low;
+            }
+            if (high > map->dirtyHigh)
+            {
+                map->dirtyHigh = high;
+            }
+            pthread_mutex_unlock(&map->mutex);
+        }
+    }
+
+    /*
+     * Return the results back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MMAP_Submit
+ *  This function is called to perform a batch of requests against the
+ *  mapping.  There is nothing to wait for, so each request is completed, and
+ *  its done function called, before the next one is performed.  A flush
+ *  therefore covers all the writes before it.
+ *
+ * Input Parameters:
+ *  map:
+ *      A pointer to the mapping.
+ *  reqs:
+ *      A pointer to an array of pointers to the requests.  Each one has its
+ *      op, buf, offset, and length set.
+ *  count:
+ *      A value indicating the number of requests in the array.
+ *
+ * Output Parameters:
+ *  reqs:
+ *      A pointer to an array of pointers to the requests, with the status,
+ *      transferred, and complete fields set in each.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_VHD_MMAP_Submit(AXP_VHD_MMAP *map, AXP_VHD_IO_REQ **reqs, u32 count)
+{
+    AXP_VHD_IO_REQ *req;
+    u32 ii;
+
+    for (ii = 0; ii < count; ii++)
+    {
+        req = reqs[ii];
+        req->complete = false;
+        req->transferred = req->length;
+        switch (req->op)
+        {
+            case AXP_VHD_IO_Read:
+                req->status = AXP_VHD_MMAP_Read(map,
+                                                req->offset,
+                                                req->buf,
+                                                &req->transferred);
+                break;
+
+            case AXP_VHD_IO_Write:
+                req->status = AXP_VHD_MMAP_Write(map,
+                                                 req->offset,
+                                                 req->buf,
+                                                 &req->transferred);
+                break;
+
+            case AXP_VHD_IO_Flush:
+            default:
+                req->transferred = 0;
+                req->status = AXP_VHD_MMAP_Flush(map);
+                break;
+        }
+        if (req->done != NULL)
+        {
+            (*req->done)(req);
+        }
+        req->complete = true;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
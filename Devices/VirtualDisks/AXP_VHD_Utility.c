@@ -31,6 +31,18 @@
  *  these all appear to be when trying to get the 64-bit value equivalent of
  *  the 64-bit long PC structure.  We will use shifts (in a macro) instead of
  *  the casts.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  The minimum and maximum block sizes are themselves valid, otherwise the
+ *  default block size for a VHD, which is also the maximum, is rejected.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  A differencing VHD can now be created.  Its disk size can be left as zero,
+ *  in which case it is taken from the parent.  A disk can be opened with no
+ *  flags, so that the parent of a differencing disk is opened with it.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  The sectors of a RAW disk can now be read and written.
  */
 #include "Devices/VirtualDisks/AXP_VirtualDisk.h"
 #include "CommonUtilities/AXP_Utility.h"
@@ -40,6 +52,7 @@
 #include "Devices/VirtualDisks/AXP_VHD_Utility.h"
 #include "Devices/VirtualDisks/AXP_VHD.h"
 #include "Devices/VirtualDisks/AXP_VHDX.h"
+#include "Devices/VirtualDisks/AXP_RAW.h"
 #include <sys/stat.h>
 #include <fcntl.h>
 
@@ -497,7 +510,7 @@ u64 AXP_VHD_PerformFileSize(FILE *fp)
  * Return Values:
  *  AXP_VHD_SUCCESS:        Normal Successful Completion.
  *  AXP_VHD_NOT_SUPPORTED:  Requested function is not supported
- *                          (Differencing Disk)
+ *                          (Differencing VHDX Disk)
  *  AXP_VHD_INV_PARAM:      An invalid parameter or combination of
  *                          parameters was detected.
  */
@@ -663,7 +676,9 @@ u32 AXP_VHD_ValidateCreate(AXP_VHD_STORAGE_TYPE *storageType,
              *  4) Sector Size must be either the minimum or maximum (but not
              *     in between).
              *  5) Disk Size needs to be between the minimum and maximum
-             *     allowable sized and  be a multiple of Sector Size.
+             *     allowable sized and  be a multiple of Sector Size, unless
+             *     it is zero for a differencing disk.
+             *  6) Only a VHD can be a differencing disk.
              */
             if (((param->ver != CREATE_VER_1) &&
                  (param->ver != CREATE_VER_2)) ||
@@ -671,18 +686,20 @@ u32 AXP_VHD_ValidateCreate(AXP_VHD_STORAGE_TYPE *storageType,
                  (accessMask != ACCESS_NONE)) ||
                 (flags > CREATE_FULL_PHYSICAL_ALLOCATION) ||
                 ((accessMask & ~ACCESS_ALL) != 0) ||
-                 (((*blkSize <= minBlk) ||
-                   (*blkSize >= maxBlk)) ||
+                 (((*blkSize < minBlk) ||
+                   (*blkSize > maxBlk)) ||
                   (IS_POWER_OF_2(*blkSize) == false)) ||
                  ((*sectorSize != minSector) &&
                   (*sectorSize != maxSector)) ||
-                 ((*diskSize < minDisk) ||
-                  (*diskSize > maxDisk) ||
-                  ((*diskSize % *sectorSize) != 0)))
+                 (((*parentPath == NULL) || (*diskSize != 0)) &&
+                  ((*diskSize < minDisk) ||
+                   (*diskSize > maxDisk) ||
+                   ((*diskSize % *sectorSize) != 0))))
             {
                 retVal = AXP_VHD_INV_PARAM;
             }
-            else if (*parentPath != NULL)
+            else if ((*parentPath != NULL) &&
+                     (storageType->deviceID != STORAGE_TYPE_DEV_VHD))
             {
                 retVal = AXP_VHD_NOT_SUPPORTED;
             }
@@ -756,12 +773,14 @@ u32 AXP_VHD_ValidateOpen(AXP_VHD_STORAGE_TYPE *storageType,
          *
          *  1) Only Version 1 is supported at this time.
          *  2) The access mask must only include the same bits set by ALL.
-         *  3) The flags is not equal to OPEN_NO_PARENTS or OPEN_BLANK_FILE.
+         *  3) The flags is not equal to OPEN_NONE, OPEN_NO_PARENTS, or
+         *     OPEN_BLANK_FILE.
          */
         if (((param != NULL) &&
              (param->ver != OPEN_VER_1)) ||
             ((accessMask & ~ACCESS_ALL) != 0) ||
-             ((flags != OPEN_NO_PARENTS) &&
+             ((flags != OPEN_NONE) &&
+              (flags != OPEN_NO_PARENTS) &&
               (flags != OPEN_BLANK_FILE)))
         {
             retVal = AXP_VHD_INV_PARAM;
@@ -815,6 +834,7 @@ u32 AXP_VHD_ValidateRead(AXP_VHD_HANDLE handle,
                          u32 *deviceID)
 {
     AXP_VHDX_Handle *vhdHandle;
+    AXP_RAW_Handle *rawHandle;
     u32 retVal = AXP_VHD_SUCCESS;
     u64 blkOffset;
 
@@ -832,6 +852,20 @@ u32 AXP_VHD_ValidateRead(AXP_VHD_HANDLE handle,
             *deviceID = vhdHandle->deviceID;
         }
     }
+    else if (AXP_ReturnType_Block(handle) == AXP_RAW_BLK)
+    {
+        rawHandle = (AXP_RAW_Handle *) handle;
+        blkOffset = (u64) rawHandle->sectorSize * lba;
+        blkOffset += ((u64) sectorsRead * (u64) rawHandle->sectorSize);
+        if (blkOffset > rawHandle->diskSize)
+        {
+            retVal = AXP_VHD_INV_PARAM;
+        }
+        else
+        {
+            *deviceID = rawHandle->deviceID;
+        }
+    }
     else
     {
         retVal = AXP_VHD_INV_HANDLE;
@@ -867,6 +901,7 @@ u32 AXP_VHD_ValidateWrite(AXP_VHD_HANDLE handle,
                           u32 *deviceID)
 {
     AXP_VHDX_Handle *vhdHandle;
+    AXP_RAW_Handle *rawHandle;
     u32 retVal = AXP_VHD_SUCCESS;
     u64 blkOffset;
 
@@ -884,6 +919,20 @@ u32 AXP_VHD_ValidateWrite(AXP_VHD_HANDLE handle,
             *deviceID = vhdHandle->deviceID;
         }
     }
+    else if (AXP_ReturnType_Block(handle) == AXP_RAW_BLK)
+    {
+        rawHandle = (AXP_RAW_Handle *) handle;
+        blkOffset = (u64) rawHandle->sectorSize * lba;
+        blkOffset += ((u64) sectorsWritten * (u64) rawHandle->sectorSize);
+        if (blkOffset > rawHandle->diskSize)
+        {
+            retVal = AXP_VHD_INV_PARAM;
+        }
+        else
+        {
+            *deviceID = rawHandle->deviceID;
+        }
+    }
     else
     {
         retVal = AXP_VHD_INV_HANDLE;
@@ -23,6 +23,20 @@
  *
  *  V01.000 08-Jul-2018 Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Writing sectors to a VHD was reading them instead.  Added the functions to
+ *  submit a batch of sector I/Os, and wait for them to complete.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Sectors can now be read from, written to, and submitted for a VHDX.  The
+ *  block map of a dynamic or differencing disk, and the parent of the latter,
+ *  are freed and closed when the disk is.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Sectors can now be read from and written to a RAW disk.  Added the
+ *  functions to map a RAW or fixed VHD disk into memory, and to flush what
+ *  has been written to a disk.
  */
 #include "Devices/VirtualDisks/AXP_VirtualDisk.h"
 #include "CommonUtilities/AXP_Utility.h"
@@ -31,6 +45,7 @@
 #include "CommonUtilities/AXP_Trace.h"
 #include "Devices/VirtualDisks/AXP_VHDX.h"
 #include "Devices/VirtualDisks/AXP_VHD.h"
+#include "Devices/VirtualDisks/AXP_VHD_BlockMap.h"
 #include "Devices/VirtualDisks/AXP_RAW.h"
 #include "Devices/VirtualDisks/AXP_SSD.h"
 
@@ -367,13 +382,12 @@ u32 AXP_VHD_ReadSectors(AXP_VHD_HANDLE handle,
             case STORAGE_TYPE_DEV_VHD:
                 retVal = _AXP_VHD_ReadSectors(handle,
                                               lba,
-                                              (size_t *) sectorsRead,
+                                              sectorsRead,
                                               outBuf);
                 break;
 
-#if 0
             /*
-             * Read from a VHDX formatted virtual disk.  TODO
+             * Read from a VHDX formatted virtual disk.
              */
             case STORAGE_TYPE_DEV_VHDX:
                 retVal = _AXP_VHDX_ReadSectors(handle,
@@ -383,13 +397,15 @@ u32 AXP_VHD_ReadSectors(AXP_VHD_HANDLE handle,
                 break;
 
             /*
-             * Read from a RAW or ISO formatted physical/virtual disk. TODO
+             * Read from a RAW or ISO formatted physical/virtual disk.
              */
             case STORAGE_TYPE_DEV_RAW:
             case STORAGE_TYPE_DEV_ISO:
                 retVal = _AXP_RAW_ReadSectors(handle, lba, sectorsRead, outBuf);
                 break;
 
+#if 0
+
             /*
              * Read from a Solid State Disk (SSD). TODO
              */
@@ -464,33 +480,34 @@ u32 AXP_VHD_WriteSectors(AXP_VHD_HANDLE handle,
              * Write to a VHD formatted virtual disk.
              */
             case STORAGE_TYPE_DEV_VHD:
-                retVal = _AXP_VHD_ReadSectors(handle,
-                                              lba,
-                                              (size_t *) sectorsWritten,
-                                              inBuf);
+                retVal = _AXP_VHD_WriteSectors(handle,
+                                               lba,
+                                               sectorsWritten,
+                                               inBuf);
                 break;
 
-#if 0
             /*
-             * Write to a VHDX formatted virtual disk. TODO
+             * Write to a VHDX formatted virtual disk.
              */
             case STORAGE_TYPE_DEV_VHDX:
-                retVal = _AXP_VHDX_ReadSectors(handle,
-                                               lba,
-                                               sectorsWritten,
-                                               inBuf);
+                retVal = _AXP_VHDX_WriteSectors(handle,
+                                                lba,
+                                                sectorsWritten,
+                                                inBuf);
                 break;
 
             /*
-             * Write to a RAW formatted physical disk. TODO
+             * Write to a RAW formatted physical disk.
              */
             case STORAGE_TYPE_DEV_RAW:
-                retVal = _AXP_RAW_ReadSectors(handle,
-                                              lba,
-                                              sectorsWritten,
-                                              inBuf);
+                retVal = _AXP_RAW_WriteSectors(handle,
+                                               lba,
+                                               sectorsWritten,
+                                               inBuf);
                 break;
 
+#if 0
+
             /*
              * Write to a Solid State Disk (SSD). TODO
              */
@@ -519,6 +536,321 @@ u32 AXP_VHD_WriteSectors(AXP_VHD_HANDLE handle,
     return (retVal);
 }
 
+/*
+ * AXP_VHD_SubmitSectors
+ *  Submits a batch of sector reads, writes, and flushes to be completed
+ *  asynchronously.  Each request's done function, if it has one, is called as
+ *  the request completes.  A flush completes after all the writes submitted
+ *  before it.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A valid handle to an open object.
+ *  reqs:
+ *      A pointer to an array of pointers to the requests.  The op, lba,
+ *      sectors, buf, done, and ctx fields are set in each.
+ *  count:
+ *      A value indicating the number of requests in the array.
+ *
+ * Output Parameters:
+ *  reqs:
+ *      A pointer to an array of pointers to the requests, with the status,
+ *      transferred, and complete fields set as each completes.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_INV_HANDLE:     The handle is not valid.
+ *  AXP_VHD_INV_PARAM:      A request is beyond the end of the disk.
+ *  AXP_VHD_CALL_NOT_IMPL:  The disk cannot complete I/Os asynchronously.
+ */
+u32 AXP_VHD_SubmitSectors(AXP_VHD_HANDLE handle,
+                          AXP_VHD_IO_REQ **reqs,
+                          u32 count)
+{
+    u32 retVal = AXP_VHD_SUCCESS;
+    u32 deviceID = STORAGE_TYPE_DEV_UNKNOWN;
+    u32 ii;
+
+    /*
+     * Go check the parameters of each request.  A flush has no sectors, but
+     * still needs a valid handle.
+     */
+    for (ii = 0; ((ii < count) && (retVal == AXP_VHD_SUCCESS)); ii++)
+    {
+        switch (reqs[ii]->op)
+        {
+            case AXP_VHD_IO_Read:
+                retVal = AXP_VHD_ValidateRead(handle,
+                                              reqs[ii]->lba,
+                                              reqs[ii]->sectors,
+                                              &deviceID);
+                break;
+
+            case AXP_VHD_IO_Write:
+                retVal = AXP_VHD_ValidateWrite(handle,
+                                               reqs[ii]->lba,
+                                               reqs[ii]->sectors,
+                                               &deviceID);
+                break;
+
+            case AXP_VHD_IO_Flush:
+            default:
+                retVal = AXP_VHD_ValidateWrite(handle, 0, 0, &deviceID);
+                break;
+        }
+    }
+    if ((retVal == AXP_VHD_SUCCESS) && (count > 0))
+    {
+
+        /*
+         * Based on storage type, call the appropriate submit function.
+         */
+        switch (deviceID)
+        {
+
+            /*
+             * Submit to a VHD formatted virtual disk.
+             */
+            case STORAGE_TYPE_DEV_VHD:
+                retVal = _AXP_VHD_SubmitSectors(handle, reqs, count);
+                break;
+
+            /*
+             * Submit to a VHDX formatted virtual disk.
+             */
+            case STORAGE_TYPE_DEV_VHDX:
+                retVal = _AXP_VHDX_SubmitSectors(handle, reqs, count);
+                break;
+
+            /*
+             * Submit to a RAW or ISO formatted physical/virtual disk.
+             */
+            case STORAGE_TYPE_DEV_RAW:
+            case STORAGE_TYPE_DEV_ISO:
+                retVal = _AXP_RAW_SubmitSectors(handle, reqs, count);
+                break;
+
+            /*
+             * The rest do not do asynchronous I/O (yet).
+             */
+            default:
+                retVal = AXP_VHD_CALL_NOT_IMPL;
+                break;
+        }
+    }
+
+    /*
+     * Return the results of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_WaitSectors
+ *  Waits for all the sector I/Os submitted for a virtual disk to complete.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A valid handle to an open object.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_INV_HANDLE:     The handle is not valid.
+ */
+u32 AXP_VHD_WaitSectors(AXP_VHD_HANDLE handle)
+{
+    AXP_VHDX_Handle *vhdx = (AXP_VHDX_Handle *) handle;
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if (AXP_ReturnType_Block(handle) == AXP_VHDX_BLK)
+    {
+        if (vhdx->io != NULL)
+        {
+            AXP_VHD_IO_Wait(vhdx->io);
+        }
+    }
+
+    /*
+     * A RAW disk completes its I/Os before they are submitted.
+     */
+    else if (AXP_ReturnType_Block(handle) != AXP_RAW_BLK)
+    {
+        retVal = AXP_VHD_INV_HANDLE;
+    }
+
+    /*
+     * Return the results of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_MemoryMap
+ *  Maps the sectors of a RAW or fixed VHD disk into memory.  From then on,
+ *  its sectors are read and written by copying them to and from the mapping,
+ *  and submitted I/Os are completed before the submit returns.  Mapping a
+ *  disk that is already mapped replaces the mapping with one that has the
+ *  new advice and sync mode.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A valid handle to an open object.
+ *  advice:
+ *      A value indicating how the disk will be accessed, so the host can read
+ *      ahead (or not) accordingly.
+ *  sync:
+ *      A value indicating when what is written to the disk is written to the
+ *      file.  With AXP_VHD_MMAP_WriteBack, that is only certain after a flush.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_INV_HANDLE:     The handle is not valid.
+ *  AXP_VHD_CALL_NOT_IMPL:  The disk is not a RAW or fixed VHD disk.
+ *  AXP_VHD_OUTOFMEMORY:    The disk could not be mapped into memory.
+ */
+u32 AXP_VHD_MemoryMap(AXP_VHD_HANDLE handle,
+                      AXP_VHD_MMAP_ADVICE advice,
+                      AXP_VHD_MMAP_SYNC sync)
+{
+    AXP_VHD_MMAP **mapping = NULL;
+    u32 retVal = AXP_VHD_SUCCESS;
+    u64 diskSize = 0;
+    bool readOnly = false;
+    int fd = -1;
+
+    /*
+     * The sectors of a fixed VHD are at the start of the file, so they can be
+     * mapped just like those of a RAW disk.  Anything the I/O engine still
+     * has in flight completes before the disk is mapped.
+     */
+    if (AXP_ReturnType_Block(handle) == AXP_VHDX_BLK)
+    {
+        AXP_VHDX_Handle *vhd = (AXP_VHDX_Handle *) handle;
+
+        if ((vhd->deviceID == STORAGE_TYPE_DEV_VHD) && (vhd->fixed == true))
+        {
+            if (vhd->io != NULL)
+            {
+                AXP_VHD_IO_Wait(vhd->io);
+            }
+            fflush(vhd->fp);
+            mapping = &vhd->mapping;
+            diskSize = vhd->diskSize;
+            readOnly = vhd->readOnly;
+            fd = vhd->fd;
+        }
+        else
+        {
+            retVal = AXP_VHD_CALL_NOT_IMPL;
+        }
+    }
+    else if (AXP_ReturnType_Block(handle) == AXP_RAW_BLK)
+    {
+        AXP_RAW_Handle *raw = (AXP_RAW_Handle *) handle;
+
+        mapping = &raw->mapping;
+        diskSize = raw->diskSize;
+        readOnly = raw->readOnly;
+        fd = raw->fd;
+    }
+    else
+    {
+        retVal = AXP_VHD_INV_HANDLE;
+    }
+
+    /*
+     * Replace any mapping the disk already has.
+     */
+    if (mapping != NULL)
+    {
+        AXP_VHD_MMAP_Destroy(*mapping);
+        *mapping = AXP_VHD_MMAP_Create(fd, diskSize, readOnly, advice, sync);
+        if (*mapping == NULL)
+        {
+            retVal = AXP_VHD_OUTOFMEMORY;
+        }
+    }
+
+    /*
+     * Return the results of this call back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_VHD_FlushSectors
+ *  Writes everything written to a virtual disk to its file, and waits for it
+ *  to get there.  This is what the guest's flush (or synchronize cache)
+ *  commands do, and for a disk mapped into memory with AXP_VHD_MMAP_WriteBack
+ *  these are the only points at which its sectors are certain to be in the
+ *  file.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A valid handle to an open object.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  AXP_VHD_SUCCESS:        Normal Successful Completion.
+ *  AXP_VHD_INV_HANDLE:     The handle is not valid.
+ *  AXP_VHD_WRITE_FAULT:    What was written could not be written to the file.
+ */
+u32 AXP_VHD_FlushSectors(AXP_VHD_HANDLE handle)
+{
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    if (AXP_ReturnType_Block(handle) == AXP_VHDX_BLK)
+    {
+        AXP_VHDX_Handle *vhdx = (AXP_VHDX_Handle *) handle;
+
+        if (vhdx->mapping != NULL)
+        {
+            retVal = AXP_VHD_MMAP_Flush(vhdx->mapping);
+        }
+        else
+        {
+            if (vhdx->io != NULL)
+            {
+                AXP_VHD_IO_Wait(vhdx->io);
+            }
+            if ((fflush(vhdx->fp) != 0) || (fdatasync(vhdx->fd) != 0))
+            {
+                retVal = AXP_VHD_WRITE_FAULT;
+            }
+        }
+    }
+    else if (AXP_ReturnType_Block(handle) == AXP_RAW_BLK)
+    {
+        AXP_RAW_Handle *raw = (AXP_RAW_Handle *) handle;
+
+        if (raw->mapping != NULL)
+        {
+            retVal = AXP_VHD_MMAP_Flush(raw->mapping);
+        }
+        else if ((raw->readOnly == false) && (fdatasync(raw->fd) != 0))
+        {
+            retVal = AXP_VHD_WRITE_FAULT;
+        }
+    }
+    else
+    {
+        retVal = AXP_VHD_INV_HANDLE;
+    }
+
+    /*
+     * Return the results of this call back to the caller.
+     */
+    return (retVal);
+}
+
 /*
  * AXP_VHD_CloseHandle
  *  Closes an open object handle.
@@ -544,8 +876,28 @@ u32 AXP_VHD_CloseHandle(AXP_VHD_HANDLE handle)
      */
     if (AXP_ReturnType_Block(handle) == AXP_VHDX_BLK)
     {
+
+        /*
+         * Any I/Os still in flight complete before the file is closed.
+         */
+        if (vhdx->io != NULL)
+        {
+            AXP_VHD_IO_Destroy(vhdx->io);
+            vhdx->io = NULL;
+        }
+        AXP_VHD_MMAP_Destroy(vhdx->mapping);
+        vhdx->mapping = NULL;
+        AXP_VHD_MapFree(vhdx);
         AXP_Deallocate_Block(vhdx);
     }
+    else if (AXP_ReturnType_Block(handle) == AXP_RAW_BLK)
+    {
+        AXP_RAW_Handle *raw = (AXP_RAW_Handle *) handle;
+
+        AXP_VHD_MMAP_Destroy(raw->mapping);
+        raw->mapping = NULL;
+        AXP_Deallocate_Block(raw);
+    }
     else
     {
         retVal = AXP_VHD_INV_HANDLE;
@@ -86,11 +86,93 @@
  *  the system/AXP_21274_21264_Common.h file.  When the System structure is
  *  allocated, it will call the CPU allocation function for each of the CPUs
  *  configured on the system.
+ *
+ *  V01.013 15-Oct-2026 Jonathan D. Belanger
+ *  Added a hashed index for both the ITB and DTB.
+ *
+ *  V01.014 15-Oct-2026 Jonathan D. Belanger
+ *  Added a micro-TLB in front of both the ITB and DTB.
+ *
+ *  V01.015 15-Oct-2026 Jonathan D. Belanger
+ *  Added the predecoded instructions to the instruction line returned from
+ *  the Icache.
+ *
+ *  V01.016 15-Oct-2026 Jonathan D. Belanger
+ *  Added the execution mode (Detailed or Functional) for the CPU, and the
+ *  fields used to request a change from one mode to the other.
+ *
+ *  V01.017 15-Oct-2026 Jonathan D. Belanger
+ *  Added the translated block cache used by the functional execution mode.
+ *
+ *  V01.018 15-Oct-2026 Jonathan D. Belanger
+ *  Replaced the mutex protected IQ and FQ counted queues, and the cluster
+ *  counters, with a lock-free ring per pipeline.  The Ibox puts an entry onto
+ *  the ring of each pipeline that can execute it, and wakes just those
+ *  pipelines.
+ *
+ *  V01.019 15-Oct-2026 Jonathan D. Belanger
+ *  Added the physical register wakeup matrix.  IQ/FQ entries waiting on a
+ *  source register are only handed to the pipelines once the register has
+ *  been written, so the pipelines no longer look at entries that cannot yet
+ *  be executed.
+ *
+ *  V01.020 15-Oct-2026 Jonathan D. Belanger
+ *  The Icache mutex is now only used to serialize writers.  Added counters
+ *  for Icache readers having to retry and for writers having to wait.
+ *
+ *  V01.021 15-Oct-2026 Jonathan D. Belanger
+ *  Added the retirement statistics.
+ *
+ *  V01.022 16-Oct-2026 Jonathan D. Belanger
+ *  Added the performance counters, and a thread to periodically write them
+ *  to a CSV file.
+ *
+ *  V01.023 16-Oct-2026 Jonathan D. Belanger
+ *  Added the Mbox work lists for the LQ and SQ.
+ *
+ *  V01.024 16-Oct-2026 Jonathan D. Belanger
+ *  Added the SQ address buckets, used to forward store data to loads, and
+ *  the counters and retirement statistic for load forwards and replays.
+ *
+ *  V01.025 16-Oct-2026 Jonathan D. Belanger
+ *  Added the System's memory map, used by the Cbox to read and write memory
+ *  blocks directly, and the counters for these.
+ *
+ *  V01.026 16-Oct-2026 Jonathan D. Belanger
+ *  Requests are now sent to the System on this CPU's own request ring.
+ *
+ *  V01.027 16-Oct-2026 Jonathan D. Belanger
+ *  The branch prediction tables are now gathered in a single structure.
+ *
+ *  V01.028 16-Oct-2026 Jonathan D. Belanger
+ *  The prediction stack is now a circular return stack, driven by the Ibox
+ *  when instructions are fetched.  Added the jump target cache, and the
+ *  counters for returns and jumps, and their mispredictions.
+ *
+ *  V01.029 16-Oct-2026 Jonathan D. Belanger
+ *  Added an indicator that the counter thread was started, so that it can be
+ *  joined when the CPU shuts down.
+ *
+ *  V01.030 16-Oct-2026 Jonathan D. Belanger
+ *  Removed the request to change the execution mode.
+ *
+ *  V01.031 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped the micro-TLB and translated block definitions to fit in 80
+ *  columns.
+ *
+ *  V01.032 16-Oct-2026 Jonathan D. Belanger
+ *  Added the number of valid instructions to the instruction line, so that a
+ *  fetch near the end of an Icache block does not return what follows it.
+ *
+ *  V01.033 16-Oct-2026 Jonathan D. Belanger
+ *  Restored the request to change the execution mode, and added the number of
+ *  retired instructions at which the mode is changed.
  */
 #ifndef _AXP_21264_CPU_DEFS_
 #define _AXP_21264_CPU_DEFS_
 
 #include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Configure.h"
 #include "CPU/AXP_Base_CPU.h"
 #include "CPU/AXP_21264_Instructions.h"
 #include "CPU/Ibox/AXP_21264_Predictions.h"
@@ -148,18 +230,28 @@
 #define AXP_21264_FBOX_MULTIPLY 0
 #define AXP_21264_FBOX_OTHER    1
 #define AXP_21264_FBOX_CLUSTERS 2
+#define AXP_21264_PIPE_FMUL     4
+#define AXP_21264_PIPE_FOTH     5
+#define AXP_21264_PIPES         6
+#define AXP_21264_PIPE_MASK(p)  (1 << (p))
+#define AXP_21264_EBOX_PIPES    0x0f
+#define AXP_21264_FBOX_PIPES    0x30
 
 /*
- * Prediction stack macros.
+ * Prediction stack macros.  The stack is circular, and predStackIdx is the
+ * index of the entry on the top of it.
  */
 #define AXP_PUSH(pc)                                                        \
-  if (cpu->predStackIdx > 0)                                                \
-    cpu->predictionStack[--cpu->predStackIdx] = (pc)
+  {                                                                         \
+    cpu->predStackIdx = (cpu->predStackIdx + 1) & AXP_RET_STACK_MASK;       \
+    cpu->predictionStack[cpu->predStackIdx] = (pc);                         \
+  }
 #define AXP_POP(pc)                                                         \
-  if (cpu->predStackIdx < AXP_INFLIGHT_MAX)                                 \
-    pc = cpu->predictionStack[cpu->predStackIdx++]
+  {                                                                         \
+    pc = cpu->predictionStack[cpu->predStackIdx];                           \
+    cpu->predStackIdx = (cpu->predStackIdx - 1) & AXP_RET_STACK_MASK;       \
+  }
 #define AXP_SWAP(pc)                                                        \
-  if (cpu->predStackIdx < AXP_INFLIGHT_MAX)                                 \
   {                                                                         \
     AXP_PC tmpPC;                                                           \
     tmpPC = cpu->predictionStack[cpu->predStackIdx];                        \
@@ -234,28 +326,197 @@
 
 /*
  * This structure is a buffer to contain the next set of instructions to get
- * queued up for execution.
+ * queued up for execution.  Only the first instrCount instructions are valid.
+ * There are fewer than AXP_NUM_FETCH_INS of them when the fetch reaches the
+ * end of the Icache block.
  */
 typedef struct
 {
     bool branch2bTaken;
     u32 linePrediction;
     u32 setPrediction;
+    u32 instrCount;
     u64 retPredStack;
     AXP_INS_FMT instructions[AXP_NUM_FETCH_INS];
     AXP_INS_TYPE instrType[AXP_NUM_FETCH_INS];
     AXP_PC instrPC[AXP_NUM_FETCH_INS];
+    AXP_ICACHE_PREDECODE predecoded[AXP_NUM_FETCH_INS];
 } AXP_INS_LINE;
 
+/*
+ * This structure is the hashed index into either the ITB or DTB.  Each valid
+ * TLB entry is on exactly one hash chain (see AXP_TB_HASH).  The bucket,
+ * asmBucket and next arrays contain the TLB entry index plus 1, so that a
+ * value of zero indicates the end of a chain and a zero initialized structure
+ * is an empty index.  The ghCount and asmGhCount arrays contain the number of
+ * valid entries for each granularity hint, so that a look-up only has to
+ * probe the granularity hints actually in use.
+ */
+typedef struct
+{
+    u8 bucket[AXP_TB_HASH_LEN];
+    u8 asmBucket[AXP_TB_HASH_LEN];
+    u8 next[AXP_TB_LEN];
+    u8 ghCount[AXP_TB_GH_CNT];
+    u8 asmGhCount[AXP_TB_GH_CNT];
+} AXP_21264_TLB_HASH;
+
+/*
+ * This structure is a translated block, used in functional mode.  When a
+ * block of integer instructions, starting at a particular PC, has been
+ * entered AXP_XLATE_HOT times, the decoded instructions are recorded, the
+ * next time they are executed, up to and including the first branch.  From
+ * then on, the block is executed from the decoded instructions, without
+ * fetching from the Icache or decoding.  The chain array contains the block
+ * last executed after this one, when the final branch was not taken (0) and
+ * taken (1), so that we do not need to look it up again.
+ */
+#define AXP_XLATE_BLOCKS    128     /* Must be a power of 2 */
+#define AXP_XLATE_MAX_INS   16
+#define AXP_XLATE_HOT       32
+#define AXP_XLATE_CHAIN_MAX 64
+#define AXP_XLATE_PAGES     256     /* Must be a multiple of 64 */
+#define AXP_XLATE_HASH(pc)                                                  \
+    ((((pc) >> 2) ^ ((pc) >> 9)) & (AXP_XLATE_BLOCKS - 1))
+
+typedef struct AXP_XLATE_BLOCK
+{
+    struct AXP_XLATE_BLOCK *chain[2];
+    u64 pc;
+    u32 asn;
+    u32 count;
+    u32 insCnt;
+    bool valid;
+    bool noop[AXP_XLATE_MAX_INS];
+    AXP_INSTRUCTION ins[AXP_XLATE_MAX_INS];
+} AXP_XLATE_BLOCK;
+
 typedef struct
 {
-    AXP_CQUE_ENTRY header;
     AXP_INSTRUCTION *ins;
     AXP_PIPELINE pipeline;
     u32 index;
-    bool processing;
+
+    /*
+     * The ticket is set when the Ibox queues the entry, and is put onto each
+     * pipeline ring along with the entry.  The pipeline that manages to swap
+     * it to zero owns the entry.  Any other pipeline holding the entry will
+     * find the ticket no longer matches and just drops it.
+     */
+    u32 ticket;
+
+    /*
+     * The bit for this entry in the wakeup matrix, and the number of source
+     * registers it is still waiting on.  Only the Ibox touches these.
+     */
+    u8 wakeBit;
+    u8 waitCnt;
 } AXP_QUEUE_ENTRY;
 
+/*
+ * Per-pipeline ready queue.  The Ibox is the only producer for the ring and
+ * the pipeline is the only consumer.  An entry is only put onto the ring once
+ * all its source registers are valid (or it has been aborted).
+ */
+typedef struct
+{
+    AXP_SPSC_RING ring;
+    AXP_EVENT_COUNT wake;
+    u64 issued;
+    u64 sleeps;
+} AXP_PIPE_QUEUE;
+
+/*
+ * Retirement statistics.  The histogram counts the number of calls to retire
+ * instructions that retired 0, 1, ... AXP_RETIRE_HIST_LEN - 1 (or more)
+ * instructions.  The stall counters count the number of times retirement
+ * stopped, or the Ibox had to wait for it, for each reason.
+ */
+#define AXP_RETIRE_HIST_LEN     9
+
+typedef enum
+{
+    AXP_RETIRE_EMPTY,           /* Nothing left in the ROB to retire */
+    AXP_RETIRE_QUEUED,          /* Oldest instruction not yet issued */
+    AXP_RETIRE_EXECUTING,       /* Oldest instruction still executing */
+    AXP_RETIRE_FAULT,           /* Aborted after an exception */
+    AXP_RETIRE_MISPREDICT,      /* Aborted after a branch misprediction */
+    AXP_RETIRE_ROB_FULL,        /* Ibox waited for room in the ROB */
+    AXP_RETIRE_STALL_INS,       /* Ibox waited for a stalling instruction */
+    AXP_RETIRE_REPLAY,          /* Aborted after a load-store order replay */
+    AXP_RETIRE_STALL_REASONS
+} AXP_RETIRE_STALL;
+
+typedef struct
+{
+    u64 calls;
+    u64 retired;
+    u64 perCall[AXP_RETIRE_HIST_LEN];
+    u64 stalls[AXP_RETIRE_STALL_REASONS];
+} AXP_RETIRE_STATS;
+
+/*
+ * Performance counters.  These are incremented by the CPU threads as they run,
+ * so they are updated with relaxed atomic adds, which never lock.  A snapshot
+ * is therefore only approximately consistent from one counter to the next.
+ * The occupancy of the MAF, VDB and IOWB are sampled when the snapshot is
+ * taken.
+ */
+typedef enum
+{
+    AXP_CNT_IBOX_CYCLES,        /* Ibox main loop iterations */
+    AXP_CNT_IBOX_STALLS,        /* Ibox waits for something to complete */
+    AXP_CNT_DECODED,            /* Instructions decoded into the ROB */
+    AXP_CNT_RETIRED,            /* Instructions retired */
+    AXP_CNT_BRANCHES,           /* Branches retired */
+    AXP_CNT_MISPREDICTS,        /* Branches whose direction was mispredicted */
+    AXP_CNT_RETURNS,            /* Returns (RET and HW_RET) retired */
+    AXP_CNT_RET_MISPREDICTS,    /* Returns whose target was mispredicted */
+    AXP_CNT_JUMPS,              /* Computed jumps (JMP and JSR) retired */
+    AXP_CNT_JMP_MISPREDICTS,    /* Jumps whose target was mispredicted */
+    AXP_CNT_ABORTS,             /* Calls to abort in-flight instructions */
+    AXP_CNT_ABORTED,            /* Instructions aborted */
+    AXP_CNT_ICACHE_FETCHES,     /* Icache fetches */
+    AXP_CNT_ICACHE_MISSES,      /* Icache fetches that missed */
+    AXP_CNT_DCACHE_READS,       /* Dcache block reads */
+    AXP_CNT_DCACHE_READ_MISSES, /* Dcache block reads that missed */
+    AXP_CNT_DCACHE_WRITES,      /* Stores written to the Dcache */
+    AXP_CNT_DCACHE_WRITE_MISSES,/* Stores that missed the Dcache */
+    AXP_CNT_DCACHE_FILLS,       /* Dcache blocks filled by the Cbox */
+    AXP_CNT_ITB_LOOKUPS,        /* ITB lookups */
+    AXP_CNT_ITB_MISSES,         /* ITB lookups that missed */
+    AXP_CNT_DTB_LOOKUPS,        /* DTB lookups */
+    AXP_CNT_DTB_MISSES,         /* DTB lookups that missed */
+    AXP_CNT_MAF_REQUESTS,       /* Requests to add a MAF entry */
+    AXP_CNT_MAF_MERGES,         /* Requests merged into an existing entry */
+    AXP_CNT_MAF_IN_USE,         /* Sum of MAF entries in use at each request */
+    AXP_CNT_LOAD_FORWARDS,      /* Loads with data forwarded from the SQ */
+    AXP_CNT_LOAD_REPLAYS,       /* Loads replayed after reading stale data */
+    AXP_CNT_DIRECT_READS,       /* Memory blocks read without the System */
+    AXP_CNT_DIRECT_WRITES,      /* Victims written without the System */
+    AXP_CNT_MAX
+} AXP_COUNTER;
+
+typedef struct
+{
+    u64 value[AXP_CNT_MAX];
+} AXP_COUNTERS;
+
+typedef struct
+{
+    struct timespec when;       /* CLOCK_MONOTONIC */
+    u64 value[AXP_CNT_MAX];
+    u32 mafInUse;
+    u32 vdbInUse;
+    u32 iowbInUse;
+} AXP_COUNTERS_SNAPSHOT;
+
+#define AXP_COUNT_ADD(cpu, counter, n)                                      \
+    __atomic_fetch_add(&(cpu)->counters.value[(counter)],                   \
+                       (n),                                                 \
+                       __ATOMIC_RELAXED)
+#define AXP_COUNT(cpu, counter) AXP_COUNT_ADD((cpu), (counter), 1)
+
 /*
  * The following states are used during CPU execution.  The state transitions
  * are as follows:
@@ -323,9 +584,11 @@ typedef enum
  */
 typedef struct
 {
-    pthread_mutex_t *mutex;
-    pthread_cond_t *cond;
-    AXP_QUEUE_HDR *rq;
+    AXP_SPSC_RING *rqRing;      /* This CPU's requests to the System        */
+    AXP_EVENT_COUNT *rqEvent;   /* Wakes the System for a new request       */
+    AXP_21264_RQ_ENTRY *rq;     /* AXP_21264_CCHIP_RQ_LEN request entries   */
+    u8 **memMap;        /* Host memory, by AXP_21264_MEM_MAP_SHIFT */
+    bool directMem;     /* No other CPU needs to be probed */
 } AXP_21264_SYSTEM;
 
 /*
@@ -369,17 +632,40 @@ typedef struct
     bool excPend;
     AXP_PC excPC;
 
+    /*
+     * The following definitions are used to determine if the Ibox executes
+     * instructions through the pipeline (Detailed) or in order, one at a time
+     * (Functional).  A change in mode is requested by setting execModeReq and
+     * execModeChange, and takes place once the ROB, IQ, FQ, LQ, and SQ have
+     * drained.  When the retired instruction counter reaches execModeSwitch
+     * (if not 0), a change to the other mode is requested.
+     */
+    AXP_21264_EXEC_MODE execMode;
+    AXP_21264_EXEC_MODE execModeReq;
+    bool execModeChange;
+    u64 execModeSwitch;
+
+    /*
+     * The following definitions are used by the translated block cache for
+     * functional mode.  The xlatePages bits are set for the physical pages
+     * that contain translated instructions, so that a write to one of them
+     * can invalidate the translations.
+     */
+    AXP_XLATE_BLOCK xlate[AXP_XLATE_BLOCKS];
+    AXP_XLATE_BLOCK *xlateRec;
+    u64 xlatePages[AXP_XLATE_PAGES / 64];
+    u64 xlateTranslated;
+    u64 xlateExecuted;
+    u64 xlateFlushes;
+
     /*
      * The following definitions are used by the branch prediction code.
      */
-    LHT localHistoryTable;
-    LPT localPredictor;
-    GPT globalPredictor;
-    CPT choicePredictor;
-    u16 globalPathHistory;
+    AXP_BP_TOURNAMENT branchPredictor;
     u8 instrCounter;                    /* Unique ID for each instruction */
-    AXP_PC predictionStack[AXP_INFLIGHT_MAX];
+    AXP_PC predictionStack[AXP_RET_STACK_SIZE];
     u8 predStackIdx;
+    AXP_JMP_CACHE jumpCache;
 
     /*
      * This is equivalent to the VPC
@@ -395,17 +681,42 @@ typedef struct
     AXP_INSTRUCTION rob[AXP_INFLIGHT_MAX];
     u32 robStart;
     u32 robEnd;
+    AXP_RETIRE_STATS retireStats;
+
+    /*
+     * Performance counters, and the thread that periodically writes them to
+     * a CSV file, when one has been configured.
+     */
+    AXP_COUNTERS counters;
+    pthread_t counterThreadID;
+    u32 counterInterval;        /* Milliseconds between snapshots */
+    bool counterStarted;        /* The counter thread is running */
 
     /*
      * Instruction Queues (Integer and Floating-Point), as well as the IQ
      * scoreboard bits.
      */
     u8 scoreboard;
-    AXP_COUNTED_QUEUE iq;
-    AXP_COUNTED_QUEUE fq;
+    AXP_PIPE_QUEUE pipeQ[AXP_21264_PIPES];
+    u32 xqTicket;
+    u32 iqCount;
+    u32 fqCount;
 
     /*
-     * Instruction Queue Pre-allocated Cache.
+     * Physical register wakeup matrix.  Each physical register has a mask
+     * with a bit for each IQ and FQ entry waiting for it to be written (IQ
+     * entries first, then FQ entries).  xqWaiting has a bit set for every
+     * entry waiting on at least one register.  These are only ever touched by
+     * the Ibox thread, which is also the one writing the physical registers.
+     */
+    u64 prWake[AXP_INT_PHYS_REG];
+    u64 pfWake[AXP_FP_PHYS_REG];
+    u64 xqWaiting;
+
+    /*
+     * Instruction Queue Pre-allocated Cache.  Entries are returned by the
+     * pipeline threads under the eBoxMutex/fBoxMutex, and taken by the Ibox
+     * only when iqCount/fqCount says one is free.
      */
     AXP_QUEUE_ENTRY iqEntries[AXP_IQ_LEN];
     u32 iqEFreelist[AXP_IQ_LEN];
@@ -442,8 +753,15 @@ typedef struct
      * needed to support it.  Each cache block contains 16 instructions, each 4
      * bytes long, for a total of 64 bytes.  There are 2 sets of cache, which
      * leaves us with 64KB / (16 * 4B) / 2 sets = 512 rows for each set.
+     *
+     * The mutex is only locked by writers (fills and flushes).  Readers use
+     * the sequence number in each block to detect that it changed while they
+     * were looking at it, and try again.  The counters are only ever
+     * incremented, one by the Ibox and the other with the mutex locked.
      */
     pthread_mutex_t iCacheMutex;
+    u64 iCacheReadRetries;
+    u64 iCacheWriteWaits;
     AXP_ICACHE_BLK iCache[AXP_CACHE_ENTRIES][AXP_2_WAY_CACHE];
     bool iCacheFlushPending;
     bool stallWaitingRetirement;
@@ -452,10 +770,18 @@ typedef struct
      * This is the Instruction Address Translation (Look-aside) Table (ITB).
      * It is 128 entries in size, and is allocated in a round-robin scheme.
      * We, therefore, maintain a start and end index (both start at 0).
+     * The itbHash is used to locate an entry without searching the entire
+     * array.  The itbMicro is used to avoid going to the ITB at all, for the
+     * most recently translated pages.
      */
     pthread_mutex_t itbMutex;
     AXP_21264_TLB itb[AXP_TB_LEN];
     u32 nextITB;
+    AXP_21264_TLB_HASH itbHash;
+    AXP_21264_MICRO_TLB itbMicro[AXP_MICRO_TLB_ACC]
+                                [AXP_MICRO_TLB_MODES]
+                                [AXP_MICRO_TLB_LEN];
+    u32 itbMicroGen;
 
     /**************************************************************************
      *  Ebox Definitions                                                      *
@@ -482,15 +808,6 @@ typedef struct
     pthread_mutex_t eBoxMutex;
     pthread_cond_t eBoxCondition;
 
-    /*
-     * An optimization for the Ebox is a counter that indicates the number of
-     * instructions in the IQ that could be executed by a particular cluster.
-     * If the counter is zero, there is nothing for that cluster.  Otherwise,
-     * there is at least one instruction that could be executed by the cluster.
-     * These counters are incremented in the Ibox and decremented in the Ebox.
-     */
-    u16 eBoxClusterCounter[AXP_21264_EBOX_CLUSTERS];
-
     /*
      * When the Mbox completes an instruction, it sets this flag and then
      * signal the Ebox conditional variable.
@@ -616,15 +933,6 @@ typedef struct
     pthread_mutex_t fBoxMutex;
     pthread_cond_t fBoxCondition;
 
-    /*
-     * An optimization for the Fbox is a counter that indicates the number of
-     * instructions in the FQ that could be executed by a particular cluster.
-     * If the counter is zero, there is nothing for that cluster.  Otherwise,
-     * there is at least one instruction that could be executed by the cluster.
-     * These counters are incremented in the Ibox and decremented in the Fbox.
-     */
-    u16 fBoxClusterCounter[AXP_21264_FBOX_CLUSTERS];
-
     /*
      * When the Mbox completes an instruction, it sets this flag and then
      * signal the Ebox conditional variable.
@@ -752,9 +1060,17 @@ typedef struct
     pthread_mutex_t sqMutex;
     AXP_MBOX_QUEUE sq[AXP_MBOX_QUEUE_LEN];
     u32 sqNext;
+    u32 lqWork[AXP_MBOX_WORK_MAX];	/* protected by mBoxMutex */
+    u32 sqWork[AXP_MBOX_WORK_MAX];
+    u32 sqIndex[AXP_MBOX_SQ_HASH_LEN];	/* protected by mBoxMutex */
     pthread_mutex_t dtbMutex;
     AXP_21264_TLB dtb[AXP_TB_LEN];
     u32 nextDTB;
+    AXP_21264_TLB_HASH dtbHash;
+    AXP_21264_MICRO_TLB dtbMicro[AXP_MICRO_TLB_ACC]
+                                [AXP_MICRO_TLB_MODES]
+                                [AXP_MICRO_TLB_LEN];
+    u32 dtbMicroGen;
 
     /*
      * The following is used to detect when we have a TB Miss while processing
@@ -894,5 +1210,8 @@ typedef struct
  * Function Prototypes.
  */
 void *AXP_21264_AllocateCPU(u64);
+void AXP_21264_Counters_Snapshot(AXP_21264_CPU *, AXP_COUNTERS_SNAPSHOT *);
+bool AXP_21264_Counters_Start(AXP_21264_CPU *, u64);
+void AXP_21264_Counters_Stop(AXP_21264_CPU *);
 
 #endif /* _AXP_21264_CPU_DEFS_ */
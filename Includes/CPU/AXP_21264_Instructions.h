@@ -42,6 +42,10 @@
  *	Changed the LEN_STALL flag used for the HW_LD/ST and HW_RET instructions
  *	into two separate flags.  One to indicate a quadword len, and the other to
  *	indicate a stall in the Ibox.
+ *
+ *	V01.006		16-Oct-2026	Jonathan D. Belanger
+ *	Added the kind of branch, the predicted target, and the state of the
+ *	return stack before it was fetched, to the decoded instruction.
  */
 #ifndef _AXP_21264_INS_DEFS_
 #define _AXP_21264_INS_DEFS_
@@ -77,6 +81,17 @@ typedef struct
 #define	AXP_JMP_TYPE(disp)	(((disp) & 0xc000) >> 14)
 #define AXP_JMP_HINT(disp)	((disp) & 0x3fff)
 
+/*
+ * The kinds of branch the Ibox predicts, which determine how the target is
+ * predicted and what is done to the return stack.
+ */
+#define AXP_BRANCH_NONE		0	/* Not a branch */
+#define AXP_BRANCH_COND		1	/* Conditional, direction predicted */
+#define AXP_BRANCH_UNCOND	2	/* BR and BSR, always taken */
+#define AXP_BRANCH_JUMP		3	/* JMP and JSR, target in jump cache */
+#define AXP_BRANCH_RETURN	4	/* RET and JSR_COROUTINE, target popped */
+#define AXP_BRANCH_PAL		5	/* CALL_PAL, not predicted */
+
 /*
  * Branch Instruction Format
  */
@@ -339,7 +354,7 @@ typedef enum
 #define FBEQ	0x31	/* Bra (FP) */
 #define FBLT	0x32	/* Bra (FP) */
 #define FBLE	0x33	/* Bra (FP) */
-#define BSR		0x34	/* Mbr */
+#define BSR		0x34	/* Bra */
 #define FBNE	0x35	/* Bra (FP) */
 #define FBGE	0x36	/* Bra (FP) */
 #define FBGT	0x37	/* Bra (FP) */
@@ -1073,6 +1088,10 @@ typedef struct
     bool globalPredict; /* Global branch predict */
     bool stall; /* Stall Ibox until IQ/FQ are empty */
     bool quadword; /* HW_LD/ST len */
+    u8 branchKind; /* AXP_BRANCH_xxx */
+    u8 predStackIdx; /* Return stack index before this was fetched */
+    AXP_PC predStackTop; /* Return stack top before this was fetched */
+    AXP_PC predictedPC; /* Predicted target of a taken branch */
 } AXP_INSTRUCTION;
 
 #endif /* _AXP_21264_INS_DEFS_ */
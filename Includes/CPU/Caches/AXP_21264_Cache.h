@@ -23,6 +23,9 @@
  *
  *	V01.000		29-Jul-2017	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Added AXP_va2paSuperPage.
  */
 #ifndef _AXP_21264_CACHE_DEFS_
 #define _AXP_21264_CACHE_DEFS_
@@ -44,6 +47,7 @@ AXP_EXCEPTIONS AXP_21264_checkMemoryAccess(
     AXP_21264_CPU *,
     AXP_21264_TLB *,
     AXP_21264_ACCESS);
+bool AXP_va2paSuperPage(AXP_21264_CPU *, u64, bool, u64 *);
 u64 AXP_va2pa(
     AXP_21264_CPU *,
     u64,
@@ -23,12 +23,30 @@
  *
  *  V01.000 29-Jul-2017 Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001 15-Oct-2026 Jonathan D. Belanger
+ *  Added the definitions for a hashed index into the ITB and DTB, so that a
+ *  TLB look-up no longer has to scan all 128 entries.
+ *
+ *  V01.002 15-Oct-2026 Jonathan D. Belanger
+ *  Added the definitions for the micro-TLB that sits in front of the ITB and
+ *  DTB.
+ *
+ *  V01.003 15-Oct-2026 Jonathan D. Belanger
+ *  Added a predecoded version of each instruction to the Icache block, so
+ *  that the Ibox only has to decode an instruction once per Icache fill.
+ *
+ *  V01.004 15-Oct-2026 Jonathan D. Belanger
+ *  Added a sequence number to the Icache block, so that it can be read
+ *  without locking the Icache mutex.
  */
 #ifndef _AXP_21264_CACHE_DEFS_DEFS_
 #define _AXP_21264_CACHE_DEFS_DEFS_
 
 #include "CommonUtilities/AXP_Utility.h"
 #include "CPU/AXP_21264_CPU.h"
+#include "CPU/AXP_21264_Instructions.h"
+#include "CPU/Ibox/AXP_21264_RegisterRenaming.h"
 
 /*
  * The following definitions utilize the granularity hint information in the
@@ -64,8 +82,48 @@ typedef struct
     u8 asn;
     bool _asm;
     bool valid;
+    u8 gh;
 } AXP_21264_TLB;
 
+/*
+ * The following definitions are used to maintain a hashed index into the ITB
+ * and DTB (see AXP_21264_TLB_HASH).  Entries that do not have the ASM bit set
+ * are hashed on the VPN (masked for the granularity hint of the entry) and the
+ * ASN.  Entries that have the ASM bit set match any ASN, so they are hashed on
+ * the masked VPN only and kept on their own set of chains.
+ */
+#define AXP_TB_HASH_LEN     256
+#define AXP_TB_GH_CNT       4
+#define AXP_TB_HASH(va, asn)                                                \
+    ((u32) ((((((va) >> 13) ^ ((u64) (asn) << 51)) *                        \
+              0x9e3779b97f4a7c15ll) >> 56) & (AXP_TB_HASH_LEN - 1)))
+
+/*
+ * Define the micro-TLB.  This is a small, direct-mapped, cache of the last
+ * successful translations of an 8KB page, one set for each access type and
+ * processor mode.  Since the access check has already been done for the
+ * access type and mode, a hit can return the physical address without going
+ * to the ITB/DTB.  The tag is the page address with the low bit set, so that
+ * a zero initialized entry never matches.  An entry is only valid if its
+ * generation matches the current generation for the ITB/DTB, which is
+ * incremented whenever a TLB entry is invalidated or replaced.
+ */
+#define AXP_MICRO_TLB_LEN       16
+#define AXP_MICRO_TLB_ACC       (Modify + 1)
+#define AXP_MICRO_TLB_MODES     4
+#define AXP_MICRO_TLB_IDX(va)                                               \
+    (((va) >> 13) & (AXP_MICRO_TLB_LEN - 1))
+#define AXP_MICRO_TLB_TAG(va)   (((va) & ~(AXP_21264_PAGE_SIZE - 1)) | 1)
+
+typedef struct
+{
+    u64 tag;
+    u64 physAddr;
+    u32 gen;
+    u8 asn;
+    bool _asm;
+} AXP_21264_MICRO_TLB;
+
 #define AXP_CM_KERNEL       0
 #define AXP_CM_EXEC         1
 #define AXP_CM_SUPER        2
@@ -324,6 +382,52 @@ typedef struct
 #define AXP_ICACHE_LINE_INS        16
 #define AXP_ICACHE_BUF_LEN        64
 
+/*
+ * The following definitions indicate which Mbox queue, if any, an instruction
+ * needs to have a slot allocated in before it can be queued for execution.
+ */
+#define AXP_PREDECODE_NO_SLOT   0
+#define AXP_PREDECODE_LQ_SLOT   1
+#define AXP_PREDECODE_SQ_SLOT   2
+
+/*
+ * This structure contains everything that can be determined about an
+ * instruction from the instruction bits alone.  It is filled in when the Icache
+ * block is filled and then reused on every fetch of the instruction, until the
+ * Icache block is either refilled or flushed.  The
+ * only thing that needs to be done when the instruction is fetched again is
+ * the PALshadow register mapping and register renaming, both of which depend
+ * upon the current state of the CPU.
+ */
+typedef struct
+{
+    AXP_INS_FMT instr;      /* Instruction that was predecoded */
+    AXP_INS_TYPE format;    /* Instruction format */
+    AXP_OPER_TYPE type;     /* Operation type */
+    AXP_PIPELINE pipeline;  /* Pipelines the instruction can execute in */
+    AXP_REG_DECODE decodedReg; /* which registers are used for what */
+    i64 displacement;       /* Displacement from PC + 4 */
+    u64 literal;            /* Literal value */
+    u32 function;           /* Function code for operation */
+    u16 aSrc1;              /* Architectural register R0-R30 or F0-F30 */
+    u16 aSrc2;              /* Architectural register R0-R30 or F0-F30 */
+    u16 aDest;              /* Architectural register R0-R30 or F0-F30 */
+    u8 opcode;              /* Operation code */
+    u8 type_hint_index;     /* HW_LD/ST type, HW_RET hint, HW_MxPR idx */
+    u8 scbdMask;            /* HW_MxPR scbd_mask */
+    u8 whichQueue;          /* AXP_IQ or AXP_FQ */
+    u8 slot;                /* AXP_PREDECODE_xx_SLOT */
+    bool src1Float;         /* Source 1 is a floating-point register */
+    bool src2Float;         /* Source 2 is a floating-point register */
+    bool destFloat;         /* Destination is a floating-point register */
+    bool callingPAL;        /* CALL_PAL instruction */
+    bool useLiteral;        /* Indicator that the literal value is valid */
+    bool stall;             /* Stall Ibox until IQ/FQ are empty */
+    bool quadword;          /* HW_LD/ST len */
+    bool noop;              /* Completed without being queued */
+    bool valid;             /* The above fields are valid */
+} AXP_ICACHE_PREDECODE;
+
 /*
  * This structure is the definition of one instruction cache block.  A block
  * contains the following:
@@ -342,6 +446,10 @@ typedef struct
  *          user
  *      Additional predecoded information to assist with instruction
  *      processing and fetch control
+ *
+ * The sequence number is not part of the 21264.  It is odd while the block is
+ * being written, and is incremented again when the write is complete.  A
+ * reader that sees it odd, or sees it change, has to read the block again.
  */
 typedef struct
 {
@@ -356,7 +464,9 @@ typedef struct
     u64 tag :33;    /* Tag */
     u64 set_0_1 :1; /* When set 0 was last used */
     u64 res_1 :15;  /* align to the 64-bit boundary */
+    u32 seq;        /* Sequence number (odd while being written) */
     AXP_INS_FMT instructions[AXP_ICACHE_LINE_INS];
+    AXP_ICACHE_PREDECODE predecoded[AXP_ICACHE_LINE_INS];
 } AXP_ICACHE_BLK;
 
 /*
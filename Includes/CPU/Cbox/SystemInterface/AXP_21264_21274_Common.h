@@ -34,6 +34,14 @@
  *
  *	V01.000		31-Mar-2018	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Added the memory map, used to find the host memory for a physical memory
+ *	address.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	Each CPU now has its own request entries, which it hands to the System
+ *	on its own request ring, rather than on a queue shared by all the CPUs.
  */
 #ifndef _AXP_21264_21274_COMMON_H_
 #define _AXP_21264_21274_COMMON_H_
@@ -47,6 +55,16 @@
  */
 #define AXP_21264_DATA_SIZE	8
 
+/*
+ * The System keeps a map of the host memory for the memory arrays, with one
+ * entry for each 64MB of physical memory, up to 32GB.  An entry is NULL when
+ * there is no memory at that address.  The CPU uses the map to read and write
+ * memory blocks directly, when no other CPU needs to be probed.
+ */
+#define AXP_21264_MEM_MAP_SHIFT	26
+#define AXP_21264_MEM_MAP_LEN	512
+#define AXP_21264_MEM_MAP_MASK	((1ll << AXP_21264_MEM_MAP_SHIFT) - 1)
+
 /*
  * The following data structure will be used to send Probe Requests and sysDc
  * responses, with or without the Probe Request, with or without data from the
@@ -146,6 +164,11 @@ typedef struct
  *	  after a previous request without waiting for RAS precharge delay
  *	- Older request vector - A bit vector identifying all older requests in
  *	  this queue (used to arbitrate among otherwise equal ready requests)
+ *
+ * The entries for each CPU belong to that CPU.  The CPU fills in an entry that
+ * is not in use, marks it in use, and puts it onto its request ring.  The
+ * System marks the entry no longer in use once it is done with it, before the
+ * response is sent back to the CPU.
  */
 typedef struct
 {
@@ -163,7 +186,7 @@ typedef struct
     bool miss2;
     bool rqValid;
     bool cacheHit;
-    bool valid;
+    bool inUse;
 } AXP_21264_RQ_ENTRY;
 
 #define AXP_21264_CCHIP_RQ_LEN	6	/* Per CPU */
@@ -23,11 +23,15 @@
  *
  *	V01.000		01-Jun-2018	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Added the function to find a memory block in host memory.
  */
 #ifndef _AXP_21264_TO_SYSTEM_H_
 #define _AXP_21264_TO_SYSTEM_H_
 
 void AXP_21264_SendToSystem(AXP_21264_CPU *, AXP_21264_SYSBUS_System *);
+u8 *AXP_21264_DirectMem(AXP_21264_CPU *, u64, int);
 
 
 #endif /* _AXP_21264_TO_SYSTEM_H_ */
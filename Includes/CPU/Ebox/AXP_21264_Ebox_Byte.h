@@ -23,6 +23,9 @@
  *
  *	V01.000		24-Jun-2017	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Included the byte and multimedia kernels.
  */
 #ifndef _AXP_21264_EBOX_BYTE_DEFS_
 #define _AXP_21264_EBOX_BYTE_DEFS_
@@ -31,6 +34,7 @@
 #include "CPU/AXP_Base_CPU.h"
 #include "CPU/AXP_21264_Instructions.h"
 #include "CPU/AXP_21264_CPU.h"
+#include "CPU/Ebox/AXP_21264_Ebox_SIMD.h"
 #include "CPU/Mbox/AXP_21264_Mbox.h"
 
 #endif /* _AXP_21264_EBOX_BYTE_DEFS_ */
@@ -23,6 +23,9 @@
  *
  *	V01.000		19-Jul-2017	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Included the byte and multimedia kernels.
  */
 #ifndef _AXP_21264_EBOX_MEDIA_DEFS_
 #define _AXP_21264_EBOX_MEDIA_DEFS_
@@ -30,6 +33,7 @@
 #include "CommonUtilities/AXP_Utility.h"
 #include "CPU/AXP_Base_CPU.h"
 #include "CPU/AXP_21264_CPU.h"
+#include "CPU/Ebox/AXP_21264_Ebox_SIMD.h"
 #include "CPU/Ibox/AXP_21264_Ibox.h"
 
 #endif /* _AXP_21264_EBOX_MEDIA_DEFS_ */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *	This header file contains the definitions needed by its source
+ *	companion, which performs the byte and multimedia operations on all the
+ *	bytes or words of a register at once.
+ *
+ * Revision History:
+ *
+ *	V01.000		16-Oct-2026	Jonathan D. Belanger
+ *	Initially written.
+ */
+#ifndef _AXP_21264_EBOX_SIMD_DEFS_
+#define _AXP_21264_EBOX_SIMD_DEFS_
+
+#include "CommonUtilities/AXP_Utility.h"
+
+/*
+ * The instruction sets there are kernels for.  SWAR (SIMD within a register)
+ * uses only 64-bit integer arithmetic, so is always available.
+ */
+typedef enum
+{
+    AXP_SIMD_SWAR,
+    AXP_SIMD_SSE2,
+    AXP_SIMD_SSSE3,
+    AXP_SIMD_ISA_COUNT
+} AXP_SIMD_ISA;
+
+/*
+ * A set of kernels.  Each one takes the register values and returns the
+ * result, as the instruction of the same name defines it.  zapMask returns
+ * the mask of the bytes selected by the low 8 bits of its argument, which is
+ * what ZAPNOT keeps and ZAP clears.
+ */
+typedef struct
+{
+    const char *name;
+    u64 (*cmpbge)(u64, u64);
+    u64 (*zapMask)(u64);
+    u64 (*minub8)(u64, u64);
+    u64 (*minsb8)(u64, u64);
+    u64 (*minuw4)(u64, u64);
+    u64 (*minsw4)(u64, u64);
+    u64 (*maxub8)(u64, u64);
+    u64 (*maxsb8)(u64, u64);
+    u64 (*maxuw4)(u64, u64);
+    u64 (*maxsw4)(u64, u64);
+    u64 (*perr)(u64, u64);
+    u64 (*pklb)(u64);
+    u64 (*pkwb)(u64);
+    u64 (*unpkbl)(u64);
+    u64 (*unpkbw)(u64);
+} AXP_SIMD_KERNELS;
+
+/*
+ * The kernels for the best instruction set the host has.  Until
+ * AXP_SIMD_Init is called, these are the SWAR ones.
+ */
+extern AXP_SIMD_KERNELS AXP_SIMD_Active;
+
+/*
+ * Function Prototypes
+ */
+void AXP_SIMD_Init(void);
+const AXP_SIMD_KERNELS *AXP_SIMD_Kernels(AXP_SIMD_ISA);
+
+#endif /* _AXP_21264_EBOX_SIMD_DEFS_ */
@@ -24,6 +24,22 @@
  *
  *	V01.000		29-June-2017	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026		Jonathan D. Belanger
+ *	Added the function to put the host in the rounding mode for an IEEE
+ *	instruction.
+ *
+ *	V01.002		16-Oct-2026		Jonathan D. Belanger
+ *	Added the functions to perform an instruction with the integer-only
+ *	floating-point operations, and to determine when an IEEE instruction
+ *	needs them.
+ *
+ *	V01.003		16-Oct-2026		Jonathan D. Belanger
+ *	Added the function to determine when an IEEE instruction needs to be
+ *	performed again with integer arithmetic.
+ *
+ *	V01.004		16-Oct-2026		Jonathan D. Belanger
+ *	Removed AXP_FP_SetRoundingMode and AXP_FP_SetExceptionMode.
  */
 #ifndef _AXP_21264_FBOX_FPFUNCTIONS_DEFS_
 #define _AXP_21264_FBOX_FPFUNCTIONS_DEFS_
@@ -31,13 +47,16 @@
 #include "CommonUtilities/AXP_Utility.h"
 #include "CPU/AXP_21264_Instructions.h"
 #include "CPU/Fbox/AXP_21264_Fbox.h"
+#include "CPU/Fbox/AXP_21264_Fbox_SoftFloat.h"
 
 float AXP_FP_CvtFPRToFloat(AXP_FP_REGISTER);
 AXP_FP_REGISTER AXP_FP_CvtFloatToFPR(float);
-int AXP_FP_SetRoundingMode(AXP_21264_CPU *, AXP_FP_FUNC *, int);
-int AXP_FP_SetExceptionMode(AXP_21264_CPU *, int);
+void AXP_FP_EnterIEEE(AXP_21264_CPU *, AXP_FP_FUNC *);
 void AXP_FP_SetFPCR(AXP_21264_CPU *, AXP_INSTRUCTION *, int, bool);
 void AXP_FP_SetExcSum(AXP_INSTRUCTION *, int, bool);
+AXP_EXCEPTIONS AXP_FP_SoftOperate(AXP_21264_CPU *, AXP_INSTRUCTION *);
+bool AXP_FP_SoftFloatNeeded(AXP_21264_CPU *, AXP_INSTRUCTION *);
+bool AXP_FP_SoftFloatRedo(AXP_21264_CPU *, AXP_INSTRUCTION *);
 bool AXP_FP_CheckForVAXInvalid(AXP_FPR_REGISTER *, AXP_FPR_REGISTER *);
 bool AXP_FP_CheckForIEEEInvalid(AXP_FP_REGISTER *, AXP_FP_REGISTER *);
 void AXP_FP_CvtG2X(
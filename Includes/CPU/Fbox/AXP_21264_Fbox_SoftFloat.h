@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This header file contains the definitions needed by its source companion,
+ *  which performs the VAX F, G, and D and IEEE S and T floating-point
+ *  operations with integer arithmetic only.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped the AXP_SF_Batch prototype to fit in 80 columns.
+ */
+#ifndef _AXP_21264_FBOX_SOFTFLOAT_DEFS_
+#define _AXP_21264_FBOX_SOFTFLOAT_DEFS_
+
+#include "CommonUtilities/AXP_Utility.h"
+#include "CPU/Fbox/AXP_21264_Fbox.h"
+
+/*
+ * The register formats operated upon.  Q is the quadword integer format, used
+ * by the conversions to and from an integer.
+ */
+typedef enum
+{
+    AXP_SF_F,
+    AXP_SF_G,
+    AXP_SF_D,
+    AXP_SF_S,
+    AXP_SF_T,
+    AXP_SF_Q
+} AXP_SF_FORMAT;
+
+/*
+ * The operations performed.
+ */
+typedef enum
+{
+    AXP_SF_Add,
+    AXP_SF_Sub,
+    AXP_SF_Mul,
+    AXP_SF_Div,
+    AXP_SF_Sqrt,
+    AXP_SF_Cvt,
+    AXP_SF_CmpUN,
+    AXP_SF_CmpEQ,
+    AXP_SF_CmpLT,
+    AXP_SF_CmpLE
+} AXP_SF_OPER;
+
+/*
+ * The exceptions an operation can raise.  These are in the same order as the
+ * exception bits in the FPCR, starting with the invalid operation bit.
+ */
+#define AXP_SF_INV      0x01
+#define AXP_SF_DZE      0x02
+#define AXP_SF_OVF      0x04
+#define AXP_SF_UNF      0x08
+#define AXP_SF_INE      0x10
+#define AXP_SF_IOV      0x20
+
+/*
+ * An operation, decoded from an instruction's opcode and function fields and
+ * the FPCR.  The rounding mode is never dynamic, it has already been taken
+ * from the FPCR, so a value of 3 is plus infinity.  The disabled field has
+ * the exceptions that the FPCR disables, when the instruction has the /S
+ * qualifier.
+ */
+typedef struct
+{
+    AXP_SF_OPER oper;
+    AXP_SF_FORMAT src;
+    AXP_SF_FORMAT dest;
+    u32 rnd;
+    u32 trp;
+    u32 disabled;
+    bool vax;
+    bool dnz;
+    bool undz;
+} AXP_SF_OPERATION;
+
+/*
+ * Function Prototypes
+ */
+bool AXP_SF_Decode(u32, u32, AXP_FBOX_FPCR *, AXP_SF_OPERATION *);
+u64 AXP_SF_Execute(AXP_SF_OPERATION *, u64, u64, u32 *);
+u32 AXP_SF_Traps(AXP_SF_OPERATION *, u32);
+void AXP_SF_Batch(
+    AXP_SF_OPERATION *,
+    const u64 *,
+    const u64 *,
+    u64 *,
+    u32 *,
+    u32);
+
+#endif /* _AXP_21264_FBOX_SOFTFLOAT_DEFS_ */
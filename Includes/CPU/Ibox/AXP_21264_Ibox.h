@@ -26,6 +26,29 @@
  *
  *	V01.001		01-Jun-2017	Jonathan D. Belanger
  *	Added a function prototype to add an Icache line/block.
+ *
+ *	V01.002		15-Oct-2026	Jonathan D. Belanger
+ *	Added the prototypes for the HW_MFPR and HW_MTPR retirement functions,
+ *	so that they can be called by the functional execution mode.
+ *
+ *	V01.003		15-Oct-2026	Jonathan D. Belanger
+ *	Added the prototype to get a copy of the retirement statistics.
+ *
+ *	V01.004		16-Oct-2026	Jonathan D. Belanger
+ *	Added the prototypes for the tournament predictor, on its own tables,
+ *	and to get the branch prediction models.
+ *
+ *	V01.005		16-Oct-2026	Jonathan D. Belanger
+ *	Added the prototypes to predict and resolve the targets of branches, and
+ *	to recover the return stack.
+ *
+ *	V01.006		16-Oct-2026	Jonathan D. Belanger
+ *	Added the prototypes to signal the Ibox that an instruction has
+ *	completed, and to wait for room in the ROB.
+ *
+ *	V01.007		16-Oct-2026	Jonathan D. Belanger
+ *	Added the prototype to change the execution mode once the ROB, IQ, FQ,
+ *	LQ, and SQ have drained.
  */
 #ifndef _AXP_21264_IBOX_DEFS_
 #define _AXP_21264_IBOX_DEFS_
@@ -58,11 +81,34 @@ void AXP_Branch_Direction(
     bool taken,
     bool localTaken,
     bool globalTaken);
+bool AXP_BP_TournamentPredict(
+    AXP_BP_TOURNAMENT *bp,
+    u64 pc,
+    bool useGlobal,
+    bool *localTaken,
+    bool *globalTaken,
+    bool *choice);
+void AXP_BP_TournamentUpdate(
+    AXP_BP_TOURNAMENT *bp,
+    u64 pc,
+    bool taken,
+    bool localTaken,
+    bool globalTaken);
+const AXP_BP_MODEL *AXP_BP_Model(u32);
+bool AXP_Branch_Target(AXP_21264_CPU *, AXP_INSTRUCTION *);
+bool AXP_Branch_Resolve(AXP_21264_CPU *, AXP_INSTRUCTION *);
+void AXP_Branch_Recover(AXP_21264_CPU *, AXP_INSTRUCTION *, bool);
 void AXP_ReturnIQEntry(AXP_21264_CPU *, AXP_QUEUE_ENTRY *);
 void AXP_ReturnFQEntry(AXP_21264_CPU *, AXP_QUEUE_ENTRY *);
 void AXP_21264_Ibox_Event(AXP_21264_CPU *, u32, AXP_PC, u64, u8, u8, bool, bool);
 void AXP_21264_Ibox_UpdateIcache(AXP_21264_CPU *, u64, u8 *, bool);
 bool AXP_21264_Ibox_Retire(AXP_21264_CPU *);
+void AXP_21264_Ibox_Completed(AXP_21264_CPU *);
+bool AXP_21264_Ibox_WaitForROB(AXP_21264_CPU *);
+bool AXP_21264_Ibox_ExecModeChange(AXP_21264_CPU *);
+void AXP_21264_Ibox_RetireStats(AXP_21264_CPU *, AXP_RETIRE_STATS *);
+void AXP_21264_Ibox_Retire_HW_MFPR(AXP_21264_CPU *, AXP_INSTRUCTION *);
+void AXP_21264_Ibox_Retire_HW_MTPR(AXP_21264_CPU *, AXP_INSTRUCTION *);
 void *AXP_21264_IboxMain(void *);
 
 #endif /* _AXP_21264_IBOX_DEFS_ */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *	This header file contains the function prototypes for the functional
+ *	(in-order, non-pipelined) execution mode of the Ibox.
+ *
+ * Revision History:
+ *
+ *	V01.000		15-Oct-2026	Jonathan D. Belanger
+ *	Initially written.
+ *
+ *	V01.001		15-Oct-2026	Jonathan D. Belanger
+ *	Exported the register and retirement functions for the translated block
+ *	cache.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	Removed AXP_21264_Ibox_SetExecMode.
+ *
+ *	V01.003		16-Oct-2026	Jonathan D. Belanger
+ *	Restored AXP_21264_Ibox_SetExecMode, and added
+ *	AXP_21264_Ibox_ExecModeCheck.
+ */
+#ifndef _AXP_IBOX_FUNCTIONAL_DEFS_
+#define _AXP_IBOX_FUNCTIONAL_DEFS_		1
+
+void AXP_21264_Ibox_Functional(AXP_21264_CPU *, AXP_INS_LINE *);
+void AXP_21264_Ibox_FunctionalRegs(AXP_21264_CPU *, AXP_INSTRUCTION *);
+bool AXP_21264_Ibox_FunctionalRetire(AXP_21264_CPU *, AXP_INSTRUCTION *);
+bool AXP_21264_Ibox_ExecModeCheck(AXP_21264_CPU *);
+void AXP_21264_Ibox_SetExecMode(AXP_21264_CPU *, AXP_21264_EXEC_MODE);
+
+#endif	/* _AXP_IBOX_FUNCTIONAL_DEFS_ */
@@ -30,6 +30,14 @@
  *	Ebox, and Fbox did.  So, it is better located at the queue entry that goes
  *	on the IQ or FQ.  This also simplifies the mutex locking and avoids both
  *	potential deadlocks and multiple threads trying to execute an instruction.
+ *
+ *	V01.002		15-Oct-2026	Jonathan D. Belanger
+ *	Added AXP_Predecode, which is called by the Icache to predecode
+ *	instructions once per Icache fill.
+ *
+ *	V01.003		15-Oct-2026	Jonathan D. Belanger
+ *	Added AXP_Decode, which decodes an instruction without renaming its
+ *	registers.
  */
 #ifndef _AXP_IBOX_INS_DECODE_DEFS_
 #define _AXP_IBOX_INS_DECODE_DEFS_	1
@@ -38,6 +46,13 @@
 #define AXP_SIGNAL_EBOX	1
 #define AXP_SIGNAL_FBOX	2
 
+void AXP_Predecode(AXP_INS_FMT, AXP_ICACHE_PREDECODE *);
+void AXP_Decode(
+    AXP_21264_CPU *,
+    AXP_INS_LINE *,
+    int,
+    AXP_INSTRUCTION *,
+    AXP_PIPELINE *);
 void AXP_Decode_Rename(
     AXP_21264_CPU *,
     AXP_INS_LINE *,
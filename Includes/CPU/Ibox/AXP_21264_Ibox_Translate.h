@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *	This header file contains the function prototypes for the translated
+ *	block cache used by the functional execution mode of the Ibox.
+ *
+ * Revision History:
+ *
+ *	V01.000		15-Oct-2026	Jonathan D. Belanger
+ *	Initially written.
+ */
+#ifndef _AXP_IBOX_TRANSLATE_DEFS_
+#define _AXP_IBOX_TRANSLATE_DEFS_		1
+
+bool AXP_21264_Xlate_Execute(AXP_21264_CPU *, AXP_PC);
+void AXP_21264_Xlate_Record(
+    AXP_21264_CPU *,
+    AXP_INSTRUCTION *,
+    AXP_ICACHE_PREDECODE *);
+void AXP_21264_Xlate_Flush(AXP_21264_CPU *);
+void AXP_21264_Xlate_CodeWrite(AXP_21264_CPU *, u64);
+
+#endif	/* _AXP_IBOX_TRANSLATE_DEFS_ */
@@ -38,6 +38,15 @@
  *  using just bit math.  This is to avoid branch mispredict in the system on
  *  which the branch prediction emulation code is running.
  *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  The 2- and 3-bit saturating counters were predicting taken from their low
+ *  bit, rather than their high one.  The local history table entries are now
+ *  large enough to hold 10 bits of history.  Gathered the tournament
+ *  predictor's tables together, and added the interface to a branch
+ *  prediction model, so that others can be compared against it.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Added the size of the return stack, and the jump target cache.
  */
 #ifndef _AXP_21264_PRED_DEFS_
 #define _AXP_21264_PRED_DEFS_
@@ -130,7 +139,7 @@ typedef struct
  */
 typedef struct
 {
-    AXP_3BIT_SAT_CNT lcl_history[ONE_K];
+    u16 lcl_history[ONE_K];
 } LHT;
 typedef struct
 {
@@ -170,7 +179,7 @@ typedef struct
         cntr.a = tmp.a & tmp.b;                                             \
         cntr.b = tmp.a & (!tmp.b);                                          \
     }
-#define AXP_2BIT_TAKE(cntr) cntr.b
+#define AXP_2BIT_TAKE(cntr) cntr.a
 
 /*
  * Macros for incrementing, decrementing, and determining whether to predict
@@ -199,7 +208,7 @@ typedef struct
         cntr.b = tmp.b & tmp.c;                                             \
         cntr.c = tmp.b & (!tmp.c);                                          \
     }
-#define AXP_3BIT_TAKE(cntr) cntr.c
+#define AXP_3BIT_TAKE(cntr) cntr.a
 
 /*
  * The following macros are to maintain the Local History Table and the Global
@@ -210,4 +219,69 @@ typedef struct
 #define AXP_GLOBAL_PATH_TAKEN(gph)      (gph) = (((gph) * 2) + 1) & AXP_MASK_12_BITS
 #define AXP_GLOBAL_PATH_NOT_TAKEN(gph)  (gph) = ((gph) * 2) & AXP_MASK_12_BITS
 
+/*
+ * The tables of the 21264's tournament predictor.  The local history table is
+ * indexed by bits 2-11 of the VPC, and the global path history indexes the
+ * global and choice predictor tables.
+ */
+typedef struct
+{
+    LHT localHistoryTable;
+    LPT localPredictor;
+    GPT globalPredictor;
+    CPT choicePredictor;
+    u16 globalPathHistory;
+} AXP_BP_TOURNAMENT;
+
+/*
+ * A branch prediction model.  The state of the model is size bytes long, and
+ * is all zeros when the model has seen no branches.  The bits are the amount
+ * of storage the model would need in hardware.
+ *
+ * The predict function returns the prediction for the branch at a PC (the
+ * pc field of the VPC), and a tag, which is handed back to the update
+ * function when the branch retires, along with whether it was actually taken.
+ * Branches are retired in the order they are predicted.
+ */
+typedef struct
+{
+    const char *name;
+    size_t size;
+    u32 bits;
+    bool (*predict)(void *, u64, u32 *);
+    void (*update)(void *, u64, bool, u32);
+} AXP_BP_MODEL;
+
+/*
+ * The return stack holds the return addresses of the subroutines called by
+ * instructions that have been fetched.  It is circular, so when calls are
+ * nested deeper than it can hold, the oldest return addresses are lost, rather
+ * than the newest ones.
+ */
+#define AXP_RET_STACK_SIZE      32
+#define AXP_RET_STACK_MASK      (AXP_RET_STACK_SIZE - 1)
+
+/*
+ * The jump target cache holds the last target of each computed jump (JMP,
+ * JSR, and HW_RET without a return hint).  It is direct mapped, and indexed
+ * by the low bits of the PC of the jump XORed with the next higher ones.
+ */
+#define AXP_JMP_CACHE_BITS      9
+#define AXP_JMP_CACHE_SIZE      (1 << AXP_JMP_CACHE_BITS)
+#define AXP_JMP_CACHE_MASK      (AXP_JMP_CACHE_SIZE - 1)
+#define AXP_JMP_CACHE_INDEX(pc)                                             \
+    (((pc) ^ ((pc) >> AXP_JMP_CACHE_BITS)) & AXP_JMP_CACHE_MASK)
+
+typedef struct
+{
+    AXP_PC pc;
+    AXP_PC target;
+    bool valid;
+} AXP_JMP_CACHE_ENTRY;
+
+typedef struct
+{
+    AXP_JMP_CACHE_ENTRY entry[AXP_JMP_CACHE_SIZE];
+} AXP_JMP_CACHE;
+
 #endif /* _AXP_21264_PRED_DEFS_ */
@@ -23,6 +23,18 @@
  *
  *	V01.000		19-Jun-2017	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	The instruction is supplied when getting an LQ or SQ slot.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	Added AXP_21264_Mbox_RetireRead.
+ *
+ *	V01.003		16-Oct-2026	Jonathan D. Belanger
+ *	Added AXP_21264_Mbox_SlotAvailable.
+ *
+ *	V01.004		16-Oct-2026	Jonathan D. Belanger
+ *	Added AXP_21264_Mbox_QueuesEmpty.
  */
 #ifndef _AXP_21264_MBOX_DEFS_
 #define _AXP_21264_MBOX_DEFS_
@@ -30,10 +42,12 @@
 #include "CommonUtilities/AXP_Utility.h"
 #include "CPU/AXP_21264_CPU.h"
 
-u32 AXP_21264_Mbox_GetLQSlot(AXP_21264_CPU *);
+bool AXP_21264_Mbox_SlotAvailable(AXP_21264_CPU *, bool);
+bool AXP_21264_Mbox_QueuesEmpty(AXP_21264_CPU *);
+u32 AXP_21264_Mbox_GetLQSlot(AXP_21264_CPU *, AXP_INSTRUCTION *);
 void AXP_21264_Mbox_PutLQSlot(AXP_21264_CPU *, u32);
 void AXP_21264_Mbox_ReadMem(AXP_21264_CPU *, AXP_INSTRUCTION *, u32, u64);
-u32 AXP_21264_Mbox_GetSQSlot(AXP_21264_CPU *);
+u32 AXP_21264_Mbox_GetSQSlot(AXP_21264_CPU *, AXP_INSTRUCTION *);
 void AXP_21264_Mbox_PutSQSlot(AXP_21264_CPU *, u32);
 void AXP_21264_Mbox_WriteMem(AXP_21264_CPU *, AXP_INSTRUCTION *, u32, u64, u64);
 void AXP_21264_Mbox_CboxCompl(AXP_21264_CPU *, i8, u8 *, int, bool);
@@ -43,6 +57,7 @@ void AXP_21264_Mbox_SQ_Pending(AXP_21264_CPU *, u8);
 void AXP_21264_Mbox_SQ_Init(AXP_21264_CPU *, u8);
 void AXP_21264_Mbox_Process_Q(AXP_21264_CPU *);
 void AXP_21264_Mbox_RetireWrite(AXP_21264_CPU *, u8);
+bool AXP_21264_Mbox_RetireRead(AXP_21264_CPU *, u8);
 bool AXP_21264_Mbox_WorkQueued(AXP_21264_CPU *);
 void AXP_21264_Mbox_UpdateDcache(AXP_21264_CPU *, i8, u8 *, u8);
 bool AXP_21264_Mbox_Init(AXP_21264_CPU *);
@@ -27,6 +27,16 @@
  *	V01.001		01-Jan-2018	Jonathan D. Belanger
  *	Changed the way instructions are completed when they need to utilize the
  *	Mbox.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	Added the work lists, so that the Mbox only looks at the LQ and SQ
+ *	entries that have something to be done, and the completion routine for
+ *	each entry, which is determined when the entry is assigned.
+ *
+ *	V01.003		16-Oct-2026	Jonathan D. Belanger
+ *	Added what is needed to forward data from the SQ to younger loads, and
+ *	to detect loads that read their data before an older store to the same
+ *	address was known (the load-store order trap).
  */
 #ifndef _AXP_21264_MBOX_DEFS_DEFS_
 #define _AXP_21264_MBOX_DEFS_DEFS_
@@ -45,6 +55,40 @@ typedef enum
     SQComplete
 } AXP_MBOX_QUEUE_STATE;
 
+/*
+ * The LQ and SQ each have a work list for the states in which the Mbox has
+ * something to do.  Each work list is a mask, with a bit for each entry in
+ * the queue.  Entries are added to and removed from the work lists, with the
+ * Mbox mutex locked, as their state changes.
+ */
+typedef enum
+{
+    AXP_MBOX_WORK_INITIAL,	/* Initial */
+    AXP_MBOX_WORK_PENDING,	/* LQReadPending or SQWritePending */
+    AXP_MBOX_WORK_COMPLETE,	/* LQComplete or SQComplete */
+    AXP_MBOX_WORK_MAX
+} AXP_MBOX_WORK;
+
+/*
+ * Once the physical address of a store is known, its SQ entry is put into a
+ * bucket, by quadword address, so that a load only has to look at the stores
+ * that may have its data.  Entries are not taken out of a bucket until they
+ * are put into another one, so the entries in a bucket still need to be
+ * checked.  The bytes within the quadword that a load or store accesses are
+ * kept as a mask, with a bit for each byte.
+ *
+ * The uniqueID of an instruction wraps, but there are never more than
+ * AXP_INFLIGHT_MAX (less than 128) instructions in-flight, so the difference
+ * between two of them tells which one is older.
+ */
+#define AXP_MBOX_SQ_HASH_LEN		16
+#define AXP_MBOX_SQ_HASH(pa)						\
+    (((pa) >> 3) & (AXP_MBOX_SQ_HASH_LEN - 1))
+#define AXP_MBOX_QW(pa)			((pa) & ~0x7ll)
+#define AXP_MBOX_BYTES(pa, len)						\
+    ((u8) (((1 << (len)) - 1) << ((pa) & 0x7)))
+#define AXP_MBOX_OLDER(id1, id2)	((i8) ((u8) (id1) - (u8) (id2)) < 0)
+
 typedef struct
 {
     u64 value;
@@ -52,11 +96,16 @@ typedef struct
     u64 physAddress;
     u64 IOdata;
     AXP_INSTRUCTION *instr;
+    void (*complRtn)();		/* Ebox or Fbox completion */
     AXP_MBOX_QUEUE_STATE state;
     AXP_DCACHE_LOC dcacheLoc;
     u8 len;
+    u8 uniqueID;		/* of the instruction */
+    u8 fwdMask;			/* LQ: bytes forwarded from the SQ */
+    u8 fwdID;			/* LQ: youngest store forwarded from */
     bool lockCond;
     bool IOflag;
+    bool replay;		/* LQ: replay the load when retired */
 } AXP_MBOX_QUEUE;
 
 #endif /* _AXP_21264_MBOX_DEFS_DEFS_ */
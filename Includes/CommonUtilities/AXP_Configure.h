@@ -36,6 +36,21 @@
  *	V01.003		03-Feb-2018	Jonathan D. Belanger
  *	Continued to work on reading in the configuration file and loading it into
  *	a usable format.
+ *
+ *	V01.004		15-Oct-2026	Jonathan D. Belanger
+ *	Added the CPU execution mode (Detailed or Functional), which can be
+ *	specified for all CPUs or on a per CPU basis.
+ *
+ *	V01.005		16-Oct-2026	Jonathan D. Belanger
+ *	Added the CSV file, and the interval, for the CPU performance counters.
+ *
+ *	V01.006		16-Oct-2026	Jonathan D. Belanger
+ *	Added the memory array Backing, which determines how the host memory for
+ *	the emulated physical memory is obtained.
+ *
+ *	V01.007		16-Oct-2026	Jonathan D. Belanger
+ *	Added the number of instructions each CPU retires before it switches
+ *	from its configured execution mode to the other one.
  */
 #ifndef _AXP_CONFIGURE_DEFS_
 #define _AXP_CONFIGURE_DEFS_
@@ -68,10 +83,16 @@
  *				Count				number
  *				Generation			number
  *				Pass				number
+ *				Mode (number)		Detailed, Functional
+ *				CounterFile			file-specification
+ *				CounterInterval		number (milliseconds)
+ *				ModeSwitch			number (instructions)
  *				Name				string
  *			DARRAY
  *				Size				decimal
  *				Count				decimal
+ *				Backing				Sparse, Huge,
+ *									Allocate
  *			Disks
  *				*Disk (number)
  *					Type			Disk, CDROM, RWCDROM
@@ -152,14 +173,31 @@ typedef enum
     NoCPUs,
     CPUCount,
     Generation,
-    MfgPass
+    MfgPass,
+    CPUMode,
+    CounterFile,
+    CounterInterval,
+    ModeSwitch
 } AXP_21264_CONFIG_CPUS;
 
+/*
+ * The execution mode for a CPU.  In Detailed mode, the CPU is emulated as the
+ * out-of-order, pipelined 21264 (Ibox, Ebox, Fbox, Mbox, and Cbox).  In
+ * Functional mode, the Ibox executes each instruction in order, to completion,
+ * without register renaming or the instruction queues.
+ */
+typedef enum
+{
+    DetailedMode,
+    FunctionalMode
+} AXP_21264_EXEC_MODE;
+
 typedef enum
 {
     NoDARRAYs,
     DARRAYSize,
-    DARRAYCount
+    DARRAYCount,
+    DARRAYBacking
 } AXP_21264_CONFIG_DARRAYS;
 
 typedef enum
@@ -364,6 +402,12 @@ typedef struct
     AXP_CPU_CONFIG *config;
     u32 minorType;
     u32 count;
+    AXP_21264_EXEC_MODE mode;	/* default for all CPUs */
+    u32 modeSpecified;		/* bit per CPU with its own mode */
+    u32 modeFunctional;		/* bit per CPU in Functional mode */
+    char *counterFile;		/* CSV file for the performance counters */
+    u32 counterInterval;	/* milliseconds between counter snapshots */
+    u64 modeSwitch;			/* instructions until mode switch */
 } AXP_21264_CPU_INFO;
 
 /*
@@ -375,11 +419,25 @@ typedef struct
  *			DARRAY
  *				Size			decimal(MB,GB)
  *				Count			decimal	[1,2,3,4]
+ *				Backing			Sparse, Huge, Allocate
+ *
+ * The Backing determines how the host memory for the arrays is obtained.
+ * Sparse reserves the address space and only gets memory for the pages the
+ * emulation touches, Huge does the same using huge pages when it can, and
+ * Allocate gets all the memory up front.
  */
+typedef enum
+{
+    SparseBacking,
+    HugeBacking,
+    AllocateBacking
+} AXP_21264_DARRAY_BACKING;
+
 typedef struct
 {
     u64 size;
     u32 count;
+    AXP_21264_DARRAY_BACKING backing;
 } AXP_21264_DARRAY_INFO;
 
 /*
@@ -507,12 +565,16 @@ extern AXP_CPU_CONFIG AXP_CPU_Configurations[];
 int AXP_LoadConfig_File(char *);
 bool AXP_ConfigGet_CPUType(u32 *, u32 *);
 u32 AXP_ConfigGet_CPUCount(void);
+AXP_21264_EXEC_MODE AXP_ConfigGet_CPUMode(u32);
+u64 AXP_ConfigGet_ModeSwitch(void);
+bool AXP_ConfigGet_CounterFile(char *, u32 *);
 bool AXP_ConfigGet_InitFile(char *);
 bool AXP_ConfigGet_PALFile(char *);
 bool AXP_ConfigGet_ROMFile(char *);
 bool AXP_ConfigGet_NVRAMFile(char *);
 bool AXP_ConfigGet_CboxCSRFile(char *);
 void AXP_ConfigGet_DarrayInfo(u32 *, u64 *);
+AXP_21264_DARRAY_BACKING AXP_ConfigGet_DarrayBacking(void);
 void AXP_TraceConfig(void);
 
 #endif /* _AXP_CONFIGURE_DEFS_ */
@@ -23,6 +23,14 @@
  *
  *	V01.000		26-June-2018	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		15-Oct-2026	Jonathan D. Belanger
+ *	Added the functions to queue an instruction to the pipelines that can
+ *	execute it, and to wake up pipelines waiting on their registers.
+ *
+ *	V01.002		15-Oct-2026	Jonathan D. Belanger
+ *	Replaced the function to wake up pipelines with ones to hand over the
+ *	instructions waiting on a register just written, or just aborted.
  */
 #ifndef _AXP_EXECUTE_INS_BOX_
 #define _AXP_EXECUTE_INS_BOX_
@@ -30,8 +38,10 @@
 /*
  * Function prototype
  */
-void AXP_Execution_Box(AXP_21264_CPU *, AXP_PIPELINE, AXP_COUNTED_QUEUE *,
-        pthread_cond_t *, pthread_mutex_t *,
+void AXP_Execution_Box(AXP_21264_CPU *, AXP_PIPELINE,
         void (*)(AXP_21264_CPU *, AXP_QUEUE_ENTRY *));
+void AXP_Execution_Enqueue(AXP_21264_CPU *, AXP_QUEUE_ENTRY *);
+void AXP_Execution_RegReady(AXP_21264_CPU *, u16, bool);
+void AXP_Execution_Aborted(AXP_21264_CPU *);
 
 #endif	/* _AXP_EXECUTE_INS_BOX_ */
@@ -23,6 +23,19 @@
  *
  *  V01.000		27-Jam-2018	Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001		16-Oct-2026	Jonathan D. Belanger
+ *  Added the binary trace format.  Each thread writes fixed-size records into
+ *  its own ring buffer, which a background thread drains into the trace file.
+ *  DECaxp_Trace_Decode turns the file back into the text format.
+ *
+ *  V01.002		16-Oct-2026	Jonathan D. Belanger
+ *  The trace macros now test a flag for each type of tracing, determined once
+ *  when tracing is initialized, rather than decoding AXP_LOGMASK on every
+ *  call.  Tracing not in AXP_TRACE_COMPILED is removed at compile time.
+ *
+ *  V01.003		16-Oct-2026	Jonathan D. Belanger
+ *  Wrapped the trace macros to fit in 80 columns.
  */
 #ifndef AXP_TRACE_H_
 #define AXP_TRACE_H_
@@ -84,137 +97,216 @@ extern AXP_TRCLOG _axp_trc_log_;
 #define AXP_TRCLOG_WRITE(format, ...)	\
   AXP_TraceWrite(__FILE__, __LINE__, format, __VA_ARGS__)
 
+/*
+ * AXP_TRACE_COMPILED is a mask, in the same format as AXP_LOGMASK, of the
+ * tracing that is compiled into the code (see the AXP_TRACE_COMPILED CMake
+ * cache variable).  Tracing not in this mask is removed by the compiler, and
+ * cannot be turned on with AXP_LOGMASK.  A mask of 0 removes all tracing.
+ */
+#ifndef AXP_TRACE_COMPILED
+#define AXP_TRACE_COMPILED	0x0fffffff
+#endif
+
+/*
+ * Each type of tracing has a flag, which is determined from AXP_LOGMASK when
+ * tracing is initialized, so that a trace statement only needs to look at a
+ * single byte to determine if it should be traced.  Until tracing has been
+ * initialized, the flags are AXP_TRC_FLAG_UNSET, and the first check will
+ * initialize tracing.
+ *
+ * The list below contains the name, component, and the bits within the
+ * component, for each type of tracing.
+ */
+#define AXP_TRC_FLAG_LIST(X)						\
+    X(UTL_CALL, UTL, AXP_TRC_CALL)					\
+    X(UTL_BUFF, UTL, AXP_TRC_BUFF)					\
+    X(UTL_OPT1, UTL, AXP_TRC_OPT1)					\
+    X(UTL_OPT2, UTL, AXP_TRC_OPT2)					\
+    X(IBOX_CALL, CPU, AXP_TRC_IBOX | AXP_TRC_CALL)			\
+    X(IBOX_BUFF, CPU, AXP_TRC_IBOX | AXP_TRC_BUFF)			\
+    X(IBOX_OPT1, CPU, AXP_TRC_IBOX | AXP_TRC_OPT1)			\
+    X(IBOX_OPT2, CPU, AXP_TRC_IBOX | AXP_TRC_OPT2)			\
+    X(IBOX_INST, CPU, AXP_TRC_IBOX | AXP_TRC_INST)			\
+    X(EBOX_CALL, CPU, AXP_TRC_EBOX | AXP_TRC_CALL)			\
+    X(EBOX_BUFF, CPU, AXP_TRC_EBOX | AXP_TRC_BUFF)			\
+    X(EBOX_OPT1, CPU, AXP_TRC_EBOX | AXP_TRC_OPT1)			\
+    X(EBOX_OPT2, CPU, AXP_TRC_EBOX | AXP_TRC_OPT2)			\
+    X(FBOX_CALL, CPU, AXP_TRC_FBOX | AXP_TRC_CALL)			\
+    X(FBOX_BUFF, CPU, AXP_TRC_FBOX | AXP_TRC_BUFF)			\
+    X(FBOX_OPT1, CPU, AXP_TRC_FBOX | AXP_TRC_OPT1)			\
+    X(FBOX_OPT2, CPU, AXP_TRC_FBOX | AXP_TRC_OPT2)			\
+    X(MBOX_CALL, CPU, AXP_TRC_MBOX | AXP_TRC_CALL)			\
+    X(MBOX_BUFF, CPU, AXP_TRC_MBOX | AXP_TRC_BUFF)			\
+    X(MBOX_OPT1, CPU, AXP_TRC_MBOX | AXP_TRC_OPT1)			\
+    X(MBOX_OPT2, CPU, AXP_TRC_MBOX | AXP_TRC_OPT2)			\
+    X(CBOX_CALL, CPU, AXP_TRC_CBOX | AXP_TRC_CALL)			\
+    X(CBOX_BUFF, CPU, AXP_TRC_CBOX | AXP_TRC_BUFF)			\
+    X(CBOX_OPT1, CPU, AXP_TRC_CBOX | AXP_TRC_OPT1)			\
+    X(CBOX_OPT2, CPU, AXP_TRC_CBOX | AXP_TRC_OPT2)			\
+    X(CBOX_INST, CPU, AXP_TRC_CBOX | AXP_TRC_INST)			\
+    X(CACHE_CALL, CPU, AXP_TRC_CACHE | AXP_TRC_CALL)			\
+    X(CACHE_BUFF, CPU, AXP_TRC_CACHE | AXP_TRC_BUFF)			\
+    X(CACHE_OPT1, CPU, AXP_TRC_CACHE | AXP_TRC_OPT1)			\
+    X(CACHE_OPT2, CPU, AXP_TRC_CACHE | AXP_TRC_OPT2)			\
+    X(SYS_CALL, SYS, AXP_TRC_CALL)					\
+    X(SYS_BUFF, SYS, AXP_TRC_BUFF)					\
+    X(SYS_OPT1, SYS, AXP_TRC_OPT1)					\
+    X(SYS_OPT2, SYS, AXP_TRC_OPT2)
+
+typedef enum
+{
+#define AXP_TRC_FLAG_ENUM(name, comp, bits)	AXP_TRCFLG_##name,
+    AXP_TRC_FLAG_LIST(AXP_TRC_FLAG_ENUM)
+#undef AXP_TRC_FLAG_ENUM
+    AXP_TRCFLG_MAX
+} AXP_TRC_FLAG;
+
+#define AXP_TRC_FLAG_OFF	0
+#define AXP_TRC_FLAG_ON		1
+#define AXP_TRC_FLAG_UNSET	2
+
+extern u8 _axp_trc_flags_[AXP_TRCFLG_MAX];
+
+#define AXP_TRC_COMPILED(comp, bits)					\
+    ((((AXP_TRACE_COMPILED & AXP_COMP_##comp) >> AXP_SHIFT_##comp) &	\
+      (bits)) == (bits))
+#define AXP_TRC_FLAG(flag)						\
+    (__builtin_expect(_axp_trc_flags_[(flag)] != AXP_TRC_FLAG_OFF, 0) && \
+     ((_axp_trc_flags_[(flag)] == AXP_TRC_FLAG_ON) || AXP_TraceFlag(flag)))
+#define AXP_TRC_SITE(name, comp, bits)					\
+    (AXP_TRC_COMPILED(comp, (bits)) && AXP_TRC_FLAG(AXP_TRCFLG_##name))
+
 /*
  * These macros return true when a type of tracing is to be performed.
  */
-#define AXP_UTL_CALL	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_UTL) >> AXP_SHIFT_UTL) &	\
-          AXP_TRC_CALL) == AXP_TRC_CALL))
-#define AXP_UTL_BUFF	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_UTL) >> AXP_SHIFT_UTL) &	\
-         AXP_TRC_BUFF) == AXP_TRC_BUFF))
-#define AXP_UTL_OPT1	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_UTL) >> AXP_SHIFT_UTL) &	\
-         AXP_TRC_OPT1) == AXP_TRC_OPT1))
-#define AXP_UTL_OPT2	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_UTL) >> AXP_SHIFT_UTL) &	\
-         AXP_TRC_OPT2) == AXP_TRC_OPT2))
-#define AXP_IBOX_CALL	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_IBOX | AXP_TRC_CALL)) ==			\
-        (AXP_TRC_IBOX | AXP_TRC_CALL)))
-#define AXP_IBOX_BUFF	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_IBOX | AXP_TRC_BUFF)) ==			\
-        (AXP_TRC_IBOX | AXP_TRC_BUFF)))
-#define AXP_IBOX_OPT1	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_IBOX | AXP_TRC_OPT1)) ==			\
-        (AXP_TRC_IBOX | AXP_TRC_OPT1)))
-#define AXP_IBOX_OPT2	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_IBOX | AXP_TRC_OPT2)) ==			\
-        (AXP_TRC_IBOX | AXP_TRC_OPT2)))
-#define AXP_IBOX_INST	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_IBOX | AXP_TRC_INST)) ==			\
-        (AXP_TRC_IBOX | AXP_TRC_INST)))
-#define AXP_EBOX_CALL	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_EBOX | AXP_TRC_CALL)) ==			\
-        (AXP_TRC_EBOX | AXP_TRC_CALL)))
-#define AXP_EBOX_BUFF	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_EBOX | AXP_TRC_BUFF)) ==			\
-        (AXP_TRC_EBOX | AXP_TRC_BUFF)))
-#define AXP_EBOX_OPT1	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_EBOX | AXP_TRC_OPT1)) ==			\
-        (AXP_TRC_EBOX | AXP_TRC_OPT1)))
-#define AXP_EBOX_OPT2	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_EBOX | AXP_TRC_OPT2)) ==			\
-        (AXP_TRC_EBOX | AXP_TRC_OPT2)))
-#define AXP_FBOX_CALL	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_FBOX | AXP_TRC_CALL)) ==			\
-        (AXP_TRC_FBOX | AXP_TRC_CALL)))
-#define AXP_FBOX_BUFF	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_FBOX | AXP_TRC_BUFF)) ==			\
-        (AXP_TRC_FBOX | AXP_TRC_BUFF)))
-#define AXP_FBOX_OPT1	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_FBOX | AXP_TRC_OPT1)) ==			\
-        (AXP_TRC_FBOX | AXP_TRC_OPT1)))
-#define AXP_FBOX_OPT2	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_FBOX | AXP_TRC_OPT2)) ==			\
-        (AXP_TRC_FBOX | AXP_TRC_OPT2)))
-#define AXP_MBOX_CALL	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_MBOX | AXP_TRC_CALL)) ==			\
-        (AXP_TRC_MBOX | AXP_TRC_CALL)))
-#define AXP_MBOX_BUFF	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_MBOX | AXP_TRC_BUFF)) ==			\
-        (AXP_TRC_MBOX | AXP_TRC_BUFF)))
-#define AXP_MBOX_OPT1	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_MBOX | AXP_TRC_OPT1)) ==			\
-        (AXP_TRC_MBOX | AXP_TRC_OPT1)))
-#define AXP_MBOX_OPT2	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_MBOX | AXP_TRC_OPT2)) ==			\
-        (AXP_TRC_MBOX | AXP_TRC_OPT2)))
-#define AXP_CBOX_CALL	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CBOX | AXP_TRC_CALL)) ==			\
-        (AXP_TRC_CBOX | AXP_TRC_CALL)))
-#define AXP_CBOX_BUFF	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CBOX | AXP_TRC_BUFF)) ==			\
-        (AXP_TRC_CBOX | AXP_TRC_BUFF)))
-#define AXP_CBOX_OPT1	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CBOX | AXP_TRC_OPT1)) ==			\
-        (AXP_TRC_CBOX | AXP_TRC_OPT1)))
-#define AXP_CBOX_OPT2	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CBOX | AXP_TRC_OPT2)) ==			\
-        (AXP_TRC_CBOX | AXP_TRC_OPT2)))
-#define AXP_CBOX_INST	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CBOX | AXP_TRC_INST)) ==			\
-        (AXP_TRC_CBOX | AXP_TRC_INST)))
-#define AXP_CACHE_CALL	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CACHE | AXP_TRC_CALL)) ==			\
-        (AXP_TRC_CACHE | AXP_TRC_CALL)))
-#define AXP_CACHE_BUFF	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CACHE | AXP_TRC_BUFF)) ==			\
-        (AXP_TRC_CACHE | AXP_TRC_BUFF)))
-#define AXP_CACHE_OPT1	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CACHE | AXP_TRC_OPT1)) ==			\
-        (AXP_TRC_CACHE | AXP_TRC_OPT1)))
-#define AXP_CACHE_OPT2	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_CPU) >> AXP_SHIFT_CPU) &	\
-         (AXP_TRC_CACHE | AXP_TRC_OPT2)) ==			\
-        (AXP_TRC_CACHE | AXP_TRC_OPT2)))
-#define AXP_SYS_CALL	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_SYS) >> AXP_SHIFT_SYS) & 	\
-         AXP_TRC_CALL) == AXP_TRC_CALL))
-#define AXP_SYS_BUFF	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_SYS) >> AXP_SHIFT_SYS) & 	\
-         AXP_TRC_BUFF) == AXP_TRC_BUFF))
-#define AXP_SYS_OPT1	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_SYS) >> AXP_SHIFT_SYS) & 	\
-         AXP_TRC_OPT1) == AXP_TRC_OPT1))
-#define AXP_SYS_OPT2	(AXP_TRCLOG_INIT &					\
-       ((((_axp_trc_log_ & AXP_COMP_SYS) >> AXP_SHIFT_SYS) & 	\
-         AXP_TRC_OPT2) == AXP_TRC_OPT2))
+#define AXP_UTL_CALL							\
+    AXP_TRC_SITE(UTL_CALL, UTL, AXP_TRC_CALL)
+#define AXP_UTL_BUFF							\
+    AXP_TRC_SITE(UTL_BUFF, UTL, AXP_TRC_BUFF)
+#define AXP_UTL_OPT1							\
+    AXP_TRC_SITE(UTL_OPT1, UTL, AXP_TRC_OPT1)
+#define AXP_UTL_OPT2							\
+    AXP_TRC_SITE(UTL_OPT2, UTL, AXP_TRC_OPT2)
+#define AXP_IBOX_CALL							\
+    AXP_TRC_SITE(IBOX_CALL, CPU, AXP_TRC_IBOX | AXP_TRC_CALL)
+#define AXP_IBOX_BUFF							\
+    AXP_TRC_SITE(IBOX_BUFF, CPU, AXP_TRC_IBOX | AXP_TRC_BUFF)
+#define AXP_IBOX_OPT1							\
+    AXP_TRC_SITE(IBOX_OPT1, CPU, AXP_TRC_IBOX | AXP_TRC_OPT1)
+#define AXP_IBOX_OPT2							\
+    AXP_TRC_SITE(IBOX_OPT2, CPU, AXP_TRC_IBOX | AXP_TRC_OPT2)
+#define AXP_IBOX_INST							\
+    AXP_TRC_SITE(IBOX_INST, CPU, AXP_TRC_IBOX | AXP_TRC_INST)
+#define AXP_EBOX_CALL							\
+    AXP_TRC_SITE(EBOX_CALL, CPU, AXP_TRC_EBOX | AXP_TRC_CALL)
+#define AXP_EBOX_BUFF							\
+    AXP_TRC_SITE(EBOX_BUFF, CPU, AXP_TRC_EBOX | AXP_TRC_BUFF)
+#define AXP_EBOX_OPT1							\
+    AXP_TRC_SITE(EBOX_OPT1, CPU, AXP_TRC_EBOX | AXP_TRC_OPT1)
+#define AXP_EBOX_OPT2							\
+    AXP_TRC_SITE(EBOX_OPT2, CPU, AXP_TRC_EBOX | AXP_TRC_OPT2)
+#define AXP_FBOX_CALL							\
+    AXP_TRC_SITE(FBOX_CALL, CPU, AXP_TRC_FBOX | AXP_TRC_CALL)
+#define AXP_FBOX_BUFF							\
+    AXP_TRC_SITE(FBOX_BUFF, CPU, AXP_TRC_FBOX | AXP_TRC_BUFF)
+#define AXP_FBOX_OPT1							\
+    AXP_TRC_SITE(FBOX_OPT1, CPU, AXP_TRC_FBOX | AXP_TRC_OPT1)
+#define AXP_FBOX_OPT2							\
+    AXP_TRC_SITE(FBOX_OPT2, CPU, AXP_TRC_FBOX | AXP_TRC_OPT2)
+#define AXP_MBOX_CALL							\
+    AXP_TRC_SITE(MBOX_CALL, CPU, AXP_TRC_MBOX | AXP_TRC_CALL)
+#define AXP_MBOX_BUFF							\
+    AXP_TRC_SITE(MBOX_BUFF, CPU, AXP_TRC_MBOX | AXP_TRC_BUFF)
+#define AXP_MBOX_OPT1							\
+    AXP_TRC_SITE(MBOX_OPT1, CPU, AXP_TRC_MBOX | AXP_TRC_OPT1)
+#define AXP_MBOX_OPT2							\
+    AXP_TRC_SITE(MBOX_OPT2, CPU, AXP_TRC_MBOX | AXP_TRC_OPT2)
+#define AXP_CBOX_CALL							\
+    AXP_TRC_SITE(CBOX_CALL, CPU, AXP_TRC_CBOX | AXP_TRC_CALL)
+#define AXP_CBOX_BUFF							\
+    AXP_TRC_SITE(CBOX_BUFF, CPU, AXP_TRC_CBOX | AXP_TRC_BUFF)
+#define AXP_CBOX_OPT1							\
+    AXP_TRC_SITE(CBOX_OPT1, CPU, AXP_TRC_CBOX | AXP_TRC_OPT1)
+#define AXP_CBOX_OPT2							\
+    AXP_TRC_SITE(CBOX_OPT2, CPU, AXP_TRC_CBOX | AXP_TRC_OPT2)
+#define AXP_CBOX_INST							\
+    AXP_TRC_SITE(CBOX_INST, CPU, AXP_TRC_CBOX | AXP_TRC_INST)
+#define AXP_CACHE_CALL							\
+    AXP_TRC_SITE(CACHE_CALL, CPU, AXP_TRC_CACHE | AXP_TRC_CALL)
+#define AXP_CACHE_BUFF							\
+    AXP_TRC_SITE(CACHE_BUFF, CPU, AXP_TRC_CACHE | AXP_TRC_BUFF)
+#define AXP_CACHE_OPT1							\
+    AXP_TRC_SITE(CACHE_OPT1, CPU, AXP_TRC_CACHE | AXP_TRC_OPT1)
+#define AXP_CACHE_OPT2							\
+    AXP_TRC_SITE(CACHE_OPT2, CPU, AXP_TRC_CACHE | AXP_TRC_OPT2)
+#define AXP_SYS_CALL							\
+    AXP_TRC_SITE(SYS_CALL, SYS, AXP_TRC_CALL)
+#define AXP_SYS_BUFF							\
+    AXP_TRC_SITE(SYS_BUFF, SYS, AXP_TRC_BUFF)
+#define AXP_SYS_OPT1							\
+    AXP_TRC_SITE(SYS_OPT1, SYS, AXP_TRC_OPT1)
+#define AXP_SYS_OPT2							\
+    AXP_TRC_SITE(SYS_OPT2, SYS, AXP_TRC_OPT2)
+
+/*
+ * The binary trace file starts with the following magic string, which is
+ * followed by chunks.  Each chunk has a header, which is followed by len bytes
+ * of data.
+ *
+ *	AXP_TRC_CHUNK_FORMAT	A format string (NUL terminated), the id of
+ *				which is in the id field.
+ *	AXP_TRC_CHUNK_RECORDS	Slots from the ring buffer of the thread in
+ *				the id field.
+ *	AXP_TRC_CHUNK_CLOCK	An AXP_TRC_CLOCK, used to convert the time
+ *				stamps in the records to the time of day.
+ */
+#define AXP_TRC_MAGIC		"AXPTRC01"
+#define AXP_TRC_MAGIC_LEN	8
+
+typedef enum
+{
+    AXP_TRC_CHUNK_FORMAT = 1,
+    AXP_TRC_CHUNK_RECORDS,
+    AXP_TRC_CHUNK_CLOCK
+} AXP_TRC_CHUNK_TYPE;
+
+typedef struct
+{
+    u32 type;
+    u32 id;
+    u32 len;
+    u32 res;
+} AXP_TRC_CHUNK;
+
+typedef struct
+{
+    u64 stamp;		/* time stamp counter */
+    u64 nsec;		/* nanoseconds since the Epoch */
+} AXP_TRC_CLOCK;
+
+/*
+ * A trace record is made up of one or more slots.  The first slot starts with
+ * the header, which is followed by the arguments, as u64s, and then the
+ * strings for any %s arguments, each NUL terminated.  Format 0 is always
+ * "%s", which is used for formats that are not string literals.
+ */
+#define AXP_TRC_SLOT_LEN	64
+#define AXP_TRC_RING_SLOTS	16384		/* must be a power of 2 */
+#define AXP_TRC_MAX_SLOTS	32
+#define AXP_TRC_MAX_ARGS	24
+#define AXP_TRC_MAX_FORMATS	4096
+
+typedef struct
+{
+    u64 stamp;		/* time stamp counter */
+    u32 fmtId;		/* format string */
+    u16 len;		/* bytes after the header */
+    u8 argCnt;		/* u64 arguments after the header */
+    u8 res;
+} AXP_TRC_RECORD;
+
+#define AXP_TRC_RECORD_SLOTS(len)					\
+    ((sizeof(AXP_TRC_RECORD) + (len) + AXP_TRC_SLOT_LEN - 1) / AXP_TRC_SLOT_LEN)
 
 /*
  * Function Prototypes
@@ -224,5 +316,8 @@ void AXP_TraceEnd(void);
 void AXP_TraceWrite(char *, ...);
 void AXP_TraceLock(void);
 void AXP_TraceUnlock(void);
+bool AXP_TraceFlag(AXP_TRC_FLAG);
+u64 AXP_TraceDropped(void);
+int AXP_TraceDecode(FILE *, FILE *);
 
 #endif /* AXP_TRACE_H_ */
@@ -55,6 +55,11 @@
  *
  *  V01.006 26-Apr-2018 Jonathan D. Belanger
  *  Added macros to INSQUE and REMQUE entries from a doubly linked list.
+ *
+ *  V01.007 15-Oct-2026 Jonathan D. Belanger
+ *  Added a lock-free single-producer/single-consumer ring and an event count
+ *  that lets a producer wake one particular consumer, rather than having to
+ *  broadcast on a condition variable shared by all of them.
  */
 #ifndef _AXP_UTIL_DEFS_
 #define _AXP_UTIL_DEFS_
@@ -294,6 +299,64 @@ typedef struct condQueueCountRoot
     u32 max;
 } AXP_COND_Q_ROOT_CNT;
 
+/*
+ * Single-producer/single-consumer (SPSC) ring.
+ *
+ * Exactly one thread puts entries onto the ring and exactly one thread takes
+ * them off, so neither side needs a mutex.  The producer only ever writes the
+ * tail and the consumer only ever writes the head, and these are kept on
+ * separate cache lines so that the two threads do not keep pulling the same
+ * line back and forth.  Each slot carries a tag along with the item, which the
+ * consumer can use to detect that the item has been reused since it was put
+ * onto the ring.  The length must be a power of 2.
+ *
+ * NOTE:    Padding is used, rather than aligning the fields, because these
+ *          are embedded in structures allocated with calloc, which does not
+ *          guarantee anything more than 16-byte alignment.
+ */
+#define AXP_SPSC_RING_LEN   64
+#define AXP_SPSC_RING_MASK  (AXP_SPSC_RING_LEN - 1)
+#define AXP_CACHE_LINE_SIZE 64
+#define AXP_CACHE_LINE_PAD  (AXP_CACHE_LINE_SIZE - sizeof(u32))
+
+typedef struct
+{
+    void *item;
+    u32 tag;
+} AXP_SPSC_SLOT;
+
+typedef struct
+{
+    u8 headPad[AXP_CACHE_LINE_PAD];
+    u32 head;
+    u8 tailPad[AXP_CACHE_LINE_PAD];
+    u32 tail;
+    u8 slotPad[AXP_CACHE_LINE_PAD];
+    AXP_SPSC_SLOT slot[AXP_SPSC_RING_LEN];
+} AXP_SPSC_RING;
+
+/*
+ * Event count.
+ *
+ * This is used by a consumer to go to sleep until a producer has something for
+ * it.  The consumer gets the current sequence, checks for work, and only then
+ * waits for the sequence to change.  The producer bumps the sequence and only
+ * goes through the mutex and condition variable when the consumer has said it
+ * is actually asleep, so a busy consumer costs the producer nothing more than
+ * a couple of atomic operations.
+ */
+#define AXP_EVENT_COUNT_SPIN    1000
+
+typedef struct
+{
+    u8 seqPad[AXP_CACHE_LINE_PAD];
+    u32 seq;
+    u32 waiters;
+    u32 spin;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} AXP_EVENT_COUNT;
+
 /*
  * Error returns for various AXP Utility file load functions.
  */
@@ -339,6 +402,19 @@ bool AXP_CondQueue_Remove(AXP_COND_Q_LEAF *, AXP_COND_Q_LEAF **);
 void AXP_CondQueue_Wait(AXP_COND_Q_HDR *);
 bool AXP_CondQueue_Empty(AXP_COND_Q_HDR *);
 
+/*
+ * Single-producer/single-consumer ring and event count functions.
+ */
+void AXP_SPSCRing_Init(AXP_SPSC_RING *);
+bool AXP_SPSCRing_Put(AXP_SPSC_RING *, void *, u32);
+bool AXP_SPSCRing_Get(AXP_SPSC_RING *, AXP_SPSC_SLOT *);
+u32 AXP_SPSCRing_Count(AXP_SPSC_RING *);
+bool AXP_EventCount_Init(AXP_EVENT_COUNT *);
+u32 AXP_EventCount_Prepare(AXP_EVENT_COUNT *);
+void AXP_EventCount_Wait(AXP_EVENT_COUNT *, u32);
+bool AXP_EventCount_Sleeping(AXP_EVENT_COUNT *);
+void AXP_EventCount_Signal(AXP_EVENT_COUNT *);
+
 /*
  * ROM and Executable file reading and writing.
  */
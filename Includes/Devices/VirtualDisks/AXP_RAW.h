@@ -27,6 +27,10 @@
  *
  *  V01.000	15-Jul-2018	Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001	16-Oct-2026	Jonathan D. Belanger
+ *  Added the functions to read and write sectors, either with the file
+ *  descriptor or through a mapping of the disk into memory.
  */
 #ifndef AXP_RAW_H_
 #define AXP_RAW_H_
@@ -68,9 +72,11 @@ typedef struct
     bool		readOnly;
 
     /*
-     * This is the file descriptor to the device.
+     * This is the file descriptor to the device, and the mapping of it into
+     * memory, if it has been mapped.
      */
     int			fd;
+    AXP_VHD_MMAP	*mapping;
 
     /*
      * These are things read from (or written to) the VHD file that are used
@@ -85,5 +91,8 @@ typedef struct
 } AXP_RAW_Handle;
 
 u32 _AXP_RAW_Open(char *, AXP_VHD_OPEN_FLAG, u32, AXP_VHD_HANDLE *);
+u32 _AXP_RAW_ReadSectors(AXP_VHD_HANDLE, u64, u32 *, u8 *);
+u32 _AXP_RAW_WriteSectors(AXP_VHD_HANDLE, u64, u32 *, u8 *);
+u32 _AXP_RAW_SubmitSectors(AXP_VHD_HANDLE, AXP_VHD_IO_REQ **, u32);
 
 #endif /* AXP_RAW_H_ */
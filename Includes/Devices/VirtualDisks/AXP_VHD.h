@@ -23,6 +23,16 @@
  *
  *  V01.000	08-Jul-2018	Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001	16-Oct-2026	Jonathan D. Belanger
+ *  Corrected the name of the write sectors function, and added the function
+ *  to submit sector I/O asynchronously.
+ *
+ *  V01.002	16-Oct-2026	Jonathan D. Belanger
+ *  Added the function to allocate blocks in a dynamic or differencing VHD.
+ *  The parent's Unicode name and the parent locator data offset are now the
+ *  sizes the specification calls for, so the Dynamic Disk Header is 1024
+ *  bytes, and the Hard Disk Footer is packed to 512 bytes.
  */
 #ifndef _AXP_VHD_H_
 #define _AXP_VHD_H_
@@ -85,7 +95,7 @@ typedef struct
     AXP_VHDX_GUID guid;
     u8 saveState;
     u8 res_1[AXP_VHD_FOOTER_RES_LEN];
-} AXP_VHD_Footer;
+} __attribute__ ((packed)) AXP_VHD_Footer;
 
 #define AXP_VHDFILE_SIG		0x78697463656e6f63ll
 #define AXP_FEATURES_NONE	0x00000000l
@@ -106,6 +116,7 @@ typedef struct
  * sector (512-byte) boundary.
  */
 #define AXP_VHD_DYNAMIC_RES_LEN	256
+#define AXP_VHD_PARENT_NAME_LEN	256
 #define AXP_VHD_PARENT_LOC_CNT	8
 typedef struct
 {
@@ -113,7 +124,7 @@ typedef struct
     u32 dataSpace;  /* in sectors */
     u32 dataLen;    /* in bytes */
     u32 res_1;
-    u32 dataOff;
+    u64 dataOff;
 } AXP_VHD_ParentLoc;
 
 #define AXP_VHD_PCODE_NONE	0x00000000l
@@ -136,7 +147,7 @@ typedef struct
     AXP_VHDX_GUID parentGuid;
     u32 parentTimestamp;
     u32 res_1;
-    uint16_t parentName;
+    u16 parentName[AXP_VHD_PARENT_NAME_LEN];
     AXP_VHD_ParentLoc parentLoc[AXP_VHD_PARENT_LOC_CNT];
     u8 res_2[AXP_VHD_DYNAMIC_RES_LEN];
 } AXP_VHD_Dynamic;
@@ -177,7 +188,9 @@ u32 _AXP_VHD_Create(char *,
                     u32,
                     AXP_VHD_HANDLE *);
 u32 _AXP_VHD_Open(char *, AXP_VHD_OPEN_FLAG, u32, AXP_VHD_HANDLE *);
-u32 _AXP_VHD_ReadSectors(AXP_VHD_HANDLE, u64, size_t *, u8 *);
-u32 _AXP_VHD_WritreSectors(AXP_VHD_HANDLE, u64, u32 *, u8 *);
+u32 _AXP_VHD_ReadSectors(AXP_VHD_HANDLE, u64, u32 *, u8 *);
+u32 _AXP_VHD_WriteSectors(AXP_VHD_HANDLE, u64, u32 *, u8 *);
+u32 _AXP_VHD_SubmitSectors(AXP_VHD_HANDLE, AXP_VHD_IO_REQ **, u32);
+u32 _AXP_VHD_AllocateBlocks(AXP_VHD_HANDLE, u32 *, u32);
 
 #endif /* _AXP_VHD_H_ */
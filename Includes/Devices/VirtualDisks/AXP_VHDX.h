@@ -23,6 +23,17 @@
  *
  *  V01.000 03-Jul-2018 Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Added the file descriptor and asynchronous I/O engine, used to read and
+ *  write the sectors, to the handle.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Added the in-memory block map, and the parent of a differencing disk, to
+ *  the handle, and the functions to read and write the sectors of a VHDX.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Added the memory mapping of a fixed VHD's sectors to the handle.
  */
 #ifndef _AXP_VHDX_H_
 #define _AXP_VHDX_H_
@@ -30,6 +41,8 @@
 #include "CommonUtilities/AXP_Configure.h"
 #include "CommonUtilities/AXP_Trace.h"
 #include "Devices/VirtualDisks/AXP_VHD_Utility.h"
+#include "Devices/VirtualDisks/AXP_VHD_AsyncIO.h"
+#include "Devices/VirtualDisks/AXP_VHD_Mmap.h"
 #include <errno.h>
 
 /*
@@ -262,9 +275,16 @@ typedef struct
 {
 
     /*
-     * This is the file pointer and file name associated with the VHD.
+     * This is the file pointer and file name associated with the VHD.  The
+     * headers and tables are read and written using the file pointer.  The
+     * sectors are read and written by the I/O engine, using the file
+     * descriptor, or, once a fixed VHD has been mapped into memory, by
+     * copying them to and from the mapping.
      */
     FILE *fp;
+    int fd;
+    AXP_VHD_IO_ENGINE *io;
+    AXP_VHD_MMAP *mapping;
 
     /*
      * These are parameters provided by the interface and stored for later
@@ -298,6 +318,25 @@ typedef struct
     u32 cylinders;
     u32 heads;
     u32 sectors;
+
+    /*
+     * For a dynamic or differencing disk, the file offset of the data for
+     * each block (zero if the block has not been allocated), and each block's
+     * sector bitmap (read in the first time it is needed), are kept in
+     * memory.  New blocks are allocated, a batch at a time, at fileEnd.  A
+     * differencing disk reads the sectors it does not have from its parent.
+     * The blocks of a dynamic disk are all present once allocated, so only a
+     * differencing disk keeps its sector bitmaps up to date.
+     */
+    u64 *blkOffsets;
+    u8 **bitmaps;
+    u64 fileEnd;
+    u32 blkCount;
+    u32 bitmapSize;
+    u32 chunkRatio;
+    AXP_VHD_HANDLE parent;
+    bool differencing;
+    pthread_mutex_t mapMutex;
 } AXP_VHDX_Handle;
 
 /*
@@ -313,5 +352,9 @@ u32 _AXP_VHDX_Create(char *,
                      u32,
                      AXP_VHD_HANDLE *);
 u32 _AXP_VHDX_Open(char *, AXP_VHD_OPEN_FLAG, u32, AXP_VHD_HANDLE *);
+u32 _AXP_VHDX_ReadSectors(AXP_VHD_HANDLE, u64, u32 *, u8 *);
+u32 _AXP_VHDX_WriteSectors(AXP_VHD_HANDLE, u64, u32 *, u8 *);
+u32 _AXP_VHDX_SubmitSectors(AXP_VHD_HANDLE, AXP_VHD_IO_REQ **, u32);
+u32 _AXP_VHDX_AllocateBlocks(AXP_VHD_HANDLE, u32 *, u32);
 
 #endif /* _AXP_VHDX_H_ */
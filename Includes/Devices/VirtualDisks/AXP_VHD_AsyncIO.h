@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This header file contains the definitions needed by its source companion,
+ *  which performs the reads, writes, and flushes of a virtual disk file
+ *  asynchronously, so that an emulated controller can have many I/Os in
+ *  flight at once.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#ifndef _AXP_VHD_ASYNCIO_H_
+#define _AXP_VHD_ASYNCIO_H_
+#include "CommonUtilities/AXP_Utility.h"
+#include <sys/uio.h>
+
+/*
+ * The default and maximum number of I/Os an engine will have in flight, and
+ * the number of threads used when the host's io_uring cannot be.
+ */
+#define AXP_VHD_IO_DEPTH        32
+#define AXP_VHD_IO_MAX_DEPTH    256
+#define AXP_VHD_IO_THREADS      4
+
+/*
+ * The largest number of contiguous requests the thread pool will combine into
+ * a single preadv or pwritev.
+ */
+#define AXP_VHD_IO_MAX_IOV      16
+
+typedef enum
+{
+    AXP_VHD_IO_Auto,            /* io_uring, if the host has it */
+    AXP_VHD_IO_Uring,
+    AXP_VHD_IO_Threads
+} AXP_VHD_IO_TYPE;
+
+typedef enum
+{
+    AXP_VHD_IO_Read,
+    AXP_VHD_IO_Write,
+    AXP_VHD_IO_Flush
+} AXP_VHD_IO_OP;
+
+/*
+ * An I/O request.  The caller owns the request, and it must stay where it is
+ * until it has completed.  The offset and length are in bytes within the
+ * file.  When a virtual disk is given the request, it sets these from the
+ * LBA and sector count.
+ *
+ * The done function, if there is one, is called from one of the engine's
+ * threads when the request completes.  It may submit more requests, but must
+ * not wait for any.
+ */
+typedef struct _AXP_VHD_IO_REQ
+{
+    struct _AXP_VHD_IO_REQ *next;
+    AXP_VHD_IO_OP op;
+    u64 lba;
+    u32 sectors;
+    u8 *buf;
+    u64 offset;
+    size_t length;
+    void (*done)(struct _AXP_VHD_IO_REQ *);
+    void *ctx;
+
+    /*
+     * These are set by the engine.
+     */
+    u32 status;
+    size_t transferred;
+    struct iovec iov;
+    bool complete;
+} AXP_VHD_IO_REQ;
+
+typedef struct _AXP_VHD_IO_ENGINE AXP_VHD_IO_ENGINE;
+
+/*
+ * Function Prototypes
+ */
+AXP_VHD_IO_ENGINE *AXP_VHD_IO_Create(int, u32, AXP_VHD_IO_TYPE);
+void AXP_VHD_IO_Destroy(AXP_VHD_IO_ENGINE *);
+AXP_VHD_IO_TYPE AXP_VHD_IO_Type(AXP_VHD_IO_ENGINE *);
+u32 AXP_VHD_IO_Submit(AXP_VHD_IO_ENGINE *, AXP_VHD_IO_REQ **, u32);
+u32 AXP_VHD_IO_Transfer(AXP_VHD_IO_ENGINE *, AXP_VHD_IO_REQ *);
+void AXP_VHD_IO_Wait(AXP_VHD_IO_ENGINE *);
+u32 AXP_VHD_IO_MaxInFlight(AXP_VHD_IO_ENGINE *);
+
+#endif /* _AXP_VHD_ASYNCIO_H_ */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This header file contains the definitions needed by its source companion,
+ *  which reads and writes the sectors of a dynamic or differencing virtual
+ *  disk, using the block map kept in memory in the disk's handle.  The VHD
+ *  and VHDX code each load the map from their own Block Allocation Table,
+ *  and allocate new blocks in their own way.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#ifndef _AXP_VHD_BLOCKMAP_H_
+#define _AXP_VHD_BLOCKMAP_H_
+#include "CommonUtilities/AXP_Utility.h"
+#include "Devices/VirtualDisks/AXP_VHDX.h"
+
+/*
+ * A sector bitmap has one bit for each sector in a block.  The first sector
+ * of the block is the most significant bit of the first byte.
+ */
+#define AXP_VHD_MAP_BIT(sector)     (0x80 >> ((sector) & 0x07))
+#define AXP_VHD_MAP_TEST(bitmap, sector)                                    \
+    (((bitmap)[(sector) >> 3] & AXP_VHD_MAP_BIT(sector)) != 0)
+
+/*
+ * Function Prototypes
+ */
+u32 AXP_VHD_MapInit(AXP_VHDX_Handle *, u32, u32);
+void AXP_VHD_MapFree(AXP_VHDX_Handle *);
+void AXP_VHD_StartIO(AXP_VHDX_Handle *);
+u32 AXP_VHD_Transfer(AXP_VHDX_Handle *, AXP_VHD_IO_OP, u64, u8 *, size_t *);
+u32 AXP_VHD_MapRead(AXP_VHDX_Handle *, u64, u32 *, u8 *);
+u32 AXP_VHD_MapWrite(AXP_VHDX_Handle *, u64, u32 *, u8 *);
+u32 AXP_VHD_MapSubmit(AXP_VHDX_Handle *, AXP_VHD_IO_REQ **, u32);
+
+#endif /* _AXP_VHD_BLOCKMAP_H_ */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This header file contains the definitions needed by its source companion,
+ *  which maps the sectors of a RAW or fixed VHD disk into memory, so that
+ *  they can be read and written by copying to and from the mapping.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#ifndef _AXP_VHD_MMAP_H_
+#define _AXP_VHD_MMAP_H_
+#include "CommonUtilities/AXP_Utility.h"
+#include "Devices/VirtualDisks/AXP_VHD_AsyncIO.h"
+
+/*
+ * What the host is told about how the disk will be accessed.
+ */
+typedef enum
+{
+    AXP_VHD_MMAP_Normal,
+    AXP_VHD_MMAP_Sequential,
+    AXP_VHD_MMAP_Random,
+    AXP_VHD_MMAP_WillNeed       /* read the whole disk in ahead of time */
+} AXP_VHD_MMAP_ADVICE;
+
+/*
+ * When what is written to the mapping is written to the file.  WriteThrough
+ * does not return from a write until it is in the file.  Async starts writing
+ * it to the file, but does not wait.  WriteBack leaves it to the host until a
+ * flush, which writes everything dirtied since the last one.
+ */
+typedef enum
+{
+    AXP_VHD_MMAP_WriteThrough,
+    AXP_VHD_MMAP_Async,
+    AXP_VHD_MMAP_WriteBack
+} AXP_VHD_MMAP_SYNC;
+
+typedef struct _AXP_VHD_MMAP AXP_VHD_MMAP;
+
+/*
+ * Function Prototypes
+ */
+AXP_VHD_MMAP *AXP_VHD_MMAP_Create(int,
+                                  u64,
+                                  bool,
+                                  AXP_VHD_MMAP_ADVICE,
+                                  AXP_VHD_MMAP_SYNC);
+void AXP_VHD_MMAP_Destroy(AXP_VHD_MMAP *);
+u32 AXP_VHD_MMAP_Read(AXP_VHD_MMAP *, u64, u8 *, size_t *);
+u32 AXP_VHD_MMAP_Write(AXP_VHD_MMAP *, u64, u8 *, size_t *);
+u32 AXP_VHD_MMAP_Flush(AXP_VHD_MMAP *);
+void AXP_VHD_MMAP_Submit(AXP_VHD_MMAP *, AXP_VHD_IO_REQ **, u32);
+
+#endif /* _AXP_VHD_MMAP_H_ */
@@ -25,12 +25,22 @@
  *
  *  V01.000	02-Jul-2018	Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001	16-Oct-2026	Jonathan D. Belanger
+ *  Added the functions to submit sector reads, writes, and flushes to be
+ *  completed asynchronously, and wait for them.
+ *
+ *  V01.002	16-Oct-2026	Jonathan D. Belanger
+ *  Added the functions to map a RAW or fixed VHD disk into memory, and to
+ *  flush what has been written to it.
  */
 #ifndef AXP_VIRTUALDISK_H_
 #define AXP_VIRTUALDISK_H_
 #include "CommonUtilities/AXP_Utility.h"
 #include "CommonUtilities/AXP_Configure.h"
 #include "CommonUtilities/AXP_GUID.h"
+#include "Devices/VirtualDisks/AXP_VHD_AsyncIO.h"
+#include "Devices/VirtualDisks/AXP_VHD_Mmap.h"
 
 /*
  * Various length definitions.
@@ -995,4 +1005,31 @@ u32 AXP_VHD_WriteSectors(AXP_VHD_HANDLE handle,
       u32 *sectorsWritten,
       u8 *outBuf);
 
+/*
+ * Submit a batch of sector reads, writes, and flushes to be completed
+ * asynchronously.
+ */
+u32 AXP_VHD_SubmitSectors(AXP_VHD_HANDLE handle,
+      AXP_VHD_IO_REQ **reqs,
+      u32 count);
+
+/*
+ * Wait for all the sector reads, writes, and flushes submitted to complete.
+ */
+u32 AXP_VHD_WaitSectors(AXP_VHD_HANDLE handle);
+
+/*
+ * Map the sectors of a RAW or fixed VHD into memory, so that they are read
+ * and written by copying them.
+ */
+u32 AXP_VHD_MemoryMap(AXP_VHD_HANDLE handle,
+      AXP_VHD_MMAP_ADVICE advice,
+      AXP_VHD_MMAP_SYNC sync);
+
+/*
+ * Write everything written to the VHD to the file, and wait for it to get
+ * there.
+ */
+u32 AXP_VHD_FlushSectors(AXP_VHD_HANDLE handle);
+
 #endif /* AXP_VIRTUALDISK_H_ */
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *	This header file contains the definitions needed to get and release the
+ *	host memory used for the emulated system's memory arrays.
+ *
+ * Revision History:
+ *
+ *	V01.000		16-Oct-2026	Jonathan D. Belanger
+ *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Added the memory map, for finding the host memory for a physical
+ *	address.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	Wrapped lines longer than 80 columns.
+ */
+#ifndef _AXP_21274_MEMORY_H_
+#define _AXP_21274_MEMORY_H_
+
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Configure.h"
+#include "Motherboard/Cchip/CPUInterface/AXP_21274_21264_Common.h"
+
+/*
+ * The sparse and huge page backed arrays are reserved in multiples of the
+ * host's huge page size (2MB on x86_64), so that the whole array can be
+ * backed by huge pages.
+ */
+#define AXP_21274_HUGE_PAGE		(2 * ONE_M)
+#define AXP_21274_ARRAY_LEN(size)	\
+	(((size) + AXP_21274_HUGE_PAGE - 1) & ~((u64) AXP_21274_HUGE_PAGE - 1))
+
+/*
+ * This macro returns the host address for a physical memory address, or NULL
+ * if there is no memory there.
+ */
+#define AXP_21274_MEM_HOST(map, pa)                                     \
+    (((((pa) >> AXP_21274_MEM_MAP_SHIFT) < AXP_21274_MEM_MAP_LEN) &&    \
+      ((map)[(pa) >> AXP_21274_MEM_MAP_SHIFT] != NULL)) ?               \
+     ((map)[(pa) >> AXP_21274_MEM_MAP_SHIFT] +                          \
+      ((pa) & AXP_21274_MEM_MAP_MASK)) :                                \
+     NULL)
+
+/*
+ * Function Prototypes
+ */
+u64 *AXP_21274_AllocateArray(u64, AXP_21264_DARRAY_BACKING);
+void AXP_21274_FreeArray(u64 *, u64, AXP_21264_DARRAY_BACKING);
+void AXP_21274_MapArrays(u8 **, u64 **, u32, u64);
+
+#endif /* _AXP_21274_MEMORY_H_ */
@@ -22,6 +22,16 @@
  *
  *	V01.000		31-Dec-2017	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Added the backing used to get the host memory for the memory arrays.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	Added the map of host memory for the memory arrays.
+ *
+ *	V01.003		16-Oct-2026	Jonathan D. Belanger
+ *	Replaced the Cchip's one request queue with a request ring for each CPU,
+ *	and added the memory worker threads.
  */
 #ifndef _AXP_SYSTEM_DEFS_
 #define _AXP_SYSTEM_DEFS_	1
@@ -116,13 +126,13 @@ typedef struct
      * Cchip Data and Information											 *
      *************************************************************************/
     pthread_t cChipThreadID;
-    pthread_mutex_t cChipMutex;
-    pthread_cond_t cChipCond;
-    AXP_QUEUE_HDR skidBufferQ;
+    AXP_EVENT_COUNT cChipEvent;
+    AXP_SPSC_RING cpuRq[AXP_21274_MAX_CPUS];
     AXP_21274_RQ_ENTRY skidBuffers[AXP_21274_CCHIP_RQ_LEN * AXP_21274_MAX_CPUS];
-    u32 skidLastUsed;
     u32 cpuCount;
     AXP_21274_CPU cpu[AXP_21274_MAX_CPUS];
+    u32 memWorkerCount;
+    AXP_21274_MEM_WORKER memWorker[AXP_21274_MAX_MEM_WORKERS];
 
     /*
      * Cchip Registers
@@ -167,6 +177,8 @@ typedef struct
     u32 arrayCount;
     u64 *array[AXP_21274_MAX_ARRAYS];
     u64 arraySizes;
+    AXP_21264_DARRAY_BACKING arrayBacking;
+    u8 *memMap[AXP_21274_MEM_MAP_LEN];
 
     /*
      * System Memory
@@ -192,4 +204,9 @@ typedef struct
     AXP_21274_PCHIP p1;
 } AXP_21274_SYSTEM;
 
+/*
+ * Function Prototypes
+ */
+void AXP_21264_SendToCPU(AXP_21274_SYSBUS_CPU *, AXP_21274_CPU *);
+
 #endif	/* _AXP_SYSTEM_DEFS_ */
@@ -23,6 +23,10 @@
  *
  *	V01.000		18-Mar-2018	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Added the memory workers, which read and write the memory arrays for the
+ *	Cchip.
  */
 #ifndef _AXP_21274_CCHIP_H_
 #define _AXP_21274_CCHIP_H_
@@ -242,6 +246,32 @@ typedef struct
     u8 res;				/* reserved */
 } AXP_CAPbusMsg;
 
+/*
+ * The Cchip hands the memory block reads and writes to a number of memory
+ * worker threads, so that the requests from more than one CPU can be
+ * processed at the same time.  The requests are shared out by DRAM page
+ * (8KB), so all the requests for the same block go, in the order the Cchip
+ * received them, to the same worker.
+ *
+ * Only the Cchip puts requests onto a worker's ring and updates queued.  Only
+ * the worker takes them off and updates done.  When the two are equal, the
+ * worker has finished all the requests the Cchip has given it.
+ */
+#define AXP_21274_MAX_MEM_WORKERS	4
+#define AXP_21274_MEM_SHARD_SHIFT	13
+#define AXP_21274_MEM_SHARD(pa, count)	\
+    (((pa) >> AXP_21274_MEM_SHARD_SHIFT) % (count))
+
+typedef struct
+{
+    AXP_SPSC_RING rq;
+    AXP_EVENT_COUNT event;
+    pthread_t threadID;
+    void *sys;
+    u64 queued;
+    u64 done;
+} AXP_21274_MEM_WORKER;
+
 #include "Motherboard/Pchip/AXP_21274_Pchip.h"
 #include "Motherboard/Dchip/AXP_21274_Dchip.h"
 
@@ -34,6 +34,18 @@
  *
  *	V01.000		31-Mar-2018	Jonathan D. Belanger
  *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Added the memory map, used to find the host memory for a physical memory
+ *	address.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	Each CPU now has its own request entries, which it hands to the System
+ *	on its own request ring, rather than on a queue shared by all the CPUs.
+ *
+ *	V01.003		16-Oct-2026	Jonathan D. Belanger
+ *	Added the probe field to the PQ entry, which was missing, so that the
+ *	System writes its responses where the CPU looks for them.
  */
 #ifndef _AXP_21274_21264_COMMON_H_
 #define _AXP_21274_21264_COMMON_H_
@@ -47,6 +59,16 @@
  */
 #define AXP_21274_DATA_SIZE	8
 
+/*
+ * The System keeps a map of the host memory for the memory arrays, with one
+ * entry for each 64MB of physical memory, up to 32GB.  An entry is NULL when
+ * there is no memory at that address.  The CPU uses the map to read and write
+ * memory blocks directly, when no other CPU needs to be probed.
+ */
+#define AXP_21274_MEM_MAP_SHIFT	26
+#define AXP_21274_MEM_MAP_LEN	512
+#define AXP_21274_MEM_MAP_MASK	((1ll << AXP_21274_MEM_MAP_SHIFT) - 1)
+
 /*
  * The following data structure will be used to send Probe Requests and sysDc
  * responses, with or without the Probe Request, with or without data from the
@@ -100,6 +122,7 @@ typedef struct
     u64 sysData[AXP_21274_DATA_SIZE];
     AXP_SYSDC sysDc;
     AXP_ProbeStatus probeStatus;
+    int probe;
     bool rvb;
     bool rpb;
     bool a;
@@ -146,10 +169,14 @@ typedef struct
  *	  after a previous request without waiting for RAS precharge delay
  *	- Older request vector - A bit vector identifying all older requests in
  *	  this queue (used to arbitrate among otherwise equal ready requests)
+ *
+ * The entries for each CPU belong to that CPU.  The CPU fills in an entry that
+ * is not in use, marks it in use, and puts it onto its request ring.  The
+ * System marks the entry no longer in use once it is done with it, before the
+ * response is sent back to the CPU.
  */
 typedef struct
 {
-    AXP_QUEUE_HDR header;
     u64 sysData[AXP_21274_DATA_SIZE];
     u64 mask;
     u64 pa;
@@ -160,6 +187,7 @@ typedef struct
     int sysDataLen;
     u32 cpuID;
     u16 waitVector;
+    bool miss1;
     bool miss2;
     bool rqValid;
     bool cacheHit;
@@ -185,9 +213,10 @@ void AXP_21264_Save_SystemInterfaces(
     u8 **,
     u8 **,
     u8 **,
-    pthread_mutex_t *,
-    pthread_cond_t *,
-    AXP_QUEUE_HDR *);
+    AXP_SPSC_RING *,
+    AXP_EVENT_COUNT *,
+    void *);
+void AXP_21264_Save_MemoryMap(void *, u8 **, bool);
 void AXP_21264_Unlock_CPU(void *);
 
 #endif /* _AXP_21274_21264_COMMON_H_ */
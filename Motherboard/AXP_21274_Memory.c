@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *	This module contains the code to get and release the host memory used
+ *	for the emulated system's memory arrays.  A sparse array only reserves
+ *	the address space, the host supplying zeroed memory for each page the
+ *	first time it is touched, so a large emulated memory costs nothing until
+ *	the emulated system uses it.
+ *
+ * Revision History:
+ *
+ *	V01.000		16-Oct-2026	Jonathan D. Belanger
+ *	Initially written.
+ *
+ *	V01.001		16-Oct-2026	Jonathan D. Belanger
+ *	Added the function to build the map of host memory for the arrays.
+ *
+ *	V01.002		16-Oct-2026	Jonathan D. Belanger
+ *	Trace the address of the allocated array as a pointer.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Configure.h"
+#include "CommonUtilities/AXP_Trace.h"
+#include "Motherboard/AXP_21274_Memory.h"
+#include <sys/mman.h>
+
+/*
+ * AXP_21274_AllocateArray
+ *  This function is called to get the host memory for a memory array.  How it
+ *  is obtained depends upon the backing:
+ *
+ *      SparseBacking:      The address space is reserved, without reserving
+ *                          swap space for it (MAP_NORESERVE).  The pages are
+ *                          supplied, zeroed, when first touched.
+ *      HugeBacking:        The address space is first mapped from the host's
+ *                          pool of huge pages (MAP_HUGETLB).  If the pool does
+ *                          not have enough pages, a sparse array is used and
+ *                          the host is asked to back it with transparent huge
+ *                          pages (MADV_HUGEPAGE).
+ *      AllocateBacking:    All the memory is allocated, and zeroed, up front.
+ *
+ *  The huge page pool is mapped without MAP_NORESERVE, so that a short pool
+ *  fails here, rather than with a SIGBUS when a page is touched.
+ *
+ * Input Parameters:
+ *  size:
+ *      A value indicating the size, in bytes, of the array.
+ *  backing:
+ *      A value indicating how the host memory is to be obtained.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL:       The memory could not be obtained.
+ *  Otherwise:  A pointer to the zeroed memory array.
+ */
+u64 *AXP_21274_AllocateArray(u64 size, AXP_21264_DARRAY_BACKING backing)
+{
+    u64 len = AXP_21274_ARRAY_LEN(size);
+    void *array = MAP_FAILED;
+    u64 *retVal = NULL;
+
+    switch (backing)
+    {
+        case AllocateBacking:
+            retVal = calloc(1, size);
+            break;
+
+        case HugeBacking:
+            array = mmap(NULL,
+                         len,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                         -1,
+                         0);
+            if (array == MAP_FAILED)
+            {
+                array = mmap(NULL,
+                             len,
+                             PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                             -1,
+                             0);
+                if (array != MAP_FAILED)
+                {
+                    (void) madvise(array, len, MADV_HUGEPAGE);
+                }
+            }
+            break;
+
+        case SparseBacking:
+        default:
+            array = mmap(NULL,
+                         len,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                         -1,
+                         0);
+            break;
+    }
+    if (array != MAP_FAILED)
+    {
+        retVal = (u64 *) array;
+    }
+
+    if (AXP_UTL_OPT1)
+    {
+        AXP_TRACE_BEGIN();
+        AXP_TraceWrite("AXP_21274_AllocateArray allocated %llu bytes at "
+                       "%p (backing %d)",
+                       size,
+                       (void *) retVal,
+                       backing);
+        AXP_TRACE_END();
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21274_FreeArray
+ *  This function is called to release the host memory for a memory array,
+ *  previously obtained by AXP_21274_AllocateArray.
+ *
+ * Input Parameters:
+ *  array:
+ *      A pointer to the memory array.  This may be NULL.
+ *  size:
+ *      A value indicating the size, in bytes, of the array.
+ *  backing:
+ *      A value indicating how the host memory was obtained.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_21274_FreeArray(u64 *array,
+                         u64 size,
+                         AXP_21264_DARRAY_BACKING backing)
+{
+    if (array != NULL)
+    {
+        if (backing == AllocateBacking)
+        {
+            free(array);
+        }
+        else
+        {
+            (void) munmap(array, AXP_21274_ARRAY_LEN(size));
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21274_MapArrays
+ *  This function is called, once the memory arrays have been allocated, to
+ *  build the map used to find the host memory for a physical address.  The
+ *  arrays are one after the other in physical memory, starting at address 0.
+ *  Each map entry covers 1 << AXP_21274_MEM_MAP_SHIFT bytes, which must all
+ *  be in the same array, otherwise the addresses are treated as nonexistent
+ *  memory.
+ *
+ * Input Parameters:
+ *  array:
+ *      A pointer to the array of memory arrays.
+ *  count:
+ *      A value indicating the number of memory arrays.
+ *  size:
+ *      A value indicating the size, in bytes, of each memory array.
+ *
+ * Output Parameters:
+ *  map:
+ *      A pointer to the map, with AXP_21274_MEM_MAP_LEN entries, to be set.
+ *
+ * Return Values:
+ *  None.
+ */
+void AXP_21274_MapArrays(u8 **map, u64 **array, u32 count, u64 size)
+{
+    u64 pa, offset;
+    u64 jj;
+    int ii;
+
+    for (ii = 0; ii < AXP_21274_MEM_MAP_LEN; ii++)
+    {
+        pa = (u64) ii << AXP_21274_MEM_MAP_SHIFT;
+        jj = (size != 0) ? (pa / size) : count;
+        offset = (size != 0) ? (pa % size) : 0;
+        if ((jj < count) &&
+            (array[jj] != NULL) &&
+            ((offset + AXP_21274_MEM_MAP_MASK) < size))
+        {
+            map[ii] = (u8 *) array[jj] + offset;
+        }
+        else
+        {
+            map[ii] = NULL;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
@@ -22,11 +22,29 @@
  *
  *  V01.000 21-JAN-2018	Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001 16-Oct-2026	Jonathan D. Belanger
+ *  The memory arrays are now obtained using the configured backing, which by
+ *  default only reserves the address space, rather than allocating all of it
+ *  up front.  The arrays are also released if the system could not be
+ *  completely allocated.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Build the map of host memory for the memory arrays, and give it to the
+ *  CPUs, so that they can read and write memory blocks directly.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Each CPU is given its own request queue, and the event count used to wake
+ *  the Cchip, instead of the Cchip's mutex and condition variable.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped a line longer than 80 columns.
  */
 #include "CommonUtilities/AXP_Configure.h"
 #include "CommonUtilities/AXP_Utility.h"
 #include "CommonUtilities/AXP_Blocks.h"
 #include "Motherboard/AXP_21274_System.h"
+#include "Motherboard/AXP_21274_Memory.h"
 #include "Motherboard/Cchip/AXP_21274_Cchip.h"
 #include "Motherboard/Dchip/AXP_21274_Dchip.h"
 #include "Motherboard/Pchip/AXP_21274_Pchip.h"
@@ -35,6 +53,7 @@
 AXP_21274_SYSTEM *AXP_21274_AllocateSystem(void)
 {
     AXP_21274_SYSTEM *sys;
+    AXP_21274_RQ_ENTRY *rq;
     void *cpu[AXP_21274_MAX_CPUS];
     int pthreadRet;
     int ii;
@@ -43,11 +62,7 @@ AXP_21274_SYSTEM *AXP_21274_AllocateSystem(void)
     sys = AXP_Allocate_Block(AXP_21274_SYS_BLK);
     if (sys != NULL)
     {
-        pthreadRet = pthread_mutex_init(&sys->cChipMutex, NULL);
-        if (pthreadRet == 0)
-        {
-            pthreadRet = pthread_mutex_init(&sys->memMutex, NULL);
-        }
+        pthreadRet = pthread_mutex_init(&sys->memMutex, NULL);
         if (pthreadRet == 0)
         {
             pthreadRet = pthread_mutex_init(&sys->p0.mutex, NULL);
@@ -58,15 +73,16 @@ AXP_21274_SYSTEM *AXP_21274_AllocateSystem(void)
         }
         if (pthreadRet == 0)
         {
-            pthreadRet = pthread_cond_init(&sys->cChipCond, NULL);
+            pthreadRet = pthread_cond_init(&sys->p0.cond, NULL);
         }
         if (pthreadRet == 0)
         {
-            pthreadRet = pthread_cond_init(&sys->p0.cond, NULL);
+            pthreadRet = pthread_cond_init(&sys->p1.cond, NULL);
         }
         if (pthreadRet == 0)
         {
-            pthreadRet = pthread_cond_init(&sys->p1.cond, NULL);
+            pthreadRet =
+                (AXP_EventCount_Init(&sys->cChipEvent) == true) ? 0 : -1;
         }
 
         /*
@@ -92,6 +108,7 @@ AXP_21274_SYSTEM *AXP_21274_AllocateSystem(void)
                          * initialize the information needed for the System to
                          * be able to communicate with the CPU.
                          */
+                        rq = &sys->skidBuffers[ii * AXP_21274_CCHIP_RQ_LEN];
                         AXP_21264_Save_SystemInterfaces(cpu[ii],
                                                         &sys->cpu[ii].mutex,
                                                         &sys->cpu[ii].cond,
@@ -99,9 +116,9 @@ AXP_21274_SYSTEM *AXP_21274_AllocateSystem(void)
                                                         &sys->cpu[ii].pqTop,
                                                         &sys->cpu[ii].pqBottom,
                                                         &sys->cpu[ii].irq_H,
-                                                        &sys->cChipMutex,
-                                                        &sys->cChipCond,
-                                                        &sys->skidBufferQ);
+                                                        &sys->cpuRq[ii],
+                                                        &sys->cChipEvent,
+                                                        rq);
                     }
                     else
                     {
@@ -122,23 +139,47 @@ AXP_21274_SYSTEM *AXP_21274_AllocateSystem(void)
         if (qRet == true)
         {
             AXP_ConfigGet_DarrayInfo(&sys->arrayCount, &sys->arraySizes);
+            sys->arrayBacking = AXP_ConfigGet_DarrayBacking();
 
             /*
              * Now that we know the sizes, go and allocate the individual
              * arrays.  Each array contains a contiguous memory address space.
+             * Unless configured otherwise, the host only supplies memory for
+             * the pages the emulation actually touches.
              */
             for (ii = 0; ii < AXP_21274_MAX_ARRAYS; ii++)
             {
                 if (ii < sys->arrayCount)
                 {
-                    sys->array[ii] = AXP_Allocate_Block(-sys->arraySizes,
-                                                        sys->array[ii]);
+                    sys->array[ii] = AXP_21274_AllocateArray(sys->arraySizes,
+                                                             sys->arrayBacking);
+                    if (sys->array[ii] == NULL)
+                    {
+                        qRet = false;
+                    }
                 }
                 else
                 {
                     sys->array[ii] = NULL;
                 }
             }
+
+            /*
+             * Build the map used to find the host memory for a physical
+             * address, and let the CPUs have it.  When there is only one CPU,
+             * there is no other CPU to be probed, and the CPU can read and
+             * write memory blocks directly.
+             */
+            AXP_21274_MapArrays(sys->memMap,
+                                sys->array,
+                                sys->arrayCount,
+                                sys->arraySizes);
+            for (ii = 0; ii < sys->cpuCount; ii++)
+            {
+                AXP_21264_Save_MemoryMap(cpu[ii],
+                                         sys->memMap,
+                                         (sys->cpuCount == 1));
+            }
         }
 
         /*
@@ -192,6 +233,12 @@ AXP_21274_SYSTEM *AXP_21274_AllocateSystem(void)
                 AXP_Deallocate_Block(cpu[ii]);
             }
         }
+        for (ii = 0; ii < AXP_21274_MAX_ARRAYS; ii++)
+        {
+            AXP_21274_FreeArray(sys->array[ii],
+                                sys->arraySizes,
+                                sys->arrayBacking);
+        }
         AXP_Deallocate_Block(sys);
         sys = NULL;
     }
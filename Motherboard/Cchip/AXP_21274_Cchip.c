@@ -53,11 +53,25 @@
  *  request from the CPU, and initialize the response to the CPU.  The Cchip
  *  loop will send this response to the appropriate CPU upon return from the
  *  read and write.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Memory blocks are now found using the map of host memory for the memory
+ *  arrays, and the responses to memory reads and writes are sent to the CPU.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Requests are taken from each CPU's request queue, in turn, and memory reads
+ *  and writes are handed to memory worker threads.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Use a pointer to each request entry when initializing them, rather than
+ *  indexing the skid buffers for every field.
  */
 #include "Motherboard/AXP_21274_System.h"
 #include "Motherboard/Cchip/AXP_21274_Cchip.h"
 #include "Motherboard/Cchip/CPUInterface/AXP_21274_21264_Common.h"
 #include "Motherboard/AXP_21274_AddressMapping.h"
+#include "Motherboard/AXP_21274_Memory.h"
+#include <sched.h>
 
 /*
  * Local Prototypes
@@ -87,6 +101,11 @@ static void AXP_21274_ReadTIG(AXP_21274_SYSTEM *,
 static void AXP_21274_WriteTIG(AXP_21274_SYSTEM *,
                                AXP_21274_RQ_ENTRY *,
                                AXP_21274_SYSBUS_CPU *);
+static void AXP_21274_ProcessMem(AXP_21274_SYSTEM *, AXP_21274_RQ_ENTRY *);
+static void *AXP_21274_MemWorker(void *);
+static void AXP_21274_MemDrain(AXP_21274_SYSTEM *);
+static bool AXP_21274_UpdateIRQ(AXP_21274_SYSTEM *);
+static bool AXP_21274_Dispatch(AXP_21274_SYSTEM *, AXP_21274_RQ_ENTRY *);
 
 /*
  * AXP_21274_ReadCCSR
@@ -1085,20 +1104,16 @@ static void AXP_21274_WritePIO(AXP_21274_SYSTEM *sys,
 static void AXP_21274_ReadMem(AXP_21274_SYSTEM *sys, AXP_21274_RQ_ENTRY *rq,
         AXP_21274_SYSBUS_CPU *rsp)
 {
-    AXP_21274_SYSTEM_MEMADDR memAddr =
-    {
-        .addr = rq->pa
-    };
+    u64 pa = rq->pa & ~((u64) sizeof(rsp->sysData) - 1);
+    u8 *block = AXP_21274_MEM_HOST(sys->memMap, pa);
 
     /*
      * TODO:    These should be in the Dchip.
      */
 
-    if (memAddr.quadAddr.index < sys->memSize)
+    if (block != NULL)
     {
-        memcpy(rsp->sysData,
-               &sys->memory[memAddr.quadAddr.index],
-              (sizeof(u64) * AXP_21274_DATA_SIZE));
+        memcpy(rsp->sysData, block, sizeof(rsp->sysData));
         switch (rq->cmd)
         {
             case ReadBlk:
@@ -1127,6 +1142,7 @@ static void AXP_21274_ReadMem(AXP_21274_SYSTEM *sys, AXP_21274_RQ_ENTRY *rq,
         rsp->sysDc = ReadDataError;
     }
     rsp->id = rq->entry;
+    rsp->pa = rq->pa;
 
     /*
      * Return back to the caller.
@@ -1158,23 +1174,21 @@ static void AXP_21274_WriteMem(AXP_21274_SYSTEM *sys,
                                AXP_21274_RQ_ENTRY *rq,
                                AXP_21274_SYSBUS_CPU *rsp)
 {
-    AXP_21274_SYSTEM_MEMADDR memAddr =
-    {
-        .addr = rq->pa
-    };
+    u64 pa = rq->pa & ~((u64) sizeof(rq->sysData) - 1);
+    u8 *block = AXP_21274_MEM_HOST(sys->memMap, pa);
 
     /*
      * TODO:    These should be in the Dchip.
      */
-    if (memAddr.quadAddr.index < sys->memSize)
+    if (block != NULL)
     {
-        memcpy(&sys->memory[memAddr.quadAddr.index],
-               rq->sysData,
-               (sizeof(u64) * AXP_21274_DATA_SIZE));
+        memcpy(block, rq->sysData, sizeof(rq->sysData));
     }
     else
         ; /* TODO: NXM error */
     rsp->id = rq->entry;
+    rsp->pa = rq->pa;
+    rsp->rvb = true;
     rsp->sysDc = WriteData;
 
     /*
@@ -1265,6 +1279,8 @@ static void AXP_21274_WriteTIG(AXP_21274_SYSTEM *sys,
  */
 void AXP_21274_CchipInit(AXP_21274_SYSTEM *sys)
 {
+    AXP_21274_RQ_ENTRY *rq;
+    long nproc;
     u32 hh, ii, jj;
 
     /*
@@ -1607,37 +1623,55 @@ void AXP_21274_CchipInit(AXP_21274_SYSTEM *sys)
     sys->cmoncnt23.ecnt2 = 0;
 
     /*
-     * Initialize the request queue.
+     * Initialize the request queues.  Each CPU has its own queue, and its own
+     * set of request entries, which it owns until the Cchip is done with them.
      */
-    AXP_INIT_QUE(sys->skidBufferQ);
-    sys->skidLastUsed = 0;
     for (hh = 0; hh < AXP_21274_MAX_CPUS; hh++)
     {
+        AXP_SPSCRing_Init(&sys->cpuRq[hh]);
         for (ii = 0; ii < AXP_21274_CCHIP_RQ_LEN; ii++)
         {
+            rq = &sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii];
             for (jj = 0; jj < AXP_21274_DATA_SIZE; jj++)
             {
-                sys->skidBuffers[ii].sysData[jj] = 0;
+                rq->sysData[jj] = 0;
             }
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].mask = 0;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].pa = 0;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].cmd =
-                Sysbus_NOP;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].status =
-                HitClean;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].phase = phase0;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].entry = 0;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].cpuID = 0;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].sysDataLen = 0;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].waitVector = 0;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].miss2 = false;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].rqValid =
-                false;
-            sys->skidBuffers[(hh * AXP_21274_CCHIP_RQ_LEN) + ii].cacheHit =
-                false;
+            rq->mask = 0;
+            rq->pa = 0;
+            rq->cmd = Sysbus_NOP;
+            rq->status = HitClean;
+            rq->phase = phase0;
+            rq->entry = 0;
+            rq->cpuID = hh;
+            rq->sysDataLen = 0;
+            rq->waitVector = 0;
+            rq->miss1 = false;
+            rq->miss2 = false;
+            rq->rqValid = false;
+            rq->cacheHit = false;
+            rq->inUse = false;
         }
     }
 
+    /*
+     * Memory reads and writes are handed to a memory worker for each host
+     * processor, up to the maximum.  With only the one host processor, the
+     * Cchip does them itself.
+     */
+    nproc = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nproc <= 1)
+    {
+        sys->memWorkerCount = 0;
+    }
+    else if (nproc < AXP_21274_MAX_MEM_WORKERS)
+    {
+        sys->memWorkerCount = nproc;
+    }
+    else
+    {
+        sys->memWorkerCount = AXP_21274_MAX_MEM_WORKERS;
+    }
+
     /*
      * Return back to the caller.
      */
@@ -1645,15 +1679,17 @@ void AXP_21274_CchipInit(AXP_21274_SYSTEM *sys)
 }
 
 /*
- * AXP_21274_Cchip_Main
- *  This is the main function for the Cchip.  It looks at its queues to
- *  determine if there is anything that needs to be processed from the CPUs or
- *  devices (PCI).
+ * AXP_21274_ProcessMem
+ *  This function is called to read or write a memory block for a CPU request,
+ *  and send the response back to the CPU.  This is called by the memory
+ *  workers, or by the Cchip itself when there are none.
  *
  * Input Parameters:
  *  sys:
  *      A pointer to the System structure for the emulated DECchip 21272/21274
  *      chipsets.
+ *  rq:
+ *      A pointer to the request to be processed.
  *
  * Output Parameters:
  *  None.
@@ -1661,314 +1697,556 @@ void AXP_21274_CchipInit(AXP_21274_SYSTEM *sys)
  * Return Value:
  *  None.
  */
-void *AXP_21274_CchipMain(void *voidPtr)
+static void AXP_21274_ProcessMem(AXP_21274_SYSTEM *sys, AXP_21274_RQ_ENTRY *rq)
 {
-    AXP_21274_SYSTEM *sys = (AXP_21274_SYSTEM *) voidPtr;
-    AXP_21274_RQ_ENTRY *rq;
     AXP_21274_SYSBUS_CPU rsp;
-    int ii;
+    u8 cpuID = rq->cpuID;
+
+    memset(&rsp, 0, sizeof(rsp));
+    if ((rq->cmd == WrVictimBlk) || (rq->cmd == CleanVictimBlk))
+    {
+        AXP_21274_WriteMem(sys, rq, &rsp);
+    }
+    else
+    {
+        AXP_21274_ReadMem(sys, rq, &rsp);
+    }
 
     /*
-     * Log that we are starting.
+     * The request entry is given back to the CPU before the response is sent,
+     * because a Cbox waiting for a free entry does so with the mutex that
+     * sending the response needs locked.
      */
-    if (AXP_SYS_CALL)
+    __atomic_store_n(&rq->inUse, false, __ATOMIC_RELEASE);
+    if (cpuID < sys->cpuCount)
     {
-        AXP_TRACE_BEGIN();
-        AXP_TraceWrite("Cchip is starting");
-        AXP_TRACE_END();
+        AXP_21264_SendToCPU(&rsp, &sys->cpu[cpuID]);
     }
 
     /*
-     * First lock the Cchips mutex so that we can make sure to coordinate
-     * access to the Cchip's queues.
+     * Return back to the caller.
      */
-    pthread_mutex_lock(&sys->cChipMutex);
+    return;
+}
+
+/*
+ * AXP_21274_MemWorker
+ *  This is the main function for a memory worker.  It reads and writes the
+ *  memory blocks handed to it by the Cchip.  All the requests for a particular
+ *  block are handed to the same worker, so they are completed in the order in
+ *  which the Cchip received them.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      A pointer to the memory worker structure.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void *AXP_21274_MemWorker(void *voidPtr)
+{
+    AXP_21274_MEM_WORKER *worker = (AXP_21274_MEM_WORKER *) voidPtr;
+    AXP_21274_SYSTEM *sys = (AXP_21274_SYSTEM *) worker->sys;
+    AXP_SPSC_SLOT slot;
+    u32 key;
 
     /*
      * TODO: Need to determine what the end condition for this loop should be.
      */
     while (true)
     {
+        key = AXP_EventCount_Prepare(&worker->event);
+        if (AXP_SPSCRing_Get(&worker->rq, &slot) == true)
+        {
+            AXP_21274_ProcessMem(sys, (AXP_21274_RQ_ENTRY *) slot.item);
+            __atomic_store_n(&worker->done, worker->done + 1, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            AXP_EventCount_Wait(&worker->event, key);
+        }
+    }
+
+    /*
+     * We never get here.
+     */
+    return (NULL);
+}
+
+/*
+ * AXP_21274_MemDrain
+ *  This function is called by the Cchip, before processing a request that
+ *  must follow all the memory reads and writes before it (such as a memory
+ *  barrier or a probe response), to wait for the memory workers to complete
+ *  all the requests they have been handed.
+ *
+ * Input Parameters:
+ *  sys:
+ *      A pointer to the System structure for the emulated DECchip 21272/21274
+ *      chipsets.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void AXP_21274_MemDrain(AXP_21274_SYSTEM *sys)
+{
+    AXP_21274_MEM_WORKER *worker;
+    u32 ii;
+
+    for (ii = 0; ii < sys->memWorkerCount; ii++)
+    {
+        worker = &sys->memWorker[ii];
+        while (__atomic_load_n(&worker->done, __ATOMIC_ACQUIRE) !=
+               worker->queued)
+        {
+            sched_yield();
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * AXP_21274_UpdateIRQ
+ *  This function is called after the Cchip has processed requests that may
+ *  have changed the interrupt state, to make sure the IRQ bits are set
+ *  accordingly.  If they change, then the appropriate CPU is signaled.
+ *
+ * Input Parameters:
+ *  sys:
+ *      A pointer to the System structure for the emulated DECchip 21272/21274
+ *      chipsets.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The IRQ bits for all the CPUs have been updated.
+ *  false:  One or more CPUs were busy, and need to be updated later.
+ */
+static bool AXP_21274_UpdateIRQ(AXP_21274_SYSTEM *sys)
+{
+    bool retVal = true;
+    int ii;
+
+    for(ii = 0; ii < sys->cpuCount; ii++)
+    {
+        u8 curIrqH;
+        u8 cpuBit = 1 << ii;
 
         /*
-         * The Cchip performs the following functions:
-         *   - Accepts requests from the Pchips and the CPUs
-         *   - Orders the arriving requests as required
-         *   - Selects among the requests to issue controls to the DRAMs
-         *   - Issues probes to the CPUs as appropriate to the selected requests
-         *   - Translates CPU PIO addresses to PCI and CSR addresses
-         *   - Issues commands to the Pchip as appropriate to the selected (PIO
-         *     or PTP) requests
-         *   - Issues responses to the Pchip and CPU as appropriate to the
-         *     issued requests
-         *   - Issues controls to the Dchip as appropriate to the DRAM accesses,
-         *     and the probe and Pchip responses
-         *   - Controls the TIGbus to manage interrupts, and maintains CSRs
-         *     including those that represent interrupt status
-         *
-         * This first thing we need to do is wait for something to arrive to be
-         * processed.
+         * Don't let the CPU try and read or modify the IRQ_H bits until we
+         * are done setting them.  A Cbox waiting for one of its request
+         * entries to be freed does so with this mutex locked, so if the CPU
+         * is busy, we leave it for the next time around.
          */
-        while AXP_QUE_EMPTY(sys->skidBufferQ)
+        if (pthread_mutex_trylock(sys->cpu[ii].mutex) != 0)
         {
-            pthread_cond_wait(&sys->cChipCond, &sys->cChipMutex);
+            retVal = false;
+            continue;
         }
 
         /*
-         * We have something to process.
+         * Save the current value of the IRQ_H bits.
          */
-        rq = (AXP_21274_RQ_ENTRY *) sys->skidBufferQ.flink;
-        AXP_REMQUE(&rq->header);
+        curIrqH = *sys->cpu[ii].irq_H;
 
         /*
-         * At this point, we can unlock the Cchip mutex so that other threads
-         * can send requests to the Cchip.  We'll lock it before we mark the
-         * request to be processed as no longer in use.
+         * If NXM is set or TIG interrupt bits 62 or 61 (Pchip0 and Pchip1,
+         * respectively) are set, then IRQ<0> is set.
          */
-        pthread_mutex_unlock(&sys->cChipMutex);
+        if (sys->misc.nxm == 1)
+        {
+            *sys->cpu[ii].irq_H |= 1;
+        }
+        else
+        {
+            *sys->cpu[ii].irq_H &= 0xfe;
+        }
 
         /*
-         * Determine what has been requested and make the call needed to
-         * complete request.
+         * DRIR is ANDed with the CPU specific MASK bits DIRn and if the
+         * result is non-zero, then IRQ<1> is set.  If DEVSUP is set for
+         * this CPU, then setting of this bit is suppressed for this cycle.
          */
-        switch (rq->cmd)
+        if ((sys->misc.devSup & cpuBit) == 0)
         {
+            bool setBit = false;
+            u64 dir;
 
             /*
-             * A CPU responded to a probe request form the system.  There
-             * should be another request being processed in the request queue.
+             * Determine which mask to use and determine if the IRQ<1> bit
+             * for this CPU should be set.
              */
-            case ProbeResponse:
-                break;
+            switch (ii)
+            {
+                case 0:
+                    AXP_CCHIP_READ_DIR0(dir, sys);
+                    setBit = (sys->drir & dir) != 0;
+                    break;
 
-            /*
-             * These are no-ops and can be ignored.
-             */
-            case Sysbus_NOP:
-            case NZNOP:
-                break;
+                case 1:
+                    AXP_CCHIP_READ_DIR1(dir, sys);
+                    setBit = (sys->drir & dir) != 0;
+                    break;
 
-            /*
-             * The CPU has requested that a Victim block be flushed.
-             */
-            case VDBFlushRequest:
-                break;
+                case 2:
+                    AXP_CCHIP_READ_DIR2(dir, sys);
+                    setBit = (sys->drir & dir) != 0;
+                    break;
 
-            /*
-             * These are Memory access requests.  These are requests to and
-             * from memory.
-             */
-            case WrVictimBlk:
-            case CleanVictimBlk:
-                AXP_21274_WriteMem(sys, rq, &rsp);
-                break;
+                case 3:
+                    AXP_CCHIP_READ_DIR3(dir, sys);
+                    setBit = (sys->drir & dir) != 0;
+                    break;
+            }
 
             /*
-             * These are control messages for the caches and memory.  It makes
-             * sure that all memory access, reads and writes, initiated prior
-             * to the MB are completed and that the block in question is
-             * evicted from the cache.
-             */
-            case Evict:
-            case Sysbus_MB:
-                break;
+            * If the bit should be set, then do so now.
+            */
+            if (setBit)
+            {
+                *sys->cpu[ii].irq_H |= 2;
+            }
+            else
+            {
+                *sys->cpu[ii].irq_H &= 0xfd;
+            }
+        }
+        else
+        {
 
             /*
-             * These are PIO requests.  These are requests to and from CSRs and
-             * I/O Devices.
+             * Clear the IRQ<1> bit for this CPU.
              */
-            case ReadBytes:
-            case ReadLWs:
-            case ReadQWs:
-                sys->misc.cpuID = rq->cpuID & 0x3; /* CPU performing read */
-                AXP_21274_ReadPIO(sys, rq, &rsp);
-                sys->misc.cpuID = 0;
-                break;
-
-            case WrBytes:
-            case WrLWs:
-            case WrQWs:
-                AXP_21274_WritePIO(sys, rq, &rsp);
-                break;
+            *sys->cpu[ii].irq_H &= 0xfd;
+        }
 
-            /*
-             * These are Memory access requests.  These are requests to and
-             * from memory.
-             */
-            case ReadBlk:
-            case ReadBlkMod:
-            case ReadBlkI:
-            case FetchBlk:
-            case ReadBlkSpec:
-            case ReadBlkModSpec:
-            case ReadBlkSpecI:
-            case FetchBlkSpec:
-            case ReadBlkVic:
-            case ReadBlkModVic:
-            case ReadBlkVicI:
-                sys->misc.cpuID = rq->cpuID & 0x3; /* CPU performing read */
-                AXP_21274_ReadMem(sys, rq, &rsp);
-                sys->misc.cpuID = 0;
-                break;
+        /*
+         * If ITINTR is set for this CPU, then IRQ<2> is set.
+         */
+        if ((sys->misc.itintr & cpuBit) == cpuBit)
+        {
+            *sys->cpu[ii].irq_H |= 4;
+        }
+        else
+        {
+            *sys->cpu[ii].irq_H &= 0xfb;
+        }
 
-            /*
-             * These are cache state change requests.
-             */
-            case InvalToDirtyVic:
-            case CleanToDirty:
-            case SharedToDirty:
-            case STCChangeToDirty:
-            case InvalToDirty:
-                break;
+        /*
+         * If IPINTR is set for this CPU, then IRQ<3> is set.
+         */
+        if ((sys->misc.ipintr & cpuBit) == cpuBit)
+        {
+            *sys->cpu[ii].irq_H |= 8;
+        }
+        else
+        {
+            *sys->cpu[ii].irq_H &= 0xf7;
         }
 
         /*
-         * Before we go back to see if there is anything to process, let's make
-         * sure the IRQ bits are set accordingly.  If they change, then the
-         * appropriate CPU should be signaled.
+         * Finally, if the IRQ_H bit changed, then we need to signal the
+         * CPU to process them.
          */
-        for(ii = 0; ii < sys->cpuCount; ii++)
+        if (curIrqH != *sys->cpu[ii].irq_H)
         {
-            u8 curIrqH;
-            u8 cpuBit = 1 << ii;
+            pthread_cond_signal(sys->cpu[ii].cond);
+        }
 
-            /*
-             * Don't let the CPU try and read or modify the IRQ_H bits until we
-             * are done setting them.
-             */
-            pthread_mutex_lock(sys->cpu[ii].mutex);
+        /*
+         * OK, we are done with this CPU, unlock its mutex and move onto
+         * the next.
+         */
+        pthread_mutex_unlock(sys->cpu[ii].mutex);
+    }
 
-            /*
-             * Save the current value of the IRQ_H bits.
-             */
-            curIrqH = *sys->cpu[ii].irq_H;
+    /*
+     * Once all the CPUs have been updated, clear the bits that indicated an
+     * interrupt needed to be sent or suppressed to the CPUs.
+     */
+    if (retVal == true)
+    {
+        sys->misc.devSup = 0;
+        sys->misc.itintr = 0;
+        sys->misc.ipreq = 0;
+    }
 
-            /*
-             * If NXM is set or TIG interrupt bits 62 or 61 (Pchip0 and Pchip1,
-             * respectively) are set, then IRQ<0> is set.
-             */
-            if (sys->misc.nxm == 1)
-            {
-                *sys->cpu[ii].irq_H |= 1;
-            }
-            else
-            {
-                *sys->cpu[ii].irq_H &= 0xfe;
-            }
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
 
-            /*
-             * DRIR is ANDed with the CPU specific MASK bits DIRn and if the
-             * result is non-zero, then IRQ<1> is set.  If DEVSUP is set for
-             * this CPU, then setting of this bit is suppressed for this cycle.
-             */
-            if ((sys->misc.devSup & cpuBit) == 0)
-            {
-                bool setBit = false;
-                u64 dir;
-
-                /*
-                 * Determine which mask to use and determine if the IRQ<1> bit
-                 * for this CPU should be set.
-                 */
-                switch (ii)
-                {
-                    case 0:
-                        AXP_CCHIP_READ_DIR0(dir, sys);
-                        setBit = (sys->drir & dir) != 0;
-                        break;
-
-                    case 1:
-                        AXP_CCHIP_READ_DIR1(dir, sys);
-                        setBit = (sys->drir & dir) != 0;
-                        break;
-
-                    case 2:
-                        AXP_CCHIP_READ_DIR2(dir, sys);
-                        setBit = (sys->drir & dir) != 0;
-                        break;
-
-                    case 3:
-                        AXP_CCHIP_READ_DIR3(dir, sys);
-                        setBit = (sys->drir & dir) != 0;
-                        break;
-                }
+/*
+ * AXP_21274_Dispatch
+ *  This function is called by the Cchip with each request taken from a CPU's
+ *  request queue.  Memory reads and writes are handed to the memory worker for
+ *  the block (or processed here, when there are no workers).  Everything else
+ *  is processed here, in the order received.
+ *
+ * Input Parameters:
+ *  sys:
+ *      A pointer to the System structure for the emulated DECchip 21272/21274
+ *      chipsets.
+ *  rq:
+ *      A pointer to the request to be processed.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   The request may have changed the interrupt state.
+ *  false:  The request did not change the interrupt state.
+ */
+static bool AXP_21274_Dispatch(AXP_21274_SYSTEM *sys, AXP_21274_RQ_ENTRY *rq)
+{
+    AXP_21274_MEM_WORKER *worker;
+    AXP_21274_SYSBUS_CPU rsp;
+    bool retVal = false;
 
-                /*
-                * If the bit should be set, then do so now.
-                */
-                if (setBit)
-                {
-                    *sys->cpu[ii].irq_H |= 2;
-                }
-                else
-                {
-                    *sys->cpu[ii].irq_H &= 0xfd;
-                }
-            }
-            else
-            {
+    memset(&rsp, 0, sizeof(rsp));
+    switch (rq->cmd)
+    {
 
-                /*
-                 * Clear the IRQ<1> bit for this CPU.
-                 */
-                *sys->cpu[ii].irq_H &= 0xfd;
-            }
+        /*
+         * These are no-ops and can be ignored.
+         */
+        case Sysbus_NOP:
+        case NZNOP:
+            __atomic_store_n(&rq->inUse, false, __ATOMIC_RELEASE);
+            break;
 
-            /*
-             * If ITINTR is set for this CPU, then IRQ<2> is set.
-             */
-            if ((sys->misc.itintr & cpuBit) == cpuBit)
+        /*
+         * These are Memory access requests.  These are requests to and
+         * from memory.
+         */
+        case WrVictimBlk:
+        case CleanVictimBlk:
+        case ReadBlk:
+        case ReadBlkMod:
+        case ReadBlkI:
+        case FetchBlk:
+        case ReadBlkSpec:
+        case ReadBlkModSpec:
+        case ReadBlkSpecI:
+        case FetchBlkSpec:
+        case ReadBlkVic:
+        case ReadBlkModVic:
+        case ReadBlkVicI:
+            if (sys->memWorkerCount > 0)
             {
-                *sys->cpu[ii].irq_H |= 4;
+                worker = &sys->memWorker[AXP_21274_MEM_SHARD(
+                    rq->pa,
+                    sys->memWorkerCount)];
+                worker->queued++;
+                while (AXP_SPSCRing_Put(&worker->rq, rq, rq->cpuID) == false)
+                {
+                    sched_yield();
+                }
+                AXP_EventCount_Signal(&worker->event);
             }
             else
             {
-                *sys->cpu[ii].irq_H &= 0xfb;
+                AXP_21274_ProcessMem(sys, rq);
             }
+            break;
 
-            /*
-             * If IPINTR is set for this CPU, then IRQ<3> is set.
-             */
-            if ((sys->misc.ipintr & cpuBit) == cpuBit)
-            {
-                *sys->cpu[ii].irq_H |= 8;
-            }
-            else
-            {
-                *sys->cpu[ii].irq_H &= 0xf7;
-            }
+        /*
+         * These are PIO requests.  These are requests to and from CSRs and
+         * I/O Devices.
+         */
+        case ReadBytes:
+        case ReadLWs:
+        case ReadQWs:
+            sys->misc.cpuID = rq->cpuID & 0x3; /* CPU performing read */
+            AXP_21274_ReadPIO(sys, rq, &rsp);
+            sys->misc.cpuID = 0;
+            __atomic_store_n(&rq->inUse, false, __ATOMIC_RELEASE);
+            retVal = true;
+            break;
 
-            /*
-             * Finally, if the IRQ_H bit changed, then we need to signal the
-             * CPU to process them.
-             */
-            if (curIrqH != *sys->cpu[ii].irq_H)
+        case WrBytes:
+        case WrLWs:
+        case WrQWs:
+            AXP_21274_WritePIO(sys, rq, &rsp);
+            __atomic_store_n(&rq->inUse, false, __ATOMIC_RELEASE);
+            retVal = true;
+            break;
+
+        /*
+         * A CPU responded to a probe request form the system.  There
+         * should be another request being processed in the request queue.
+         *
+         * The CPU has requested that a Victim block be flushed.
+         *
+         * These are control messages for the caches and memory.  It makes
+         * sure that all memory access, reads and writes, initiated prior
+         * to the MB are completed and that the block in question is
+         * evicted from the cache.
+         *
+         * These are cache state change requests.
+         *
+         * All of these must follow the memory reads and writes that came
+         * before them.
+         */
+        case ProbeResponse:
+        case VDBFlushRequest:
+        case Evict:
+        case Sysbus_MB:
+        case InvalToDirtyVic:
+        case CleanToDirty:
+        case SharedToDirty:
+        case STCChangeToDirty:
+        case InvalToDirty:
+        default:
+            AXP_21274_MemDrain(sys);
+            __atomic_store_n(&rq->inUse, false, __ATOMIC_RELEASE);
+            retVal = true;
+            break;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * AXP_21274_Cchip_Main
+ *  This is the main function for the Cchip.  It starts the memory workers,
+ *  then looks at the request queue for each CPU, in turn, to determine if
+ *  there is anything that needs to be processed.
+ *
+ * Input Parameters:
+ *  sys:
+ *      A pointer to the System structure for the emulated DECchip 21272/21274
+ *      chipsets.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+void *AXP_21274_CchipMain(void *voidPtr)
+{
+    AXP_21274_SYSTEM *sys = (AXP_21274_SYSTEM *) voidPtr;
+    AXP_21274_MEM_WORKER *worker;
+    AXP_SPSC_SLOT slot;
+    bool found;
+    bool irqPending = false;
+    u32 key;
+    u32 ii;
+
+    /*
+     * Log that we are starting.
+     */
+    if (AXP_SYS_CALL)
+    {
+        AXP_TRACE_BEGIN();
+        AXP_TraceWrite("Cchip is starting with %u memory workers",
+                       sys->memWorkerCount);
+        AXP_TRACE_END();
+    }
+
+    /*
+     * Start the memory workers.  If one cannot be started, we go with the
+     * ones that were.
+     */
+    for (ii = 0; ii < sys->memWorkerCount; ii++)
+    {
+        worker = &sys->memWorker[ii];
+        AXP_SPSCRing_Init(&worker->rq);
+        worker->sys = sys;
+        worker->queued = worker->done = 0;
+        if ((AXP_EventCount_Init(&worker->event) == false) ||
+            (pthread_create(&worker->threadID,
+                            NULL,
+                            AXP_21274_MemWorker,
+                            worker) != 0))
+        {
+            break;
+        }
+    }
+    sys->memWorkerCount = ii;
+
+    /*
+     * TODO: Need to determine what the end condition for this loop should be.
+     */
+    while (true)
+    {
+
+        /*
+         * The Cchip performs the following functions:
+         *   - Accepts requests from the Pchips and the CPUs
+         *   - Orders the arriving requests as required
+         *   - Selects among the requests to issue controls to the DRAMs
+         *   - Issues probes to the CPUs as appropriate to the selected requests
+         *   - Translates CPU PIO addresses to PCI and CSR addresses
+         *   - Issues commands to the Pchip as appropriate to the selected (PIO
+         *     or PTP) requests
+         *   - Issues responses to the Pchip and CPU as appropriate to the
+         *     issued requests
+         *   - Issues controls to the Dchip as appropriate to the DRAM accesses,
+         *     and the probe and Pchip responses
+         *   - Controls the TIGbus to manage interrupts, and maintains CSRs
+         *     including those that represent interrupt status
+         *
+         * Get the key for waiting before looking at the queues, so that a
+         * request that arrives after we looked will wake us.  Then take one
+         * request from each CPU, in turn, so that one busy CPU does not keep
+         * the others waiting.
+         */
+        key = AXP_EventCount_Prepare(&sys->cChipEvent);
+        found = false;
+        for (ii = 0; ii < sys->cpuCount; ii++)
+        {
+            if (AXP_SPSCRing_Get(&sys->cpuRq[ii], &slot) == true)
             {
-                pthread_cond_signal(sys->cpu[ii].cond);
+                found = true;
+                if (AXP_21274_Dispatch(sys, (AXP_21274_RQ_ENTRY *) slot.item))
+                {
+                    irqPending = true;
+                }
             }
-
-            /*
-             * OK, we are done with this CPU, unlock its mutex and move onto
-             * the next.
-             */
-            pthread_mutex_unlock(sys->cpu[ii].mutex);
         }
 
         /*
-         * Clear the bits that indicated an interrupt needed to be sent or
-         * suppressed to the CPUs.
+         * If anything was processed that might have changed the interrupt
+         * state, let's make sure the IRQ bits are set accordingly.
          */
-        sys->misc.devSup = 0;
-        sys->misc.itintr = 0;
-        sys->misc.ipreq = 0;
+        if (irqPending == true)
+        {
+            irqPending = !AXP_21274_UpdateIRQ(sys);
+        }
 
         /*
-         * At this point, we have to relock the Cchip mutex so that other
-         * threads don't interrupt the Cchip while it is using memory that is
-         * accessed and potentially updated by other threads.
+         * If there was nothing to process, wait for something to arrive.  If
+         * a CPU was too busy to have its IRQ bits updated, we only give it a
+         * chance to finish what it is doing.
          */
-        rq->inUse = false;
-        pthread_mutex_lock(&sys->cChipMutex);
+        if (found == false)
+        {
+            if (irqPending == true)
+            {
+                sched_yield();
+            }
+            else
+            {
+                AXP_EventCount_Wait(&sys->cChipEvent, key);
+            }
+        }
     }
 
     /*
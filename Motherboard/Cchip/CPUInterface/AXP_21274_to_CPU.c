@@ -23,6 +23,13 @@
  *
  *  V01.000 30-Mar2018  Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  The whole data block is now copied into the PQ entry, and the all-ones
+ *  pattern no longer overruns it.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Responses are not probes, so the probe field is cleared.
  */
 #include "Motherboard/Cchip/CPUInterface/AXP_21274_21264_Common.h"
 #include "CommonUtilities/AXP_Utility.h"
@@ -64,6 +71,7 @@ void AXP_21264_SendToCPU(AXP_21274_SYSBUS_CPU *msg, AXP_21274_CPU *cpu)
      * Copy the data from the System structure and into the CPU structure.
      */
     pq->pa = msg->pa;
+    pq->probe = 0;
     pq->sysDc = msg->sysDc;
     pq->probeStatus = HitClean; /* Just initializing */
     pq->rvb = msg->rvb;
@@ -79,7 +87,7 @@ void AXP_21264_SendToCPU(AXP_21274_SYSBUS_CPU *msg, AXP_21274_CPU *cpu)
     switch (msg->sysDc)
     {
         case ReadDataError:
-            memset(pq->sysData, 0xff, (AXP_21274_DATA_SIZE * sizeof(pq->sysData)));
+            memset(pq->sysData, 0xff, sizeof(pq->sysData));
             pq->dm = true;
             break;
 
@@ -87,7 +95,7 @@ void AXP_21264_SendToCPU(AXP_21274_SYSBUS_CPU *msg, AXP_21274_CPU *cpu)
         case ReadDataDirty:
         case ReadDataShared:
         case ReadDataSharedDirty:
-            memcpy(pq->sysData, msg->sysData, AXP_21274_DATA_SIZE);
+            memcpy(pq->sysData, msg->sysData, sizeof(pq->sysData));
             pq->dm = true;
             pq->wrap = msg->wrap;
             break;
@@ -0,0 +1,592 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to test the byte and
+ *  multimedia instruction kernels.  Every set of kernels the host supports is
+ *  checked against a byte at a time implementation of each instruction, with
+ *  every pair of byte values in every byte, and with random values.  Then each
+ *  kernel, and the byte at a time implementation, is timed, as is a strlen
+ *  style scan of a buffer with CMPBGE.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Configure.h"
+#include "CPU/Ebox/AXP_21264_Ebox_SIMD.h"
+#include <stddef.h>
+#include <time.h>
+
+#define AXP_TEST_RANDOM     ONE_M
+#define AXP_TEST_TIMED      (4 * ONE_M)
+#define AXP_TEST_SCAN_SIZE  (64 * ONE_M)
+#define AXP_TEST_SCAN_REPS  8
+
+/*
+ * The byte at a time implementations, which the kernels have to match.
+ */
+static u64 refCmpBge(u64 a, u64 b)
+{
+    u64 retVal = 0;
+    int ii;
+
+    for (ii = 0; ii < 8; ii++)
+    {
+        if (((a >> (ii * 8)) & 0xff) >= ((b >> (ii * 8)) & 0xff))
+        {
+            retVal |= 1 << ii;
+        }
+    }
+    return (retVal);
+}
+
+static u64 refZapMask(u64 b)
+{
+    u64 retVal = 0;
+    int ii;
+
+    for (ii = 0; ii < 8; ii++)
+    {
+        if ((b & (1 << ii)) != 0)
+        {
+            retVal |= 0xffull << (ii * 8);
+        }
+    }
+    return (retVal);
+}
+
+static u64 refMinMax(u64 a, u64 b, int bits, bool isSigned, bool isMax)
+{
+    u64 mask = (1ull << bits) - 1;
+    u64 retVal = 0;
+    i64 la, lb;
+    int ii;
+
+    for (ii = 0; ii < 64; ii += bits)
+    {
+        la = (a >> ii) & mask;
+        lb = (b >> ii) & mask;
+        if (isSigned)
+        {
+            la = (la ^ (1ll << (bits - 1))) - (1ll << (bits - 1));
+            lb = (lb ^ (1ll << (bits - 1))) - (1ll << (bits - 1));
+        }
+        retVal |= (((isMax ? (la > lb) : (la < lb)) ? la : lb) & mask) << ii;
+    }
+    return (retVal);
+}
+
+static u64 refMinUB8(u64 a, u64 b) {return (refMinMax(a, b, 8, false, false));}
+static u64 refMinSB8(u64 a, u64 b) {return (refMinMax(a, b, 8, true, false));}
+static u64 refMinUW4(u64 a, u64 b) {return (refMinMax(a, b, 16, false, false));}
+static u64 refMinSW4(u64 a, u64 b) {return (refMinMax(a, b, 16, true, false));}
+static u64 refMaxUB8(u64 a, u64 b) {return (refMinMax(a, b, 8, false, true));}
+static u64 refMaxSB8(u64 a, u64 b) {return (refMinMax(a, b, 8, true, true));}
+static u64 refMaxUW4(u64 a, u64 b) {return (refMinMax(a, b, 16, false, true));}
+static u64 refMaxSW4(u64 a, u64 b) {return (refMinMax(a, b, 16, true, true));}
+
+static u64 refPerr(u64 a, u64 b)
+{
+    u64 retVal = 0;
+    int ii;
+
+    for (ii = 0; ii < 64; ii += 8)
+    {
+        retVal += abs((int) ((a >> ii) & 0xff) - (int) ((b >> ii) & 0xff));
+    }
+    return (retVal);
+}
+
+static u64 refPkLB(u64 b)
+{
+    return ((b & 0xff) | (((b >> 32) & 0xff) << 8));
+}
+
+static u64 refPkWB(u64 b)
+{
+    u64 retVal = 0;
+    int ii;
+
+    for (ii = 0; ii < 4; ii++)
+    {
+        retVal |= ((b >> (ii * 16)) & 0xff) << (ii * 8);
+    }
+    return (retVal);
+}
+
+static u64 refUnpkBL(u64 b)
+{
+    return ((b & 0xff) | (((b >> 8) & 0xff) << 32));
+}
+
+static u64 refUnpkBW(u64 b)
+{
+    u64 retVal = 0;
+    int ii;
+
+    for (ii = 0; ii < 4; ii++)
+    {
+        retVal |= ((b >> (ii * 8)) & 0xff) << (ii * 16);
+    }
+    return (retVal);
+}
+
+/*
+ * The kernels, by name, with the byte at a time implementation of each, and
+ * their offsets in the set of kernels.
+ */
+typedef struct
+{
+    const char *name;
+    size_t offset;
+    bool unary;
+    u64 (*ref2)(u64, u64);
+    u64 (*ref1)(u64);
+} AXP_TEST_KERNEL;
+
+#define AXP_TEST_BINARY(name, field, ref) \
+    {name, offsetof(AXP_SIMD_KERNELS, field), false, ref, NULL}
+#define AXP_TEST_UNARY(name, field, ref) \
+    {name, offsetof(AXP_SIMD_KERNELS, field), true, NULL, ref}
+
+static const AXP_TEST_KERNEL kernels[] =
+{
+    AXP_TEST_BINARY("CMPBGE", cmpbge, refCmpBge),
+    AXP_TEST_UNARY("ZAPNOT mask", zapMask, refZapMask),
+    AXP_TEST_BINARY("MINUB8", minub8, refMinUB8),
+    AXP_TEST_BINARY("MINSB8", minsb8, refMinSB8),
+    AXP_TEST_BINARY("MINUW4", minuw4, refMinUW4),
+    AXP_TEST_BINARY("MINSW4", minsw4, refMinSW4),
+    AXP_TEST_BINARY("MAXUB8", maxub8, refMaxUB8),
+    AXP_TEST_BINARY("MAXSB8", maxsb8, refMaxSB8),
+    AXP_TEST_BINARY("MAXUW4", maxuw4, refMaxUW4),
+    AXP_TEST_BINARY("MAXSW4", maxsw4, refMaxSW4),
+    AXP_TEST_BINARY("PERR", perr, refPerr),
+    AXP_TEST_UNARY("PKLB", pklb, refPkLB),
+    AXP_TEST_UNARY("PKWB", pkwb, refPkWB),
+    AXP_TEST_UNARY("UNPKBL", unpkbl, refUnpkBL),
+    AXP_TEST_UNARY("UNPKBW", unpkbw, refUnpkBW),
+    {NULL, 0, false, NULL, NULL}
+};
+
+static u64 randState = 0x9e3779b97f4a7c15ull;
+
+/*
+ * randomValue
+ *  This function is called to get a random test value.  Most of its bytes
+ *  are random, but a quarter are one of the values at the edges of the
+ *  signed and unsigned ranges.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The value.
+ */
+static u64 randomValue(void)
+{
+    static const u8 edges[] = {0x00, 0x01, 0x7f, 0x80, 0x81, 0xfe, 0xff, 0x7e};
+    u64 retVal, choose;
+    int ii;
+
+    randState ^= randState << 13;
+    randState ^= randState >> 7;
+    randState ^= randState << 17;
+    retVal = randState;
+    choose = randState * 0x2545f4914f6cdd1dull;
+    for (ii = 0; ii < 8; ii++)
+    {
+        if (((choose >> (ii * 4)) & 0x3) == 0)
+        {
+            retVal &= ~(0xffull << (ii * 8));
+            retVal |= (u64) edges[(choose >> (ii * 4 + 32)) & 0x7] << (ii * 8);
+        }
+    }
+    return (retVal);
+}
+
+/*
+ * checkOne
+ *  This function is called to check one kernel against its byte at a time
+ *  implementation, for one pair of operands.
+ *
+ * Input Parameters:
+ *  set:
+ *      A pointer to the set of kernels.
+ *  kernel:
+ *      A pointer to the description of the kernel.
+ *  a:
+ *      A value of the first operand (not used by the unary kernels).
+ *  b:
+ *      A value of the second operand.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  true:   The results match.
+ *  false:  They do not.
+ */
+static bool checkOne(const AXP_SIMD_KERNELS *set,
+                     const AXP_TEST_KERNEL *kernel,
+                     u64 a,
+                     u64 b)
+{
+    const void *fn = *(const void **) ((const u8 *) set + kernel->offset);
+    u64 expected, result;
+    bool retVal = true;
+
+    if (kernel->unary)
+    {
+        expected = (*kernel->ref1)(b);
+        result = (*(u64 (*)(u64)) fn)(b);
+    }
+    else
+    {
+        expected = (*kernel->ref2)(a, b);
+        result = (*(u64 (*)(u64, u64)) fn)(a, b);
+    }
+    if (result != expected)
+    {
+        printf("    %s %s(0x%016llx, 0x%016llx) = 0x%016llx, expected "
+               "0x%016llx\n",
+               set->name,
+               kernel->name,
+               a,
+               b,
+               result,
+               expected);
+        retVal = false;
+    }
+    return (retVal);
+}
+
+/*
+ * checkSet
+ *  This function is called to check every kernel in a set.  Each byte of the
+ *  operands is, in turn, given every pair of byte values, with the other
+ *  bytes random, then the operands are all random.
+ *
+ * Input Parameters:
+ *  set:
+ *      A pointer to the set of kernels.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of mismatches.
+ */
+static u32 checkSet(const AXP_SIMD_KERNELS *set)
+{
+    const AXP_TEST_KERNEL *kernel;
+    u32 failures = 0;
+    u64 a, b;
+    int lane, x, y;
+    u32 ii;
+
+    for (kernel = kernels; kernel->name != NULL; kernel++)
+    {
+        u32 before = failures;
+
+        for (lane = 0; (lane < 64) && (failures - before < 4); lane += 8)
+        {
+            for (x = 0; x < 256; x++)
+            {
+                for (y = 0; y < 256; y++)
+                {
+                    a = (randomValue() & ~(0xffull << lane)) |
+                        ((u64) x << lane);
+                    b = (randomValue() & ~(0xffull << lane)) |
+                        ((u64) y << lane);
+                    if (checkOne(set, kernel, a, b) == false)
+                    {
+                        failures++;
+                    }
+                }
+            }
+        }
+        for (ii = 0; (ii < AXP_TEST_RANDOM) && (failures - before < 8); ii++)
+        {
+            if (checkOne(set, kernel, randomValue(), randomValue()) == false)
+            {
+                failures++;
+            }
+        }
+        printf("    %-5s %-12s %s\n",
+               set->name,
+               kernel->name,
+               (failures == before) ? "passed" : "FAILED");
+    }
+    return (failures);
+}
+
+/*
+ * elapsed
+ *  This function is called to get the number of nanoseconds between two
+ *  times.
+ *
+ * Input Parameters:
+ *  start:
+ *      A pointer to the earlier time.
+ *  end:
+ *      A pointer to the later time.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The nanoseconds.
+ */
+static double elapsed(struct timespec *start, struct timespec *end)
+{
+    return (((end->tv_sec - start->tv_sec) * 1e9) +
+            (end->tv_nsec - start->tv_nsec));
+}
+
+/*
+ * timeKernel
+ *  This function is called to time a kernel, through a pointer the way the
+ *  instructions call them.  Each result feeds the next operand, so the calls
+ *  cannot overlap or be optimized away.
+ *
+ * Input Parameters:
+ *  kernel:
+ *      A pointer to the description of the kernel.
+ *  fn:
+ *      A pointer to the function to time.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The nanoseconds per call.
+ */
+static double timeKernel(const AXP_TEST_KERNEL *kernel, const void *fn)
+{
+    u64 (*volatile fn2)(u64, u64) = (u64 (*)(u64, u64)) fn;
+    u64 (*volatile fn1)(u64) = (u64 (*)(u64)) fn;
+    struct timespec start, end;
+    u64 value = 0x0123456789abcdefull;
+    u64 other = 0xfedcba9876543210ull;
+    u32 ii;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (kernel->unary)
+    {
+        for (ii = 0; ii < AXP_TEST_TIMED; ii++)
+        {
+            value = (*fn1)(value ^ other) + ii;
+        }
+    }
+    else
+    {
+        for (ii = 0; ii < AXP_TEST_TIMED; ii++)
+        {
+            value = (*fn2)(value, other) + ii;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (value == 0)
+    {
+        printf(" ");
+    }
+    return (elapsed(&start, &end) / AXP_TEST_TIMED);
+}
+
+/*
+ * scanBuffer
+ *  This function is called to find the length of each of the zero terminated
+ *  strings in a buffer, a quadword at a time, the way a guest strlen does.
+ *  CMPBGE of zero against the quadword sets a bit for each zero byte.
+ *
+ * Input Parameters:
+ *  cmpbge:
+ *      A pointer to the CMPBGE function to use.
+ *  buffer:
+ *      A pointer to the buffer, which ends with a zero byte.
+ *  quads:
+ *      A value indicating the number of quadwords in the buffer.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of zero bytes found.
+ */
+static u64 scanBuffer(u64 (*cmpbge)(u64, u64), const u64 *buffer, u64 quads)
+{
+    u64 found = 0;
+    u64 ii;
+
+    for (ii = 0; ii < quads; ii++)
+    {
+        found += __builtin_popcountll((*cmpbge)(0, buffer[ii]));
+    }
+    return (found);
+}
+
+/*
+ * main
+ *  This function is called to check and time the byte and multimedia
+ *  instruction kernels.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  0:  All the kernels matched.
+ *  1:  At least one did not.
+ */
+int main(void)
+{
+    const AXP_SIMD_KERNELS *sets[AXP_SIMD_ISA_COUNT];
+    const AXP_TEST_KERNEL *kernel;
+    struct timespec start, end;
+    u64 *buffer;
+    u64 quads = AXP_TEST_SCAN_SIZE / sizeof(u64);
+    u64 found, expected = 0;
+    u32 failures = 0;
+    int isa, rep;
+    u64 ii;
+
+    printf("\nAXP 21264 Byte and Multimedia Kernel Tester\n");
+    AXP_SIMD_Init();
+    printf("\nActive kernels: %s\n\nChecking against the byte at a time "
+           "instructions:\n",
+           AXP_SIMD_Active.name);
+    for (isa = AXP_SIMD_SWAR; isa < AXP_SIMD_ISA_COUNT; isa++)
+    {
+        sets[isa] = AXP_SIMD_Kernels(isa);
+        if (sets[isa] != NULL)
+        {
+            failures += checkSet(sets[isa]);
+        }
+    }
+
+    /*
+     * Time each kernel, through a pointer, the way the instructions call
+     * them.
+     */
+    printf("\nNanoseconds per call:\n\n    %-12s %8s", "", "Bytewise");
+    for (isa = AXP_SIMD_SWAR; isa < AXP_SIMD_ISA_COUNT; isa++)
+    {
+        if (sets[isa] != NULL)
+        {
+            printf(" %8s", sets[isa]->name);
+        }
+    }
+    printf("\n");
+    for (kernel = kernels; kernel->name != NULL; kernel++)
+    {
+        printf("    %-12s %8.2f",
+               kernel->name,
+               timeKernel(kernel,
+                          kernel->unary ?
+                              (const void *) kernel->ref1 :
+                              (const void *) kernel->ref2));
+        for (isa = AXP_SIMD_SWAR; isa < AXP_SIMD_ISA_COUNT; isa++)
+        {
+            if (sets[isa] != NULL)
+            {
+                printf(" %8.2f",
+                       timeKernel(kernel,
+                                  *(const void **) ((const u8 *) sets[isa] +
+                                                    kernel->offset)));
+            }
+        }
+        printf("\n");
+    }
+
+    /*
+     * Scan a buffer of strings, of random lengths up to 64 bytes, for their
+     * terminating zero bytes.
+     */
+    buffer = malloc(AXP_TEST_SCAN_SIZE);
+    for (ii = 0; ii < AXP_TEST_SCAN_SIZE; ii++)
+    {
+        u8 byte = 'a' + (randomValue() % 26);
+
+        if ((randomValue() % 64) == 0)
+        {
+            byte = 0;
+        }
+        ((u8 *) buffer)[ii] = byte;
+        expected += (byte == 0);
+    }
+    printf("\nStrlen scan of %d MB with CMPBGE:\n\n",
+           AXP_TEST_SCAN_SIZE / ONE_M);
+    for (isa = AXP_SIMD_SWAR - 1; isa < AXP_SIMD_ISA_COUNT; isa++)
+    {
+        u64 (*cmpbge)(u64, u64);
+        const char *name;
+
+        if (isa < AXP_SIMD_SWAR)
+        {
+            cmpbge = refCmpBge;
+            name = "Bytewise";
+        }
+        else if (sets[isa] != NULL)
+        {
+            cmpbge = sets[isa]->cmpbge;
+            name = sets[isa]->name;
+        }
+        else
+        {
+            continue;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (rep = 0; rep < AXP_TEST_SCAN_REPS; rep++)
+        {
+            found = scanBuffer(cmpbge, buffer, quads);
+            if (found != expected)
+            {
+                printf("    %s found %llu zero bytes, expected %llu\n",
+                       name,
+                       found,
+                       expected);
+                failures++;
+                break;
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("    %-8s %8.2f GB/s\n",
+               name,
+               (double) AXP_TEST_SCAN_SIZE * AXP_TEST_SCAN_REPS /
+               elapsed(&start, &end));
+    }
+    free(buffer);
+
+    if (failures == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%u mismatches!\n", failures);
+    }
+    return (failures == 0 ? 0 : 1);
+}
@@ -33,14 +33,30 @@
  *
  *  V01.003 08-Jun-2019 Jonathan D. Belanger
  *  Fixing compiler warnings when compiling with Clang.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Added running the IEEE S add, subtract, multiply, divide, and square root
+ *  test vectors through the integer-only floating-point operations, a batch at
+ *  a time, checking the result and exceptions of each one.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Added testing that IEEE T results too small to be normalized are performed
+ *  again with integer arithmetic, which writes a true zero without /U.
+ *
+ *  V01.006 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped lines longer than 80 columns.
  */
 #include <math.h>
 #include <float.h>
+#include <time.h>
+#include <ctype.h>
 #include "CommonUtilities/AXP_Utility.h"
 #include "CommonUtilities/AXP_Blocks.h"
 #include "CPU/AXP_21264_Instructions.h"
 #include "CPU/AXP_21264_CPU.h"
 #include "CPU/Fbox/AXP_21264_Fbox.h"
+#include "CPU/Fbox/AXP_21264_Fbox_SoftFloat.h"
+#include "CPU/Fbox/AXP_21264_Fbox_FPFunctions.h"
 
 #ifndef AXP_TEST_DATA_FILES
 #define AXP_TEST_DATA_FILES "."
@@ -1051,6 +1067,493 @@ bool isInf(double fpv)
     return (AXP_FP_ENCODE(fpr, true) == Infinity);
 }
 
+/*
+ * The test vectors run through the integer-only operations, grouped by
+ * operation and rounding mode, so that each group can be run as a batch.
+ */
+#define AXP_SF_TEST_OPS     5
+#define AXP_SF_TEST_RNDS    4
+#define AXP_SF_TEST_REPEAT  20
+
+typedef struct
+{
+    u64 *src1;
+    u64 *src2;
+    u64 *expected;
+    u32 *flags;
+    u32 *line;
+    u32 count;
+    u32 size;
+} AXP_SF_TEST_GROUP;
+
+static char *sfFileNames[] =
+{
+    "fpTestData/Add-Cancellation-And-Subnorm-Result.fptest",
+    "fpTestData/Add-Cancellation.fptest",
+    "fpTestData/Add-Shift-And-Special-Significands.fptest",
+    "fpTestData/Add-Shift.fptest",
+    "fpTestData/Basic-Types-Inputs.fptest",
+    "fpTestData/Basic-Types-Intermediate.fptest",
+    "fpTestData/Corner-Rounding.fptest",
+    "fpTestData/Divide-Divide-By-Zero-Exception.fptest",
+    "fpTestData/Divide-Trailing-Zeros.fptest",
+    "fpTestData/Hamming-Distance.fptest",
+    "fpTestData/Input-Special-Significand.fptest",
+    "fpTestData/Overflow.fptest",
+    "fpTestData/Rounding.fptest",
+    "fpTestData/Sticky-Bit-Calculation.fptest",
+    "fpTestData/Underflow.fptest",
+    "fpTestData/Vicinity-Of-Rounding-Boundaries.fptest",
+    NULL
+};
+
+/*
+ * sfParseOperand
+ *  This function is called to convert an operand or result from a test vector
+ *  into the value an IEEE S register would hold.
+ *
+ * Input Parameters:
+ *  str:
+ *      A pointer to the operand string, such as +1.01FD72P-118, -0.000D18P-126,
+ *      +Inf, -Zero, Q, or S.
+ *
+ * Output Parameters:
+ *  reg:
+ *      A pointer to receive the register value.
+ *
+ * Return Value:
+ *  true:   The operand was converted.
+ *  false:  The operand is not one that can be.
+ */
+bool sfParseOperand(char *str, u64 *reg)
+{
+    u64 sign = 0;
+    u64 fraction;
+    int exponent;
+    bool retVal = true;
+
+    if ((*str == '+') || (*str == '-'))
+    {
+        sign = (*str == '-') ? AXP_R_SIGN : 0;
+        str++;
+    }
+    if (strcmp(str, "Zero") == 0)
+    {
+        *reg = sign;
+    }
+    else if (strcmp(str, "Inf") == 0)
+    {
+        *reg = sign | AXP_R_PINF;
+    }
+    else if (strcmp(str, "Q") == 0)
+    {
+        *reg = sign | AXP_R_PINF | AXP_R_QNAN;
+    }
+    else if (strcmp(str, "S") == 0)
+    {
+        *reg = sign | AXP_R_PINF | 0x0004000000000000ll;
+    }
+    else if (((str[0] == '0') || (str[0] == '1')) &&
+             (sscanf(&str[2], "%llxP%d", &fraction, &exponent) == 2))
+    {
+        if (str[0] == '1')
+        {
+            *reg = sign |
+                   ((u64) (exponent + AXP_T_BIAS) << AXP_T_FRAC_SIZE) |
+                   (fraction << 29);
+        }
+        else
+        {
+            *reg = sign | (fraction << 29);
+        }
+    }
+    else
+    {
+        retVal = false;
+    }
+    return (retVal);
+}
+
+/*
+ * sfParseFlags
+ *  This function is called to convert the exceptions a test vector expects
+ *  into the ones the integer-only operations raise.
+ *
+ * Input Parameters:
+ *  str:
+ *      A pointer to the string of flags, such as "xu".
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The expected exceptions.
+ */
+u32 sfParseFlags(char *str)
+{
+    u32 retVal = 0;
+
+    while (*str != '\0')
+    {
+        switch (*str)
+        {
+            case 'x':
+                retVal |= AXP_SF_INE;
+                break;
+
+            case 'u':
+                retVal |= AXP_SF_UNF;
+                break;
+
+            case 'o':
+                retVal |= AXP_SF_OVF;
+                break;
+
+            case 'z':
+                retVal |= AXP_SF_DZE;
+                break;
+
+            case 'i':
+                retVal |= AXP_SF_INV;
+                break;
+        }
+        str++;
+    }
+    return (retVal);
+}
+
+/*
+ * sfAddVector
+ *  This function is called to add a test vector to its group.
+ *
+ * Input Parameters:
+ *  group:
+ *      A pointer to the group.
+ *  src1:
+ *      A value of the first operand register.
+ *  src2:
+ *      A value of the second operand register.
+ *  expected:
+ *      A value of the expected result register.
+ *  flags:
+ *      A value of the expected exceptions.
+ *  line:
+ *      A value of the line number the vector came from.
+ *
+ * Output Parameters:
+ *  group:
+ *      A pointer to the group, with the vector added.
+ *
+ * Return Value:
+ *  None.
+ */
+void sfAddVector(AXP_SF_TEST_GROUP *group,
+                 u64 src1,
+                 u64 src2,
+                 u64 expected,
+                 u32 flags,
+                 u32 line)
+{
+    if (group->count == group->size)
+    {
+        group->size = (group->size == 0) ? 1024 : (group->size * 2);
+        group->src1 = realloc(group->src1, group->size * sizeof(u64));
+        group->src2 = realloc(group->src2, group->size * sizeof(u64));
+        group->expected = realloc(group->expected, group->size * sizeof(u64));
+        group->flags = realloc(group->flags, group->size * sizeof(u32));
+        group->line = realloc(group->line, group->size * sizeof(u32));
+    }
+    group->src1[group->count] = src1;
+    group->src2[group->count] = src2;
+    group->expected[group->count] = expected;
+    group->flags[group->count] = flags;
+    group->line[group->count] = line;
+    group->count++;
+    return;
+}
+
+/*
+ * sfTestVectors
+ *  This function is called to run the IEEE S add, subtract, multiply, divide,
+ *  and square root test vectors through the integer-only floating-point
+ *  operations.  The vectors are read and grouped by operation and rounding
+ *  mode, then each group is run as a batch, with the /SUI qualifiers and the
+ *  FPCR disabling underflow and inexact traps, which gives the IEEE default
+ *  results.  The batches are run a number of times, to time them.  Vectors
+ *  that expect a trap to have been taken, or have no result, are skipped.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   All the vectors run passed.
+ *  false:  At least one did not.
+ */
+bool sfTestVectors(void)
+{
+    static const char ops[] = "+-*/V";
+    AXP_SF_TEST_GROUP groups[AXP_SF_TEST_OPS][AXP_SF_TEST_RNDS];
+    AXP_SF_OPERATION op;
+    union cvtFPCR64 fpcr = {.FPCR64 = 0};
+    struct timespec start, end;
+    char line[256];
+    char *tokens[8];
+    char fileName[AXP_MAX_FILENAME_LEN];
+    FILE *fp;
+    u64 *dest = NULL;
+    u32 *raised = NULL;
+    u64 src1, src2, expected;
+    double seconds;
+    u32 maxCount = 0, lineNo, flags, rnd, ii, jj, kk, rep;
+    int passed = 0, failed = 0, skipped = 0, executed = 0;
+    int tokCnt, opIdx, operand;
+    char *opPtr, *tok;
+
+    memset(groups, 0, sizeof(groups));
+    for (ii = 0; sfFileNames[ii] != NULL; ii++)
+    {
+        sprintf(fileName, "%s/%s", AXP_TEST_DATA_FILES, sfFileNames[ii]);
+        fp = fopen(fileName, "r");
+        if (fp == NULL)
+        {
+            printf("Unable to open test data file: %s\n", fileName);
+            failed++;
+            continue;
+        }
+        lineNo = 0;
+        while (fgets(line, sizeof(line), fp) != NULL)
+        {
+            lineNo++;
+            if ((strncmp(line, "b32", 3) != 0) ||
+                (line[4] != ' ') ||
+                ((opPtr = strchr(ops, line[3])) == NULL))
+            {
+                continue;
+            }
+            opIdx = opPtr - ops;
+            tokCnt = 0;
+            tok = strtok(line, " \r\n");
+            while ((tok != NULL) && (tokCnt < 8))
+            {
+                tokens[tokCnt++] = tok;
+                tok = strtok(NULL, " \r\n");
+            }
+
+            /*
+             * The tokens are the operation, rounding mode, the traps taken (if
+             * any), the operands, "->", the result, and the exceptions (if
+             * any).
+             */
+            if (tokCnt < 5)
+            {
+                continue;
+            }
+            if (strcmp(tokens[1], "=0") == 0)
+            {
+                rnd = AXP_FP_NORMAL;
+            }
+            else if (strcmp(tokens[1], "0") == 0)
+            {
+                rnd = AXP_FP_CHOPPED;
+            }
+            else if (strcmp(tokens[1], "<") == 0)
+            {
+                rnd = AXP_FP_MINUS_INF;
+            }
+            else if (strcmp(tokens[1], ">") == 0)
+            {
+                rnd = AXP_FP_PLUS_INF;
+            }
+            else
+            {
+                skipped++;
+                continue;
+            }
+            operand = 2;
+            if (islower(tokens[2][0]))
+            {
+                skipped++;
+                continue;
+            }
+            src2 = 0;
+            jj = (opIdx == 4) ? 1 : 2;
+            if ((tokCnt < (operand + jj + 2)) ||
+                (strcmp(tokens[operand + jj], "->") != 0) ||
+                (sfParseOperand(tokens[operand], &src1) == false) ||
+                ((jj == 2) &&
+                 (sfParseOperand(tokens[operand + 1], &src2) == false)) ||
+                (sfParseOperand(tokens[operand + jj + 1], &expected) == false))
+            {
+                skipped++;
+                continue;
+            }
+
+            /*
+             * The vectors do not signal an invalid operation for a signaling
+             * NaN when the other operand is a quiet NaN, but IEEE and the
+             * Alpha do.
+             */
+            if ((jj == 2) &&
+                (((strcmp(tokens[operand], "Q") == 0) &&
+                  (strcmp(tokens[operand + 1], "S") == 0)) ||
+                 ((strcmp(tokens[operand], "S") == 0) &&
+                  (strcmp(tokens[operand + 1], "Q") == 0))))
+            {
+                skipped++;
+                continue;
+            }
+            flags = 0;
+            if (tokCnt > (operand + jj + 2))
+            {
+                flags = sfParseFlags(tokens[operand + jj + 2]);
+            }
+            sfAddVector(&groups[opIdx][rnd],
+                        src1,
+                        src2,
+                        expected,
+                        flags,
+                        lineNo);
+        }
+        fclose(fp);
+    }
+
+    for (ii = 0; ii < AXP_SF_TEST_OPS; ii++)
+    {
+        for (jj = 0; jj < AXP_SF_TEST_RNDS; jj++)
+        {
+            if (groups[ii][jj].count > maxCount)
+            {
+                maxCount = groups[ii][jj].count;
+            }
+        }
+    }
+    dest = calloc(maxCount + 1, sizeof(u64));
+    raised = calloc(maxCount + 1, sizeof(u32));
+
+    /*
+     * Run and time the batches.
+     */
+    fpcr.FPCR.unfd = 1;
+    fpcr.FPCR.ined = 1;
+    fpcr.FPCR.dyn = AXP_FP_PLUS_INF;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (rep = 0; rep < AXP_SF_TEST_REPEAT; rep++)
+    {
+        for (ii = 0; ii < AXP_SF_TEST_OPS; ii++)
+        {
+            for (jj = 0; jj < AXP_SF_TEST_RNDS; jj++)
+            {
+                AXP_SF_TEST_GROUP *group = &groups[ii][jj];
+                u32 function;
+
+                if (group->count == 0)
+                {
+                    continue;
+                }
+
+                /*
+                 * Plus infinity rounding is only available as dynamic.
+                 */
+                function = (AXP_FP_TRP_S | AXP_FP_TRP_U | AXP_FP_TRP_I) << 8;
+                function |= ((jj == AXP_FP_PLUS_INF) ?
+                             AXP_FP_DYNAMIC :
+                             jj) << 6;
+                function |= AXP_FP_S << 4;
+                function |= (ii == 4) ? AXP_FP_SQRTST : ii;
+                AXP_SF_Decode((ii == 4) ? ITFP : FLTI,
+                              function,
+                              &fpcr.FPCR,
+                              &op);
+                AXP_SF_Batch(&op,
+                             group->src1,
+                             (ii == 4) ? NULL : group->src2,
+                             dest,
+                             raised,
+                             group->count);
+
+                /*
+                 * Check the results the first time through.
+                 */
+                if (rep == 0)
+                {
+                    for (kk = 0; kk < group->count; kk++)
+                    {
+                        u64 exp = group->expected[kk];
+                        bool match;
+
+                        if (((exp & AXP_R_PINF) == AXP_R_PINF) &&
+                            ((exp & AXP_R_FRAC) != 0))
+                        {
+                            match = ((dest[kk] & AXP_R_PINF) == AXP_R_PINF) &&
+                                    ((dest[kk] & AXP_R_FRAC) != 0);
+                        }
+                        else
+                        {
+                            match = dest[kk] == group->expected[kk];
+                        }
+                        match &= (raised[kk] & ~AXP_SF_IOV) ==
+                                 group->flags[kk];
+                        if (match)
+                        {
+                            passed++;
+                        }
+                        else
+                        {
+                            if (failed < 20)
+                            {
+                                printf("%7u: %c rnd %u %016llx %016llx -> "
+                                       "%016llx %02x, expected %016llx %02x\n",
+                                       group->line[kk],
+                                       ops[ii],
+                                       jj,
+                                       group->src1[kk],
+                                       group->src2[kk],
+                                       dest[kk],
+                                       raised[kk],
+                                       group->expected[kk],
+                                       group->flags[kk]);
+                            }
+                            failed++;
+                        }
+                    }
+                }
+                executed += group->count;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (end.tv_sec - start.tv_sec) +
+              ((end.tv_nsec - start.tv_nsec) / 1000000000.0);
+
+    printf("\nInteger-only IEEE S test vectors: %d passed, %d failed, and %d "
+           "skipped.\n",
+           passed,
+           failed,
+           skipped);
+    printf("%d vectors executed in %.3f seconds, %.0f vectors per second.\n",
+           executed,
+           seconds,
+           (seconds > 0.0) ? (executed / seconds) : 0.0);
+
+    for (ii = 0; ii < AXP_SF_TEST_OPS; ii++)
+    {
+        for (jj = 0; jj < AXP_SF_TEST_RNDS; jj++)
+        {
+            free(groups[ii][jj].src1);
+            free(groups[ii][jj].src2);
+            free(groups[ii][jj].expected);
+            free(groups[ii][jj].flags);
+            free(groups[ii][jj].line);
+        }
+    }
+    free(dest);
+    free(raised);
+    return (failed == 0);
+}
+
 /*
  * main
  *  This function is compiled in when unit testing.  It exercises the branch
@@ -1065,6 +1568,107 @@ bool isInf(double fpv)
  * Return Value:
  *  None.
  */
+/*
+ * sfTestTinyResults
+ *  This function is called to test that the IEEE T results the host gets
+ *  wrong, because they are too small to be normalized, are detected after the
+ *  host has performed the instruction, and performed again with integer
+ *  arithmetic.  Without /U, the Alpha writes a true zero.  With /U, it traps.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure, with the FPCR cleared.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  true:   All the tests passed.
+ *  false:  At least one did not.
+ */
+bool sfTestTinyResults(AXP_21264_CPU *cpu)
+{
+    static const struct
+    {
+        u32 function;
+        u64 src1;
+        u64 src2;
+        bool redo;
+        AXP_EXCEPTIONS exception;
+        u64 expected;
+    } tests[] =
+    {
+        /* 1.0 + 1.0 is normal, and left to the host */
+        {AXP_FUNC_ADDT, 0x3ff0000000000000ll, 0x3ff0000000000000ll, false,
+         NoException, 0x4000000000000000ll},
+
+        /* 1.5 * 2^-1022 - 2^-1022 is an exact denormal */
+        {AXP_FUNC_ADDT, 0x0018000000000000ll, 0x8010000000000000ll, true,
+         NoException, 0x0000000000000000ll},
+
+        /* 2^-1022 * 0.5 is an exact denormal */
+        {AXP_FUNC_MULT, 0x0010000000000000ll, 0x3fe0000000000000ll, true,
+         NoException, 0x0000000000000000ll},
+
+        /* 1.0e-200 * 1.0e-200 underflows */
+        {AXP_FUNC_MULT, 0x16687e92154ef7acll, 0x16687e92154ef7acll, true,
+         NoException, 0x0000000000000000ll},
+
+        /* With /SU, the exact denormal traps */
+        {AXP_FUNC_ADDT_SU, 0x0018000000000000ll, 0x8010000000000000ll, true,
+         ArithmeticTraps, 0}
+    };
+    AXP_INSTRUCTION instr;
+    AXP_EXCEPTIONS exception;
+    bool redo;
+    bool retVal = true;
+    int ii;
+
+    printf("\nTesting IEEE T results too small to be normalized...\n");
+    for (ii = 0; ii < (int) (sizeof(tests) / sizeof(tests[0])); ii++)
+    {
+        memset(&instr, 0, sizeof(instr));
+        instr.opcode = FLTI;
+        instr.function = tests[ii].function;
+        instr.src1v.fp.uq = tests[ii].src1;
+        instr.src2v.fp.uq = tests[ii].src2;
+        if (tests[ii].function == AXP_FUNC_MULT)
+        {
+            exception = AXP_MULT(cpu, &instr);
+        }
+        else
+        {
+            exception = AXP_ADDT(cpu, &instr);
+        }
+        redo = AXP_FP_SoftFloatRedo(cpu, &instr);
+        if (redo == true)
+        {
+            memset(&instr.insFpcr, 0, sizeof(instr.insFpcr));
+            memset(&instr.excSum, 0, sizeof(instr.excSum));
+            exception = AXP_FP_SoftOperate(cpu, &instr);
+        }
+        if ((redo != tests[ii].redo) ||
+            (exception != tests[ii].exception) ||
+            ((exception == NoException) &&
+             (instr.destv.fp.uq != tests[ii].expected)))
+        {
+            printf("    Test %d failed: redo %d, exception %d, "
+                   "result 0x%016llx\n",
+                   ii,
+                   redo,
+                   exception,
+                   instr.destv.fp.uq);
+            retVal = false;
+        }
+    }
+    printf("    %s\n", (retVal == true) ? "passed" : "failed");
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
 int main()
 {
     FILE *fp;
@@ -1698,6 +2302,12 @@ int main()
                 testCnt);
     }
 
+    /*
+     * Now run the vectors through the integer-only operations.
+     */
+    sfTestVectors();
+    sfTestTinyResults(cpu);
+
     /*
      * We are done.
      */
@@ -0,0 +1,613 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to test the functional
+ *  execution mode of the Ibox.  A short stream of integer instructions,
+ *  including a taken branch, is executed one fetched line at a time, and the
+ *  registers and the next PC are checked afterwards.  The stream is run again,
+ *  switching to detailed mode and back part way through it, and the same
+ *  registers and next PC are checked.  A loop is then run from
+ *  a super page until it is translated, and a store to its physical page is
+ *  checked to discard the translation.  Finally, the loop is timed when it is
+ *  interpreted and when it is translated.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Check that a fetched line that runs past the end of the Icache block stops
+ *  at the end of the block.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Check that a loop run from a super page is translated, and that a store to
+ *  its physical page discards the translation.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  The fetched lines say how many of their instructions are valid, as the
+ *  ones returned by the Icache do.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Time the loop interpreted, from a page that is never translated, and
+ *  translated, from the super page, and print the speed-up.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Check that the execution mode switches, part way through a fetched line,
+ *  once the configured number of instructions have been retired, and that
+ *  the registers and the next PC are the same after switching back.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CPU/AXP_21264_CPU.h"
+#include "CPU/Ibox/AXP_21264_Ibox.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Functional.h"
+#include "CPU/Ibox/AXP_21264_Ibox_PCHandling.h"
+#include "CPU/Ibox/AXP_21264_Ibox_Translate.h"
+
+/*
+ * Instruction encodings for the instructions used below.
+ */
+#define AXP_TEST_LDA(ra, rb, disp)                                          \
+    ((0x08 << 26) | ((ra) << 21) | ((rb) << 16) | ((disp) & 0xffff))
+#define AXP_TEST_ADDQ(ra, rb, rc)                                           \
+    ((0x10 << 26) | ((ra) << 21) | ((rb) << 16) | (0x20 << 5) | (rc))
+#define AXP_TEST_SUBQ_LIT(ra, lit, rc)                                      \
+    ((0x10 << 26) | ((ra) << 21) | ((lit) << 13) | (1 << 12) |             \
+     (0x29 << 5) | (rc))
+#define AXP_TEST_BR(ra, disp)                                               \
+    ((0x30 << 26) | ((ra) << 21) | ((disp) & 0x1fffff))
+
+#define AXP_TEST_BASE_PC    0x10000
+#define AXP_TEST_STREAM_LEN (sizeof(testStream) / sizeof(testStream[0]))
+
+/*
+ * The loop is run from the Kernel mode super page that maps VA<47:30> equal
+ * to 0x3fffe onto the low GB of physical memory.
+ */
+#define AXP_TEST_LOOP_VA    0x0000ffff80010000ll
+#define AXP_TEST_LOOP_PA    0x10000
+#define AXP_TEST_LOOP_LEN   (sizeof(testLoop) / sizeof(testLoop[0]))
+#define AXP_TEST_LOOP_RUNS  (AXP_XLATE_HOT + 8)
+
+/*
+ * For timing, the loop is also run from a page that is neither in a super
+ * page nor in the ITB, so it can never be translated.
+ */
+#define AXP_TEST_INTERP_VA  0x20000
+#define AXP_TEST_TIME_LOOPS 1000000
+
+/*
+ * The instruction stream.  The branch skips over the instruction after it.
+ */
+static const u32 testStream[] =
+{
+    AXP_TEST_LDA(1, 31, 5),         /* 0: LDA   r1, 5(r31)      */
+    AXP_TEST_LDA(2, 31, 7),         /* 1: LDA   r2, 7(r31)      */
+    AXP_TEST_ADDQ(1, 2, 3),         /* 2: ADDQ  r1, r2, r3      */
+    AXP_TEST_BR(4, 1),              /* 3: BR    r4, 5           */
+    AXP_TEST_LDA(9, 31, 1),         /* 4: LDA   r9, 1(r31)      */
+    AXP_TEST_SUBQ_LIT(3, 2, 5),     /* 5: SUBQ  r3, #2, r5      */
+    AXP_TEST_LDA(6, 31, -1),        /* 6: LDA   r6, -1(r31)     */
+    AXP_TEST_ADDQ(5, 6, 7),         /* 7: ADDQ  r5, r6, r7      */
+    AXP_TEST_ADDQ(7, 7, 8),         /* 8: ADDQ  r7, r7, r8      */
+    AXP_TEST_LDA(10, 31, 0),        /* 9: LDA   r10, 0(r31)     */
+    AXP_TEST_LDA(10, 31, 0),        /* 10: LDA  r10, 0(r31)     */
+    AXP_TEST_LDA(10, 31, 0),        /* 11: LDA  r10, 0(r31)     */
+    AXP_TEST_LDA(10, 31, 0),        /* 12: LDA  r10, 0(r31)     */
+    AXP_TEST_LDA(10, 31, 0),        /* 13: LDA  r10, 0(r31)     */
+    AXP_TEST_LDA(10, 31, 3),        /* 14: LDA  r10, 3(r31)     */
+    AXP_TEST_ADDQ(10, 10, 11),      /* 15: ADDQ r10, r10, r11   */
+    AXP_TEST_LDA(12, 31, 1),        /* 16: LDA  r12, 1(r31)     */
+    AXP_TEST_LDA(13, 31, 1)         /* 17: LDA  r13, 1(r31)     */
+};
+
+/*
+ * A loop that counts in r20 forever.
+ */
+static const u32 testLoop[] =
+{
+    AXP_TEST_LDA(20, 20, 1),        /* 0: LDA   r20, 1(r20)     */
+    AXP_TEST_BR(31, -2)             /* 1: BR    r31, 0          */
+};
+
+/*
+ * fetchLine
+ *  This function is called to fill in a fetched line of instructions, as the
+ *  Icache would, from the instruction stream.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure.
+ *  pc:
+ *      The PC of the first instruction to be fetched.
+ *  base:
+ *      The PC of the first instruction in the stream.
+ *  stream:
+ *      A pointer to the instruction stream.
+ *  len:
+ *      The number of instructions in the stream.
+ *
+ * Output Parameters:
+ *  next:
+ *      A pointer to the line to receive the fetched instructions.
+ *
+ * Return Value:
+ *  None.
+ */
+static void fetchLine(AXP_21264_CPU *cpu,
+                      AXP_PC pc,
+                      u64 base,
+                      const u32 *stream,
+                      u64 len,
+                      AXP_INS_LINE *next)
+{
+    u64 idx = (AXP_GET_PC(pc) - base) / sizeof(u32);
+    u32 offset = AXP_GET_PC(pc) / sizeof(u32) % AXP_ICACHE_LINE_INS;
+    u32 ii;
+
+    /*
+     * Like the Icache, stop at the end of the Icache block.
+     */
+    memset(next, 0, sizeof(AXP_INS_LINE));
+    next->instrCount = AXP_NUM_FETCH_INS;
+    if ((offset + AXP_NUM_FETCH_INS) > AXP_ICACHE_LINE_INS)
+    {
+        next->instrCount = AXP_ICACHE_LINE_INS - offset;
+    }
+    for (ii = 0; ii < next->instrCount; ii++)
+    {
+        next->instructions[ii].instr =
+            ((idx + ii) < len) ?
+                stream[idx + ii] :
+                AXP_TEST_LDA(31, 31, 0);
+        next->instrPC[ii] = AXP_21264_MakeVPC(cpu,
+                                              AXP_GET_PC(pc) +
+                                                  (ii * sizeof(u32)),
+                                              0);
+    }
+    return;
+}
+
+/*
+ * checkReg
+ *  This function is called to check the value in an integer register.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure.
+ *  reg:
+ *      The architectural register to be checked.
+ *  expected:
+ *      The value the register should contain.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The number of errors found (0 or 1).
+ */
+static int checkReg(AXP_21264_CPU *cpu, int reg, u64 expected)
+{
+    u64 value = cpu->pr[cpu->prMap[reg]].value;
+
+    if (value != expected)
+    {
+        printf("R%d is 0x%016llx, expected 0x%016llx\n",
+               reg,
+               value,
+               expected);
+        return (1);
+    }
+    return (0);
+}
+
+/*
+ * timeLoop
+ *  This function is called to run the loop until it has gone around a number
+ *  of times, and time how long that took.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure.
+ *  va:
+ *      The virtual address of the first instruction of the loop.
+ *  loops:
+ *      The number of times to go around the loop.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The nanoseconds for each time around the loop.
+ */
+static double timeLoop(AXP_21264_CPU *cpu, u64 va, u64 loops)
+{
+    struct timespec start, end;
+    AXP_INS_LINE next;
+    AXP_PC pc = AXP_21264_MakeVPC(cpu, va, 0);
+    u64 first = cpu->pr[cpu->prMap[20]].value;
+    u64 count;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do
+    {
+        fetchLine(cpu, pc, va, testLoop, AXP_TEST_LOOP_LEN, &next);
+        pthread_mutex_lock(&cpu->iBoxMutex);
+        AXP_21264_Ibox_Functional(cpu, &next);
+        pthread_mutex_unlock(&cpu->iBoxMutex);
+        pc = AXP_21264_GetNextVPC(cpu);
+        count = cpu->pr[cpu->prMap[20]].value - first;
+    } while (count < loops);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return ((((end.tv_sec - start.tv_sec) * 1e9) +
+             (end.tv_nsec - start.tv_nsec)) / count);
+}
+
+int main()
+{
+    AXP_21264_CPU *cpu;
+    AXP_INS_LINE next;
+    AXP_PC pc;
+    int errors = 0;
+    int ii;
+
+    printf("\nAXP 21264 Ibox Functional Mode Tester\n");
+    cpu = (AXP_21264_CPU *) calloc(1, sizeof(AXP_21264_CPU));
+    if (cpu == NULL)
+    {
+        printf("Unable to allocate the CPU\n");
+        return (-1);
+    }
+    pthread_mutex_init(&cpu->iBoxMutex, NULL);
+    pthread_mutex_init(&cpu->robMutex, NULL);
+    pthread_mutex_init(&cpu->lqMutex, NULL);
+    pthread_mutex_init(&cpu->sqMutex, NULL);
+    pthread_cond_init(&cpu->iBoxCondition, NULL);
+    cpu->cpuState = Run;
+    cpu->execMode = FunctionalMode;
+
+    /*
+     * Nothing is renamed in functional mode, so each architectural register
+     * is simply mapped to the physical register of the same number.
+     */
+    for (ii = 0; ii < AXP_MAX_INT_REGISTERS; ii++)
+    {
+        cpu->prMap[ii] = ii;
+    }
+    for (ii = 0; ii < AXP_MAX_FP_REGISTERS; ii++)
+    {
+        cpu->pfMap[ii] = ii;
+    }
+
+    /*
+     * The first line stops at the branch, which goes to the instruction after
+     * the next one.
+     */
+    printf("    Executing up to and including a taken branch...\n");
+    pc = AXP_21264_MakeVPC(cpu, AXP_TEST_BASE_PC, 0);
+    fetchLine(cpu,
+              pc,
+              AXP_TEST_BASE_PC,
+              testStream,
+              AXP_TEST_STREAM_LEN,
+              &next);
+    pthread_mutex_lock(&cpu->iBoxMutex);
+    AXP_21264_Ibox_Functional(cpu, &next);
+    pthread_mutex_unlock(&cpu->iBoxMutex);
+    errors += checkReg(cpu, 1, 5);
+    errors += checkReg(cpu, 2, 7);
+    errors += checkReg(cpu, 3, 12);
+    errors += checkReg(cpu, 4, AXP_TEST_BASE_PC + (4 * sizeof(u32)));
+    pc = AXP_21264_GetNextVPC(cpu);
+    if (AXP_GET_PC(pc) != (AXP_TEST_BASE_PC + (5 * sizeof(u32))))
+    {
+        printf("Next PC after the branch is 0x%016llx\n",
+               (u64) AXP_GET_PC(pc));
+        errors++;
+    }
+
+    /*
+     * The second line runs from the branch target to the end of the line.
+     */
+    printf("    Executing from the branch target...\n");
+    if (errors == 0)
+    {
+        fetchLine(cpu,
+                  pc,
+                  AXP_TEST_BASE_PC,
+                  testStream,
+                  AXP_TEST_STREAM_LEN,
+                  &next);
+        pthread_mutex_lock(&cpu->iBoxMutex);
+        AXP_21264_Ibox_Functional(cpu, &next);
+        pthread_mutex_unlock(&cpu->iBoxMutex);
+        errors += checkReg(cpu, 5, 10);
+        errors += checkReg(cpu, 6, (u64) -1);
+        errors += checkReg(cpu, 7, 9);
+        errors += checkReg(cpu, 8, 18);
+        errors += checkReg(cpu, 9, 0);
+        pc = AXP_21264_GetNextVPC(cpu);
+        if (AXP_GET_PC(pc) != (AXP_TEST_BASE_PC + (9 * sizeof(u32))))
+        {
+            printf("Next PC after the line is 0x%016llx\n",
+                   (u64) AXP_GET_PC(pc));
+            errors++;
+        }
+    }
+
+    /*
+     * A line fetched two instructions before the end of the Icache block
+     * stops at the end of the block.
+     */
+    printf("    Executing up to the end of the Icache block...\n");
+    if (errors == 0)
+    {
+        pc = AXP_21264_MakeVPC(cpu,
+                               AXP_TEST_BASE_PC +
+                                   ((AXP_ICACHE_LINE_INS - 2) * sizeof(u32)),
+                               0);
+        fetchLine(cpu,
+                  pc,
+                  AXP_TEST_BASE_PC,
+                  testStream,
+                  AXP_TEST_STREAM_LEN,
+                  &next);
+        pthread_mutex_lock(&cpu->iBoxMutex);
+        AXP_21264_Ibox_Functional(cpu, &next);
+        pthread_mutex_unlock(&cpu->iBoxMutex);
+        errors += checkReg(cpu, 10, 3);
+        errors += checkReg(cpu, 11, 6);
+        errors += checkReg(cpu, 12, 0);
+        errors += checkReg(cpu, 13, 0);
+        pc = AXP_21264_GetNextVPC(cpu);
+        if (AXP_GET_PC(pc) !=
+            (AXP_TEST_BASE_PC + (AXP_ICACHE_LINE_INS * sizeof(u32))))
+        {
+            printf("Next PC after the block is 0x%016llx\n",
+                   (u64) AXP_GET_PC(pc));
+            errors++;
+        }
+    }
+
+    /*
+     * Run the first line again, with the switch to detailed mode requested
+     * after two more instructions have been retired.  The third instruction
+     * is not executed until after switching back.
+     */
+    printf("    Switching execution modes part way through a line...\n");
+    if (errors == 0)
+    {
+        for (ii = 1; ii <= 4; ii++)
+        {
+            cpu->pr[cpu->prMap[ii]].value = 0;
+        }
+        cpu->execModeSwitch = cpu->counters.value[AXP_CNT_RETIRED] + 2;
+        pc = AXP_21264_MakeVPC(cpu, AXP_TEST_BASE_PC, 0);
+        fetchLine(cpu,
+                  pc,
+                  AXP_TEST_BASE_PC,
+                  testStream,
+                  AXP_TEST_STREAM_LEN,
+                  &next);
+        pthread_mutex_lock(&cpu->iBoxMutex);
+        AXP_21264_Ibox_Functional(cpu, &next);
+        if ((cpu->execModeChange != true) ||
+            (cpu->execModeReq != DetailedMode) ||
+            (AXP_21264_Ibox_ExecModeChange(cpu) != true) ||
+            (cpu->execMode != DetailedMode))
+        {
+            printf("Did not switch to detailed mode\n");
+            errors++;
+        }
+        pthread_mutex_unlock(&cpu->iBoxMutex);
+        errors += checkReg(cpu, 1, 5);
+        errors += checkReg(cpu, 2, 7);
+        errors += checkReg(cpu, 3, 0);
+        pc = AXP_21264_GetNextVPC(cpu);
+        if (AXP_GET_PC(pc) != (AXP_TEST_BASE_PC + (2 * sizeof(u32))))
+        {
+            printf("Next PC after switching modes is 0x%016llx\n",
+                   (u64) AXP_GET_PC(pc));
+            errors++;
+        }
+    }
+
+    /*
+     * Switch back, the way another thread would, and run the rest of the
+     * line.  Everything ends up as it did the first time through.
+     */
+    if (errors == 0)
+    {
+        AXP_21264_Ibox_SetExecMode(cpu, FunctionalMode);
+        pthread_mutex_lock(&cpu->iBoxMutex);
+        if ((cpu->execModeChange != true) ||
+            (AXP_21264_Ibox_ExecModeChange(cpu) != true) ||
+            (cpu->execMode != FunctionalMode))
+        {
+            printf("Did not switch back to functional mode\n");
+            errors++;
+        }
+        else
+        {
+            fetchLine(cpu,
+                      pc,
+                      AXP_TEST_BASE_PC,
+                      testStream,
+                      AXP_TEST_STREAM_LEN,
+                      &next);
+            AXP_21264_Ibox_Functional(cpu, &next);
+        }
+        pthread_mutex_unlock(&cpu->iBoxMutex);
+        errors += checkReg(cpu, 1, 5);
+        errors += checkReg(cpu, 2, 7);
+        errors += checkReg(cpu, 3, 12);
+        errors += checkReg(cpu, 4, AXP_TEST_BASE_PC + (4 * sizeof(u32)));
+        pc = AXP_21264_GetNextVPC(cpu);
+        if ((AXP_GET_PC(pc) != (AXP_TEST_BASE_PC + (5 * sizeof(u32)))) ||
+            (cpu->execModeSwitch != 0))
+        {
+            printf("Next PC after switching back is 0x%016llx\n",
+                   (u64) AXP_GET_PC(pc));
+            errors++;
+        }
+    }
+
+    /*
+     * Run the loop from the super page until it has been translated and run
+     * from the translation.  Each time around, the loop is fetched from the
+     * branch target.
+     */
+    printf("    Translating a loop run from a super page...\n");
+    if (errors == 0)
+    {
+        cpu->iCtl.spe = AXP_SPE0_BIT;
+        cpu->ierCm.cm = AXP_CM_KERNEL;
+        pc = AXP_21264_MakeVPC(cpu, AXP_TEST_LOOP_VA, 0);
+        for (ii = 0; ii < AXP_TEST_LOOP_RUNS; ii++)
+        {
+            fetchLine(cpu,
+                      pc,
+                      AXP_TEST_LOOP_VA,
+                      testLoop,
+                      AXP_TEST_LOOP_LEN,
+                      &next);
+            pthread_mutex_lock(&cpu->iBoxMutex);
+            AXP_21264_Ibox_Functional(cpu, &next);
+            pthread_mutex_unlock(&cpu->iBoxMutex);
+            pc = AXP_21264_GetNextVPC(cpu);
+        }
+        if ((cpu->xlateTranslated != 1) || (cpu->xlateExecuted == 0))
+        {
+            printf("Loop not translated, translated = %llu, executed = %llu\n",
+                   cpu->xlateTranslated,
+                   cpu->xlateExecuted);
+            errors++;
+        }
+        if (AXP_GET_PC(pc) != AXP_TEST_LOOP_VA)
+        {
+            printf("Next PC after the loop is 0x%016llx\n",
+                   (u64) AXP_GET_PC(pc));
+            errors++;
+        }
+        if (cpu->pr[cpu->prMap[20]].value <= AXP_TEST_LOOP_RUNS)
+        {
+            printf("Loop only ran %llu times\n",
+                   cpu->pr[cpu->prMap[20]].value);
+            errors++;
+        }
+    }
+
+    /*
+     * A store to some other page leaves the translation alone.  A store to
+     * the physical page of the loop discards it.
+     */
+    printf("    Storing to the physical page of the loop...\n");
+    if (errors == 0)
+    {
+        AXP_21264_Xlate_CodeWrite(cpu,
+                                  AXP_TEST_LOOP_PA + AXP_21264_PAGE_SIZE);
+        if (cpu->xlateFlushes != 0)
+        {
+            printf("Translations discarded by a store to another page\n");
+            errors++;
+        }
+        AXP_21264_Xlate_CodeWrite(cpu, AXP_TEST_LOOP_PA + sizeof(u64));
+        if (cpu->xlateFlushes != 1)
+        {
+            printf("Translations not discarded by a store to the loop\n");
+            errors++;
+        }
+    }
+
+    /*
+     * After the store, the loop is fetched and executed again, rather than
+     * run from the discarded translation.
+     */
+    if (errors == 0)
+    {
+        u64 executed = cpu->xlateExecuted;
+        u64 count = cpu->pr[cpu->prMap[20]].value;
+
+        fetchLine(cpu,
+                  pc,
+                  AXP_TEST_LOOP_VA,
+                  testLoop,
+                  AXP_TEST_LOOP_LEN,
+                  &next);
+        pthread_mutex_lock(&cpu->iBoxMutex);
+        AXP_21264_Ibox_Functional(cpu, &next);
+        pthread_mutex_unlock(&cpu->iBoxMutex);
+        if ((cpu->xlateExecuted != executed) ||
+            (cpu->pr[cpu->prMap[20]].value != (count + 1)))
+        {
+            printf("Discarded translation was executed\n");
+            errors++;
+        }
+    }
+
+    /*
+     * Time the loop interpreted and then translated.  The translation was
+     * discarded above, so the loop is profiled and recorded again first.
+     */
+    printf("    Timing the loop interpreted and translated...\n");
+    if (errors == 0)
+    {
+        u64 executed = cpu->xlateExecuted;
+        double interpreted, translated;
+
+        interpreted = timeLoop(cpu, AXP_TEST_INTERP_VA, AXP_TEST_TIME_LOOPS);
+        if (cpu->xlateExecuted != executed)
+        {
+            printf("Loop that cannot be tracked was translated\n");
+            errors++;
+        }
+        translated = timeLoop(cpu, AXP_TEST_LOOP_VA, AXP_TEST_TIME_LOOPS);
+        if (cpu->xlateExecuted == executed)
+        {
+            printf("Loop in the super page was not translated\n");
+            errors++;
+        }
+        printf("        Interpreted: %8.1f ns per loop\n", interpreted);
+        printf("        Translated:  %8.1f ns per loop\n", translated);
+        printf("        Speed-up:    %8.1fx\n", interpreted / translated);
+    }
+
+    /*
+     * Nothing was left in-flight.
+     */
+    if ((errors == 0) &&
+        ((cpu->robStart != cpu->robEnd) || (cpu->excPend == true)))
+    {
+        printf("Instructions left in-flight or an exception pending\n");
+        errors++;
+    }
+    free(cpu);
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
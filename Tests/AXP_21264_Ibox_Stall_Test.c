@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to test the Ibox waiting for
+ *  room in the ROB.  A thread, standing in for the Ibox, waits with the ROB
+ *  full, while the oldest instruction is completed, either by the Mbox
+ *  completion routine or by a pipeline, at the same time.  If the Ibox misses
+ *  the wakeup, it never retires the instruction and the test fails.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CPU/AXP_21264_CPU.h"
+#include "CPU/Ibox/AXP_21264_Ibox.h"
+#include "CPU/Ebox/AXP_21264_Ebox.h"
+
+#define AXP_TEST_ITERATIONS 2000
+#define AXP_TEST_WAIT_USEC  5000000
+
+static bool ready;
+
+/*
+ * iboxWait
+ *  This function is the thread that stands in for the Ibox.  With the Ibox
+ *  mutex locked, as the Ibox always has it, it waits for room in the ROB.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      A pointer to the CPU structure.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  NULL.
+ */
+static void *iboxWait(void *voidPtr)
+{
+    AXP_21264_CPU *cpu = (AXP_21264_CPU *) voidPtr;
+
+    pthread_mutex_lock(&cpu->iBoxMutex);
+    AXP_21264_Ibox_WaitForROB(cpu);
+    __atomic_store_n(&ready, true, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&cpu->iBoxMutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return (NULL);
+}
+
+/*
+ * fillROB
+ *  This function is called to fill the ROB with instructions that are still
+ *  executing.  They do not write a register, so retiring them has nothing
+ *  else to do.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  None.
+ */
+static void fillROB(AXP_21264_CPU *cpu)
+{
+    int ii;
+
+    memset(cpu->rob, 0, sizeof(cpu->rob));
+    for (ii = 0; ii < AXP_INFLIGHT_MAX; ii++)
+    {
+        cpu->rob[ii].opcode = INTA;
+        cpu->rob[ii].type = Oper;
+        cpu->rob[ii].excRegMask = NoException;
+        cpu->rob[ii].state = Executing;
+    }
+    cpu->robStart = 0;
+    cpu->robEnd = AXP_INFLIGHT_MAX - 1;
+    return;
+}
+
+int main()
+{
+    AXP_21264_CPU *cpu;
+    AXP_RETIRE_STATS stats;
+    pthread_t ibox;
+    int errors = 0;
+    int ii, waited;
+
+    printf("\nAXP 21264 Ibox Stall Tester\n");
+    cpu = (AXP_21264_CPU *) calloc(1, sizeof(AXP_21264_CPU));
+    if (cpu == NULL)
+    {
+        printf("Unable to allocate the CPU\n");
+        return (-1);
+    }
+    pthread_mutex_init(&cpu->iBoxMutex, NULL);
+    pthread_mutex_init(&cpu->robMutex, NULL);
+    pthread_cond_init(&cpu->iBoxCondition, NULL);
+    cpu->cpuState = Run;
+    cpu->execMode = DetailedMode;
+
+    /*
+     * The oldest instruction is completed while the Ibox is getting ready to
+     * wait, or after it has.  Every other time, it is a load completed by the
+     * Mbox, otherwise it is an instruction completed by a pipeline.
+     */
+    printf("    Completing instructions while the ROB is full...\n");
+    for (ii = 0; (ii < AXP_TEST_ITERATIONS) && (errors == 0); ii++)
+    {
+        fillROB(cpu);
+        ready = false;
+        pthread_create(&ibox, NULL, iboxWait, cpu);
+        if ((ii % 4) >= 2)
+        {
+            usleep(100);
+        }
+        if ((ii % 2) == 0)
+        {
+            AXP_21264_Ebox_Compl(cpu, &cpu->rob[0]);
+        }
+        else
+        {
+            pthread_mutex_lock(&cpu->robMutex);
+            cpu->rob[0].state = WaitingRetirement;
+            pthread_mutex_unlock(&cpu->robMutex);
+            AXP_21264_Ibox_Completed(cpu);
+        }
+
+        /*
+         * If the wakeup was missed, the Ibox is going to wait forever.
+         */
+        for (waited = 0;
+             (__atomic_load_n(&ready, __ATOMIC_ACQUIRE) == false) &&
+              (waited < AXP_TEST_WAIT_USEC);
+             waited += 1000)
+        {
+            usleep(1000);
+        }
+        if (__atomic_load_n(&ready, __ATOMIC_ACQUIRE) == false)
+        {
+            printf("Ibox missed the wakeup on iteration %d\n", ii);
+            errors++;
+            break;
+        }
+        pthread_join(ibox, NULL);
+        if ((cpu->robStart != 1) ||
+            (cpu->rob[0].state != Retired) ||
+            (cpu->stallWaitingRetirement == true))
+        {
+            printf("Oldest instruction not retired on iteration %d, "
+                   "start = %u\n",
+                   ii,
+                   cpu->robStart);
+            errors++;
+        }
+    }
+
+    /*
+     * Every wait for room in the ROB is counted, once.
+     */
+    AXP_21264_Ibox_RetireStats(cpu, &stats);
+    if ((errors == 0) &&
+        ((stats.stalls[AXP_RETIRE_ROB_FULL] != AXP_TEST_ITERATIONS) ||
+         (stats.retired != AXP_TEST_ITERATIONS)))
+    {
+        printf("Retirement statistics not as expected, stalls = %llu, "
+               "retired = %llu\n",
+               stats.stalls[AXP_RETIRE_ROB_FULL],
+               stats.retired);
+        errors++;
+    }
+
+    /*
+     * The Ibox does not wait when the CPU is no longer running.
+     */
+    printf("    Waiting for room in the ROB when not running...\n");
+    if (errors == 0)
+    {
+        fillROB(cpu);
+        cpu->cpuState = ShuttingDown;
+        pthread_mutex_lock(&cpu->iBoxMutex);
+        if (AXP_21264_Ibox_WaitForROB(cpu) == true)
+        {
+            printf("Room in the ROB when there should not be\n");
+            errors++;
+        }
+        pthread_mutex_unlock(&cpu->iBoxMutex);
+    }
+    free(cpu);
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
@@ -29,6 +29,22 @@
  *
  *  V01.002 09-Jun-2019 Jonathan D. Belanger
  *  Reformatted the code to remove tabs and correct other formatting issues.
+ *
+ *  V01.003 15-Oct-2026 Jonathan D. Belanger
+ *  Check that the predecoded instructions returned from the Icache match the
+ *  instructions returned with them.
+ *
+ *  V01.004 15-Oct-2026 Jonathan D. Belanger
+ *  Added a test that fetches from the Icache while other threads keep filling
+ *  the same block, to make sure fetches are never torn now that they do not
+ *  lock the Icache mutex.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Only look at the instructions the Icache says are valid, starting with the
+ *  one at the PC, and added a test that a fetch near the end of a block stops
+ *  at the end of the block.  The instructions past the end of the block were
+ *  how the loops in the branch table were left, so the test now stops after a
+ *  fixed number of instructions.
  */
 #include "CommonUtilities/AXP_Blocks.h"
 #include "CPU/AXP_21264_CPU.h"
@@ -223,6 +239,209 @@ static u32 memory[] =
 };
 
 #define AXP_NUMBER_OR_BRANCHES 15
+#define AXP_FILL_THREADS        2
+#define AXP_FILL_COUNT          100000
+#define AXP_FETCH_COUNT         1000000
+#define AXP_MAX_INSTRUCTIONS    8192
+
+/*
+ * The information passed to each of the fill threads.
+ */
+typedef struct
+{
+    AXP_21264_CPU *cpu;
+    AXP_21264_TLB *itb;
+    u32 *block;
+    volatile bool *stop;
+} AXP_FILL_ARGS;
+
+/*
+ * fillThread
+ *  This function is the thread that keeps filling the Icache block at PC 0
+ *  with the same instructions, like the Cbox would do for Icache misses.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      A pointer to the fill arguments.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  NULL.
+ */
+static void *fillThread(void *voidPtr)
+{
+    AXP_FILL_ARGS *args = (AXP_FILL_ARGS *) voidPtr;
+    AXP_PC pc = {.pc = 0};
+    int ii;
+
+    for (ii = 0; ((ii < AXP_FILL_COUNT) && (*args->stop == false)); ii++)
+    {
+        AXP_IcacheAdd(args->cpu, pc, args->block, args->itb);
+    }
+    return (NULL);
+}
+
+/*
+ * concurrentFetch
+ *  This function fetches the instructions at PC 0 while a number of threads
+ *  keep filling the block with one of two different sets of instructions.
+ *  Each fetch must return the first four instructions of one set or the
+ *  other, never a mixture of the two, with predecoded instructions that match.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The number of torn fetches.
+ */
+static int concurrentFetch(void)
+{
+    AXP_21264_CPU *cpu;
+    AXP_21264_TLB *itb;
+    AXP_FILL_ARGS args[AXP_FILL_THREADS];
+    pthread_t threads[AXP_FILL_THREADS];
+    AXP_INS_LINE nextLine;
+    AXP_PC pc = {.pc = 0};
+    volatile bool stop = false;
+    u32 *block;
+    int tornCnt = 0;
+    int hitCnt = 0;
+    int ii, jj;
+
+    cpu = (AXP_21264_CPU *) AXP_Allocate_Block(AXP_21264_CPU_BLK);
+    cpu->iCtl.ic_en = 3;
+    AXP_addTLBEntry(cpu, 0, 0, false);
+    itb = AXP_findTLBEntry(cpu, 0, false);
+    AXP_IcacheAdd(cpu, pc, &memory[0], itb);
+    for (ii = 0; ii < AXP_FILL_THREADS; ii++)
+    {
+        args[ii].cpu = cpu;
+        args[ii].itb = itb;
+        args[ii].block = &memory[AXP_ICACHE_LINE_INS * (ii + 1)];
+        args[ii].stop = &stop;
+        pthread_create(&threads[ii], NULL, fillThread, &args[ii]);
+    }
+    for (ii = 0; ii < AXP_FETCH_COUNT; ii++)
+    {
+        nextLine.setPrediction = 0;
+        if (AXP_IcacheFetch(cpu, pc, &nextLine) == false)
+        {
+            continue;
+        }
+        hitCnt++;
+
+        /*
+         * Figure out which block we got from the first instruction, and make
+         * sure all the others came from the same one.
+         */
+        block = &memory[0];
+        for (jj = 0; jj <= AXP_FILL_THREADS; jj++)
+        {
+            if (nextLine.instructions[0].instr ==
+                memory[AXP_ICACHE_LINE_INS * jj])
+            {
+                block = &memory[AXP_ICACHE_LINE_INS * jj];
+            }
+        }
+        for (jj = 0; jj < AXP_NUM_FETCH_INS; jj++)
+        {
+            if ((nextLine.instructions[jj].instr != block[jj]) ||
+                (nextLine.predecoded[jj].valid == false) ||
+                (nextLine.predecoded[jj].instr.instr != block[jj]))
+            {
+                tornCnt++;
+                break;
+            }
+        }
+    }
+    stop = true;
+    for (ii = 0; ii < AXP_FILL_THREADS; ii++)
+    {
+        pthread_join(threads[ii], NULL);
+    }
+
+    printf("Concurrent fetches:              %d\n", hitCnt);
+    printf("    Torn fetches:                %d\n", tornCnt);
+    printf("    Fetch retries:               %llu\n", cpu->iCacheReadRetries);
+    printf("    Fill waits for the mutex:    %llu\n\n", cpu->iCacheWriteWaits);
+    AXP_Deallocate_Block(cpu);
+    return (tornCnt);
+}
+
+/*
+ * blockEndFetch
+ *  This function fetches the instructions two before the end of an Icache
+ *  block.  Only those two instructions are in the block, so only they are
+ *  returned, and the slots after them are not valid.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  The number of errors found.
+ */
+static int blockEndFetch(void)
+{
+    AXP_21264_CPU *cpu;
+    AXP_21264_TLB *itb;
+    AXP_INS_LINE nextLine;
+    AXP_PC pc = {.pc = 0};
+    u32 offset = AXP_ICACHE_LINE_INS - 2;
+    int errors = 0;
+    u32 ii;
+
+    cpu = (AXP_21264_CPU *) AXP_Allocate_Block(AXP_21264_CPU_BLK);
+    cpu->iCtl.ic_en = 3;
+    AXP_addTLBEntry(cpu, 0, 0, false);
+    itb = AXP_findTLBEntry(cpu, 0, false);
+    AXP_IcacheAdd(cpu, pc, &memory[0], itb);
+    pc.pc = offset;
+    nextLine.setPrediction = 0;
+    if (AXP_IcacheFetch(cpu, pc, &nextLine) == false)
+    {
+        printf("Fetch at the end of the block missed\n");
+        errors++;
+    }
+    else if (nextLine.instrCount != (AXP_ICACHE_LINE_INS - offset))
+    {
+        printf("Fetch at the end of the block returned %u instructions\n",
+               nextLine.instrCount);
+        errors++;
+    }
+    else
+    {
+        for (ii = 0; ii < AXP_NUM_FETCH_INS; ii++)
+        {
+            if ((ii < nextLine.instrCount) &&
+                ((nextLine.instructions[ii].instr != memory[offset + ii]) ||
+                 (nextLine.predecoded[ii].valid == false)))
+            {
+                printf("Instruction %u at the end of the block is 0x%08x\n",
+                       ii,
+                       nextLine.instructions[ii].instr);
+                errors++;
+            }
+            else if ((ii >= nextLine.instrCount) &&
+                     (nextLine.predecoded[ii].valid == true))
+            {
+                printf("Slot %u after the end of the block is valid\n", ii);
+                errors++;
+            }
+        }
+    }
+    printf("Fetches at the end of a block:   %s\n\n",
+           (errors == 0) ? "Passed" : "Failed");
+    AXP_Deallocate_Block(cpu);
+    return (errors);
+}
 
 /*
  * main
@@ -243,6 +462,9 @@ int main()
     bool done = false;
     bool branchTaken = false;
     int hitCnt, cacheMissCnt, ITBMissCnt, cycleCnt, instrCnt;
+    int predecodeErrCnt = 0;
+    int tornCnt;
+    int blockEndCnt;
     int jj;
     u64 ii;
     AXP_21264_TLB *itb;
@@ -289,7 +511,12 @@ int main()
     nextLine.linePrediction = 0;
     nextLine.setPrediction = 0;
 
-    while (!done)
+    /*
+     * The branches taken are driven by the table above, not by the
+     * instructions, and some of its loops never exit.  So, stop after a fixed
+     * number of instructions, if the end of the program is not reached first.
+     */
+    while (!done && (instrCnt < AXP_MAX_INSTRUCTIONS))
     {
 
         /*
@@ -299,8 +526,28 @@ int main()
         {
             hitCnt++;
             branchTaken = false;
-            for (ii = (pc.vpc.pc % sizeof(AXP_INS_FMT));
-                 ((ii < AXP_NUM_FETCH_INS) && !done && !branchTaken);
+
+            /*
+             * The predecoded instructions should always be valid and for the
+             * instructions returned with them.
+             */
+            for (ii = 0; ii < nextLine.instrCount; ii++)
+            {
+                if ((nextLine.predecoded[ii].valid == false) ||
+                    (nextLine.predecoded[ii].instr.instr !=
+                     nextLine.instructions[ii].instr) ||
+                    (nextLine.predecoded[ii].format !=
+                     AXP_InstructionFormat(nextLine.instructions[ii])))
+                {
+                    printf("Predecoded instruction 0x%08x does not match "
+                           "0x%08x\n",
+                           nextLine.predecoded[ii].instr.instr,
+                           nextLine.instructions[ii].instr);
+                    predecodeErrCnt++;
+                }
+            }
+            for (ii = 0;
+                 ((ii < nextLine.instrCount) && !done && !branchTaken);
                  ii++)
             {
 
@@ -452,5 +699,11 @@ int main()
            ((float)(hitCnt+cacheMissCnt+ITBMissCnt)/(float)cycleCnt));
     printf("Instructions per cycle:          %5.2f\n\n",
            ((float)instrCnt/(float)cycleCnt));
-    return(0);
+    printf("Predecode mismatches:            %d\n\n",
+           predecodeErrCnt);
+    AXP_Deallocate_Block(cpu);
+    tornCnt = concurrentFetch();
+    blockEndCnt = blockEndFetch();
+    return(((predecodeErrCnt == 0) && (tornCnt == 0) && (blockEndCnt == 0)) ?
+           0 : -1);
 }
@@ -0,0 +1,750 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to test the Mbox LQ and SQ
+ *  processing.  The Mbox functions are called directly, without the Mbox
+ *  thread, so that the state of the queues and work lists can be checked
+ *  after each step.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Added tests for forwarding store data to loads, and for replaying loads
+ *  that read stale data.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Added tests for the Cbox reading and writing memory blocks directly from
+ *  and to host memory.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Added tests for a full LQ, and for an aborted load that faults giving back
+ *  its LQ entry.
+ *
+ *  V01.004 16-Oct-2026 Jonathan D. Belanger
+ *  Added a test for reading memory blocks through the System, with the Cchip
+ *  responding to the MAF entries sent to it.
+ *
+ *  V01.005 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped lines longer than 80 columns.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CPU/AXP_21264_CPU.h"
+#include "CPU/Mbox/AXP_21264_Mbox.h"
+#include "CPU/Ebox/AXP_21264_Ebox.h"
+#include "CPU/Fbox/AXP_21264_Fbox.h"
+#include "CPU/Cbox/AXP_21264_Cbox.h"
+#include "CPU/Cbox/SystemInterface/AXP_21264_to_System.h"
+#include "Motherboard/AXP_21274_System.h"
+#include "Motherboard/AXP_21274_InitRoutines.h"
+#include "Motherboard/AXP_21274_Memory.h"
+
+#define AXP_TEST_IO_ADDR    0x0000080000001000ll
+#define AXP_TEST_MEM_ADDR   0x0000000000002000ll
+#define AXP_TEST_DIRECT_ADDR 0x0000000000010000ll
+#define AXP_TEST_SYSTEM_ADDR 0x0000000000020000ll
+#define AXP_TEST_ARRAY_SIZE (64ll * ONE_M)
+#define AXP_TEST_WAIT_SEC   5
+
+/*
+ * issueStore
+ *  This function is called to get an SQ slot for a store, and have the Mbox
+ *  process it.  The store misses the caches, so it stays in the SQ waiting on
+ *  the Cbox.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure.
+ *  opcode:
+ *      A value indicating the store instruction.
+ *  uniqueID:
+ *      A value indicating the age of the instruction.
+ *  pa:
+ *      A value indicating the address to be written.
+ *  value:
+ *      A value indicating the data to be written.
+ *
+ * Output Parameters:
+ *  instr:
+ *      A pointer to the instruction to be set up for the store.
+ *
+ * Return Values:
+ *  The SQ slot assigned to the store.
+ */
+static u32 issueStore(AXP_21264_CPU *cpu,
+                      AXP_INSTRUCTION *instr,
+                      u8 opcode,
+                      u8 uniqueID,
+                      u64 pa,
+                      u64 value)
+{
+    u32 slot;
+
+    memset(instr, 0, sizeof(AXP_INSTRUCTION));
+    instr->opcode = opcode;
+    instr->pc.pal = AXP_PAL_MODE;
+    instr->uniqueID = uniqueID;
+    instr->src1v.r.uq = value;
+    slot = AXP_21264_Mbox_GetSQSlot(cpu, instr);
+    AXP_21264_Mbox_WriteMem(cpu, instr, slot, pa, value);
+    AXP_21264_Mbox_Process_Q(cpu);
+    return (slot);
+}
+
+/*
+ * issueLoad
+ *  This function is called to get an LQ slot for a load, and have the Mbox
+ *  process it.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure.
+ *  opcode:
+ *      A value indicating the load instruction.
+ *  uniqueID:
+ *      A value indicating the age of the instruction.
+ *  pa:
+ *      A value indicating the address to be read.
+ *
+ * Output Parameters:
+ *  instr:
+ *      A pointer to the instruction to be set up for the load.
+ *
+ * Return Values:
+ *  The LQ slot assigned to the load.
+ */
+static u32 issueLoad(AXP_21264_CPU *cpu,
+                     AXP_INSTRUCTION *instr,
+                     u8 opcode,
+                     u8 uniqueID,
+                     u64 pa)
+{
+    u32 slot;
+
+    memset(instr, 0, sizeof(AXP_INSTRUCTION));
+    instr->opcode = opcode;
+    instr->pc.pal = AXP_PAL_MODE;
+    instr->uniqueID = uniqueID;
+    slot = AXP_21264_Mbox_GetLQSlot(cpu, instr);
+    AXP_21264_Mbox_ReadMem(cpu, instr, slot, pa);
+    AXP_21264_Mbox_Process_Q(cpu);
+    return (slot);
+}
+
+/*
+ * checkWork
+ *  This function is called to check that the Mbox work lists contain what is
+ *  expected.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure.
+ *  test:
+ *      A pointer to the name of the test step.
+ *  lqWork:
+ *      A pointer to the expected LQ work lists.
+ *  sqWork:
+ *      A pointer to the expected SQ work lists.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int checkWork(AXP_21264_CPU *cpu,
+                     const char *test,
+                     const u32 *lqWork,
+                     const u32 *sqWork)
+{
+    int errors = 0;
+    int ii;
+
+    for (ii = 0; ii < AXP_MBOX_WORK_MAX; ii++)
+    {
+        if ((cpu->lqWork[ii] != lqWork[ii]) || (cpu->sqWork[ii] != sqWork[ii]))
+        {
+            printf("%s: work list %d is 0x%08x/0x%08x, "
+                   "expected 0x%08x/0x%08x\n",
+                   test,
+                   ii,
+                   cpu->lqWork[ii],
+                   cpu->sqWork[ii],
+                   lqWork[ii],
+                   sqWork[ii]);
+            errors++;
+        }
+    }
+    return (errors);
+}
+
+/*
+ * main
+ *  This function is called by the image activator to run the test.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  All tests passed.
+ *  -1: A test failed.
+ */
+int main()
+{
+    const u32 none[AXP_MBOX_WORK_MAX] = {0, 0, 0};
+    u32 expected[AXP_MBOX_WORK_MAX];
+    AXP_21264_CPU *cpu;
+    AXP_INSTRUCTION load[2];
+    AXP_INSTRUCTION store;
+    AXP_INSTRUCTION stores[4];
+    u64 data = 0x1122334455667788ll;
+    AXP_21274_SYSTEM *sys;
+    struct timespec deadline;
+    u32 slot[2];
+    int mafEntry[2];
+    u32 sqSlot;
+    u32 sqSlots[4];
+    static u8 *memMap[AXP_21264_MEM_MAP_LEN];
+    u8 *mem;
+    u8 victim[AXP_21264_SIZE_QUAD];
+    int entry;
+    int errors = 0;
+    int ii;
+
+    printf("\nAXP 21264 Mbox Tester\n");
+    cpu = (AXP_21264_CPU *) calloc(1, sizeof(AXP_21264_CPU));
+    if (cpu == NULL)
+    {
+        printf("Unable to allocate the CPU\n");
+        return (-1);
+    }
+    AXP_21264_Mbox_Init(cpu);
+    cpu->bTag = calloc(AXP_BCACHE_IDX_FILL + 1, sizeof(AXP_21264_BCACHE_TAG));
+    if (cpu->bTag == NULL)
+    {
+        printf("Unable to allocate the Bcache tags\n");
+        return (-1);
+    }
+    memset(load, 0, sizeof(load));
+    memset(&store, 0, sizeof(store));
+
+    /*
+     * Two loads, one integer and one floating-point.  The completion routine
+     * is determined when the slot is assigned.
+     */
+    printf("    Assigning LQ and SQ slots...\n");
+    load[0].opcode = LDQ;
+    load[0].pc.pal = AXP_PAL_MODE;
+    load[1].opcode = LDT;
+    load[1].pc.pal = AXP_PAL_MODE;
+    store.opcode = STQ;
+    store.pc.pal = AXP_PAL_MODE;
+    slot[0] = AXP_21264_Mbox_GetLQSlot(cpu, &load[0]);
+    slot[1] = AXP_21264_Mbox_GetLQSlot(cpu, &load[1]);
+    sqSlot = AXP_21264_Mbox_GetSQSlot(cpu, &store);
+    if ((slot[0] != 0) || (slot[1] != 1) || (sqSlot != 0) ||
+        (cpu->lq[0].complRtn != AXP_21264_Ebox_Compl) ||
+        (cpu->lq[1].complRtn != AXP_21264_Fbox_Compl) ||
+        (cpu->sq[0].complRtn != AXP_21264_Ebox_Compl))
+    {
+        printf("Slots or completion routines not as expected\n");
+        errors++;
+    }
+    errors += checkWork(cpu, "Assigned", none, none);
+    if (AXP_21264_Mbox_WorkQueued(cpu) == true)
+    {
+        printf("Work queued before any was requested\n");
+        errors++;
+    }
+
+    /*
+     * Only the second load is requested.  It goes on the Initial work list,
+     * and once processed, waits for the Cbox to return the I/O data.
+     */
+    printf("    Processing an I/O load...\n");
+    AXP_21264_Mbox_ReadMem(cpu, &load[1], slot[1], AXP_TEST_IO_ADDR);
+    memcpy(expected, none, sizeof(expected));
+    expected[AXP_MBOX_WORK_INITIAL] = 1 << slot[1];
+    errors += checkWork(cpu, "ReadMem", expected, none);
+    if (AXP_21264_Mbox_WorkQueued(cpu) == false)
+    {
+        printf("Work not queued after a load was requested\n");
+        errors++;
+    }
+    AXP_21264_Mbox_Process_Q(cpu);
+    errors += checkWork(cpu, "LQ Initial", none, none);
+    if ((cpu->lq[slot[1]].state != CboxPending) ||
+        (cpu->lq[slot[0]].state != Assigned))
+    {
+        printf("LQ states are %d/%d, expected %d/%d\n",
+               cpu->lq[slot[0]].state,
+               cpu->lq[slot[1]].state,
+               Assigned,
+               CboxPending);
+        errors++;
+    }
+
+    /*
+     * The Cbox returns the data, which puts the entry on the pending work
+     * list.  Processing it completes the load, which keeps the slot until it
+     * is retired.
+     */
+    AXP_21264_Mbox_CboxCompl(cpu,
+                             slot[1] + 1,
+                             (u8 *) &data,
+                             sizeof(data),
+                             false);
+    expected[AXP_MBOX_WORK_INITIAL] = 0;
+    expected[AXP_MBOX_WORK_PENDING] = 1 << slot[1];
+    errors += checkWork(cpu, "CboxCompl", expected, none);
+    AXP_21264_Mbox_Process_Q(cpu);
+    errors += checkWork(cpu, "LQ Complete", none, none);
+    if ((cpu->lq[slot[1]].state != LQComplete) ||
+        (load[1].destv.r.uq != data))
+    {
+        printf("Load not completed, state = %d, data = 0x%016llx\n",
+               cpu->lq[slot[1]].state,
+               load[1].destv.r.uq);
+        errors++;
+    }
+    if ((AXP_21264_Mbox_RetireRead(cpu, slot[1]) == true) ||
+        (cpu->lq[slot[1]].state != QNotInUse))
+    {
+        printf("Load not retired, state = %d\n", cpu->lq[slot[1]].state);
+        errors++;
+    }
+
+    /*
+     * An entry the Ibox gives back, before the Mbox gets to it, is dropped
+     * from the work list.
+     */
+    printf("    Giving back a requested load...\n");
+    AXP_21264_Mbox_ReadMem(cpu, &load[0], slot[0], AXP_TEST_IO_ADDR);
+    AXP_21264_Mbox_PutLQSlot(cpu, slot[0]);
+    AXP_21264_Mbox_Process_Q(cpu);
+    errors += checkWork(cpu, "PutLQSlot", none, none);
+    if ((cpu->lq[slot[0]].state != QNotInUse) || (cpu->lqNext != 0))
+    {
+        printf("Load given back not as expected, state = %d, next = %u\n",
+               cpu->lq[slot[0]].state,
+               cpu->lqNext);
+        errors++;
+    }
+
+    /*
+     * Once all the LQ entries have been assigned, there is no slot available
+     * until one is given back.
+     */
+    printf("    Filling the LQ...\n");
+    for (ii = 0; ii < AXP_MBOX_QUEUE_LEN; ii++)
+    {
+        if ((AXP_21264_Mbox_SlotAvailable(cpu, true) == false) ||
+            (AXP_21264_Mbox_GetLQSlot(cpu, &load[0]) != (u32) ii))
+        {
+            printf("LQ slot %d not available\n", ii);
+            errors++;
+        }
+    }
+    if ((AXP_21264_Mbox_SlotAvailable(cpu, true) == true) ||
+        (AXP_21264_Mbox_GetLQSlot(cpu, &load[0]) != AXP_MBOX_QUEUE_LEN) ||
+        (AXP_21264_Mbox_SlotAvailable(cpu, false) == false))
+    {
+        printf("LQ not full, next = %u\n", cpu->lqNext);
+        errors++;
+    }
+    AXP_21264_Mbox_PutLQSlot(cpu, AXP_MBOX_QUEUE_LEN - 1);
+    if (AXP_21264_Mbox_SlotAvailable(cpu, true) == false)
+    {
+        printf("LQ slot not available after one was given back\n");
+        errors++;
+    }
+    for (ii = AXP_MBOX_QUEUE_LEN - 2; ii >= 0; ii--)
+    {
+        AXP_21264_Mbox_PutLQSlot(cpu, ii);
+    }
+
+    /*
+     * A load that was aborted, and then faults when the Mbox translates its
+     * address, is never going to be requested again.  Its entry is given
+     * back.
+     */
+    printf("    Faulting an aborted load...\n");
+    load[0].pc.pal = 0;
+    load[0].state = Aborted;
+    slot[0] = AXP_21264_Mbox_GetLQSlot(cpu, &load[0]);
+    AXP_21264_Mbox_ReadMem(cpu, &load[0], slot[0], AXP_TEST_MEM_ADDR);
+    AXP_21264_Mbox_Process_Q(cpu);
+    errors += checkWork(cpu, "LQ Fault", none, none);
+    if ((cpu->lq[slot[0]].state != QNotInUse) || (cpu->lqNext != 0))
+    {
+        printf("Faulted load not given back, state = %d, next = %u\n",
+               cpu->lq[slot[0]].state,
+               cpu->lqNext);
+        errors++;
+    }
+    load[0].pc.pal = AXP_PAL_MODE;
+    load[0].state = Retired;
+    cpu->excPend = false;
+
+    /*
+     * An I/O store is sent to the Cbox and is complete.  It is completed only
+     * the once, and stays in the SQ until retired.
+     */
+    printf("    Processing an I/O store...\n");
+    AXP_21264_Mbox_WriteMem(cpu, &store, sqSlot, AXP_TEST_IO_ADDR, data);
+    expected[AXP_MBOX_WORK_PENDING] = 0;
+    expected[AXP_MBOX_WORK_INITIAL] = 1 << sqSlot;
+    errors += checkWork(cpu, "WriteMem", none, expected);
+    AXP_21264_Mbox_Process_Q(cpu);
+    errors += checkWork(cpu, "SQ Complete", none, none);
+    if ((cpu->sq[sqSlot].state != SQComplete) ||
+        (AXP_21264_Mbox_WorkQueued(cpu) == true))
+    {
+        printf("Store not completed, state = %d\n", cpu->sq[sqSlot].state);
+        errors++;
+    }
+
+    AXP_21264_Mbox_PutSQSlot(cpu, sqSlot);
+
+    /*
+     * A load gets each byte from the youngest store, older than it, that
+     * wrote the byte.  Stores younger than the load are ignored.  The stores
+     * miss the caches, so they stay in the SQ.
+     */
+    printf("    Forwarding store data to loads...\n");
+    sqSlots[0] = issueStore(cpu, &stores[0], STQ, 10, AXP_TEST_MEM_ADDR, data);
+    sqSlots[1] = issueStore(cpu,
+                            &stores[1],
+                            STB,
+                            11,
+                            AXP_TEST_MEM_ADDR + 2,
+                            0xab);
+    sqSlots[2] = issueStore(cpu, &stores[2], STQ, 20, AXP_TEST_MEM_ADDR, ~data);
+    slot[0] = issueLoad(cpu, &load[0], LDQ, 12, AXP_TEST_MEM_ADDR);
+    slot[1] = issueLoad(cpu, &load[1], LDL, 13, AXP_TEST_MEM_ADDR + 4);
+    if ((load[0].destv.r.uq != 0x1122334455ab7788ll) ||
+        (load[1].destv.r.uq != 0x0000000011223344ll) ||
+        (cpu->lq[slot[0]].state != LQComplete) ||
+        (cpu->lq[slot[1]].state != LQComplete) ||
+        (cpu->counters.value[AXP_CNT_LOAD_FORWARDS] != 2))
+    {
+        printf("Forwarded data 0x%016llx/0x%016llx, forwards = %llu\n",
+               load[0].destv.r.uq,
+               load[1].destv.r.uq,
+               cpu->counters.value[AXP_CNT_LOAD_FORWARDS]);
+        errors++;
+    }
+
+    /*
+     * A store whose address is known after a younger load to the same bytes
+     * has read its data causes the load to be replayed.  One that is older
+     * than the store the load got its data from does not.
+     */
+    printf("    Replaying loads that read stale data...\n");
+    if ((AXP_21264_Mbox_RetireRead(cpu, slot[0]) == true) ||
+        (AXP_21264_Mbox_RetireRead(cpu, slot[1]) == true))
+    {
+        printf("Loads replayed with no store ordering violation\n");
+        errors++;
+    }
+    slot[0] = issueLoad(cpu, &load[0], LDW_U, 16, AXP_TEST_MEM_ADDR + 2);
+    if ((load[0].destv.r.uq != 0x55ab) || (cpu->lq[slot[0]].replay == true))
+    {
+        printf("Forwarded word 0x%016llx\n", load[0].destv.r.uq);
+        errors++;
+    }
+    sqSlots[3] = issueStore(cpu, &stores[3], STL, 9, AXP_TEST_MEM_ADDR, 0);
+    if (cpu->lq[slot[0]].replay == true)
+    {
+        printf("Load replayed for a store older than the one forwarded\n");
+        errors++;
+    }
+    AXP_21264_Mbox_PutSQSlot(cpu, sqSlots[3]);
+    sqSlots[3] = issueStore(cpu, &stores[3], STB, 15, AXP_TEST_MEM_ADDR + 3, 0);
+    if (AXP_21264_Mbox_RetireRead(cpu, slot[0]) == false)
+    {
+        printf("Load not replayed after a store ordering violation\n");
+        errors++;
+    }
+    if ((cpu->lqNext != 0) || (AXP_21264_Mbox_WorkQueued(cpu) == true))
+    {
+        printf("LQ not empty after loads retired, next = %u\n", cpu->lqNext);
+        errors++;
+    }
+    for (ii = 0; ii < 4; ii++)
+    {
+        AXP_21264_Mbox_PutSQSlot(cpu, sqSlots[ii]);
+    }
+
+    /*
+     * Give the CPU a map of host memory.  A load that misses the caches has
+     * its Dcache block filled from host memory when the Cbox processes the
+     * MAF entry, without a request to the System.
+     */
+    printf("    Reading and writing memory directly...\n");
+    mem = calloc(1, AXP_21264_MEM_MAP_MASK + 1);
+    if (mem == NULL)
+    {
+        printf("Unable to allocate the memory\n");
+        return (-1);
+    }
+    for (ii = 0; ii < (4 * AXP_21264_SIZE_QUAD); ii++)
+    {
+        mem[AXP_TEST_DIRECT_ADDR + ii] = ii;
+    }
+    memMap[0] = mem;
+    cpu->system.memMap = memMap;
+    cpu->system.directMem = true;
+    slot[0] = issueLoad(cpu, &load[0], LDQ, 30, AXP_TEST_DIRECT_ADDR + 8);
+    entry = -1;
+    for (ii = 0; ii < AXP_21264_MAF_LEN; ii++)
+    {
+        if ((cpu->maf[ii].type == LDx) &&
+            ((cpu->maf[ii].pa & AXP_21264_ALIGN_MEM_BLK) ==
+             AXP_TEST_DIRECT_ADDR))
+        {
+            entry = ii;
+        }
+    }
+    if (entry == -1)
+    {
+        printf("Load did not miss the caches\n");
+        errors++;
+    }
+    else
+    {
+        pthread_mutex_lock(&cpu->cBoxInterfaceMutex);
+        AXP_21264_Process_MAF(cpu, entry);
+        pthread_mutex_unlock(&cpu->cBoxInterfaceMutex);
+    }
+    if ((cpu->lq[slot[0]].state != LQReadPending) ||
+        (memcmp(cpu->dCache[cpu->lq[slot[0]].dcacheLoc.index]
+                           [cpu->lq[slot[0]].dcacheLoc.set].data,
+                &mem[AXP_TEST_DIRECT_ADDR],
+                AXP_DCACHE_DATA_LEN) != 0) ||
+        (cpu->counters.value[AXP_CNT_DIRECT_READS] != 1) ||
+        ((entry != -1) && (cpu->maf[entry].complete == false)))
+    {
+        printf("Direct read not completed, state = %d\n",
+               cpu->lq[slot[0]].state);
+        errors++;
+    }
+    AXP_21264_Mbox_PutLQSlot(cpu, slot[0]);
+
+    /*
+     * A victim is written straight to host memory.  While another victim for
+     * the same block is waiting, the block has to go through the System.
+     */
+    for (ii = 0; ii < AXP_21264_SIZE_QUAD; ii++)
+    {
+        victim[ii] = 0xff - ii;
+    }
+    entry = AXP_21264_Add_VDB(cpu,
+                              toMemory,
+                              AXP_TEST_DIRECT_ADDR + AXP_21264_SIZE_QUAD,
+                              victim,
+                              false,
+                              false);
+    pthread_mutex_lock(&cpu->cBoxInterfaceMutex);
+    AXP_21264_Process_VDB(cpu, entry);
+    pthread_mutex_unlock(&cpu->cBoxInterfaceMutex);
+    if ((memcmp(&mem[AXP_TEST_DIRECT_ADDR + AXP_21264_SIZE_QUAD],
+                victim,
+                AXP_21264_SIZE_QUAD) != 0) ||
+        (cpu->vdb[entry].valid == true) ||
+        (cpu->counters.value[AXP_CNT_DIRECT_WRITES] != 1))
+    {
+        printf("Direct victim write not completed\n");
+        errors++;
+    }
+    entry = AXP_21264_Add_VDB(cpu,
+                              toBcache,
+                              AXP_TEST_DIRECT_ADDR + (2 * AXP_21264_SIZE_QUAD),
+                              victim,
+                              false,
+                              false);
+    if ((AXP_21264_DirectMem(cpu,
+                             AXP_TEST_DIRECT_ADDR +
+                             (2 * AXP_21264_SIZE_QUAD) + 8,
+                             -1) != NULL) ||
+        (AXP_21264_DirectMem(cpu,
+                             AXP_TEST_DIRECT_ADDR +
+                             (3 * AXP_21264_SIZE_QUAD),
+                             -1) !=
+         &mem[AXP_TEST_DIRECT_ADDR + (3 * AXP_21264_SIZE_QUAD)]) ||
+        (AXP_21264_DirectMem(cpu, AXP_21264_MEM_MAP_MASK + 1, -1) != NULL))
+    {
+        printf("Direct memory access allowed when it should not be\n");
+        errors++;
+    }
+    AXP_21264_Free_VDB(cpu, entry);
+    cpu->system.directMem = false;
+    if (AXP_21264_DirectMem(cpu, AXP_TEST_DIRECT_ADDR, -1) != NULL)
+    {
+        printf("Direct memory access allowed with other CPUs\n");
+        errors++;
+    }
+    cpu->system.memMap = NULL;
+    free(mem);
+
+    /*
+     * Without a map of host memory, a load that misses the caches is sent to
+     * the System.  The Cchip responds with the MAF entry that was sent, which
+     * the Cbox uses to complete the load.  There are two loads, so that the
+     * second MAF entry is not entry zero.  The requests left in the MAF by the
+     * earlier tests are never going to be processed, so they are cleared out.
+     */
+    printf("    Reading memory through the System...\n");
+    memset(cpu->maf, 0, sizeof(cpu->maf));
+    cpu->mafTop = cpu->mafBottom = 0;
+    sys = calloc(1, sizeof(AXP_21274_SYSTEM));
+    if (sys == NULL)
+    {
+        printf("Unable to allocate the System\n");
+        return (-1);
+    }
+    AXP_EventCount_Init(&sys->cChipEvent);
+    AXP_21274_CchipInit(sys);
+    sys->arrayCount = 1;
+    sys->arraySizes = AXP_TEST_ARRAY_SIZE;
+    sys->arrayBacking = SparseBacking;
+    sys->array[0] = AXP_21274_AllocateArray(AXP_TEST_ARRAY_SIZE,
+                                            SparseBacking);
+    if (sys->array[0] == NULL)
+    {
+        printf("Unable to allocate the memory array\n");
+        return (-1);
+    }
+    AXP_21274_MapArrays(sys->memMap,
+                        sys->array,
+                        sys->arrayCount,
+                        sys->arraySizes);
+    mem = AXP_21274_MEM_HOST(sys->memMap, AXP_TEST_SYSTEM_ADDR);
+    for (ii = 0; ii < (2 * AXP_21264_SIZE_QUAD); ii++)
+    {
+        mem[ii] = 0x80 + ii;
+    }
+    sys->cpuCount = 1;
+    pthread_mutex_init(&cpu->cBoxInterfaceMutex, NULL);
+    pthread_cond_init(&cpu->cBoxInterfaceCond, NULL);
+    AXP_21264_Save_SystemInterfaces(cpu,
+                                    &sys->cpu[0].mutex,
+                                    &sys->cpu[0].cond,
+                                    (void **) &sys->cpu[0].pq,
+                                    &sys->cpu[0].pqTop,
+                                    &sys->cpu[0].pqBottom,
+                                    &sys->cpu[0].irq_H,
+                                    &sys->cpuRq[0],
+                                    &sys->cChipEvent,
+                                    &sys->skidBuffers[0]);
+    if (pthread_create(&sys->cChipThreadID,
+                       NULL,
+                       AXP_21274_CchipMain,
+                       sys) != 0)
+    {
+        printf("Unable to start the Cchip\n");
+        return (-1);
+    }
+    for (ii = 0; ii < 2; ii++)
+    {
+        slot[ii] = issueLoad(cpu,
+                             &load[ii],
+                             LDQ,
+                             40 + ii,
+                             AXP_TEST_SYSTEM_ADDR +
+                             (ii * AXP_21264_SIZE_QUAD));
+        mafEntry[ii] = AXP_21264_MAF_Empty(cpu);
+        if (mafEntry[ii] == -1)
+        {
+            printf("Load %d did not miss the caches\n", ii);
+            errors++;
+        }
+        else
+        {
+            pthread_mutex_lock(&cpu->cBoxInterfaceMutex);
+            AXP_21264_Process_MAF(cpu, mafEntry[ii]);
+            pthread_mutex_unlock(&cpu->cBoxInterfaceMutex);
+        }
+    }
+
+    /*
+     * Process the responses, as the Cbox does, until both loads have their
+     * data.
+     */
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += AXP_TEST_WAIT_SEC;
+    pthread_mutex_lock(&cpu->cBoxInterfaceMutex);
+    while (((cpu->lq[slot[0]].state != LQReadPending) ||
+            (cpu->lq[slot[1]].state != LQReadPending)) &&
+           (errors == 0))
+    {
+        if ((entry = AXP_21264_PQ_Empty(cpu)) != -1)
+        {
+            AXP_21264_Process_PQ(cpu, entry);
+        }
+        else if (pthread_cond_timedwait(&cpu->cBoxInterfaceCond,
+                                        &cpu->cBoxInterfaceMutex,
+                                        &deadline) != 0)
+        {
+            printf("Timed out waiting for the System to respond\n");
+            errors++;
+        }
+    }
+    pthread_mutex_unlock(&cpu->cBoxInterfaceMutex);
+    for (ii = 0; (ii < 2) && (errors == 0); ii++)
+    {
+        if (memcmp(cpu->dCache[cpu->lq[slot[ii]].dcacheLoc.index]
+                              [cpu->lq[slot[ii]].dcacheLoc.set].data,
+                   &mem[ii * AXP_21264_SIZE_QUAD],
+                   AXP_DCACHE_DATA_LEN) != 0)
+        {
+            printf("Read through the System not completed for load %d, "
+                   "MAF entry %d\n",
+                   ii,
+                   mafEntry[ii]);
+            errors++;
+        }
+    }
+    AXP_21264_Mbox_PutLQSlot(cpu, slot[1]);
+    AXP_21264_Mbox_PutLQSlot(cpu, slot[0]);
+
+    /*
+     * The Cchip does not exit, so the System is left for it.
+     */
+
+    free(cpu->bTag);
+    free(cpu);
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
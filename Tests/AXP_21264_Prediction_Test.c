@@ -17,21 +17,80 @@
  * Description:
  *
  *  This source file contains the main function to test the branch prediction
- *  code.
+ *  code, and to compare the branch prediction models with each other.  The
+ *  traces of branches they are run on are converted from text into a binary
+ *  format, which is mapped into memory.
  *
  * Revision History:
  *
  *  V01.000 22-May-2017 Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Replaced the replaying of each text trace through the Ibox's predictor
+ *  with a comparison of all the branch prediction models, on binary traces
+ *  mapped into memory.  Traces that cannot be read, such as those not
+ *  fetched from large file storage, are skipped, rather than looping forever,
+ *  and synthetic traces are always run.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Added a test of the prediction of the targets of subroutine calls,
+ *  returns, and computed jumps, and of the recovery of the return stack.
+ *
+ *  V01.003 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped lines longer than 80 columns.
  */
 #include "CommonUtilities/AXP_Blocks.h"
 #include "CPU/AXP_21264_CPU.h"
 #include "CPU/Ibox/AXP_21264_Ibox.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #ifndef AXP_TEST_DATA_FILES
 #define AXP_TEST_DATA_FILES "."
 #endif
 #define AXP_MAX_FILENAME_LEN 256
+#define AXP_BP_SYNTHETIC    (4 * ONE_M)
+#define AXP_BP_MAX_MODELS   16
+
+/*
+ * The header of a binary trace, which is followed by a quadword for each
+ * branch.  The magic number is "AXPBPT01".
+ */
+#define AXP_BP_TRACE_MAGIC  0x3130545042505841ull
+typedef struct
+{
+    u64 magic;
+    u64 count;
+} AXP_BP_TRACE_HEADER;
+
+/*
+ * A binary trace mapped into memory.
+ */
+typedef struct
+{
+    char name[AXP_MAX_FILENAME_LEN];
+    void *map;
+    size_t mapSize;
+    u64 count;
+    const u64 *records;
+} AXP_BP_TRACE;
+
+/*
+ * The results of running a model over a trace, or the totals for all the
+ * traces.
+ */
+typedef struct
+{
+    u64 branches;
+    u64 correct;
+    double seconds;
+    double accuracy;
+} AXP_BP_RESULT;
 
 #define _AXP_2BIT_INCR(cntr) if ((cntr.cnt) < AXP_2BIT_MAX_VALUE) cntr.cnt++
 #define _AXP_2BIT_DECR(cntr) if ((cntr.cnt) > 0) cntr.cnt--
@@ -645,23 +704,721 @@ void TestSaturatingCounters(void)
 }
 
 /*
- * main
- *  This function is compiled in when unit testing.  It exercises the branch
- *  prediction code, and should be somewhat extensive.
+ * readTraceLine
+ *  This function is called to read the next branch from a text trace, which
+ *  has a line for each branch, with its PC and a 1 when it was taken or a 0
+ *  when it was not.  Blank lines are skipped.
  *
  * Input Parameters:
+ *  fp:
+ *      A pointer to the open text trace.
+ *
+ * Output Parameters:
+ *  record:
+ *      A location to receive the branch, in the binary trace format.
+ *
+ * Return Values:
+ *  1:  A branch was read.
+ *  0:  The end of the trace was reached.
+ *  -1: The line is not a branch, so this is not a trace.
+ */
+static int readTraceLine(FILE *fp, u64 *record)
+{
+    char line[AXP_MAX_FILENAME_LEN];
+    char *ptr, *end;
+    u64 pc, taken;
+    int retVal = 0;
+
+    while ((retVal == 0) && (fgets(line, sizeof(line), fp) != NULL))
+    {
+        ptr = line;
+        while (isspace(*ptr))
+        {
+            ptr++;
+        }
+        if (*ptr == '\0')
+        {
+            continue;
+        }
+        retVal = -1;
+        pc = strtoull(ptr, &end, 0);
+        if ((end != ptr) && isspace(*end) && (pc < (1ull << 63)))
+        {
+            ptr = end;
+            taken = strtoull(ptr, &end, 10);
+            while (isspace(*end))
+            {
+                end++;
+            }
+            if ((end != ptr) && (taken <= 1) && (*end == '\0'))
+            {
+                *record = (pc << 1) | taken;
+                retVal = 1;
+            }
+        }
+    }
+    return (retVal);
+}
+
+/*
+ * convertTrace
+ *  This function is called to convert a text trace into the binary format,
+ *  which is a header, followed by a quadword for each branch, with its PC in
+ *  the upper 63 bits and whether it was taken in bit 0.
+ *
+ * Input Parameters:
+ *  textName:
+ *      A pointer to the name of the text trace.
+ *  binName:
+ *      A pointer to the name of the binary trace to write.
+ *
+ * Output Parameters:
  *  None.
  *
+ * Return Values:
+ *  true:   The trace was converted.
+ *  false:  It could not be read or written, or was not a trace.
+ */
+static bool convertTrace(const char *textName, const char *binName)
+{
+    AXP_BP_TRACE_HEADER header = {.magic = AXP_BP_TRACE_MAGIC, .count = 0};
+    FILE *in, *out = NULL;
+    bool retVal = false;
+    u64 record;
+    int status = -1;
+
+    in = fopen(textName, "r");
+    if (in == NULL)
+    {
+        printf("Unable to open trace file: %s\n", textName);
+    }
+    else
+    {
+        out = fopen(binName, "wb");
+        if (out == NULL)
+        {
+            printf("Unable to create trace file: %s\n", binName);
+        }
+    }
+    if (out != NULL)
+    {
+        fwrite(&header, sizeof(header), 1, out);
+        while ((status = readTraceLine(in, &record)) == 1)
+        {
+            fwrite(&record, sizeof(record), 1, out);
+            header.count++;
+        }
+        if ((status == 0) && (header.count > 0))
+        {
+            fseek(out, 0, SEEK_SET);
+            retVal = fwrite(&header, sizeof(header), 1, out) == 1;
+        }
+        else
+        {
+            printf("%s is not a branch trace\n", textName);
+        }
+        retVal = (fclose(out) == 0) && retVal;
+        if (retVal == false)
+        {
+            remove(binName);
+        }
+    }
+    if (in != NULL)
+    {
+        fclose(in);
+    }
+    return (retVal);
+}
+
+/*
+ * mapTrace
+ *  This function is called to map a binary trace into memory.
+ *
+ * Input Parameters:
+ *  binName:
+ *      A pointer to the name of the binary trace.
+ *  name:
+ *      A pointer to the name to report the trace by.
+ *
+ * Output Parameters:
+ *  trace:
+ *      A pointer to the trace to be mapped.
+ *
+ * Return Values:
+ *  true:   The trace was mapped.
+ *  false:  It could not be, or was not a binary trace.
+ */
+static bool mapTrace(const char *binName, const char *name, AXP_BP_TRACE *trace)
+{
+    const AXP_BP_TRACE_HEADER *header;
+    struct stat st;
+    bool retVal = false;
+    int fd;
+
+    fd = open(binName, O_RDONLY);
+    if ((fd >= 0) && (fstat(fd, &st) == 0) &&
+        (st.st_size >= (off_t) sizeof(AXP_BP_TRACE_HEADER)))
+    {
+        trace->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (trace->map != MAP_FAILED)
+        {
+            header = (const AXP_BP_TRACE_HEADER *) trace->map;
+            trace->mapSize = st.st_size;
+            trace->count = header->count;
+            trace->records = (const u64 *) (header + 1);
+            if ((header->magic == AXP_BP_TRACE_MAGIC) &&
+                (trace->mapSize ==
+                    sizeof(*header) + (trace->count * sizeof(u64))))
+            {
+                madvise(trace->map, trace->mapSize, MADV_SEQUENTIAL);
+                strncpy(trace->name, name, sizeof(trace->name) - 1);
+                retVal = true;
+            }
+            else
+            {
+                munmap(trace->map, trace->mapSize);
+            }
+        }
+    }
+    if (retVal == false)
+    {
+        printf("Unable to map binary trace file: %s\n", binName);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return (retVal);
+}
+
+/*
+ * loadTrace
+ *  This function is called to get a trace into memory.  A binary trace is
+ *  mapped as it is.  A text trace is converted into a binary one in the
+ *  current directory, which is mapped, then deleted.
+ *
+ * Input Parameters:
+ *  fileName:
+ *      A pointer to the name of the trace.
+ *
+ * Output Parameters:
+ *  trace:
+ *      A pointer to the trace to be mapped.
+ *
+ * Return Values:
+ *  true:   The trace was mapped.
+ *  false:  It was not.
+ */
+static bool loadTrace(const char *fileName, AXP_BP_TRACE *trace)
+{
+    char binName[AXP_MAX_FILENAME_LEN + 4];
+    char name[AXP_MAX_FILENAME_LEN];
+    const char *base = strrchr(fileName, '/');
+    size_t len;
+    bool retVal;
+
+    base = (base == NULL) ? fileName : (base + 1);
+    strncpy(name, base, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    len = strlen(name);
+    if ((len > 4) && (strcmp(&name[len - 4], ".bpt") == 0))
+    {
+        name[len - 4] = '\0';
+        retVal = mapTrace(fileName, name, trace);
+    }
+    else
+    {
+        if ((len > 4) && (strcmp(&name[len - 4], ".txt") == 0))
+        {
+            name[len - 4] = '\0';
+        }
+        snprintf(binName, sizeof(binName), "%s.bpt", name);
+        retVal = convertTrace(fileName, binName) &&
+                 mapTrace(binName, name, trace);
+        remove(binName);
+    }
+    return (retVal);
+}
+
+/*
+ * emitBranch
+ *  This function is called to write a branch to a synthetic text trace.
+ *
+ * Input Parameters:
+ *  fp:
+ *      A pointer to the open text trace.
+ *  pc:
+ *      A value of the PC of the branch.
+ *  taken:
+ *      A value indicating whether the branch was taken.
+ *
  * Output Parameters:
  *  None.
  *
- * Return Value:
- *  0 - always a success.
+ * Return Values:
+ *  The value of taken.
+ */
+static bool emitBranch(FILE *fp, u64 pc, bool taken)
+{
+    fprintf(fp, "%llu %d\n", pc, taken);
+    return (taken);
+}
+
+/*
+ * generateTrace
+ *  This function is called to write a synthetic text trace, for when the
+ *  traces in the data files are not available.  The branches are those of
+ *  one of a few kinds of program.
+ *
+ *      loops       Nested loops, of a few trip counts, containing a branch
+ *                  taken every third time through.
+ *      correlated  Branches whose direction depends on that of earlier ones,
+ *                  and others which are usually taken.
+ *      random      Branches which are taken with a few probabilities.
+ *
+ * Input Parameters:
+ *  fileName:
+ *      A pointer to the name of the text trace to write.
+ *  kind:
+ *      A pointer to the kind of program.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  true:   The trace was written.
+ *  false:  It could not be.
+ */
+static bool generateTrace(const char *fileName, const char *kind)
+{
+    FILE *fp = fopen(fileName, "w");
+    bool a, b;
+    u32 count = 0;
+    u32 ii, jj, kk;
+
+    srand(1);
+    if (fp != NULL)
+    {
+        while (count < AXP_BP_SYNTHETIC)
+        {
+            if (strcmp(kind, "loops") == 0)
+            {
+                for (ii = 0; ii < 16; ii++)
+                {
+                    for (jj = 0; jj < 7; jj++)
+                    {
+                        for (kk = 0; kk < 4; kk++)
+                        {
+                            emitBranch(fp, 0x1010, (kk % 3) == 0);
+                            emitBranch(fp, 0x1018, kk < 3);
+                            count += 2;
+                        }
+                        emitBranch(fp, 0x1020, jj < 6);
+                        count++;
+                    }
+                    emitBranch(fp, 0x1030, ii < 15);
+                    count++;
+                }
+            }
+            else if (strcmp(kind, "correlated") == 0)
+            {
+                a = emitBranch(fp, 0x2000, rand() & 1);
+                b = emitBranch(fp, 0x2008, rand() & 1);
+                emitBranch(fp, 0x2010, (rand() % 10) != 0);
+                emitBranch(fp, 0x2018, a);
+                emitBranch(fp, 0x2020, a ^ b);
+                emitBranch(fp, 0x2028, (rand() % 20) != 0);
+                emitBranch(fp, 0x2030, a && b);
+                count += 7;
+            }
+            else
+            {
+                for (ii = 0; ii < 32; ii++)
+                {
+                    emitBranch(fp, 0x3000 + (ii * 8), (rand() % 32) <= ii);
+                }
+                count += 32;
+            }
+        }
+        fclose(fp);
+    }
+    return (fp != NULL);
+}
+
+/*
+ * runModel
+ *  This function is called to run a trace through a branch prediction model,
+ *  predicting each branch, then updating the model with its actual
+ *  direction.
+ *
+ * Input Parameters:
+ *  model:
+ *      A pointer to the model.
+ *  trace:
+ *      A pointer to the trace.
+ *
+ * Output Parameters:
+ *  result:
+ *      A pointer to the result to be filled in.
+ *
+ * Return Values:
  *  None.
  */
-int main()
+static void runModel(const AXP_BP_MODEL *model,
+                     AXP_BP_TRACE *trace,
+                     AXP_BP_RESULT *result)
+{
+    void *state = calloc(1, model->size);
+    struct timespec start, end;
+    u64 correct = 0;
+    u64 record, pc;
+    bool taken;
+    u32 tag;
+    u64 ii;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (ii = 0; ii < trace->count; ii++)
+    {
+        record = trace->records[ii];
+        pc = record >> 1;
+        taken = (record & 1) != 0;
+        correct += (*model->predict)(state, pc, &tag) == taken;
+        (*model->update)(state, pc, taken, tag);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    free(state);
+    result->branches = trace->count;
+    result->correct = correct;
+    result->seconds = (end.tv_sec - start.tv_sec) +
+                      ((end.tv_nsec - start.tv_nsec) / 1e9);
+    return;
+}
+
+/*
+ * checkTournament
+ *  This function is called to check that the tournament model makes the same
+ *  predictions as the Ibox does, for every branch in a trace, in each of the
+ *  dynamic prediction modes.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU to predict with.
+ *  trace:
+ *      A pointer to the trace.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of branches predicted differently.
+ */
+static u64 checkTournament(AXP_21264_CPU *cpu, AXP_BP_TRACE *trace)
+{
+    const AXP_BP_MODEL *model;
+    AXP_PC vpc = {.pal = 0, .res = 0};
+    bool localTaken, globalTaken, choice, taken;
+    u64 mismatches = 0;
+    void *state;
+    u32 tag;
+    u64 ii;
+    int mode;
+
+    for (mode = AXP_I_CTL_BP_MODE_CHOICE;
+         mode <= AXP_I_CTL_BP_MODE_LOCAL;
+         mode++)
+    {
+        model = AXP_BP_Model(mode == AXP_I_CTL_BP_MODE_CHOICE ? 0 : 1);
+        state = calloc(1, model->size);
+        memset(&cpu->branchPredictor, 0, sizeof(cpu->branchPredictor));
+        cpu->iCtl.bp_mode = mode;
+        for (ii = 0; ii < trace->count; ii++)
+        {
+            vpc.pc = trace->records[ii] >> 1;
+            taken = (trace->records[ii] & 1) != 0;
+            if (AXP_Branch_Prediction(cpu,
+                                      vpc,
+                                      &localTaken,
+                                      &globalTaken,
+                                      &choice) !=
+                (*model->predict)(state, vpc.pc, &tag))
+            {
+                mismatches++;
+            }
+            AXP_Branch_Direction(cpu, vpc, taken, localTaken, globalTaken);
+            (*model->update)(state, vpc.pc, taken, tag);
+        }
+        free(state);
+    }
+    return (mismatches);
+}
+
+/*
+ * fetchBranch
+ *  This function sets up a branch instruction and has the Ibox predict it, as
+ *  if it had just been fetched, then checks the prediction.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure with the return stack and jump target
+ *      cache.
+ *  instr:
+ *      A pointer to the instruction to set up.
+ *  opcode:
+ *      A value of the opcode of the branch.
+ *  pc:
+ *      A value of the PC of the branch.
+ *  displacement:
+ *      A value of the displacement, or for JMP, the hint bits.
+ *  hint:
+ *      A value of the hint bits of a HW_RET.
+ *  expected:
+ *      A value of the PC expected to be predicted, or zero if the branch is
+ *      expected to not be predicted.
+ *
+ * Output Parameters:
+ *  instr:
+ *      The instruction, with its prediction.
+ *
+ * Return Values:
+ *  0 - The prediction was the one expected.
+ *  1 - It was not.
+ */
+static u32 fetchBranch(AXP_21264_CPU *cpu,
+                       AXP_INSTRUCTION *instr,
+                       u8 opcode,
+                       u64 pc,
+                       i64 displacement,
+                       u8 hint,
+                       u64 expected)
+{
+    bool predicted;
+    u32 retVal = 0;
+
+    memset(instr, 0, sizeof(AXP_INSTRUCTION));
+    instr->type = Branch;
+    instr->opcode = opcode;
+    AXP_PUT_PC(instr->pc, pc);
+    instr->displacement = displacement;
+    instr->type_hint_index = hint;
+    predicted = AXP_Branch_Target(cpu, instr);
+    if ((predicted != (expected != 0)) ||
+        ((predicted == true) &&
+         (AXP_GET_PC(instr->predictedPC) != expected)))
+    {
+        printf("    Opcode 0x%02x at 0x%08llx predicted %s 0x%08llx, "
+               "expected 0x%08llx\n",
+               opcode,
+               pc,
+               predicted ? "taken to" : "not taken",
+               (u64) AXP_GET_PC(instr->predictedPC),
+               expected);
+        retVal = 1;
+    }
+    return (retVal);
+}
+
+/*
+ * retireBranch
+ *  This function has the Ibox resolve a branch, as if it had just been
+ *  retired, and checks whether it was mispredicted.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure with the return stack and jump target
+ *      cache.
+ *  instr:
+ *      A pointer to the branch instruction.
+ *  target:
+ *      A value of the PC the branch actually went to.
+ *  mispredict:
+ *      A value of true if the branch is expected to be mispredicted.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0 - The branch was mispredicted, or not, as expected.
+ *  1 - It was not.
+ */
+static u32 retireBranch(AXP_21264_CPU *cpu,
+                        AXP_INSTRUCTION *instr,
+                        u64 target,
+                        bool mispredict)
+{
+    u32 retVal = 0;
+
+    AXP_PUT_PC(instr->branchPC, target);
+    if (AXP_Branch_Resolve(cpu, instr) != mispredict)
+    {
+        printf("    Opcode 0x%02x at 0x%08llx to 0x%08llx was%s "
+               "mispredicted\n",
+               instr->opcode,
+               (u64) AXP_GET_PC(instr->pc),
+               target,
+               mispredict ? " not" : "");
+        retVal = 1;
+    }
+    return (retVal);
+}
+
+/*
+ * checkTargets
+ *  This function checks the prediction of the targets of subroutine calls,
+ *  returns, and computed jumps, from the return stack and jump target cache,
+ *  and the recovery of the return stack when instructions are aborted.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the CPU structure with the return stack and jump target
+ *      cache.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of checks that failed.
+ */
+static u32 checkTargets(AXP_21264_CPU *cpu)
+{
+    AXP_INSTRUCTION call, jsr, ret, calls[AXP_RET_STACK_SIZE + 8];
+    u32 failures = 0;
+    u32 ii;
+    u8 stackIdx;
+
+    memset(cpu->predictionStack, 0, sizeof(cpu->predictionStack));
+    memset(&cpu->jumpCache, 0, sizeof(cpu->jumpCache));
+    memset(&cpu->counters, 0, sizeof(cpu->counters));
+    cpu->predStackIdx = 0;
+
+    /*
+     * A BSR goes to its displacement, and a RET with nothing pushed is not
+     * predicted.  JSR is first predicted from its hint bits, then from the
+     * jump target cache.
+     */
+    failures += fetchBranch(cpu, &ret, JMP, 0x0800, 0x8001, 0, 0);
+    failures += fetchBranch(cpu, &call, BSR, 0x1000, 0x100, 0, 0x1404);
+    failures += retireBranch(cpu, &call, 0x1404, false);
+    failures += fetchBranch(cpu, &jsr, JMP, 0x1404, 0x4010, 0, 0x1448);
+    stackIdx = cpu->predStackIdx;
+
+    /*
+     * A RET fetched after the JSR, which turns out to go elsewhere, is
+     * aborted, which puts back the JSR's return PC.
+     */
+    failures += fetchBranch(cpu, &ret, JMP, 0x1448, 0x8001, 0, 0x1408);
+    failures += retireBranch(cpu, &jsr, 0x2000, true);
+    AXP_Branch_Recover(cpu, &jsr, true);
+    if ((cpu->predStackIdx != stackIdx) ||
+        (AXP_GET_PC(cpu->predictionStack[stackIdx]) != 0x1408))
+    {
+        printf("    The return stack was not recovered after a JSR\n");
+        failures++;
+    }
+    failures += fetchBranch(cpu, &ret, JMP, 0x2010, 0x8001, 0, 0x1408);
+    failures += retireBranch(cpu, &ret, 0x1408, false);
+    failures += fetchBranch(cpu, &ret, JMP, 0x1410, 0x8001, 0, 0x1004);
+    failures += retireBranch(cpu, &ret, 0x1004, false);
+    failures += fetchBranch(cpu, &jsr, JMP, 0x1404, 0x4010, 0, 0x2000);
+    failures += retireBranch(cpu, &jsr, 0x2000, false);
+
+    /*
+     * A replayed instruction is fetched again, so its own push is undone.
+     */
+    stackIdx = cpu->predStackIdx;
+    AXP_Branch_Recover(cpu, &jsr, false);
+    if (cpu->predStackIdx == stackIdx)
+    {
+        printf("    The return stack was not recovered for a replay\n");
+        failures++;
+    }
+    AXP_Branch_Recover(cpu, &jsr, true);
+
+    /*
+     * CALL_PAL is not predicted, but pushes its return PC, for HW_RET to pop.
+     */
+    failures += fetchBranch(cpu, &call, PAL00, 0x3000, 0, 0, 0);
+    failures += fetchBranch(cpu, &ret, HW_RET, 0x8000, 0, AXP_HW_RET, 0x3004);
+
+    /*
+     * Calls nested deeper than the return stack lose only the outermost
+     * return PCs.
+     */
+    for (ii = 0; ii < AXP_RET_STACK_SIZE + 8; ii++)
+    {
+        failures += fetchBranch(cpu,
+                                &calls[ii],
+                                BSR,
+                                0x10000 + (ii * 0x100),
+                                0x3f,
+                                0,
+                                0x10000 + (ii * 0x100) + 0x100);
+    }
+    for (ii = AXP_RET_STACK_SIZE + 8; ii > 8; ii--)
+    {
+        failures += fetchBranch(cpu,
+                                &ret,
+                                JMP,
+                                0x20000,
+                                0x8001,
+                                0,
+                                0x10000 + ((ii - 1) * 0x100) + 4);
+        failures += retireBranch(cpu,
+                                 &ret,
+                                 0x10000 + ((ii - 1) * 0x100) + 4,
+                                 false);
+    }
+    failures += fetchBranch(cpu,
+                            &ret,
+                            JMP,
+                            0x20000,
+                            0x8001,
+                            0,
+                            0x10000 + ((AXP_RET_STACK_SIZE + 7) * 0x100) + 4);
+    failures += retireBranch(cpu, &ret, 0x10000 + (7 * 0x100) + 4, true);
+
+    if ((cpu->counters.value[AXP_CNT_JUMPS] != 2) ||
+        (cpu->counters.value[AXP_CNT_JMP_MISPREDICTS] != 1) ||
+        (cpu->counters.value[AXP_CNT_RETURNS] != AXP_RET_STACK_SIZE + 3) ||
+        (cpu->counters.value[AXP_CNT_RET_MISPREDICTS] != 1))
+    {
+        printf("    Counted %llu jumps, %llu mispredicted, and %llu returns, "
+               "%llu mispredicted\n",
+               cpu->counters.value[AXP_CNT_JUMPS],
+               cpu->counters.value[AXP_CNT_JMP_MISPREDICTS],
+               cpu->counters.value[AXP_CNT_RETURNS],
+               cpu->counters.value[AXP_CNT_RET_MISPREDICTS]);
+        failures++;
+    }
+    return (failures);
+}
+
+/*
+ * main
+ *  This function is compiled in when unit testing.  It tests the saturating
+ *  counters, and the prediction of returns and jump targets, then runs each
+ *  branch prediction model on a number of traces, and reports how accurate
+ *  and fast each one is.
+ *
+ *  With no arguments, the traces are the ones in the data files, and some
+ *  synthetic ones.  Otherwise, the arguments are the traces to use, either
+ *  text or binary (ending in .bpt).  With the -c option, a text trace is
+ *  just converted to a binary one.
+ *
+ * Input Parameters:
+ *  argc:
+ *      A value of the number of arguments.
+ *  argv:
+ *      A pointer to the arguments.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Value:
+ *  0 - All the tests passed.
+ *  1 - At least one test failed.
+ */
+int main(int argc, char **argv)
 {
-    FILE *fp;
     char *fileNames[] =
     {
         "trace1.txt",
@@ -669,298 +1426,160 @@ int main()
         "trace3.txt",
         "trace4.txt",
         "trace5.txt",
-		"trace-matmul.txt",
-		"trace-12queens.txt",
-		"trace-fib30.txt",
-		"trace-ray.txt"
+        "trace-matmul.txt",
+        "trace-12queens.txt",
+        "trace-fib30.txt",
+        "trace-ray.txt"
     };
+    char *synthetic[] = {"loops", "correlated", "random"};
+    int numberOfFiles = (int) (sizeof(fileNames) / sizeof(char *));
+    int numberOfSynthetic = (int) (sizeof(synthetic) / sizeof(char *));
     char fileName[AXP_MAX_FILENAME_LEN];
-    bool taken;
-    int takenInt;
-    int ii, jj, kk;
+    AXP_BP_RESULT totals[AXP_BP_MAX_MODELS];
+    AXP_BP_RESULT result;
+    AXP_BP_TRACE trace;
+    const AXP_BP_MODEL *model;
     AXP_21264_CPU *cpu;
-    AXP_PC vpc = {.pal = 0, .res = 0};
-    int vpcInt;
-    bool localTaken;
-    bool globalTaken;
-    bool choice;
-    bool prediction;
-    int insCnt;
-    int predictedCnt;
-    int localCnt;
-    int globalCnt;
-    int choiceUsed;
-    int choiceCorrect;
-    int totalIns;
-    int totalCorrect;
-    int totalMispredict;
-    float totalPredictAccuracy;
-    int totalLocalCorrect;
-    int totalGlobalCorrect;
-    int totalChoiceUsed;
-    int totalChoiceCorrect;
-    int totalChoiceWrong;
-    int numberOfFiles = (int) (sizeof(fileNames)/sizeof(char *));
+    u64 mismatches;
+    double fallThrough = 0.0;
+    u32 failures = 0;
+    int traces = 0;
+    int ii, jj;
+
+    if ((argc == 4) && (strcmp(argv[1], "-c") == 0))
+    {
+        return (convertTrace(argv[2], argv[3]) ? 0 : 1);
+    }
+    else if ((argc > 1) && (argv[1][0] == '-'))
+    {
+        printf("Usage: %s [-c text-trace binary-trace] [trace ...]\n", argv[0]);
+        return (1);
+    }
 
-    /*
-     * NOTE:  The current simulation takes in one instruction at a time.  The
-     *        AXP simulator will process four instructions at a time and
-     *        potentially out of order.  When a branch instruction is retired,
-     *        only then is the
-     */
     printf("\nAXP 21264 Predictions Unit Tester\n");
-    printf("\nFirst, we run the various implementations of 2 and 3 bit\n");
-    printf("saturating counters through various implementations to test\n");
-    printf("which is faster.\n");
-    TestSaturatingCounters();
-    printf("\nFinally, we'll actually test the branch prediction code.\n");
-    printf("%d trace files to be processed\n\n",
-           (int) (sizeof(fileNames)/sizeof(char *)));
+    if (argc == 1)
+    {
+        printf("\nFirst, we run the various implementations of 2 and 3 bit\n");
+        printf("saturating counters through various implementations to test\n");
+        printf("which is faster.\n");
+        TestSaturatingCounters();
+    }
     cpu = (AXP_21264_CPU *) AXP_Allocate_Block(AXP_21264_CPU_BLK);
-    for (kk = 0; kk < 3; kk++)
-    {
-        totalIns = 0;
-        totalCorrect = 0;
-        totalMispredict = 0;
-        totalPredictAccuracy = 0.0;
-        totalLocalCorrect = 0;
-        totalGlobalCorrect = 0;
-        totalChoiceUsed = 0;
-        totalChoiceCorrect = 0;
-        totalChoiceWrong = 0;
-
-        /*
-         * bp_mode has the following values:
-         *  0b00 = Choice selects between local and global history
-         *         predictions.
-         *  0b01 = Only local prediction is used.
-         *  0b1x = Prediction always returns false.
-         */
-        cpu->iCtl.bp_mode = kk;
-        printf("====================================================\n");
-        switch(kk)
+    printf("\nNext, we check the prediction of returns and jump targets.\n");
+    if (checkTargets(cpu) != 0)
+    {
+        failures++;
+    }
+    printf("\nNow, we'll compare the branch prediction models.\n");
+    memset(totals, 0, sizeof(totals));
+    for (ii = 0;
+         ii < ((argc == 1) ? numberOfFiles + numberOfSynthetic : argc - 1);
+         ii++)
+    {
+        if (argc > 1)
+        {
+            strncpy(fileName, argv[ii + 1], sizeof(fileName) - 1);
+            fileName[sizeof(fileName) - 1] = '\0';
+        }
+        else if (ii < numberOfFiles)
+        {
+            snprintf(fileName,
+                     sizeof(fileName),
+                     "%s/%s",
+                     AXP_TEST_DATA_FILES,
+                     fileNames[ii]);
+        }
+        else
         {
-            case 0x00:
-                printf("Choice predictor selects either Local or Global History Predictions\n");
-                break;
-            case 0x01:
-                printf("Only Local Prediction is used\n");
-                break;
-            case 0x02:
-                printf("Predictor always returns false (fall-through)\n");
-                break;
+            snprintf(fileName,
+                     sizeof(fileName),
+                     "synthetic-%s.txt",
+                     synthetic[ii - numberOfFiles]);
+            generateTrace(fileName, synthetic[ii - numberOfFiles]);
         }
-        for (ii = 0; ii < numberOfFiles; ii++)
+        if (loadTrace(fileName, &trace) == true)
         {
-            sprintf(fileName, "%s/%s", AXP_TEST_DATA_FILES, fileNames[ii]);
-            fp = fopen(fileName, "r");
-            if (fp != NULL)
+            printf("\nTrace %s, %llu branches\n", trace.name, trace.count);
+            printf("    %-12s %8s %10s %12s %12s\n",
+                   "Model",
+                   "Bits",
+                   "Accuracy",
+                   "Mispred/1K",
+                   "M pred/s");
+            for (jj = 0; (model = AXP_BP_Model(jj)) != NULL; jj++)
             {
-                int lineCount = 0;
-                int ch;
-                int items;
-
-                while(!feof(fp))
-                {
-                    ch = fgetc(fp);
-                    if(ch == '\n')
-                    {
-                        lineCount++;
-                    }
-                }
-                fseek(fp, 0, SEEK_SET);
-                insCnt = 0;
-                predictedCnt = 0;
-                localCnt = 0;
-                globalCnt = 0;
-                choiceUsed = 0;
-                choiceCorrect = 0;
-                printf("\nProcessing trace file: %s (%d)...\n",
-                       fileNames[ii],
-                       lineCount);
-                while (feof(fp) == 0)
-                {
-                    items = fscanf(fp, "%d %d\n", &vpcInt, &takenInt);
-                    if (items == 0)
-                    {
-                        perror("No items returned from input file");
-                    }
-                    insCnt++;
-                    vpc.pc = vpcInt;
-                    taken = (takenInt == 1) ? true : false;
-
-                    /*
-                     * Predict whether the branch should be taken or not.
-                     * We'll get results from the Local and Global Predictor,
-                     * and the Choice selected (when the Local and Global do
-                     * not agree).
-                     */
-                    prediction = AXP_Branch_Prediction(cpu,
-                                                       vpc,
-                                                       &localTaken,
-                                                       &globalTaken,
-                                                       &choice);
-                    if (prediction == taken)
-                    {
-                        predictedCnt++;
-                    }
-
-                    /*
-                     * Let's determine how the choice was determined.
-                     *
-                     * No prediction.  Always returns false (fall-through)
-                     */
-                    if (kk != 2)
-                    {
-                        if (kk != 1)    /* Local prediction only. */
-                        {
-                            if (localTaken != globalTaken)
-                            {
-                                choiceUsed++;
-                                if (choice == true)
-                                {
-                                    if (taken == globalTaken)
-                                    {
-                                        globalCnt++;
-                                        choiceCorrect++;
-                                    }
-                                }
-                                else
-                                {
-                                    if (taken == localTaken)
-                                    {
-                                        localCnt++;
-                                        choiceCorrect++;
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                if (taken == localTaken)
-                                {
-                                    localCnt++;
-                                    globalCnt++;
-                                }
-                            }
-                        }
-                        else if (taken == localTaken)
-                        {
-                            localCnt++;
-                        }
-                    }
-
-                    /*
-                     * Update the predictors based on whether the branch was
-                     * actually taken or not and considering which of the
-                     * predictors was correct.
-                     *
-                     * NOTE:    Whether choice was used or not is irrelevant.
-                     *          The choice is determined by whether the local
-                     *          or global were correct.  If both are correct or
-                     *          both are incorrect, then the choice was not
-                     *          used and thus would not have made a difference.
-                     */
-                    AXP_Branch_Direction(cpu,
-                                         vpc,
-                                         taken,
-                                         localTaken,
-                                         globalTaken);
-                }
-                fclose(fp);
-
-                /*
-                 * Print out what we found.
-                 */
-                printf("---------------------------------------------\n");
-                printf("Total instructions:\t\t\t%d\n", insCnt);
-                printf("Correct predictions:\t\t\t%d\n", predictedCnt);
-                printf("Mispredictions:\t\t\t\t%d\n", (insCnt - predictedCnt));
-                printf("Prediction accuracy:\t\t\t%1.6f\n\n",
-                       ((float) predictedCnt / (float) insCnt));
-                printf("Times local correct:\t\t\t%d\n", localCnt);
-                printf("Times global correct:\t\t\t%d\n", globalCnt);
-                printf("Times choice used:\t\t\t%d\n", choiceUsed);
-                printf("Times choice selected correctly:\t%d\n",
-                       choiceCorrect);
-                printf("Times choice was wrong:\t\t\t%d\n",
-                       (choiceUsed - choiceCorrect));
-
-                totalIns += insCnt;
-                totalCorrect += predictedCnt;
-                totalMispredict += (insCnt - predictedCnt);
-                totalPredictAccuracy += ((float) predictedCnt / (float) insCnt);
-                totalLocalCorrect += localCnt;
-                totalGlobalCorrect += globalCnt;
-                totalChoiceUsed += choiceUsed;
-                totalChoiceCorrect += choiceCorrect;
-                totalChoiceWrong += (choiceUsed - choiceCorrect);
-
-                /*
-                 * We need to clear out the prediction tables in the CPU
-                 * record.
-                 */
-                cpu->globalPathHistory = 0;
-                for (jj = 0; jj < ONE_K; jj++)
-                {
-                    cpu->localHistoryTable.lcl_history[jj].cnt = 0;
-                }
-                for (jj = 0; jj < ONE_K; jj++)
-                {
-                    cpu->localPredictor.lcl_pred[jj].cnt = 0;
-                }
-                for (jj = 0; jj < FOUR_K; jj++)
-                {
-                    cpu->globalPredictor.gbl_pred[jj].cnt = 0;
-                }
-                for (jj = 0; jj < FOUR_K; jj++)
-                {
-                    cpu->choicePredictor.choice_pred[jj].cnt = 0;
-                }
+                runModel(model, &trace, &result);
+                printf("    %-12s %8u %10.6f %12.2f %12.1f\n",
+                       model->name,
+                       model->bits,
+                       (double) result.correct / result.branches,
+                       (result.branches - result.correct) * 1000.0 /
+                       result.branches,
+                       result.branches / result.seconds / 1e6);
+                totals[jj].accuracy += (double) result.correct /
+                                       result.branches;
+                totals[jj].branches += result.branches;
+                totals[jj].seconds += result.seconds;
             }
-            else
+            mismatches = checkTournament(cpu, &trace);
+            if (mismatches != 0)
             {
-                printf("Unable to open trace file: %s\n", fileName);
+                printf("    The Ibox predicted %llu branches differently\n",
+                       mismatches);
+                failures++;
             }
+            munmap(trace.map, trace.mapSize);
+            traces++;
         }
-        printf("\n---------------------------------------------\n");
-
-        /*
-         * Averages for each predictor mode.
-         */
-        switch(kk)
+        if ((argc == 1) && (ii >= numberOfFiles))
         {
-            case 0x00:
-                printf("Choice Predictor Average:\n");
-                break;
-
-            case 0x01:
-                printf("Only Local Prediction Average:\n");
-                break;
-
-            case 0x02:
-                printf("Predictor always returns false (Fall-Through)"
-                       " Average:\n");
-                break;
+            remove(fileName);
         }
-        printf("Average number of instructions:\t\t%d\n",
-               totalIns / numberOfFiles);
-        printf("Average correct predictions:\t\t%d\n",
-               totalCorrect / numberOfFiles);
-        printf("Average mispredictions:\t\t\t%d\n",
-               totalMispredict / numberOfFiles);
-        printf("Average prediction accuracy:\t\t%1.6f\n\n",
-               (float) totalPredictAccuracy / (float) numberOfFiles);
-        printf("Average local correct:\t\t\t%d\n",
-               totalLocalCorrect / numberOfFiles);
-        printf("Average global correct:\t\t\t%d\n",
-               totalGlobalCorrect / numberOfFiles);
-        printf("Average choice used:\t\t\t%d\n",
-               totalChoiceUsed / numberOfFiles);
-        printf("Average choice selected Correctly:\t%d\n",
-               totalChoiceCorrect / numberOfFiles);
-        printf("Average choice wrong:\t\t\t%d\n",
-               totalChoiceWrong / numberOfFiles);
     }
     AXP_Deallocate_Block(cpu);
-    return(0);
+
+    /*
+     * Every model that predicts anything should do better than predicting
+     * that no branch is taken.
+     */
+    if (traces > 0)
+    {
+        for (jj = 0; (model = AXP_BP_Model(jj)) != NULL; jj++)
+        {
+            if (model->bits == 0)
+            {
+                fallThrough = totals[jj].accuracy;
+            }
+        }
+        printf("\nAverage over %d traces\n", traces);
+        printf("    %-12s %8s %10s %12s\n",
+               "Model",
+               "Bits",
+               "Accuracy",
+               "M pred/s");
+        for (jj = 0; (model = AXP_BP_Model(jj)) != NULL; jj++)
+        {
+            printf("    %-12s %8u %10.6f %12.1f\n",
+                   model->name,
+                   model->bits,
+                   totals[jj].accuracy / traces,
+                   totals[jj].branches / totals[jj].seconds / 1e6);
+            if ((model->bits > 0) && (totals[jj].accuracy <= fallThrough))
+            {
+                printf("    %s is less accurate than not predicting\n",
+                       model->name);
+                failures++;
+            }
+        }
+    }
+    else
+    {
+        printf("\nNo traces to run\n");
+        failures++;
+    }
+    if (failures == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    return (failures == 0 ? 0 : 1);
 }
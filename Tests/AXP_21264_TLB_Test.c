@@ -0,0 +1,397 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to test the hashed ITB/DTB
+ *  look-up code against a linear search of the TLB array, and to measure how
+ *  long each one takes.  It also tests the micro-TLB in front of the virtual
+ *  to physical address translation.
+ *
+ * Revision History:
+ *
+ *  V01.000 15-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 15-Oct-2026 Jonathan D. Belanger
+ *  Added tests for the micro-TLB used by AXP_va2pa.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  The look-ups being timed can no longer be optimized away, which had the
+ *  linear look-up taking no time at all in an optimized build.
+ */
+#include "CommonUtilities/AXP_Blocks.h"
+#include "CPU/AXP_21264_CPU.h"
+#include "CPU/Caches/AXP_21264_Cache.h"
+#include <time.h>
+
+#define AXP_TEST_LOOKUPS    (4 * ONE_M)
+#define AXP_TEST_ASNS       4
+
+/*
+ * linearFind
+ *  This is how the TLB used to be searched.  Every entry is looked at until
+ *  a match is found.  It is used as both the reference for correctness and
+ *  the baseline for timing.  It is not inlined, so that the compiler cannot
+ *  fold it into the timing loop, any more than it can AXP_findTLBEntry.
+ */
+__attribute__((noinline))
+static AXP_21264_TLB *linearFind(AXP_21264_CPU *cpu, u64 virtAddr, bool dtb)
+{
+    AXP_21264_TLB *tlbArray = (dtb ? cpu->dtb : cpu->itb);
+    u8 asn = (dtb ? cpu->dtbAsn0.asn : cpu->pCtx.asn);
+    int ii;
+
+    for (ii = 0; ii < AXP_TB_LEN; ii++)
+    {
+        if ((tlbArray[ii].valid == true) &&
+            (tlbArray[ii].virtAddr == (virtAddr & tlbArray[ii].matchMask)) &&
+            ((tlbArray[ii]._asm == true) || (tlbArray[ii].asn == asn)))
+        {
+            return (&tlbArray[ii]);
+        }
+    }
+    return (NULL);
+}
+
+/*
+ * nextRandom
+ *  A simple xorshift random number generator, so that the test is
+ *  repeatable.
+ */
+static u64 nextRandom(u64 *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (*state);
+}
+
+/*
+ * fillTLB
+ *  Add a TLB entry for each of the virtual addresses in the array, using a
+ *  mix of granularity hints, ASNs and ASM settings.
+ */
+static void fillTLB(AXP_21264_CPU *cpu, u64 *vaList, int count, bool dtb)
+{
+    int ii;
+
+    for (ii = 0; ii < count; ii++)
+    {
+        u8 gh = ((ii % 16) == 0) ? (ii / 16) % AXP_TB_GH_CNT : 0;
+        u8 asn = ii % AXP_TEST_ASNS;
+        bool _asm = (ii % 10) == 0;
+
+        if (dtb)
+        {
+            cpu->dtbPte0.gh = gh;
+            cpu->dtbPte0._asm = _asm;
+            cpu->dtbPte0.ure = 1;
+            cpu->dtbAsn0.asn = asn;
+        }
+        else
+        {
+            cpu->itbPte.gh = gh;
+            cpu->itbPte._asm = _asm;
+            cpu->itbPte.ure = 1;
+            cpu->pCtx.asn = asn;
+        }
+        AXP_addTLBEntry(cpu, vaList[ii], vaList[ii], dtb);
+    }
+}
+
+/*
+ * compareAll
+ *  Look-up every virtual address (and a near miss for each) for every ASN
+ *  and compare what the hashed look-up returns against the linear search.
+ */
+static int compareAll(AXP_21264_CPU *cpu, u64 *vaList, int count, bool dtb)
+{
+    AXP_21264_TLB *hashed, *linear;
+    int errors = 0;
+    int ii, asn, jj;
+
+    for (asn = 0; asn < AXP_TEST_ASNS; asn++)
+    {
+        if (dtb)
+        {
+            cpu->dtbAsn0.asn = asn;
+        }
+        else
+        {
+            cpu->pCtx.asn = asn;
+        }
+        for (ii = 0; ii < count; ii++)
+        {
+            for (jj = 0; jj < 2; jj++)
+            {
+                u64 va = vaList[ii] + (jj * AXP_21264_PAGE_SIZE) + 0x18;
+
+                hashed = AXP_findTLBEntry(cpu, va, dtb);
+                linear = linearFind(cpu, va, dtb);
+                if (hashed != linear)
+                {
+                    errors++;
+                }
+            }
+        }
+    }
+    return (errors);
+}
+
+/*
+ * timeLookups
+ *  Time a number of look-ups of the virtual addresses, using either the
+ *  hashed or the linear look-up, and return the number of nanoseconds per
+ *  look-up.  Each look-up is for a different byte in the page, and the
+ *  entries found are stored through a volatile pointer, so that none of the
+ *  look-ups can be optimized away.
+ */
+static double timeLookups(AXP_21264_CPU *cpu,
+                          u64 *vaList,
+                          int count,
+                          bool dtb,
+                          bool hashed)
+{
+    struct timespec start, end;
+    AXP_21264_TLB * volatile sink = NULL;
+    u64 state = 0x2545f4914f6cdd1dll;
+    int ii;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (ii = 0; ii < AXP_TEST_LOOKUPS; ii++)
+    {
+        u64 va = vaList[nextRandom(&state) % count] +
+                 ((ii * 8) & (AXP_21264_PAGE_SIZE - 1));
+
+        if (hashed)
+        {
+            sink = AXP_findTLBEntry(cpu, va, dtb);
+        }
+        else
+        {
+            sink = linearFind(cpu, va, dtb);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    (void) sink;
+    return (((end.tv_sec - start.tv_sec) * 1000000000.0 +
+             (end.tv_nsec - start.tv_nsec)) / AXP_TEST_LOOKUPS);
+}
+
+/*
+ * translate
+ *  Translate a virtual address, using AXP_va2pa, and compare the result with
+ *  what the TLB entry says it should be.  Returns the number of mismatches.
+ *
+ *  NOTE:   ITB entries are always set up to fault on read and execute, so we
+ *          translate those without asking for any access.
+ */
+static int translate(AXP_21264_CPU *cpu, u64 va, bool dtb, bool expectMiss)
+{
+    AXP_21264_TLB *tlb;
+    AXP_EXCEPTIONS memChk;
+    AXP_PC pc;
+    u64 pa;
+    u32 fault;
+    bool _asm;
+
+    AXP_PUT_PC(pc, 0);
+    pa = AXP_va2pa(cpu, va, pc, dtb, dtb ? Read : None, &_asm, &fault, &memChk);
+    cpu->tbMissOutstanding = false;
+    tlb = AXP_findTLBEntry(cpu, va, dtb);
+    if ((tlb == NULL) || expectMiss)
+    {
+        return ((tlb == NULL) && (fault != 0) ? 0 : 1);
+    }
+    if ((fault != 0) ||
+        (pa != (tlb->physAddr | (va & tlb->keepMask))) ||
+        (_asm != tlb->_asm))
+    {
+        return (1);
+    }
+    return (0);
+}
+
+/*
+ * checkMicroTLB
+ *  Translate all the virtual addresses twice (the second time should hit in
+ *  the micro-TLB), then make sure that invalidating the TLB entries also
+ *  invalidates the micro-TLB.  Also, time how long a translation takes.
+ */
+static int checkMicroTLB(AXP_21264_CPU *cpu, u64 *vaList, int count, bool dtb)
+{
+    struct timespec start, end;
+    AXP_EXCEPTIONS memChk;
+    AXP_PC pc;
+    u32 fault;
+    int errors = 0;
+    int ii, jj;
+
+    fillTLB(cpu, vaList, count, dtb);
+    if (dtb)
+    {
+        cpu->dtbAsn0.asn = 1;
+    }
+    else
+    {
+        cpu->pCtx.asn = 1;
+    }
+    for (jj = 0; jj < 2; jj++)
+    {
+        for (ii = 0; ii < count; ii++)
+        {
+            errors += translate(cpu, vaList[ii] + 0x18, dtb, false);
+        }
+    }
+
+    /*
+     * Time translating addresses in the same page, over and over.  This is
+     * the common case for loads and stores.
+     */
+    AXP_PUT_PC(pc, 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (ii = 0; ii < AXP_TEST_LOOKUPS; ii++)
+    {
+        AXP_va2pa(cpu,
+                  vaList[1] + ((ii * 8) & (AXP_21264_PAGE_SIZE - 1)),
+                  pc,
+                  dtb,
+                  dtb ? Read : None,
+                  NULL,
+                  &fault,
+                  &memChk);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("    Translation (micro-TLB hit): %8.2f ns\n",
+           ((end.tv_sec - start.tv_sec) * 1000000000.0 +
+            (end.tv_nsec - start.tv_nsec)) / AXP_TEST_LOOKUPS);
+
+    /*
+     * Invalidate a single entry, then everything, and make sure the micro-TLB
+     * does not still have the translations.
+     */
+    errors += translate(cpu, vaList[1] + 0x18, dtb, false);
+    AXP_tbis(cpu, vaList[1], dtb);
+    errors += translate(cpu, vaList[1] + 0x18, dtb, true);
+    errors += translate(cpu, vaList[5] + 0x18, dtb, false);
+    AXP_tbia(cpu, dtb);
+    errors += translate(cpu, vaList[5] + 0x18, dtb, true);
+    return (errors);
+}
+
+int main()
+{
+    AXP_21264_CPU *cpu;
+    u64 vaList[AXP_TB_LEN];
+    u64 state = 0x9e3779b97f4a7c15ll;
+    double linearNs, hashedNs;
+    int errors = 0;
+    int ii, pass;
+    bool dtb;
+
+    printf("\nAXP 21264 ITB/DTB Hashed Look-up Tester\n");
+    cpu = (AXP_21264_CPU *) AXP_Allocate_Block(AXP_21264_CPU_BLK);
+    if (cpu == NULL)
+    {
+        printf("Unable to allocate a CPU structure\n");
+        return (-1);
+    }
+    cpu->ierCm.cm = AXP_CM_USER;
+
+    /*
+     * Generate a set of page aligned virtual addresses, spread out so that
+     * the large granularity hint entries do not overlap any of the others.
+     */
+    for (ii = 0; ii < AXP_TB_LEN; ii++)
+    {
+        vaList[ii] = ((nextRandom(&state) & 0x3ffll) << 29) | ((u64) ii << 22);
+    }
+
+    for (pass = 0; pass < 2; pass++)
+    {
+        dtb = (pass == 0);
+        printf("\n>>> Testing the %s\n", dtb ? "DTB" : "ITB");
+
+        /*
+         * Fill the TLB twice, so that the round-robin replacement gets
+         * exercised, then compare the two look-ups.
+         */
+        fillTLB(cpu, vaList, AXP_TB_LEN, dtb);
+        fillTLB(cpu, vaList, AXP_TB_LEN, dtb);
+        errors += compareAll(cpu, vaList, AXP_TB_LEN, dtb);
+
+        /*
+         * Invalidate some single entries and compare again.
+         */
+        for (ii = 0; ii < AXP_TB_LEN; ii += 3)
+        {
+            if (dtb)
+            {
+                cpu->dtbAsn0.asn = ii % AXP_TEST_ASNS;
+            }
+            else
+            {
+                cpu->pCtx.asn = ii % AXP_TEST_ASNS;
+            }
+            AXP_tbis(cpu, vaList[ii], dtb);
+        }
+        errors += compareAll(cpu, vaList, AXP_TB_LEN, dtb);
+
+        /*
+         * Invalidate all the process specific entries and compare again.
+         */
+        AXP_tbiap(cpu, dtb);
+        errors += compareAll(cpu, vaList, AXP_TB_LEN, dtb);
+
+        /*
+         * Refill and time the two look-ups.
+         */
+        fillTLB(cpu, vaList, AXP_TB_LEN, dtb);
+        errors += compareAll(cpu, vaList, AXP_TB_LEN, dtb);
+        linearNs = timeLookups(cpu, vaList, AXP_TB_LEN, dtb, false);
+        hashedNs = timeLookups(cpu, vaList, AXP_TB_LEN, dtb, true);
+        printf("    Linear look-up:              %8.2f ns\n", linearNs);
+        printf("    Hashed look-up:              %8.2f ns\n", hashedNs);
+        printf("    Speed-up:                    %8.2fx\n",
+               linearNs / hashedNs);
+
+        /*
+         * Invalidate everything, there should be nothing left to find.
+         */
+        AXP_tbia(cpu, dtb);
+        errors += compareAll(cpu, vaList, AXP_TB_LEN, dtb);
+
+        /*
+         * Now test the micro-TLB in front of the TLB.
+         */
+        errors += checkMicroTLB(cpu, vaList, AXP_TB_LEN, dtb);
+    }
+    AXP_Deallocate_Block(cpu);
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d look-ups did not match the linear search!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to measure the memory
+ *  bandwidth seen by a CPU.  Each memory block is read and written, one
+ *  request at a time, through the Cchip (the queued path, which is how a
+ *  block is read or written when there is more than one CPU), then directly
+ *  from and to host memory (the path the Cbox uses when there is only the one
+ *  CPU).  The data written by one path is checked by reading it back with the
+ *  other.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Requests are now put on the CPU's request queue, and the Cchip woken with
+ *  its event count.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Configure.h"
+#include "Motherboard/AXP_21274_System.h"
+#include "Motherboard/AXP_21274_InitRoutines.h"
+#include "Motherboard/AXP_21274_Memory.h"
+#include <time.h>
+#include <sched.h>
+
+#define AXP_TEST_ARRAY_SIZE (256ll * ONE_M)
+#define AXP_TEST_REGION     (8ll * ONE_M)
+#define AXP_TEST_BLOCK      (AXP_21274_DATA_SIZE * sizeof(u64))
+#define AXP_TEST_BLOCKS     (AXP_TEST_REGION / AXP_TEST_BLOCK)
+
+/*
+ * The CPU side of the interface to the Cchip.  This is what the CPU would
+ * have saved in the System structure.
+ */
+static pthread_mutex_t cpuMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cpuCond = PTHREAD_COND_INITIALIZER;
+static AXP_21274_CBOX_PQ pq[AXP_21274_PQ_LEN];
+static u8 pqTop = 0;
+static u8 pqBottom = 0;
+static u8 irqH = 0;
+static u32 rqNext = 0;
+
+/*
+ * queuedRequest
+ *  This function is called to send a memory request to the Cchip, the way the
+ *  Cbox does, and wait for the response.
+ *
+ * Input Parameters:
+ *  sys:
+ *      A pointer to the System structure.
+ *  cmd:
+ *      A value indicating the command to be sent (ReadBlk or WrVictimBlk).
+ *  pa:
+ *      A value indicating the physical address of the block.
+ *  data:
+ *      A pointer to the block of data to be written.
+ *
+ * Output Parameters:
+ *  data:
+ *      A pointer to the location to receive the block of data read.
+ *
+ * Return Values:
+ *  The SysDc response from the Cchip.
+ */
+static AXP_SYSDC queuedRequest(AXP_21274_SYSTEM *sys,
+                               AXP_System_Commands cmd,
+                               u64 pa,
+                               u64 *data)
+{
+    AXP_21274_RQ_ENTRY *rq;
+    AXP_SYSDC retVal;
+
+    /*
+     * Use CPU 0's request entries in turn, waiting for the Cchip to be done
+     * with the one we are going to use.
+     */
+    rq = &sys->skidBuffers[rqNext];
+    rqNext = (rqNext + 1) % AXP_21274_CCHIP_RQ_LEN;
+    while (__atomic_load_n(&rq->inUse, __ATOMIC_ACQUIRE) == true)
+    {
+        sched_yield();
+    }
+    rq->cmd = cmd;
+    rq->pa = pa;
+    rq->cpuID = 0;
+    rq->entry = 0;
+    rq->inUse = true;
+    if (cmd == WrVictimBlk)
+    {
+        memcpy(rq->sysData, data, sizeof(rq->sysData));
+    }
+    AXP_SPSCRing_Put(&sys->cpuRq[0], rq, 0);
+    AXP_EventCount_Signal(&sys->cChipEvent);
+
+    /*
+     * Wait for the response to arrive in the PQ, and take it out.
+     */
+    pthread_mutex_lock(&cpuMutex);
+    while (pq[pqBottom].valid == false)
+    {
+        pthread_cond_wait(&cpuCond, &cpuMutex);
+    }
+    if (cmd != WrVictimBlk)
+    {
+        memcpy(data, pq[pqBottom].sysData, sizeof(pq[pqBottom].sysData));
+    }
+    retVal = pq[pqBottom].sysDc;
+    pq[pqBottom].valid = false;
+    pthread_mutex_unlock(&cpuMutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * report
+ *  This function is called to display the bandwidth for a pass over the
+ *  memory region.
+ *
+ * Input Parameters:
+ *  path:
+ *      A pointer to the name of the path used.
+ *  op:
+ *      A pointer to the name of the operation performed.
+ *  start:
+ *      A pointer to the time the pass started.
+ *  end:
+ *      A pointer to the time the pass ended.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of nanoseconds per block.
+ */
+static double report(const char *path,
+                     const char *op,
+                     struct timespec *start,
+                     struct timespec *end)
+{
+    double elapsed;
+    double nsPerBlock;
+
+    elapsed = (double) (end->tv_sec - start->tv_sec) +
+              ((double) (end->tv_nsec - start->tv_nsec) / 1.0e9);
+    nsPerBlock = (elapsed * 1.0e9) / AXP_TEST_BLOCKS;
+    printf("    %-8s %-6s %12.1f MB/s %10.1f ns/block\n",
+           path,
+           op,
+           ((double) AXP_TEST_REGION / ONE_M) / elapsed,
+           nsPerBlock);
+
+    /*
+     * Return back to the caller.
+     */
+    return (nsPerBlock);
+}
+
+/*
+ * main
+ *  This function is called by the image activator to run the test.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  All tests passed.
+ *  -1: A test failed.
+ */
+int main()
+{
+    AXP_21274_SYSTEM *sys;
+    struct timespec start, end;
+    u64 data[AXP_21274_DATA_SIZE];
+    u64 pa;
+    u8 *block;
+    double queuedNs, directNs;
+    int errors = 0;
+    int ii;
+
+    printf("\nAXP 21274 Memory Bandwidth Tester\n");
+    printf("    (%lldMB region, one %llu byte block at a time)\n",
+           AXP_TEST_REGION / ONE_M,
+           (u64) AXP_TEST_BLOCK);
+
+    /*
+     * Set up just enough of the System for the Cchip to read and write memory
+     * for the one CPU.
+     */
+    sys = calloc(1, sizeof(AXP_21274_SYSTEM));
+    if (sys == NULL)
+    {
+        printf("Unable to allocate the System\n");
+        return (-1);
+    }
+    AXP_EventCount_Init(&sys->cChipEvent);
+    AXP_21274_CchipInit(sys);
+    sys->arrayCount = 1;
+    sys->arraySizes = AXP_TEST_ARRAY_SIZE;
+    sys->arrayBacking = SparseBacking;
+    sys->array[0] = AXP_21274_AllocateArray(sys->arraySizes,
+                                            sys->arrayBacking);
+    if (sys->array[0] == NULL)
+    {
+        printf("Unable to allocate the memory array\n");
+        return (-1);
+    }
+    AXP_21274_MapArrays(sys->memMap,
+                        sys->array,
+                        sys->arrayCount,
+                        sys->arraySizes);
+    sys->cpuCount = 1;
+    sys->cpu[0].mutex = &cpuMutex;
+    sys->cpu[0].cond = &cpuCond;
+    sys->cpu[0].pq = pq;
+    sys->cpu[0].pqTop = &pqTop;
+    sys->cpu[0].pqBottom = &pqBottom;
+    sys->cpu[0].irq_H = &irqH;
+    if (pthread_create(&sys->cChipThreadID,
+                       NULL,
+                       AXP_21274_CchipMain,
+                       sys) != 0)
+    {
+        printf("Unable to start the Cchip\n");
+        return (-1);
+    }
+
+    /*
+     * Write through the Cchip, then read back directly.
+     */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (pa = 0; pa < AXP_TEST_REGION; pa += AXP_TEST_BLOCK)
+    {
+        for (ii = 0; ii < AXP_21274_DATA_SIZE; ii++)
+        {
+            data[ii] = pa + ii;
+        }
+        if (queuedRequest(sys, WrVictimBlk, pa, data) != WriteData)
+        {
+            errors++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    queuedNs = report("Queued", "Write", &start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (pa = 0; pa < AXP_TEST_REGION; pa += AXP_TEST_BLOCK)
+    {
+        block = AXP_21274_MEM_HOST(sys->memMap, pa);
+        memcpy(data, block, AXP_TEST_BLOCK);
+        if ((data[0] != pa) || (data[AXP_21274_DATA_SIZE - 1] !=
+                                (pa + AXP_21274_DATA_SIZE - 1)))
+        {
+            errors++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    directNs = report("Direct", "Read", &start, &end);
+
+    /*
+     * Write directly, then read back through the Cchip.
+     */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (pa = 0; pa < AXP_TEST_REGION; pa += AXP_TEST_BLOCK)
+    {
+        for (ii = 0; ii < AXP_21274_DATA_SIZE; ii++)
+        {
+            data[ii] = ~(pa + ii);
+        }
+        block = AXP_21274_MEM_HOST(sys->memMap, pa);
+        memcpy(block, data, AXP_TEST_BLOCK);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    directNs += report("Direct", "Write", &start, &end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (pa = 0; pa < AXP_TEST_REGION; pa += AXP_TEST_BLOCK)
+    {
+        if ((queuedRequest(sys, ReadBlk, pa, data) != ReadData) ||
+            (data[0] != ~pa) ||
+            (data[AXP_21274_DATA_SIZE - 1] !=
+             ~(pa + AXP_21274_DATA_SIZE - 1)))
+        {
+            errors++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    queuedNs += report("Queued", "Read", &start, &end);
+
+    /*
+     * Memory that is not there is a read error through the Cchip, and is not
+     * in the map for the direct path.
+     */
+    if ((queuedRequest(sys, ReadBlk, AXP_TEST_ARRAY_SIZE, data) !=
+         ReadDataError) ||
+        (AXP_21274_MEM_HOST(sys->memMap, AXP_TEST_ARRAY_SIZE) != NULL))
+    {
+        printf("    Nonexistent memory not detected\n");
+        errors++;
+    }
+    printf("    Direct path is %.1f times faster\n", queuedNs / directNs);
+
+    /*
+     * Print final results.  The Cchip thread does not exit, so it is left to
+     * go away with the image.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
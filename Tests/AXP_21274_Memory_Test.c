@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to test the memory array
+ *  backings.  For 4GB, 16GB, and 32GB of memory, with each backing, the time
+ *  taken to allocate the arrays and the resident set size (RSS) are measured,
+ *  after the allocation and after the emulation has touched a few pages.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Configure.h"
+#include "Motherboard/AXP_21274_Memory.h"
+#include <time.h>
+
+#define AXP_TEST_ARRAYS     4
+#define AXP_TEST_STRIDE     (256ll * ONE_M)
+#define AXP_TEST_SLACK      (16ll * ONE_M)
+
+/*
+ * getRSS
+ *  This function is called to get the current resident set size of this
+ *  process.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The resident set size, in bytes.
+ */
+static u64 getRSS(void)
+{
+    FILE *fp;
+    u64 pages = 0;
+    u64 resident = 0;
+
+    fp = fopen("/proc/self/statm", "r");
+    if (fp != NULL)
+    {
+        if (fscanf(fp, "%llu %llu", &pages, &resident) != 2)
+        {
+            resident = 0;
+        }
+        fclose(fp);
+    }
+    return (resident * sysconf(_SC_PAGESIZE));
+}
+
+/*
+ * testBacking
+ *  This function is called to allocate the memory arrays for a total memory
+ *  size with a backing, touch one quadword every AXP_TEST_STRIDE bytes, and
+ *  check that the memory reads back as expected.  The time and RSS are
+ *  reported.
+ *
+ * Input Parameters:
+ *  total:
+ *      A value indicating the total size, in bytes, of the memory arrays.
+ *  backing:
+ *      A value indicating how the host memory is to be obtained.
+ *  name:
+ *      A pointer to the name of the backing.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int testBacking(u64 total,
+                       AXP_21264_DARRAY_BACKING backing,
+                       const char *name)
+{
+    u64 *array[AXP_TEST_ARRAYS];
+    u64 size = total / AXP_TEST_ARRAYS;
+    struct timespec start, end;
+    u64 rssStart, rssAlloc, rssTouch;
+    u64 touched = 0;
+    u64 offset;
+    double elapsed;
+    int errors = 0;
+    int ii;
+
+    rssStart = getRSS();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (ii = 0; ii < AXP_TEST_ARRAYS; ii++)
+    {
+        array[ii] = AXP_21274_AllocateArray(size, backing);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    rssAlloc = getRSS();
+    elapsed = ((end.tv_sec - start.tv_sec) * 1.0e3) +
+              ((end.tv_nsec - start.tv_nsec) / 1.0e6);
+
+    for (ii = 0; ii < AXP_TEST_ARRAYS; ii++)
+    {
+        if (array[ii] == NULL)
+        {
+            break;
+        }
+    }
+    if (ii < AXP_TEST_ARRAYS)
+    {
+
+        /*
+         * The up front allocation is allowed to fail, when the host does not
+         * have the memory, which is what the other backings avoid.
+         */
+        printf("    %3lluGB %-8s unable to allocate\n", total / ONE_G, name);
+        if (backing != AllocateBacking)
+        {
+            errors++;
+        }
+    }
+    else
+    {
+
+        /*
+         * Touch a few pages, then make sure they, and the pages in between,
+         * read back correctly.
+         */
+        for (ii = 0; ii < AXP_TEST_ARRAYS; ii++)
+        {
+            for (offset = 0; offset < size; offset += AXP_TEST_STRIDE)
+            {
+                array[ii][offset / sizeof(u64)] = offset + ii;
+                touched++;
+            }
+        }
+        rssTouch = getRSS();
+        for (ii = 0; ii < AXP_TEST_ARRAYS; ii++)
+        {
+            for (offset = 0; offset < size; offset += AXP_TEST_STRIDE)
+            {
+                if ((array[ii][offset / sizeof(u64)] != (offset + ii)) ||
+                    (array[ii][(offset + AXP_TEST_STRIDE / 2) /
+                               sizeof(u64)] != 0))
+                {
+                    errors++;
+                }
+            }
+        }
+        printf("    %3lluGB %-8s %10.3f ms %10.1f MB %10.1f MB\n",
+               total / ONE_G,
+               name,
+               elapsed,
+               (double) (rssAlloc - rssStart) / ONE_M,
+               (double) (rssTouch - rssStart) / ONE_M);
+
+        /*
+         * The sparse backings must not have used more memory than the pages
+         * touched (each of which may be a huge page).
+         */
+        if ((backing != AllocateBacking) &&
+            ((rssAlloc - rssStart) > AXP_TEST_SLACK))
+        {
+            printf("        %s used memory before it was touched\n", name);
+            errors++;
+        }
+        if ((backing != AllocateBacking) &&
+            ((rssTouch - rssStart) >
+             ((touched * AXP_21274_HUGE_PAGE) + AXP_TEST_SLACK)))
+        {
+            printf("        %s used memory that was not touched\n", name);
+            errors++;
+        }
+    }
+    for (ii = 0; ii < AXP_TEST_ARRAYS; ii++)
+    {
+        AXP_21274_FreeArray(array[ii], size, backing);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * main
+ *  This function is called by the image activator to run the test.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  All tests passed.
+ *  -1: A test failed.
+ */
+int main()
+{
+    u64 totals[] = {4ll * ONE_G, 16ll * ONE_G, 32ll * ONE_G};
+    int errors = 0;
+    int ii;
+
+    printf("\nAXP 21274 Memory Array Tester\n");
+    printf("    (%d arrays, one quadword touched every %lldMB)\n",
+           AXP_TEST_ARRAYS,
+           AXP_TEST_STRIDE / ONE_M);
+    printf("    Memory Backing     Allocation  RSS Allocated  RSS Touched\n");
+    for (ii = 0; ii < (sizeof(totals) / sizeof(totals[0])); ii++)
+    {
+        errors += testBacking(totals[ii], SparseBacking, "Sparse");
+        errors += testBacking(totals[ii], HugeBacking, "Huge");
+        errors += testBacking(totals[ii], AllocateBacking, "Allocate");
+    }
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
@@ -0,0 +1,422 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to stress the Cchip with
+ *  memory requests from more than one CPU at a time.  Each emulated CPU is a
+ *  thread that keeps several requests outstanding, the way the Cbox does,
+ *  writing a block and then reading it back.  The read is sent before the
+ *  write has completed, so the data read back also checks that the requests
+ *  for a block are completed in the order they were sent.  This is done for a
+ *  number of CPUs and memory workers, and the throughput of each is reported.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Configure.h"
+#include "Motherboard/AXP_21274_System.h"
+#include "Motherboard/AXP_21274_InitRoutines.h"
+#include "Motherboard/AXP_21274_Memory.h"
+#include <time.h>
+#include <sched.h>
+
+#define AXP_TEST_ARRAY_SIZE     (256ll * ONE_M)
+#define AXP_TEST_CPU_REGION     (16ll * ONE_M)
+#define AXP_TEST_BLOCK          (AXP_21274_DATA_SIZE * sizeof(u64))
+#define AXP_TEST_BLOCKS         8192
+#define AXP_TEST_OUTSTANDING    4
+
+/*
+ * The CPU side of the interface to the Cchip, and what the CPU thread needs to
+ * keep track of its outstanding requests.
+ */
+typedef struct
+{
+    AXP_21274_SYSTEM *sys;
+    u32 cpuID;
+    pthread_t threadID;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    AXP_21274_CBOX_PQ pq[AXP_21274_PQ_LEN];
+    u8 pqTop;
+    u8 pqBottom;
+    u8 irqH;
+    bool busy[AXP_21274_CCHIP_RQ_LEN];
+    AXP_System_Commands cmd[AXP_21274_CCHIP_RQ_LEN];
+    u64 expect[AXP_21274_CCHIP_RQ_LEN];
+    u32 outstanding;
+    u32 errors;
+} AXP_TEST_CPU;
+
+/*
+ * The memory array is shared by all the passes.
+ */
+static u64 *array = NULL;
+
+/*
+ * consumeResponses
+ *  This function is called to take the responses the Cchip has sent to a CPU
+ *  out of the PQ, and check them.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the test CPU.
+ *  wait:
+ *      A value indicating whether to wait for a response to arrive.
+ *
+ * Output Parameters:
+ *  cpu:
+ *      A pointer to the test CPU, with the responded to requests no longer
+ *      outstanding.
+ *
+ * Return Values:
+ *  None.
+ */
+static void consumeResponses(AXP_TEST_CPU *cpu, bool wait)
+{
+    AXP_21274_CBOX_PQ *pq;
+    bool found = false;
+    u32 entry;
+    int ii;
+
+    pthread_mutex_lock(&cpu->mutex);
+    do
+    {
+        for (ii = 0; ii < AXP_21274_PQ_LEN; ii++)
+        {
+            pq = &cpu->pq[ii];
+            if (pq->valid == true)
+            {
+                entry = pq->ID;
+                if ((entry >= AXP_21274_CCHIP_RQ_LEN) ||
+                    (cpu->busy[entry] == false))
+                {
+                    cpu->errors++;
+                }
+                else
+                {
+                    if (cpu->cmd[entry] == WrVictimBlk)
+                    {
+                        if (pq->sysDc != WriteData)
+                        {
+                            cpu->errors++;
+                        }
+                    }
+                    else if ((pq->sysDc != ReadData) ||
+                             (pq->sysData[0] != cpu->expect[entry]) ||
+                             (pq->sysData[AXP_21274_DATA_SIZE - 1] !=
+                              (cpu->expect[entry] + AXP_21274_DATA_SIZE - 1)))
+                    {
+                        cpu->errors++;
+                    }
+                    cpu->busy[entry] = false;
+                    cpu->outstanding--;
+                }
+                pq->valid = false;
+                found = true;
+            }
+        }
+        if ((found == false) && (wait == true))
+        {
+            pthread_cond_wait(&cpu->cond, &cpu->mutex);
+        }
+    } while ((found == false) && (wait == true));
+    pthread_mutex_unlock(&cpu->mutex);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * sendRequest
+ *  This function is called to send a memory request to the Cchip, the way the
+ *  Cbox does, without waiting for the response.  If the CPU already has as
+ *  many requests outstanding as it is allowed, we wait for a response first.
+ *
+ * Input Parameters:
+ *  cpu:
+ *      A pointer to the test CPU.
+ *  cmd:
+ *      A value indicating the command to be sent (ReadBlk or WrVictimBlk).
+ *  pa:
+ *      A value indicating the physical address of the block.
+ *  pattern:
+ *      A value indicating the first quadword of the block written, or
+ *      expected to be read.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void sendRequest(AXP_TEST_CPU *cpu,
+                        AXP_System_Commands cmd,
+                        u64 pa,
+                        u64 pattern)
+{
+    AXP_21274_SYSTEM *sys = cpu->sys;
+    AXP_21274_RQ_ENTRY *rq;
+    u32 entry;
+    int ii;
+
+    while (cpu->outstanding >= AXP_TEST_OUTSTANDING)
+    {
+        consumeResponses(cpu, true);
+    }
+
+    /*
+     * There are more request entries than we allow to be outstanding, so
+     * there is always one free, though the Cchip may not quite be done with
+     * it yet.
+     */
+    for (entry = 0; cpu->busy[entry] == true; entry++)
+        ;
+    rq = &sys->skidBuffers[(cpu->cpuID * AXP_21274_CCHIP_RQ_LEN) + entry];
+    while (__atomic_load_n(&rq->inUse, __ATOMIC_ACQUIRE) == true)
+    {
+        sched_yield();
+    }
+    cpu->busy[entry] = true;
+    cpu->cmd[entry] = cmd;
+    cpu->expect[entry] = pattern;
+    cpu->outstanding++;
+    rq->cmd = cmd;
+    rq->pa = pa;
+    rq->cpuID = cpu->cpuID;
+    rq->entry = entry;
+    if (cmd == WrVictimBlk)
+    {
+        for (ii = 0; ii < AXP_21274_DATA_SIZE; ii++)
+        {
+            rq->sysData[ii] = pattern + ii;
+        }
+    }
+    rq->inUse = true;
+    AXP_SPSCRing_Put(&sys->cpuRq[cpu->cpuID], rq, cpu->cpuID);
+    AXP_EventCount_Signal(&sys->cChipEvent);
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * cpuMain
+ *  This is the main function for a test CPU.  It writes each block in its own
+ *  region of memory, and reads it back.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      A pointer to the test CPU.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL.
+ */
+static void *cpuMain(void *voidPtr)
+{
+    AXP_TEST_CPU *cpu = (AXP_TEST_CPU *) voidPtr;
+    u64 pa, pattern;
+    int ii;
+
+    for (ii = 0; ii < AXP_TEST_BLOCKS; ii++)
+    {
+        pa = (cpu->cpuID * AXP_TEST_CPU_REGION) + (ii * AXP_TEST_BLOCK);
+        pattern = ((u64) cpu->sys->memWorkerCount << 56) |
+                  ((u64) cpu->sys->cpuCount << 48) |
+                  pa;
+        sendRequest(cpu, WrVictimBlk, pa, pattern);
+        sendRequest(cpu, ReadBlk, pa, pattern);
+        consumeResponses(cpu, false);
+    }
+    while (cpu->outstanding > 0)
+    {
+        consumeResponses(cpu, true);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (NULL);
+}
+
+/*
+ * runPass
+ *  This function is called to set up a System with the number of CPUs and
+ *  memory workers, and have each of the CPUs write and read its blocks.  A new
+ *  System is used for each pass, because the Cchip does not exit.
+ *
+ * Input Parameters:
+ *  cpuCount:
+ *      A value indicating the number of CPUs to send requests.
+ *  workers:
+ *      A value indicating the number of memory workers the Cchip is to use.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors detected.
+ */
+static int runPass(u32 cpuCount, u32 workers)
+{
+    AXP_21274_SYSTEM *sys;
+    AXP_TEST_CPU *cpu;
+    struct timespec start, end;
+    double elapsed, requests;
+    int errors = 0;
+    u32 ii;
+
+    sys = calloc(1, sizeof(AXP_21274_SYSTEM));
+    cpu = calloc(cpuCount, sizeof(AXP_TEST_CPU));
+    if ((sys == NULL) || (cpu == NULL))
+    {
+        printf("    Unable to allocate the System\n");
+        return (1);
+    }
+    AXP_EventCount_Init(&sys->cChipEvent);
+    AXP_21274_CchipInit(sys);
+    sys->memWorkerCount = workers;
+    sys->arrayCount = 1;
+    sys->arraySizes = AXP_TEST_ARRAY_SIZE;
+    sys->arrayBacking = SparseBacking;
+    sys->array[0] = array;
+    AXP_21274_MapArrays(sys->memMap,
+                        sys->array,
+                        sys->arrayCount,
+                        sys->arraySizes);
+    sys->cpuCount = cpuCount;
+    for (ii = 0; ii < cpuCount; ii++)
+    {
+        cpu[ii].sys = sys;
+        cpu[ii].cpuID = ii;
+        pthread_mutex_init(&cpu[ii].mutex, NULL);
+        pthread_cond_init(&cpu[ii].cond, NULL);
+        sys->cpu[ii].mutex = &cpu[ii].mutex;
+        sys->cpu[ii].cond = &cpu[ii].cond;
+        sys->cpu[ii].pq = cpu[ii].pq;
+        sys->cpu[ii].pqTop = &cpu[ii].pqTop;
+        sys->cpu[ii].pqBottom = &cpu[ii].pqBottom;
+        sys->cpu[ii].irq_H = &cpu[ii].irqH;
+    }
+    if (pthread_create(&sys->cChipThreadID,
+                       NULL,
+                       AXP_21274_CchipMain,
+                       sys) != 0)
+    {
+        printf("    Unable to start the Cchip\n");
+        return (1);
+    }
+
+    /*
+     * Start all the CPUs, and wait for them to finish.
+     */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (ii = 0; ii < cpuCount; ii++)
+    {
+        pthread_create(&cpu[ii].threadID, NULL, cpuMain, &cpu[ii]);
+    }
+    for (ii = 0; ii < cpuCount; ii++)
+    {
+        pthread_join(cpu[ii].threadID, NULL);
+        errors += cpu[ii].errors;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    elapsed = (double) (end.tv_sec - start.tv_sec) +
+              ((double) (end.tv_nsec - start.tv_nsec) / 1.0e9);
+    requests = (double) cpuCount * AXP_TEST_BLOCKS * 2;
+    printf("    %u CPU(s) %u worker(s) %12.0f requests/s %8.1f MB/s %s\n",
+           cpuCount,
+           sys->memWorkerCount,
+           requests / elapsed,
+           (requests * AXP_TEST_BLOCK) / (elapsed * ONE_M),
+           (errors == 0) ? "passed" : "FAILED");
+
+    /*
+     * The Cchip and memory worker threads do not exit, so the System and CPUs
+     * are left for them.
+     */
+    return (errors);
+}
+
+/*
+ * main
+ *  This function is called by the image activator to run the test.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  All tests passed.
+ *  -1: A test failed.
+ */
+int main()
+{
+    const u32 cpuCounts[] = {1, 2, 4};
+    const u32 workerCounts[] = {0, 1, 2, 4};
+    int errors = 0;
+    int ii, jj;
+
+    printf("\nAXP 21274 Cchip Stress Tester\n");
+    printf("    (%d requests per CPU, %d outstanding, %ld host "
+           "processors)\n",
+           AXP_TEST_BLOCKS * 2,
+           AXP_TEST_OUTSTANDING,
+           sysconf(_SC_NPROCESSORS_ONLN));
+
+    array = AXP_21274_AllocateArray(AXP_TEST_ARRAY_SIZE, SparseBacking);
+    if (array == NULL)
+    {
+        printf("Unable to allocate the memory array\n");
+        return (-1);
+    }
+    for (ii = 0; ii < (int) (sizeof(cpuCounts) / sizeof(cpuCounts[0])); ii++)
+    {
+        for (jj = 0;
+             jj < (int) (sizeof(workerCounts) / sizeof(workerCounts[0]));
+             jj++)
+        {
+            errors += runPass(cpuCounts[ii], workerCounts[jj]);
+        }
+    }
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
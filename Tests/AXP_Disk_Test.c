@@ -25,17 +25,80 @@
  *
  *  V01.001 09-Jun-2019 Jonathan D. Belanger
  *  Updated to use new directory structure format and clean-up formatting.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Added a benchmark of reading and writing a fixed VHD and a RAW disk, with
+ *  the file descriptor and with the disk mapped into memory, for each of the
+ *  mapping's advice and sync modes.
  */
 #include "Devices/VirtualDisks/AXP_VirtualDisk.h"
 #include "CommonUtilities/AXP_Utility.h"
 #include "CommonUtilities/AXP_Trace.h"
 #include "Devices/VirtualDisks/AXP_VHD_Utility.h"
+#include <time.h>
 
 #ifndef AXP_TEST_DATA_FILES
 #define AXP_TEST_DATA_FILES "."
 #endif
 #define AXP_MAX_FILENAME_LEN 256
 
+/*
+ * The benchmark writes the whole disk sequentially and flushes it, reads it
+ * back sequentially, then reads sectors from all over it.
+ */
+#define AXP_BENCH_VHD       "/tmp/AXP_Disk_Test.vhd"
+#define AXP_BENCH_RAW       "/tmp/AXP_Disk_Test.raw"
+#define AXP_BENCH_SIZE      (16 * ONE_M)
+#define AXP_BENCH_XFER      (64 * ONE_K)
+#define AXP_BENCH_SECTOR    512
+#define AXP_BENCH_RANDOM    4096
+#define AXP_BENCH_SECTORS   (AXP_BENCH_SIZE / AXP_BENCH_SECTOR)
+
+typedef struct
+{
+    char *name;
+    bool mapped;
+    AXP_VHD_MMAP_ADVICE advice;
+    AXP_VHD_MMAP_SYNC sync;
+} benchModes;
+
+static benchModes benchModeCases[] =
+{
+    {
+        .name = "File I/O",
+        .mapped = false
+    },
+    {
+        .name = "mmap, write through",
+        .mapped = true,
+        .advice = AXP_VHD_MMAP_Normal,
+        .sync = AXP_VHD_MMAP_WriteThrough
+    },
+    {
+        .name = "mmap, async",
+        .mapped = true,
+        .advice = AXP_VHD_MMAP_Normal,
+        .sync = AXP_VHD_MMAP_Async
+    },
+    {
+        .name = "mmap, write back, sequential",
+        .mapped = true,
+        .advice = AXP_VHD_MMAP_Sequential,
+        .sync = AXP_VHD_MMAP_WriteBack
+    },
+    {
+        .name = "mmap, write back, will need",
+        .mapped = true,
+        .advice = AXP_VHD_MMAP_WillNeed,
+        .sync = AXP_VHD_MMAP_WriteBack
+    },
+    {
+        .name = NULL
+    }
+};
+
+static u8 benchBuf[AXP_BENCH_XFER];
+
 typedef struct
 {
     u8 *buf;
@@ -203,6 +266,369 @@ static crc32cTests crc32cTestCases[] =
     }
 };
 
+/*
+ * benchFill
+ *  This function is called to fill a buffer with a pattern that depends upon
+ *  where it is on the disk, and the pass, so that each pass writes something
+ *  different.
+ *
+ * Input Parameters:
+ *  lba:
+ *      A value indicating the first sector the buffer is for.
+ *  seed:
+ *      A value indicating the pass.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void benchFill(u64 lba, u8 seed)
+{
+    size_t ii;
+
+    for (ii = 0; ii < AXP_BENCH_XFER; ii++)
+    {
+        benchBuf[ii] = (u8) ((lba * AXP_BENCH_SECTOR + ii) * 7 + seed);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * benchCheck
+ *  This function is called to check that a buffer read from the disk has the
+ *  pattern benchFill would have put in it.
+ *
+ * Input Parameters:
+ *  lba:
+ *      A value indicating the first sector the buffer is for.
+ *  len:
+ *      A value indicating the number of bytes to check.
+ *  seed:
+ *      A value indicating the pass.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of bytes that do not match.
+ */
+static int benchCheck(u64 lba, size_t len, u8 seed)
+{
+    size_t ii;
+    int errors = 0;
+
+    for (ii = 0; ii < len; ii++)
+    {
+        if (benchBuf[ii] != (u8) ((lba * AXP_BENCH_SECTOR + ii) * 7 + seed))
+        {
+            errors++;
+        }
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * benchSeconds
+ *  This function is called to get the number of seconds between two times.
+ *
+ * Input Parameters:
+ *  start:
+ *      A pointer to the earlier time.
+ *  end:
+ *      A pointer to the later time.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of seconds from start to end.
+ */
+static double benchSeconds(struct timespec *start, struct timespec *end)
+{
+    return ((double) (end->tv_sec - start->tv_sec) +
+            ((double) (end->tv_nsec - start->tv_nsec) / 1.0e9));
+}
+
+/*
+ * benchOpen
+ *  This function is called to open the disk for a benchmark pass.  The VHD
+ *  is created as a fixed VHD the first time, and the RAW disk is a file of
+ *  zeros.
+ *
+ * Input Parameters:
+ *  deviceID:
+ *      A value indicating whether to open the VHD or the RAW disk.
+ *  create:
+ *      A boolean indicating that the disk is to be created first.
+ *
+ * Output Parameters:
+ *  handle:
+ *      A pointer to the location to receive the handle for the disk.
+ *
+ * Return Values:
+ *  The status of opening the disk.
+ */
+static u32 benchOpen(u32 deviceID, bool create, AXP_VHD_HANDLE *handle)
+{
+    AXP_VHD_CREATE_PARAM createParam;
+    AXP_VHD_STORAGE_TYPE storageType;
+    char *path = (deviceID == STORAGE_TYPE_DEV_VHD) ?
+        AXP_BENCH_VHD : AXP_BENCH_RAW;
+    FILE *fp;
+    u32 retVal = AXP_VHD_SUCCESS;
+
+    storageType.deviceID = deviceID;
+    AXP_VHD_KnownGUIDMemory(AXP_Vendor_Microsoft, &storageType.vendorID);
+    if (create == true)
+    {
+        remove(path);
+        if (deviceID == STORAGE_TYPE_DEV_VHD)
+        {
+            createParam.ver = CREATE_VER_1;
+            uuid_clear(createParam.ver_1.GUID.uuid);
+            createParam.ver_1.maxSize = AXP_BENCH_SIZE;
+            createParam.ver_1.blkSize = AXP_VHD_BLK_DEF;
+            createParam.ver_1.sectorSize = AXP_BENCH_SECTOR;
+            createParam.ver_1.parentPath = NULL;
+            createParam.ver_1.srcPath = NULL;
+            retVal = AXP_VHD_Create(&storageType,
+                                    path,
+                                    ACCESS_NONE,
+                                    NULL,
+                                    CREATE_FULL_PHYSICAL_ALLOCATION,
+                                    0,
+                                    &createParam,
+                                    NULL,
+                                    handle);
+            if (retVal == AXP_VHD_SUCCESS)
+            {
+                AXP_VHD_CloseHandle(*handle);
+            }
+        }
+        else
+        {
+            fp = fopen(path, "wb");
+            if ((fp == NULL) || (ftruncate(fileno(fp), AXP_BENCH_SIZE) != 0))
+            {
+                retVal = AXP_VHD_FILE_NOT_FOUND;
+            }
+            if (fp != NULL)
+            {
+                fclose(fp);
+            }
+        }
+    }
+    if (retVal == AXP_VHD_SUCCESS)
+    {
+        retVal = AXP_VHD_Open(&storageType,
+                              path,
+                              ACCESS_ALL,
+                              OPEN_NONE,
+                              NULL,
+                              handle);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * benchDisk
+ *  This function is called to benchmark one disk in one mode.  The disk is
+ *  written from start to end and flushed, read back from start to end, and
+ *  then read a sector at a time from all over.  Only the reads, writes, and
+ *  flush are timed, not filling and checking the buffer.  The disk is closed
+ *  and opened again without being mapped, to check that everything written
+ *  before the flush made it into the file.
+ *
+ * Input Parameters:
+ *  deviceID:
+ *      A value indicating whether to benchmark the VHD or the RAW disk.
+ *  mode:
+ *      A pointer to the mode to benchmark.
+ *  seed:
+ *      A value indicating the pass, so each writes something different.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int benchDisk(u32 deviceID, benchModes *mode, u8 seed)
+{
+    AXP_VHD_HANDLE handle;
+    struct timespec start, end;
+    double writeSecs = 0.0, readSecs = 0.0, randomSecs = 0.0;
+    u32 status;
+    u32 sectors = AXP_BENCH_XFER / AXP_BENCH_SECTOR;
+    u32 sectorsXfer;
+    u64 lba, rnd = seed;
+    int errors = 0;
+    int ii;
+
+    if ((benchOpen(deviceID, seed == 1, &handle) != AXP_VHD_SUCCESS) ||
+        ((mode->mapped == true) &&
+         (AXP_VHD_MemoryMap(handle, mode->advice, mode->sync) !=
+          AXP_VHD_SUCCESS)))
+    {
+        printf("	%-30s ...Failed to open\n", mode->name);
+        return (1);
+    }
+
+    /*
+     * Write the disk from start to end, then flush it.
+     */
+    for (lba = 0; lba < AXP_BENCH_SECTORS; lba += sectors)
+    {
+        benchFill(lba, seed);
+        sectorsXfer = sectors;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        status = AXP_VHD_WriteSectors(handle, lba, &sectorsXfer, benchBuf);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        writeSecs += benchSeconds(&start, &end);
+        if ((status != AXP_VHD_SUCCESS) || (sectorsXfer != sectors))
+        {
+            errors++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    status = AXP_VHD_FlushSectors(handle);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    writeSecs += benchSeconds(&start, &end);
+    if (status != AXP_VHD_SUCCESS)
+    {
+        errors++;
+    }
+
+    /*
+     * Read the disk from start to end.
+     */
+    for (lba = 0; lba < AXP_BENCH_SECTORS; lba += sectors)
+    {
+        sectorsXfer = sectors;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        status = AXP_VHD_ReadSectors(handle, lba, &sectorsXfer, benchBuf);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        readSecs += benchSeconds(&start, &end);
+        if ((status != AXP_VHD_SUCCESS) || (sectorsXfer != sectors))
+        {
+            errors++;
+        }
+        errors += benchCheck(lba, AXP_BENCH_XFER, seed) != 0;
+    }
+
+    /*
+     * Read a sector at a time from all over the disk.
+     */
+    for (ii = 0; ii < AXP_BENCH_RANDOM; ii++)
+    {
+        rnd = rnd * 6364136223846793005ull + 1442695040888963407ull;
+        lba = (rnd >> 33) % AXP_BENCH_SECTORS;
+        sectorsXfer = 1;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        status = AXP_VHD_ReadSectors(handle, lba, &sectorsXfer, benchBuf);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        randomSecs += benchSeconds(&start, &end);
+        if (status != AXP_VHD_SUCCESS)
+        {
+            errors++;
+        }
+        errors += benchCheck(lba, AXP_BENCH_SECTOR, seed) != 0;
+    }
+    AXP_VHD_CloseHandle(handle);
+
+    /*
+     * What was flushed should be in the file, whichever way it was written.
+     */
+    if (benchOpen(deviceID, false, &handle) == AXP_VHD_SUCCESS)
+    {
+        for (lba = 0; lba < AXP_BENCH_SECTORS; lba += sectors)
+        {
+            sectorsXfer = sectors;
+            if (AXP_VHD_ReadSectors(handle, lba, &sectorsXfer, benchBuf) !=
+                AXP_VHD_SUCCESS)
+            {
+                errors++;
+            }
+            errors += benchCheck(lba, AXP_BENCH_XFER, seed) != 0;
+        }
+        AXP_VHD_CloseHandle(handle);
+    }
+    else
+    {
+        errors++;
+    }
+    printf("	%-30s write: %8.1f MB/s, read: %8.1f MB/s, random read: "
+           "%9.0f IO/s - %s\n",
+           mode->name,
+           ((double) AXP_BENCH_SIZE / ONE_M) / writeSecs,
+           ((double) AXP_BENCH_SIZE / ONE_M) / readSecs,
+           AXP_BENCH_RANDOM / randomSecs,
+           (errors == 0) ? "Passed" : "Failed");
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * benchmark
+ *  This function is called to benchmark the fixed VHD and the RAW disk in
+ *  each mode.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int benchmark(void)
+{
+    u32 deviceIDs[] = {STORAGE_TYPE_DEV_VHD, STORAGE_TYPE_DEV_RAW};
+    char *names[] = {"Fixed VHD", "RAW"};
+    int errors = 0;
+    int ii, jj;
+
+    for (ii = 0; ii < 2; ii++)
+    {
+        printf("\n    %s (%u x %u byte writes and reads, %u %u byte random "
+               "reads):\n",
+               names[ii],
+               AXP_BENCH_SIZE / AXP_BENCH_XFER,
+               AXP_BENCH_XFER,
+               AXP_BENCH_RANDOM,
+               AXP_BENCH_SECTOR);
+        for (jj = 0; benchModeCases[jj].name != NULL; jj++)
+        {
+            errors += benchDisk(deviceIDs[ii], &benchModeCases[jj], jj + 1);
+        }
+    }
+    remove(AXP_BENCH_VHD);
+    remove(AXP_BENCH_RAW);
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
 int main(void)
 {
     AXP_VHD_CREATE_PARAM createParam;
@@ -218,6 +644,7 @@ int main(void)
     i32 retVal = AXP_VHD_SUCCESS;
     u32 crcCalc;
     int ii = 0;
+    int errors;
 
     printf("\nDECaxp Disk Testing...\n\n");
 
@@ -280,10 +707,15 @@ int main(void)
         printf("\t...Failed...\n");
     }
 
+    printf("\nTest %d: Benchmark disks with and without memory mapping...\n",
+           ++ii);
+    errors = benchmark();
+    printf("\t...%s...\n", (errors == 0) ? "Succeeded" : "Failed");
+
     /*
      * Return back to the caller.
      */
     printf("...Done.\n");
-    return(0);
+    return((errors == 0) ? 0 : -1);
 }
 
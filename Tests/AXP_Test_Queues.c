@@ -42,8 +42,16 @@
  *
  *  V01.000	11-May-2019 Jonathan D. Belanger
  *  Initially written.
+ *
+ *  V01.001	15-Oct-2026 Jonathan D. Belanger
+ *  Added tests for the single-producer/single-consumer ring, and a benchmark
+ *  comparing the cost of handing IQ entries to the Ebox pipelines through a
+ *  counted queue and a shared condition variable, to doing so through a ring
+ *  and event count per pipeline.
  */
 #include "CommonUtilities/AXP_Utility.h"
+#include <time.h>
+#include <sched.h>
 
 /*
  * This structure contains a queue as a header.
@@ -56,6 +64,313 @@ typedef struct
 
 #define QUEUE_COUNT 100
 
+/*
+ * The following is used to measure the cost of handing instructions from the
+ * Ibox to the Ebox pipelines.  One producer thread (the Ibox) hands entries
+ * to four consumer threads (L0, L1, U0, and U1).  Each entry can be executed
+ * by one, two, or all four of the pipelines, and only one of them gets to
+ * execute it.  No more than HANDOFF_QLEN entries can be outstanding at a time,
+ * just like the IQ.
+ *
+ * The first method is the way it used to be done: a single mutex protected
+ * counted queue, with the consumers holding a shared mutex while they scan
+ * the queue, and the producer broadcasting on a shared condition variable
+ * after each insert.  The second method uses a single-producer/single-consumer
+ * ring and an event count per consumer.
+ */
+#define HANDOFF_PIPES   4
+#define HANDOFF_QLEN    20
+#define HANDOFF_COUNT   1000000
+
+typedef struct
+{
+    AXP_CQUE_ENTRY header;
+    u32 index;
+    u32 eligible;
+    u32 ticket;
+    bool processing;
+} HANDOFF_ENTRY;
+
+typedef struct
+{
+    HANDOFF_ENTRY entries[HANDOFF_QLEN];
+    u32 freeList[HANDOFF_QLEN];
+    u32 flStart;
+    u32 flEnd;
+    u32 outstanding;
+    pthread_mutex_t flMutex;
+    u8 *executed;
+    u32 *itemOf;
+    bool done;
+
+    /*
+     * Counted queue method.
+     */
+    AXP_COUNTED_QUEUE queue;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    /*
+     * Ring method.
+     */
+    AXP_SPSC_RING ring[HANDOFF_PIPES];
+    AXP_EVENT_COUNT wake[HANDOFF_PIPES];
+} HANDOFF_BENCH;
+
+typedef struct
+{
+    HANDOFF_BENCH *bench;
+    u32 pipe;
+} HANDOFF_ARG;
+
+/*
+ * The eligible pipelines for the entries handed off, in the same mix of one,
+ * two, and four pipelines found in the integer instructions.
+ */
+static const u32 handoffMix[8] = {0xf, 0x3, 0xc, 0xf, 0x1, 0xf, 0x4, 0xf};
+
+static double HandoffNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double) ts.tv_sec + ((double) ts.tv_nsec / 1.0e9));
+}
+
+static HANDOFF_ENTRY *HandoffGet(HANDOFF_BENCH *bench, u32 item)
+{
+    HANDOFF_ENTRY *entry;
+
+    while (__atomic_load_n(&bench->outstanding, __ATOMIC_ACQUIRE) >=
+           HANDOFF_QLEN)
+    {
+        sched_yield();
+    }
+    entry = &bench->entries[bench->freeList[bench->flStart]];
+    bench->flStart = (bench->flStart + 1) % HANDOFF_QLEN;
+    __atomic_add_fetch(&bench->outstanding, 1, __ATOMIC_RELAXED);
+    entry->eligible = handoffMix[item % 8];
+    bench->itemOf[entry->index] = item;
+    return (entry);
+}
+
+static void HandoffReturn(HANDOFF_BENCH *bench, HANDOFF_ENTRY *entry)
+{
+    bench->executed[bench->itemOf[entry->index]]++;
+    pthread_mutex_lock(&bench->flMutex);
+    bench->freeList[bench->flEnd] = entry->index;
+    bench->flEnd = (bench->flEnd + 1) % HANDOFF_QLEN;
+    pthread_mutex_unlock(&bench->flMutex);
+    __atomic_sub_fetch(&bench->outstanding, 1, __ATOMIC_RELEASE);
+    return;
+}
+
+static void *HandoffQueueConsumer(void *voidPtr)
+{
+    HANDOFF_ARG *arg = (HANDOFF_ARG *) voidPtr;
+    HANDOFF_BENCH *bench = arg->bench;
+    HANDOFF_ENTRY *entry;
+    u32 mask = 1 << arg->pipe;
+
+    pthread_mutex_lock(&bench->mutex);
+    while (bench->done == false)
+    {
+        AXP_LockCountedQueue(&bench->queue);
+        entry = (HANDOFF_ENTRY *) bench->queue.flink;
+        while (((AXP_COUNTED_QUEUE *) entry != &bench->queue) &&
+               (((entry->eligible & mask) == 0) || entry->processing))
+        {
+            entry = (HANDOFF_ENTRY *) entry->header.flink;
+        }
+        if ((AXP_COUNTED_QUEUE *) entry == &bench->queue)
+        {
+            AXP_UnlockCountedQueue(&bench->queue);
+            pthread_cond_wait(&bench->cond, &bench->mutex);
+            continue;
+        }
+        entry->processing = true;
+        AXP_RemoveCountedQueue((AXP_CQUE_ENTRY *) entry, true);
+        entry->processing = false;
+        HandoffReturn(bench, entry);
+    }
+    pthread_mutex_unlock(&bench->mutex);
+    return (NULL);
+}
+
+static void HandoffQueueProducer(HANDOFF_BENCH *bench)
+{
+    HANDOFF_ENTRY *entry;
+    u32 ii;
+
+    for (ii = 0; ii < HANDOFF_COUNT; ii++)
+    {
+        entry = HandoffGet(bench, ii);
+        AXP_InsertCountedQueue((AXP_CQUE_ENTRY *) &bench->queue,
+                               &entry->header);
+        pthread_mutex_lock(&bench->mutex);
+        pthread_cond_broadcast(&bench->cond);
+        pthread_mutex_unlock(&bench->mutex);
+    }
+    return;
+}
+
+static void *HandoffRingConsumer(void *voidPtr)
+{
+    HANDOFF_ARG *arg = (HANDOFF_ARG *) voidPtr;
+    HANDOFF_BENCH *bench = arg->bench;
+    AXP_SPSC_SLOT slot;
+    HANDOFF_ENTRY *entry;
+    u32 key;
+    bool found;
+
+    while (__atomic_load_n(&bench->done, __ATOMIC_ACQUIRE) == false)
+    {
+        key = AXP_EventCount_Prepare(&bench->wake[arg->pipe]);
+        found = false;
+        while (AXP_SPSCRing_Get(&bench->ring[arg->pipe], &slot) == true)
+        {
+            entry = (HANDOFF_ENTRY *) slot.item;
+            if (__atomic_compare_exchange_n(&entry->ticket,
+                                            &slot.tag,
+                                            0,
+                                            false,
+                                            __ATOMIC_ACQ_REL,
+                                            __ATOMIC_ACQUIRE) == true)
+            {
+                HandoffReturn(bench, entry);
+            }
+            found = true;
+        }
+        if ((found == false) &&
+            (__atomic_load_n(&bench->done, __ATOMIC_ACQUIRE) == false))
+        {
+            AXP_EventCount_Wait(&bench->wake[arg->pipe], key);
+        }
+    }
+    return (NULL);
+}
+
+static void HandoffRingProducer(HANDOFF_BENCH *bench)
+{
+    HANDOFF_ENTRY *entry;
+    u32 ticket = 0;
+    u32 ii, jj;
+    i32 wake;
+
+    for (ii = 0; ii < HANDOFF_COUNT; ii++)
+    {
+        entry = HandoffGet(bench, ii);
+        if (++ticket == 0)
+        {
+            ticket = 1;
+        }
+        __atomic_store_n(&entry->ticket, ticket, __ATOMIC_RELEASE);
+        wake = -1;
+        for (jj = 0; jj < HANDOFF_PIPES; jj++)
+        {
+            if ((entry->eligible & (1 << jj)) != 0)
+            {
+                while (AXP_SPSCRing_Put(&bench->ring[jj], entry, ticket) ==
+                       false)
+                {
+                    AXP_EventCount_Signal(&bench->wake[jj]);
+                    sched_yield();
+                }
+                if ((wake < 0) ||
+                    (AXP_EventCount_Sleeping(&bench->wake[jj]) == false))
+                {
+                    wake = jj;
+                }
+            }
+        }
+        AXP_EventCount_Signal(&bench->wake[wake]);
+    }
+    return;
+}
+
+/*
+ * Run one of the hand-off methods, and return the number of nanoseconds per
+ * entry, or a negative value if any entry was not executed exactly once.
+ */
+static double HandoffRun(bool ring)
+{
+    HANDOFF_BENCH *bench = calloc(1, sizeof(HANDOFF_BENCH));
+    HANDOFF_ARG args[HANDOFF_PIPES];
+    pthread_t threads[HANDOFF_PIPES];
+    double start, retVal;
+    u32 ii;
+
+    bench->executed = calloc(HANDOFF_COUNT, sizeof(u8));
+    bench->itemOf = calloc(HANDOFF_QLEN, sizeof(u32));
+    pthread_mutex_init(&bench->flMutex, NULL);
+    pthread_mutex_init(&bench->mutex, NULL);
+    pthread_cond_init(&bench->cond, NULL);
+    AXP_InitCountedQueue(&bench->queue, HANDOFF_QLEN);
+    for (ii = 0; ii < HANDOFF_QLEN; ii++)
+    {
+        AXP_INIT_CQENTRY(bench->entries[ii].header, bench->queue);
+        bench->entries[ii].index = ii;
+        bench->freeList[ii] = ii;
+    }
+    for (ii = 0; ii < HANDOFF_PIPES; ii++)
+    {
+        AXP_SPSCRing_Init(&bench->ring[ii]);
+        AXP_EventCount_Init(&bench->wake[ii]);
+        args[ii].bench = bench;
+        args[ii].pipe = ii;
+        pthread_create(&threads[ii],
+                       NULL,
+                       (ring ? HandoffRingConsumer : HandoffQueueConsumer),
+                       &args[ii]);
+    }
+
+    start = HandoffNow();
+    if (ring)
+    {
+        HandoffRingProducer(bench);
+    }
+    else
+    {
+        HandoffQueueProducer(bench);
+    }
+    while (__atomic_load_n(&bench->outstanding, __ATOMIC_ACQUIRE) != 0)
+    {
+        sched_yield();
+    }
+    retVal = ((HandoffNow() - start) * 1.0e9) / HANDOFF_COUNT;
+
+    /*
+     * Let the consumers go, and make sure everything was executed once.
+     */
+    pthread_mutex_lock(&bench->mutex);
+    __atomic_store_n(&bench->done, true, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&bench->cond);
+    pthread_mutex_unlock(&bench->mutex);
+    for (ii = 0; ii < HANDOFF_PIPES; ii++)
+    {
+        AXP_EventCount_Signal(&bench->wake[ii]);
+    }
+    for (ii = 0; ii < HANDOFF_PIPES; ii++)
+    {
+        pthread_join(threads[ii], NULL);
+    }
+    for (ii = 0; ii < HANDOFF_COUNT; ii++)
+    {
+        if (bench->executed[ii] != 1)
+        {
+            printf("    Entry %u executed %u times\n",
+                   ii,
+                   bench->executed[ii]);
+            retVal = -1.0;
+            break;
+        }
+    }
+    free(bench->executed);
+    free(bench->itemOf);
+    free(bench);
+    return (retVal);
+}
+
 int main(void)
 {
     AXP_QUEUE_HDR *next = NULL;
@@ -188,6 +503,100 @@ int main(void)
         }
     }
 
+    /*
+     * Next, test the single-producer/single-consumer ring, from a single
+     * thread.
+     */
+    if (retVal == 0)
+    {
+        AXP_SPSC_RING *ring = calloc(1, sizeof(AXP_SPSC_RING));
+        AXP_SPSC_SLOT slot;
+        int jj;
+
+        printf("\nTesting single-producer/single-consumer ring\n");
+        AXP_SPSCRing_Init(ring);
+        for (jj = 0; ((jj < 3) && (retVal == 0)); jj++)
+        {
+            printf("    Filling the ring (pass %d)\n", jj + 1);
+            for (ii = 0; ii < AXP_SPSC_RING_LEN; ii++)
+            {
+                if (AXP_SPSCRing_Put(ring, ring, ii) == false)
+                {
+                    printf("    Put failed at %d.  This is not good.\n", ii);
+                    retVal = -1;
+                    break;
+                }
+            }
+            if ((retVal == 0) && (AXP_SPSCRing_Put(ring, ring, ii) == true))
+            {
+                printf("    Put into a full ring worked.  "
+                       "This is not good.\n");
+                retVal = -1;
+            }
+            if ((retVal == 0) &&
+                (AXP_SPSCRing_Count(ring) != AXP_SPSC_RING_LEN))
+            {
+                printf("    Expected %d, got %u, ring items.  "
+                       "This is not good.\n",
+                       AXP_SPSC_RING_LEN,
+                       AXP_SPSCRing_Count(ring));
+                retVal = -1;
+            }
+            printf("    Emptying and verifying the ring's entries\n");
+            for (ii = 0; ((ii < AXP_SPSC_RING_LEN) && (retVal == 0)); ii++)
+            {
+                if ((AXP_SPSCRing_Get(ring, &slot) == false) ||
+                    (slot.item != ring) ||
+                    (slot.tag != (u32) ii))
+                {
+                    printf("    Ring items not in order at %d\n", ii);
+                    retVal = -1;
+                }
+            }
+            if ((retVal == 0) && (AXP_SPSCRing_Get(ring, &slot) == true))
+            {
+                printf("    Get from an empty ring worked.  "
+                       "This is not good.\n");
+                retVal = -1;
+            }
+        }
+        free(ring);
+        if (retVal == 0)
+        {
+            printf("Ring tests passed\n");
+        }
+    }
+
+    /*
+     * Finally, measure the cost of handing entries to the pipelines, using
+     * each of the methods.
+     */
+    if (retVal == 0)
+    {
+        double queueNs, ringNs;
+
+        printf("\nMeasuring IQ to Ebox pipeline hand-off (%d entries, "
+               "%d pipelines)\n",
+               HANDOFF_COUNT,
+               HANDOFF_PIPES);
+        queueNs = HandoffRun(false);
+        printf("    Counted queue and broadcast: %8.1f ns/entry\n", queueNs);
+        ringNs = HandoffRun(true);
+        printf("    Ring and event count:        %8.1f ns/entry\n", ringNs);
+        if ((queueNs < 0.0) || (ringNs < 0.0))
+        {
+            printf("    At least one entry was not executed exactly once.  "
+                   "This is not good.\n");
+            retVal = -1;
+        }
+        else
+        {
+            printf("    Speed-up:                    %8.2fx\n",
+                   queueNs / ringNs);
+            printf("Hand-off tests passed\n");
+        }
+    }
+
     /*
      * Print final results.
      */
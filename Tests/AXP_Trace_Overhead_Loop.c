@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the instruction loop used to measure the cost of
+ *  the trace statements.  It is compiled twice, once with the tracing compiled
+ *  in and once (with AXP_TRACE_LOOP_OUT defined) with it compiled out.  Each
+ *  instruction passes the same trace statements as one going through the
+ *  Ibox, Ebox, and Mbox.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ */
+#ifdef AXP_TRACE_LOOP_OUT
+#undef AXP_TRACE_COMPILED
+#define AXP_TRACE_COMPILED	0
+#define AXP_TRACE_LOOP		AXP_Trace_Loop_Out
+#else
+#define AXP_TRACE_LOOP		AXP_Trace_Loop_In
+#endif
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Trace.h"
+
+/*
+ * AXP_TRACE_LOOP
+ *  This function is called to "execute" a number of instructions.  Each one is
+ *  fetched, decoded, executed, has its memory accessed, and is retired, with
+ *  the trace statements that each of these steps has in the emulator.
+ *
+ * Input Parameters:
+ *  count:
+ *      A value indicating the number of instructions to execute.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  A checksum of the results, which is the same however the tracing is set.
+ */
+u64 AXP_TRACE_LOOP(u64 count)
+{
+    u64 pc = 0x20000000;
+    u64 regs[32] = {0};
+    u64 ii;
+    u32 inst;
+    u32 opcode, ra, rb, rc;
+    u64 sum = 0;
+
+    for (ii = 0; ii < count; ii++)
+    {
+
+        /*
+         * Fetch.
+         */
+        inst = (u32) ((pc * 0x9e3779b97f4a7c15ll) >> 32);
+        if (AXP_CACHE_OPT2)
+        {
+            AXP_TRACE_BEGIN();
+            AXP_TraceWrite("Icache fetch at 0x%016llx", pc);
+            AXP_TRACE_END();
+        }
+
+        /*
+         * Decode.
+         */
+        opcode = inst >> 26;
+        ra = (inst >> 21) & 0x1f;
+        rb = (inst >> 16) & 0x1f;
+        rc = inst & 0x1f;
+        if (AXP_IBOX_INST)
+        {
+            AXP_TRACE_BEGIN();
+            AXP_TraceWrite("Decoded 0x%08x opcode 0x%02x at 0x%016llx",
+                           inst,
+                           opcode,
+                           pc);
+            AXP_TRACE_END();
+        }
+
+        /*
+         * Execute.
+         */
+        if (AXP_EBOX_OPT2)
+        {
+            AXP_TRACE_BEGIN();
+            AXP_TraceWrite("Ebox executing R%02u, R%02u, R%02u", ra, rb, rc);
+            AXP_TRACE_END();
+        }
+        regs[rc] = regs[ra] + regs[rb] + opcode;
+
+        /*
+         * Memory access (a quarter of the instructions).
+         */
+        if ((opcode & 0x03) == 0)
+        {
+            if (AXP_MBOX_OPT2)
+            {
+                AXP_TRACE_BEGIN();
+                AXP_TraceWrite("Mbox access at 0x%016llx", regs[rb]);
+                AXP_TRACE_END();
+            }
+            regs[ra] ^= regs[rb] >> 3;
+        }
+
+        /*
+         * Retire.
+         */
+        if (AXP_IBOX_OPT1)
+        {
+            AXP_TRACE_BEGIN();
+            AXP_TraceWrite("Retired 0x%08x", inst);
+            AXP_TRACE_END();
+        }
+        sum += regs[rc];
+        pc += 4;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (sum);
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to measure the cost, per
+ *  instruction, of the trace statements, with the tracing compiled out,
+ *  compiled in but turned off, and turned on.  Because tracing can only be
+ *  initialized once, each measurement is run in its own process.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped a line longer than 80 columns.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Trace.h"
+#include <sys/wait.h>
+#include <time.h>
+
+#define AXP_TEST_INSTRUCTIONS	20000000ll
+#define AXP_TEST_TRACED		2000000ll
+#define AXP_TEST_FILE		"AXP_Trace_Overhead_Test.trc"
+
+u64 AXP_Trace_Loop_Out(u64);
+u64 AXP_Trace_Loop_In(u64);
+
+/*
+ * runLoop
+ *  This function is called to run the instruction loop, in a child process,
+ *  and report how long each instruction took.  The child's exit status
+ *  indicates whether the checksum was the expected one.
+ *
+ * Input Parameters:
+ *  name:
+ *      A pointer to the name of the measurement.
+ *  loop:
+ *      A pointer to the instruction loop to run.
+ *  count:
+ *      A value indicating the number of instructions to run.
+ *  mask:
+ *      A pointer to the value for AXP_LOGMASK, or NULL for no tracing.
+ *  expected:
+ *      A value indicating the checksum the loop should return.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  true:   The measurement was taken.
+ *  false:  The measurement could not be taken or the checksum was wrong.
+ */
+static bool runLoop(const char *name,
+                    u64 (*loop)(u64),
+                    u64 count,
+                    const char *mask,
+                    u64 expected)
+{
+    struct timespec start, end;
+    double elapsed;
+    pid_t pid;
+    int status;
+    u64 sum;
+    bool retVal = false;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+    {
+        if (mask != NULL)
+        {
+            setenv("AXP_LOGMASK", mask, 1);
+            setenv("AXP_LOGFILE", AXP_TEST_FILE, 1);
+            setenv("AXP_LOGFORMAT", "binary", 1);
+        }
+        else
+        {
+            unsetenv("AXP_LOGMASK");
+        }
+
+        /*
+         * Run a few instructions first, so that tracing is initialized before
+         * we start timing.
+         */
+        (*loop)(16);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        sum = (*loop)(count);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        elapsed = ((end.tv_sec - start.tv_sec) * 1.0e9) +
+                  (end.tv_nsec - start.tv_nsec);
+        printf("    %-32s %10.3f ns/instruction\n", name, elapsed / count);
+        if (mask != NULL)
+        {
+            printf("    %-32s %10llu records dropped\n",
+                   "",
+                   AXP_TraceDropped());
+            AXP_TraceEnd();
+            remove(AXP_TEST_FILE);
+        }
+        fflush(stdout);
+        _exit((sum == expected) ? 0 : 1);
+    }
+    else if (pid > 0)
+    {
+        retVal = (waitpid(pid, &status, 0) == pid) &&
+                 WIFEXITED(status) &&
+                 (WEXITSTATUS(status) == 0);
+    }
+    if (retVal == false)
+    {
+        printf("%s failed\n", name);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (retVal);
+}
+
+/*
+ * main
+ *  This function is called by the image activator to run the test.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  All tests passed.
+ *  -1: A test failed.
+ */
+int main()
+{
+    u64 expected;
+    u64 expectedTraced;
+    int errors = 0;
+
+    printf("\nAXP Trace Overhead Tester\n");
+
+    /*
+     * Get the checksums, with the tracing compiled out, which the other
+     * measurements must also produce.
+     */
+    expected = AXP_Trace_Loop_Out(AXP_TEST_INSTRUCTIONS);
+    expectedTraced = AXP_Trace_Loop_Out(AXP_TEST_TRACED);
+
+    if (runLoop("Tracing compiled out:",
+                AXP_Trace_Loop_Out,
+                AXP_TEST_INSTRUCTIONS,
+                NULL,
+                expected) == false)
+    {
+        errors++;
+    }
+    if (runLoop("Tracing compiled in, off:",
+                AXP_Trace_Loop_In,
+                AXP_TEST_INSTRUCTIONS,
+                NULL,
+                expected) == false)
+    {
+        errors++;
+    }
+    if (runLoop("Tracing on, other components:",
+                AXP_Trace_Loop_In,
+                AXP_TEST_INSTRUCTIONS,
+                "0x0000000f",
+                expected) == false)
+    {
+        errors++;
+    }
+    if (runLoop("Tracing on (binary):",
+                AXP_Trace_Loop_In,
+                AXP_TEST_TRACED,
+                "0x0000fff0",
+                expectedTraced) == false)
+    {
+        errors++;
+    }
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
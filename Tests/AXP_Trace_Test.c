@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to test the binary trace
+ *  format.  A number of threads write trace records at the same time, then
+ *  the trace file is decoded and each line is compared with the text the
+ *  record should have produced.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Check that ending tracing is safe when the binary format was selected,
+ *  but the drainer thread was never started.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Wrapped a line longer than 80 columns.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "CommonUtilities/AXP_Trace.h"
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define AXP_TEST_THREADS    4
+#define AXP_TEST_BURSTS     5
+#define AXP_TEST_PER_BURST  4000
+#define AXP_TEST_RECORDS    (AXP_TEST_BURSTS * AXP_TEST_PER_BURST)
+#define AXP_TEST_FILE       "AXP_Trace_Test.trc"
+
+static u64 elapsedNs[AXP_TEST_THREADS];
+
+/*
+ * expectedText
+ *  This function generates the text that a trace record written by a test
+ *  thread should decode to.
+ *
+ * Input Parameters:
+ *  thread:
+ *      A value indicating the thread that wrote the record.
+ *  record:
+ *      A value indicating which of the thread's records this is.
+ *  buffer:
+ *      A value indicating whether this is the record written from a buffer,
+ *      rather than with a string literal format.
+ *  outLen:
+ *      The size of the out buffer.
+ *
+ * Output Parameters:
+ *  out:
+ *      A pointer to the buffer to receive the text.
+ *
+ * Return Values:
+ *  None.
+ */
+static void expectedText(int thread,
+                         u32 record,
+                         bool buffer,
+                         char *out,
+                         size_t outLen)
+{
+    static const char *names[] = {"Ibox", "Ebox", "Fbox", "Mbox", "Cbox"};
+
+    if (buffer == true)
+    {
+        snprintf(out, outLen, "thread %d buffer %u", thread, record);
+    }
+    else
+    {
+        snprintf(out,
+                 outLen,
+                 "Thread %d record %u: 0x%016llx %s %-5s|%*d|%.3f|%c|100%%",
+                 thread,
+                 record,
+                 (u64) record * 0x9e3779b97f4a7c15ll,
+                 names[record % 5],
+                 names[(record + thread) % 5],
+                 (thread & 0x03) + 3,
+                 -(int) (record & 0xffff),
+                 (double) record / 7.0,
+                 'A' + (record % 26));
+    }
+    return;
+}
+
+/*
+ * traceThread
+ *  This function is the main function for each of the threads writing trace
+ *  records.  The records are written in bursts, with a pause in between, to
+ *  give the drainer time to empty the ring buffer.
+ *
+ * Input Parameters:
+ *  voidPtr:
+ *      The thread number.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  NULL.
+ */
+static void *traceThread(void *voidPtr)
+{
+    static const char *names[] = {"Ibox", "Ebox", "Fbox", "Mbox", "Cbox"};
+    int thread = (int) (i64) voidPtr;
+    struct timespec pause = {.tv_sec = 0, .tv_nsec = 30000000};
+    struct timespec start, end;
+    char buf[64];
+    u32 record = 0;
+    int burst, ii;
+
+    for (burst = 0; burst < AXP_TEST_BURSTS; burst++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (ii = 0; ii < AXP_TEST_PER_BURST; ii++, record++)
+        {
+            if (AXP_UTL_OPT1)
+            {
+                AXP_TRACE_BEGIN();
+                if ((record % 10) == 9)
+                {
+                    expectedText(thread, record, true, buf, sizeof(buf));
+                    AXP_TraceWrite(buf);
+                }
+                else
+                {
+                    AXP_TraceWrite("Thread %d record %u: 0x%016llx %s %-5s|%*d|"
+                                   "%.3f|%c|100%%",
+                                   thread,
+                                   record,
+                                   (u64) record * 0x9e3779b97f4a7c15ll,
+                                   names[record % 5],
+                                   names[(record + thread) % 5],
+                                   (thread & 0x03) + 3,
+                                   -(int) (record & 0xffff),
+                                   (double) record / 7.0,
+                                   'A' + (record % 26));
+                }
+                AXP_TRACE_END();
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        elapsedNs[thread] += ((end.tv_sec - start.tv_sec) * 1000000000ll) +
+                             (end.tv_nsec - start.tv_nsec);
+        nanosleep(&pause, NULL);
+    }
+    return (NULL);
+}
+
+/*
+ * endWithoutDrainer
+ *  This function checks that tracing can be ended when the binary format was
+ *  selected, but no tracing was turned on, or the trace file could not be
+ *  opened, so the drainer thread was never started.  Tracing can only be
+ *  initialized once in a process, so this is done in a child process.
+ *
+ * Input Parameters:
+ *  mask:
+ *      A pointer to the value for AXP_LOGMASK, or NULL for none.
+ *  file:
+ *      A pointer to the value for AXP_LOGFILE.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  Tracing was ended without the child process failing.
+ *  1:  It was not.
+ */
+static int endWithoutDrainer(const char *mask, const char *file)
+{
+    pid_t pid;
+    int status = -1;
+    int retVal = 1;
+
+    pid = fork();
+    if (pid == 0)
+    {
+        if (mask != NULL)
+        {
+            setenv("AXP_LOGMASK", mask, 1);
+        }
+        setenv("AXP_LOGFILE", file, 1);
+        setenv("AXP_LOGFORMAT", "binary", 1);
+        AXP_TraceInit();
+        AXP_TraceEnd();
+        exit(0);
+    }
+    else if ((pid > 0) &&
+             (waitpid(pid, &status, 0) == pid) &&
+             (WIFEXITED(status) != 0) &&
+             (WEXITSTATUS(status) == 0))
+    {
+        retVal = 0;
+    }
+    else
+    {
+        printf("Ending tracing, with AXP_LOGMASK=%s and AXP_LOGFILE=%s, "
+               "failed (status 0x%x)\n",
+               (mask != NULL) ? mask : "(none)",
+               file,
+               status);
+    }
+    return (retVal);
+}
+
+/*
+ * main
+ *  This function is called by the image activator to run the test.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  All tests passed.
+ *  -1: A test failed.
+ */
+int main()
+{
+    pthread_t threads[AXP_TEST_THREADS];
+    u32 nextRecord[AXP_TEST_THREADS];
+    char line[512];
+    char expected[256];
+    char *text;
+    FILE *trc;
+    FILE *txt;
+    u64 dropped;
+    u64 matched = 0;
+    u64 totalNs = 0;
+    int decoded;
+    int thread;
+    u32 record;
+    int errors = 0;
+    int ii;
+
+    printf("\nAXP Binary Trace Tester\n");
+    errors += endWithoutDrainer(NULL, AXP_TEST_FILE);
+    errors += endWithoutDrainer("0x00000001",
+                                "/nonexistent/AXP_Trace_Test.trc");
+    setenv("AXP_LOGMASK", "0x0000000f", 1);
+    setenv("AXP_LOGFILE", AXP_TEST_FILE, 1);
+    setenv("AXP_LOGFORMAT", "binary", 1);
+    if (AXP_TraceInit() == false)
+    {
+        printf("Unable to initialize tracing\n");
+        return (-1);
+    }
+
+    /*
+     * Have the threads write their records, then end the tracing, so that
+     * everything is written to the file.
+     */
+    for (ii = 0; ii < AXP_TEST_THREADS; ii++)
+    {
+        nextRecord[ii] = 0;
+        pthread_create(&threads[ii], NULL, traceThread, (void *) (i64) ii);
+    }
+    for (ii = 0; ii < AXP_TEST_THREADS; ii++)
+    {
+        pthread_join(threads[ii], NULL);
+        totalNs += elapsedNs[ii];
+    }
+    AXP_TraceEnd();
+    dropped = AXP_TraceDropped();
+
+    /*
+     * Decode the trace file and check each of the lines from the threads.
+     * Each thread's records must be in the order written, and match the text
+     * that would have been written in the text format.
+     */
+    trc = fopen(AXP_TEST_FILE, "rb");
+    txt = tmpfile();
+    if ((trc == NULL) || (txt == NULL))
+    {
+        printf("Unable to open the trace file\n");
+        return (-1);
+    }
+    decoded = AXP_TraceDecode(trc, txt);
+    fclose(trc);
+    rewind(txt);
+    while (fgets(line, sizeof(line), txt) != NULL)
+    {
+        line[strcspn(line, "\n")] = '\0';
+        text = strstr(line, ": ");
+        if (text == NULL)
+        {
+            continue;
+        }
+        text += 2;
+        if ((sscanf(text, "Thread %d record %u:", &thread, &record) != 2) &&
+            (sscanf(text, "thread %d buffer %u", &thread, &record) != 2))
+        {
+            continue;
+        }
+        if ((thread < 0) || (thread >= AXP_TEST_THREADS))
+        {
+            printf("Bad thread number in: %s\n", text);
+            errors++;
+            continue;
+        }
+        expectedText(thread,
+                     record,
+                     (text[0] == 't'),
+                     expected,
+                     sizeof(expected));
+        if (strcmp(text, expected) != 0)
+        {
+            if (errors < 10)
+            {
+                printf("Mismatch:\n    got:      %s\n    expected: %s\n",
+                       text,
+                       expected);
+            }
+            errors++;
+        }
+        if (record < nextRecord[thread])
+        {
+            if (errors < 10)
+            {
+                printf("Thread %d record %u is out of order\n", thread, record);
+            }
+            errors++;
+        }
+        nextRecord[thread] = record + 1;
+        matched++;
+    }
+    fclose(txt);
+    remove(AXP_TEST_FILE);
+
+    printf("    Records written:             %8u\n",
+           AXP_TEST_THREADS * AXP_TEST_RECORDS);
+    printf("    Records decoded:             %8d\n", decoded);
+    printf("    Test records matched:        %8llu\n", matched);
+    printf("    Records dropped:             %8llu\n", dropped);
+    printf("    Time per record:             %8.2f ns\n",
+           (double) totalNs / (AXP_TEST_THREADS * AXP_TEST_RECORDS));
+    if ((matched + dropped) != (AXP_TEST_THREADS * AXP_TEST_RECORDS))
+    {
+        printf("Records were lost, without being counted as dropped\n");
+        errors++;
+    }
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}
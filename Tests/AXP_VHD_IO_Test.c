@@ -0,0 +1,1214 @@
+/*
+ * Copyright (C) Jonathan D. Belanger 2026.
+ * All Rights Reserved.
+ *
+ * This software is furnished under a license and may be used and copied only
+ * in accordance with the terms of such license and with the inclusion of the
+ * above copyright notice.  This software or any other copies thereof may not
+ * be provided or otherwise made available to any other person.  No title to
+ * and ownership of the software is hereby transferred.
+ *
+ * The information in this software is subject to change without notice and
+ * should not be construed as a commitment by the author or co-authors.
+ *
+ * The author and any co-authors assume no responsibility for the use or
+ * reliability of this software.
+ *
+ * Description:
+ *
+ *  This source file contains the main function to test the asynchronous
+ *  virtual disk I/O engine.  Each kind of engine writes a file in batches,
+ *  flushes it, and reads it back, and is timed against reading and writing
+ *  the same file one request at a time through stdio.  Then a fixed VHD is
+ *  created, written, closed, reopened, and read back.  The same is done for a
+ *  dynamic VHD and a dynamic VHDX, which must read unwritten sectors as zeros
+ *  and grow only by the blocks written, and for a differencing VHD, which
+ *  must read what it does not have from its parent, and leave the parent
+ *  alone.  Finally, a dynamic VHD is timed against a fixed one.
+ *
+ * Revision History:
+ *
+ *  V01.000 16-Oct-2026 Jonathan D. Belanger
+ *  Initially written.
+ *
+ *  V01.001 16-Oct-2026 Jonathan D. Belanger
+ *  Added tests for dynamic and differencing virtual disks.
+ *
+ *  V01.002 16-Oct-2026 Jonathan D. Belanger
+ *  Added a test for opening a VHDX that does not exist, or that is too
+ *  small to be one.
+ */
+#include "CommonUtilities/AXP_Utility.h"
+#include "Devices/VirtualDisks/AXP_VirtualDisk.h"
+#include "Devices/VirtualDisks/AXP_VHD_Utility.h"
+#include "Devices/VirtualDisks/AXP_VHD_AsyncIO.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define AXP_TEST_FILE       "/tmp/AXP_VHD_IO_Test.dat"
+#define AXP_TEST_VHD        "/tmp/AXP_VHD_IO_Test.vhd"
+#define AXP_TEST_PARENT     "/tmp/AXP_VHD_IO_Test_Parent.vhd"
+#define AXP_TEST_VHDX       "/tmp/AXP_VHD_IO_Test.vhdx"
+#define AXP_TEST_DYN_SIZE   (64 * ONE_M)
+#define AXP_TEST_TIME_SIZE  (16 * ONE_M)
+#define AXP_TEST_TIME_XFER  (64 * ONE_K)
+#define AXP_TEST_XFER       (4 * ONE_K)
+#define AXP_TEST_XFERS      4096
+#define AXP_TEST_SIZE       ((u64) AXP_TEST_XFER * AXP_TEST_XFERS)
+#define AXP_TEST_BATCH      128
+#define AXP_TEST_SECTOR     512
+#define AXP_TEST_SECTORS    8
+
+static AXP_VHD_IO_REQ reqs[AXP_TEST_XFERS];
+static AXP_VHD_IO_REQ *reqPtrs[AXP_TEST_XFERS];
+static u8 testBuf[AXP_TEST_SIZE];
+static u32 doneCount = 0;
+
+/*
+ * countDone
+ *  This function is called by the engine as each request completes.
+ *
+ * Input Parameters:
+ *  req:
+ *      A pointer to the request that completed.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  None.
+ */
+static void countDone(AXP_VHD_IO_REQ *req)
+{
+    if ((req->status == AXP_VHD_SUCCESS) && (req->transferred == req->length))
+    {
+        __atomic_add_fetch(&doneCount, 1, __ATOMIC_RELAXED);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * fill
+ *  This function is called to fill a buffer with a pattern that depends upon
+ *  where in the file the buffer goes.
+ *
+ * Input Parameters:
+ *  buf:
+ *      A pointer to the buffer to be filled.
+ *  len:
+ *      A value indicating the length of the buffer.
+ *  offset:
+ *      A value indicating the offset of the buffer within the file.
+ *  seed:
+ *      A value to make the pattern differ from one pass to the next.
+ *
+ * Output Parameters:
+ *  buf:
+ *      A pointer to the filled buffer.
+ *
+ * Return Values:
+ *  None.
+ */
+static void fill(u8 *buf, size_t len, u64 offset, u8 seed)
+{
+    size_t ii;
+
+    for (ii = 0; ii < len; ii++)
+    {
+        buf[ii] = (u8) (((offset + ii) * 7) + ((offset + ii) >> 12) + seed);
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return;
+}
+
+/*
+ * elapsed
+ *  This function is called to return the number of seconds between two times.
+ *
+ * Input Parameters:
+ *  start:
+ *      A pointer to the starting time.
+ *  end:
+ *      A pointer to the ending time.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of seconds from start to end.
+ */
+static double elapsed(struct timespec *start, struct timespec *end)
+{
+    return ((double) (end->tv_sec - start->tv_sec) +
+            ((double) (end->tv_nsec - start->tv_nsec) / 1.0e9));
+}
+
+/*
+ * runBatch
+ *  This function is called to read or write the entire test file with the
+ *  engine, a batch of requests at a time, and wait for them all to complete.
+ *  The requests alternate between going up from the start of the file and
+ *  down from the end of it, so that some are contiguous and some are not.
+ *
+ * Input Parameters:
+ *  io:
+ *      A pointer to the engine.
+ *  op:
+ *      A value indicating whether to read or write.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of requests that did not complete successfully.
+ */
+static int runBatch(AXP_VHD_IO_ENGINE *io, AXP_VHD_IO_OP op)
+{
+    u32 ii, xfer;
+
+    doneCount = 0;
+    for (ii = 0; ii < AXP_TEST_XFERS; ii++)
+    {
+        xfer = (ii & 1) ? (AXP_TEST_XFERS - 1 - (ii / 2)) : (ii / 2);
+        reqs[ii].op = op;
+        reqs[ii].buf = &testBuf[(u64) xfer * AXP_TEST_XFER];
+        reqs[ii].offset = (u64) xfer * AXP_TEST_XFER;
+        reqs[ii].length = AXP_TEST_XFER;
+        reqs[ii].done = countDone;
+        reqPtrs[ii] = &reqs[ii];
+    }
+    for (ii = 0; ii < AXP_TEST_XFERS; ii += AXP_TEST_BATCH)
+    {
+        if (AXP_VHD_IO_Submit(io, &reqPtrs[ii], AXP_TEST_BATCH) !=
+            AXP_VHD_SUCCESS)
+        {
+            break;
+        }
+    }
+    AXP_VHD_IO_Wait(io);
+
+    /*
+     * Return back to the caller.
+     */
+    return (AXP_TEST_XFERS - doneCount);
+}
+
+/*
+ * testEngine
+ *  This function is called to test one kind of engine, and time it against
+ *  stdio.
+ *
+ * Input Parameters:
+ *  type:
+ *      A value indicating the kind of engine to test.
+ *  name:
+ *      A pointer to the name of the engine.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int testEngine(AXP_VHD_IO_TYPE type, const char *name)
+{
+    AXP_VHD_IO_ENGINE *io;
+    AXP_VHD_IO_REQ flush;
+    AXP_VHD_IO_REQ *flushPtr = &flush;
+    struct timespec start, end;
+    double engineSecs, stdioSecs;
+    FILE *fp;
+    size_t len;
+    u64 offset;
+    int errors = 0;
+    int fd;
+
+    printf("\n    %s engine:\n", name);
+    fp = fopen(AXP_TEST_FILE, "wb+");
+    if (fp == NULL)
+    {
+        printf("\tUnable to create %s\n", AXP_TEST_FILE);
+        return (1);
+    }
+    fd = fileno(fp);
+    if (ftruncate(fd, AXP_TEST_SIZE) != 0)
+    {
+        printf("\tUnable to size %s\n", AXP_TEST_FILE);
+        fclose(fp);
+        return (1);
+    }
+    io = AXP_VHD_IO_Create(fd, AXP_VHD_IO_DEPTH, type);
+    if (io == NULL)
+    {
+        printf("\t...not available on this host, skipped.\n");
+        fclose(fp);
+        return (0);
+    }
+
+    /*
+     * Write the file, flush it, then read it back.
+     */
+    fill(testBuf, AXP_TEST_SIZE, 0, 1);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    errors += runBatch(io, AXP_VHD_IO_Write);
+    flush.op = AXP_VHD_IO_Flush;
+    flush.done = NULL;
+    if (AXP_VHD_IO_Submit(io, &flushPtr, 1) == AXP_VHD_SUCCESS)
+    {
+        AXP_VHD_IO_Wait(io);
+    }
+    else
+    {
+        flush.status = AXP_VHD_WRITE_FAULT;
+    }
+    if (flush.status != AXP_VHD_SUCCESS)
+    {
+        printf("\tFlush failed\n");
+        errors++;
+    }
+    memset(testBuf, 0, AXP_TEST_SIZE);
+    errors += runBatch(io, AXP_VHD_IO_Read);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    engineSecs = elapsed(&start, &end);
+    for (offset = 0; offset < AXP_TEST_SIZE; offset += AXP_TEST_XFER)
+    {
+        u8 expected[AXP_TEST_XFER];
+
+        fill(expected, AXP_TEST_XFER, offset, 1);
+        if (memcmp(&testBuf[offset], expected, AXP_TEST_XFER) != 0)
+        {
+            errors++;
+        }
+    }
+    printf("\tMost I/Os in flight: %u (depth %u)\n",
+           AXP_VHD_IO_MaxInFlight(io),
+           AXP_VHD_IO_DEPTH);
+    if (AXP_VHD_IO_MaxInFlight(io) > AXP_VHD_IO_DEPTH)
+    {
+        errors++;
+    }
+    AXP_VHD_IO_Destroy(io);
+
+    /*
+     * Do the same thing, one request at a time, through stdio.
+     */
+    fill(testBuf, AXP_TEST_SIZE, 0, 2);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (offset = 0; offset < AXP_TEST_SIZE; offset += AXP_TEST_XFER)
+    {
+        if (AXP_WriteAtOffset(fp,
+                              &testBuf[offset],
+                              AXP_TEST_XFER,
+                              offset) == false)
+        {
+            errors++;
+        }
+    }
+    fflush(fp);
+    fdatasync(fd);
+    for (offset = 0; offset < AXP_TEST_SIZE; offset += AXP_TEST_XFER)
+    {
+        len = AXP_TEST_XFER;
+        if (AXP_ReadFromOffset(fp, &testBuf[offset], &len, offset) == false)
+        {
+            errors++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    stdioSecs = elapsed(&start, &end);
+    fclose(fp);
+    remove(AXP_TEST_FILE);
+
+    printf("\t%s: %8.1f MB/s, stdio: %8.1f MB/s (%u x %u byte writes, "
+           "flush, and reads)\n",
+           name,
+           (2.0 * AXP_TEST_SIZE / ONE_M) / engineSecs,
+           (2.0 * AXP_TEST_SIZE / ONE_M) / stdioSecs,
+           AXP_TEST_XFERS,
+           AXP_TEST_XFER);
+    printf("\t...%s\n", (errors == 0) ? "Passed" : "Failed");
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * testFixedVHD
+ *  This function is called to create a fixed VHD, write sectors to it both
+ *  synchronously and in a batch, then close, reopen, and read them back.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int testFixedVHD(void)
+{
+    AXP_VHD_CREATE_PARAM createParam;
+    AXP_VHD_STORAGE_TYPE storageType;
+    AXP_VHD_HANDLE handle;
+    u8 buf[AXP_TEST_SECTOR * AXP_TEST_SECTORS];
+    u8 expected[AXP_TEST_SECTOR * AXP_TEST_SECTORS];
+    u32 sectors, count, ii;
+    u64 lba;
+    int errors = 0;
+
+    printf("\n    Fixed VHD:\n");
+    remove(AXP_TEST_VHD);
+    createParam.ver = CREATE_VER_1;
+    uuid_clear(createParam.ver_1.GUID.uuid);
+    createParam.ver_1.maxSize = 4 * ONE_M;
+    createParam.ver_1.blkSize = AXP_VHD_DEF_BLK;
+    createParam.ver_1.sectorSize = AXP_TEST_SECTOR;
+    createParam.ver_1.parentPath = NULL;
+    createParam.ver_1.srcPath = NULL;
+    storageType.deviceID = STORAGE_TYPE_DEV_VHD;
+    AXP_VHD_KnownGUIDMemory(AXP_Vendor_Microsoft, &storageType.vendorID);
+    if (AXP_VHD_Create(&storageType,
+                       AXP_TEST_VHD,
+                       ACCESS_NONE,
+                       NULL,
+                       CREATE_FULL_PHYSICAL_ALLOCATION,
+                       0,
+                       &createParam,
+                       NULL,
+                       &handle) != AXP_VHD_SUCCESS)
+    {
+        printf("\tUnable to create %s\n", AXP_TEST_VHD);
+        return (1);
+    }
+
+    /*
+     * Write the first few sectors one call at a time, and the rest in
+     * batches.
+     */
+    for (lba = 0; lba < 64; lba += AXP_TEST_SECTORS)
+    {
+        fill(buf, sizeof(buf), lba * AXP_TEST_SECTOR, 3);
+        sectors = AXP_TEST_SECTORS;
+        if ((AXP_VHD_WriteSectors(handle, lba, &sectors, buf) !=
+             AXP_VHD_SUCCESS) || (sectors != AXP_TEST_SECTORS))
+        {
+            errors++;
+        }
+    }
+    fill(testBuf, ONE_M, 0, 3);
+    doneCount = 0;
+    count = (ONE_M / sizeof(buf)) - 8;
+    for (ii = 0; ii < count; ii++)
+    {
+        reqs[ii].op = AXP_VHD_IO_Write;
+        reqs[ii].lba = (ii + 8) * AXP_TEST_SECTORS;
+        reqs[ii].sectors = AXP_TEST_SECTORS;
+        reqs[ii].buf = &testBuf[reqs[ii].lba * AXP_TEST_SECTOR];
+        reqs[ii].done = countDone;
+        reqPtrs[ii] = &reqs[ii];
+    }
+    reqs[count].op = AXP_VHD_IO_Flush;
+    reqs[count].done = NULL;
+    reqPtrs[count] = &reqs[count];
+    if (AXP_VHD_SubmitSectors(handle, reqPtrs, count + 1) != AXP_VHD_SUCCESS)
+    {
+        printf("\tUnable to submit the writes\n");
+        errors++;
+    }
+    AXP_VHD_WaitSectors(handle);
+    if ((doneCount != count) || (reqs[count].status != AXP_VHD_SUCCESS))
+    {
+        printf("\t%u of %u writes completed\n", doneCount, count);
+        errors++;
+    }
+
+    /*
+     * A request past the end of the disk is rejected.
+     */
+    reqs[0].op = AXP_VHD_IO_Read;
+    reqs[0].lba = createParam.ver_1.maxSize / AXP_TEST_SECTOR;
+    if (AXP_VHD_SubmitSectors(handle, reqPtrs, 1) != AXP_VHD_INV_PARAM)
+    {
+        printf("\tRead past the end of the disk not detected\n");
+        errors++;
+    }
+    AXP_VHD_CloseHandle(handle);
+
+    /*
+     * Open it again, which must not lose what was written, and read it back.
+     */
+    if (AXP_VHD_Open(&storageType,
+                     AXP_TEST_VHD,
+                     ACCESS_ALL,
+                     OPEN_NO_PARENTS,
+                     NULL,
+                     &handle) != AXP_VHD_SUCCESS)
+    {
+        printf("\tUnable to open %s\n", AXP_TEST_VHD);
+        remove(AXP_TEST_VHD);
+        return (errors + 1);
+    }
+    for (lba = 0; lba < (ONE_M / AXP_TEST_SECTOR); lba += AXP_TEST_SECTORS)
+    {
+        fill(expected, sizeof(expected), lba * AXP_TEST_SECTOR, 3);
+        sectors = AXP_TEST_SECTORS;
+        if ((AXP_VHD_ReadSectors(handle, lba, &sectors, buf) !=
+             AXP_VHD_SUCCESS) ||
+            (sectors != AXP_TEST_SECTORS) ||
+            (memcmp(buf, expected, sizeof(buf)) != 0))
+        {
+            errors++;
+        }
+    }
+    AXP_VHD_CloseHandle(handle);
+    remove(AXP_TEST_VHD);
+    printf("\t...%s\n", (errors == 0) ? "Passed" : "Failed");
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * createDisk
+ *  This function is called to create a virtual disk for a test.
+ *
+ * Input Parameters:
+ *  path:
+ *      A pointer to the path for the disk.
+ *  deviceID:
+ *      A value indicating whether to create a VHD or VHDX.
+ *  flags:
+ *      A value indicating whether the disk is fixed or dynamic.
+ *  blkSize:
+ *      A value indicating the block size.
+ *  parentPath:
+ *      A pointer to the path to the parent, or NULL.
+ *
+ * Output Parameters:
+ *  handle:
+ *      A pointer to the location to receive the handle for the disk.
+ *
+ * Return Values:
+ *  The status of creating the disk.
+ */
+static u32 createDisk(char *path,
+                      u32 deviceID,
+                      AXP_VHD_CREATE_FLAG flags,
+                      u32 blkSize,
+                      char *parentPath,
+                      AXP_VHD_HANDLE *handle)
+{
+    AXP_VHD_CREATE_PARAM createParam;
+    AXP_VHD_STORAGE_TYPE storageType;
+
+    remove(path);
+    createParam.ver = CREATE_VER_1;
+    uuid_clear(createParam.ver_1.GUID.uuid);
+    createParam.ver_1.maxSize = (parentPath == NULL) ? AXP_TEST_DYN_SIZE : 0;
+    createParam.ver_1.blkSize = blkSize;
+    createParam.ver_1.sectorSize = AXP_TEST_SECTOR;
+    createParam.ver_1.parentPath = parentPath;
+    createParam.ver_1.srcPath = NULL;
+    storageType.deviceID = deviceID;
+    AXP_VHD_KnownGUIDMemory(AXP_Vendor_Microsoft, &storageType.vendorID);
+    return (AXP_VHD_Create(&storageType,
+                           path,
+                           ACCESS_NONE,
+                           NULL,
+                           flags,
+                           0,
+                           &createParam,
+                           NULL,
+                           handle));
+}
+
+/*
+ * openDisk
+ *  This function is called to open a virtual disk for a test.
+ *
+ * Input Parameters:
+ *  path:
+ *      A pointer to the path for the disk.
+ *  deviceID:
+ *      A value indicating whether the disk is a VHD or VHDX.
+ *
+ * Output Parameters:
+ *  handle:
+ *      A pointer to the location to receive the handle for the disk.
+ *
+ * Return Values:
+ *  The status of opening the disk.
+ */
+static u32 openDisk(char *path, u32 deviceID, AXP_VHD_HANDLE *handle)
+{
+    AXP_VHD_STORAGE_TYPE storageType;
+
+    storageType.deviceID = deviceID;
+    AXP_VHD_KnownGUIDMemory(AXP_Vendor_Microsoft, &storageType.vendorID);
+    return (AXP_VHD_Open(&storageType,
+                         path,
+                         ACCESS_ALL,
+                         OPEN_NONE,
+                         NULL,
+                         handle));
+}
+
+/*
+ * fileSize
+ *  This function is called to get the size of a file.
+ *
+ * Input Parameters:
+ *  path:
+ *      A pointer to the path for the file.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The size of the file, in bytes.
+ */
+static u64 fileSize(char *path)
+{
+    struct stat st;
+
+    return ((stat(path, &st) == 0) ? (u64) st.st_size : 0);
+}
+
+/*
+ * checkSectors
+ *  This function is called to read sectors from a disk, and compare them with
+ *  what they should be.  The sectors in [lo, hi) should have the pattern for
+ *  seed, and the rest the pattern for other, or zeros if other is zero.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A handle for the disk.
+ *  lba:
+ *      A value indicating the first sector.
+ *  sectors:
+ *      A value indicating the number of sectors.
+ *  lo:
+ *      A value indicating the first sector with the seed pattern.
+ *  hi:
+ *      A value indicating the sector after the last with the seed pattern.
+ *  seed:
+ *      A value indicating the pattern written to [lo, hi).
+ *  other:
+ *      A value indicating the pattern of the other sectors, or zero.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int checkSectors(AXP_VHD_HANDLE handle,
+                        u64 lba,
+                        u32 sectors,
+                        u64 lo,
+                        u64 hi,
+                        u8 seed,
+                        u8 other)
+{
+    u8 *expected = &testBuf[AXP_TEST_SIZE / 2];
+    u32 sectorsRead = sectors;
+    u64 ii;
+    int errors = 0;
+
+    for (ii = lba; ii < (lba + sectors); ii++)
+    {
+        if ((ii >= lo) && (ii < hi))
+        {
+            fill(&expected[(ii - lba) * AXP_TEST_SECTOR],
+                 AXP_TEST_SECTOR,
+                 ii * AXP_TEST_SECTOR,
+                 seed);
+        }
+        else if (other != 0)
+        {
+            fill(&expected[(ii - lba) * AXP_TEST_SECTOR],
+                 AXP_TEST_SECTOR,
+                 ii * AXP_TEST_SECTOR,
+                 other);
+        }
+        else
+        {
+            memset(&expected[(ii - lba) * AXP_TEST_SECTOR], 0, AXP_TEST_SECTOR);
+        }
+    }
+    if ((AXP_VHD_ReadSectors(handle, lba, &sectorsRead, testBuf) !=
+         AXP_VHD_SUCCESS) ||
+        (sectorsRead != sectors) ||
+        (memcmp(testBuf, expected, (size_t) sectors * AXP_TEST_SECTOR) != 0))
+    {
+        printf("\tSectors %llu to %llu are not correct\n",
+               (unsigned long long) lba,
+               (unsigned long long) (lba + sectors - 1));
+        errors++;
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * writeSectors
+ *  This function is called to write a pattern to sectors of a disk, either
+ *  with one call or as a batch of requests.
+ *
+ * Input Parameters:
+ *  handle:
+ *      A handle for the disk.
+ *  lba:
+ *      A value indicating the first sector.
+ *  sectors:
+ *      A value indicating the number of sectors.
+ *  seed:
+ *      A value indicating the pattern.
+ *  batch:
+ *      A value indicating whether to submit a batch of requests, each of
+ *      AXP_TEST_SECTORS sectors.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int writeSectors(AXP_VHD_HANDLE handle,
+                        u64 lba,
+                        u32 sectors,
+                        u8 seed,
+                        bool batch)
+{
+    u32 sectorsWritten = sectors;
+    u32 count = sectors / AXP_TEST_SECTORS;
+    u32 ii;
+    int errors = 0;
+
+    fill(testBuf,
+         (size_t) sectors * AXP_TEST_SECTOR,
+         lba * AXP_TEST_SECTOR,
+         seed);
+    if (batch == false)
+    {
+        if ((AXP_VHD_WriteSectors(handle, lba, &sectorsWritten, testBuf) !=
+             AXP_VHD_SUCCESS) ||
+            (sectorsWritten != sectors))
+        {
+            errors++;
+        }
+    }
+    else
+    {
+        doneCount = 0;
+        for (ii = 0; ii < count; ii++)
+        {
+            reqs[ii].op = AXP_VHD_IO_Write;
+            reqs[ii].lba = lba + (ii * AXP_TEST_SECTORS);
+            reqs[ii].sectors = AXP_TEST_SECTORS;
+            reqs[ii].buf = &testBuf[ii * AXP_TEST_SECTORS * AXP_TEST_SECTOR];
+            reqs[ii].done = countDone;
+            reqPtrs[ii] = &reqs[ii];
+        }
+        if (AXP_VHD_SubmitSectors(handle, reqPtrs, count) != AXP_VHD_SUCCESS)
+        {
+            errors++;
+        }
+        AXP_VHD_WaitSectors(handle);
+        if (doneCount != count)
+        {
+            errors++;
+        }
+    }
+    if (errors != 0)
+    {
+        printf("\tUnable to write sectors %llu to %llu\n",
+               (unsigned long long) lba,
+               (unsigned long long) (lba + sectors - 1));
+    }
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * testDynamic
+ *  This function is called to create a dynamic disk, check that it reads as
+ *  zeros without growing, write sectors to it both synchronously and in a
+ *  batch, across block boundaries, then close, reopen, and read them back.
+ *
+ * Input Parameters:
+ *  path:
+ *      A pointer to the path for the disk.
+ *  deviceID:
+ *      A value indicating whether to create a VHD or VHDX.
+ *  blkSize:
+ *      A value indicating the block size.
+ *  name:
+ *      A pointer to the name of the test.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int testDynamic(char *path, u32 deviceID, u32 blkSize, const char *name)
+{
+    AXP_VHD_HANDLE handle;
+    u32 blkSectors = blkSize / AXP_TEST_SECTOR;
+    u64 emptySize, grownSize;
+    int errors = 0;
+
+    printf("\n    Dynamic %s:\n", name);
+    if (createDisk(path,
+                   deviceID,
+                   CREATE_NONE,
+                   blkSize,
+                   NULL,
+                   &handle) != AXP_VHD_SUCCESS)
+    {
+        printf("\tUnable to create %s\n", path);
+        return (1);
+    }
+    emptySize = fileSize(path);
+
+    /*
+     * Nothing has been written, so everything is zeros, and reading it does
+     * not make the file any bigger.
+     */
+    errors += checkSectors(handle, 0, 2 * ONE_K, 0, 0, 0, 0);
+    errors += checkSectors(handle,
+                           (AXP_TEST_DYN_SIZE / AXP_TEST_SECTOR) - 64,
+                           64,
+                           0,
+                           0,
+                           0,
+                           0);
+    if (fileSize(path) != emptySize)
+    {
+        printf("\tReading grew the file from %llu to %llu bytes\n",
+               (unsigned long long) emptySize,
+               (unsigned long long) fileSize(path));
+        errors++;
+    }
+
+    /*
+     * Write across the boundary between the first two blocks, and a batch in
+     * the middle of a later block.
+     */
+    errors += writeSectors(handle, blkSectors - 12, 24, 5, false);
+    errors += writeSectors(handle, (4 * blkSectors) + 64, ONE_K, 7, true);
+    errors += checkSectors(handle,
+                           blkSectors - 16,
+                           32,
+                           blkSectors - 12,
+                           blkSectors + 12,
+                           5,
+                           0);
+    AXP_VHD_CloseHandle(handle);
+
+    /*
+     * Three blocks were written, so the file grew by about that much.
+     */
+    grownSize = fileSize(path);
+    if ((grownSize < (emptySize + (3 * (u64) blkSize))) ||
+        (grownSize > (emptySize + (4 * (u64) blkSize))))
+    {
+        printf("\tFile grew from %llu to %llu bytes for 3 blocks\n",
+               (unsigned long long) emptySize,
+               (unsigned long long) grownSize);
+        errors++;
+    }
+
+    /*
+     * Open it again, and check everything written, and not, is still there.
+     */
+    if (openDisk(path, deviceID, &handle) != AXP_VHD_SUCCESS)
+    {
+        printf("\tUnable to open %s\n", path);
+        remove(path);
+        return (errors + 1);
+    }
+    errors += checkSectors(handle,
+                           blkSectors - 16,
+                           32,
+                           blkSectors - 12,
+                           blkSectors + 12,
+                           5,
+                           0);
+    errors += checkSectors(handle,
+                           4 * blkSectors,
+                           ONE_K + 128,
+                           (4 * blkSectors) + 64,
+                           (4 * blkSectors) + 64 + ONE_K,
+                           7,
+                           0);
+    errors += checkSectors(handle, 2 * blkSectors, 64, 0, 0, 0, 0);
+    AXP_VHD_CloseHandle(handle);
+    remove(path);
+    printf("\t...%s\n", (errors == 0) ? "Passed" : "Failed");
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * testDifferencing
+ *  This function is called to create a dynamic VHD with some sectors
+ *  written, and a differencing VHD on top of it.  The differencing disk must
+ *  read the parent's sectors, until they are written, and writing them must
+ *  leave the parent alone.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int testDifferencing(void)
+{
+    AXP_VHD_HANDLE handle;
+    u32 ii;
+    int errors = 0;
+
+    printf("\n    Differencing VHD:\n");
+    if (createDisk(AXP_TEST_PARENT,
+                   STORAGE_TYPE_DEV_VHD,
+                   CREATE_NONE,
+                   AXP_VHD_BLK_DEF,
+                   NULL,
+                   &handle) != AXP_VHD_SUCCESS)
+    {
+        printf("\tUnable to create %s\n", AXP_TEST_PARENT);
+        return (1);
+    }
+    errors += writeSectors(handle, 0, 2 * ONE_K, 5, false);
+    AXP_VHD_CloseHandle(handle);
+    if (createDisk(AXP_TEST_VHD,
+                   STORAGE_TYPE_DEV_VHD,
+                   CREATE_NONE,
+                   AXP_VHD_BLK_DEF,
+                   AXP_TEST_PARENT,
+                   &handle) != AXP_VHD_SUCCESS)
+    {
+        printf("\tUnable to create %s\n", AXP_TEST_VHD);
+        remove(AXP_TEST_PARENT);
+        return (errors + 1);
+    }
+
+    /*
+     * Everything comes from the parent, until it is written.
+     */
+    errors += checkSectors(handle, 0, 2 * ONE_K, 0, 2 * ONE_K, 5, 0);
+    errors += writeSectors(handle, 100, 8, 9, false);
+    errors += writeSectors(handle, 5000, 16, 9, true);
+    errors += checkSectors(handle, 96, 16, 100, 108, 9, 5);
+    errors += checkSectors(handle, 4992, 32, 5000, 5016, 9, 0);
+
+    /*
+     * A batch of reads, some of which are all in the differencing disk, and
+     * some of which are partly in the parent.
+     */
+    doneCount = 0;
+    for (ii = 0; ii < 8; ii++)
+    {
+        reqs[ii].op = AXP_VHD_IO_Read;
+        reqs[ii].lba = 96 + (ii * 2);
+        reqs[ii].sectors = 2;
+        reqs[ii].buf = &testBuf[ii * 2 * AXP_TEST_SECTOR];
+        reqs[ii].done = countDone;
+        reqPtrs[ii] = &reqs[ii];
+    }
+    if (AXP_VHD_SubmitSectors(handle, reqPtrs, 8) != AXP_VHD_SUCCESS)
+    {
+        errors++;
+    }
+    AXP_VHD_WaitSectors(handle);
+    fill(&testBuf[AXP_TEST_SIZE / 2],
+         16 * AXP_TEST_SECTOR,
+         96 * AXP_TEST_SECTOR,
+         5);
+    fill(&testBuf[(AXP_TEST_SIZE / 2) + (4 * AXP_TEST_SECTOR)],
+         8 * AXP_TEST_SECTOR,
+         100 * AXP_TEST_SECTOR,
+         9);
+    if ((doneCount != 8) ||
+        (memcmp(testBuf,
+                &testBuf[AXP_TEST_SIZE / 2],
+                16 * AXP_TEST_SECTOR) != 0))
+    {
+        printf("\tBatch of reads is not correct\n");
+        errors++;
+    }
+    AXP_VHD_CloseHandle(handle);
+
+    /*
+     * Opening it again finds the parent from the parent locator.
+     */
+    if (openDisk(AXP_TEST_VHD,
+                 STORAGE_TYPE_DEV_VHD,
+                 &handle) == AXP_VHD_SUCCESS)
+    {
+        errors += checkSectors(handle, 96, 16, 100, 108, 9, 5);
+        errors += checkSectors(handle, 1000, 64, 0, 2 * ONE_K, 5, 0);
+        AXP_VHD_CloseHandle(handle);
+    }
+    else
+    {
+        printf("\tUnable to open %s\n", AXP_TEST_VHD);
+        errors++;
+    }
+
+    /*
+     * The parent has not been changed.
+     */
+    if (openDisk(AXP_TEST_PARENT,
+                 STORAGE_TYPE_DEV_VHD,
+                 &handle) == AXP_VHD_SUCCESS)
+    {
+        errors += checkSectors(handle, 96, 16, 0, 2 * ONE_K, 5, 0);
+        errors += checkSectors(handle, 4992, 32, 0, 0, 0, 0);
+        AXP_VHD_CloseHandle(handle);
+    }
+    else
+    {
+        printf("\tUnable to open %s\n", AXP_TEST_PARENT);
+        errors++;
+    }
+    remove(AXP_TEST_VHD);
+    remove(AXP_TEST_PARENT);
+    printf("\t...%s\n", (errors == 0) ? "Passed" : "Failed");
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * testBadVHDX
+ *  This function is called to open a VHDX that does not exist, and one that
+ *  is too small to hold the header section.  Neither one can be opened.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int testBadVHDX(void)
+{
+    AXP_VHD_HANDLE handle;
+    FILE *fp;
+    u32 retVal;
+    int errors = 0;
+
+    printf("\n    Bad VHDX:\n");
+    remove(AXP_TEST_VHDX);
+    retVal = openDisk(AXP_TEST_VHDX, STORAGE_TYPE_DEV_VHDX, &handle);
+    if (retVal != AXP_VHD_FILE_NOT_FOUND)
+    {
+        printf("\tOpening a missing VHDX returned %u\n", retVal);
+        errors++;
+    }
+    fp = fopen(AXP_TEST_VHDX, "wb");
+    if (fp != NULL)
+    {
+        fill(testBuf, 4 * AXP_TEST_SECTOR, 0, 3);
+        fwrite(testBuf, AXP_TEST_SECTOR, 4, fp);
+        fclose(fp);
+        retVal = openDisk(AXP_TEST_VHDX, STORAGE_TYPE_DEV_VHDX, &handle);
+        if (retVal != AXP_VHD_FILE_CORRUPT)
+        {
+            printf("\tOpening a short VHDX returned %u\n", retVal);
+            errors++;
+        }
+        remove(AXP_TEST_VHDX);
+    }
+    else
+    {
+        printf("\tUnable to create %s\n", AXP_TEST_VHDX);
+        errors++;
+    }
+    printf("\t...%s\n", (errors == 0) ? "Passed" : "Failed");
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * timeDisk
+ *  This function is called to time writing, then reading, the start of a
+ *  disk sequentially.
+ *
+ * Input Parameters:
+ *  flags:
+ *      A value indicating whether the VHD is fixed or dynamic.
+ *
+ * Output Parameters:
+ *  mbps:
+ *      A pointer to the location to receive the number of MB per second.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int timeDisk(AXP_VHD_CREATE_FLAG flags, double *mbps)
+{
+    AXP_VHD_HANDLE handle;
+    struct timespec start, end;
+    u32 sectors = AXP_TEST_TIME_XFER / AXP_TEST_SECTOR;
+    u32 sectorsXfer;
+    u64 lba;
+    int errors = 0;
+
+    if (createDisk(AXP_TEST_VHD,
+                   STORAGE_TYPE_DEV_VHD,
+                   flags,
+                   AXP_VHD_BLK_DEF,
+                   NULL,
+                   &handle) != AXP_VHD_SUCCESS)
+    {
+        return (1);
+    }
+    fill(testBuf, AXP_TEST_TIME_XFER, 0, 11);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (lba = 0; lba < (AXP_TEST_TIME_SIZE / AXP_TEST_SECTOR); lba += sectors)
+    {
+        sectorsXfer = sectors;
+        if (AXP_VHD_WriteSectors(handle, lba, &sectorsXfer, testBuf) !=
+            AXP_VHD_SUCCESS)
+        {
+            errors++;
+        }
+    }
+    for (lba = 0; lba < (AXP_TEST_TIME_SIZE / AXP_TEST_SECTOR); lba += sectors)
+    {
+        sectorsXfer = sectors;
+        if (AXP_VHD_ReadSectors(handle, lba, &sectorsXfer, testBuf) !=
+            AXP_VHD_SUCCESS)
+        {
+            errors++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    *mbps = (2.0 * AXP_TEST_TIME_SIZE / ONE_M) / elapsed(&start, &end);
+    AXP_VHD_CloseHandle(handle);
+    remove(AXP_TEST_VHD);
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * testTiming
+ *  This function is called to time a dynamic VHD against a fixed one.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  The number of errors found.
+ */
+static int testTiming(void)
+{
+    double dynamicMBps = 0.0, fixedMBps = 0.0;
+    int errors = 0;
+
+    printf("\n    Dynamic versus fixed VHD:\n");
+    errors += timeDisk(CREATE_NONE, &dynamicMBps);
+    errors += timeDisk(CREATE_FULL_PHYSICAL_ALLOCATION, &fixedMBps);
+    printf("\tDynamic: %8.1f MB/s, Fixed: %8.1f MB/s "
+           "(%u x %u byte writes, then reads)\n",
+           dynamicMBps,
+           fixedMBps,
+           AXP_TEST_TIME_SIZE / AXP_TEST_TIME_XFER,
+           AXP_TEST_TIME_XFER);
+    printf("\t...%s\n", (errors == 0) ? "Passed" : "Failed");
+
+    /*
+     * Return back to the caller.
+     */
+    return (errors);
+}
+
+/*
+ * main
+ *  This function is called by the image activator to run the test.
+ *
+ * Input Parameters:
+ *  None.
+ *
+ * Output Parameters:
+ *  None.
+ *
+ * Return Values:
+ *  0:  All tests passed.
+ *  -1: A test failed.
+ */
+int main()
+{
+    int errors = 0;
+
+    printf("\nAXP Virtual Disk Asynchronous I/O Tester\n");
+    errors += testEngine(AXP_VHD_IO_Uring, "io_uring");
+    errors += testEngine(AXP_VHD_IO_Threads, "Threads");
+    errors += testFixedVHD();
+    errors += testDynamic(AXP_TEST_VHD,
+                          STORAGE_TYPE_DEV_VHD,
+                          AXP_VHD_BLK_DEF,
+                          "VHD");
+    errors += testDynamic(AXP_TEST_VHDX,
+                          STORAGE_TYPE_DEV_VHDX,
+                          ONE_M,
+                          "VHDX");
+    errors += testDifferencing();
+    errors += testBadVHDX();
+    errors += testTiming();
+
+    /*
+     * Print final results.
+     */
+    if (errors == 0)
+    {
+        printf("\nAll tests passed!\n");
+    }
+    else
+    {
+        printf("\n%d errors found!\n", errors);
+    }
+    return (errors == 0 ? 0 : -1);
+}